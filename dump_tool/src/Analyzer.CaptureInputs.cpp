@@ -3,6 +3,8 @@
 #include "AnalyzerInternals.h"
 #include "CrashLogger.h"
 #include "CrashLoggerParseCore.h"
+#include "DumpIdentity.h"
+#include "HangPrecaptureTypes.h"
 #include "Mo2Index.h"
 #include "OutputWriterInternals.h"
 #include "PluginRules.h"
@@ -28,20 +30,19 @@ using skydiag::dump_tool::minidump::FindModuleIndexForAddress;
 using skydiag::dump_tool::minidump::IsGameExeModule;
 using skydiag::dump_tool::minidump::IsLikelyWindowsSystemModulePath;
 using skydiag::dump_tool::minidump::IsSystemishModule;
-using skydiag::dump_tool::minidump::LoadThreads;
 using skydiag::dump_tool::minidump::ModuleForAddress;
 using skydiag::dump_tool::minidump::ModuleInfo;
+using skydiag::dump_tool::minidump::ModuleTable;
 using skydiag::dump_tool::minidump::ReadStreamSized;
 using skydiag::dump_tool::minidump::WideLower;
 
 std::optional<CONTEXT> ParseExceptionInfo(
-  void* dumpBase,
-  std::uint64_t dumpSize,
+  const minidump::MinidumpIndex& dump,
   AnalysisResult& out)
 {
   void* excPtr = nullptr;
   ULONG excSize = 0;
-  if (!ReadStreamSized(dumpBase, dumpSize, ExceptionStream, &excPtr, &excSize) || !excPtr || excSize < sizeof(MINIDUMP_EXCEPTION_STREAM)) {
+  if (!ReadStreamSized(dump, ExceptionStream, &excPtr, &excSize) || !excPtr || excSize < sizeof(MINIDUMP_EXCEPTION_STREAM)) {
     return std::nullopt;
   }
   const auto* es = static_cast<const MINIDUMP_EXCEPTION_STREAM*>(excPtr);
@@ -60,16 +61,15 @@ std::optional<CONTEXT> ParseExceptionInfo(
     }
   }
   CONTEXT ctx{};
-  if (internal::TryReadContextFromLocation(dumpBase, dumpSize, es->ThreadContext, ctx)) {
+  if (internal::TryReadContextFromLocation(dump, es->ThreadContext, ctx)) {
     return ctx;
   }
   return std::nullopt;
 }
 
 void ResolveFaultModule(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<ModuleInfo>& allModules,
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& allModules,
   AnalysisResult& out)
 {
   if (out.exc_addr == 0) {
@@ -84,8 +84,8 @@ void ResolveFaultModule(
     wchar_t buf[1024]{};
     swprintf_s(buf, L"%s+0x%llx", m.filename.c_str(), static_cast<unsigned long long>(off));
     out.fault_module_plus_offset = buf;
-    out.inferred_mod_name = m.inferred_mod_name;
-  } else if (auto m = ModuleForAddress(dumpBase, dumpSize, out.exc_addr)) {
+    out.inferred_mod_name = m.InferredModName();
+  } else if (auto m = ModuleForAddress(dump, out.exc_addr)) {
     out.fault_module_path = m->path;
     out.fault_module_filename = m->filename;
     out.fault_module_plus_offset = m->plusOffset;
@@ -110,15 +110,14 @@ void ResolveFaultModule(
 }
 
 void ParseBlackboxStream(
-  void* dumpBase,
-  std::uint64_t dumpSize,
+  const minidump::MinidumpIndex& dump,
   const std::optional<Mo2Index>& mo2Index,
   const std::vector<std::wstring>& modulePaths,
   AnalysisResult& out)
 {
   void* bbPtr = nullptr;
   ULONG bbSize = 0;
-  if (!ReadStreamSized(dumpBase, dumpSize, skydiag::protocol::kMinidumpUserStream_Blackbox, &bbPtr, &bbSize) || !bbPtr ||
+  if (!ReadStreamSized(dump, skydiag::protocol::kMinidumpUserStream_Blackbox, &bbPtr, &bbSize) || !bbPtr ||
       bbSize < offsetof(skydiag::SharedLayout, resources)) {
     return;
   }
@@ -262,24 +261,33 @@ void ParseBlackboxStream(
 
 void IntegratePluginScan(
   const std::wstring& dumpPath,
-  const std::vector<ModuleInfo>& allModules,
-  void* dumpBase,
-  std::uint64_t dumpSize,
+  const ModuleTable& allModules,
+  const minidump::MinidumpIndex& dump,
   const AnalyzeOptions& opt,
   AnalysisResult& out)
 {
   void* pluginPtr = nullptr;
   ULONG pluginSize = 0;
-  if (ReadStreamSized(dumpBase, dumpSize, skydiag::protocol::kMinidumpUserStream_PluginInfo, &pluginPtr, &pluginSize) &&
+  if (ReadStreamSized(dump, skydiag::protocol::kMinidumpUserStream_PluginInfo, &pluginPtr, &pluginSize) &&
       pluginPtr && pluginSize > 0) {
     out.has_plugin_scan = true;
     out.plugin_scan_json_utf8.assign(static_cast<const char*>(pluginPtr), static_cast<std::size_t>(pluginSize));
   }
   if (!out.has_plugin_scan) {
     const std::filesystem::path dumpFs(dumpPath);
-    const auto sidecarPath = dumpFs.parent_path() / (dumpFs.stem().wstring() + L"_PluginScan.json");
+    std::wstring stem = dumpFs.stem().wstring();
     std::string sidecarJson;
-    if (ReadTextFileUtf8(sidecarPath, &sidecarJson) && !sidecarJson.empty()) {
+    bool found = ReadTextFileUtf8(dumpFs.parent_path() / (stem + L"_PluginScan.json"), &sidecarJson) &&
+                 !sidecarJson.empty();
+    // The helper names the sidecar after the thin dump of a two-phase crash.
+    constexpr std::wstring_view kEnrichedSuffix = L"_Enriched";
+    if (!found && stem.size() > kEnrichedSuffix.size() &&
+        std::wstring_view(stem).substr(stem.size() - kEnrichedSuffix.size()) == kEnrichedSuffix) {
+      stem.resize(stem.size() - kEnrichedSuffix.size());
+      found = ReadTextFileUtf8(dumpFs.parent_path() / (stem + L"_PluginScan.json"), &sidecarJson) &&
+              !sidecarJson.empty();
+    }
+    if (found) {
       out.has_plugin_scan = true;
       out.plugin_scan_json_utf8 = std::move(sidecarJson);
     }
@@ -295,7 +303,7 @@ void IntegratePluginScan(
       const bool hasHeader171 = AnyPluginHeaderVersionGte(parsedPluginScan, 1.71);
       bool hasBees = false;
       for (const auto& m : allModules) {
-        if (WideLower(m.filename) == L"bees.dll") {
+        if (m.filename_lower == L"bees.dll") {
           hasBees = true;
           break;
         }
@@ -375,44 +383,53 @@ bool DetermineHangLike(
   return hangLike;
 }
 
-void IntegrateCrashLoggerLog(
+CrashLoggerLogLookup FindCrashLoggerLog(
   const std::wstring& dumpPath,
-  const std::vector<ModuleInfo>& allModules,
+  const ModuleTable& allModules,
   const std::vector<std::wstring>& modulePaths,
-  const std::optional<Mo2Index>& mo2Index,
-  AnalysisResult& out)
+  const std::optional<Mo2Index>& mo2Index)
 {
-  std::wstring clErr;
+  CrashLoggerLogLookup lookup;
   const auto dumpFs = std::filesystem::path(dumpPath);
   std::optional<std::filesystem::path> gameRootDir;
   for (const auto& m : allModules) {
     if (m.path.empty() || m.filename.empty()) {
       continue;
     }
-    const std::wstring lower = WideLower(m.filename);
-    if (lower == L"skyrimse.exe" || lower == L"skyrimae.exe" || lower == L"skyrimvr.exe" || lower == L"skyrim.exe") {
+    if (m.is_game_exe) {
       gameRootDir = std::filesystem::path(m.path).parent_path();
       break;
     }
   }
 
   const auto mo2Base = TryInferMo2BaseDirFromModulePaths(modulePaths);
-  CrashLoggerPairingMetadata pairing{};
-  auto logPath = TryFindCrashLoggerLogForDump(
+  lookup.log_path = TryFindCrashLoggerLogForDump(
     dumpFs,
     mo2Base,
     mo2Index ? &*mo2Index : nullptr,
     gameRootDir,
-    &clErr,
-    &pairing);
-  if (!logPath) {
-    if (!clErr.empty()) {
-      out.diagnostics.push_back(L"[CrashLogger] log not found: " + clErr);
+    &lookup.search_err,
+    &lookup.pairing);
+  if (lookup.log_path) {
+    lookup.log_utf8 = ReadWholeFileUtf8(*lookup.log_path, &lookup.read_err);
+  }
+  return lookup;
+}
+
+void IntegrateCrashLoggerLog(
+  const CrashLoggerLogLookup& lookup,
+  const ModuleTable& allModules,
+  AnalysisResult& out)
+{
+  if (!lookup.log_path) {
+    if (!lookup.search_err.empty()) {
+      out.diagnostics.push_back(L"[CrashLogger] log not found: " + lookup.search_err);
     }
     return;
   }
 
-  out.crash_logger_log_path = logPath->wstring();
+  const auto& pairing = lookup.pairing;
+  out.crash_logger_log_path = lookup.log_path->wstring();
   out.crash_logger_pairing_time_delta_ms = pairing.time_delta_ms;
   out.crash_logger_pairing_runner_up_time_delta_ms = pairing.runner_up_time_delta_ms;
   out.crash_logger_pairing_eligible_candidate_count = pairing.eligible_candidate_count;
@@ -429,10 +446,9 @@ void IntegrateCrashLoggerLog(
       std::to_wstring(pairing.nearby_competitor_count));
   }
 
-  std::wstring readErr;
-  auto logUtf8 = ReadWholeFileUtf8(*logPath, &readErr);
+  const auto& logUtf8 = lookup.log_utf8;
   if (!logUtf8) {
-    out.diagnostics.push_back(L"[CrashLogger] failed to read log: " + readErr);
+    out.diagnostics.push_back(L"[CrashLogger] failed to read log: " + lookup.read_err);
     return;
   }
 
@@ -444,7 +460,7 @@ void IntegrateCrashLoggerLog(
   canonicalByLower.reserve(allModules.size());
   for (const auto& m : allModules) {
     if (!m.filename.empty()) {
-      canonicalByLower.emplace(WideLower(m.filename), m.filename);
+      canonicalByLower.emplace(m.filename_lower, m.filename);
     }
   }
   out.crash_logger_top_modules = ParseCrashLoggerTopModules(*logUtf8, canonicalByLower);
@@ -487,13 +503,14 @@ void IntegrateCrashLoggerLog(
 }
 
 void ComputeSuspects(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<ModuleInfo>& allModules,
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& allModules,
   const std::optional<CONTEXT>& excCtx,
   bool hangLike,
   const AnalyzeOptions& opt,
-  AnalysisResult& out)
+  AnalysisResult& out,
+  const minidump::MemoryOverlaySource* overlay,
+  const std::filesystem::path& moduleCacheDir)
 {
   const bool shouldAnalyzeStacks = (out.exc_tid != 0) || hangLike;
   if (!shouldAnalyzeStacks) {
@@ -527,26 +544,25 @@ void ComputeSuspects(
     }
   }
   tids = std::move(uniqueTids);
-  const auto threads = LoadThreads(dumpBase, dumpSize);
   const std::uint32_t preferredTid = out.exc_tid != 0u ? out.exc_tid : mainTid.value_or(0u);
   if (!internal::TryComputeStackwalkSuspects(
-        dumpBase,
-        dumpSize,
+        dump,
         allModules,
         tids,
         preferredTid,
         out.exc_tid,
         excCtx,
-        threads,
         opt.language,
-        out)) {
+        out,
+        overlay,
+        moduleCacheDir)) {
     out.suspects_from_stackwalk = false;
-    out.diagnostics.push_back(L"[Stackwalk] DbgHelp stackwalk failed, falling back to stack scan");
+    out.stack_scan_fallback = true;
+    out.diagnostics.push_back(L"[Stackwalk] stackwalk found no suspects, falling back to stack scan");
     const std::vector<std::uint32_t> scanTids =
       (hangLike && mainTid.has_value()) ? std::vector<std::uint32_t>{ *mainTid } : tids;
     out.suspects = internal::ComputeStackScanSuspects(
-      dumpBase,
-      dumpSize,
+      dump,
       allModules,
       scanTids,
       out.exc_tid,
@@ -566,8 +582,7 @@ void ComputeSuspects(
     constexpr std::size_t kNearStackSlots = 32u;
     constexpr std::size_t kMinimumThreadGroup = 4u;
     const auto matchingTids = internal::FindThreadsWithNearStackModule(
-      dumpBase,
-      dumpSize,
+      dump,
       allModules,
       out.suspects[0].module_filename,
       kNearStackSlots);
@@ -584,6 +599,11 @@ void ComputeSuspects(
       out.hang_thread_module_consensus.matching_thread_count = static_cast<std::uint32_t>(matchingTids.size());
       out.hang_thread_module_consensus.stable_thread_count = stableCount;
       out.hang_thread_module_consensus.os_lock_cycle_proven = false;
+      out.hang_thread_module_consensus.whole_stack_thread_count = internal::CountThreadsReferencingModuleAnywhere(
+        dump,
+        allModules,
+        out.suspects[0].module_filename,
+        &out.hang_thread_module_consensus.whole_stack_scanned_thread_count);
       out.suspects[0].reason += opt.language == i18n::Language::kEnglish
         ? (L" (same module appeared near the active stack of " + std::to_wstring(matchingTids.size()) +
             L" threads; all had zero context-switch delta across WCT passes)")
@@ -593,4 +613,171 @@ void ComputeSuspects(
   }
 }
 
+void BuildWctWaitGraphAnalysis(
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& allModules,
+  AnalysisResult& out)
+{
+  if (!out.has_wct) {
+    return;
+  }
+  const auto graph = internal::TryBuildWctWaitGraph(out.wct_json_utf8);
+  if (!graph || !graph->has) {
+    return;
+  }
+
+  auto& result = out.wct_wait_graph;
+  result.has_graph = true;
+  result.thread_nodes = graph->thread_nodes;
+  result.lock_nodes = graph->lock_nodes;
+  result.longest_chain_thread_ids = graph->longest_chain_tids;
+  result.longest_chain_has_cycle = graph->longest_chain_has_cycle;
+
+  std::vector<std::uint32_t> participants = graph->longest_chain_tids;
+  for (const auto& cycle : graph->cycles) {
+    participants.insert(participants.end(), cycle.thread_ids.begin(), cycle.thread_ids.end());
+  }
+  constexpr std::size_t kNearStackSlots = 32u;
+  const auto moduleByTid = internal::FindTopNearStackModuleByThread(
+    dump,
+    allModules,
+    participants,
+    kNearStackSlots);
+
+  // One entry per distinct module, in participant order.
+  const auto collectModules = [&](const std::vector<std::uint32_t>& tids) {
+    std::vector<std::wstring> modules;
+    for (const auto tid : tids) {
+      const auto it = moduleByTid.find(tid);
+      if (it == moduleByTid.end()) {
+        continue;
+      }
+      const bool seen = std::any_of(modules.begin(), modules.end(), [&](const std::wstring& m) {
+        return WideLower(m) == WideLower(it->second);
+      });
+      if (!seen) {
+        modules.push_back(it->second);
+      }
+    }
+    return modules;
+  };
+
+  for (const auto& cycle : graph->cycles) {
+    WaitGraphCycle row{};
+    row.thread_ids = cycle.thread_ids;
+    for (const auto& name : cycle.lock_names) {
+      row.lock_names.push_back(Utf8ToWide(name));
+    }
+    row.modules = collectModules(cycle.thread_ids);
+    result.cycles.push_back(std::move(row));
+  }
+  result.longest_chain_modules = collectModules(graph->longest_chain_tids);
+}
+
+bool TryOpenDumpDeltaBase(
+  const std::wstring& dumpPath,
+  void* dumpBase,
+  std::uint64_t dumpSize,
+  minidump::MappedFile* baseFile,
+  AnalysisResult& out)
+{
+  void* deltaPtr = nullptr;
+  ULONG deltaSize = 0;
+  if (!baseFile ||
+      !ReadStreamSized(dumpBase, dumpSize, skydiag::protocol::kMinidumpUserStream_DumpDelta, &deltaPtr, &deltaSize) ||
+      !deltaPtr || deltaSize == 0) {
+    return false;
+  }
+
+  const auto j = nlohmann::json::parse(
+    std::string_view(static_cast<const char*>(deltaPtr), static_cast<std::size_t>(deltaSize)),
+    nullptr,
+    /*allow_exceptions=*/false);
+  if (!j.is_object() || j.value("format", std::string{}) != "skydiag_dump_delta") {
+    out.diagnostics.push_back(L"[Delta] unrecognized incremental recapture stream; analyzing the delta alone");
+    return false;
+  }
+  // The base is referenced by bare filename; never follow a path out of the dump directory.
+  const std::filesystem::path baseName(Utf8ToWide(j.value("base_dump", std::string{})));
+  if (baseName.empty() || baseName != baseName.filename() || baseName == L"..") {
+    out.diagnostics.push_back(L"[Delta] incremental recapture names no usable base dump; analyzing the delta alone");
+    return false;
+  }
+  const auto basePath = std::filesystem::path(dumpPath).parent_path() / baseName;
+  out.dump_delta_base_filename = baseName.wstring();
+
+  std::wstring openErr;
+  if (!baseFile->Open(basePath.wstring(), &openErr)) {
+    out.diagnostics.push_back(L"[Delta] base dump unavailable (" + openErr + L"); analyzing the delta alone");
+    return false;
+  }
+  std::uint64_t sizeBytes = 0;
+  std::uint64_t lastWrite = 0;
+  std::wstring metaErr;
+  if (!ReadDumpFileMetadata(baseFile->file.get(), &sizeBytes, &lastWrite, &metaErr) ||
+      sizeBytes != j.value("base_size_bytes", std::uint64_t{ 0 }) ||
+      lastWrite != j.value("base_last_write_utc_100ns", std::uint64_t{ 0 })) {
+    baseFile->Close();
+    out.diagnostics.push_back(L"[Delta] base dump changed since the recapture; analyzing the delta alone");
+    return false;
+  }
+
+  out.dump_delta_overlay_applied = true;
+  return true;
+}
+
+void ParseHangPrecaptureStream(
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& allModules,
+  AnalysisResult& out)
+{
+  void* hpPtr = nullptr;
+  ULONG hpSize = 0;
+  if (!ReadStreamSized(dump, skydiag::protocol::kMinidumpUserStream_HangPrecapture, &hpPtr, &hpSize) ||
+      !hpPtr || hpSize == 0) {
+    return;
+  }
+  const auto stream = internal::TryParseHangPrecapture(
+    std::string_view(static_cast<const char*>(hpPtr), static_cast<std::size_t>(hpSize)));
+  if (!stream) {
+    return;
+  }
+
+  // RIP usually sits in a system wait/spin routine; the stack words then tell
+  // which non-system module called into it.
+  const auto resolveModule = [&](const internal::HangPrecaptureThread& thread) -> std::wstring {
+    std::wstring ripModule;
+    if (const auto mi = FindModuleIndexForAddress(allModules, thread.rip)) {
+      if (!allModules[*mi].is_systemish) {
+        return allModules[*mi].filename;
+      }
+      ripModule = allModules[*mi].filename;
+    }
+    for (const auto word : thread.stack) {
+      const auto mi = FindModuleIndexForAddress(allModules, word);
+      if (mi && !allModules[*mi].is_systemish) {
+        return allModules[*mi].filename;
+      }
+    }
+    return ripModule;
+  };
+
+  auto& result = out.hang_precapture;
+  result.has_precapture = true;
+  result.snapshot_count = static_cast<std::uint32_t>(stream->snapshots.size());
+  result.dropped_snapshots = stream->dropped;
+  result.stable_main_rip_samples = internal::CountTrailingStableMainThreadRip(*stream);
+  for (const auto& snapshot : stream->snapshots) {
+    HangPrecaptureTimelineEntry entry{};
+    entry.offset_ms = snapshot.offset_ms;
+    entry.seconds_since_heartbeat = snapshot.seconds_since_heartbeat;
+    if (const auto* main = internal::FindMainThreadSample(snapshot)) {
+      result.main_thread_id = main->tid;
+      entry.main_thread_rip = main->rip;
+      entry.main_thread_module = resolveModule(*main);
+    }
+    result.timeline.push_back(std::move(entry));
+  }
+}
+
 }  // namespace skydiag::dump_tool
@@ -102,7 +102,7 @@ std::string CrashHistoryIdentityKey(const AnalysisResult& out)
   if (!out.dump_identity.IsValid()) {
     return {};
   }
-  return out.dump_identity.sha256 + "." + out.dump_identity.StorageMetadataKey();
+  return out.dump_identity.DigestKey() + "." + out.dump_identity.StorageMetadataKey();
 }
 
 void AppendHistoryCandidateKey(
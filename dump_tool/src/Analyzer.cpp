@@ -15,6 +15,7 @@
 #include "AnalyzerInternals.h"
 #include "MinidumpUtil.h"
 #include "Mo2Index.h"
+#include "TaskGraph.h"
 #include "Utf.h"
 
 #include <Windows.h>
@@ -38,6 +39,7 @@
 #include <sstream>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -48,6 +50,9 @@
 
 namespace skydiag::dump_tool {
 
+using skydiag::dump_tool::internal::output_writer::DefaultOutDirForDump;
+using skydiag::dump_tool::internal::output_writer::DumpIdentityCacheDirectory;
+using skydiag::dump_tool::internal::output_writer::ModuleCacheDirectory;
 using skydiag::dump_tool::minidump::IsGameExeModule;
 using skydiag::dump_tool::minidump::IsKnownHookFramework;
 using skydiag::dump_tool::minidump::IsLikelyWindowsSystemModulePath;
@@ -56,6 +61,7 @@ using skydiag::dump_tool::minidump::LoadHookFrameworksFromJson;
 using skydiag::dump_tool::minidump::LoadAllModules;
 using skydiag::dump_tool::minidump::MappedFile;
 using skydiag::dump_tool::minidump::ModuleInfo;
+using skydiag::dump_tool::minidump::ModuleTable;
 using skydiag::dump_tool::minidump::ReadStreamSized;
 using skydiag::dump_tool::minidump::WideLower;
 
@@ -135,7 +141,7 @@ bool CanPromoteCrashLoggerFrameModule(std::wstring_view module)
 
 bool IsCrashLoggerFrameModuleLoadedFromSystemPath(
   std::wstring_view module,
-  const std::vector<ModuleInfo>& allModules)
+  const ModuleTable& allModules)
 {
   const std::wstring key = WideLower(NormalizeCrashLoggerModuleFilename(module));
   if (key.empty()) {
@@ -143,7 +149,7 @@ bool IsCrashLoggerFrameModuleLoadedFromSystemPath(
   }
 
   for (const auto& loaded : allModules) {
-    if (WideLower(loaded.filename) == key &&
+    if (loaded.filename_lower == key &&
         IsLikelyWindowsSystemModulePath(loaded.path)) {
       return true;
     }
@@ -152,7 +158,7 @@ bool IsCrashLoggerFrameModuleLoadedFromSystemPath(
 }
 
 void IntegrateCrashLoggerFrameSignals(
-  const std::vector<ModuleInfo>& allModules,
+  const ModuleTable& allModules,
   AnalysisResult* out)
 {
   if (!out || out->crash_logger_log_path.empty()) {
@@ -172,7 +178,7 @@ void IntegrateCrashLoggerFrameSignals(
   canonicalByFilenameLower.reserve(allModules.size());
   for (const auto& module : allModules) {
     if (!module.filename.empty()) {
-      canonicalByFilenameLower.emplace(WideLower(module.filename), module.filename);
+      canonicalByFilenameLower.emplace(module.filename_lower, module.filename);
     }
   }
 
@@ -231,7 +237,7 @@ struct CrashLoggerFramePromotion
 
 void ApplyCrashLoggerCorroborationToSuspects(
   AnalysisResult* out,
-  const std::vector<ModuleInfo>& allModules)
+  const ModuleTable& allModules)
 {
   if (!out || out->suspects.empty() ||
       (out->crash_logger_top_modules.empty() &&
@@ -397,10 +403,20 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
   if (!mf.Open(dumpPath, err)) {
     return false;
   }
-  const std::uint64_t dumpSize = mf.size;
-  void* dumpBase = mf.view;
-  if (!ComputeDumpIdentity(mf.file.get(), dumpBase, dumpSize, &out.dump_identity, err)) {
-    return false;
+  void* const mappedBase = mf.view;
+  const std::uint64_t mappedSize = mf.size;
+  std::uint64_t dumpSize = mappedSize;
+  void* dumpBase = mappedBase;
+
+  // Incremental recapture: everything is read from the base dump; the delta
+  // (the file we were asked about) only fills memory gaps during stackwalk
+  // (see TryOpenDumpDeltaBase; the summary records the scope).
+  MappedFile deltaBaseFile{};
+  std::optional<minidump::MemoryOverlaySource> deltaOverlay;
+  if (TryOpenDumpDeltaBase(dumpPath, dumpBase, dumpSize, &deltaBaseFile, out)) {
+    deltaOverlay = minidump::MemoryOverlaySource{ dumpBase, dumpSize };
+    dumpBase = deltaBaseFile.view;
+    dumpSize = deltaBaseFile.size;
   }
 
   // Optional: allow external hook-framework list override.
@@ -408,67 +424,169 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
     LoadHookFrameworksFromJson(std::filesystem::path(opt.data_dir) / L"hook_frameworks.json");
   }
 
-  const auto allModules = LoadAllModules(dumpBase, dumpSize);
-  if (!opt.game_version.empty()) {
-    out.game_version = opt.game_version;
-  } else {
+  // Stages that only produce their own result (hashing, directory walks,
+  // data file loads) run on a task graph and overlap with the sequential
+  // stages below, which own `out`. Task results live in these locals; the
+  // analysis thread reads them only after Wait() on the producing task.
+  DumpIdentity identity{};
+  bool identityOk = false;
+  std::wstring identityErr;
+  minidump::MinidumpIndex dump;
+  std::string indexErr;
+  bool indexOk = false;
+  ModuleTable allModules;
+  std::vector<std::wstring> modulePaths;
+  std::string moduleGameVersion;
+  std::optional<Mo2Index> mo2Index;
+  std::optional<CrashLoggerLogLookup> prefetchedCrashLogger;
+  GraphicsInjectionDiag graphicsDiag;
+  bool graphicsRulesLoaded = false;
+  SignatureDatabase sigDb;
+  bool sigDbLoaded = false;
+  TroubleshootingGuideDatabase tsDb;
+  bool tsDbLoaded = false;
+  AddressResolver resolver;
+  bool resolverLoaded = false;
+  AddressResolver::LoadStatus resolverStatus = AddressResolver::LoadStatus::kOk;
+
+  const std::filesystem::path dataDir = opt.data_dir;
+  const std::string gameVersionOverride = opt.game_version;
+  DumpIdentityOptions identityOptions{};
+  identityOptions.algorithm = opt.identity_algorithm;
+  const std::filesystem::path outBase =
+    !outDir.empty() ? std::filesystem::path(outDir) : DefaultOutDirForDump(std::filesystem::path(dumpPath));
+  identityOptions.cache_dir = DumpIdentityCacheDirectory(outBase);
+
+  // Declared after everything its tasks capture: an early return (identity
+  // failure) destroys the graph first, and its destructor waits for tasks
+  // that are still running against those locals.
+  const unsigned poolWorkers = std::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1u;
+  TaskGraph graph(poolWorkers);
+  const auto analysisStart = std::chrono::steady_clock::now();
+  const auto identityTask = graph.Add("dump_identity", [&]() {
+    identityOk = ComputeDumpIdentity(mf.file.get(), mappedBase, mappedSize, &identity, &identityErr, identityOptions);
+  });
+  // Decode the directory, module/thread lists and memory ranges once; every
+  // stage below reads through this index. A dump it cannot parse leaves the
+  // index empty, which the stages treat as "stream absent", as before.
+  const auto indexTask = graph.Add("minidump_index", [&]() {
+    indexOk = dump.Build(dumpBase, dumpSize, &indexErr);
+    if (indexOk) {
+      dump.PrefetchThreadStacks();
+    }
+  });
+  const auto modulesTask = graph.Add("load_modules", [&]() {
+    LoadAllModules(dump, &allModules);
+    modulePaths.reserve(allModules.size());
     for (const auto& m : allModules) {
-      if (m.is_game_exe && !m.version.empty()) {
-        out.game_version = m.version;
-        break;
+      if (!m.path.empty()) {
+        modulePaths.push_back(m.path);
+      }
+      if (moduleGameVersion.empty() && m.is_game_exe && !m.Version().empty()) {
+        moduleGameVersion = m.Version();
       }
     }
-  }
-
-  std::vector<std::wstring> modulePaths;
-  modulePaths.reserve(allModules.size());
-  for (const auto& m : allModules) {
-    if (!m.path.empty()) {
-      modulePaths.push_back(m.path);
+  }, { indexTask });
+  const auto mo2Task = graph.Add("mo2_index", [&]() {
+    mo2Index = TryBuildMo2IndexFromModulePaths(modulePaths);
+  }, { modulesTask });
+  // Speculative: whether the log is needed is only known after the blackbox
+  // and plugin stages, so search ahead when the dump already looks like a
+  // crash or hang and fall back to an inline search otherwise.
+  const auto crashLoggerTask = graph.Add("crashlogger_search", [&]() {
+    const auto& exception = dump.Exception();
+    if (nameCrash || nameHang || (exception && exception->code != 0u)) {
+      prefetchedCrashLogger = FindCrashLoggerLog(dumpPath, allModules, modulePaths, mo2Index);
+    }
+  }, { mo2Task });
+  const auto graphicsRulesTask = graph.Add("graphics_rules", [&]() {
+    if (!dataDir.empty()) {
+      graphicsRulesLoaded = graphicsDiag.LoadRules(dataDir / L"graphics_injection_rules.json");
+    }
+  });
+  const auto sigDbTask = graph.Add("signature_db", [&]() {
+    if (!dataDir.empty()) {
+      sigDbLoaded = sigDb.LoadFromJson(dataDir / L"crash_signatures.json");
+    }
+  });
+  const auto tsDbTask = graph.Add("troubleshooting_db", [&]() {
+    if (!dataDir.empty()) {
+      tsDbLoaded = tsDb.LoadFromJson(dataDir / L"troubleshooting_guides.json");
+    }
+  });
+  const auto addressDbTask = graph.Add("address_db", [&]() {
+    const std::string& version = gameVersionOverride.empty() ? moduleGameVersion : gameVersionOverride;
+    if (!dataDir.empty() && !version.empty()) {
+      resolverLoaded = resolver.LoadFromJson(
+        dataDir / L"address_db" / L"skyrimse_functions.json", version, &resolverStatus);
     }
+  }, { modulesTask });
+  graph.Start();
+
+  graph.Wait(indexTask);
+  if (!indexOk) {
+    out.diagnostics.push_back(L"[Dump] " + Utf8ToWide(indexErr));
   }
-  const auto mo2Index = TryBuildMo2IndexFromModulePaths(modulePaths);
+
+  graph.Wait(modulesTask);
+  out.game_version = gameVersionOverride.empty() ? moduleGameVersion : gameVersionOverride;
 
   // Exception info + fault module
-  const auto excCtx = ParseExceptionInfo(dumpBase, dumpSize, out);
-  ResolveFaultModule(dumpBase, dumpSize, allModules, out);
+  const auto excCtx = graph.RunInline("exception_info", [&]() {
+    auto ctx = ParseExceptionInfo(dump, out);
+    ResolveFaultModule(dump, allModules, out);
+    return ctx;
+  });
 
   // Graphics injection diagnostics (best-effort, data-driven via JSON rules).
   if (!opt.data_dir.empty()) {
-    GraphicsInjectionDiag graphicsDiag;
-    const auto rulesPath = std::filesystem::path(opt.data_dir) / L"graphics_injection_rules.json";
-    if (!graphicsDiag.LoadRules(rulesPath)) {
+    graph.Wait(graphicsRulesTask);
+    if (!graphicsRulesLoaded) {
       out.diagnostics.push_back(L"[Data] failed to load graphics_injection_rules.json");
     } else {
-      std::vector<std::wstring> moduleFilenames;
-      moduleFilenames.reserve(allModules.size());
-      for (const auto& m : allModules) {
-        if (!m.filename.empty()) {
-          moduleFilenames.push_back(m.filename);
+      graph.RunInline("graphics_diag", [&]() {
+        std::vector<std::wstring> moduleFilenames;
+        moduleFilenames.reserve(allModules.size());
+        for (const auto& m : allModules) {
+          if (!m.filename.empty()) {
+            moduleFilenames.push_back(m.filename);
+          }
         }
-      }
-      out.graphics_env = graphicsDiag.DetectEnvironment(moduleFilenames);
-      out.graphics_diag = graphicsDiag.Diagnose(
-        moduleFilenames,
-        out.fault_module_filename,
-        opt.language == i18n::Language::kKorean);
+        out.graphics_env = graphicsDiag.DetectEnvironment(moduleFilenames);
+        out.graphics_diag = graphicsDiag.Diagnose(
+          moduleFilenames,
+          out.fault_module_filename,
+          opt.language == i18n::Language::kKorean);
+      });
     }
   }
 
+  // The dump identity gates everything below (clean-exit evidence, history).
+  graph.Wait(identityTask);
+  if (!identityOk) {
+    if (err) *err = identityErr;
+    return false;
+  }
+  out.dump_identity = identity;
+
   // SkyrimDiag blackbox (optional)
-  ParseBlackboxStream(dumpBase, dumpSize, mo2Index, modulePaths, out);
-  TryConsumeCleanExitEvidence(dumpPath, out);
+  graph.Wait(mo2Task);
+  graph.RunInline("blackbox", [&]() {
+    ParseBlackboxStream(dump, mo2Index, modulePaths, out);
+    TryConsumeCleanExitEvidence(dumpPath, out);
+  });
 
   // WCT stream (optional)
   void* wctPtr = nullptr;
   ULONG wctSize = 0;
-  if (ReadStreamSized(dumpBase, dumpSize, skydiag::protocol::kMinidumpUserStream_WctJson, &wctPtr, &wctSize) && wctPtr && wctSize > 0) {
+  if (ReadStreamSized(dump, skydiag::protocol::kMinidumpUserStream_WctJson, &wctPtr, &wctSize) && wctPtr && wctSize > 0) {
     out.has_wct = true;
     out.wct_json_utf8.assign(static_cast<const char*>(wctPtr), static_cast<std::size_t>(wctSize));
   }
+  graph.RunInline("hang_precapture", [&]() { ParseHangPrecaptureStream(dump, allModules, out); });
 
   // Plugin scan + rules
-  IntegratePluginScan(dumpPath, allModules, dumpBase, dumpSize, opt, out);
+  graph.RunInline("plugin_scan", [&]() { IntegratePluginScan(dumpPath, allModules, dump, opt, out); });
 
   // Hang detection
   const bool hangLike = DetermineHangLike(nameHang, out);
@@ -479,18 +597,35 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
       !out.is_filtered_clean_exit &&
       ((out.exc_code != 0) || nameCrash || hangLike);
     if (shouldSearchCrashLogger) {
-      IntegrateCrashLoggerLog(dumpPath, allModules, modulePaths, mo2Index, out);
-      IntegrateCrashLoggerFrameSignals(allModules, &out);
+      graph.Wait(crashLoggerTask);
+      graph.RunInline("crashlogger", [&]() {
+        const auto lookup = prefetchedCrashLogger
+          ? std::move(*prefetchedCrashLogger)
+          : FindCrashLoggerLog(dumpPath, allModules, modulePaths, mo2Index);
+        IntegrateCrashLoggerLog(lookup, allModules, out);
+        IntegrateCrashLoggerFrameSignals(allModules, &out);
+      });
     }
   }
 
   // Suspects (prefer callstack/stackwalk; fallback to stack scan)
-  ComputeSuspects(dumpBase, dumpSize, allModules, excCtx, hangLike, opt, out);
+  graph.RunInline("suspects", [&]() {
+    ComputeSuspects(
+      dump,
+      allModules,
+      excCtx,
+      hangLike,
+      opt,
+      out,
+      deltaOverlay ? &*deltaOverlay : nullptr,
+      ModuleCacheDirectory(outBase));
+  });
   if (out.symbol_runtime_degraded) {
     out.diagnostics.push_back(L"[Symbols] degraded runtime environment detected; stackwalk/source lookup may be limited");
   }
 
   ApplyCrashLoggerCorroborationToSuspects(&out, allModules);
+  graph.RunInline("wait_graph", [&]() { BuildWctWaitGraphAnalysis(dump, allModules, out); });
 
   if (out.is_filtered_clean_exit) {
     out.suspects.clear();
@@ -508,9 +643,8 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
 
   // Signature matching from external pattern DB.
   if (!out.is_filtered_clean_exit && !opt.data_dir.empty()) {
-    SignatureDatabase sigDb;
-    const auto sigPath = std::filesystem::path(opt.data_dir) / L"crash_signatures.json";
-    if (!sigDb.LoadFromJson(sigPath)) {
+    graph.Wait(sigDbTask);
+    if (!sigDbLoaded) {
       out.diagnostics.push_back(L"[Data] failed to load crash_signatures.json");
     } else {
       SignatureMatchInput input{};
@@ -548,11 +682,9 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
 
   // Resolve game EXE offsets to known function names (best-effort).
   if (!opt.data_dir.empty() && !out.game_version.empty()) {
-    AddressResolver resolver;
-    const auto addrDb = std::filesystem::path(opt.data_dir) / L"address_db" / L"skyrimse_functions.json";
-    AddressResolver::LoadStatus loadStatus = AddressResolver::LoadStatus::kOk;
-    if (!resolver.LoadFromJson(addrDb, out.game_version, &loadStatus)) {
-      switch (loadStatus) {
+    graph.Wait(addressDbTask);
+    if (!resolverLoaded) {
+      switch (resolverStatus) {
       case AddressResolver::LoadStatus::kFileOpenFailed:
         out.diagnostics.push_back(L"[Data] address_db/skyrimse_functions.json not found");
         break;
@@ -580,14 +712,15 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
   const auto analysisTimestamp = NowIso8601Utc();
   const auto historyPath = ResolveCrashHistoryPath(dumpPath, outDir, opt);
   if (!out.is_filtered_clean_exit) {
-    LoadCrashHistoryContext(historyPath, dumpPath, analysisTimestamp, out);
+    graph.RunInline("history_context", [&]() {
+      LoadCrashHistoryContext(historyPath, dumpPath, analysisTimestamp, out);
+    });
   }
 
   // Best-effort troubleshooting guide matching.
   if (!out.is_filtered_clean_exit && !opt.data_dir.empty()) {
-    TroubleshootingGuideDatabase tsDb;
-    const auto guidesPath = std::filesystem::path(opt.data_dir) / L"troubleshooting_guides.json";
-    if (!tsDb.LoadFromJson(guidesPath)) {
+    graph.Wait(tsDbTask);
+    if (!tsDbLoaded) {
       out.diagnostics.push_back(L"[Data] failed to load troubleshooting_guides.json");
     } else {
       TroubleshootingMatchInput tsInput{};
@@ -614,7 +747,7 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
     out.events,
     (out.state_flags & skydiag::kState_Loading) != 0u);
 
-  BuildEvidenceAndSummary(out, opt.language);
+  graph.RunInline("evidence", [&]() { BuildEvidenceAndSummary(out, opt.language); });
   FreezeSignalInput freezeSignals{};
   freezeSignals.is_hang_like = out.is_hang_like;
   freezeSignals.is_snapshot_like = out.is_snapshot_like;
@@ -628,6 +761,9 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
   if (out.hang_thread_module_consensus.has_consensus) {
     freezeSignals.thread_module_consensus = out.hang_thread_module_consensus;
   }
+  if (out.wct_wait_graph.has_graph) {
+    freezeSignals.wait_graph = out.wct_wait_graph;
+  }
   freezeSignals.actionable_candidates = out.actionable_candidates;
   out.freeze_analysis = BuildFreezeCandidateConsensus(freezeSignals, opt.language);
   out.freeze_analysis.first_chance_context = out.first_chance_summary;
@@ -637,6 +773,14 @@ bool AnalyzeDump(const std::wstring& dumpPath, const std::wstring& outDir, const
   if (!out.is_filtered_clean_exit) {
     AppendCrashHistoryEntry(historyPath, dumpPath, analysisTimestamp, out);
   }
+
+  graph.WaitAll();
+  for (auto& t : graph.Timings()) {
+    out.stage_timings.push_back(AnalysisStageTiming{ std::move(t.name), t.start_ms, t.duration_ms, t.worker });
+  }
+  out.analysis_workers = graph.WorkerCount();
+  out.analysis_total_ms =
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - analysisStart).count();
   if (err) err->clear();
   return true;
 }
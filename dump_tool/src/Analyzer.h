@@ -93,6 +93,48 @@ struct HangThreadModuleConsensus
   std::uint32_t matching_thread_count = 0;
   std::uint32_t stable_thread_count = 0;
   bool os_lock_cycle_proven = false;
+  // Threads referencing the module anywhere on their stack (whole-stack scan
+  // of every thread) out of the threads that scan could read. A module on
+  // nearly every stack does not single itself out, so the consensus verdict
+  // is downgraded (see BuildFreezeCandidateConsensus).
+  std::uint32_t whole_stack_thread_count = 0;
+  std::uint32_t whole_stack_scanned_thread_count = 0;
+};
+
+struct WaitGraphCycle
+{
+  std::vector<std::uint32_t> thread_ids;
+  std::vector<std::wstring> lock_names;
+  std::vector<std::wstring> modules;  // top non-system module near each participant's stack (best-effort)
+};
+
+struct WaitGraphAnalysis
+{
+  bool has_graph = false;
+  std::uint32_t thread_nodes = 0;
+  std::uint32_t lock_nodes = 0;
+  std::vector<WaitGraphCycle> cycles;
+  std::vector<std::uint32_t> longest_chain_thread_ids;
+  std::vector<std::wstring> longest_chain_modules;
+  bool longest_chain_has_cycle = false;
+};
+
+struct HangPrecaptureTimelineEntry
+{
+  std::uint64_t offset_ms = 0;
+  double seconds_since_heartbeat = 0.0;
+  std::uint64_t main_thread_rip = 0;
+  std::wstring main_thread_module;  // first non-system module at RIP or in the sampled stack words
+};
+
+struct HangPrecaptureAnalysis
+{
+  bool has_precapture = false;
+  std::uint32_t snapshot_count = 0;
+  std::uint64_t dropped_snapshots = 0;
+  std::uint32_t main_thread_id = 0;
+  std::uint32_t stable_main_rip_samples = 0;
+  std::vector<HangPrecaptureTimelineEntry> timeline;
 };
 
 struct FreezeAnalysisResult
@@ -109,6 +151,7 @@ struct FreezeAnalysisResult
   BlackboxFreezeSummary blackbox_context;
   FirstChanceSummary first_chance_context;
   HangThreadModuleConsensus thread_module_consensus;
+  WaitGraphAnalysis wait_graph;
 };
 
 struct EventRow
@@ -148,12 +191,27 @@ struct BucketCandidateRepeat
   std::size_t prior_count = 0;
 };
 
+// Wall-clock time of one AnalyzeDump stage. Stages on the task graph can
+// overlap; worker 0 is the analysis thread itself.
+struct AnalysisStageTiming
+{
+  std::string name;
+  double start_ms = 0.0;
+  double duration_ms = 0.0;
+  int worker = 0;
+};
+
 struct AnalysisResult
 {
   i18n::Language language = i18n::DefaultLanguage();
   std::wstring dump_path;
   std::wstring out_dir;
   DumpIdentity dump_identity;
+  // Incremental recapture: base dump this delta names, and whether the
+  // analysis ran on that base with the delta's memory overlaid (stackwalk
+  // memory only; every stream and the stack scan come from the base).
+  std::wstring dump_delta_base_filename;
+  bool dump_delta_overlay_applied = false;
 
   std::uint32_t pid = 0;
   std::uint32_t state_flags = 0;
@@ -219,6 +277,10 @@ struct AnalysisResult
   // Heuristic: suspects inferred from stack/module scanning
   std::vector<SuspectItem> suspects;
   bool suspects_from_stackwalk = false;
+  // The stack walk was attempted and produced nothing, so suspects came from
+  // the stack scan (summary callstack.stack_scan_fallback; the helper's
+  // recapture policy reads it).
+  bool stack_scan_fallback = false;
   std::optional<SignatureMatch> signature_match;
   std::unordered_map<std::uint64_t, std::string> resolved_functions;
   std::vector<ModuleStats> history_stats;
@@ -234,6 +296,7 @@ struct AnalysisResult
 
   // Best-effort callstack (primary thread: crash thread, WCT cycle thread, or inferred main thread)
   std::uint32_t stackwalk_primary_tid = 0;
+  std::string stackwalk_unwinder;  // "native_x64" or "dbghelp"; empty without a callstack
   std::vector<std::wstring> stackwalk_primary_frames;
   std::vector<CrashBucketFrame> stackwalk_primary_bucket_frames;
   std::uint32_t stackwalk_total_frames = 0;
@@ -278,6 +341,8 @@ struct AnalysisResult
   BlackboxFreezeSummary blackbox_freeze_summary;
   FirstChanceSummary first_chance_summary;
   HangThreadModuleConsensus hang_thread_module_consensus;
+  WaitGraphAnalysis wct_wait_graph;
+  HangPrecaptureAnalysis hang_precapture;
   FreezeAnalysisResult freeze_analysis;
 
   bool has_wct = false;
@@ -296,6 +361,11 @@ struct AnalysisResult
 
   // Diagnostic messages from best-effort subsystems (data loading, CrashLogger integration, etc.)
   std::vector<std::wstring> diagnostics;
+
+  // Per-stage timings (varies run to run; not part of any verdict).
+  std::vector<AnalysisStageTiming> stage_timings;
+  std::uint32_t analysis_workers = 0;
+  double analysis_total_ms = 0.0;
 };
 
 struct AnalyzeOptions
@@ -306,6 +376,9 @@ struct AnalyzeOptions
   std::wstring data_dir;  // Optional analyzer data directory (e.g. "<exe>/data")
   std::string game_version;  // Optional override (e.g. "1.6.640.0")
   std::wstring output_dir;   // Optional output base directory for crash history
+  // Tree identities hash much faster on large dumps but change every storage
+  // key, so flat SHA-256 stays the default (the WinUI verifies it directly).
+  DumpIdentityAlgorithm identity_algorithm = DumpIdentityAlgorithm::kSha256;
   i18n::Language language = i18n::DefaultLanguage();
 };
 
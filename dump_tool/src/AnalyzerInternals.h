@@ -9,9 +9,11 @@
 #include <DbgHelp.h>
 
 #include <cstdint>
+#include <filesystem>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace skydiag::dump_tool::internal {
@@ -35,33 +37,49 @@ FirstChanceSummary BuildFirstChanceSummary(
 std::wstring ResourceKindFromPath(std::wstring_view path);
 
 std::vector<SuspectItem> ComputeStackScanSuspects(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<minidump::ModuleInfo>& modules,
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& modules,
   const std::vector<std::uint32_t>& targetTids,
   std::uint32_t exceptionTid,
   i18n::Language lang);
 
 std::vector<std::uint32_t> FindThreadsWithNearStackModule(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<minidump::ModuleInfo>& modules,
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& modules,
   std::wstring_view moduleFilename,
   std::size_t maxSlots);
 
-bool TryReadContextFromLocation(void* dumpBase, std::uint64_t dumpSize, const MINIDUMP_LOCATION_DESCRIPTOR& loc, CONTEXT& out);
+// Threads (all of the dump's, not just WCT targets) whose whole captured stack
+// from Rsp holds at least one pointer into the module; `scannedThreads`
+// receives how many stacks were readable. Runs the parallel whole-stack scan,
+// so it is only worth calling once a candidate exists.
+std::uint32_t CountThreadsReferencingModuleAnywhere(
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& modules,
+  std::wstring_view moduleFilename,
+  std::uint32_t* scannedThreads = nullptr);
+
+// Highest-weighted non-system module in the top maxSlots stack slots of each
+// thread, keyed by thread id. Threads without a usable stack are omitted.
+std::unordered_map<std::uint32_t, std::wstring> FindTopNearStackModuleByThread(
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& modules,
+  const std::vector<std::uint32_t>& tids,
+  std::size_t maxSlots);
+
+bool TryReadContextFromLocation(const minidump::MinidumpIndex& dump, const MINIDUMP_LOCATION_DESCRIPTOR& loc, CONTEXT& out);
 
 bool TryComputeStackwalkSuspects(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<minidump::ModuleInfo>& modules,
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& modules,
   const std::vector<std::uint32_t>& targetTids,
   std::uint32_t preferredTid,
   std::uint32_t excTid,
   const std::optional<CONTEXT>& excCtx,
-  const std::vector<minidump::ThreadRecord>& threads,
   i18n::Language lang,
-  AnalysisResult& out);
+  AnalysisResult& out,
+  const minidump::MemoryOverlaySource* overlay = nullptr,
+  const std::filesystem::path& moduleCacheDir = {});
 
 void ComputeCrashBucket(AnalysisResult& out);
 
@@ -0,0 +1,136 @@
+#include "HangPrecaptureTypes.h"
+
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
+
+namespace skydiag::dump_tool::internal {
+namespace {
+
+constexpr std::size_t kMaxSnapshots = 64u;
+constexpr std::size_t kMaxThreadsPerSnapshot = 64u;
+constexpr std::size_t kMaxStackWords = 64u;
+
+template <typename T>
+T ReadUnsigned(const nlohmann::json& obj, const char* key)
+{
+  const auto it = obj.find(key);
+  if (it == obj.end() || !it->is_number_unsigned()) {
+    return T{};
+  }
+  return it->get<T>();
+}
+
+}  // namespace
+
+std::optional<HangPrecaptureStream> TryParseHangPrecapture(std::string_view jsonUtf8)
+{
+  if (jsonUtf8.empty()) {
+    return std::nullopt;
+  }
+
+  try {
+    const auto j = nlohmann::json::parse(jsonUtf8, nullptr, /*allow_exceptions=*/true);
+    if (!j.is_object()) {
+      return std::nullopt;
+    }
+    const auto snapshotsIt = j.find("snapshots");
+    if (snapshotsIt == j.end() || !snapshotsIt->is_array()) {
+      return std::nullopt;
+    }
+
+    HangPrecaptureStream out{};
+    out.version = ReadUnsigned<std::uint32_t>(j, "version");
+    out.capacity = ReadUnsigned<std::uint32_t>(j, "capacity");
+    out.dropped = ReadUnsigned<std::uint64_t>(j, "dropped");
+
+    for (const auto& s : *snapshotsIt) {
+      if (out.snapshots.size() >= kMaxSnapshots) {
+        break;
+      }
+      if (!s.is_object()) {
+        continue;
+      }
+      HangPrecaptureSnapshot snapshot{};
+      snapshot.offset_ms = ReadUnsigned<std::uint64_t>(s, "offset_ms");
+      const auto secIt = s.find("seconds_since_heartbeat");
+      if (secIt != s.end() && secIt->is_number()) {
+        snapshot.seconds_since_heartbeat = secIt->get<double>();
+      }
+      snapshot.threshold_sec = ReadUnsigned<std::uint32_t>(s, "threshold_sec");
+      snapshot.state_flags = ReadUnsigned<std::uint32_t>(s, "state_flags");
+      snapshot.main_tid = ReadUnsigned<std::uint32_t>(s, "main_tid");
+
+      const auto threadsIt = s.find("threads");
+      if (threadsIt != s.end() && threadsIt->is_array()) {
+        for (const auto& t : *threadsIt) {
+          if (snapshot.threads.size() >= kMaxThreadsPerSnapshot) {
+            break;
+          }
+          if (!t.is_object()) {
+            continue;
+          }
+          HangPrecaptureThread thread{};
+          thread.tid = ReadUnsigned<std::uint32_t>(t, "tid");
+          if (thread.tid == 0u) {
+            continue;
+          }
+          thread.rip = ReadUnsigned<std::uint64_t>(t, "rip");
+          thread.rsp = ReadUnsigned<std::uint64_t>(t, "rsp");
+          const auto stackIt = t.find("stack");
+          if (stackIt != t.end() && stackIt->is_array()) {
+            for (const auto& word : *stackIt) {
+              if (thread.stack.size() >= kMaxStackWords) {
+                break;
+              }
+              thread.stack.push_back(word.is_number_unsigned() ? word.get<std::uint64_t>() : 0u);
+            }
+          }
+          snapshot.threads.push_back(std::move(thread));
+        }
+      }
+      out.snapshots.push_back(std::move(snapshot));
+    }
+
+    if (out.snapshots.empty()) {
+      return std::nullopt;
+    }
+    return out;
+  } catch (...) {
+    return std::nullopt;
+  }
+}
+
+const HangPrecaptureThread* FindMainThreadSample(const HangPrecaptureSnapshot& snapshot)
+{
+  if (snapshot.main_tid == 0u) {
+    return nullptr;
+  }
+  const auto it = std::find_if(snapshot.threads.begin(), snapshot.threads.end(), [&](const HangPrecaptureThread& t) {
+    return t.tid == snapshot.main_tid;
+  });
+  return it == snapshot.threads.end() ? nullptr : &*it;
+}
+
+std::uint32_t CountTrailingStableMainThreadRip(const HangPrecaptureStream& stream)
+{
+  std::uint32_t run = 0;
+  std::uint32_t tid = 0;
+  std::uint64_t rip = 0;
+  for (auto it = stream.snapshots.rbegin(); it != stream.snapshots.rend(); ++it) {
+    const auto* main = FindMainThreadSample(*it);
+    if (!main || main->rip == 0u) {
+      break;
+    }
+    if (run == 0u) {
+      tid = main->tid;
+      rip = main->rip;
+    } else if (main->tid != tid || main->rip != rip) {
+      break;
+    }
+    ++run;
+  }
+  return run;
+}
+
+}  // namespace skydiag::dump_tool::internal
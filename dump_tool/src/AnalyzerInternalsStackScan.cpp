@@ -1,5 +1,7 @@
 #include "AnalyzerInternals.h"
 #include "AnalyzerScoringPolicy.h"
+#include "ModuleAddressIndex.h"
+#include "StackModuleScan.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -9,13 +11,15 @@
 namespace skydiag::dump_tool::internal {
 namespace {
 
-using skydiag::dump_tool::minidump::FindModuleIndexForAddress;
 using skydiag::dump_tool::minidump::GetThreadStackBytes;
 using skydiag::dump_tool::minidump::IsSkseModule;
 using skydiag::dump_tool::minidump::LoadThreads;
+using skydiag::dump_tool::minidump::ModuleAddressIndex;
 using skydiag::dump_tool::minidump::ModuleInfo;
+using skydiag::dump_tool::minidump::ModuleTable;
 using skydiag::dump_tool::minidump::ReadThreadContextWin64;
-using skydiag::dump_tool::minidump::ThreadRecord;
+using skydiag::dump_tool::minidump::ScanStacksForModuleRefs;
+using skydiag::dump_tool::minidump::StackSlice;
 using skydiag::dump_tool::minidump::WideLower;
 using skydiag::dump_tool::i18n::ConfidenceText;
 
@@ -59,35 +63,34 @@ std::uint32_t StackScanSlotWeight(std::size_t slotIndex)
 }  // namespace
 
 std::vector<SuspectItem> ComputeStackScanSuspects(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<ModuleInfo>& modules,
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& modules,
   const std::vector<std::uint32_t>& targetTids,
   std::uint32_t exceptionTid,
   i18n::Language lang)
 {
   std::vector<SuspectItem> out;
-  if (!dumpBase || modules.empty() || targetTids.empty()) {
+  if (!dump.Base() || modules.empty() || targetTids.empty()) {
     return out;
   }
 
-  const auto threads = LoadThreads(dumpBase, dumpSize);
-  if (threads.empty()) {
+  if (dump.Threads().empty()) {
     return out;
   }
 
+  const auto addressIndex = ModuleAddressIndex::FromModules(modules);
   std::unordered_map<std::size_t, std::uint32_t> scoreByModule;
   std::unordered_map<std::size_t, std::uint32_t> exceptionScoreByModule;
 
   constexpr std::size_t kMaxScanBytes = std::size_t{96} * 1024u;
   for (const auto tid : targetTids) {
-    const auto it = std::find_if(threads.begin(), threads.end(), [&](const ThreadRecord& tr) { return tr.tid == tid; });
-    if (it == threads.end()) {
+    const auto* it = dump.FindThread(tid);
+    if (!it) {
       continue;
     }
 
     CONTEXT ctx{};
-    if (!ReadThreadContextWin64(dumpBase, dumpSize, *it, ctx)) {
+    if (!ReadThreadContextWin64(dump, *it, ctx)) {
       continue;
     }
     const std::uint64_t sp = ctx.Rsp;
@@ -95,7 +98,7 @@ std::vector<SuspectItem> ComputeStackScanSuspects(
     const std::uint8_t* stackBytes = nullptr;
     std::size_t stackSize = 0;
     std::uint64_t stackBase = 0;
-    if (!GetThreadStackBytes(dumpBase, dumpSize, *it, stackBytes, stackSize, stackBase)) {
+    if (!GetThreadStackBytes(dump, *it, stackBytes, stackSize, stackBase)) {
       continue;
     }
 
@@ -105,20 +108,13 @@ std::vector<SuspectItem> ComputeStackScanSuspects(
     }
     const std::size_t endOff = std::min<std::size_t>(stackSize, startOff + kMaxScanBytes);
 
-    for (std::size_t off = startOff; off + sizeof(std::uint64_t) <= endOff; off += sizeof(std::uint64_t)) {
-      std::uint64_t val = 0;
-      std::memcpy(&val, stackBytes + off, sizeof(val));
-      auto mi = FindModuleIndexForAddress(modules, val);
-      if (!mi) {
-        continue;
-      }
-      const std::size_t slotIndex = (off - startOff) / sizeof(std::uint64_t);
+    addressIndex.ForEachModulePointer(stackBytes + startOff, endOff - startOff, [&](std::size_t slotIndex, std::size_t mi) {
       const auto weight = StackScanSlotWeight(slotIndex);
-      scoreByModule[*mi] += weight;
+      scoreByModule[mi] += weight;
       if (exceptionTid != 0u && tid == exceptionTid) {
-        exceptionScoreByModule[*mi] += weight;
+        exceptionScoreByModule[mi] += weight;
       }
-    }
+    });
   }
 
   struct Row
@@ -152,9 +148,7 @@ std::vector<SuspectItem> ComputeStackScanSuspects(
     if (a.score != b.score) {
       return a.score > b.score;
     }
-    const auto an = WideLower(modules[a.modIndex].filename);
-    const auto bn = WideLower(modules[b.modIndex].filename);
-    return an < bn;
+    return modules.FilenameLower(a.modIndex) < modules.FilenameLower(b.modIndex);
   });
 
   if (rows.empty()) {
@@ -212,7 +206,7 @@ std::vector<SuspectItem> ComputeStackScanSuspects(
     si.confidence = ConfidenceText(lang, si.confidence_level);
     si.module_filename = m.filename;
     si.module_path = m.path;
-    si.inferred_mod_name = m.inferred_mod_name;
+    si.inferred_mod_name = m.InferredModName();
     si.score = row.score;
     si.reason = en
       ? (L"Observed " + std::to_wstring(row.score) +
@@ -232,35 +226,33 @@ std::vector<SuspectItem> ComputeStackScanSuspects(
 }
 
 std::vector<std::uint32_t> FindThreadsWithNearStackModule(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<ModuleInfo>& modules,
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& modules,
   std::wstring_view moduleFilename,
   std::size_t maxSlots)
 {
   std::vector<std::uint32_t> matchingTids;
-  if (!dumpBase || moduleFilename.empty() || maxSlots == 0u) {
+  if (!dump.Base() || moduleFilename.empty() || maxSlots == 0u) {
     return matchingTids;
   }
 
-  const auto moduleIt = std::find_if(modules.begin(), modules.end(), [&](const ModuleInfo& module) {
-    return WideLower(module.filename) == WideLower(moduleFilename);
-  });
-  if (moduleIt == modules.end()) {
+  const auto moduleIndex = modules.FindByFilename(moduleFilename);
+  if (!moduleIndex) {
     return matchingTids;
   }
+  const std::uint64_t moduleBase = modules.Base(*moduleIndex);
+  const std::uint64_t moduleEnd = modules.End(*moduleIndex);
 
-  const auto threads = LoadThreads(dumpBase, dumpSize);
-  for (const auto& thread : threads) {
+  for (const auto& thread : LoadThreads(dump)) {
     CONTEXT context{};
-    if (!ReadThreadContextWin64(dumpBase, dumpSize, thread, context)) {
+    if (!ReadThreadContextWin64(dump, thread, context)) {
       continue;
     }
 
     const std::uint8_t* stackBytes = nullptr;
     std::size_t stackSize = 0;
     std::uint64_t stackBase = 0;
-    if (!GetThreadStackBytes(dumpBase, dumpSize, thread, stackBytes, stackSize, stackBase)) {
+    if (!GetThreadStackBytes(dump, thread, stackBytes, stackSize, stackBase)) {
       continue;
     }
 
@@ -275,7 +267,7 @@ std::vector<std::uint32_t> FindThreadsWithNearStackModule(
     for (std::size_t offset = 0; offset + sizeof(std::uint64_t) <= scanBytes; offset += sizeof(std::uint64_t)) {
       std::uint64_t value = 0;
       std::memcpy(&value, stackBytes + startOffset + offset, sizeof(value));
-      if (value >= moduleIt->base && value < moduleIt->end) {
+      if (value >= moduleBase && value < moduleEnd) {
         matched = true;
         break;
       }
@@ -287,4 +279,119 @@ std::vector<std::uint32_t> FindThreadsWithNearStackModule(
   return matchingTids;
 }
 
+std::uint32_t CountThreadsReferencingModuleAnywhere(
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& modules,
+  std::wstring_view moduleFilename,
+  std::uint32_t* scannedThreads)
+{
+  if (scannedThreads) {
+    *scannedThreads = 0;
+  }
+  if (!dump.Base() || moduleFilename.empty()) {
+    return 0;
+  }
+  const auto moduleIndex = modules.FindByFilename(moduleFilename);
+  if (!moduleIndex) {
+    return 0;
+  }
+  const auto target = static_cast<std::uint32_t>(*moduleIndex);
+
+  std::vector<StackSlice> slices;
+  slices.reserve(dump.Threads().size());
+  for (const auto& thread : dump.Threads()) {
+    CONTEXT context{};
+    if (!ReadThreadContextWin64(dump, thread, context)) {
+      continue;
+    }
+    const std::uint8_t* stackBytes = nullptr;
+    std::size_t stackSize = 0;
+    std::uint64_t stackBase = 0;
+    if (!GetThreadStackBytes(dump, thread, stackBytes, stackSize, stackBase)) {
+      continue;
+    }
+    std::size_t startOffset = 0;
+    if (context.Rsp >= stackBase && context.Rsp < stackBase + static_cast<std::uint64_t>(stackSize)) {
+      startOffset = static_cast<std::size_t>(context.Rsp - stackBase);
+    }
+    slices.push_back(StackSlice{ thread.tid, stackBytes + startOffset, stackSize - startOffset });
+  }
+  if (scannedThreads) {
+    *scannedThreads = static_cast<std::uint32_t>(slices.size());
+  }
+
+  const auto addressIndex = ModuleAddressIndex::FromModules(modules);
+  std::uint32_t count = 0;
+  for (const auto& refs : ScanStacksForModuleRefs(addressIndex, slices)) {
+    if (std::binary_search(refs.modules.begin(), refs.modules.end(), target)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+std::unordered_map<std::uint32_t, std::wstring> FindTopNearStackModuleByThread(
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& modules,
+  const std::vector<std::uint32_t>& tids,
+  std::size_t maxSlots)
+{
+  std::unordered_map<std::uint32_t, std::wstring> moduleByTid;
+  if (!dump.Base() || modules.empty() || tids.empty() || maxSlots == 0u) {
+    return moduleByTid;
+  }
+
+  const auto addressIndex = ModuleAddressIndex::FromModules(modules);
+  for (const auto tid : tids) {
+    if (moduleByTid.contains(tid)) {
+      continue;
+    }
+    const auto* it = dump.FindThread(tid);
+    if (!it) {
+      continue;
+    }
+
+    CONTEXT context{};
+    if (!ReadThreadContextWin64(dump, *it, context)) {
+      continue;
+    }
+    const std::uint8_t* stackBytes = nullptr;
+    std::size_t stackSize = 0;
+    std::uint64_t stackBase = 0;
+    if (!GetThreadStackBytes(dump, *it, stackBytes, stackSize, stackBase)) {
+      continue;
+    }
+
+    std::size_t startOffset = 0;
+    if (context.Rsp >= stackBase && context.Rsp < stackBase + static_cast<std::uint64_t>(stackSize)) {
+      startOffset = static_cast<std::size_t>(context.Rsp - stackBase);
+    }
+    const std::size_t scanBytes = std::min<std::size_t>(
+      stackSize - startOffset,
+      maxSlots * sizeof(std::uint64_t));
+
+    std::unordered_map<std::size_t, std::uint32_t> scoreByModule;
+    addressIndex.ForEachModulePointer(stackBytes + startOffset, scanBytes, [&](std::size_t slotIndex, std::size_t mi) {
+      if (modules.Has(mi, ModuleTable::kSystemish) || modules.Has(mi, ModuleTable::kGameExe)) {
+        return;
+      }
+      scoreByModule[mi] += StackScanSlotWeight(slotIndex);
+    });
+
+    std::optional<std::size_t> best;
+    std::uint32_t bestScore = 0;
+    for (const auto& [idx, score] : scoreByModule) {
+      if (!best || score > bestScore ||
+          (score == bestScore && modules.FilenameLower(idx) < modules.FilenameLower(*best))) {
+        best = idx;
+        bestScore = score;
+      }
+    }
+    if (best) {
+      moduleByTid.emplace(tid, modules[*best].filename);
+    }
+  }
+  return moduleByTid;
+}
+
 }  // namespace skydiag::dump_tool::internal
@@ -2,41 +2,185 @@
 
 #include "AnalyzerScoringPolicy.h"
 #include "AnalyzerInternalsStackwalkPriv.h"
+#include "ModuleCache.h"
+#include "Utf.h"
+#include "X64Unwinder.h"
 
 #include <algorithm>
 #include <cstring>
+#include <memory>
 
 namespace skydiag::dump_tool::internal {
 namespace {
 
 using skydiag::dump_tool::internal::stackwalk_internal::MinidumpMemoryView;
 using skydiag::dump_tool::internal::stackwalk_internal::StackWalkAddrsForContext;
+using skydiag::dump_tool::internal::stackwalk_internal::ProbeSymbolRuntime;
+using skydiag::dump_tool::internal::stackwalk_internal::SymbolRuntime;
 using skydiag::dump_tool::internal::stackwalk_internal::SymSession;
 
+using skydiag::dump_tool::minidump::FindModuleIndexForAddress;
 using skydiag::dump_tool::minidump::ModuleInfo;
+using skydiag::dump_tool::minidump::ModuleTable;
 using skydiag::dump_tool::minidump::IsKnownHookFramework;
 using skydiag::dump_tool::minidump::ReadThreadContextWin64;
-using skydiag::dump_tool::minidump::ThreadRecord;
 using skydiag::dump_tool::minidump::WideLower;
 using skydiag::dump_tool::i18n::ConfidenceText;
 
+static_assert(sizeof(CONTEXT) == sizeof(minidump::ContextX64), "the native unwinder reads CONTEXT as ContextX64");
+
+// Lets the native unwinder read through the same view (and incremental
+// overlay) StackWalk64 uses.
+class MemoryViewTarget final : public minidump::TargetMemory
+{
+public:
+  explicit MemoryViewTarget(const MinidumpMemoryView& view) : m_view(view) {}
+  std::size_t Read(std::uint64_t addr, void* dst, std::size_t size) const override
+  {
+    std::size_t got = 0;
+    m_view.Read(addr, dst, size, got);
+    return got;
+  }
+
+private:
+  const MinidumpMemoryView& m_view;
+};
+
+std::optional<ModuleCacheKey> CacheKeyForModule(const minidump::MinidumpIndex& dump, const ModuleInfo& module)
+{
+  for (const auto& record : dump.Modules()) {
+    if (record.base == module.base) {
+      auto key = ModuleCacheKeyFor(record);
+      if (key.Valid()) {
+        return key;
+      }
+      break;
+    }
+  }
+  return std::nullopt;
+}
+
+// Symbol caches of the modules `pcs` fall in, indexed like `modules`.
+// False when one of them has no cache yet.
+bool OpenFrameSymbolCaches(
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& modules,
+  const std::filesystem::path& cacheDir,
+  const std::vector<std::uint64_t>& pcs,
+  std::vector<std::unique_ptr<ModuleCacheFile>>* caches)
+{
+  caches->clear();
+  caches->resize(modules.size());
+  if (cacheDir.empty()) {
+    return false;
+  }
+  std::vector<bool> tried(modules.size(), false);
+  bool all = true;
+  for (const auto pc : pcs) {
+    const auto idx = FindModuleIndexForAddress(modules, pc);
+    if (!idx || tried[*idx]) {
+      continue;
+    }
+    tried[*idx] = true;
+    const auto key = CacheKeyForModule(dump, modules[*idx]);
+    auto file = std::make_unique<ModuleCacheFile>();
+    if (key && file->Open(cacheDir, *key, ModuleCacheKind::kSymbols)) {
+      (*caches)[*idx] = std::move(file);
+    } else {
+      all = false;
+    }
+  }
+  return all;
+}
+
+struct SymbolHarvest
+{
+  std::uint64_t base = 0;
+  std::vector<CachedSymbol> symbols;
+};
+
+BOOL CALLBACK CollectModuleSymbol(PSYMBOL_INFOW sym, ULONG /*size*/, PVOID ctx)
+{
+  auto* harvest = static_cast<SymbolHarvest*>(ctx);
+  if (sym->NameLen > 0 && sym->Address >= harvest->base && sym->Address - harvest->base <= 0xFFFFFFFFull) {
+    harvest->symbols.push_back(
+      { static_cast<std::uint32_t>(sym->Address - harvest->base), WideToUtf8(std::wstring_view(sym->Name, sym->NameLen)) });
+  }
+  return TRUE;
+}
+
+// Stores the symbols DbgHelp loaded for uncached frame modules. Only PDB
+// public tables are cached: a PDB belongs to the module build the cache is
+// keyed on, whereas an export table is what DbgHelp falls back to when this
+// run's search path (offline policy, missing cache) found no PDB, and caching
+// it would pin later runs to it. A module with source lines keeps going
+// through DbgHelp, the only thing that can render them.
+std::size_t StoreFrameSymbolCaches(
+  HANDLE process,
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& modules,
+  const std::filesystem::path& cacheDir,
+  const std::vector<std::uint64_t>& pcs,
+  const std::vector<std::unique_ptr<ModuleCacheFile>>& caches)
+{
+  std::size_t stored = 0;
+  std::vector<bool> tried(modules.size(), false);
+  for (const auto pc : pcs) {
+    const auto idx = FindModuleIndexForAddress(modules, pc);
+    if (!idx || tried[*idx] || caches[*idx]) {
+      continue;
+    }
+    tried[*idx] = true;
+    const auto key = CacheKeyForModule(dump, modules[*idx]);
+    if (!key) {
+      continue;
+    }
+
+    IMAGEHLP_MODULEW64 info{};
+    info.SizeOfStruct = sizeof(info);
+    if (!SymGetModuleInfoW64(process, static_cast<DWORD64>(modules[*idx].base), &info)) {
+      continue;
+    }
+    const bool pdbPublicsOnly = info.SymType == SymPdb && !info.LineNumbers;
+    if (!pdbPublicsOnly) {
+      continue;
+    }
+
+    SymbolHarvest harvest;
+    harvest.base = modules[*idx].base;
+    if (!SymEnumSymbolsW(process, static_cast<ULONG64>(harvest.base), L"*", CollectModuleSymbol, &harvest)) {
+      continue;
+    }
+    if (StoreModuleSymbolCache(cacheDir, *key, std::move(harvest.symbols))) {
+      ++stored;
+    }
+  }
+  return stored;
+}
+
 }  // namespace
 
 namespace stackwalk {
 
 std::vector<SuspectItem> ComputeCallstackSuspectsFromAddrs(
-  const std::vector<ModuleInfo>& modules,
+  const ModuleTable& modules,
   const std::vector<std::uint64_t>& pcs,
   i18n::Language lang);
 
 std::vector<CrashBucketFrame> BuildCanonicalCallstackFrames(
-  const std::vector<ModuleInfo>& modules,
+  const ModuleTable& modules,
+  const std::vector<std::uint64_t>& pcs,
+  std::size_t maxFrames);
+
+std::pair<std::size_t, std::size_t> SelectCallstackFrameRange(
+  const ModuleTable& modules,
   const std::vector<std::uint64_t>& pcs,
   std::size_t maxFrames);
 
 std::vector<std::wstring> FormatCallstackForDisplay(
   HANDLE process,
-  const std::vector<ModuleInfo>& modules,
+  const ModuleTable& modules,
+  const std::vector<const ModuleCacheFile*>* symbolCaches,
   const std::vector<std::uint64_t>& pcs,
   std::size_t maxFrames,
   std::uint32_t* outTotalFrames,
@@ -45,93 +189,183 @@ std::vector<std::wstring> FormatCallstackForDisplay(
 
 }  // namespace stackwalk
 
-bool TryReadContextFromLocation(void* dumpBase, std::uint64_t dumpSize, const MINIDUMP_LOCATION_DESCRIPTOR& loc, CONTEXT& out)
+bool TryReadContextFromLocation(const minidump::MinidumpIndex& dump, const MINIDUMP_LOCATION_DESCRIPTOR& loc, CONTEXT& out)
 {
-  if (!dumpBase) {
-    return false;
-  }
-  const std::uint64_t rva = static_cast<std::uint64_t>(loc.Rva);
-  const std::uint64_t sz = static_cast<std::uint64_t>(loc.DataSize);
-  if (rva == 0 || sz == 0 || rva > dumpSize || sz > (dumpSize - rva)) {
+  const auto bytes = dump.Reader().Bytes(minidump::MinidumpLocation{ loc.DataSize, loc.Rva });
+  if (bytes.empty()) {
     return false;
   }
 
-  const auto* base = static_cast<const std::uint8_t*>(dumpBase);
-  const std::size_t copyN = static_cast<std::size_t>(std::min<std::uint64_t>(sz, sizeof(CONTEXT)));
+  const std::size_t copyN = std::min<std::size_t>(bytes.size(), sizeof(CONTEXT));
   std::memset(&out, 0, sizeof(out));
-  std::memcpy(&out, base + rva, copyN);
+  std::memcpy(&out, bytes.data(), copyN);
   return true;
 }
 
 bool TryComputeStackwalkSuspects(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<ModuleInfo>& modules,
+  const minidump::MinidumpIndex& dump,
+  const ModuleTable& modules,
   const std::vector<std::uint32_t>& targetTids,
   std::uint32_t preferredTid,
   std::uint32_t excTid,
   const std::optional<CONTEXT>& excCtx,
-  const std::vector<ThreadRecord>& threads,
   i18n::Language lang,
-  AnalysisResult& out)
+  AnalysisResult& out,
+  const minidump::MemoryOverlaySource* overlay,
+  const std::filesystem::path& moduleCacheDir)
 {
-  if (!dumpBase || modules.empty() || targetTids.empty() || threads.empty()) {
+  if (!dump.Base() || modules.empty() || targetTids.empty() || dump.Threads().empty()) {
     return false;
   }
 
   MinidumpMemoryView mem;
-  if (!mem.Init(dumpBase, dumpSize, &threads)) {
+  if (!mem.Init(dump)) {
     return false;
   }
+  if (overlay) {
+    const std::uint64_t added = mem.Overlay(*overlay);
+    out.diagnostics.push_back(
+      L"[Delta] stackwalk memory overlay added " + std::to_wstring(added) + L" bytes from the incremental recapture");
+  }
 
-  SymSession sym(modules, out.online_symbol_source_allowed);
-  out.symbol_search_path = sym.searchPath;
-  out.symbol_cache_path = sym.cachePath;
-  out.dbghelp_path = sym.dbghelpPath;
-  out.dbghelp_version = sym.dbghelpVersion;
-  out.msdia_path = sym.msdiaPath;
-  out.msdia_available = sym.msdiaAvailable;
-  out.symbol_cache_ready = sym.symbolCacheReady;
-  out.symbol_runtime_degraded = sym.runtimeDegraded;
-  out.online_symbol_source_used = sym.usedOnlineSymbolSource;
-  for (const auto& diagnostic : sym.runtimeDiagnostics) {
-    out.diagnostics.push_back(diagnostic);
-  }
-  if (!sym.ok) {
+  // Native unwind first, from the modules' own .pdata/.xdata: no DbgHelp
+  // lock, and every target thread in parallel.
+  std::vector<minidump::ThreadUnwindInput> unwindInputs;
+  std::vector<CONTEXT> contexts;
+  for (const auto tid : targetTids) {
+    CONTEXT ctx{};
+    bool haveCtx = false;
+    if (tid != 0 && tid == excTid && excCtx) {
+      ctx = *excCtx;
+      haveCtx = true;
+    } else {
+      const auto* thread = dump.FindThread(tid);
+      if (thread && ReadThreadContextWin64(dump, *thread, ctx)) {
+        haveCtx = true;
+      }
+    }
+    if (!haveCtx || ctx.Rip == 0 || ctx.Rsp == 0) {
+      continue;
+    }
+    minidump::ThreadUnwindInput input;
+    input.tid = tid;
+    std::memcpy(&input.context, &ctx, sizeof(ctx));
+    unwindInputs.push_back(input);
+    contexts.push_back(ctx);
+  }
+  const MemoryViewTarget unwindMemory(mem);
+  minidump::X64UnwinderOptions unwindOptions;
+  unwindOptions.module_cache_dir = moduleCacheDir;
+  const minidump::X64Unwinder unwinder(dump.Modules(), unwindMemory, unwindOptions);
+  const auto nativeStacks = minidump::UnwindThreads(unwinder, unwindInputs, /*maxFrames=*/64);
+  std::size_t nativeUnwound = 0;
+  for (const auto& stack : nativeStacks) {
+    if (stack.pcs.size() >= 2) {
+      ++nativeUnwound;
+    }
+  }
+  const auto unwindStats = unwinder.Stats();
+  out.diagnostics.push_back(
+    L"[Stackwalk] native x64 unwinder: " + std::to_wstring(nativeUnwound) + L"/" + std::to_wstring(nativeStacks.size()) +
+    L" threads unwound (unwind tables: " + std::to_wstring(unwindStats.modules_from_dump) + L" from dump, " +
+    std::to_wstring(unwindStats.modules_from_files) + L" from module files, " +
+    std::to_wstring(unwindStats.modules_from_cache) + L" from the module cache, " +
+    std::to_wstring(unwindStats.modules_without_tables) + L" unavailable)");
+
+  // The DbgHelp session is opened only when something needs it: the
+  // StackWalk64 fallback, or frames whose modules have no symbol cache.
+  std::optional<SymSession> sym;
+  const auto recordRuntime = [&](const SymbolRuntime& rt) {
+    out.symbol_search_path = rt.searchPath;
+    out.symbol_cache_path = rt.cachePath;
+    out.dbghelp_path = rt.dbghelpPath;
+    out.dbghelp_version = rt.dbghelpVersion;
+    out.msdia_path = rt.msdiaPath;
+    out.msdia_available = rt.msdiaAvailable;
+    out.symbol_cache_ready = rt.symbolCacheReady;
+    out.symbol_runtime_degraded = rt.runtimeDegraded;
+    out.online_symbol_source_used = rt.usedOnlineSymbolSource;
+    for (const auto& diagnostic : rt.runtimeDiagnostics) {
+      out.diagnostics.push_back(diagnostic);
+    }
+  };
+  const auto openSymbols = [&]() -> bool {
+    if (!sym) {
+      sym.emplace(modules, out.online_symbol_source_allowed);
+      recordRuntime(sym->runtime);
+    }
+    return sym->ok;
+  };
+  const bool needStackWalk = std::any_of(nativeStacks.begin(), nativeStacks.end(), [](const auto& stack) {
+    return stack.pcs.size() < 2 || stack.truncated;
+  });
+  // Without a symbol session the native stacks still give module+offset
+  // frames and suspects.
+  if (needStackWalk && !openSymbols() && nativeUnwound == 0) {
     return false;
   }
 
+  const auto formatFrames = [&](const std::vector<std::uint64_t>& pcs) {
+    constexpr std::size_t kDisplayFrames = 12;
+    const auto [start, end] = stackwalk::SelectCallstackFrameRange(modules, pcs, kDisplayFrames);
+    const std::vector<std::uint64_t> shown(
+      pcs.begin() + static_cast<std::ptrdiff_t>(start), pcs.begin() + static_cast<std::ptrdiff_t>(end));
+    std::vector<std::unique_ptr<ModuleCacheFile>> caches;
+    if (OpenFrameSymbolCaches(dump, modules, moduleCacheDir, shown, &caches) && !sym) {
+      // No session, but the summary still describes the runtime one would use.
+      recordRuntime(ProbeSymbolRuntime(modules, out.online_symbol_source_allowed));
+      out.diagnostics.push_back(L"[Symbols] callstack symbols served from the module cache; DbgHelp session skipped");
+    } else {
+      openSymbols();
+    }
+    const HANDLE symProcess = (sym && sym->ok) ? sym->process : nullptr;
+    std::vector<const ModuleCacheFile*> cacheViews;
+    cacheViews.reserve(caches.size());
+    for (const auto& cache : caches) {
+      cacheViews.push_back(cache.get());
+    }
+    out.stackwalk_primary_frames = stackwalk::FormatCallstackForDisplay(
+      symProcess,
+      modules,
+      &cacheViews,
+      pcs,
+      kDisplayFrames,
+      &out.stackwalk_total_frames,
+      &out.stackwalk_symbolized_frames,
+      &out.stackwalk_source_line_frames);
+    if (symProcess && !moduleCacheDir.empty()) {
+      const auto stored = StoreFrameSymbolCaches(symProcess, dump, modules, moduleCacheDir, shown, caches);
+      if (stored > 0) {
+        out.diagnostics.push_back(L"[Symbols] cached the symbol tables of " + std::to_wstring(stored) + L" modules for later analyses");
+      }
+    }
+  };
+
   struct Candidate
   {
     std::uint32_t tid = 0;
     std::vector<std::uint64_t> pcs;
     std::vector<SuspectItem> suspects;
     std::uint32_t topScore = 0;
+    const char* unwinder = "";
   };
 
   Candidate best{};
   Candidate bestAny{};
   const bool en = (lang == i18n::Language::kEnglish);
-  for (const auto tid : targetTids) {
-    CONTEXT ctx{};
-    bool haveCtx = false;
-    if (tid != 0 && tid == excTid && excCtx) {
-      ctx = *excCtx;
-      haveCtx = true;
-    } else {
-      const auto it = std::find_if(threads.begin(), threads.end(), [&](const ThreadRecord& tr) { return tr.tid == tid; });
-      if (it != threads.end() && ReadThreadContextWin64(dumpBase, dumpSize, *it, ctx)) {
-        haveCtx = true;
+  for (std::size_t i = 0; i < nativeStacks.size(); ++i) {
+    const auto tid = nativeStacks[i].tid;
+    auto pcs = nativeStacks[i].pcs;
+    const char* unwinderName = "native_x64";
+    // StackWalk64 only where the native walk ran out of tables or memory;
+    // it may know a function table we could not read.
+    if (sym && sym->ok && (pcs.size() < 2 || nativeStacks[i].truncated)) {
+      auto dbghelpPcs = StackWalkAddrsForContext(sym->process, mem, contexts[i], /*maxFrames=*/64);
+      if (dbghelpPcs.size() > pcs.size()) {
+        pcs = std::move(dbghelpPcs);
+        unwinderName = "dbghelp";
       }
     }
-    if (!haveCtx) {
-      continue;
-    }
-    if (ctx.Rip == 0 || ctx.Rsp == 0) {
-      continue;
-    }
-
-    auto pcs = StackWalkAddrsForContext(sym.process, mem, ctx, /*maxFrames=*/64);
     if (pcs.empty()) {
       continue;
     }
@@ -146,6 +380,7 @@ bool TryComputeStackwalkSuspects(
           preferredTid)) {
       bestAny.tid = tid;
       bestAny.pcs = pcs;
+      bestAny.unwinder = unwinderName;
     }
 
     auto suspects = stackwalk::ComputeCallstackSuspectsFromAddrs(modules, pcs, lang);
@@ -166,24 +401,19 @@ bool TryComputeStackwalkSuspects(
       best.pcs = std::move(pcs);
       best.suspects = std::move(suspects);
       best.topScore = topScore;
+      best.unwinder = unwinderName;
     }
   }
 
   if (best.suspects.empty()) {
     if (!bestAny.pcs.empty()) {
       out.stackwalk_primary_tid = bestAny.tid;
+      out.stackwalk_unwinder = bestAny.unwinder;
       out.stackwalk_primary_bucket_frames = stackwalk::BuildCanonicalCallstackFrames(
         modules,
         bestAny.pcs,
         /*maxFrames=*/12);
-      out.stackwalk_primary_frames = stackwalk::FormatCallstackForDisplay(
-        sym.process,
-        modules,
-        bestAny.pcs,
-        /*maxFrames=*/12,
-        &out.stackwalk_total_frames,
-        &out.stackwalk_symbolized_frames,
-        &out.stackwalk_source_line_frames);
+      formatFrames(bestAny.pcs);
     }
     return false;
   }
@@ -220,18 +450,12 @@ bool TryComputeStackwalkSuspects(
   out.suspects_from_stackwalk = true;
   out.suspects = std::move(best.suspects);
   out.stackwalk_primary_tid = best.tid;
+  out.stackwalk_unwinder = best.unwinder;
   out.stackwalk_primary_bucket_frames = stackwalk::BuildCanonicalCallstackFrames(
     modules,
     best.pcs,
     /*maxFrames=*/12);
-  out.stackwalk_primary_frames = stackwalk::FormatCallstackForDisplay(
-    sym.process,
-    modules,
-    best.pcs,
-    /*maxFrames=*/12,
-    &out.stackwalk_total_frames,
-    &out.stackwalk_symbolized_frames,
-    &out.stackwalk_source_line_frames);
+  formatFrames(best.pcs);
   return true;
 }
 
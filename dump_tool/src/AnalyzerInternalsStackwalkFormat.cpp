@@ -1,5 +1,8 @@
 #include "AnalyzerInternals.h"
 
+#include "ModuleCache.h"
+#include "Utf.h"
+
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -12,8 +15,9 @@ namespace {
 
 using skydiag::dump_tool::minidump::FindModuleIndexForAddress;
 using skydiag::dump_tool::minidump::ModuleInfo;
+using skydiag::dump_tool::minidump::ModuleTable;
 
-std::wstring FormatModulePlusOffset(const std::vector<ModuleInfo>& modules, std::uint64_t addr)
+std::wstring FormatModulePlusOffset(const ModuleTable& modules, std::uint64_t addr)
 {
   if (auto idx = FindModuleIndexForAddress(modules, addr)) {
     const auto& m = modules[*idx];
@@ -29,7 +33,8 @@ std::wstring FormatModulePlusOffset(const std::vector<ModuleInfo>& modules, std:
 
 std::wstring FormatSymbolizedFrame(
   HANDLE process,
-  const std::vector<ModuleInfo>& modules,
+  const ModuleTable& modules,
+  const std::vector<const ModuleCacheFile*>* symbolCaches,
   std::uint64_t addr,
   bool* outHasSymbol,
   bool* outHasSourceLine)
@@ -42,7 +47,29 @@ std::wstring FormatSymbolizedFrame(
   }
 
   const std::wstring fallback = FormatModulePlusOffset(modules, addr);
-  if (!process || addr == 0) {
+  if (addr == 0) {
+    return fallback;
+  }
+
+  // A cached module's table is all DbgHelp would have found (no source lines).
+  if (symbolCaches) {
+    if (auto idx = FindModuleIndexForAddress(modules, addr); idx && *idx < symbolCaches->size() && (*symbolCaches)[*idx]) {
+      const auto& m = modules[*idx];
+      std::string_view name;
+      std::uint32_t displacement = 0;
+      if (!(*symbolCaches)[*idx]->FindSymbol(static_cast<std::uint32_t>(addr - m.base), &name, &displacement)) {
+        return fallback;
+      }
+      if (outHasSymbol) {
+        *outHasSymbol = true;
+      }
+      wchar_t offBuf[64]{};
+      swprintf_s(offBuf, L"+0x%llx", static_cast<unsigned long long>(displacement));
+      return m.filename + L"!" + Utf8ToWide(name) + offBuf;
+    }
+  }
+
+  if (!process) {
     return fallback;
   }
 
@@ -88,8 +115,10 @@ std::wstring FormatSymbolizedFrame(
   return frame;
 }
 
+}  // namespace
+
 std::pair<std::size_t, std::size_t> SelectCallstackFrameRange(
-  const std::vector<ModuleInfo>& modules,
+  const ModuleTable& modules,
   const std::vector<std::uint64_t>& pcs,
   std::size_t maxFrames)
 {
@@ -110,10 +139,8 @@ std::pair<std::size_t, std::size_t> SelectCallstackFrameRange(
   return { start, std::min<std::size_t>(pcs.size(), start + maxFrames) };
 }
 
-}  // namespace
-
 std::vector<CrashBucketFrame> BuildCanonicalCallstackFrames(
-  const std::vector<ModuleInfo>& modules,
+  const ModuleTable& modules,
   const std::vector<std::uint64_t>& pcs,
   std::size_t maxFrames)
 {
@@ -137,7 +164,8 @@ std::vector<CrashBucketFrame> BuildCanonicalCallstackFrames(
 
 std::vector<std::wstring> FormatCallstackForDisplay(
   HANDLE process,
-  const std::vector<ModuleInfo>& modules,
+  const ModuleTable& modules,
+  const std::vector<const ModuleCacheFile*>* symbolCaches,
   const std::vector<std::uint64_t>& pcs,
   std::size_t maxFrames,
   std::uint32_t* outTotalFrames,
@@ -164,7 +192,7 @@ std::vector<std::wstring> FormatCallstackForDisplay(
   for (std::size_t i = start; i < end; i++) {
     bool hasSymbol = false;
     bool hasSourceLine = false;
-    out.push_back(FormatSymbolizedFrame(process, modules, pcs[i], &hasSymbol, &hasSourceLine));
+    out.push_back(FormatSymbolizedFrame(process, modules, symbolCaches, pcs[i], &hasSymbol, &hasSourceLine));
     if (outTotalFrames) {
       *outTotalFrames += 1;
     }
@@ -1,5 +1,7 @@
 #include "AnalyzerInternalsStackwalkPriv.h"
 
+#include "MemoryRangeOverlay.h"
+
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -8,8 +10,6 @@
 namespace skydiag::dump_tool::internal::stackwalk_internal {
 namespace {
 
-using skydiag::dump_tool::minidump::ReadStreamSized;
-
 static thread_local const MinidumpMemoryView* g_stackwalkMemView = nullptr;
 
 BOOL CALLBACK ReadProcessMemoryFromMinidump64(HANDLE, DWORD64 baseAddr, PVOID buffer, DWORD size, LPDWORD bytesRead)
@@ -30,113 +30,77 @@ BOOL CALLBACK ReadProcessMemoryFromMinidump64(HANDLE, DWORD64 baseAddr, PVOID bu
 
 }  // namespace
 
-bool MinidumpMemoryView::Init(void* dumpBase, std::uint64_t dumpSize, const std::vector<minidump::ThreadRecord>* threads)
+bool MinidumpMemoryView::Init(const minidump::MinidumpIndex& dump)
 {
   ranges.clear();
-  if (!dumpBase || dumpSize < sizeof(MINIDUMP_HEADER)) {
+  recent.Reset();
+  const auto* base = static_cast<const std::uint8_t*>(dump.Base());
+  if (!base) {
     return false;
   }
 
-  const auto* base = static_cast<const std::uint8_t*>(dumpBase);
-
-  // Prefer Memory64ListStream for FullMemory dumps.
-  {
-    void* ptr = nullptr;
-    ULONG size = 0;
-    if (ReadStreamSized(dumpBase, dumpSize, Memory64ListStream, &ptr, &size) && ptr && size >= sizeof(MINIDUMP_MEMORY64_LIST)) {
-      const auto* list = static_cast<const MINIDUMP_MEMORY64_LIST*>(ptr);
-      const std::uint64_t need =
-        static_cast<std::uint64_t>(offsetof(MINIDUMP_MEMORY64_LIST, MemoryRanges)) +
-        static_cast<std::uint64_t>(list->NumberOfMemoryRanges) * static_cast<std::uint64_t>(sizeof(MINIDUMP_MEMORY_DESCRIPTOR64));
-      if (need <= static_cast<std::uint64_t>(size)) {
-        std::uint64_t cursor = list->BaseRva;
-        ranges.reserve(static_cast<std::size_t>(list->NumberOfMemoryRanges));
-        for (ULONG i = 0; i < list->NumberOfMemoryRanges; i++) {
-          const auto& mr = list->MemoryRanges[i];
-          if (mr.DataSize == 0) {
-            continue;
-          }
-          if (cursor > dumpSize || mr.DataSize > (dumpSize - cursor)) {
-            ranges.clear();
-            break;
-          }
-          MinidumpMemoryRange r{};
-          r.start = mr.StartOfMemoryRange;
-          r.end = mr.StartOfMemoryRange + mr.DataSize;
-          r.bytes = base + cursor;
-          ranges.push_back(r);
-          cursor += mr.DataSize;
-        }
-        if (!ranges.empty()) {
-          std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) { return a.start < b.start; });
-          return true;
-        }
-      }
-    }
+  // Memory64ListStream for FullMemory dumps, else MemoryListStream; the index
+  // has already bounds-checked and sorted them.
+  const auto& regions = dump.Memory().Regions();
+  ranges.reserve(regions.size());
+  for (const auto& region : regions) {
+    MinidumpMemoryRange r{};
+    r.start = region.start;
+    r.end = region.start + region.size;
+    r.bytes = base + region.rva;
+    ranges.push_back(r);
+  }
+  if (!ranges.empty()) {
+    return true;
   }
 
-  // Fallback: MemoryListStream (typically contains thread stacks).
-  {
-    void* ptr = nullptr;
-    ULONG size = 0;
-    if (!ReadStreamSized(dumpBase, dumpSize, MemoryListStream, &ptr, &size) || !ptr || size < sizeof(MINIDUMP_MEMORY_LIST)) {
-      // Some dumps omit MemoryListStream but still include per-thread stack memory in ThreadListStream.
-      if (!threads || threads->empty()) {
-        return false;
-      }
-      ranges.reserve(threads->size());
-      for (const auto& tr : *threads) {
-        const std::uint64_t rva = static_cast<std::uint64_t>(tr.stack.Memory.Rva);
-        const std::uint64_t sz = static_cast<std::uint64_t>(tr.stack.Memory.DataSize);
-        if (rva == 0 || sz == 0) {
-          continue;
-        }
-        if (rva > dumpSize || sz > (dumpSize - rva)) {
-          continue;
-        }
-        MinidumpMemoryRange r{};
-        r.start = tr.stack.StartOfMemoryRange;
-        r.end = tr.stack.StartOfMemoryRange + sz;
-        r.bytes = base + rva;
-        ranges.push_back(r);
-      }
-      if (!ranges.empty()) {
-        std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) { return a.start < b.start; });
-      }
-      return !ranges.empty();
-    }
-
-    const auto* list = static_cast<const MINIDUMP_MEMORY_LIST*>(ptr);
-    const std::uint64_t need =
-      static_cast<std::uint64_t>(offsetof(MINIDUMP_MEMORY_LIST, MemoryRanges)) +
-      static_cast<std::uint64_t>(list->NumberOfMemoryRanges) * static_cast<std::uint64_t>(sizeof(MINIDUMP_MEMORY_DESCRIPTOR));
-    if (need > static_cast<std::uint64_t>(size)) {
-      return false;
+  // Some dumps omit MemoryListStream but still include per-thread stack memory in ThreadListStream.
+  ranges.reserve(dump.Threads().size());
+  for (const auto& tr : dump.Threads()) {
+    const auto stack = dump.Reader().Bytes(tr.stack);
+    if (stack.empty()) {
+      continue;
     }
+    MinidumpMemoryRange r{};
+    r.start = tr.stackStart;
+    r.end = tr.stackStart + stack.size();
+    r.bytes = stack.data();
+    ranges.push_back(r);
+  }
+  std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) { return a.start < b.start; });
+  return !ranges.empty();
+}
 
-    ranges.reserve(static_cast<std::size_t>(list->NumberOfMemoryRanges));
-    for (ULONG i = 0; i < list->NumberOfMemoryRanges; i++) {
-      const auto& mr = list->MemoryRanges[i];
-      const std::uint64_t rva = static_cast<std::uint64_t>(mr.Memory.Rva);
-      const std::uint64_t sz = static_cast<std::uint64_t>(mr.Memory.DataSize);
-      if (rva == 0 || sz == 0) {
-        continue;
-      }
-      if (rva > dumpSize || sz > (dumpSize - rva)) {
-        continue;
-      }
-      MinidumpMemoryRange r{};
-      r.start = mr.StartOfMemoryRange;
-      r.end = mr.StartOfMemoryRange + sz;
-      r.bytes = base + rva;
-      ranges.push_back(r);
-    }
+std::uint64_t MinidumpMemoryView::Overlay(const minidump::MemoryOverlaySource& overlay)
+{
+  minidump::MinidumpIndex overlayDump;
+  MinidumpMemoryView extra;
+  if (!overlay.dumpBase || !overlayDump.Build(overlay.dumpBase, overlay.dumpSize, nullptr) ||
+      overlayDump.Memory().Regions().empty() || !extra.Init(overlayDump)) {
+    return 0;
+  }
 
-    if (!ranges.empty()) {
-      std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) { return a.start < b.start; });
+  std::vector<AddressSpan> covered;
+  covered.reserve(ranges.size());
+  for (const auto& r : ranges) {
+    covered.push_back({ r.start, r.end });
+  }
+  covered = CoalesceSpans(std::move(covered));
+
+  std::uint64_t added = 0;
+  for (const auto& r : extra.ranges) {
+    for (const auto& gap : UncoveredSpans(covered, r.start, r.end)) {
+      MinidumpMemoryRange piece{};
+      piece.start = gap.start;
+      piece.end = gap.end;
+      piece.bytes = r.bytes + static_cast<std::size_t>(gap.start - r.start);
+      ranges.push_back(piece);
+      added += gap.end - gap.start;
     }
-    return !ranges.empty();
   }
+  std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) { return a.start < b.start; });
+  recent.Reset();
+  return added;
 }
 
 bool MinidumpMemoryView::Read(std::uint64_t addr, void* dst, std::size_t n, std::size_t& outRead) const
@@ -146,16 +110,15 @@ bool MinidumpMemoryView::Read(std::uint64_t addr, void* dst, std::size_t n, std:
     return false;
   }
 
-  const auto it = std::upper_bound(ranges.begin(), ranges.end(), addr, [](std::uint64_t value, const MinidumpMemoryRange& r) {
-    return value < r.start;
-  });
-  if (it == ranges.begin()) {
-    return false;
-  }
-  const auto& r = *(it - 1);
-  if (addr < r.start || addr >= r.end || !r.bytes) {
+  const std::size_t i = recent.Find(
+    ranges,
+    addr,
+    [](const MinidumpMemoryRange& r) { return r.start; },
+    [](const MinidumpMemoryRange& r, std::uint64_t a) { return a >= r.start && a < r.end && r.bytes; });
+  if (i == minidump::RecentRangeCache::kNone) {
     return false;
   }
+  const auto& r = ranges[i];
   const std::uint64_t avail = r.end - addr;
   const std::size_t copyN = static_cast<std::size_t>(std::min<std::uint64_t>(avail, static_cast<std::uint64_t>(n)));
   std::memcpy(dst, r.bytes + static_cast<std::size_t>(addr - r.start), copyN);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AnalyzerInternals.h"
+#include "RecentRangeCache.h"
 
 #include <cstddef>
 #include <cstdint>
@@ -21,29 +22,48 @@ struct MinidumpMemoryView
 {
   std::vector<MinidumpMemoryRange> ranges;
 
-  bool Init(void* dumpBase, std::uint64_t dumpSize, const std::vector<minidump::ThreadRecord>* threads);
+  bool Init(const minidump::MinidumpIndex& dump);
 
+  // Adds the overlay's memory wherever this view has none; returns the
+  // number of bytes added.
+  std::uint64_t Overlay(const minidump::MemoryOverlaySource& overlay);
+
+  // StackWalk64 calls this through ReadProcessMemoryFromMinidump64 for every
+  // few bytes it unwinds; `recent` keeps those off the binary search.
   bool Read(std::uint64_t addr, void* dst, std::size_t n, std::size_t& outRead) const;
+
+  minidump::RecentRangeCache recent;
 };
 
-struct SymSession
+// The symbol runtime a DbgHelp session runs with: DLLs, search path, cache
+// directory and what is wrong with them. Resolved without the DbgHelp lock
+// or SymInitialize, so an analysis that skips the session still reports it.
+struct SymbolRuntime
 {
-  HANDLE process = nullptr;
-  HMODULE ownedMsdiaModule = nullptr;
-  bool ok = false;
   std::wstring searchPath;
   std::wstring cachePath;
   std::wstring dbghelpPath;
   std::wstring dbghelpVersion;
   std::wstring msdiaPath;
+  std::wstring bundledMsdiaPath;  // the game's copy, used when none is resolvable
   bool msdiaAvailable = false;
   bool symbolCacheReady = false;
   bool runtimeDegraded = false;
-  bool usedOnlineSymbolSource = false;
+  bool usedOnlineSymbolSource = false;  // set by a session only
   std::vector<std::wstring> runtimeDiagnostics;
+};
+
+SymbolRuntime ProbeSymbolRuntime(const minidump::ModuleTable& modules, bool allowOnlineSymbols);
+
+struct SymSession
+{
+  HANDLE process = nullptr;
+  HMODULE ownedMsdiaModule = nullptr;
+  bool ok = false;
+  SymbolRuntime runtime;
   std::unique_lock<std::mutex> dbghelp_lock;
 
-  explicit SymSession(const std::vector<minidump::ModuleInfo>& modules, bool allowOnlineSymbols);
+  explicit SymSession(const minidump::ModuleTable& modules, bool allowOnlineSymbols);
   ~SymSession();
 };
 
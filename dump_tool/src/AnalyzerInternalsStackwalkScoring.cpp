@@ -13,6 +13,7 @@ namespace {
 using skydiag::dump_tool::minidump::FindModuleIndexForAddress;
 using skydiag::dump_tool::minidump::IsSkseModule;
 using skydiag::dump_tool::minidump::ModuleInfo;
+using skydiag::dump_tool::minidump::ModuleTable;
 using skydiag::dump_tool::minidump::WideLower;
 using skydiag::dump_tool::i18n::ConfidenceText;
 
@@ -70,7 +71,7 @@ i18n::ConfidenceLevel ConfidenceForSecondaryCallstackLevel(std::uint32_t score,
 }  // namespace
 
 std::vector<SuspectItem> ComputeCallstackSuspectsFromAddrs(
-  const std::vector<ModuleInfo>& modules,
+  const ModuleTable& modules,
   const std::vector<std::uint64_t>& pcs,
   i18n::Language lang)
 {
@@ -127,9 +128,7 @@ std::vector<SuspectItem> ComputeCallstackSuspectsFromAddrs(
     if (a.firstDepth != b.firstDepth) {
       return a.firstDepth < b.firstDepth;
     }
-    const auto an = WideLower(modules[a.modIndex].filename);
-    const auto bn = WideLower(modules[b.modIndex].filename);
-    return an < bn;
+    return modules.FilenameLower(a.modIndex) < modules.FilenameLower(b.modIndex);
   });
 
   // If the top frame owner is a hook framework (especially CrashLoggerSSE), prefer a
@@ -189,7 +188,7 @@ std::vector<SuspectItem> ComputeCallstackSuspectsFromAddrs(
     si.confidence = ConfidenceText(lang, si.confidence_level);
     si.module_filename = m.filename;
     si.module_path = m.path;
-    si.inferred_mod_name = m.inferred_mod_name;
+    si.inferred_mod_name = m.InferredModName();
     si.score = row.score;
     si.reason = en
       ? (L"Callstack weight=" + std::to_wstring(row.score) + L", first depth=" + std::to_wstring(row.firstDepth))
@@ -14,6 +14,7 @@ namespace skydiag::dump_tool::internal::stackwalk_internal {
 namespace {
 
 using skydiag::dump_tool::minidump::ModuleInfo;
+using skydiag::dump_tool::minidump::ModuleTable;
 
 std::mutex& DbgHelpGlobalMutex()
 {
@@ -98,10 +99,10 @@ std::wstring ResolveRuntimeDllPath(const wchar_t* moduleName)
   return SearchDllPath(moduleName);
 }
 
-std::filesystem::path InferGameExeDirFromModules(const std::vector<ModuleInfo>& modules)
+std::filesystem::path InferGameExeDirFromModules(const ModuleTable& modules)
 {
   for (const auto& module : modules) {
-    if (module.path.empty() || module.filename.empty() || !minidump::IsGameExeModule(module.filename)) {
+    if (module.path.empty() || module.filename.empty() || !module.is_game_exe) {
       continue;
     }
     const std::filesystem::path exePath(module.path);
@@ -112,7 +113,7 @@ std::filesystem::path InferGameExeDirFromModules(const std::vector<ModuleInfo>&
   return {};
 }
 
-std::wstring FindBundledGameRuntimeDllPath(const std::vector<ModuleInfo>& modules, const wchar_t* moduleName)
+std::wstring FindBundledGameRuntimeDllPath(const ModuleTable& modules, const wchar_t* moduleName)
 {
   if (!moduleName || !*moduleName) {
     return {};
@@ -243,42 +244,71 @@ std::wstring ResolveSymbolSearchPath(
 
 }  // namespace
 
-SymSession::SymSession(const std::vector<ModuleInfo>& modules, bool allowOnlineSymbols)
+SymbolRuntime ProbeSymbolRuntime(const ModuleTable& modules, bool allowOnlineSymbols)
+{
+  SymbolRuntime rt;
+  rt.dbghelpPath = ResolveRuntimeDllPath(L"dbghelp.dll");
+  if (!rt.dbghelpPath.empty()) {
+    const auto version = QueryFileVersionString(std::filesystem::path(rt.dbghelpPath));
+    rt.dbghelpVersion.assign(version.begin(), version.end());
+  }
+  if (rt.dbghelpPath.empty()) {
+    rt.runtimeDegraded = true;
+    rt.runtimeDiagnostics.push_back(L"[Symbols] dbghelp.dll runtime not resolved; stackwalk quality may be degraded");
+  } else if (rt.dbghelpVersion.empty()) {
+    rt.runtimeDegraded = true;
+    rt.runtimeDiagnostics.push_back(L"[Symbols] dbghelp.dll version unreadable; runtime health is uncertain");
+  }
+
+  rt.msdiaPath = ResolveRuntimeDllPath(L"msdia140.dll");
+  if (rt.msdiaPath.empty()) {
+    rt.bundledMsdiaPath = FindBundledGameRuntimeDllPath(modules, L"msdia140.dll");
+    rt.msdiaPath = rt.bundledMsdiaPath;
+  }
+  rt.msdiaAvailable = !rt.msdiaPath.empty();
+  if (!rt.msdiaAvailable) {
+    rt.runtimeDegraded = true;
+    rt.runtimeDiagnostics.push_back(L"[Symbols] msdia140.dll not found; source line resolution may be limited");
+  }
+
+  bool searchPathFromEnv = false;
+  rt.searchPath = ResolveSymbolSearchPath(&rt.cachePath, allowOnlineSymbols, &rt.symbolCacheReady, &searchPathFromEnv);
+  if (rt.searchPath.empty()) {
+    rt.runtimeDegraded = true;
+    rt.runtimeDiagnostics.push_back(L"[Symbols] symbol search path is empty; symbolization will be limited");
+  }
+  if (!rt.cachePath.empty() && !rt.symbolCacheReady) {
+    rt.runtimeDegraded = true;
+    rt.runtimeDiagnostics.push_back(L"[Symbols] symbol cache directory unavailable; local-cache symbolization may be limited");
+  }
+  if (!allowOnlineSymbols &&
+      searchPathFromEnv &&
+      (WideContainsAsciiInsensitive(rt.searchPath, "https://") || WideContainsAsciiInsensitive(rt.searchPath, "http://"))) {
+    rt.runtimeDegraded = true;
+    rt.runtimeDiagnostics.push_back(L"[Symbols] explicit symbol path includes online source while policy disables it");
+  }
+  return rt;
+}
+
+SymSession::SymSession(const ModuleTable& modules, bool allowOnlineSymbols)
 {
   dbghelp_lock = std::unique_lock<std::mutex>(DbgHelpGlobalMutex());
   process = GetCurrentProcess();
 
-  dbghelpPath = ResolveRuntimeDllPath(L"dbghelp.dll");
-  if (!dbghelpPath.empty()) {
-    const auto version = QueryFileVersionString(std::filesystem::path(dbghelpPath));
-    dbghelpVersion.assign(version.begin(), version.end());
-  }
-  if (dbghelpPath.empty()) {
-    runtimeDegraded = true;
-    runtimeDiagnostics.push_back(L"[Symbols] dbghelp.dll runtime not resolved; stackwalk quality may be degraded");
-  } else if (dbghelpVersion.empty()) {
-    runtimeDegraded = true;
-    runtimeDiagnostics.push_back(L"[Symbols] dbghelp.dll version unreadable; runtime health is uncertain");
-  }
-
-  msdiaPath = ResolveRuntimeDllPath(L"msdia140.dll");
-  if (msdiaPath.empty()) {
-    if (const std::wstring bundledMsdiaPath = FindBundledGameRuntimeDllPath(modules, L"msdia140.dll");
-        !bundledMsdiaPath.empty()) {
-      ownedMsdiaModule = LoadLibraryW(bundledMsdiaPath.c_str());
-      if (ownedMsdiaModule) {
-        msdiaPath = QueryLoadedModulePath(L"msdia140.dll");
-        if (msdiaPath.empty()) {
-          msdiaPath = bundledMsdiaPath;
-        }
+  runtime = ProbeSymbolRuntime(modules, allowOnlineSymbols);
+  if (!runtime.bundledMsdiaPath.empty()) {
+    ownedMsdiaModule = LoadLibraryW(runtime.bundledMsdiaPath.c_str());
+    if (ownedMsdiaModule) {
+      if (const std::wstring loadedPath = QueryLoadedModulePath(L"msdia140.dll"); !loadedPath.empty()) {
+        runtime.msdiaPath = loadedPath;
       }
+    } else {
+      runtime.msdiaPath.clear();
+      runtime.msdiaAvailable = false;
+      runtime.runtimeDegraded = true;
+      runtime.runtimeDiagnostics.push_back(L"[Symbols] msdia140.dll not found; source line resolution may be limited");
     }
   }
-  msdiaAvailable = !msdiaPath.empty();
-  if (!msdiaAvailable) {
-    runtimeDegraded = true;
-    runtimeDiagnostics.push_back(L"[Symbols] msdia140.dll not found; source line resolution may be limited");
-  }
 
   DWORD opts = SymGetOptions();
   opts |= SYMOPT_UNDNAME;
@@ -287,35 +317,19 @@ SymSession::SymSession(const std::vector<ModuleInfo>& modules, bool allowOnlineS
   opts |= SYMOPT_NO_PROMPTS;
   SymSetOptions(opts);
 
-  bool searchPathFromEnv = false;
-  searchPath = ResolveSymbolSearchPath(&cachePath, allowOnlineSymbols, &symbolCacheReady, &searchPathFromEnv);
-  if (searchPath.empty()) {
-    runtimeDegraded = true;
-    runtimeDiagnostics.push_back(L"[Symbols] symbol search path is empty; symbolization will be limited");
-  }
-  if (!cachePath.empty() && !symbolCacheReady) {
-    runtimeDegraded = true;
-    runtimeDiagnostics.push_back(L"[Symbols] symbol cache directory unavailable; local-cache symbolization may be limited");
-  }
-  if (!allowOnlineSymbols &&
-      searchPathFromEnv &&
-      (WideContainsAsciiInsensitive(searchPath, "https://") || WideContainsAsciiInsensitive(searchPath, "http://"))) {
-    runtimeDegraded = true;
-    runtimeDiagnostics.push_back(L"[Symbols] explicit symbol path includes online source while policy disables it");
-  }
-  ok = SymInitializeW(process, searchPath.empty() ? nullptr : searchPath.c_str(), FALSE) != FALSE;
+  ok = SymInitializeW(process, runtime.searchPath.empty() ? nullptr : runtime.searchPath.c_str(), FALSE) != FALSE;
   if (!ok) {
-    runtimeDegraded = true;
-    runtimeDiagnostics.push_back(L"[Symbols] SymInitializeW failed; stackwalk symbolization unavailable");
+    runtime.runtimeDegraded = true;
+    runtime.runtimeDiagnostics.push_back(L"[Symbols] SymInitializeW failed; stackwalk symbolization unavailable");
     return;
   }
 
   wchar_t actualSearchPath[4096]{};
   if (SymGetSearchPathW(process, actualSearchPath, static_cast<DWORD>(std::size(actualSearchPath))) &&
       actualSearchPath[0] != L'\0') {
-    searchPath = actualSearchPath;
+    runtime.searchPath = actualSearchPath;
   }
-  usedOnlineSymbolSource = (searchPath.find(L"https://") != std::wstring::npos);
+  runtime.usedOnlineSymbolSource = (runtime.searchPath.find(L"https://") != std::wstring::npos);
 
   for (const auto& m : modules) {
     if (m.path.empty() || m.base == 0 || m.end <= m.base) {
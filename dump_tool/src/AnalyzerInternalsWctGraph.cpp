@@ -0,0 +1,372 @@
+#include "WctTypes.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <nlohmann/json.hpp>
+
+namespace skydiag::dump_tool::internal {
+namespace {
+
+constexpr std::size_t kMaxReportedCycles = 16u;
+constexpr std::size_t kMaxReportedChainThreads = 64u;
+constexpr std::uint32_t kNoIndex = std::numeric_limits<std::uint32_t>::max();
+
+struct GraphNode
+{
+  bool is_thread = false;
+  std::uint32_t tid = 0;
+  std::string lock_name;
+  std::vector<std::uint32_t> out;
+};
+
+class WaitGraph
+{
+public:
+  std::uint32_t ThreadNode(std::uint32_t tid)
+  {
+    const auto [it, inserted] = m_threadIndex.emplace(tid, static_cast<std::uint32_t>(m_nodes.size()));
+    if (inserted) {
+      GraphNode node{};
+      node.is_thread = true;
+      node.tid = tid;
+      m_nodes.push_back(std::move(node));
+    }
+    return it->second;
+  }
+
+  std::uint32_t LockNode(const std::string& key, const std::string& name)
+  {
+    const auto [it, inserted] = m_lockIndex.emplace(key, static_cast<std::uint32_t>(m_nodes.size()));
+    if (inserted) {
+      GraphNode node{};
+      node.lock_name = name;
+      m_nodes.push_back(std::move(node));
+    }
+    return it->second;
+  }
+
+  void AddEdge(std::uint32_t from, std::uint32_t to)
+  {
+    const std::uint64_t key = (static_cast<std::uint64_t>(from) << 32) | to;
+    if (m_edgeKeys.insert(key).second) {
+      m_nodes[from].out.push_back(to);
+    }
+  }
+
+  const std::vector<GraphNode>& Nodes() const { return m_nodes; }
+  std::size_t EdgeCount() const { return m_edgeKeys.size(); }
+  std::size_t LockCount() const { return m_lockIndex.size(); }
+  std::size_t ThreadCount() const { return m_threadIndex.size(); }
+
+private:
+  std::vector<GraphNode> m_nodes;
+  std::unordered_map<std::uint32_t, std::uint32_t> m_threadIndex;
+  std::unordered_map<std::string, std::uint32_t> m_lockIndex;
+  std::unordered_set<std::uint64_t> m_edgeKeys;
+};
+
+// WCT emits one chain per thread: thread, lock, owner thread, lock, ... Named
+// locks are shared across chains by name. Unnamed locks (critical sections
+// usually have no name) are keyed by their owner so two waiters on the same
+// owner still meet at one node; without an owner they stay private to the
+// waiter.
+void AddChain(WaitGraph& graph, std::uint32_t chainTid, const nlohmann::json& nodes)
+{
+  std::uint32_t prevThread = kNoIndex;
+  bool havePendingLock = false;
+  std::uint32_t pendingType = 0;
+  std::string pendingName;
+
+  const auto flushPendingLock = [&](std::uint32_t ownerTid) {
+    std::string key = pendingName.empty()
+      ? ("type:" + std::to_string(pendingType) +
+          (ownerTid != 0u ? "@owner:" + std::to_string(ownerTid) : "@waiter:" + std::to_string(graph.Nodes()[prevThread].tid)))
+      : ("name:" + pendingName);
+    const auto lock = graph.LockNode(key, pendingName);
+    graph.AddEdge(prevThread, lock);
+    havePendingLock = false;
+    return lock;
+  };
+
+  for (const auto& node : nodes) {
+    if (!node.is_object()) {
+      continue;
+    }
+    const auto threadIt = node.find("thread");
+    if (threadIt != node.end() && threadIt->is_object()) {
+      std::uint32_t tid = 0;
+      const auto idIt = threadIt->find("threadId");
+      if (idIt != threadIt->end() && idIt->is_number_unsigned()) {
+        tid = idIt->get<std::uint32_t>();
+      }
+      if (tid == 0u && prevThread == kNoIndex) {
+        tid = chainTid;
+      }
+      if (tid == 0u) {
+        // An owner we cannot name breaks the chain; later nodes are not
+        // attributable to a known waiter.
+        break;
+      }
+      const auto current = graph.ThreadNode(tid);
+      if (prevThread != kNoIndex) {
+        if (havePendingLock) {
+          graph.AddEdge(flushPendingLock(tid), current);
+        } else {
+          graph.AddEdge(prevThread, current);
+        }
+      }
+      prevThread = current;
+      continue;
+    }
+
+    if (prevThread == kNoIndex) {
+      if (chainTid == 0u) {
+        break;
+      }
+      prevThread = graph.ThreadNode(chainTid);
+    }
+    if (havePendingLock) {
+      flushPendingLock(0u);
+    }
+    havePendingLock = true;
+    pendingType = 0;
+    const auto typeIt = node.find("objectType");
+    if (typeIt != node.end() && typeIt->is_number_unsigned()) {
+      pendingType = typeIt->get<std::uint32_t>();
+    }
+    pendingName.clear();
+    const auto nameIt = node.find("objectName");
+    if (nameIt != node.end() && nameIt->is_string()) {
+      pendingName = nameIt->get<std::string>();
+    }
+  }
+
+  if (havePendingLock && prevThread != kNoIndex) {
+    flushPendingLock(0u);
+  }
+}
+
+struct SccResult
+{
+  std::vector<std::uint32_t> component;           // node -> SCC id
+  std::vector<std::vector<std::uint32_t>> members;  // SCC id -> nodes, in reverse topological order
+};
+
+// Iterative Tarjan so a long chain cannot exhaust the analyzer's stack.
+// Components are emitted after every component reachable from them, which the
+// longest-chain pass below relies on.
+SccResult ComputeStronglyConnectedComponents(const std::vector<GraphNode>& nodes)
+{
+  const std::size_t n = nodes.size();
+  SccResult result{};
+  result.component.assign(n, kNoIndex);
+
+  std::vector<std::uint32_t> index(n, kNoIndex);
+  std::vector<std::uint32_t> lowlink(n, 0);
+  std::vector<bool> onStack(n, false);
+  std::vector<std::uint32_t> stack;
+  struct Frame
+  {
+    std::uint32_t node = 0;
+    std::size_t nextEdge = 0;
+  };
+  std::vector<Frame> callStack;
+  std::uint32_t nextIndex = 0;
+
+  for (std::uint32_t root = 0; root < n; ++root) {
+    if (index[root] != kNoIndex) {
+      continue;
+    }
+    callStack.push_back(Frame{ root, 0 });
+    index[root] = lowlink[root] = nextIndex++;
+    stack.push_back(root);
+    onStack[root] = true;
+
+    while (!callStack.empty()) {
+      auto& frame = callStack.back();
+      const auto v = frame.node;
+      if (frame.nextEdge < nodes[v].out.size()) {
+        const auto w = nodes[v].out[frame.nextEdge++];
+        if (index[w] == kNoIndex) {
+          index[w] = lowlink[w] = nextIndex++;
+          stack.push_back(w);
+          onStack[w] = true;
+          callStack.push_back(Frame{ w, 0 });
+        } else if (onStack[w]) {
+          lowlink[v] = std::min(lowlink[v], index[w]);
+        }
+        continue;
+      }
+
+      if (lowlink[v] == index[v]) {
+        const auto id = static_cast<std::uint32_t>(result.members.size());
+        result.members.emplace_back();
+        std::uint32_t w = kNoIndex;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          onStack[w] = false;
+          result.component[w] = id;
+          result.members.back().push_back(w);
+        } while (w != v);
+      }
+      callStack.pop_back();
+      if (!callStack.empty()) {
+        const auto parent = callStack.back().node;
+        lowlink[parent] = std::min(lowlink[parent], lowlink[v]);
+      }
+    }
+  }
+  return result;
+}
+
+bool IsCyclicComponent(const std::vector<GraphNode>& nodes, const std::vector<std::uint32_t>& members)
+{
+  if (members.size() > 1u) {
+    return true;
+  }
+  const auto v = members.front();
+  return std::find(nodes[v].out.begin(), nodes[v].out.end(), v) != nodes[v].out.end();
+}
+
+std::vector<std::uint32_t> SortedThreadIds(const std::vector<GraphNode>& nodes, const std::vector<std::uint32_t>& members)
+{
+  std::vector<std::uint32_t> tids;
+  for (const auto v : members) {
+    if (nodes[v].is_thread) {
+      tids.push_back(nodes[v].tid);
+    }
+  }
+  std::sort(tids.begin(), tids.end());
+  return tids;
+}
+
+}  // namespace
+
+std::optional<WctWaitGraphSummary> TryBuildWctWaitGraph(std::string_view wctJsonUtf8)
+{
+  if (wctJsonUtf8.empty()) {
+    return std::nullopt;
+  }
+
+  try {
+    const auto j = nlohmann::json::parse(wctJsonUtf8, nullptr, /*allow_exceptions=*/true);
+    if (!j.is_object()) {
+      return std::nullopt;
+    }
+    const auto threadsIt = j.find("threads");
+    if (threadsIt == j.end() || !threadsIt->is_array()) {
+      return std::nullopt;
+    }
+
+    WaitGraph graph;
+    for (const auto& t : *threadsIt) {
+      if (!t.is_object()) {
+        continue;
+      }
+      const auto tidIt = t.find("tid");
+      const std::uint32_t tid = (tidIt != t.end() && tidIt->is_number_unsigned()) ? tidIt->get<std::uint32_t>() : 0u;
+      const auto nodesIt = t.find("nodes");
+      if (nodesIt == t.end() || !nodesIt->is_array()) {
+        continue;
+      }
+      AddChain(graph, tid, *nodesIt);
+    }
+
+    const auto& nodes = graph.Nodes();
+    WctWaitGraphSummary summary{};
+    summary.has = true;
+    summary.thread_nodes = static_cast<std::uint32_t>(graph.ThreadCount());
+    summary.lock_nodes = static_cast<std::uint32_t>(graph.LockCount());
+    summary.edges = static_cast<std::uint32_t>(graph.EdgeCount());
+    if (nodes.empty()) {
+      return summary;
+    }
+
+    const auto scc = ComputeStronglyConnectedComponents(nodes);
+    const std::size_t componentCount = scc.members.size();
+    std::vector<bool> cyclic(componentCount, false);
+    std::vector<std::uint32_t> weight(componentCount, 0);
+    for (std::size_t c = 0; c < componentCount; ++c) {
+      cyclic[c] = IsCyclicComponent(nodes, scc.members[c]);
+      for (const auto v : scc.members[c]) {
+        if (nodes[v].is_thread) {
+          ++weight[c];
+        }
+      }
+      if (!cyclic[c]) {
+        continue;
+      }
+      WctWaitGraphCycle cycle{};
+      cycle.thread_ids = SortedThreadIds(nodes, scc.members[c]);
+      for (const auto v : scc.members[c]) {
+        if (!nodes[v].is_thread && !nodes[v].lock_name.empty()) {
+          cycle.lock_names.push_back(nodes[v].lock_name);
+        }
+      }
+      std::sort(cycle.lock_names.begin(), cycle.lock_names.end());
+      if (!cycle.thread_ids.empty()) {
+        summary.cycles.push_back(std::move(cycle));
+      }
+    }
+    std::sort(summary.cycles.begin(), summary.cycles.end(), [](const WctWaitGraphCycle& a, const WctWaitGraphCycle& b) {
+      if (a.thread_ids.size() != b.thread_ids.size()) {
+        return a.thread_ids.size() > b.thread_ids.size();
+      }
+      return a.thread_ids < b.thread_ids;
+    });
+    if (summary.cycles.size() > kMaxReportedCycles) {
+      summary.cycles.resize(kMaxReportedCycles);
+    }
+
+    // Longest path over the condensation DAG, weighted by thread count.
+    // Components arrive sinks-first, so every successor is final before use.
+    std::vector<std::uint32_t> best(componentCount, 0);
+    std::vector<std::uint32_t> next(componentCount, kNoIndex);
+    for (std::uint32_t c = 0; c < componentCount; ++c) {
+      std::uint32_t bestSucc = 0;
+      for (const auto v : scc.members[c]) {
+        for (const auto w : nodes[v].out) {
+          const auto succ = scc.component[w];
+          if (succ == c) {
+            continue;
+          }
+          if (next[c] == kNoIndex || best[succ] > bestSucc) {
+            bestSucc = best[succ];
+            next[c] = succ;
+          }
+        }
+      }
+      best[c] = weight[c] + bestSucc;
+    }
+
+    std::uint32_t head = kNoIndex;
+    for (std::uint32_t c = 0; c < componentCount; ++c) {
+      if (weight[c] == 0u) {
+        continue;
+      }
+      if (head == kNoIndex || best[c] > best[head]) {
+        head = c;
+      }
+    }
+    for (auto c = head; c != kNoIndex; c = next[c]) {
+      if (cyclic[c]) {
+        summary.longest_chain_has_cycle = true;
+      }
+      for (const auto tid : SortedThreadIds(nodes, scc.members[c])) {
+        if (summary.longest_chain_tids.size() >= kMaxReportedChainThreads) {
+          break;
+        }
+        summary.longest_chain_tids.push_back(tid);
+      }
+    }
+    return summary;
+  } catch (...) {
+    return std::nullopt;
+  }
+}
+
+}  // namespace skydiag::dump_tool::internal
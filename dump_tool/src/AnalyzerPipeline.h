@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Analyzer.h"
+#include "CrashLogger.h"
 #include "MinidumpUtil.h"
 #include "Mo2Index.h"
 
@@ -14,28 +15,24 @@
 namespace skydiag::dump_tool {
 
 std::optional<CONTEXT> ParseExceptionInfo(
-  void* dumpBase,
-  std::uint64_t dumpSize,
+  const minidump::MinidumpIndex& dump,
   AnalysisResult& out);
 
 void ResolveFaultModule(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<minidump::ModuleInfo>& allModules,
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& allModules,
   AnalysisResult& out);
 
 void ParseBlackboxStream(
-  void* dumpBase,
-  std::uint64_t dumpSize,
+  const minidump::MinidumpIndex& dump,
   const std::optional<Mo2Index>& mo2Index,
   const std::vector<std::wstring>& modulePaths,
   AnalysisResult& out);
 
 void IntegratePluginScan(
   const std::wstring& dumpPath,
-  const std::vector<minidump::ModuleInfo>& allModules,
-  void* dumpBase,
-  std::uint64_t dumpSize,
+  const minidump::ModuleTable& allModules,
+  const minidump::MinidumpIndex& dump,
   const AnalyzeOptions& opt,
   AnalysisResult& out);
 
@@ -43,20 +40,59 @@ bool DetermineHangLike(
   bool nameHang,
   const AnalysisResult& out);
 
-void IntegrateCrashLoggerLog(
+// Crash Logger log search and read, split from IntegrateCrashLoggerLog so the
+// directory walk can run on the analysis task graph. Touches no AnalysisResult.
+struct CrashLoggerLogLookup
+{
+  std::optional<std::filesystem::path> log_path;
+  CrashLoggerPairingMetadata pairing{};
+  std::wstring search_err;
+  std::optional<std::string> log_utf8;
+  std::wstring read_err;
+};
+
+CrashLoggerLogLookup FindCrashLoggerLog(
   const std::wstring& dumpPath,
-  const std::vector<minidump::ModuleInfo>& allModules,
+  const minidump::ModuleTable& allModules,
   const std::vector<std::wstring>& modulePaths,
-  const std::optional<Mo2Index>& mo2Index,
+  const std::optional<Mo2Index>& mo2Index);
+
+void IntegrateCrashLoggerLog(
+  const CrashLoggerLogLookup& lookup,
+  const minidump::ModuleTable& allModules,
   AnalysisResult& out);
 
 void ComputeSuspects(
-  void* dumpBase,
-  std::uint64_t dumpSize,
-  const std::vector<minidump::ModuleInfo>& allModules,
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& allModules,
   const std::optional<CONTEXT>& excCtx,
   bool hangLike,
   const AnalyzeOptions& opt,
+  AnalysisResult& out,
+  const minidump::MemoryOverlaySource* overlay = nullptr,
+  const std::filesystem::path& moduleCacheDir = {});
+
+// Incremental recapture: when the dump carries a DumpDelta stream and its base
+// dump is still on disk unchanged, maps the base into `baseFile`. The caller
+// then analyzes the base and overlays the delta's memory on the stackwalk
+// view only. That is the one stage that follows pointers into captured
+// memory; the stack scan reads thread stacks, which the delta never carries,
+// and the delta's own streams (exception, threads, blackbox) are not read.
+bool TryOpenDumpDeltaBase(
+  const std::wstring& dumpPath,
+  void* dumpBase,
+  std::uint64_t dumpSize,
+  minidump::MappedFile* baseFile,
+  AnalysisResult& out);
+
+void BuildWctWaitGraphAnalysis(
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& allModules,
+  AnalysisResult& out);
+
+void ParseHangPrecaptureStream(
+  const minidump::MinidumpIndex& dump,
+  const minidump::ModuleTable& allModules,
   AnalysisResult& out);
 
 std::filesystem::path ResolveCrashHistoryPath(
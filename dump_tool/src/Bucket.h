@@ -98,4 +98,42 @@ inline std::wstring ComputeCrashBucketKey(
   return wss.str();
 }
 
+// The helper writes an approximate HFP1 fingerprint into the incident manifest
+// at capture time (exception code, fault module offset, stack-scan frames).
+// Stack scanning also picks up stale return addresses, so a helper frame only
+// counts as confirmed when the stackwalk has the same module+offset.
+struct HelperFingerprintCheck
+{
+  bool faultConsistent = false;
+  std::size_t framesConfirmed = 0;
+  std::size_t framesTotal = 0;
+};
+
+inline HelperFingerprintCheck CheckHelperFingerprint(
+  std::uint32_t helperExceptionCode,
+  std::wstring_view helperFaultModule,
+  std::uint64_t helperFaultOffset,
+  const std::vector<CrashBucketFrame>& helperFrames,
+  std::uint32_t exceptionCode,
+  std::wstring_view faultModule,
+  std::uint64_t faultModuleOffset,
+  const std::vector<CrashBucketFrame>& stackwalkFrames)
+{
+  HelperFingerprintCheck out{};
+  out.faultConsistent = helperExceptionCode == exceptionCode &&
+    bucket::LowerTrimmed(helperFaultModule) == bucket::LowerTrimmed(faultModule) &&
+    helperFaultOffset == faultModuleOffset;
+  out.framesTotal = helperFrames.size();
+  for (const auto& hf : helperFrames) {
+    const auto module = bucket::LowerTrimmed(hf.module_filename);
+    const bool found = std::any_of(stackwalkFrames.begin(), stackwalkFrames.end(), [&](const CrashBucketFrame& sf) {
+      return sf.module_offset == hf.module_offset && bucket::LowerTrimmed(sf.module_filename) == module;
+    });
+    if (found) {
+      out.framesConfirmed++;
+    }
+  }
+  return out;
+}
+
 }  // namespace skydiag::dump_tool
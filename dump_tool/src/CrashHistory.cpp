@@ -1,4 +1,5 @@
 #include "CrashHistory.h"
+#include "DumpIdentity.h"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -36,6 +37,40 @@ std::string NormalizeStoredCandidateKey(std::string_view value)
   return key;
 }
 
+// Identity keys are "<digest>.<size>.<mtime>" where the digest is a flat
+// SHA-256 or a prefixed tree root (DumpIdentity::DigestKey). The two hash the
+// same bytes differently, so a row recorded under one algorithm stays
+// readable after switching to the other: same file generation (metadata
+// suffix) and same dump file name count as the same dump.
+bool IsTreeIdentityKey(std::string_view key)
+{
+  return key.substr(0, kTreeSha256DigestKeyPrefix.size()) == kTreeSha256DigestKeyPrefix;
+}
+
+std::string_view IdentityKeyMetadata(std::string_view key)
+{
+  const auto dot = key.find('.');
+  return dot == std::string_view::npos ? std::string_view{} : key.substr(dot + 1u);
+}
+
+bool IsSameDumpIdentity(
+  const CrashHistoryEntry& row,
+  std::string_view identityKey,
+  std::string_view normalizedDumpFile)
+{
+  if (row.dump_identity_key == identityKey) {
+    return true;
+  }
+  if (IsTreeIdentityKey(row.dump_identity_key) == IsTreeIdentityKey(identityKey) ||
+      normalizedDumpFile.empty()) {
+    return false;
+  }
+  const auto metadata = IdentityKeyMetadata(identityKey);
+  return !metadata.empty() &&
+    IdentityKeyMetadata(row.dump_identity_key) == metadata &&
+    NormalizeStoredCandidateKey(row.dump_file) == normalizedDumpFile;
+}
+
 void UpsertHistoryEntry(std::vector<CrashHistoryEntry>* entries, CrashHistoryEntry entry)
 {
   if (!entries || entry.dump_file.empty()) {
@@ -49,7 +84,7 @@ void UpsertHistoryEntry(std::vector<CrashHistoryEntry>* entries, CrashHistoryEnt
   const auto existing = std::find_if(entries->begin(), entries->end(), [&](const CrashHistoryEntry& row) {
     if (!entry.dump_identity_key.empty()) {
       return !row.dump_identity_key.empty() &&
-        row.dump_identity_key == entry.dump_identity_key;
+        IsSameDumpIdentity(row, entry.dump_identity_key, dumpKey);
     }
     return row.dump_identity_key.empty() &&
       NormalizeStoredCandidateKey(row.dump_file) == dumpKey;
@@ -224,7 +259,7 @@ std::size_t CrashHistory::RemoveEntriesForDumpFile(
   m_entries.erase(
     std::remove_if(m_entries.begin(), m_entries.end(), [&](const CrashHistoryEntry& row) {
       if (!dumpIdentityKey.empty() && !row.dump_identity_key.empty()) {
-        return row.dump_identity_key == dumpIdentityKey;
+        return IsSameDumpIdentity(row, dumpIdentityKey, dumpKey);
       }
       // Legacy rows have no identity. Exclude same-basename legacy evidence
       // conservatively for current-incident correlation, but never merge it
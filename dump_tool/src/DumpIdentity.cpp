@@ -1,72 +1,21 @@
 #include "DumpIdentity.h"
 
+#include "DumpIdentityCache.h"
+#include "Sha256.h"
+
 #include <Windows.h>
-#include <bcrypt.h>
 
 #include <algorithm>
-#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <iomanip>
 #include <limits>
 #include <sstream>
 #include <utility>
-#include <vector>
 
 namespace skydiag::dump_tool {
 namespace {
 
-class BCryptAlgorithm final
-{
-public:
-  ~BCryptAlgorithm()
-  {
-    if (handle_) {
-      BCryptCloseAlgorithmProvider(handle_, 0);
-    }
-  }
-
-  BCRYPT_ALG_HANDLE* Put() noexcept { return &handle_; }
-  BCRYPT_ALG_HANDLE Get() const noexcept { return handle_; }
-
-private:
-  BCRYPT_ALG_HANDLE handle_ = nullptr;
-};
-
-class BCryptHash final
-{
-public:
-  ~BCryptHash()
-  {
-    if (handle_) {
-      BCryptDestroyHash(handle_);
-    }
-  }
-
-  BCRYPT_HASH_HANDLE* Put() noexcept { return &handle_; }
-  BCRYPT_HASH_HANDLE Get() const noexcept { return handle_; }
-
-private:
-  BCRYPT_HASH_HANDLE handle_ = nullptr;
-};
-
-bool BCryptSucceeded(NTSTATUS status) noexcept
-{
-  return status >= 0;
-}
-
-std::string HexLower(const std::vector<std::uint8_t>& bytes)
-{
-  static constexpr char kHex[] = "0123456789abcdef";
-  std::string out;
-  out.resize(bytes.size() * 2u);
-  for (std::size_t i = 0; i < bytes.size(); ++i) {
-    out[i * 2u] = kHex[(bytes[i] >> 4u) & 0x0fu];
-    out[i * 2u + 1u] = kHex[bytes[i] & 0x0fu];
-  }
-  return out;
-}
-
 void SetError(std::wstring* err, std::wstring message)
 {
   if (err) {
@@ -136,8 +85,50 @@ bool IsSameFileGeneration(
          before.last_write_time_utc_100ns == after.last_write_time_utc_100ns;
 }
 
+DumpIdentityCacheKey CacheKeyFor(const DumpHandleMetadata& metadata) noexcept
+{
+  DumpIdentityCacheKey key{};
+  key.volume_serial_number = metadata.volume_serial_number;
+  key.file_index = metadata.file_index;
+  key.size_bytes = metadata.size_bytes;
+  key.last_write_time_utc_100ns = metadata.last_write_time_utc_100ns;
+  return key;
+}
+
+std::string HashMappedDump(
+  const std::uint8_t* bytes,
+  std::uint64_t size,
+  const DumpIdentityOptions& options)
+{
+  if (options.algorithm == DumpIdentityAlgorithm::kTreeSha256) {
+    return Sha256HexLower(ComputeTreeSha256(bytes, size, kTreeSha256DefaultLeafBytes, options.workers));
+  }
+  Sha256 hash;
+  std::uint64_t offset = 0;
+  constexpr std::uint64_t kHashChunkBytes = 64ull * 1024ull * 1024ull;
+  while (offset < size) {
+    const auto take = (std::min)(kHashChunkBytes, size - offset);
+    hash.Update(bytes + static_cast<std::size_t>(offset), static_cast<std::size_t>(take));
+    offset += take;
+  }
+  return Sha256HexLower(hash.Finish());
+}
+
 }  // namespace
 
+std::string_view DumpIdentityAlgorithmName(DumpIdentityAlgorithm algorithm) noexcept
+{
+  return algorithm == DumpIdentityAlgorithm::kTreeSha256 ? "tree-sha256" : "sha256";
+}
+
+std::string DumpIdentity::DigestKey() const
+{
+  if (algorithm == DumpIdentityAlgorithm::kTreeSha256) {
+    return std::string(kTreeSha256DigestKeyPrefix) + sha256;
+  }
+  return sha256;
+}
+
 std::string DumpIdentity::StorageMetadataKey() const
 {
   if (!IsValid()) {
@@ -180,7 +171,8 @@ bool ComputeDumpIdentity(
   const void* mappedBytes,
   std::uint64_t mappedSize,
   DumpIdentity* out,
-  std::wstring* err)
+  std::wstring* err,
+  const DumpIdentityOptions& options)
 {
   const HANDLE dumpFile = static_cast<HANDLE>(dumpFileHandle);
   if (!out || !dumpFile || dumpFile == INVALID_HANDLE_VALUE ||
@@ -200,83 +192,20 @@ bool ComputeDumpIdentity(
     return false;
   }
 
-  BCryptAlgorithm algorithm;
-  if (!BCryptSucceeded(BCryptOpenAlgorithmProvider(
-        algorithm.Put(),
-        BCRYPT_SHA256_ALGORITHM,
-        nullptr,
-        0))) {
-    SetError(err, L"BCryptOpenAlgorithmProvider(SHA256) failed");
-    return false;
-  }
-
-  DWORD objectLength = 0;
-  DWORD resultLength = 0;
-  if (!BCryptSucceeded(BCryptGetProperty(
-        algorithm.Get(),
-        BCRYPT_OBJECT_LENGTH,
-        reinterpret_cast<PUCHAR>(&objectLength),
-        sizeof(objectLength),
-        &resultLength,
-        0)) ||
-      objectLength == 0u) {
-    SetError(err, L"BCrypt SHA256 object length query failed");
-    return false;
-  }
-
-  DWORD hashLength = 0;
-  if (!BCryptSucceeded(BCryptGetProperty(
-        algorithm.Get(),
-        BCRYPT_HASH_LENGTH,
-        reinterpret_cast<PUCHAR>(&hashLength),
-        sizeof(hashLength),
-        &resultLength,
-        0)) ||
-      hashLength != 32u) {
-    SetError(err, L"BCrypt SHA256 hash length query failed");
-    return false;
-  }
-
-  std::vector<std::uint8_t> hashObject(objectLength);
-  BCryptHash hash;
-  if (!BCryptSucceeded(BCryptCreateHash(
-        algorithm.Get(),
-        hash.Put(),
-        hashObject.data(),
-        static_cast<ULONG>(hashObject.size()),
-        nullptr,
-        0,
-        0))) {
-    SetError(err, L"BCryptCreateHash(SHA256) failed");
-    return false;
-  }
-
-  const auto* bytes = static_cast<const std::uint8_t*>(mappedBytes);
-  std::uint64_t offset = 0;
-  constexpr std::uint64_t kHashChunkBytes = 64ull * 1024ull * 1024ull;
-  while (offset < mappedSize) {
-    const auto take64 = (std::min)(kHashChunkBytes, mappedSize - offset);
-    const auto take = static_cast<ULONG>(take64);
-    if (!BCryptSucceeded(BCryptHashData(
-          hash.Get(),
-          const_cast<PUCHAR>(bytes + static_cast<std::size_t>(offset)),
-          take,
-          0))) {
-      SetError(err, L"BCryptHashData(SHA256) failed");
-      return false;
+  const auto cacheKey = CacheKeyFor(metadataBefore);
+  const auto algorithmName = DumpIdentityAlgorithmName(options.algorithm);
+  if (auto cached = LookupDumpIdentityCache(options.cache_dir, cacheKey, algorithmName)) {
+    out->algorithm = options.algorithm;
+    out->sha256 = std::move(*cached);
+    out->size_bytes = metadataBefore.size_bytes;
+    out->last_write_time_utc_100ns = metadataBefore.last_write_time_utc_100ns;
+    if (err) {
+      err->clear();
     }
-    offset += take64;
+    return true;
   }
 
-  std::vector<std::uint8_t> digest(hashLength);
-  if (!BCryptSucceeded(BCryptFinishHash(
-        hash.Get(),
-        digest.data(),
-        static_cast<ULONG>(digest.size()),
-        0))) {
-    SetError(err, L"BCryptFinishHash(SHA256) failed");
-    return false;
-  }
+  std::string digest = HashMappedDump(static_cast<const std::uint8_t*>(mappedBytes), mappedSize, options);
 
   DumpHandleMetadata metadataAfter{};
   if (!ReadDumpHandleMetadata(dumpFileHandle, &metadataAfter, err)) {
@@ -287,7 +216,10 @@ bool ComputeDumpIdentity(
     return false;
   }
 
-  out->sha256 = HexLower(digest);
+  // A failed cache write only costs a rehash next time.
+  StoreDumpIdentityCache(options.cache_dir, cacheKey, algorithmName, digest);
+  out->algorithm = options.algorithm;
+  out->sha256 = std::move(digest);
   out->size_bytes = metadataBefore.size_bytes;
   out->last_write_time_utc_100ns = metadataBefore.last_write_time_utc_100ns;
   if (err) {
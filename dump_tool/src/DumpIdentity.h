@@ -1,13 +1,30 @@
 #pragma once
 
 #include <cstdint>
+#include <filesystem>
 #include <string>
+#include <string_view>
 
 namespace skydiag::dump_tool {
 
+enum class DumpIdentityAlgorithm : std::uint8_t
+{
+  kSha256,      // flat SHA-256 of the file (skydiag.dump_identity.v1)
+  kTreeSha256,  // ComputeTreeSha256 root, leaves hashed in parallel (v2)
+};
+
+// "sha256" / "tree-sha256": the algorithm field of v2 identity JSON and the
+// identity cache.
+std::string_view DumpIdentityAlgorithmName(DumpIdentityAlgorithm algorithm) noexcept;
+
+// Digest keys of tree identities carry this prefix so they can never collide
+// with, or be mistaken for, a flat SHA-256 of the same file.
+inline constexpr std::string_view kTreeSha256DigestKeyPrefix = "tree-sha256-";
+
 struct DumpIdentity
 {
-  std::string sha256;
+  DumpIdentityAlgorithm algorithm = DumpIdentityAlgorithm::kSha256;
+  std::string sha256;  // lowercase hex; the tree root for kTreeSha256
   std::uint64_t size_bytes = 0;
   std::uint64_t last_write_time_utc_100ns = 0;
 
@@ -22,17 +39,32 @@ struct DumpIdentity
   // components so same-content files with different FILETIME values never
   // share authoritative summary or triage state.
   [[nodiscard]] std::string StorageMetadataKey() const;
+
+  // Digest path component for persisted state: the flat hex digest, or the
+  // prefixed tree root. Flat identities keep the layout they always had.
+  [[nodiscard]] std::string DigestKey() const;
+};
+
+struct DumpIdentityOptions
+{
+  DumpIdentityAlgorithm algorithm = DumpIdentityAlgorithm::kSha256;
+  // Directory for the identity cache (see DumpIdentityCache.h); empty = none.
+  std::filesystem::path cache_dir;
+  unsigned workers = 0;  // tree leaves; 0 = hardware_concurrency()
 };
 
 // dumpFileHandle must be the same still-open file object that owns mappedBytes.
 // Metadata and the SHA-256 are read from that single generation even if the
 // original path is renamed or replaced while analysis is running.
+// With a cache_dir, a digest recorded for the same file ID, size and
+// last-write time is reused instead of rehashing the file.
 bool ComputeDumpIdentity(
   void* dumpFileHandle,
   const void* mappedBytes,
   std::uint64_t mappedSize,
   DumpIdentity* out,
-  std::wstring* err);
+  std::wstring* err,
+  const DumpIdentityOptions& options = {});
 
 bool ReadDumpFileMetadata(
   void* dumpFileHandle,
@@ -0,0 +1,177 @@
+#include "DumpIdentityCache.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+namespace skydiag::dump_tool {
+namespace {
+
+constexpr const char* kCacheSchema = "skydiag.dump_identity_cache.v1";
+
+std::atomic<std::uint64_t> g_cacheTempCounter{ 0u };
+
+bool IsLowerHexDigest(std::string_view value)
+{
+  if (value.size() != 64u) {
+    return false;
+  }
+  for (const char ch : value) {
+    if (!((ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f'))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool KeyMatches(const nlohmann::json& j, const DumpIdentityCacheKey& key)
+{
+  return j.value("volume_serial_number", std::uint64_t{ 0 }) == key.volume_serial_number &&
+    j.value("file_index", std::uint64_t{ 0 }) == key.file_index &&
+    j.value("size_bytes", std::uint64_t{ 0 }) == key.size_bytes &&
+    j.value("last_write_time_utc_100ns", std::uint64_t{ 0 }) == key.last_write_time_utc_100ns;
+}
+
+std::optional<nlohmann::json> ReadCacheFile(const std::filesystem::path& path)
+{
+  try {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+      return std::nullopt;
+    }
+    auto j = nlohmann::json::parse(f, nullptr, false);
+    if (!j.is_object() || j.value("schema", "") != kCacheSchema) {
+      return std::nullopt;
+    }
+    return j;
+  } catch (...) {
+    return std::nullopt;
+  }
+}
+
+}  // namespace
+
+std::filesystem::path DumpIdentityCachePath(
+  const std::filesystem::path& cacheDir,
+  const DumpIdentityCacheKey& key)
+{
+  char name[48]{};
+  std::snprintf(
+    name,
+    sizeof(name),
+    "%08x-%016llx.json",
+    static_cast<unsigned>(key.volume_serial_number),
+    static_cast<unsigned long long>(key.file_index));
+  return cacheDir / name;
+}
+
+std::optional<std::string> LookupDumpIdentityCache(
+  const std::filesystem::path& cacheDir,
+  const DumpIdentityCacheKey& key,
+  std::string_view algorithm)
+{
+  if (cacheDir.empty() || key.size_bytes == 0u || key.last_write_time_utc_100ns == 0u) {
+    return std::nullopt;
+  }
+  const auto j = ReadCacheFile(DumpIdentityCachePath(cacheDir, key));
+  if (!j || !KeyMatches(*j, key)) {
+    return std::nullopt;
+  }
+  const auto digests = j->find("digests");
+  if (digests == j->end() || !digests->is_object()) {
+    return std::nullopt;
+  }
+  const auto it = digests->find(std::string(algorithm));
+  if (it == digests->end() || !it->is_string()) {
+    return std::nullopt;
+  }
+  std::string hex = it->get<std::string>();
+  if (!IsLowerHexDigest(hex)) {
+    return std::nullopt;
+  }
+  return hex;
+}
+
+bool StoreDumpIdentityCache(
+  const std::filesystem::path& cacheDir,
+  const DumpIdentityCacheKey& key,
+  std::string_view algorithm,
+  std::string_view hexDigest)
+{
+  if (cacheDir.empty() || !IsLowerHexDigest(hexDigest) ||
+      key.size_bytes == 0u || key.last_write_time_utc_100ns == 0u) {
+    return false;
+  }
+  try {
+    const auto path = DumpIdentityCachePath(cacheDir, key);
+
+    // Keep the other algorithm's digest when it describes the same generation.
+    nlohmann::json digests = nlohmann::json::object();
+    if (const auto existing = ReadCacheFile(path); existing && KeyMatches(*existing, key)) {
+      const auto it = existing->find("digests");
+      if (it != existing->end() && it->is_object()) {
+        digests = *it;
+      }
+    }
+    digests[std::string(algorithm)] = std::string(hexDigest);
+
+    const nlohmann::json j = {
+      { "schema", kCacheSchema },
+      { "volume_serial_number", key.volume_serial_number },
+      { "file_index", key.file_index },
+      { "size_bytes", key.size_bytes },
+      { "last_write_time_utc_100ns", key.last_write_time_utc_100ns },
+      { "digests", digests },
+    };
+
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDir, ec);
+    if (ec) {
+      return false;
+    }
+    auto tempPath = path;
+    const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    tempPath += ".tmp." + std::to_string(now) + "." +
+      std::to_string(g_cacheTempCounter.fetch_add(1u, std::memory_order_relaxed));
+
+    bool wrote = false;
+    {
+      std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+      if (out) {
+        out << j.dump(2);
+        out.flush();
+        out.close();
+        wrote = static_cast<bool>(out);
+      }
+    }
+    if (!wrote) {
+      std::filesystem::remove(tempPath, ec);
+      return false;
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+      std::filesystem::remove(tempPath, ec);
+      return false;
+    }
+#else
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+      std::filesystem::remove(tempPath, ec);
+      return false;
+    }
+#endif
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+}  // namespace skydiag::dump_tool
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace skydiag::dump_tool {
+
+// Which file generation a cached digest belongs to. The file ID survives a
+// rename, so a dump moved within the volume still hits; any write changes
+// the size or last-write time and misses.
+struct DumpIdentityCacheKey
+{
+  std::uint32_t volume_serial_number = 0;
+  std::uint64_t file_index = 0;
+  std::uint64_t size_bytes = 0;
+  std::uint64_t last_write_time_utc_100ns = 0;
+};
+
+// One small JSON sidecar per file ID under `cacheDir`
+// (skydiag.dump_identity_cache.v1), holding a digest per algorithm name
+// ("sha256", "tree-sha256"). Entries whose key no longer matches are ignored
+// and overwritten; a corrupt or unreadable file is treated as a miss.
+std::filesystem::path DumpIdentityCachePath(
+  const std::filesystem::path& cacheDir,
+  const DumpIdentityCacheKey& key);
+
+std::optional<std::string> LookupDumpIdentityCache(
+  const std::filesystem::path& cacheDir,
+  const DumpIdentityCacheKey& key,
+  std::string_view algorithm);
+
+// Best effort: returns false when the sidecar could not be written.
+bool StoreDumpIdentityCache(
+  const std::filesystem::path& cacheDir,
+  const DumpIdentityCacheKey& key,
+  std::string_view algorithm,
+  std::string_view hexDigest);
+
+}  // namespace skydiag::dump_tool
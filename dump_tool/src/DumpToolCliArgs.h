@@ -16,6 +16,7 @@ struct DumpToolCliArgs
   std::optional<bool> allow_online_symbols;
 
   bool debug = false;
+  bool tree_identity = false;  // identity as a parallel tree hash (not flat SHA-256)
   std::wstring lang_token;  // e.g. "en", "ko"
 };
 
@@ -31,6 +32,7 @@ inline std::wstring DumpToolCliUsage()
     L"  --no-online-symbols        Disallow symbol server usage\n"
     L"  --lang <token>             Language token (e.g. en, ko)\n"
     L"  --debug                    Disable path redaction\n"
+    L"  --tree-identity            Identify the dump by a parallel tree hash\n"
     L"  --headless                 Accepted for compatibility (ignored)\n"
     L"  --help                     Show this help\n";
 }
@@ -76,6 +78,11 @@ inline bool ParseDumpToolCliArgs(const std::vector<std::wstring_view>& argv, Dum
       continue;
     }
 
+    if (a == L"--tree-identity") {
+      out->tree_identity = true;
+      continue;
+    }
+
     if (a == L"--allow-online-symbols") {
       out->allow_online_symbols = true;
       continue;
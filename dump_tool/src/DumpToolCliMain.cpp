@@ -85,6 +85,9 @@ int wmain(int argc, wchar_t** argv)
   AnalyzeOptions opt{};
   opt.debug = a.debug;
   opt.redact_paths = !a.debug;
+  if (a.tree_identity) {
+    opt.identity_algorithm = DumpIdentityAlgorithm::kTreeSha256;
+  }
   if (a.allow_online_symbols.has_value()) {
     opt.allow_online_symbols = a.allow_online_symbols.value();
   } else {
@@ -5,6 +5,7 @@
 
 #include "AnalyzerScoringPolicy.h"
 #include "CandidateConsensus.h"
+#include "FreezeCandidateConsensus.h"
 #include "MinidumpUtil.h"
 #include "Utf.h"
 
@@ -349,7 +350,8 @@ void AddHangThreadGroupSignal(const AnalysisResult& r, bool en, std::vector<Cand
         L" other stable threads retained the same module near their active stacks")
     : (L"메인 스레드와 다른 " + std::to_wstring(consensus.matching_thread_count - 1u) +
         L"개 정지 스레드의 현재 스택 상단에 동일 모듈이 반복됨");
-  signal.weight = 5u;
+  // A module on nearly every stack is only weak evidence for this one.
+  signal.weight = IsUbiquitousConsensusModule(consensus) ? 2u : 5u;
   if (!signal.candidate_key.empty()) {
     out->push_back(std::move(signal));
   }
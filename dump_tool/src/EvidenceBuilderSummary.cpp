@@ -1,5 +1,6 @@
 #include "EvidenceBuilderPrivate.h"
 #include "EvidenceBuilderEvidencePipeline.h"
+#include "FreezeCandidateConsensus.h"
 
 #include <algorithm>
 #include <cwchar>
@@ -600,14 +601,19 @@ std::wstring BuildSummarySentence(const AnalysisResult& r, i18n::Language lang,
 
       if (r.hang_thread_module_consensus.has_consensus) {
         const auto& consensus = r.hang_thread_module_consensus;
+        const bool ubiquitous = IsUbiquitousConsensusModule(consensus);
         summary = en
           ? (hangPrefix + L" " + consensus.module_filename + L" appears on the game main thread and " +
               std::to_wstring(consensus.matching_thread_count - 1u) +
-              L" other non-progressing threads, supporting a module-level synchronization stall. WCT did not prove an OS lock cycle. (Confidence: Medium)")
+              (ubiquitous
+                 ? L" other non-progressing threads, but it is on nearly every thread's stack, so this does not single it out. WCT did not prove an OS lock cycle. (Confidence: Low)"
+                 : L" other non-progressing threads, supporting a module-level synchronization stall. WCT did not prove an OS lock cycle. (Confidence: Medium)"))
           : (hangPrefix + L" 게임 메인 스레드와 진행이 멈춘 다른 " +
               std::to_wstring(consensus.matching_thread_count - 1u) + L"개 스레드에서 " +
               consensus.module_filename +
-              L"이(가) 반복되어 모듈 내부 동기화 정지 가능성이 높습니다. WCT가 OS 잠금 사이클을 입증한 것은 아닙니다. (신뢰도: 중간)");
+              (ubiquitous
+                 ? L"이(가) 반복되지만 거의 모든 스레드 스택에 있는 모듈이라 원인으로 특정하기 어렵습니다. WCT가 OS 잠금 사이클을 입증한 것은 아닙니다. (신뢰도: 낮음)"
+                 : L"이(가) 반복되어 모듈 내부 동기화 정지 가능성이 높습니다. WCT가 OS 잠금 사이클을 입증한 것은 아닙니다. (신뢰도: 중간)"));
       } else if (hasSuspect && !suspectWho.empty()) {
         if (!r.suspects_from_stackwalk) {
           summary = en
@@ -48,6 +48,27 @@ bool HasLiveProcessCapture(const FreezeSignalInput& input)
   return input.wct && input.wct->has_capture;
 }
 
+bool HasWaitGraphCycle(const FreezeSignalInput& input)
+{
+  return input.wait_graph && !input.wait_graph->cycles.empty();
+}
+
+std::wstring JoinThreadIds(const std::vector<std::uint32_t>& tids, std::size_t maxCount)
+{
+  std::wstring joined;
+  const std::size_t limit = std::min(tids.size(), maxCount);
+  for (std::size_t i = 0; i < limit; ++i) {
+    if (i != 0u) {
+      joined += L", ";
+    }
+    joined += std::to_wstring(tids[i]);
+  }
+  if (tids.size() > limit) {
+    joined += L", ...";
+  }
+  return joined;
+}
+
 bool HasConsensusBackedDeadlock(const FreezeSignalInput& input)
 {
   return input.wct &&
@@ -118,6 +139,14 @@ std::string DetermineSupportQuality(
 
 }  // namespace
 
+bool IsUbiquitousConsensusModule(const HangThreadModuleConsensus& consensus)
+{
+  constexpr std::uint32_t kMinScannedThreads = 8u;
+  return consensus.whole_stack_scanned_thread_count >= kMinScannedThreads &&
+         static_cast<std::uint64_t>(consensus.whole_stack_thread_count) * 10u >=
+           static_cast<std::uint64_t>(consensus.whole_stack_scanned_thread_count) * 9u;
+}
+
 FreezeAnalysisResult BuildFreezeCandidateConsensus(const FreezeSignalInput& input, i18n::Language language)
 {
   FreezeAnalysisResult result{};
@@ -153,18 +182,40 @@ FreezeAnalysisResult BuildFreezeCandidateConsensus(const FreezeSignalInput& inpu
     result.support_quality = "multi_thread_consensus";
   }
 
-  if (input.wct && input.wct->cycles > 0) {
+  if (input.wait_graph.has_value()) {
+    result.wait_graph = *input.wait_graph;
+  }
+
+  if ((input.wct && input.wct->cycles > 0) || HasWaitGraphCycle(input)) {
     result.state_id = "deadlock_likely";
     const bool repeatedCycleSupport =
-      consensusBackedDeadlock || (input.wct->cycle_consensus && input.wct->longest_wait_tid_consensus);
+      consensusBackedDeadlock ||
+      (input.wct && input.wct->cycle_consensus && input.wct->longest_wait_tid_consensus);
     result.confidence_level = repeatedCycleSupport
       ? i18n::ConfidenceLevel::kHigh
       : i18n::ConfidenceLevel::kMedium;
-    result.primary_reasons.push_back(
-      language == i18n::Language::kEnglish
-        ? L"WCT reported cycle threads"
-        : L"WCT에서 cycle thread가 감지됨");
-    if (input.wct->cycle_consensus && !input.wct->repeated_cycle_tids.empty()) {
+    if (input.wct && input.wct->cycles > 0) {
+      result.primary_reasons.push_back(
+        language == i18n::Language::kEnglish
+          ? L"WCT reported cycle threads"
+          : L"WCT에서 cycle thread가 감지됨");
+    }
+    if (!result.wait_graph.cycles.empty()) {
+      const auto& cycle = result.wait_graph.cycles.front();
+      result.primary_reasons.push_back(
+        language == i18n::Language::kEnglish
+          ? (L"The WCT wait graph closes a lock cycle over threads " + JoinThreadIds(cycle.thread_ids, 6) +
+              L" (cycles=" + std::to_wstring(result.wait_graph.cycles.size()) + L")")
+          : (L"WCT 대기 그래프에서 스레드 " + JoinThreadIds(cycle.thread_ids, 6) +
+              L" 사이의 잠금 사이클이 확인됨 (cycles=" + std::to_wstring(result.wait_graph.cycles.size()) + L")"));
+      if (!cycle.modules.empty()) {
+        result.primary_reasons.push_back(
+          language == i18n::Language::kEnglish
+            ? (L"Modules near the cycle threads' stacks: " + JoinModules(cycle.modules, 3))
+            : (L"사이클 스레드 스택 상단의 모듈: " + JoinModules(cycle.modules, 3)));
+      }
+    }
+    if (input.wct && input.wct->cycle_consensus && !input.wct->repeated_cycle_tids.empty()) {
       result.primary_reasons.push_back(
         language == i18n::Language::kEnglish
           ? (L"Repeated WCT captures preserved the same cycle thread set (count=" +
@@ -172,7 +223,7 @@ FreezeAnalysisResult BuildFreezeCandidateConsensus(const FreezeSignalInput& inpu
           : (L"반복 WCT 캡처에서 같은 cycle thread 집합이 유지됨 (count=" +
               std::to_wstring(input.wct->repeated_cycle_tids.size()) + L")"));
     }
-    if (input.wct->longest_wait_tid != 0u) {
+    if (input.wct && input.wct->longest_wait_tid != 0u) {
       result.primary_reasons.push_back(
         language == i18n::Language::kEnglish
           ? L"A blocked thread with the longest observed wait was identified"
@@ -207,6 +258,19 @@ FreezeAnalysisResult BuildFreezeCandidateConsensus(const FreezeSignalInput& inpu
       language == i18n::Language::kEnglish
         ? L"This supports a logical synchronization stall, but WCT did not prove an OS lock cycle"
         : L"논리적 동기화 정지를 뒷받침하지만 WCT가 OS 잠금 사이클을 입증한 것은 아님");
+    if (IsUbiquitousConsensusModule(result.thread_module_consensus)) {
+      result.confidence_level = i18n::ConfidenceLevel::kLow;
+      result.primary_reasons.push_back(
+        language == i18n::Language::kEnglish
+          ? (L"A whole-stack scan found " + result.thread_module_consensus.module_filename + L" on " +
+              std::to_wstring(result.thread_module_consensus.whole_stack_thread_count) + L" of " +
+              std::to_wstring(result.thread_module_consensus.whole_stack_scanned_thread_count) +
+              L" threads, so the thread group does not single it out")
+          : (L"전체 스택 스캔에서 " + result.thread_module_consensus.module_filename + L"이(가) " +
+              std::to_wstring(result.thread_module_consensus.whole_stack_scanned_thread_count) + L"개 중 " +
+              std::to_wstring(result.thread_module_consensus.whole_stack_thread_count) +
+              L"개 스레드에 나타나 스레드 그룹 합의가 이 모듈을 특정하지 못함"));
+    }
   } else if (loadingSignal && freezeLike) {
     result.state_id = "loader_stall_likely";
     result.confidence_level = (strongLoaderContext || consensusBackedLoaderSignal)
@@ -298,6 +362,17 @@ FreezeAnalysisResult BuildFreezeCandidateConsensus(const FreezeSignalInput& inpu
     seenNames.insert(related.display_name);
     result.related_candidates.push_back(std::move(related));
   }
+  if (result.state_id == "deadlock_likely") {
+    for (const auto& cycle : result.wait_graph.cycles) {
+      for (const auto& moduleName : cycle.modules) {
+        if (moduleName.empty() || seenNames.contains(moduleName) || result.related_candidates.size() >= 4u) {
+          continue;
+        }
+        result.related_candidates.push_back(ToRelatedModuleCandidate(moduleName, language));
+        seenNames.insert(moduleName);
+      }
+    }
+  }
   if (input.blackbox.has_value()) {
     for (const auto& moduleName : input.blackbox->recent_non_system_modules) {
       if (moduleName.empty() || seenNames.contains(moduleName)) {
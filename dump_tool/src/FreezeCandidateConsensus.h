@@ -17,9 +17,16 @@ struct FreezeSignalInput
   std::optional<BlackboxFreezeSummary> blackbox;
   std::optional<FirstChanceSummary> first_chance;
   std::optional<HangThreadModuleConsensus> thread_module_consensus;
+  std::optional<WaitGraphAnalysis> wait_graph;
   std::vector<ActionableCandidate> actionable_candidates;
 };
 
+// True when the whole-stack scan found the consensus module on (nearly) every
+// readable thread stack. Hook frameworks and thread-start shims sit on all
+// stacks whether or not they are involved, so the near-stack consensus does
+// not single such a module out and is reported with low confidence.
+bool IsUbiquitousConsensusModule(const HangThreadModuleConsensus& consensus);
+
 FreezeAnalysisResult BuildFreezeCandidateConsensus(const FreezeSignalInput& input, i18n::Language language);
 
 }  // namespace skydiag::dump_tool
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace skydiag::dump_tool::internal {
+
+// Mirrors the helper's kMinidumpUserStream_HangPrecapture JSON payload.
+struct HangPrecaptureThread
+{
+  std::uint32_t tid = 0;
+  std::uint64_t rip = 0;
+  std::uint64_t rsp = 0;
+  std::vector<std::uint64_t> stack;
+};
+
+struct HangPrecaptureSnapshot
+{
+  std::uint64_t offset_ms = 0;
+  double seconds_since_heartbeat = 0.0;
+  std::uint32_t threshold_sec = 0;
+  std::uint32_t state_flags = 0;
+  std::uint32_t main_tid = 0;
+  std::vector<HangPrecaptureThread> threads;
+};
+
+struct HangPrecaptureStream
+{
+  std::uint32_t version = 0;
+  std::uint32_t capacity = 0;
+  std::uint64_t dropped = 0;
+  std::vector<HangPrecaptureSnapshot> snapshots;
+};
+
+std::optional<HangPrecaptureStream> TryParseHangPrecapture(std::string_view jsonUtf8);
+
+// Main-thread sample of one snapshot, or nullptr when the main thread was not
+// captured in it.
+const HangPrecaptureThread* FindMainThreadSample(const HangPrecaptureSnapshot& snapshot);
+
+// Number of trailing snapshots in which the main thread sat on the same RIP.
+std::uint32_t CountTrailingStableMainThreadRip(const HangPrecaptureStream& stream);
+
+}  // namespace skydiag::dump_tool::internal
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace skydiag::dump_tool {
+
+struct AddressSpan
+{
+  std::uint64_t start = 0;
+  std::uint64_t end = 0;  // exclusive
+};
+
+// Sorts and merges overlapping or touching spans; empty spans are dropped.
+inline std::vector<AddressSpan> CoalesceSpans(std::vector<AddressSpan> spans)
+{
+  spans.erase(
+    std::remove_if(spans.begin(), spans.end(), [](const AddressSpan& s) { return s.end <= s.start; }),
+    spans.end());
+  std::sort(spans.begin(), spans.end(), [](const AddressSpan& a, const AddressSpan& b) { return a.start < b.start; });
+  std::vector<AddressSpan> out;
+  out.reserve(spans.size());
+  for (const auto& span : spans) {
+    if (!out.empty() && span.start <= out.back().end) {
+      out.back().end = std::max(out.back().end, span.end);
+    } else {
+      out.push_back(span);
+    }
+  }
+  return out;
+}
+
+// Parts of [start, end) that no span in `covered` reaches. `covered` must be
+// sorted by start and disjoint (see CoalesceSpans). Used to lay an
+// incremental recapture underneath its base dump: the base always wins.
+inline std::vector<AddressSpan> UncoveredSpans(
+  const std::vector<AddressSpan>& covered,
+  std::uint64_t start,
+  std::uint64_t end)
+{
+  std::vector<AddressSpan> out;
+  if (end <= start) {
+    return out;
+  }
+
+  auto it = std::upper_bound(covered.begin(), covered.end(), start, [](std::uint64_t value, const AddressSpan& span) {
+    return value < span.start;
+  });
+  // The span that starts at or before `start` may still reach into it.
+  std::uint64_t cursor = start;
+  if (it != covered.begin() && std::prev(it)->end > cursor) {
+    cursor = std::min(std::prev(it)->end, end);
+  }
+
+  for (; it != covered.end() && it->start < end && cursor < end; ++it) {
+    if (it->start > cursor) {
+      out.push_back({ cursor, it->start });
+    }
+    cursor = std::max(cursor, std::min(it->end, end));
+  }
+  if (cursor < end) {
+    out.push_back({ cursor, end });
+  }
+  return out;
+}
+
+}  // namespace skydiag::dump_tool
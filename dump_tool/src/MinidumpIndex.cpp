@@ -0,0 +1,96 @@
+#include "MinidumpIndex.h"
+
+#include <algorithm>
+
+namespace skydiag::dump_tool::minidump {
+
+bool MinidumpIndex::Build(const void* data, std::uint64_t size, std::string* err)
+{
+  m_streams.clear();
+  m_modules.clear();
+  m_threads.clear();
+  m_threadsByTid.clear();
+  m_exception.reset();
+  m_memory = MinidumpMemory{};
+  if (!m_reader.Open(data, size, err)) {
+    return false;
+  }
+
+  // One pass over the directory; a stream whose bytes fall outside the file
+  // keeps its slot (as an empty span) so a later duplicate cannot shadow it,
+  // matching MinidumpReader::Stream().
+  m_streams.reserve(m_reader.StreamCount());
+  for (std::uint32_t i = 0; i < m_reader.StreamCount(); ++i) {
+    const auto entry = m_reader.DirectoryEntry(i);
+    StreamEntry s{};
+    s.type = entry.type;
+    s.valid = entry.location.dataSize == 0 || !m_reader.Bytes(entry.location.rva, entry.location.dataSize).empty();
+    if (s.valid && entry.location.dataSize != 0) {
+      s.bytes = m_reader.Bytes(entry.location.rva, entry.location.dataSize);
+    }
+    m_streams.push_back(s);
+  }
+  std::stable_sort(m_streams.begin(), m_streams.end(), [](const StreamEntry& a, const StreamEntry& b) {
+    return a.type < b.type;
+  });
+  m_streams.erase(
+    std::unique(m_streams.begin(), m_streams.end(), [](const StreamEntry& a, const StreamEntry& b) { return a.type == b.type; }),
+    m_streams.end());
+
+  m_modules = m_reader.Modules();
+  std::sort(m_modules.begin(), m_modules.end(), [](const auto& a, const auto& b) { return a.base < b.base; });
+  m_threads = m_reader.Threads();
+  m_threadsByTid.resize(m_threads.size());
+  for (std::uint32_t i = 0; i < m_threadsByTid.size(); ++i) {
+    m_threadsByTid[i] = i;
+  }
+  std::stable_sort(m_threadsByTid.begin(), m_threadsByTid.end(), [this](std::uint32_t a, std::uint32_t b) {
+    return m_threads[a].tid < m_threads[b].tid;
+  });
+  m_exception = m_reader.Exception();
+  m_memory = MinidumpMemory(m_reader);
+  return true;
+}
+
+void MinidumpIndex::PrefetchThreadStacks() const
+{
+  std::vector<ByteSpan> stacks;
+  stacks.reserve(m_threads.size());
+  for (const auto& t : m_threads) {
+    stacks.push_back(m_reader.Bytes(t.stack));
+  }
+  PrefetchMappedSpans(stacks);
+}
+
+std::optional<ByteSpan> MinidumpIndex::Stream(std::uint32_t type) const
+{
+  const auto it = std::lower_bound(m_streams.begin(), m_streams.end(), type, [](const StreamEntry& s, std::uint32_t t) {
+    return s.type < t;
+  });
+  if (it == m_streams.end() || it->type != type || !it->valid) {
+    return std::nullopt;
+  }
+  return it->bytes;
+}
+
+const MinidumpModuleRecord* MinidumpIndex::FindModule(std::uint64_t addr) const
+{
+  auto it = std::upper_bound(m_modules.begin(), m_modules.end(), addr, [](std::uint64_t value, const auto& m) {
+    return value < m.base;
+  });
+  if (it == m_modules.begin()) {
+    return nullptr;
+  }
+  --it;
+  return (addr - it->base) < it->size ? &*it : nullptr;
+}
+
+const MinidumpThreadRecord* MinidumpIndex::FindThread(std::uint32_t tid) const
+{
+  const auto it = std::lower_bound(m_threadsByTid.begin(), m_threadsByTid.end(), tid, [this](std::uint32_t pos, std::uint32_t value) {
+    return m_threads[pos].tid < value;
+  });
+  return (it != m_threadsByTid.end() && m_threads[*it].tid == tid) ? &m_threads[*it] : nullptr;
+}
+
+}  // namespace skydiag::dump_tool::minidump
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "MinidumpReader.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace skydiag::dump_tool::minidump {
+
+// Everything the analysis stages look up in a dump, decoded once per
+// AnalyzeDump: the stream table, modules (sorted by base), threads (dump
+// order, with a tid lookup) and the memory-range table. Stages take it by
+// const reference instead of re-walking the directory or re-decoding lists
+// per lookup. Like the reader it borrows the mapped bytes, which must outlive
+// it.
+class MinidumpIndex
+{
+public:
+  bool Build(const void* data, std::uint64_t size, std::string* err);
+
+  const MinidumpReader& Reader() const noexcept { return m_reader; }
+  // Raw view for code that still addresses the dump by pointer and size.
+  void* Base() const noexcept { return const_cast<std::uint8_t*>(m_reader.Data()); }
+  std::uint64_t Size() const noexcept { return m_reader.Size(); }
+
+  std::optional<ByteSpan> Stream(std::uint32_t type) const;
+
+  const std::vector<MinidumpModuleRecord>& Modules() const noexcept { return m_modules; }
+  const MinidumpModuleRecord* FindModule(std::uint64_t addr) const;
+
+  const std::vector<MinidumpThreadRecord>& Threads() const noexcept { return m_threads; }
+  const MinidumpThreadRecord* FindThread(std::uint32_t tid) const;
+
+  const std::optional<MinidumpExceptionRecord>& Exception() const noexcept { return m_exception; }
+  const MinidumpMemory& Memory() const noexcept { return m_memory; }
+
+  // Starts read-ahead of every captured thread stack (PrefetchMappedSpans).
+  // The stack scans and stack walks read these in many small pieces; on a
+  // cold full dump that is otherwise a page fault per piece.
+  void PrefetchThreadStacks() const;
+
+private:
+  struct StreamEntry
+  {
+    std::uint32_t type = 0;
+    bool valid = false;
+    ByteSpan bytes;
+  };
+
+  MinidumpReader m_reader;
+  std::vector<StreamEntry> m_streams;  // sorted by type; first directory entry wins
+  std::vector<MinidumpModuleRecord> m_modules;
+  std::vector<MinidumpThreadRecord> m_threads;
+  std::vector<std::uint32_t> m_threadsByTid;  // positions in m_threads, sorted by tid
+  std::optional<MinidumpExceptionRecord> m_exception;
+  MinidumpMemory m_memory;
+};
+
+}  // namespace skydiag::dump_tool::minidump
@@ -0,0 +1,523 @@
+#include "MinidumpReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace skydiag::dump_tool::minidump {
+
+namespace {
+
+// On-disk sizes (DbgHelp packs these structures to 4 bytes).
+constexpr std::uint64_t kHeaderSize = 32;
+constexpr std::uint64_t kDirectorySize = 12;
+constexpr std::uint64_t kModuleSize = 108;
+constexpr std::uint64_t kThreadSize = 48;
+constexpr std::uint64_t kMemoryDescriptorSize = 16;
+constexpr std::uint64_t kMemoryDescriptor64Size = 16;
+constexpr std::uint64_t kExceptionStreamSize = 168;
+constexpr std::uint32_t kVsFixedFileInfoSignature = 0xFEEF04BDu;
+
+template <class T>
+T Load(const std::uint8_t* p)
+{
+  T v{};
+  std::memcpy(&v, p, sizeof(T));
+  return v;
+}
+
+template <class T>
+T Load(ByteSpan bytes, std::size_t off)
+{
+  return Load<T>(bytes.data() + off);
+}
+
+MinidumpLocation LoadLocation(ByteSpan bytes, std::size_t off)
+{
+  return MinidumpLocation{ Load<std::uint32_t>(bytes, off), Load<std::uint32_t>(bytes, off + 4) };
+}
+
+// Count-prefixed array of `entrySize` records starting at `entriesOff`;
+// returns the usable count (0 when the stream cannot hold what it claims).
+std::uint64_t CheckedCount(ByteSpan stream, std::uint64_t count, std::uint64_t entriesOff, std::uint64_t entrySize)
+{
+  if (stream.size() < entriesOff) {
+    return 0;
+  }
+  const std::uint64_t room = (stream.size() - entriesOff) / entrySize;
+  return count <= room ? count : 0;
+}
+
+void AppendUtf8(std::string* out, std::uint32_t cp)
+{
+  if (cp < 0x80u) {
+    out->push_back(static_cast<char>(cp));
+  } else if (cp < 0x800u) {
+    out->push_back(static_cast<char>(0xC0u | (cp >> 6)));
+    out->push_back(static_cast<char>(0x80u | (cp & 0x3Fu)));
+  } else if (cp < 0x10000u) {
+    out->push_back(static_cast<char>(0xE0u | (cp >> 12)));
+    out->push_back(static_cast<char>(0x80u | ((cp >> 6) & 0x3Fu)));
+    out->push_back(static_cast<char>(0x80u | (cp & 0x3Fu)));
+  } else {
+    out->push_back(static_cast<char>(0xF0u | (cp >> 18)));
+    out->push_back(static_cast<char>(0x80u | ((cp >> 12) & 0x3Fu)));
+    out->push_back(static_cast<char>(0x80u | ((cp >> 6) & 0x3Fu)));
+    out->push_back(static_cast<char>(0x80u | (cp & 0x3Fu)));
+  }
+}
+
+}  // namespace
+
+std::string Utf16LeToUtf8(ByteSpan bytes)
+{
+  std::string out;
+  out.reserve(bytes.size() / 2);
+  const std::size_t units = bytes.size() / 2;
+  for (std::size_t i = 0; i < units; ++i) {
+    const std::uint32_t u = Load<std::uint16_t>(bytes, i * 2);
+    if (u >= 0xD800u && u <= 0xDBFFu && i + 1 < units) {
+      const std::uint32_t lo = Load<std::uint16_t>(bytes, (i + 1) * 2);
+      if (lo >= 0xDC00u && lo <= 0xDFFFu) {
+        AppendUtf8(&out, 0x10000u + ((u - 0xD800u) << 10) + (lo - 0xDC00u));
+        ++i;
+        continue;
+      }
+    }
+    AppendUtf8(&out, (u >= 0xD800u && u <= 0xDFFFu) ? 0xFFFDu : u);
+  }
+  return out;
+}
+
+bool MinidumpReader::Open(const void* data, std::uint64_t size, std::string* err)
+{
+  m_base = nullptr;
+  m_size = 0;
+  m_streamCount = 0;
+  m_directoryRva = 0;
+
+  const auto fail = [err](const char* msg) {
+    if (err) *err = msg;
+    return false;
+  };
+  if (!data || size < kHeaderSize) {
+    return fail("file is smaller than a minidump header");
+  }
+  const auto* base = static_cast<const std::uint8_t*>(data);
+  if (Load<std::uint32_t>(base) != kMinidumpSignature) {
+    return fail("missing MDMP signature");
+  }
+  const std::uint32_t streams = Load<std::uint32_t>(base + 8);
+  const std::uint32_t dirRva = Load<std::uint32_t>(base + 12);
+  if (dirRva > size || streams > (size - dirRva) / kDirectorySize) {
+    return fail("stream directory is out of bounds");
+  }
+
+  m_base = base;
+  m_size = size;
+  m_streamCount = streams;
+  m_directoryRva = dirRva;
+  if (err) err->clear();
+  return true;
+}
+
+ByteSpan MinidumpReader::Bytes(std::uint64_t rva, std::uint64_t size) const
+{
+  if (!m_base || rva > m_size || size > m_size - rva) {
+    return {};
+  }
+  return ByteSpan(m_base + rva, static_cast<std::size_t>(size));
+}
+
+ByteSpan MinidumpReader::Bytes(const MinidumpLocation& loc) const
+{
+  if (loc.rva == 0 || loc.dataSize == 0) {
+    return {};
+  }
+  return Bytes(loc.rva, loc.dataSize);
+}
+
+MinidumpDirectoryEntry MinidumpReader::DirectoryEntry(std::uint32_t i) const
+{
+  if (!m_base || i >= m_streamCount) {
+    return {};
+  }
+  const auto* entry = m_base + m_directoryRva + static_cast<std::uint64_t>(i) * kDirectorySize;
+  return MinidumpDirectoryEntry{
+    Load<std::uint32_t>(entry),
+    MinidumpLocation{ Load<std::uint32_t>(entry + 4), Load<std::uint32_t>(entry + 8) },
+  };
+}
+
+std::optional<ByteSpan> MinidumpReader::Stream(std::uint32_t type) const
+{
+  for (std::uint32_t i = 0; i < m_streamCount; ++i) {
+    const auto entry = DirectoryEntry(i);
+    if (entry.type != type) {
+      continue;
+    }
+    if (entry.location.dataSize == 0) {
+      return ByteSpan{};
+    }
+    const auto bytes = Bytes(entry.location.rva, entry.location.dataSize);
+    if (bytes.empty()) {
+      return std::nullopt;
+    }
+    return bytes;
+  }
+  return std::nullopt;
+}
+
+bool MinidumpReader::ReadString(std::uint32_t rva, std::string* out) const
+{
+  out->clear();
+  const auto len = Bytes(rva, sizeof(std::uint32_t));
+  if (rva == 0 || len.empty()) {
+    return false;
+  }
+  const std::uint32_t lenBytes = Load<std::uint32_t>(len, 0);
+  if ((lenBytes % 2u) != 0u) {
+    return false;
+  }
+  const auto chars = Bytes(static_cast<std::uint64_t>(rva) + sizeof(std::uint32_t), lenBytes);
+  if (lenBytes != 0 && chars.empty()) {
+    return false;
+  }
+  *out = Utf16LeToUtf8(chars);
+  return true;
+}
+
+std::optional<std::uint16_t> MinidumpReader::ProcessorArchitecture() const
+{
+  const auto s = Stream(kSystemInfoStream);
+  if (!s || s->size() < sizeof(std::uint16_t)) {
+    return std::nullopt;
+  }
+  return Load<std::uint16_t>(*s, 0);
+}
+
+std::vector<MinidumpModuleRecord> MinidumpReader::Modules() const
+{
+  std::vector<MinidumpModuleRecord> out;
+  const auto s = Stream(kModuleListStream);
+  if (!s || s->size() < 4) {
+    return out;
+  }
+  const std::uint64_t n = CheckedCount(*s, Load<std::uint32_t>(*s, 0), 4, kModuleSize);
+  out.reserve(static_cast<std::size_t>(n));
+  for (std::uint64_t i = 0; i < n; ++i) {
+    const std::size_t off = static_cast<std::size_t>(4 + i * kModuleSize);
+    MinidumpModuleRecord m{};
+    m.base = Load<std::uint64_t>(*s, off);
+    m.size = Load<std::uint32_t>(*s, off + 8);
+    m.checksum = Load<std::uint32_t>(*s, off + 12);
+    m.timeDateStamp = Load<std::uint32_t>(*s, off + 16);
+    if (!ReadString(Load<std::uint32_t>(*s, off + 20), &m.path)) {
+      continue;
+    }
+    if (Load<std::uint32_t>(*s, off + 24) == kVsFixedFileInfoSignature) {
+      m.hasVersion = true;
+      m.fileVersionMS = Load<std::uint32_t>(*s, off + 32);
+      m.fileVersionLS = Load<std::uint32_t>(*s, off + 36);
+    }
+    out.push_back(std::move(m));
+  }
+  return out;
+}
+
+std::vector<MinidumpThreadRecord> MinidumpReader::Threads() const
+{
+  std::vector<MinidumpThreadRecord> out;
+  const auto s = Stream(kThreadListStream);
+  if (!s || s->size() < 4) {
+    return out;
+  }
+  const std::uint64_t n = CheckedCount(*s, Load<std::uint32_t>(*s, 0), 4, kThreadSize);
+  out.reserve(static_cast<std::size_t>(n));
+  for (std::uint64_t i = 0; i < n; ++i) {
+    const std::size_t off = static_cast<std::size_t>(4 + i * kThreadSize);
+    MinidumpThreadRecord t{};
+    t.tid = Load<std::uint32_t>(*s, off);
+    t.teb = Load<std::uint64_t>(*s, off + 16);
+    t.stackStart = Load<std::uint64_t>(*s, off + 24);
+    t.stack = LoadLocation(*s, off + 32);
+    t.context = LoadLocation(*s, off + 40);
+    out.push_back(t);
+  }
+  return out;
+}
+
+std::optional<MinidumpExceptionRecord> MinidumpReader::Exception() const
+{
+  const auto s = Stream(kExceptionStream);
+  if (!s || s->size() < kExceptionStreamSize) {
+    return std::nullopt;
+  }
+  MinidumpExceptionRecord e{};
+  e.tid = Load<std::uint32_t>(*s, 0);
+  e.code = Load<std::uint32_t>(*s, 8);
+  e.flags = Load<std::uint32_t>(*s, 12);
+  e.address = Load<std::uint64_t>(*s, 24);
+  e.numberParameters = std::min<std::uint32_t>(Load<std::uint32_t>(*s, 32), 15u);
+  for (std::uint32_t i = 0; i < e.numberParameters; ++i) {
+    e.parameters[i] = Load<std::uint64_t>(*s, 40 + i * 8u);
+  }
+  e.context = LoadLocation(*s, 160);
+  return e;
+}
+
+bool MinidumpReader::ReadContextX64(const MinidumpLocation& loc, ContextX64* out) const
+{
+  const auto bytes = Bytes(loc);
+  if (bytes.empty()) {
+    return false;
+  }
+  std::memset(out, 0, sizeof(*out));
+  std::memcpy(out, bytes.data(), std::min<std::size_t>(bytes.size(), sizeof(*out)));
+  return true;
+}
+
+MinidumpMemory::MinidumpMemory(const MinidumpReader& reader) : m_base(reader.Data())
+{
+  if (const auto s = reader.Stream(kMemory64ListStream); s && s->size() >= 16) {
+    const std::uint64_t n = CheckedCount(*s, Load<std::uint64_t>(*s, 0), 16, kMemoryDescriptor64Size);
+    std::uint64_t cursor = Load<std::uint64_t>(*s, 8);
+    m_regions.reserve(static_cast<std::size_t>(n));
+    for (std::uint64_t i = 0; i < n; ++i) {
+      const std::size_t off = static_cast<std::size_t>(16 + i * kMemoryDescriptor64Size);
+      const std::uint64_t start = Load<std::uint64_t>(*s, off);
+      const std::uint64_t size = Load<std::uint64_t>(*s, off + 8);
+      // Memory64 data is laid out back to back, so one bad range makes every
+      // later one unreliable too.
+      if (reader.Bytes(cursor, size).size() != size) {
+        break;
+      }
+      if (size != 0) {
+        m_regions.push_back({ start, size, cursor });
+      }
+      cursor += size;
+    }
+  }
+  if (m_regions.empty()) {
+    if (const auto s = reader.Stream(kMemoryListStream); s && s->size() >= 4) {
+      const std::uint64_t n = CheckedCount(*s, Load<std::uint32_t>(*s, 0), 4, kMemoryDescriptorSize);
+      m_regions.reserve(static_cast<std::size_t>(n));
+      for (std::uint64_t i = 0; i < n; ++i) {
+        const std::size_t off = static_cast<std::size_t>(4 + i * kMemoryDescriptorSize);
+        const std::uint64_t start = Load<std::uint64_t>(*s, off);
+        const auto loc = LoadLocation(*s, off + 8);
+        if (!reader.Bytes(loc).empty()) {
+          m_regions.push_back({ start, loc.dataSize, loc.rva });
+        }
+      }
+    }
+  }
+  std::sort(m_regions.begin(), m_regions.end(), [](const auto& a, const auto& b) { return a.start < b.start; });
+}
+
+std::size_t MinidumpMemory::Read(std::uint64_t addr, void* dst, std::size_t size) const
+{
+  const auto startOf = [](const MinidumpMemoryRegion& r) { return r.start; };
+  const auto contains = [](const MinidumpMemoryRegion& r, std::uint64_t a) { return a - r.start < r.size; };
+
+  auto* out = static_cast<std::uint8_t*>(dst);
+  std::size_t done = 0;
+  std::size_t i = RecentRangeCache::kNone;
+  while (done < size) {
+    const std::uint64_t cur = addr + done;
+    // A read running off the end of a region usually continues in the next
+    // one (Memory64 ranges are often split at allocation boundaries).
+    if (i != RecentRangeCache::kNone && i + 1u < m_regions.size() && contains(m_regions[i + 1u], cur)) {
+      ++i;
+    } else {
+      i = m_recent.Find(m_regions, cur, startOf, contains);
+      if (i == RecentRangeCache::kNone) {
+        break;
+      }
+    }
+    const auto& r = m_regions[i];
+    const std::uint64_t inRegion = cur - r.start;
+    const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(r.size - inRegion, size - done));
+    std::memcpy(out + done, m_base + r.rva + inRegion, n);
+    done += n;
+  }
+  return done;
+}
+
+MappedDumpFile::~MappedDumpFile()
+{
+  Close();
+}
+
+namespace {
+
+struct PageSpan
+{
+  std::uintptr_t begin = 0;
+  std::size_t size = 0;
+};
+
+std::vector<PageSpan> ToPageSpans(const std::vector<ByteSpan>& spans, std::size_t pageSize)
+{
+  std::vector<PageSpan> out;
+  out.reserve(spans.size());
+  for (const auto& s : spans) {
+    if (s.empty()) {
+      continue;
+    }
+    const auto first = reinterpret_cast<std::uintptr_t>(s.data());
+    const std::uintptr_t begin = first & ~static_cast<std::uintptr_t>(pageSize - 1u);
+    const std::uintptr_t end = (first + s.size() + pageSize - 1u) & ~static_cast<std::uintptr_t>(pageSize - 1u);
+    out.push_back({ begin, static_cast<std::size_t>(end - begin) });
+  }
+  return out;
+}
+
+}  // namespace
+
+#if defined(_WIN32)
+
+void PrefetchMappedSpans(const std::vector<ByteSpan>& spans)
+{
+  // WIN32_MEMORY_RANGE_ENTRY; resolved at runtime so the tool still starts
+  // where the export is missing.
+  struct MemoryRangeEntry
+  {
+    void* VirtualAddress;
+    SIZE_T NumberOfBytes;
+  };
+  using PrefetchVirtualMemoryFn = BOOL(WINAPI*)(HANDLE, ULONG_PTR, MemoryRangeEntry*, ULONG);
+  static const auto prefetch = []() -> PrefetchVirtualMemoryFn {
+    const HMODULE kernel32 = GetModuleHandleW(L"kernel32.dll");
+    return kernel32 ? reinterpret_cast<PrefetchVirtualMemoryFn>(GetProcAddress(kernel32, "PrefetchVirtualMemory")) : nullptr;
+  }();
+  if (!prefetch) {
+    return;
+  }
+  SYSTEM_INFO info{};
+  GetSystemInfo(&info);
+  std::vector<MemoryRangeEntry> entries;
+  for (const auto& page : ToPageSpans(spans, info.dwPageSize)) {
+    entries.push_back({ reinterpret_cast<void*>(page.begin), page.size });
+  }
+  if (!entries.empty()) {
+    prefetch(GetCurrentProcess(), entries.size(), entries.data(), 0);
+  }
+}
+
+bool MappedDumpFile::Open(const std::filesystem::path& path, std::string* err)
+{
+  Close();
+  HANDLE file = CreateFileW(
+    path.c_str(),
+    GENERIC_READ,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL,
+    nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    if (err) *err = "CreateFileW failed: " + std::to_string(GetLastError());
+    return false;
+  }
+  LARGE_INTEGER sz{};
+  if (!GetFileSizeEx(file, &sz) || sz.QuadPart <= 0) {
+    if (err) *err = "file is empty or unreadable";
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (!view) {
+    if (err) *err = "file mapping failed: " + std::to_string(GetLastError());
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+  m_file = file;
+  m_mapping = mapping;
+  m_view = view;
+  m_size = static_cast<std::uint64_t>(sz.QuadPart);
+  if (err) err->clear();
+  return true;
+}
+
+void MappedDumpFile::Close() noexcept
+{
+  if (m_view) {
+    UnmapViewOfFile(m_view);
+    m_view = nullptr;
+  }
+  if (m_mapping) {
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+  }
+  if (m_file) {
+    CloseHandle(m_file);
+    m_file = nullptr;
+  }
+  m_size = 0;
+}
+
+#else
+
+void PrefetchMappedSpans(const std::vector<ByteSpan>& spans)
+{
+  const long pageSize = ::sysconf(_SC_PAGESIZE);
+  for (const auto& page : ToPageSpans(spans, pageSize > 0 ? static_cast<std::size_t>(pageSize) : 4096u)) {
+    ::madvise(reinterpret_cast<void*>(page.begin), page.size, MADV_WILLNEED);
+  }
+}
+
+bool MappedDumpFile::Open(const std::filesystem::path& path, std::string* err)
+{
+  Close();
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    if (err) *err = "open failed: " + std::to_string(errno);
+    return false;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    if (err) *err = "file is empty or unreadable";
+    ::close(fd);
+    return false;
+  }
+  void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  if (view == MAP_FAILED) {
+    if (err) *err = "mmap failed: " + std::to_string(errno);
+    ::close(fd);
+    return false;
+  }
+  m_fd = fd;
+  m_view = view;
+  m_size = static_cast<std::uint64_t>(st.st_size);
+  if (err) err->clear();
+  return true;
+}
+
+void MappedDumpFile::Close() noexcept
+{
+  if (m_view) {
+    ::munmap(m_view, static_cast<std::size_t>(m_size));
+    m_view = nullptr;
+  }
+  if (m_fd >= 0) {
+    ::close(m_fd);
+    m_fd = -1;
+  }
+  m_size = 0;
+}
+
+#endif
+
+}  // namespace skydiag::dump_tool::minidump
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "RecentRangeCache.h"
+
+// Portable, bounds-checked minidump reader. No DbgHelp/Windows types: every
+// structure is decoded field by field from the little-endian file layout, so
+// it builds and runs on Linux as well as Windows. Nothing here trusts a count,
+// RVA or size from the file without checking it against the mapped length.
+
+namespace skydiag::dump_tool::minidump {
+
+inline constexpr std::uint32_t kMinidumpSignature = 0x504D444Du;  // "MDMP"
+
+// MINIDUMP_STREAM_TYPE values this reader decodes. User streams (see
+// SkyrimDiagProtocol.h) are read raw through MinidumpReader::Stream().
+inline constexpr std::uint32_t kThreadListStream = 3;
+inline constexpr std::uint32_t kModuleListStream = 4;
+inline constexpr std::uint32_t kMemoryListStream = 5;
+inline constexpr std::uint32_t kExceptionStream = 6;
+inline constexpr std::uint32_t kSystemInfoStream = 7;
+inline constexpr std::uint32_t kMemory64ListStream = 9;
+
+inline constexpr std::uint16_t kProcessorArchitectureAmd64 = 9;
+
+using ByteSpan = std::span<const std::uint8_t>;
+
+struct MinidumpLocation
+{
+  std::uint32_t dataSize = 0;
+  std::uint32_t rva = 0;
+};
+
+struct MinidumpDirectoryEntry
+{
+  std::uint32_t type = 0;
+  MinidumpLocation location;
+};
+
+struct MinidumpModuleRecord
+{
+  std::uint64_t base = 0;
+  std::uint32_t size = 0;
+  std::uint32_t checksum = 0;
+  std::uint32_t timeDateStamp = 0;
+  std::string path;  // UTF-8
+  // VS_FIXEDFILEINFO file version; valid only when hasVersion.
+  bool hasVersion = false;
+  std::uint32_t fileVersionMS = 0;
+  std::uint32_t fileVersionLS = 0;
+};
+
+struct MinidumpThreadRecord
+{
+  std::uint32_t tid = 0;
+  std::uint64_t teb = 0;
+  std::uint64_t stackStart = 0;
+  MinidumpLocation stack;
+  MinidumpLocation context;
+};
+
+struct MinidumpExceptionRecord
+{
+  std::uint32_t tid = 0;
+  std::uint32_t code = 0;
+  std::uint32_t flags = 0;
+  std::uint64_t address = 0;
+  std::uint32_t numberParameters = 0;
+  std::uint64_t parameters[15]{};
+  MinidumpLocation context;
+};
+
+// A captured range of target memory and where its bytes live in the file.
+struct MinidumpMemoryRegion
+{
+  std::uint64_t start = 0;
+  std::uint64_t size = 0;
+  std::uint64_t rva = 0;
+};
+
+// Byte-for-byte layout of the Win64 CONTEXT record (field names follow
+// winnt.h so code ported from CONTEXT reads the same).
+struct ContextX64
+{
+  std::uint64_t P1Home, P2Home, P3Home, P4Home, P5Home, P6Home;
+  std::uint32_t ContextFlags;
+  std::uint32_t MxCsr;
+  std::uint16_t SegCs, SegDs, SegEs, SegFs, SegGs, SegSs;
+  std::uint32_t EFlags;
+  std::uint64_t Dr0, Dr1, Dr2, Dr3, Dr6, Dr7;
+  std::uint64_t Rax, Rcx, Rdx, Rbx, Rsp, Rbp, Rsi, Rdi;
+  std::uint64_t R8, R9, R10, R11, R12, R13, R14, R15;
+  std::uint64_t Rip;
+  std::uint8_t FltSave[512];
+  std::uint8_t VectorRegister[26 * 16];
+  std::uint64_t VectorControl;
+  std::uint64_t DebugControl;
+  std::uint64_t LastBranchToRip;
+  std::uint64_t LastBranchFromRip;
+  std::uint64_t LastExceptionToRip;
+  std::uint64_t LastExceptionFromRip;
+};
+
+static_assert(sizeof(ContextX64) == 1232, "ContextX64 must match the Win64 CONTEXT size");
+static_assert(offsetof(ContextX64, Rsp) == 0x98, "ContextX64 must match the Win64 CONTEXT layout");
+static_assert(offsetof(ContextX64, Rip) == 0xF8, "ContextX64 must match the Win64 CONTEXT layout");
+
+// Read-only view over a minidump that is already in memory (mapped or
+// loaded). Does not own the bytes; they must outlive the reader.
+class MinidumpReader
+{
+public:
+  bool Open(const void* data, std::uint64_t size, std::string* err);
+  bool IsOpen() const noexcept { return m_base != nullptr; }
+
+  const std::uint8_t* Data() const noexcept { return m_base; }
+  std::uint64_t Size() const noexcept { return m_size; }
+  std::uint32_t StreamCount() const noexcept { return m_streamCount; }
+
+  MinidumpDirectoryEntry DirectoryEntry(std::uint32_t i) const;  // i < StreamCount()
+  // First stream of `type`; nullopt when absent or out of bounds.
+  std::optional<ByteSpan> Stream(std::uint32_t type) const;
+  // Empty when the location is null or out of bounds.
+  ByteSpan Bytes(const MinidumpLocation& loc) const;
+  ByteSpan Bytes(std::uint64_t rva, std::uint64_t size) const;
+
+  // MINIDUMP_STRING at `rva` (UTF-16LE) decoded to UTF-8.
+  bool ReadString(std::uint32_t rva, std::string* out) const;
+
+  std::optional<std::uint16_t> ProcessorArchitecture() const;
+  std::vector<MinidumpModuleRecord> Modules() const;
+  std::vector<MinidumpThreadRecord> Threads() const;
+  std::optional<MinidumpExceptionRecord> Exception() const;
+  // Copies up to sizeof(ContextX64) bytes; a shorter record is zero-filled.
+  bool ReadContextX64(const MinidumpLocation& loc, ContextX64* out) const;
+
+private:
+  const std::uint8_t* m_base = nullptr;
+  std::uint64_t m_size = 0;
+  std::uint32_t m_streamCount = 0;
+  std::uint32_t m_directoryRva = 0;
+};
+
+// Target memory captured in a dump: Memory64ListStream when present (full
+// dumps), else MemoryListStream. Built once per analysis rather than on
+// every MinidumpReader::Open, since full dumps carry thousands of ranges.
+class MinidumpMemory
+{
+public:
+  MinidumpMemory() = default;
+  explicit MinidumpMemory(const MinidumpReader& reader);
+
+  // Sorted by start. Ranges whose bytes fall outside the file are dropped.
+  const std::vector<MinidumpMemoryRegion>& Regions() const noexcept { return m_regions; }
+  // Copies target memory at `addr`, crossing adjacent regions; returns the
+  // number of bytes copied (short on the first gap). Region lookups go
+  // through a small recent-hit cache first (RecentRangeCache).
+  std::size_t Read(std::uint64_t addr, void* dst, std::size_t size) const;
+
+private:
+  const std::uint8_t* m_base = nullptr;
+  std::vector<MinidumpMemoryRegion> m_regions;
+  RecentRangeCache m_recent;
+};
+
+// Read-only file mapping (mmap on POSIX, MapViewOfFile on Windows).
+class MappedDumpFile
+{
+public:
+  MappedDumpFile() = default;
+  MappedDumpFile(const MappedDumpFile&) = delete;
+  MappedDumpFile& operator=(const MappedDumpFile&) = delete;
+  ~MappedDumpFile();
+
+  bool Open(const std::filesystem::path& path, std::string* err);
+  void Close() noexcept;
+
+  const void* Data() const noexcept { return m_view; }
+  std::uint64_t Size() const noexcept { return m_size; }
+
+private:
+  void* m_view = nullptr;
+  std::uint64_t m_size = 0;
+#if defined(_WIN32)
+  void* m_file = nullptr;
+  void* m_mapping = nullptr;
+#else
+  int m_fd = -1;
+#endif
+};
+
+// Advisory read-ahead for parts of a mapped dump that are about to be read in
+// many small pieces: madvise(MADV_WILLNEED) on POSIX, PrefetchVirtualMemory
+// on Windows 8+ (silently nothing on older systems). Spans are widened to
+// whole pages; empty spans are skipped. Never changes what is read.
+void PrefetchMappedSpans(const std::vector<ByteSpan>& spans);
+
+// UTF-16LE bytes to UTF-8; unpaired surrogates become U+FFFD.
+std::string Utf16LeToUtf8(ByteSpan bytes);
+
+}  // namespace skydiag::dump_tool::minidump
@@ -1,6 +1,6 @@
 #include "MinidumpUtil.h"
 
-#include "Mo2Index.h"
+#include "MinidumpReader.h"
 #include "Utf.h"
 
 #include <algorithm>
@@ -92,18 +92,6 @@ std::vector<std::wstring> DefaultHookFrameworkDlls()
   };
 }
 
-std::string ModuleVersionString(const VS_FIXEDFILEINFO& info)
-{
-  if (info.dwSignature != VS_FFI_SIGNATURE) {
-    return {};
-  }
-  const auto major = static_cast<unsigned>(HIWORD(info.dwFileVersionMS));
-  const auto minor = static_cast<unsigned>(LOWORD(info.dwFileVersionMS));
-  const auto build = static_cast<unsigned>(HIWORD(info.dwFileVersionLS));
-  const auto revision = static_cast<unsigned>(LOWORD(info.dwFileVersionLS));
-  return std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(build) + "." + std::to_string(revision);
-}
-
 std::mutex g_hookFrameworksMutex;
 std::vector<std::wstring> g_hookFrameworkDlls = DefaultHookFrameworkDlls();
 
@@ -178,128 +166,59 @@ MappedFile::~MappedFile()
 
 bool ReadStreamSized(void* dumpBase, std::uint64_t dumpSize, std::uint32_t streamType, void** outPtr, ULONG* outSize)
 {
-  if (!dumpBase || !outPtr || !outSize || dumpSize < sizeof(MINIDUMP_HEADER)) {
+  if (!outPtr || !outSize) {
     return false;
   }
 
-  const auto* hdr = static_cast<const MINIDUMP_HEADER*>(dumpBase);
-  if (hdr->Signature != MINIDUMP_SIGNATURE) {
+  MinidumpReader reader;
+  if (!reader.Open(dumpBase, dumpSize, nullptr)) {
     return false;
   }
-
-  const std::uint64_t dirOff = static_cast<std::uint64_t>(hdr->StreamDirectoryRva);
-  const std::uint64_t n = static_cast<std::uint64_t>(hdr->NumberOfStreams);
-  if (dirOff > dumpSize) {
-    return false;
-  }
-  const std::uint64_t maxDirs = (dumpSize - dirOff) / sizeof(MINIDUMP_DIRECTORY);
-  if (n == 0 || n > maxDirs) {
+  const auto stream = reader.Stream(streamType);
+  if (!stream) {
     return false;
   }
 
-  const auto* base = static_cast<const std::uint8_t*>(dumpBase);
-  const auto* dirs = reinterpret_cast<const MINIDUMP_DIRECTORY*>(base + dirOff);
-
-  for (std::uint64_t i = 0; i < n; i++) {
-    if (dirs[i].StreamType != streamType) {
-      continue;
-    }
-
-    const std::uint64_t rva = static_cast<std::uint64_t>(dirs[i].Location.Rva);
-    const std::uint64_t sz = static_cast<std::uint64_t>(dirs[i].Location.DataSize);
-    if (rva > dumpSize) {
-      return false;
-    }
-    if (sz > (dumpSize - rva)) {
-      return false;
-    }
-
-    *outPtr = const_cast<std::uint8_t*>(base + rva);
-    *outSize = static_cast<ULONG>(sz);
-    return true;
-  }
-
-  return false;
+  *outPtr = const_cast<std::uint8_t*>(stream->data());
+  *outSize = static_cast<ULONG>(stream->size());
+  return true;
 }
 
-bool ReadMinidumpStringUtf8(void* dumpBase, std::uint64_t dumpSize, RVA rva, std::string& out)
+bool ReadStreamSized(const MinidumpIndex& dump, std::uint32_t streamType, void** outPtr, ULONG* outSize)
 {
-  out.clear();
-  if (!dumpBase || dumpSize < sizeof(std::uint32_t) || rva == 0) {
-    return false;
-  }
-
-  const std::uint64_t off = static_cast<std::uint64_t>(rva);
-  if (off + sizeof(std::uint32_t) > dumpSize) {
-    return false;
-  }
-
-  const auto* base = static_cast<const std::uint8_t*>(dumpBase);
-  const auto* lenPtr = reinterpret_cast<const std::uint32_t*>(base + off);
-  const std::uint32_t lenBytes = *lenPtr;
-
-  if ((lenBytes % 2u) != 0u) {
+  if (!outPtr || !outSize) {
     return false;
   }
-  if (off + sizeof(std::uint32_t) + lenBytes > dumpSize) {
+  const auto stream = dump.Stream(streamType);
+  if (!stream) {
     return false;
   }
-
-  const auto* wbuf = reinterpret_cast<const wchar_t*>(base + off + sizeof(std::uint32_t));
-  const std::wstring_view w(wbuf, lenBytes / sizeof(wchar_t));
-  out = WideToUtf8(w);
+  *outPtr = const_cast<std::uint8_t*>(stream->data());
+  *outSize = static_cast<ULONG>(stream->size());
   return true;
 }
 
-std::optional<ModuleHit> ModuleForAddress(void* dumpBase, std::uint64_t dumpSize, std::uint64_t addr)
+std::optional<ModuleHit> ModuleForAddress(const MinidumpIndex& dump, std::uint64_t addr)
 {
-  void* ptr = nullptr;
-  ULONG size = 0;
-  if (!ReadStreamSized(dumpBase, dumpSize, ModuleListStream, &ptr, &size)) {
-    return std::nullopt;
-  }
-  if (size < sizeof(MINIDUMP_MODULE_LIST)) {
+  const auto* mod = dump.FindModule(addr);
+  if (!mod) {
     return std::nullopt;
   }
 
-  const auto* list = static_cast<const MINIDUMP_MODULE_LIST*>(ptr);
-  const std::uint64_t need =
-    static_cast<std::uint64_t>(offsetof(MINIDUMP_MODULE_LIST, Modules)) +
-    static_cast<std::uint64_t>(list->NumberOfModules) * static_cast<std::uint64_t>(sizeof(MINIDUMP_MODULE));
-  if (need > static_cast<std::uint64_t>(size)) {
-    return std::nullopt;
-  }
-
-  for (ULONG i = 0; i < list->NumberOfModules; i++) {
-    const auto& mod = list->Modules[i];
-    const std::uint64_t base = mod.BaseOfImage;
-    const std::uint64_t end = base + mod.SizeOfImage;
-    if (addr < base || addr >= end) {
-      continue;
-    }
-
-    std::string utf8;
-    if (!ReadMinidumpStringUtf8(dumpBase, dumpSize, mod.ModuleNameRva, utf8)) {
-      return std::nullopt;
-    }
-
-    const std::wstring wpath = Utf8ToWide(utf8);
-    std::filesystem::path p(wpath);
-    const auto file = p.filename().wstring();
-
-    const std::uint64_t off = addr - base;
-    wchar_t buf[1024]{};
-    swprintf_s(buf, L"%s+0x%llx", file.c_str(), static_cast<unsigned long long>(off));
+  const std::wstring wpath = Utf8ToWide(mod->path);
+  std::filesystem::path p(wpath);
+  const auto file = p.filename().wstring();
 
-    ModuleHit hit{};
-    hit.base = base;
-    hit.path = wpath;
-    hit.filename = file;
-    hit.plusOffset = buf;
-    return hit;
-  }
+  const std::uint64_t off = addr - mod->base;
+  wchar_t buf[1024]{};
+  swprintf_s(buf, L"%s+0x%llx", file.c_str(), static_cast<unsigned long long>(off));
 
-  return std::nullopt;
+  ModuleHit hit{};
+  hit.base = mod->base;
+  hit.path = wpath;
+  hit.filename = file;
+  hit.plusOffset = buf;
+  return hit;
 }
 
 bool IsSystemishModule(std::wstring_view filename)
@@ -405,121 +324,64 @@ bool IsSkseModule(std::wstring_view filename)
   return IsSkseModuleLower(LowerCopy(filename));
 }
 
-std::vector<ModuleInfo> LoadAllModules(void* dumpBase, std::uint64_t dumpSize)
-{
-  std::vector<ModuleInfo> out;
+namespace {
 
-  void* ptr = nullptr;
-  ULONG size = 0;
-  if (!ReadStreamSized(dumpBase, dumpSize, ModuleListStream, &ptr, &size) || !ptr || size < sizeof(MINIDUMP_MODULE_LIST)) {
-    return out;
+std::uint8_t ClassifyModuleName(std::wstring_view filenameLower)
+{
+  std::uint8_t flags = 0;
+  if (IsSystemishModule(filenameLower)) {
+    flags |= ModuleTable::kSystemish;
   }
-
-  const auto* list = static_cast<const MINIDUMP_MODULE_LIST*>(ptr);
-  const std::uint64_t need =
-    static_cast<std::uint64_t>(offsetof(MINIDUMP_MODULE_LIST, Modules)) +
-    static_cast<std::uint64_t>(list->NumberOfModules) * static_cast<std::uint64_t>(sizeof(MINIDUMP_MODULE));
-  if (need > static_cast<std::uint64_t>(size)) {
-    return out;
+  if (IsGameExeModule(filenameLower)) {
+    flags |= ModuleTable::kGameExe;
   }
-
-  out.reserve(list->NumberOfModules);
-  for (ULONG i = 0; i < list->NumberOfModules; i++) {
-    const auto& mod = list->Modules[i];
-    std::string utf8;
-    if (!ReadMinidumpStringUtf8(dumpBase, dumpSize, mod.ModuleNameRva, utf8)) {
-      continue;
-    }
-
-    ModuleInfo mi{};
-    mi.base = mod.BaseOfImage;
-    mi.end = mi.base + mod.SizeOfImage;
-    mi.version = ModuleVersionString(mod.VersionInfo);
-    mi.path = Utf8ToWide(utf8);
-    mi.filename = std::filesystem::path(mi.path).filename().wstring();
-    mi.inferred_mod_name = InferMo2ModNameFromPath(mi.path);
-    mi.is_systemish = IsSystemishModule(mi.filename) || IsLikelyWindowsSystemModulePathLower(WideLower(mi.path));
-    mi.is_game_exe = IsGameExeModule(mi.filename);
-    mi.is_known_hook_framework = IsKnownHookFramework(mi.filename);
-    out.push_back(std::move(mi));
+  if (IsKnownHookFramework(filenameLower)) {
+    flags |= ModuleTable::kKnownHookFramework;
   }
-
-  std::sort(out.begin(), out.end(), [](const ModuleInfo& a, const ModuleInfo& b) { return a.base < b.base; });
-  return out;
+  return flags;
 }
 
-std::optional<std::size_t> FindModuleIndexForAddress(const std::vector<ModuleInfo>& mods, std::uint64_t addr)
-{
-  if (mods.empty()) {
-    return std::nullopt;
-  }
-
-  // lower_bound by base, then check previous element.
-  const auto it = std::upper_bound(mods.begin(), mods.end(), addr, [](std::uint64_t value, const ModuleInfo& m) {
-    return value < m.base;
-  });
+}  // namespace
 
-  if (it == mods.begin()) {
-    return std::nullopt;
-  }
-  const auto& cand = *(it - 1);
-  if (addr >= cand.base && addr < cand.end) {
-    return static_cast<std::size_t>(std::distance(mods.begin(), it - 1));
-  }
-  return std::nullopt;
+void LoadAllModules(const MinidumpIndex& dump, ModuleTable* out)
+{
+  // The index keeps modules sorted by base already.
+  const auto& records = dump.Modules();
+  std::vector<ModuleRow> rows;
+  rows.reserve(records.size());
+  for (const auto& mod : records) {
+    auto& row = rows.emplace_back();
+    row.base = mod.base;
+    row.size = mod.size;
+    row.path = Utf8ToWide(mod.path);
+    row.systemPath = IsLikelyWindowsSystemModulePathLower(WideLower(row.path));
+    row.hasVersion = mod.hasVersion;
+    row.fileVersionMS = mod.fileVersionMS;
+    row.fileVersionLS = mod.fileVersionLS;
+  }
+  out->Build(rows, &ClassifyModuleName);
 }
 
-std::vector<ThreadRecord> LoadThreads(void* dumpBase, std::uint64_t dumpSize)
+const std::vector<ThreadRecord>& LoadThreads(const MinidumpIndex& dump)
 {
-  std::vector<ThreadRecord> out;
-
-  void* ptr = nullptr;
-  ULONG size = 0;
-  if (!ReadStreamSized(dumpBase, dumpSize, ThreadListStream, &ptr, &size) || !ptr || size < sizeof(MINIDUMP_THREAD_LIST)) {
-    return out;
-  }
-
-  const auto* list = static_cast<const MINIDUMP_THREAD_LIST*>(ptr);
-  const std::uint64_t need =
-    static_cast<std::uint64_t>(offsetof(MINIDUMP_THREAD_LIST, Threads)) +
-    static_cast<std::uint64_t>(list->NumberOfThreads) * static_cast<std::uint64_t>(sizeof(MINIDUMP_THREAD));
-  if (need > static_cast<std::uint64_t>(size)) {
-    return out;
-  }
-
-  out.reserve(list->NumberOfThreads);
-  for (ULONG i = 0; i < list->NumberOfThreads; i++) {
-    const auto& th = list->Threads[i];
-    ThreadRecord tr{};
-    tr.tid = th.ThreadId;
-    tr.stack = th.Stack;
-    tr.context = th.ThreadContext;
-    out.push_back(std::move(tr));
-  }
-  return out;
+  return dump.Threads();
 }
 
-bool ReadThreadContextWin64(void* dumpBase, std::uint64_t dumpSize, const ThreadRecord& tr, CONTEXT& out)
+bool ReadThreadContextWin64(const MinidumpIndex& dump, const ThreadRecord& tr, CONTEXT& out)
 {
-  if (!dumpBase) {
-    return false;
-  }
-  const std::uint64_t rva = static_cast<std::uint64_t>(tr.context.Rva);
-  const std::uint64_t sz = static_cast<std::uint64_t>(tr.context.DataSize);
-  if (rva == 0 || sz == 0 || rva > dumpSize || sz > (dumpSize - rva)) {
+  const auto bytes = dump.Reader().Bytes(tr.context);
+  if (bytes.empty()) {
     return false;
   }
 
-  const auto* base = static_cast<const std::uint8_t*>(dumpBase);
-  const std::size_t copyN = static_cast<std::size_t>(std::min<std::uint64_t>(sz, sizeof(CONTEXT)));
+  const std::size_t copyN = std::min<std::size_t>(bytes.size(), sizeof(CONTEXT));
   std::memset(&out, 0, sizeof(out));
-  std::memcpy(&out, base + rva, copyN);
+  std::memcpy(&out, bytes.data(), copyN);
   return true;
 }
 
 bool GetThreadStackBytes(
-  void* dumpBase,
-  std::uint64_t dumpSize,
+  const MinidumpIndex& dump,
   const ThreadRecord& tr,
   const std::uint8_t*& outPtr,
   std::size_t& outSize,
@@ -529,16 +391,14 @@ bool GetThreadStackBytes(
   outSize = 0;
   outBaseAddr = 0;
 
-  const std::uint64_t rva = static_cast<std::uint64_t>(tr.stack.Memory.Rva);
-  const std::uint64_t sz = static_cast<std::uint64_t>(tr.stack.Memory.DataSize);
-  if (!dumpBase || rva == 0 || sz == 0 || rva > dumpSize || sz > (dumpSize - rva)) {
+  const auto bytes = dump.Reader().Bytes(tr.stack);
+  if (bytes.empty()) {
     return false;
   }
 
-  const auto* base = static_cast<const std::uint8_t*>(dumpBase);
-  outPtr = base + rva;
-  outSize = static_cast<std::size_t>(sz);
-  outBaseAddr = tr.stack.StartOfMemoryRange;
+  outPtr = bytes.data();
+  outSize = bytes.size();
+  outBaseAddr = tr.stackStart;
   return true;
 }
 
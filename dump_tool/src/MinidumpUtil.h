@@ -4,6 +4,7 @@
 
 #include <DbgHelp.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <optional>
@@ -11,6 +12,8 @@
 #include <string_view>
 #include <vector>
 
+#include "MinidumpIndex.h"
+#include "ModuleTable.h"
 #include "SkyrimDiagHandle.h"
 #include "SkyrimDiagStringUtil.h"
 
@@ -29,8 +32,17 @@ struct MappedFile
   ~MappedFile();
 };
 
+// A second mapped dump whose memory fills gaps in the primary one; set when an
+// incremental recapture is analyzed on top of its base dump.
+struct MemoryOverlaySource
+{
+  void* dumpBase = nullptr;
+  std::uint64_t dumpSize = 0;
+};
+
 bool ReadStreamSized(void* dumpBase, std::uint64_t dumpSize, std::uint32_t streamType, void** outPtr, ULONG* outSize);
-bool ReadMinidumpStringUtf8(void* dumpBase, std::uint64_t dumpSize, RVA rva, std::string& out);
+// Same lookup through the per-analysis index (no directory walk).
+bool ReadStreamSized(const MinidumpIndex& dump, std::uint32_t streamType, void** outPtr, ULONG* outSize);
 
 struct ModuleHit
 {
@@ -40,7 +52,7 @@ struct ModuleHit
   std::wstring plusOffset;
 };
 
-std::optional<ModuleHit> ModuleForAddress(void* dumpBase, std::uint64_t dumpSize, std::uint64_t addr);
+std::optional<ModuleHit> ModuleForAddress(const MinidumpIndex& dump, std::uint64_t addr);
 
 inline std::wstring WideLower(std::wstring_view s) { return skydiag::WideLower(s); }
 
@@ -53,34 +65,15 @@ bool IsSkseModule(std::wstring_view filename);
 void LoadHookFrameworksFromJson(const std::filesystem::path& jsonPath);
 bool IsKnownHookFramework(std::wstring_view filename);
 
-struct ModuleInfo
-{
-  std::uint64_t base = 0;
-  std::uint64_t end = 0;
-  std::string version;
-  std::wstring path;
-  std::wstring filename;
-  std::wstring inferred_mod_name;
-  bool is_systemish = false;
-  bool is_game_exe = false;
-  bool is_known_hook_framework = false;
-};
-
-std::vector<ModuleInfo> LoadAllModules(void* dumpBase, std::uint64_t dumpSize);
-std::optional<std::size_t> FindModuleIndexForAddress(const std::vector<ModuleInfo>& mods, std::uint64_t addr);
+// Fills `out`, which must be empty; the table is not movable.
+void LoadAllModules(const MinidumpIndex& dump, ModuleTable* out);
 
-struct ThreadRecord
-{
-  std::uint32_t tid = 0;
-  MINIDUMP_MEMORY_DESCRIPTOR stack{};
-  MINIDUMP_LOCATION_DESCRIPTOR context{};
-};
+using ThreadRecord = MinidumpThreadRecord;
 
-std::vector<ThreadRecord> LoadThreads(void* dumpBase, std::uint64_t dumpSize);
-bool ReadThreadContextWin64(void* dumpBase, std::uint64_t dumpSize, const ThreadRecord& tr, CONTEXT& out);
+const std::vector<ThreadRecord>& LoadThreads(const MinidumpIndex& dump);
+bool ReadThreadContextWin64(const MinidumpIndex& dump, const ThreadRecord& tr, CONTEXT& out);
 bool GetThreadStackBytes(
-  void* dumpBase,
-  std::uint64_t dumpSize,
+  const MinidumpIndex& dump,
   const ThreadRecord& tr,
   const std::uint8_t*& outPtr,
   std::size_t& outSize,
@@ -0,0 +1,177 @@
+#include "ModuleAddressIndex.h"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace skydiag::dump_tool::minidump {
+namespace {
+
+// Beyond this many granules (8 GiB) a single module is treated as corrupt
+// size data; the prefilter then degrades to the overall bounds check.
+constexpr std::uint64_t kMaxGranulesPerModule = std::uint64_t{ 1 } << 17;
+
+void FillEytzinger(
+  const std::vector<std::uint64_t>& sorted,
+  std::vector<std::uint64_t>& eyt,
+  std::vector<std::uint32_t>& rank,
+  std::size_t& next,
+  std::size_t k)
+{
+  if (k >= eyt.size()) {
+    return;
+  }
+  FillEytzinger(sorted, eyt, rank, next, 2 * k);
+  eyt[k] = sorted[next];
+  rank[k] = static_cast<std::uint32_t>(next);
+  ++next;
+  FillEytzinger(sorted, eyt, rank, next, 2 * k + 1);
+}
+
+}  // namespace
+
+std::uint64_t ModuleAddressIndex::BoundsMask(const std::uint64_t* words, std::size_t count, std::uint64_t lo, std::uint64_t span) noexcept
+{
+  std::uint64_t mask = 0;
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  // (w - lo) < span, unsigned, four lanes at a time. AVX2 only has a signed
+  // 64-bit compare, so both sides are biased by the sign bit first.
+  const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+  const __m256i vlo = _mm256_set1_epi64x(static_cast<long long>(lo));
+  const __m256i vspan = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(span)), bias);
+  for (; i + 4 <= count; i += 4) {
+    const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    const __m256i off = _mm256_xor_si256(_mm256_sub_epi64(w, vlo), bias);
+    const __m256i inBounds = _mm256_cmpgt_epi64(vspan, off);
+    const auto lanes = static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(inBounds)));
+    mask |= static_cast<std::uint64_t>(lanes) << i;
+  }
+#endif
+  // Portable lanes (and the AVX2 tail): branch-free, so compilers vectorize
+  // it for whatever SIMD width the build targets.
+  for (; i < count; ++i) {
+    const std::uint64_t inBounds = (words[i] - lo) < span;
+    mask |= inBounds << i;
+  }
+  return mask;
+}
+
+ModuleAddressIndex::ModuleAddressIndex(const std::vector<Range>& ranges)
+{
+  std::vector<std::uint32_t> order(ranges.size());
+  std::iota(order.begin(), order.end(), 0u);
+  // Stable, so equal bases resolve to the last one exactly like upper_bound
+  // over an already sorted module list.
+  std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+    return ranges[a].base < ranges[b].base;
+  });
+
+  m_bases.reserve(order.size());
+  m_ends.reserve(order.size());
+  m_moduleIndex.reserve(order.size());
+  for (const auto i : order) {
+    m_bases.push_back(ranges[i].base);
+    m_ends.push_back(ranges[i].end);
+    m_moduleIndex.push_back(i);
+  }
+
+  m_eytzinger.assign(m_bases.size() + 1, 0);
+  m_eytzingerRank.assign(m_bases.size() + 1, 0);
+  std::size_t next = 0;
+  FillEytzinger(m_bases, m_eytzinger, m_eytzingerRank, next, 1);
+
+  std::uint64_t lo = ~std::uint64_t{ 0 };
+  std::uint64_t hi = 0;
+  for (const auto& r : ranges) {
+    if (r.end <= r.base) {
+      continue;
+    }
+    lo = std::min(lo, r.base);
+    hi = std::max(hi, r.end);
+
+    const std::uint64_t first = r.base >> kGranuleShift;
+    const std::uint64_t last = (r.end - 1) >> kGranuleShift;
+    if (last - first >= kMaxGranulesPerModule) {
+      m_coarse = true;
+      continue;
+    }
+    for (std::uint64_t g = first; g <= last; ++g) {
+      auto* bits = MutableRegionBits(g >> (32 - kGranuleShift));
+      const auto inRegion = static_cast<std::uint32_t>(g) & (kGranulesPerRegion - 1u);
+      bits[inRegion >> 6] |= std::uint64_t{ 1 } << (inRegion & 63u);
+    }
+  }
+  if (hi > lo) {
+    m_lo = lo;
+    m_span = hi - lo;
+  }
+}
+
+std::uint64_t* ModuleAddressIndex::MutableRegionBits(std::uint64_t highBits)
+{
+  for (std::size_t i = 0; i < m_regionKeys.size(); ++i) {
+    if (m_regionKeys[i] == highBits) {
+      return m_regionBits.data() + i * kWordsPerRegion;
+    }
+  }
+  m_regionKeys.push_back(highBits);
+  m_regionBits.resize(m_regionBits.size() + kWordsPerRegion, 0);
+  return m_regionBits.data() + (m_regionKeys.size() - 1) * kWordsPerRegion;
+}
+
+std::optional<std::size_t> ModuleAddressIndex::Find(std::uint64_t addr) const noexcept
+{
+  if (!MayContain(addr)) {
+    return std::nullopt;
+  }
+
+  // First node with base > addr; k ends as 0 when there is none.
+  const std::size_t n = m_bases.size();
+  std::size_t k = 1;
+  while (k <= n) {
+    k = 2 * k + static_cast<std::size_t>(m_eytzinger[k] <= addr);
+  }
+  k >>= std::countr_one(k) + 1;
+
+  const std::size_t upper = k ? m_eytzingerRank[k] : n;
+  if (upper == 0) {
+    return std::nullopt;
+  }
+  const std::size_t pos = upper - 1;
+  if (addr >= m_ends[pos]) {
+    return std::nullopt;
+  }
+  return m_moduleIndex[pos];
+}
+
+std::size_t ModuleAddressIndex::FilterCandidates(const std::uint64_t* words, std::size_t count, std::uint32_t* outPositions) const
+{
+  std::size_t kept = 0;
+  if (m_span == 0) {
+    return kept;
+  }
+
+  constexpr std::size_t kBlock = 64;
+  for (std::size_t blockStart = 0; blockStart < count; blockStart += kBlock) {
+    const std::size_t blockLen = std::min(kBlock, count - blockStart);
+
+    // Pass 1: unsigned bounds check into a bit mask.
+    const std::uint64_t mask = BoundsMask(words + blockStart, blockLen, m_lo, m_span);
+
+    // Pass 2: granule bitmap for the survivors only.
+    for (std::uint64_t rest = mask; rest != 0; rest &= rest - 1) {
+      const auto i = static_cast<std::size_t>(std::countr_zero(rest));
+      if (MayContain(words[blockStart + i])) {
+        outPositions[kept++] = static_cast<std::uint32_t>(blockStart + i);
+      }
+    }
+  }
+  return kept;
+}
+
+}  // namespace skydiag::dump_tool::minidump
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace skydiag::dump_tool::minidump {
+
+// Compact address -> module lookup for the stack scans, which test every
+// 8-byte stack slot against the module list. FindModuleIndexForAddress does
+// a plain binary search over ModuleTable's base column; this keeps only the
+// bounds, in two layers:
+//
+//  - a page table keyed on the high 32 address bits, each populated 4 GiB
+//    region holding a bitmap of the 64 KiB granules covered by some module
+//    (Windows maps images on the 64 KiB allocation granularity). Most stack
+//    words are small integers, stack or heap pointers and fail this test
+//    without touching the module table.
+//  - the module bases in Eytzinger (BFS) order for a branch-free predecessor
+//    search when the granule is populated.
+//
+// Lookup semantics match FindModuleIndexForAddress: the module with the
+// greatest base <= addr, and only if addr < its end.
+class ModuleAddressIndex
+{
+public:
+  struct Range
+  {
+    std::uint64_t base = 0;
+    std::uint64_t end = 0;  // exclusive
+  };
+
+  ModuleAddressIndex() = default;
+  // `ranges[i]` describes module i; the returned indices refer back to it.
+  explicit ModuleAddressIndex(const std::vector<Range>& ranges);
+
+  // Any container of objects with `base` / `end` members (e.g. ModuleInfo).
+  template <class Modules>
+  static ModuleAddressIndex FromModules(const Modules& modules)
+  {
+    std::vector<Range> ranges;
+    ranges.reserve(modules.size());
+    for (const auto& m : modules) {
+      ranges.push_back(Range{ m.base, m.end });
+    }
+    return ModuleAddressIndex(ranges);
+  }
+
+  bool Empty() const noexcept { return m_bases.empty(); }
+
+  // Cheap test: false means no module contains `addr`; true means "maybe".
+  bool MayContain(std::uint64_t addr) const noexcept
+  {
+    if (addr - m_lo >= m_span) {
+      return false;
+    }
+    if (m_coarse) {
+      return true;
+    }
+    const auto* bits = RegionBits(addr >> 32);
+    if (!bits) {
+      return false;
+    }
+    const auto granule = static_cast<std::uint32_t>(addr >> kGranuleShift) & (kGranulesPerRegion - 1u);
+    return (bits[granule >> 6] >> (granule & 63u)) & 1u;
+  }
+
+  std::optional<std::size_t> Find(std::uint64_t addr) const noexcept;
+
+  // Batch prefilter over `count` words: writes the positions of words that
+  // pass MayContain() to `outPositions` and returns how many. The bounds
+  // check runs as a separate SIMD pass (BoundsMask) ahead of the bitmap.
+  std::size_t FilterCandidates(const std::uint64_t* words, std::size_t count, std::uint32_t* outPositions) const;
+
+  // Calls onHit(slotIndex, moduleIndex) for every 8-byte slot of `bytes`
+  // that points into a module. Slots go through FilterCandidates() a chunk at
+  // a time, so only plausible pointers reach the Eytzinger search.
+  template <class OnHit>
+  void ForEachModulePointer(const std::uint8_t* bytes, std::size_t byteCount, OnHit&& onHit) const
+  {
+    constexpr std::size_t kChunkSlots = 512;
+    std::uint64_t words[kChunkSlots];
+    std::uint32_t hits[kChunkSlots];
+    const std::size_t slotCount = byteCount / sizeof(std::uint64_t);
+    for (std::size_t chunk = 0; chunk < slotCount; chunk += kChunkSlots) {
+      const std::size_t n = std::min(kChunkSlots, slotCount - chunk);
+      std::memcpy(words, bytes + chunk * sizeof(std::uint64_t), n * sizeof(std::uint64_t));
+      const std::size_t kept = FilterCandidates(words, n, hits);
+      for (std::size_t i = 0; i < kept; ++i) {
+        if (const auto mi = Find(words[hits[i]])) {
+          onHit(chunk + hits[i], *mi);
+        }
+      }
+    }
+  }
+
+  // Bit i set when (words[i] - lo) < span; count <= 64. Uses AVX2 when the
+  // build enables it (4 words per compare), else a branch-free scalar loop.
+  static std::uint64_t BoundsMask(const std::uint64_t* words, std::size_t count, std::uint64_t lo, std::uint64_t span) noexcept;
+
+private:
+  static constexpr unsigned kGranuleShift = 16;
+  static constexpr std::uint32_t kGranulesPerRegion = 1u << (32 - kGranuleShift);
+  static constexpr std::size_t kWordsPerRegion = kGranulesPerRegion / 64u;
+
+  const std::uint64_t* RegionBits(std::uint64_t highBits) const noexcept
+  {
+    // Process images cluster in a handful of 4 GiB regions (exe, system DLLs,
+    // the rest), so a linear probe beats a hash here.
+    for (std::size_t i = 0; i < m_regionKeys.size(); ++i) {
+      if (m_regionKeys[i] == highBits) {
+        return m_regionBits.data() + i * kWordsPerRegion;
+      }
+    }
+    return nullptr;
+  }
+
+  std::uint64_t* MutableRegionBits(std::uint64_t highBits);
+
+  // Sorted by base (stable), with the caller's module index alongside.
+  std::vector<std::uint64_t> m_bases;
+  std::vector<std::uint64_t> m_ends;
+  std::vector<std::uint32_t> m_moduleIndex;
+  // 1-based Eytzinger copy of m_bases and each node's sorted rank.
+  std::vector<std::uint64_t> m_eytzinger;
+  std::vector<std::uint32_t> m_eytzingerRank;
+
+  std::uint64_t m_lo = 0;    // lowest base
+  std::uint64_t m_span = 0;  // highest end - m_lo; 0 when empty
+  bool m_coarse = false;     // a module too large for the bitmap; bounds check only
+  std::vector<std::uint64_t> m_regionKeys;
+  std::vector<std::uint64_t> m_regionBits;  // kWordsPerRegion words per key
+};
+
+}  // namespace skydiag::dump_tool::minidump
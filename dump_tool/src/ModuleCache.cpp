@@ -0,0 +1,359 @@
+#include "ModuleCache.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace skydiag::dump_tool {
+namespace {
+
+// File layout (little-endian):
+//   header   48 bytes: magic, version, kind, time_date_stamp, size_of_image,
+//            countA, offsetA, countB, offsetB, blobOffset, blobSize, 0
+//   table A  countA x 12 bytes   kUnwind: begin, end, unwind_info
+//                                kSymbols: rva, name offset, name length
+//   table B  countB x 12 bytes   kUnwind: rva, blob offset, size
+//   blob                         kUnwind: range bytes; kSymbols: names
+constexpr std::uint32_t kMagic = 0x434D4B53u;  // "SKMC"
+// 2: symbol files hold PDB publics only (version 1 could hold export tables).
+constexpr std::uint32_t kVersion = 2;
+constexpr std::size_t kHeaderSize = 48;
+constexpr std::size_t kEntrySize = 12;
+
+std::atomic<std::uint64_t> g_cacheTempCounter{ 0u };
+
+std::uint32_t Le32(const std::uint8_t* p)
+{
+  std::uint32_t v = 0;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+void Put32(std::vector<std::uint8_t>* out, std::uint32_t v)
+{
+  const auto off = out->size();
+  out->resize(off + 4);
+  std::memcpy(out->data() + off, &v, 4);
+}
+
+const char* KindSuffix(ModuleCacheKind kind)
+{
+  return kind == ModuleCacheKind::kUnwind ? ".unwind" : ".symbols";
+}
+
+struct Entry
+{
+  std::uint32_t a = 0;
+  std::uint32_t b = 0;
+  std::uint32_t c = 0;
+};
+
+bool WriteCacheFile(
+  const std::filesystem::path& cacheDir,
+  const ModuleCacheKey& key,
+  ModuleCacheKind kind,
+  const std::vector<Entry>& tableA,
+  const std::vector<Entry>& tableB,
+  const std::vector<std::uint8_t>& blob)
+{
+  if (cacheDir.empty() || !key.Valid()) {
+    return false;
+  }
+  const std::uint64_t total = kHeaderSize + (tableA.size() + tableB.size()) * kEntrySize + blob.size();
+  if (total > 0xFFFFFFFFull) {
+    return false;
+  }
+
+  std::vector<std::uint8_t> bytes;
+  bytes.reserve(static_cast<std::size_t>(total));
+  const auto offsetA = static_cast<std::uint32_t>(kHeaderSize);
+  const auto offsetB = static_cast<std::uint32_t>(offsetA + tableA.size() * kEntrySize);
+  const auto blobOffset = static_cast<std::uint32_t>(offsetB + tableB.size() * kEntrySize);
+  for (const std::uint32_t v : { kMagic, kVersion, static_cast<std::uint32_t>(kind), key.time_date_stamp,
+         key.size_of_image, static_cast<std::uint32_t>(tableA.size()), offsetA,
+         static_cast<std::uint32_t>(tableB.size()), offsetB, blobOffset, static_cast<std::uint32_t>(blob.size()),
+         0u }) {
+    Put32(&bytes, v);
+  }
+  for (const auto* table : { &tableA, &tableB }) {
+    for (const auto& e : *table) {
+      Put32(&bytes, e.a);
+      Put32(&bytes, e.b);
+      Put32(&bytes, e.c);
+    }
+  }
+  bytes.insert(bytes.end(), blob.begin(), blob.end());
+
+  try {
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDir, ec);
+    if (ec) {
+      return false;
+    }
+    const auto path = ModuleCachePath(cacheDir, key, kind);
+    auto tempPath = path;
+    const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    tempPath += ".tmp." + std::to_string(now) + "." +
+      std::to_string(g_cacheTempCounter.fetch_add(1u, std::memory_order_relaxed));
+
+    bool wrote = false;
+    {
+      std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+      if (out) {
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        out.flush();
+        out.close();
+        wrote = static_cast<bool>(out);
+      }
+    }
+    if (!wrote) {
+      std::filesystem::remove(tempPath, ec);
+      return false;
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+      std::filesystem::remove(tempPath, ec);
+      return false;
+    }
+#else
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+      std::filesystem::remove(tempPath, ec);
+      return false;
+    }
+#endif
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+}  // namespace
+
+ModuleCacheKey ModuleCacheKeyFor(const minidump::MinidumpModuleRecord& record)
+{
+  ModuleCacheKey key;
+  const auto slash = record.path.find_last_of("\\/");
+  const std::string_view name = slash == std::string::npos
+    ? std::string_view(record.path)
+    : std::string_view(record.path).substr(slash + 1);
+  // Non-ASCII names are hex-encoded so the cache file name is portable.
+  for (const char ch : name) {
+    const auto c = static_cast<unsigned char>(ch);
+    if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-') {
+      key.file_name.push_back(ch);
+    } else if (c >= 'A' && c <= 'Z') {
+      key.file_name.push_back(static_cast<char>(c - 'A' + 'a'));
+    } else {
+      char hex[4];
+      std::snprintf(hex, sizeof(hex), "%%%02x", c);
+      key.file_name += hex;
+    }
+  }
+  key.time_date_stamp = record.timeDateStamp;
+  key.size_of_image = record.size;
+  return key;
+}
+
+std::filesystem::path ModuleCachePath(
+  const std::filesystem::path& cacheDir,
+  const ModuleCacheKey& key,
+  ModuleCacheKind kind)
+{
+  char stamp[24];
+  std::snprintf(stamp, sizeof(stamp), ".%08x%08x", key.time_date_stamp, key.size_of_image);
+  return cacheDir / (key.file_name + stamp + KindSuffix(kind));
+}
+
+bool StoreModuleUnwindCache(
+  const std::filesystem::path& cacheDir,
+  const ModuleCacheKey& key,
+  std::vector<CachedRuntimeFunction> functions,
+  std::vector<CachedImageRange> ranges)
+{
+  std::sort(functions.begin(), functions.end(), [](const auto& a, const auto& b) { return a.begin < b.begin; });
+  std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) { return a.rva < b.rva; });
+
+  std::vector<Entry> tableA;
+  tableA.reserve(functions.size());
+  for (const auto& f : functions) {
+    tableA.push_back({ f.begin, f.end, f.unwind_info });
+  }
+  std::vector<Entry> tableB;
+  std::vector<std::uint8_t> blob;
+  for (const auto& r : ranges) {
+    if (r.bytes.empty()) {
+      continue;
+    }
+    if (!tableB.empty() && r.rva < tableB.back().a + tableB.back().c) {
+      return false;
+    }
+    tableB.push_back({ r.rva, static_cast<std::uint32_t>(blob.size()), static_cast<std::uint32_t>(r.bytes.size()) });
+    blob.insert(blob.end(), r.bytes.begin(), r.bytes.end());
+  }
+  return WriteCacheFile(cacheDir, key, ModuleCacheKind::kUnwind, tableA, tableB, blob);
+}
+
+bool StoreModuleSymbolCache(
+  const std::filesystem::path& cacheDir,
+  const ModuleCacheKey& key,
+  std::vector<CachedSymbol> symbols)
+{
+  std::sort(symbols.begin(), symbols.end(), [](const auto& a, const auto& b) {
+    return a.rva != b.rva ? a.rva < b.rva : a.name < b.name;
+  });
+  // One name per address is enough for display; keep the first in order.
+  symbols.erase(
+    std::unique(symbols.begin(), symbols.end(), [](const auto& a, const auto& b) { return a.rva == b.rva; }),
+    symbols.end());
+
+  std::vector<Entry> tableA;
+  tableA.reserve(symbols.size());
+  std::vector<std::uint8_t> blob;
+  for (const auto& s : symbols) {
+    tableA.push_back({ s.rva, static_cast<std::uint32_t>(blob.size()), static_cast<std::uint32_t>(s.name.size()) });
+    blob.insert(blob.end(), s.name.begin(), s.name.end());
+  }
+  return WriteCacheFile(cacheDir, key, ModuleCacheKind::kSymbols, tableA, {}, blob);
+}
+
+bool ModuleCacheFile::Open(const std::filesystem::path& cacheDir, const ModuleCacheKey& key, ModuleCacheKind kind)
+{
+  m_header = nullptr;
+  m_file.Close();
+  if (cacheDir.empty() || !key.Valid()) {
+    return false;
+  }
+  std::error_code ec;
+  const auto path = ModuleCachePath(cacheDir, key, kind);
+  if (!std::filesystem::is_regular_file(path, ec) || !m_file.Open(path, nullptr)) {
+    return false;
+  }
+
+  const auto* base = static_cast<const std::uint8_t*>(m_file.Data());
+  const std::uint64_t size = m_file.Size();
+  const auto fail = [&]() {
+    m_file.Close();
+    return false;
+  };
+  if (!base || size < kHeaderSize || Le32(base) != kMagic || Le32(base + 4) != kVersion ||
+      Le32(base + 8) != static_cast<std::uint32_t>(kind) || Le32(base + 12) != key.time_date_stamp ||
+      Le32(base + 16) != key.size_of_image) {
+    return fail();
+  }
+  const std::uint64_t countA = Le32(base + 20);
+  const std::uint64_t offsetA = Le32(base + 24);
+  const std::uint64_t countB = Le32(base + 28);
+  const std::uint64_t offsetB = Le32(base + 32);
+  const std::uint64_t blobOffset = Le32(base + 36);
+  const std::uint64_t blobSize = Le32(base + 40);
+  if (offsetA + countA * kEntrySize > size || offsetB + countB * kEntrySize > size || blobOffset + blobSize > size) {
+    return fail();
+  }
+
+  m_countA = static_cast<std::size_t>(countA);
+  m_countB = static_cast<std::size_t>(countB);
+  m_tableA = base + offsetA;
+  m_tableB = base + offsetB;
+  m_blob = base + blobOffset;
+  m_blobSize = static_cast<std::size_t>(blobSize);
+  // Every blob reference must stay inside the blob.
+  for (std::size_t i = 0; i < m_countB; ++i) {
+    const auto* e = Entry(1, i);
+    if (std::uint64_t{ Le32(e + 4) } + Le32(e + 8) > m_blobSize) {
+      return fail();
+    }
+  }
+  if (kind == ModuleCacheKind::kSymbols) {
+    for (std::size_t i = 0; i < m_countA; ++i) {
+      const auto* e = Entry(0, i);
+      if (std::uint64_t{ Le32(e + 4) } + Le32(e + 8) > m_blobSize) {
+        return fail();
+      }
+    }
+  }
+  m_header = base;
+  return true;
+}
+
+const std::uint8_t* ModuleCacheFile::Entry(std::size_t table, std::size_t i) const
+{
+  return (table == 0 ? m_tableA : m_tableB) + i * kEntrySize;
+}
+
+CachedRuntimeFunction ModuleCacheFile::Function(std::size_t i) const
+{
+  const auto* e = Entry(0, i);
+  return { Le32(e), Le32(e + 4), Le32(e + 8) };
+}
+
+std::size_t ModuleCacheFile::ReadImage(std::uint32_t rva, void* dst, std::size_t size) const
+{
+  std::memset(dst, 0, size);
+  if (!IsOpen() || m_countB == 0) {
+    return 0;
+  }
+  // Last range starting at or before rva.
+  std::size_t lo = 0;
+  std::size_t hi = m_countB;
+  while (lo < hi) {
+    const std::size_t mid = lo + (hi - lo) / 2;
+    if (Le32(Entry(1, mid)) <= rva) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0) {
+    return 0;
+  }
+  const auto* e = Entry(1, lo - 1);
+  const std::uint32_t start = Le32(e);
+  const std::uint32_t blobOff = Le32(e + 4);
+  const std::uint32_t len = Le32(e + 8);
+  if (rva - start >= len) {
+    return 0;
+  }
+  const std::size_t copyN = std::min<std::size_t>(size, len - (rva - start));
+  std::memcpy(dst, m_blob + blobOff + (rva - start), copyN);
+  return copyN;
+}
+
+bool ModuleCacheFile::FindSymbol(std::uint32_t rva, std::string_view* outName, std::uint32_t* outDisplacement) const
+{
+  if (!IsOpen() || m_countA == 0) {
+    return false;
+  }
+  std::size_t lo = 0;
+  std::size_t hi = m_countA;
+  while (lo < hi) {
+    const std::size_t mid = lo + (hi - lo) / 2;
+    if (Le32(Entry(0, mid)) <= rva) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0) {
+    return false;
+  }
+  const auto* e = Entry(0, lo - 1);
+  if (outName) {
+    *outName = std::string_view(reinterpret_cast<const char*>(m_blob + Le32(e + 4)), Le32(e + 8));
+  }
+  if (outDisplacement) {
+    *outDisplacement = rva - Le32(e);
+  }
+  return true;
+}
+
+}  // namespace skydiag::dump_tool
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "MinidumpReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Persistent per-module cache of what the analysis derives from a module
+// image: its unwind tables (for X64Unwinder) and its exported / PDB-public
+// symbols (for callstack display). Every dump from the same install carries
+// the same SkyrimSE.exe and SKSE DLLs, so later analyses map these files
+// instead of re-reading images or opening a DbgHelp session.
+//
+// One file per module build and kind under the cache directory. The layout
+// is fixed-width little-endian tables that are searched in place through a
+// read-only mapping; nothing is parsed into memory on open.
+
+namespace skydiag::dump_tool {
+
+// One build of a module. TimeDateStamp and SizeOfImage pick the build; the
+// file name keeps two DLLs that happen to share both apart.
+struct ModuleCacheKey
+{
+  std::string file_name;  // lower-cased ASCII, no directory
+  std::uint32_t time_date_stamp = 0;
+  std::uint32_t size_of_image = 0;
+
+  // A record without a timestamp cannot be told apart from a rebuild.
+  bool Valid() const noexcept { return !file_name.empty() && time_date_stamp != 0 && size_of_image != 0; }
+};
+
+ModuleCacheKey ModuleCacheKeyFor(const minidump::MinidumpModuleRecord& record);
+
+enum class ModuleCacheKind : std::uint32_t
+{
+  kUnwind = 1,
+  kSymbols = 2,
+};
+
+struct CachedRuntimeFunction
+{
+  std::uint32_t begin = 0;
+  std::uint32_t end = 0;
+  std::uint32_t unwind_info = 0;
+};
+
+// Image bytes kept for the unwinder (UNWIND_INFO records), by RVA.
+struct CachedImageRange
+{
+  std::uint32_t rva = 0;
+  std::vector<std::uint8_t> bytes;
+};
+
+struct CachedSymbol
+{
+  std::uint32_t rva = 0;
+  std::string name;  // UTF-8, undecorated
+};
+
+std::filesystem::path ModuleCachePath(
+  const std::filesystem::path& cacheDir,
+  const ModuleCacheKey& key,
+  ModuleCacheKind kind);
+
+// Best effort: false when the key is not cacheable or the file could not be
+// written. `functions` need not be sorted; `ranges` must not overlap.
+bool StoreModuleUnwindCache(
+  const std::filesystem::path& cacheDir,
+  const ModuleCacheKey& key,
+  std::vector<CachedRuntimeFunction> functions,
+  std::vector<CachedImageRange> ranges);
+
+// `symbols` need not be sorted. An empty list is a valid entry: the module
+// has no symbols worth asking DbgHelp for again.
+bool StoreModuleSymbolCache(
+  const std::filesystem::path& cacheDir,
+  const ModuleCacheKey& key,
+  std::vector<CachedSymbol> symbols);
+
+// A mapped cache file. Open() fails on a missing, truncated or foreign file
+// (other key, kind or version), which callers treat as a miss.
+class ModuleCacheFile
+{
+public:
+  bool Open(const std::filesystem::path& cacheDir, const ModuleCacheKey& key, ModuleCacheKind kind);
+  bool IsOpen() const noexcept { return m_header != nullptr; }
+
+  // kUnwind: RUNTIME_FUNCTION entries sorted by begin, and image reads served
+  // from the kept ranges (short outside them; the rest of `dst` is zeroed).
+  std::size_t FunctionCount() const noexcept { return IsOpen() ? m_countA : 0; }
+  CachedRuntimeFunction Function(std::size_t i) const;
+  std::size_t ReadImage(std::uint32_t rva, void* dst, std::size_t size) const;
+
+  // kSymbols: the symbol at or before `rva`.
+  std::size_t SymbolCount() const noexcept { return IsOpen() ? m_countA : 0; }
+  bool FindSymbol(std::uint32_t rva, std::string_view* outName, std::uint32_t* outDisplacement) const;
+
+private:
+  const std::uint8_t* Entry(std::size_t table, std::size_t i) const;
+
+  minidump::MappedDumpFile m_file;
+  const std::uint8_t* m_header = nullptr;
+  std::size_t m_countA = 0;
+  std::size_t m_countB = 0;
+  const std::uint8_t* m_tableA = nullptr;
+  const std::uint8_t* m_tableB = nullptr;
+  const std::uint8_t* m_blob = nullptr;
+  std::size_t m_blobSize = 0;
+};
+
+}  // namespace skydiag::dump_tool
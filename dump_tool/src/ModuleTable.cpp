@@ -0,0 +1,156 @@
+#include "ModuleTable.h"
+
+#include "Mo2Index.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <unordered_map>
+
+namespace skydiag::dump_tool::minidump {
+
+namespace {
+
+std::wstring LowerCopy(std::wstring_view s)
+{
+  std::wstring out(s);
+  std::transform(out.begin(), out.end(), out.begin(), [](wchar_t c) { return static_cast<wchar_t>(towlower(c)); });
+  return out;
+}
+
+std::wstring FilenameOf(const std::wstring& path)
+{
+  // Dump paths are Windows paths; split on either separator so the table
+  // reads the same when built off-Windows.
+  const auto slash = path.find_last_of(L"\\/");
+  return slash == std::wstring::npos ? path : path.substr(slash + 1);
+}
+
+std::string ModuleVersionString(std::uint32_t fileVersionMS, std::uint32_t fileVersionLS)
+{
+  const auto major = static_cast<unsigned>(fileVersionMS >> 16);
+  const auto minor = static_cast<unsigned>(fileVersionMS & 0xFFFFu);
+  const auto build = static_cast<unsigned>(fileVersionLS >> 16);
+  const auto revision = static_cast<unsigned>(fileVersionLS & 0xFFFFu);
+  return std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(build) + "." + std::to_string(revision);
+}
+
+}  // namespace
+
+const std::string& ModuleInfo::Version() const
+{
+  return table->Version(index);
+}
+
+const std::wstring& ModuleInfo::InferredModName() const
+{
+  return table->InferredModName(index);
+}
+
+void ModuleTable::Build(const std::vector<ModuleRow>& rows, NameClassifier classify)
+{
+  const std::size_t n = rows.size();
+  m_bases.reserve(n);
+  m_ends.reserve(n);
+  m_flags.reserve(n);
+  m_nameIds.reserve(n);
+  m_paths.reserve(n);
+  m_filenames.reserve(n);
+  m_versionFields.reserve(n);
+
+  // Name-based classification is per distinct file name; the hook framework
+  // list is behind a mutex.
+  std::unordered_map<std::wstring, std::uint32_t> nameIds;
+  std::vector<std::uint8_t> nameFlags;
+  for (const auto& row : rows) {
+    m_bases.push_back(row.base);
+    m_ends.push_back(row.base + row.size);
+    m_versionFields.push_back({ row.hasVersion, row.fileVersionMS, row.fileVersionLS });
+    const auto& path = m_paths.emplace_back(row.path);
+    const auto& filename = m_filenames.emplace_back(FilenameOf(path));
+
+    auto lower = LowerCopy(filename);
+    auto [it, inserted] = nameIds.try_emplace(lower, static_cast<std::uint32_t>(m_names.size()));
+    if (inserted) {
+      nameFlags.push_back(classify ? classify(lower) : std::uint8_t{ 0 });
+      m_names.push_back(std::move(lower));
+    }
+    m_nameIds.push_back(it->second);
+
+    std::uint8_t flags = nameFlags[it->second];
+    if (row.systemPath) {
+      flags |= kSystemish;
+    }
+    m_flags.push_back(flags);
+  }
+
+  m_versions.resize(n);
+  m_modNames.resize(n);
+  m_versionOnce = std::make_unique<std::once_flag[]>(n);
+  m_modNameOnce = std::make_unique<std::once_flag[]>(n);
+}
+
+ModuleInfo ModuleTable::operator[](std::size_t i) const
+{
+  const std::uint8_t flags = m_flags[i];
+  return ModuleInfo{
+    m_bases[i],
+    m_ends[i],
+    m_paths[i],
+    m_filenames[i],
+    m_names[m_nameIds[i]],
+    (flags & kSystemish) != 0,
+    (flags & kGameExe) != 0,
+    (flags & kKnownHookFramework) != 0,
+    this,
+    i,
+  };
+}
+
+const std::string& ModuleTable::Version(std::size_t i) const
+{
+  std::call_once(m_versionOnce[i], [&]() {
+    const auto& fields = m_versionFields[i];
+    if (fields.has) {
+      m_versions[i] = ModuleVersionString(fields.ms, fields.ls);
+    }
+  });
+  return m_versions[i];
+}
+
+const std::wstring& ModuleTable::InferredModName(std::size_t i) const
+{
+  std::call_once(m_modNameOnce[i], [&]() { m_modNames[i] = InferMo2ModNameFromPath(m_paths[i]); });
+  return m_modNames[i];
+}
+
+std::optional<std::size_t> ModuleTable::Find(std::uint64_t addr) const
+{
+  // upper_bound by base, then check the previous module's end.
+  const auto it = std::upper_bound(m_bases.begin(), m_bases.end(), addr);
+  if (it == m_bases.begin()) {
+    return std::nullopt;
+  }
+  const auto i = static_cast<std::size_t>(std::distance(m_bases.begin(), it) - 1);
+  if (addr < m_ends[i]) {
+    return i;
+  }
+  return std::nullopt;
+}
+
+std::optional<std::size_t> ModuleTable::FindByFilename(std::wstring_view filename) const
+{
+  const std::wstring lower = LowerCopy(filename);
+  for (std::size_t i = 0; i < m_nameIds.size(); ++i) {
+    if (m_names[m_nameIds[i]] == lower) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::size_t> FindModuleIndexForAddress(const ModuleTable& mods, std::uint64_t addr)
+{
+  return mods.Find(addr);
+}
+
+}  // namespace skydiag::dump_tool::minidump
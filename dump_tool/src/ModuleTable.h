@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace skydiag::dump_tool::minidump {
+
+class ModuleTable;
+
+// One row of a ModuleTable. A view: the strings live in the table, which
+// must outlive it. Version and inferred mod name are derived on first use.
+struct ModuleInfo
+{
+  std::uint64_t base = 0;
+  std::uint64_t end = 0;
+  const std::wstring& path;
+  const std::wstring& filename;
+  const std::wstring& filename_lower;  // interned: equal names share storage
+  bool is_systemish = false;
+  bool is_game_exe = false;
+  bool is_known_hook_framework = false;
+
+  const std::string& Version() const;
+  const std::wstring& InferredModName() const;
+
+  const ModuleTable* table = nullptr;
+  std::size_t index = 0;
+};
+
+// Input row for ModuleTable::Build; rows arrive sorted by base.
+struct ModuleRow
+{
+  std::uint64_t base = 0;
+  std::uint64_t size = 0;
+  std::wstring path;
+  bool systemPath = false;  // path is under a Windows system directory
+  bool hasVersion = false;
+  std::uint32_t fileVersionMS = 0;
+  std::uint32_t fileVersionLS = 0;
+};
+
+// The dump's module list, stored column-wise and sorted by base. Loading
+// does one lower-case pass and one classification per distinct file name;
+// the version string and MO2 mod name are only built for the few modules a
+// report ends up naming. Rows are handed out as ModuleInfo views.
+class ModuleTable
+{
+public:
+  enum Flag : std::uint8_t
+  {
+    kSystemish = 1u << 0,
+    kGameExe = 1u << 1,
+    kKnownHookFramework = 1u << 2,
+  };
+
+  // Flags for a lower-cased file name; called once per distinct name.
+  using NameClassifier = std::uint8_t (*)(std::wstring_view filenameLower);
+
+  class Iterator
+  {
+  public:
+    Iterator(const ModuleTable* table, std::size_t index) : m_table(table), m_index(index) {}
+    ModuleInfo operator*() const { return (*m_table)[m_index]; }
+    Iterator& operator++()
+    {
+      ++m_index;
+      return *this;
+    }
+    bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+    bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+  private:
+    const ModuleTable* m_table = nullptr;
+    std::size_t m_index = 0;
+  };
+
+  ModuleTable() = default;
+  // Rows hold a pointer back to the table, so it stays where it was built.
+  ModuleTable(const ModuleTable&) = delete;
+  ModuleTable& operator=(const ModuleTable&) = delete;
+  ModuleTable(ModuleTable&&) = delete;
+  ModuleTable& operator=(ModuleTable&&) = delete;
+
+  // Fills an empty table. Call once, before any row is handed out.
+  void Build(const std::vector<ModuleRow>& rows, NameClassifier classify);
+
+  std::size_t size() const noexcept { return m_bases.size(); }
+  bool empty() const noexcept { return m_bases.empty(); }
+  ModuleInfo operator[](std::size_t i) const;
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, size()); }
+
+  std::uint64_t Base(std::size_t i) const { return m_bases[i]; }
+  std::uint64_t End(std::size_t i) const { return m_ends[i]; }
+  bool Has(std::size_t i, Flag flag) const { return (m_flags[i] & flag) != 0; }
+  const std::wstring& FilenameLower(std::size_t i) const { return m_names[m_nameIds[i]]; }
+  const std::string& Version(std::size_t i) const;
+  const std::wstring& InferredModName(std::size_t i) const;
+
+  // Index of the module containing `addr`.
+  std::optional<std::size_t> Find(std::uint64_t addr) const;
+  // First module whose file name matches, case-insensitively.
+  std::optional<std::size_t> FindByFilename(std::wstring_view filename) const;
+
+private:
+  struct VersionFields
+  {
+    bool has = false;
+    std::uint32_t ms = 0;
+    std::uint32_t ls = 0;
+  };
+
+  std::vector<std::uint64_t> m_bases;
+  std::vector<std::uint64_t> m_ends;
+  std::vector<std::uint8_t> m_flags;
+  std::vector<std::uint32_t> m_nameIds;
+  std::vector<std::wstring> m_names;
+  std::vector<std::wstring> m_paths;
+  std::vector<std::wstring> m_filenames;
+  std::vector<VersionFields> m_versionFields;
+
+  // Filled on first access, once per row.
+  mutable std::vector<std::string> m_versions;
+  mutable std::vector<std::wstring> m_modNames;
+  mutable std::unique_ptr<std::once_flag[]> m_versionOnce;
+  mutable std::unique_ptr<std::once_flag[]> m_modNameOnce;
+};
+
+std::optional<std::size_t> FindModuleIndexForAddress(const ModuleTable& mods, std::uint64_t addr);
+
+}  // namespace skydiag::dump_tool::minidump
@@ -290,8 +290,32 @@ std::string BuildReportText(
           << " stable_threads=" << r.freeze_analysis.thread_module_consensus.stable_thread_count
           << " os_lock_cycle_proven="
           << (r.freeze_analysis.thread_module_consensus.os_lock_cycle_proven ? "1" : "0")
+          << " whole_stack_threads=" << r.freeze_analysis.thread_module_consensus.whole_stack_thread_count
+          << "/" << r.freeze_analysis.thread_module_consensus.whole_stack_scanned_thread_count
           << "\n";
     }
+    if (r.freeze_analysis.wait_graph.has_graph) {
+      const auto& graph = r.freeze_analysis.wait_graph;
+      rpt << "  wait_graph threads=" << graph.thread_nodes
+          << " locks=" << graph.lock_nodes
+          << " cycles=" << graph.cycles.size()
+          << " longest_chain=" << graph.longest_chain_thread_ids.size()
+          << " longest_chain_has_cycle=" << (graph.longest_chain_has_cycle ? "1" : "0")
+          << "\n";
+      for (const auto& cycle : graph.cycles) {
+        rpt << "    cycle tids=";
+        for (std::size_t i = 0; i < cycle.thread_ids.size(); ++i) {
+          rpt << (i ? "," : "") << cycle.thread_ids[i];
+        }
+        if (!cycle.modules.empty()) {
+          rpt << " modules=";
+          for (std::size_t i = 0; i < cycle.modules.size(); ++i) {
+            rpt << (i ? "," : "") << WideToUtf8(cycle.modules[i]);
+          }
+        }
+        rpt << "\n";
+      }
+    }
     rpt << "  blackbox loading_window="
         << (r.freeze_analysis.blackbox_context.loading_window ? "1" : "0")
         << " module churn=" << r.freeze_analysis.blackbox_context.module_churn_score
@@ -322,6 +346,23 @@ std::string BuildReportText(
           << " [" << WideToUtf8(candidate.confidence) << "]\n";
     }
   }
+  if (r.hang_precapture.has_precapture) {
+    rpt << (en ? "HangPrecapture: " : "행 사전 캡처: ")
+        << "snapshots=" << r.hang_precapture.snapshot_count
+        << " dropped=" << r.hang_precapture.dropped_snapshots
+        << " main_tid=" << r.hang_precapture.main_thread_id
+        << " stable_main_rip_samples=" << r.hang_precapture.stable_main_rip_samples
+        << "\n";
+    for (const auto& entry : r.hang_precapture.timeline) {
+      rpt << "  +" << entry.offset_ms << "ms"
+          << " heartbeat_age_ms=" << static_cast<std::uint64_t>(entry.seconds_since_heartbeat * 1000.0)
+          << " rip=0x" << std::hex << entry.main_thread_rip << std::dec;
+      if (!entry.main_thread_module.empty()) {
+        rpt << " module=" << WideToUtf8(entry.main_thread_module);
+      }
+      rpt << "\n";
+    }
+  }
   if (!r.actionable_candidates.empty()) {
     rpt << (en ? "\nActionable candidates:\n" : "\n행동 우선 후보:\n");
     for (const auto& candidate : r.actionable_candidates) {
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cwctype>
 #include <filesystem>
 #include <optional>
@@ -27,6 +28,57 @@ using skydiag::dump_tool::internal::output_writer::MaybeRedactPath;
 using skydiag::dump_tool::internal::output_writer::ReplaceAll;
 using skydiag::dump_tool::internal::output_writer::TryLoadIncidentManifestJson;
 
+namespace {
+
+// "module+0xoffset" as written by the helper's fingerprint serializer.
+bool TryParseFingerprintFrame(const std::string& text, CrashBucketFrame* out)
+{
+  const auto plus = text.rfind("+0x");
+  if (plus == std::string::npos || plus == 0 || plus + 3 >= text.size()) {
+    return false;
+  }
+  char* end = nullptr;
+  const auto offset = std::strtoull(text.c_str() + plus + 3, &end, 16);
+  if (!end || *end != '\0') {
+    return false;
+  }
+  out->module_filename = Utf8ToWide(text.substr(0, plus));
+  out->module_offset = offset;
+  return true;
+}
+
+// Reports whether the helper's capture-time fingerprint agrees with this
+// analysis; the CTD2 bucket key stays authoritative either way.
+nlohmann::json BuildHelperFingerprintJson(const nlohmann::json& fp, const AnalysisResult& r)
+{
+  std::vector<CrashBucketFrame> helperFrames;
+  if (fp.contains("stack_frames") && fp["stack_frames"].is_array()) {
+    for (const auto& f : fp["stack_frames"]) {
+      CrashBucketFrame frame{};
+      if (f.is_string() && TryParseFingerprintFrame(f.get<std::string>(), &frame)) {
+        helperFrames.push_back(std::move(frame));
+      }
+    }
+  }
+  const auto check = CheckHelperFingerprint(
+    fp.value("exception_code", 0u),
+    Utf8ToWide(fp.value("fault_module", std::string{})),
+    fp.value("fault_offset", std::uint64_t{ 0 }),
+    helperFrames,
+    r.exc_code,
+    r.fault_module_filename,
+    r.fault_module_offset,
+    r.stackwalk_primary_bucket_frames);
+  return {
+    { "key", fp.value("key", std::string{}) },
+    { "fault_consistent", check.faultConsistent },
+    { "frames_confirmed", check.framesConfirmed },
+    { "frames_total", check.framesTotal },
+  };
+}
+
+}  // namespace
+
 nlohmann::json BuildSummaryJson(
   const AnalysisResult& r,
   const std::filesystem::path& outBase,
@@ -41,6 +93,13 @@ nlohmann::json BuildSummaryJson(
   };
   summary["dump_path"] = WideToUtf8(MaybeRedactPath(r.dump_path, redactPaths));
   summary["dump_identity"] = DumpIdentityJson(r.dump_identity);
+  if (!r.dump_delta_base_filename.empty()) {
+    summary["dump_delta"] = {
+      { "base_dump", WideToUtf8(r.dump_delta_base_filename) },
+      { "overlay_applied", r.dump_delta_overlay_applied },
+      { "overlay_scope", r.dump_delta_overlay_applied ? "stackwalk_memory" : "" },
+    };
+  }
   summary["pid"] = r.pid;
   summary["state_flags"] = r.state_flags;
   summary["summary_sentence"] = WideToUtf8(r.summary_sentence);
@@ -138,6 +197,9 @@ nlohmann::json BuildSummaryJson(
       { "manifest_path", WideToUtf8(MaybeRedactPath(incidentManifestPath.wstring(), redactPaths)) },
       { "privacy", std::move(privacy) },
     };
+    if (incidentManifest.contains("helper_fingerprint") && incidentManifest["helper_fingerprint"].is_object()) {
+      summary["helper_fingerprint"] = BuildHelperFingerprintJson(incidentManifest["helper_fingerprint"], r);
+    }
   }
   const auto summaryPath = outBase / (stem + L"_SkyrimDiagSummary.json");
   nlohmann::json triage;
@@ -305,6 +367,8 @@ nlohmann::json BuildSummaryJson(
 
   summary["callstack"] = nlohmann::json::object();
   summary["callstack"]["thread_id"] = r.stackwalk_primary_tid;
+  summary["callstack"]["unwinder"] = r.stackwalk_unwinder;
+  summary["callstack"]["stack_scan_fallback"] = r.stack_scan_fallback;
   summary["callstack"]["frames"] = nlohmann::json::array();
   for (const auto& f : r.stackwalk_primary_frames) {
     summary["callstack"]["frames"].push_back(WideToUtf8(f));
@@ -388,7 +452,39 @@ nlohmann::json BuildSummaryJson(
     { "matching_thread_count", r.freeze_analysis.thread_module_consensus.matching_thread_count },
     { "stable_thread_count", r.freeze_analysis.thread_module_consensus.stable_thread_count },
     { "os_lock_cycle_proven", r.freeze_analysis.thread_module_consensus.os_lock_cycle_proven },
+    { "whole_stack_thread_count", r.freeze_analysis.thread_module_consensus.whole_stack_thread_count },
+    { "whole_stack_scanned_thread_count", r.freeze_analysis.thread_module_consensus.whole_stack_scanned_thread_count },
   };
+  {
+    const auto& graph = r.freeze_analysis.wait_graph;
+    const auto toUtf8Array = [](const std::vector<std::wstring>& items) {
+      nlohmann::json arr = nlohmann::json::array();
+      for (const auto& item : items) {
+        arr.push_back(WideToUtf8(item));
+      }
+      return arr;
+    };
+    nlohmann::json cycles = nlohmann::json::array();
+    for (const auto& cycle : graph.cycles) {
+      cycles.push_back({
+        { "thread_ids", cycle.thread_ids },
+        { "lock_names", toUtf8Array(cycle.lock_names) },
+        { "modules", toUtf8Array(cycle.modules) },
+      });
+    }
+    summary["freeze_analysis"]["wait_graph"] = {
+      { "has_graph", graph.has_graph },
+      { "thread_nodes", graph.thread_nodes },
+      { "lock_nodes", graph.lock_nodes },
+      { "cycle_count", graph.cycles.size() },
+      { "cycles", std::move(cycles) },
+      { "longest_chain", {
+        { "thread_ids", graph.longest_chain_thread_ids },
+        { "modules", toUtf8Array(graph.longest_chain_modules) },
+        { "has_cycle", graph.longest_chain_has_cycle },
+      } },
+    };
+  }
   summary["freeze_analysis"]["primary_reasons"] = nlohmann::json::array();
   for (const auto& reason : r.freeze_analysis.primary_reasons) {
     summary["freeze_analysis"]["primary_reasons"].push_back(WideToUtf8(reason));
@@ -445,6 +541,23 @@ nlohmann::json BuildSummaryJson(
     summary["first_chance_context"]["recent_non_system_modules"].push_back(WideToUtf8(moduleName));
   }
 
+  summary["hang_precapture"] = {
+    { "has_precapture", r.hang_precapture.has_precapture },
+    { "snapshot_count", r.hang_precapture.snapshot_count },
+    { "dropped_snapshots", r.hang_precapture.dropped_snapshots },
+    { "main_thread_id", r.hang_precapture.main_thread_id },
+    { "stable_main_rip_samples", r.hang_precapture.stable_main_rip_samples },
+    { "timeline", nlohmann::json::array() },
+  };
+  for (const auto& entry : r.hang_precapture.timeline) {
+    summary["hang_precapture"]["timeline"].push_back({
+      { "offset_ms", entry.offset_ms },
+      { "seconds_since_heartbeat", entry.seconds_since_heartbeat },
+      { "main_thread_rip", entry.main_thread_rip },
+      { "main_thread_module", WideToUtf8(entry.main_thread_module) },
+    });
+  }
+
   summary["evidence"] = nlohmann::json::array();
   for (const auto& e : r.evidence) {
     summary["evidence"].push_back({
@@ -499,6 +612,23 @@ nlohmann::json BuildSummaryJson(
     summary["diagnostics"] = std::move(diags);
   }
 
+  if (!r.stage_timings.empty()) {
+    auto stages = nlohmann::json::array();
+    for (const auto& t : r.stage_timings) {
+      stages.push_back({
+        { "name", t.name },
+        { "start_ms", t.start_ms },
+        { "duration_ms", t.duration_ms },
+        { "worker", t.worker },
+      });
+    }
+    summary["analysis_timings"] = {
+      { "workers", r.analysis_workers },
+      { "total_ms", r.analysis_total_ms },
+      { "stages", std::move(stages) },
+    };
+  }
+
   return summary;
 }
 
@@ -1,5 +1,6 @@
 #include "OutputWriterInternals.h"
 #include "DumpIdentity.h"
+#include "Sha256.h"
 #include "Utf.h"
 
 #include <Windows.h>
@@ -211,6 +212,16 @@ bool WriteTextUtf8(const std::filesystem::path& path, const std::string& content
 
 nlohmann::json DumpIdentityJson(const DumpIdentity& identity)
 {
+  if (identity.algorithm == DumpIdentityAlgorithm::kTreeSha256) {
+    return {
+      { "schema", "skydiag.dump_identity.v2" },
+      { "algorithm", std::string(DumpIdentityAlgorithmName(identity.algorithm)) },
+      { "leaf_bytes", kTreeSha256DefaultLeafBytes },
+      { "digest", identity.sha256 },
+      { "size_bytes", identity.size_bytes },
+      { "last_write_time_utc_100ns", identity.last_write_time_utc_100ns },
+    };
+  }
   return {
     { "schema", "skydiag.dump_identity.v1" },
     { "sha256", identity.sha256 },
@@ -224,12 +235,26 @@ bool DumpIdentityMatchesJson(const nlohmann::json& value, const DumpIdentity& id
   if (!identity.IsValid() || !value.is_object()) {
     return false;
   }
+  // A tree identity never vouches for state written under a flat one (or
+  // the reverse), even for the same file: the schema and digest field differ.
+  const bool tree = identity.algorithm == DumpIdentityAlgorithm::kTreeSha256;
   const auto schema = value.find("schema");
-  const auto sha = value.find("sha256");
+  const auto sha = value.find(tree ? "digest" : "sha256");
   const auto size = value.find("size_bytes");
   const auto modified = value.find("last_write_time_utc_100ns");
+  if (tree) {
+    const auto algorithm = value.find("algorithm");
+    const auto leafBytes = value.find("leaf_bytes");
+    if (algorithm == value.end() || !algorithm->is_string() ||
+        algorithm->get_ref<const std::string&>() != DumpIdentityAlgorithmName(identity.algorithm) ||
+        leafBytes == value.end() || !leafBytes->is_number_unsigned() ||
+        leafBytes->get<std::uint64_t>() != kTreeSha256DefaultLeafBytes) {
+      return false;
+    }
+  }
   return schema != value.end() && schema->is_string() &&
-    schema->get_ref<const std::string&>() == "skydiag.dump_identity.v1" &&
+    schema->get_ref<const std::string&>() ==
+      (tree ? "skydiag.dump_identity.v2" : "skydiag.dump_identity.v1") &&
     sha != value.end() && sha->is_string() &&
     sha->get_ref<const std::string&>() == identity.sha256 &&
     size != value.end() && size->is_number_unsigned() &&
@@ -247,7 +272,7 @@ std::filesystem::path TriageStatePath(
   }
   return outBase
     / L".skydiag-triage"
-    / Utf8ToWide(identity.sha256)
+    / Utf8ToWide(identity.DigestKey())
     / (Utf8ToWide(identity.StorageMetadataKey()) + L".json");
 }
 
@@ -260,10 +285,20 @@ std::filesystem::path IdentityArtifactDirectory(
   }
   return outBase
     / L".skydiag-analysis"
-    / Utf8ToWide(identity.sha256)
+    / Utf8ToWide(identity.DigestKey())
     / Utf8ToWide(identity.StorageMetadataKey());
 }
 
+std::filesystem::path DumpIdentityCacheDirectory(const std::filesystem::path& outBase)
+{
+  return outBase / L".skydiag-identity";
+}
+
+std::filesystem::path ModuleCacheDirectory(const std::filesystem::path& outBase)
+{
+  return outBase / L".skydiag-modules";
+}
+
 std::filesystem::path OutputFamilyLockPath(
   const std::filesystem::path& outBase,
   std::wstring_view dumpStem)
@@ -37,6 +37,12 @@ std::filesystem::path IdentityArtifactDirectory(
   const std::filesystem::path& outBase,
   const DumpIdentity& identity);
 
+// Sidecars of ComputeDumpIdentity digests, keyed by file ID (DumpIdentityCache.h).
+std::filesystem::path DumpIdentityCacheDirectory(const std::filesystem::path& outBase);
+
+// Per-module unwind and symbol caches, keyed by module build (ModuleCache.h).
+std::filesystem::path ModuleCacheDirectory(const std::filesystem::path& outBase);
+
 std::filesystem::path OutputFamilyLockPath(
   const std::filesystem::path& outBase,
   std::wstring_view dumpStem);
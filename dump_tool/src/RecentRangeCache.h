@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace skydiag::dump_tool::minidump {
+
+// Remembers the last few ranges a sorted range table answered from, so the
+// memory readers skip the upper_bound for the access pattern stack walks
+// produce: thousands of tiny reads that stay inside the current stack, with
+// the odd hop to a module or heap range and straight back.
+//
+// Slot 0 is the most recent hit (sequential reads within one range stop
+// there); a hit in a later slot moves to the front, a miss does the binary
+// search and pushes its range in. Slots are relaxed atomics holding indices
+// that are always re-checked against the table, so concurrent readers may
+// see each other's hints but never a wrong answer. Copies start cold.
+class RecentRangeCache
+{
+public:
+  static constexpr std::size_t kSlots = 8;
+  static constexpr std::size_t kNone = static_cast<std::size_t>(-1);
+
+  RecentRangeCache() noexcept { Reset(); }
+  RecentRangeCache(const RecentRangeCache&) noexcept { Reset(); }
+  RecentRangeCache& operator=(const RecentRangeCache&) noexcept
+  {
+    Reset();
+    return *this;
+  }
+
+  // Call whenever the table the slots index into changes.
+  void Reset() noexcept
+  {
+    for (auto& slot : m_slots) {
+      slot.store(kEmpty, std::memory_order_relaxed);
+    }
+  }
+
+  // Index of the range in `ranges` (sorted by start) with the greatest
+  // start <= addr, if it contains `addr`; else kNone. StartOf(r) and
+  // Contains(r, addr) adapt the caller's range type.
+  template <class Range, class StartOf, class Contains>
+  std::size_t Find(const std::vector<Range>& ranges, std::uint64_t addr, StartOf&& startOf, Contains&& contains) const
+  {
+    for (std::size_t k = 0; k < kSlots; ++k) {
+      const std::uint32_t i = m_slots[k].load(std::memory_order_relaxed);
+      // The successor check keeps the answer identical to the binary search
+      // (greatest start <= addr) even if a malformed table overlaps.
+      if (i < ranges.size() && contains(ranges[i], addr) &&
+          (i + 1u == ranges.size() || addr < startOf(ranges[i + 1u]))) {
+        if (k != 0) {
+          Promote(k, i);
+        }
+        return i;
+      }
+    }
+
+    const auto it = std::upper_bound(ranges.begin(), ranges.end(), addr, [&](std::uint64_t value, const Range& r) {
+      return value < startOf(r);
+    });
+    if (it == ranges.begin()) {
+      return kNone;
+    }
+    const auto i = static_cast<std::size_t>(it - ranges.begin()) - 1u;
+    if (!contains(ranges[i], addr)) {
+      return kNone;
+    }
+    if (i < kEmpty) {
+      Promote(kSlots - 1u, static_cast<std::uint32_t>(i));
+    }
+    return i;
+  }
+
+private:
+  static constexpr std::uint32_t kEmpty = 0xFFFFFFFFu;
+
+  // Moves slots [0, k) down by one and puts `index` in front.
+  void Promote(std::size_t k, std::uint32_t index) const noexcept
+  {
+    for (std::size_t j = k; j > 0; --j) {
+      m_slots[j].store(m_slots[j - 1u].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    m_slots[0].store(index, std::memory_order_relaxed);
+  }
+
+  mutable std::array<std::atomic<std::uint32_t>, kSlots> m_slots;
+};
+
+}  // namespace skydiag::dump_tool::minidump
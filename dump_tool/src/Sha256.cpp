@@ -0,0 +1,396 @@
+#include "Sha256.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SKYDIAG_SHA256_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+#define SKYDIAG_SHA256_ARM 1
+#include <arm_neon.h>
+#endif
+
+namespace skydiag::dump_tool {
+namespace {
+
+alignas(16) constexpr std::uint32_t kRoundConstants[64] = {
+  0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+  0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+  0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+  0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+  0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+  0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+  0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+  0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u,
+};
+
+constexpr std::uint32_t kInitialState[8] = {
+  0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u,
+};
+
+using BlockFn = void (*)(std::uint32_t state[8], const std::uint8_t* data, std::size_t blocks);
+
+constexpr std::uint32_t Rotr(std::uint32_t x, unsigned n) noexcept
+{
+  return (x >> n) | (x << (32u - n));
+}
+
+std::uint32_t LoadBe32(const std::uint8_t* p) noexcept
+{
+  return (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16) |
+    (static_cast<std::uint32_t>(p[2]) << 8) | static_cast<std::uint32_t>(p[3]);
+}
+
+void BlocksScalar(std::uint32_t state[8], const std::uint8_t* data, std::size_t blocks)
+{
+  std::uint32_t w[64];
+  for (; blocks > 0; --blocks, data += 64) {
+    for (int t = 0; t < 16; ++t) {
+      w[t] = LoadBe32(data + t * 4);
+    }
+    for (int t = 16; t < 64; ++t) {
+      const std::uint32_t s0 = Rotr(w[t - 15], 7) ^ Rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+      const std::uint32_t s1 = Rotr(w[t - 2], 17) ^ Rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+      w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+
+    std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int t = 0; t < 64; ++t) {
+      const std::uint32_t s1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+      const std::uint32_t ch = (e & f) ^ (~e & g);
+      const std::uint32_t t1 = h + s1 + ch + kRoundConstants[t] + w[t];
+      const std::uint32_t s0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+      const std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+      const std::uint32_t t2 = s0 + maj;
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+#if defined(SKYDIAG_SHA256_X86)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SKYDIAG_SHA_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#else
+#define SKYDIAG_SHA_TARGET
+#endif
+
+// SHA-NI: the state lives as ABEF/CDGH halves, each sha256rnds2 does two
+// rounds, and msg1/msg2 extend the schedule four words at a time.
+SKYDIAG_SHA_TARGET void BlocksShaNi(std::uint32_t state[8], const std::uint8_t* data, std::size_t blocks)
+{
+  const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+
+  __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1);  // CDAB
+  __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B);  // EFGH
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);       // CDGH
+
+  for (; blocks > 0; --blocks, data += 64) {
+    const __m128i abefSave = state0;
+    const __m128i cdghSave = state1;
+    __m128i w[4];
+    for (int g = 0; g < 16; ++g) {
+      __m128i& cur = w[g & 3];
+      if (g < 4) {
+        cur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + g * 16)), byteSwap);
+      } else {
+        const __m128i& prev1 = w[(g - 1) & 3];
+        const __m128i& prev2 = w[(g - 2) & 3];
+        const __m128i& prev3 = w[(g - 3) & 3];
+        cur = _mm_sha256msg2_epu32(
+          _mm_add_epi32(_mm_sha256msg1_epu32(cur, prev3), _mm_alignr_epi8(prev1, prev2, 4)),
+          prev1);
+      }
+      __m128i msg = _mm_add_epi32(cur, _mm_load_si128(reinterpret_cast<const __m128i*>(&kRoundConstants[g * 4])));
+      state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+      msg = _mm_shuffle_epi32(msg, 0x0E);
+      state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+    }
+    state0 = _mm_add_epi32(state0, abefSave);
+    state1 = _mm_add_epi32(state1, cdghSave);
+  }
+
+  tmp = _mm_shuffle_epi32(state0, 0x1B);     // FEBA
+  state1 = _mm_shuffle_epi32(state1, 0xB1);  // DCHG
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(tmp, state1, 0xF0));  // DCBA
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(state1, tmp, 8));     // EFGH
+}
+
+bool CpuHasShaNi() noexcept
+{
+#if defined(_MSC_VER)
+  int regs[4]{};
+  __cpuid(regs, 0);
+  if (regs[0] < 7) {
+    return false;
+  }
+  __cpuid(regs, 1);
+  const bool ssse3 = (regs[2] & (1 << 9)) != 0;
+  const bool sse41 = (regs[2] & (1 << 19)) != 0;
+  __cpuidex(regs, 7, 0);
+  const bool sha = (regs[1] & (1 << 29)) != 0;
+#else
+  unsigned a = 0, b = 0, c = 0, d = 0;
+  if (!__get_cpuid(1, &a, &b, &c, &d)) {
+    return false;
+  }
+  const bool ssse3 = (c & (1u << 9)) != 0;
+  const bool sse41 = (c & (1u << 19)) != 0;
+  if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+    return false;
+  }
+  const bool sha = (b & (1u << 29)) != 0;
+#endif
+  return ssse3 && sse41 && sha;
+}
+
+BlockFn SelectAccelerated() noexcept
+{
+  return CpuHasShaNi() ? &BlocksShaNi : nullptr;
+}
+
+#elif defined(SKYDIAG_SHA256_ARM)
+
+void BlocksArmV8(std::uint32_t state[8], const std::uint8_t* data, std::size_t blocks)
+{
+  uint32x4_t state0 = vld1q_u32(&state[0]);
+  uint32x4_t state1 = vld1q_u32(&state[4]);
+
+  for (; blocks > 0; --blocks, data += 64) {
+    const uint32x4_t abcdSave = state0;
+    const uint32x4_t efghSave = state1;
+    uint32x4_t w[4];
+    for (int g = 0; g < 16; ++g) {
+      uint32x4_t& cur = w[g & 3];
+      if (g < 4) {
+        cur = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + g * 16)));
+      } else {
+        cur = vsha256su1q_u32(vsha256su0q_u32(cur, w[(g - 3) & 3]), w[(g - 2) & 3], w[(g - 1) & 3]);
+      }
+      const uint32x4_t msg = vaddq_u32(cur, vld1q_u32(&kRoundConstants[g * 4]));
+      const uint32x4_t abcd = state0;
+      state0 = vsha256hq_u32(state0, state1, msg);
+      state1 = vsha256h2q_u32(state1, abcd, msg);
+    }
+    state0 = vaddq_u32(state0, abcdSave);
+    state1 = vaddq_u32(state1, efghSave);
+  }
+
+  vst1q_u32(&state[0], state0);
+  vst1q_u32(&state[4], state1);
+}
+
+BlockFn SelectAccelerated() noexcept
+{
+  // Compiled only when the target baseline already includes the SHA2
+  // extension, so there is nothing left to probe at runtime.
+  return &BlocksArmV8;
+}
+
+#else
+
+BlockFn SelectAccelerated() noexcept
+{
+  return nullptr;
+}
+
+#endif
+
+BlockFn AcceleratedBlocks() noexcept
+{
+  static const BlockFn fn = SelectAccelerated();
+  return fn;
+}
+
+std::atomic<bool> g_forceScalar{ false };
+
+void ProcessBlocks(std::uint32_t state[8], const std::uint8_t* data, std::size_t blocks) noexcept
+{
+  const BlockFn accelerated = AcceleratedBlocks();
+  if (accelerated && !g_forceScalar.load(std::memory_order_relaxed)) {
+    accelerated(state, data, blocks);
+  } else {
+    BlocksScalar(state, data, blocks);
+  }
+}
+
+void StoreLe64(std::uint8_t* p, std::uint64_t v) noexcept
+{
+  for (int i = 0; i < 8; ++i) {
+    p[i] = static_cast<std::uint8_t>(v >> (i * 8));
+  }
+}
+
+Sha256Digest HashLeaf(const std::uint8_t* bytes, std::size_t size)
+{
+  static constexpr std::uint8_t kLeafPrefix = 0x00;
+  Sha256 h;
+  h.Update(&kLeafPrefix, 1);
+  h.Update(bytes, size);
+  return h.Finish();
+}
+
+}  // namespace
+
+void Sha256::Reset() noexcept
+{
+  std::memcpy(m_state, kInitialState, sizeof(m_state));
+  m_buffered = 0;
+  m_totalBytes = 0;
+}
+
+void Sha256::Update(const void* data, std::size_t size) noexcept
+{
+  auto* p = static_cast<const std::uint8_t*>(data);
+  m_totalBytes += size;
+  if (m_buffered > 0) {
+    const std::size_t take = std::min(size, sizeof(m_buffer) - m_buffered);
+    std::memcpy(m_buffer + m_buffered, p, take);
+    m_buffered += take;
+    p += take;
+    size -= take;
+    if (m_buffered < sizeof(m_buffer)) {
+      return;
+    }
+    ProcessBlocks(m_state, m_buffer, 1);
+    m_buffered = 0;
+  }
+  if (const std::size_t blocks = size / 64u; blocks > 0) {
+    ProcessBlocks(m_state, p, blocks);
+    p += blocks * 64u;
+    size -= blocks * 64u;
+  }
+  if (size > 0) {
+    std::memcpy(m_buffer, p, size);
+    m_buffered = size;
+  }
+}
+
+Sha256Digest Sha256::Finish() noexcept
+{
+  const std::uint64_t bitLength = m_totalBytes * 8u;
+  std::uint8_t tail[128]{};
+  std::memcpy(tail, m_buffer, m_buffered);
+  tail[m_buffered] = 0x80;
+  const std::size_t tailSize = m_buffered + 1u + 8u <= 64u ? 64u : 128u;
+  for (int i = 0; i < 8; ++i) {
+    tail[tailSize - 1u - static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(bitLength >> (i * 8));
+  }
+  ProcessBlocks(m_state, tail, tailSize / 64u);
+
+  Sha256Digest digest{};
+  for (std::size_t i = 0; i < 8; ++i) {
+    digest[i * 4 + 0] = static_cast<std::uint8_t>(m_state[i] >> 24);
+    digest[i * 4 + 1] = static_cast<std::uint8_t>(m_state[i] >> 16);
+    digest[i * 4 + 2] = static_cast<std::uint8_t>(m_state[i] >> 8);
+    digest[i * 4 + 3] = static_cast<std::uint8_t>(m_state[i]);
+  }
+  Reset();
+  return digest;
+}
+
+Sha256Digest ComputeSha256(const void* data, std::size_t size) noexcept
+{
+  Sha256 h;
+  h.Update(data, size);
+  return h.Finish();
+}
+
+std::string Sha256HexLower(const Sha256Digest& digest)
+{
+  static constexpr char kHex[] = "0123456789abcdef";
+  std::string out(digest.size() * 2u, '0');
+  for (std::size_t i = 0; i < digest.size(); ++i) {
+    out[i * 2u] = kHex[(digest[i] >> 4u) & 0x0fu];
+    out[i * 2u + 1u] = kHex[digest[i] & 0x0fu];
+  }
+  return out;
+}
+
+bool Sha256HardwareAccelerated() noexcept
+{
+  return AcceleratedBlocks() != nullptr && !g_forceScalar.load(std::memory_order_relaxed);
+}
+
+void Sha256ForceScalarForTesting(bool forceScalar) noexcept
+{
+  g_forceScalar.store(forceScalar, std::memory_order_relaxed);
+}
+
+Sha256Digest ComputeTreeSha256(
+  const void* data,
+  std::uint64_t size,
+  std::size_t leafBytes,
+  unsigned workers)
+{
+  if (leafBytes == 0) {
+    leafBytes = kTreeSha256DefaultLeafBytes;
+  }
+  const auto* bytes = static_cast<const std::uint8_t*>(data);
+  const std::size_t leafCount = static_cast<std::size_t>((size + leafBytes - 1u) / leafBytes);
+  std::vector<Sha256Digest> leaves(leafCount);
+
+  if (workers == 0) {
+    workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  workers = static_cast<unsigned>(std::min<std::size_t>(workers, std::max<std::size_t>(leafCount, 1u)));
+
+  std::atomic<std::size_t> next{ 0 };
+  const auto work = [&]() {
+    for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < leafCount;
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      const std::uint64_t offset = static_cast<std::uint64_t>(i) * leafBytes;
+      const auto take = static_cast<std::size_t>(std::min<std::uint64_t>(leafBytes, size - offset));
+      leaves[i] = HashLeaf(bytes + offset, take);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1u);
+  for (unsigned w = 1; w < workers; ++w) {
+    pool.emplace_back(work);
+  }
+  work();
+  for (auto& t : pool) {
+    t.join();
+  }
+
+  std::uint8_t header[17]{};
+  header[0] = 0x01;
+  StoreLe64(header + 1, leafBytes);
+  StoreLe64(header + 9, size);
+  Sha256 root;
+  root.Update(header, sizeof(header));
+  for (const auto& leaf : leaves) {
+    root.Update(leaf.data(), leaf.size());
+  }
+  return root.Finish();
+}
+
+}  // namespace skydiag::dump_tool
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace skydiag::dump_tool {
+
+using Sha256Digest = std::array<std::uint8_t, 32>;
+
+// Portable streaming SHA-256 (FIPS 180-4). The block function picks the
+// x86 SHA extensions or the ARMv8 crypto instructions when the CPU has them
+// and falls back to a scalar implementation otherwise; all paths produce the
+// same digest.
+class Sha256
+{
+public:
+  Sha256() noexcept { Reset(); }
+
+  void Reset() noexcept;
+  void Update(const void* data, std::size_t size) noexcept;
+  Sha256Digest Finish() noexcept;
+
+private:
+  std::uint32_t m_state[8]{};
+  std::uint8_t m_buffer[64]{};
+  std::size_t m_buffered = 0;
+  std::uint64_t m_totalBytes = 0;
+};
+
+Sha256Digest ComputeSha256(const void* data, std::size_t size) noexcept;
+std::string Sha256HexLower(const Sha256Digest& digest);
+
+// True when the block function uses SHA-NI / ARMv8 SHA2 on this machine.
+bool Sha256HardwareAccelerated() noexcept;
+// Test hook: forces the scalar block function in this process.
+void Sha256ForceScalarForTesting(bool forceScalar) noexcept;
+
+inline constexpr std::size_t kTreeSha256DefaultLeafBytes = 16u * 1024u * 1024u;
+
+// Two-level tree hash for large dumps, so leaves can be hashed in parallel:
+//   leaf_i = SHA-256(0x00 || bytes[i*leafBytes, (i+1)*leafBytes))
+//   root   = SHA-256(0x01 || LE64(leafBytes) || LE64(size) || leaf_0 || ...)
+// The domain-separation prefixes keep a leaf from being confused with the
+// root. The digest depends on leafBytes, so callers persisting it must keep
+// leafBytes fixed (DumpIdentity always uses the default).
+// workers == 0 picks hardware_concurrency(); 1 hashes on the calling thread.
+Sha256Digest ComputeTreeSha256(
+  const void* data,
+  std::uint64_t size,
+  std::size_t leafBytes = kTreeSha256DefaultLeafBytes,
+  unsigned workers = 0);
+
+}  // namespace skydiag::dump_tool
@@ -0,0 +1,72 @@
+#include "StackModuleScan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace skydiag::dump_tool::minidump {
+namespace {
+
+// Below this the scan finishes faster than the workers start.
+constexpr std::size_t kMinBytesForWorkers = std::size_t{ 1 } << 20;
+constexpr unsigned kMaxDefaultWorkers = 8;
+
+StackModuleRefs ScanOne(const ModuleAddressIndex& index, const StackSlice& slice)
+{
+  StackModuleRefs refs;
+  refs.tid = slice.tid;
+  if (!slice.bytes) {
+    return refs;
+  }
+  index.ForEachModulePointer(slice.bytes, slice.size, [&](std::size_t, std::size_t mi) {
+    refs.modules.push_back(static_cast<std::uint32_t>(mi));
+  });
+  std::sort(refs.modules.begin(), refs.modules.end());
+  refs.modules.erase(std::unique(refs.modules.begin(), refs.modules.end()), refs.modules.end());
+  return refs;
+}
+
+}  // namespace
+
+std::vector<StackModuleRefs> ScanStacksForModuleRefs(
+  const ModuleAddressIndex& index,
+  const std::vector<StackSlice>& slices,
+  unsigned maxWorkers)
+{
+  std::vector<StackModuleRefs> out(slices.size());
+  if (slices.empty()) {
+    return out;
+  }
+
+  std::size_t totalBytes = 0;
+  for (const auto& slice : slices) {
+    totalBytes += slice.size;
+  }
+  if (maxWorkers == 0) {
+    maxWorkers = std::clamp(std::thread::hardware_concurrency(), 1u, kMaxDefaultWorkers);
+  }
+  const unsigned workers = totalBytes < kMinBytesForWorkers
+    ? 1u
+    : static_cast<unsigned>(std::min<std::size_t>(maxWorkers, slices.size()));
+
+  std::atomic<std::size_t> next{ 0 };
+  const auto work = [&]() {
+    for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < slices.size();
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      out[i] = ScanOne(index, slices[i]);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(workers > 0 ? workers - 1 : 0);
+  for (unsigned w = 1; w < workers; ++w) {
+    pool.emplace_back(work);
+  }
+  work();
+  for (auto& t : pool) {
+    t.join();
+  }
+  return out;
+}
+
+}  // namespace skydiag::dump_tool::minidump
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ModuleAddressIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace skydiag::dump_tool::minidump {
+
+// One thread's captured stack, from the current stack pointer to the base.
+struct StackSlice
+{
+  std::uint32_t tid = 0;
+  const std::uint8_t* bytes = nullptr;
+  std::size_t size = 0;
+};
+
+// Modules a stack references at least once, as indices into the list the
+// ModuleAddressIndex was built from (sorted, unique).
+struct StackModuleRefs
+{
+  std::uint32_t tid = 0;
+  std::vector<std::uint32_t> modules;
+};
+
+// Whole-stack pointer scan of every slice, split across worker threads when
+// the total is large enough to pay for them. Results keep the slice order.
+// maxWorkers == 0 picks min(hardware threads, 8).
+std::vector<StackModuleRefs> ScanStacksForModuleRefs(
+  const ModuleAddressIndex& index,
+  const std::vector<StackSlice>& slices,
+  unsigned maxWorkers = 0);
+
+}  // namespace skydiag::dump_tool::minidump
@@ -0,0 +1,248 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace skydiag::dump_tool {
+namespace {
+
+constexpr std::size_t kNoHomeQueue = std::numeric_limits<std::size_t>::max();
+
+}  // namespace
+
+TaskGraph::TaskGraph(unsigned workers)
+  : m_workerCount(workers)
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+  if (!m_started) {
+    return;
+  }
+  WaitUntil([this]() {
+    return std::all_of(m_tasks.begin(), m_tasks.end(), [](const Task& t) { return t.done; });
+  });
+  {
+    std::lock_guard lock(m_mutex);
+    m_stopping = true;
+  }
+  m_cv.notify_all();
+  for (auto& t : m_threads) {
+    t.join();
+  }
+}
+
+TaskGraph::TaskId TaskGraph::Add(std::string name, std::function<void()> fn, std::initializer_list<TaskId> deps)
+{
+  const TaskId id = m_tasks.size();
+  Task task;
+  task.name = std::move(name);
+  task.fn = std::move(fn);
+  for (const auto dep : deps) {
+    if (dep < id) {
+      m_tasks[dep].dependents.push_back(id);
+      ++task.pendingDeps;
+    }
+  }
+  m_tasks.push_back(std::move(task));
+  return id;
+}
+
+void TaskGraph::Start()
+{
+  if (m_started) {
+    return;
+  }
+  m_started = true;
+  const std::size_t queueCount = std::max(1u, m_workerCount);
+  for (std::size_t i = 0; i < queueCount; ++i) {
+    m_queues.push_back(std::make_unique<WorkQueue>());
+  }
+  for (TaskId id = 0; id < m_tasks.size(); ++id) {
+    if (m_tasks[id].pendingDeps == 0) {
+      Push(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % queueCount, id);
+    }
+  }
+  for (unsigned i = 0; i < m_workerCount; ++i) {
+    m_threads.emplace_back([this, i]() { WorkerMain(i); });
+  }
+}
+
+void TaskGraph::Wait(TaskId id)
+{
+  Start();
+  WaitUntil([this, id]() { return m_tasks[id].done; });
+  std::exception_ptr error;
+  {
+    std::lock_guard lock(m_mutex);
+    error = m_tasks[id].error;
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void TaskGraph::WaitAll()
+{
+  for (TaskId id = 0; id < m_tasks.size(); ++id) {
+    Wait(id);
+  }
+}
+
+std::vector<TaskTiming> TaskGraph::Timings() const
+{
+  std::vector<TaskTiming> out;
+  {
+    std::lock_guard lock(m_mutex);
+    out = m_timings;
+  }
+  std::stable_sort(out.begin(), out.end(), [](const TaskTiming& a, const TaskTiming& b) {
+    return a.start_ms < b.start_ms;
+  });
+  return out;
+}
+
+bool TaskGraph::TryTake(std::size_t home, TaskId* out)
+{
+  if (home < m_queues.size()) {
+    auto& own = *m_queues[home];
+    std::lock_guard lock(own.mutex);
+    if (!own.tasks.empty()) {
+      *out = own.tasks.back();
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  const std::size_t n = m_queues.size();
+  const std::size_t first = home < n ? home + 1 : 0;
+  for (std::size_t k = 0; k < n; ++k) {
+    const std::size_t victim = (first + k) % n;
+    if (victim == home) {
+      continue;
+    }
+    auto& q = *m_queues[victim];
+    std::lock_guard lock(q.mutex);
+    if (!q.tasks.empty()) {
+      *out = q.tasks.front();
+      q.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskGraph::Push(std::size_t queue, TaskId id)
+{
+  {
+    auto& q = *m_queues[queue];
+    std::lock_guard lock(q.mutex);
+    q.tasks.push_back(id);
+  }
+  {
+    std::lock_guard lock(m_mutex);
+    ++m_epoch;
+  }
+  m_cv.notify_all();
+}
+
+void TaskGraph::Execute(TaskId id, int worker, std::size_t home)
+{
+  Task& task = m_tasks[id];
+  std::exception_ptr error;
+  {
+    std::lock_guard lock(m_mutex);
+    error = task.error;  // set when a dependency failed
+  }
+
+  if (!error) {
+    const auto start = Clock::now();
+    try {
+      task.fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    RecordTiming(task.name, start, Clock::now(), worker);
+  }
+
+  std::vector<TaskId> ready;
+  {
+    std::lock_guard lock(m_mutex);
+    task.done = true;
+    task.error = error;
+    for (const auto dep : task.dependents) {
+      auto& d = m_tasks[dep];
+      if (error && !d.error) {
+        d.error = error;
+      }
+      if (--d.pendingDeps == 0) {
+        ready.push_back(dep);
+      }
+    }
+    ++m_epoch;
+  }
+  m_cv.notify_all();
+
+  const std::size_t queue = home < m_queues.size()
+    ? home
+    : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+  for (const auto dep : ready) {
+    Push(queue, dep);
+  }
+}
+
+void TaskGraph::WorkerMain(std::size_t index)
+{
+  for (;;) {
+    std::uint64_t seen = 0;
+    {
+      std::lock_guard lock(m_mutex);
+      if (m_stopping) {
+        return;
+      }
+      seen = m_epoch;
+    }
+    TaskId id = 0;
+    if (TryTake(index, &id)) {
+      Execute(id, static_cast<int>(index) + 1, index);
+      continue;
+    }
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [&]() { return m_stopping || m_epoch != seen; });
+  }
+}
+
+void TaskGraph::WaitUntil(const std::function<bool()>& done)
+{
+  for (;;) {
+    std::uint64_t seen = 0;
+    {
+      std::lock_guard lock(m_mutex);
+      if (done()) {
+        return;
+      }
+      seen = m_epoch;
+    }
+    TaskId id = 0;
+    if (TryTake(kNoHomeQueue, &id)) {
+      Execute(id, 0, kNoHomeQueue);
+      continue;
+    }
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [&]() { return done() || m_epoch != seen; });
+  }
+}
+
+void TaskGraph::RecordTiming(std::string name, Clock::time_point start, Clock::time_point end, int worker)
+{
+  using Ms = std::chrono::duration<double, std::milli>;
+  TaskTiming timing;
+  timing.name = std::move(name);
+  timing.start_ms = Ms(start - m_origin).count();
+  timing.duration_ms = Ms(end - start).count();
+  timing.worker = worker;
+  std::lock_guard lock(m_mutex);
+  m_timings.push_back(std::move(timing));
+}
+
+}  // namespace skydiag::dump_tool
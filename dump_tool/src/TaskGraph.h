@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace skydiag::dump_tool {
+
+struct TaskTiming
+{
+  std::string name;
+  double start_ms = 0.0;     // since the graph was created
+  double duration_ms = 0.0;
+  int worker = 0;            // 0 = the analysis thread, 1..N = pool workers
+};
+
+// Small dependency-graph executor for AnalyzeDump. Tasks are added up front
+// with the ids of the tasks they depend on, then Start() hands ready tasks to
+// a fixed pool: each worker has its own deque (LIFO for the tasks it made
+// ready itself) and steals from the front of the others when idle. The
+// analysis thread keeps running the sequential stages and calls Wait() where
+// it needs a task's result; while waiting it steals work too, so a graph with
+// zero workers still completes.
+//
+// Every task and every RunInline() step is timed on one clock; Timings()
+// feeds the summary's per-stage breakdown.
+//
+// A task that throws is marked failed, its dependents are skipped and Wait()
+// on any of them rethrows the exception.
+class TaskGraph
+{
+public:
+  using TaskId = std::size_t;
+
+  explicit TaskGraph(unsigned workers);
+  TaskGraph(const TaskGraph&) = delete;
+  TaskGraph& operator=(const TaskGraph&) = delete;
+  ~TaskGraph();  // waits for every task, then joins the pool
+
+  // Only before Start(). `deps` must be ids returned earlier.
+  TaskId Add(std::string name, std::function<void()> fn, std::initializer_list<TaskId> deps = {});
+
+  void Start();
+  void Wait(TaskId id);
+  void WaitAll();
+
+  // Times `f` on the calling thread as a stage of its own.
+  template <class F>
+  decltype(auto) RunInline(std::string name, F&& f)
+  {
+    const auto start = Clock::now();
+    struct Record
+    {
+      TaskGraph* graph;
+      std::string name;
+      Clock::time_point start;
+      ~Record() { graph->RecordTiming(std::move(name), start, Clock::now(), 0); }
+    } record{ this, std::move(name), start };
+    return std::forward<F>(f)();
+  }
+
+  // Finished tasks and inline steps, ordered by start time.
+  std::vector<TaskTiming> Timings() const;
+  unsigned WorkerCount() const noexcept { return static_cast<unsigned>(m_threads.size()); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Task
+  {
+    std::string name;
+    std::function<void()> fn;
+    std::vector<TaskId> dependents;
+    std::size_t pendingDeps = 0;
+    bool done = false;
+    std::exception_ptr error;
+  };
+
+  struct WorkQueue
+  {
+    std::mutex mutex;
+    std::deque<TaskId> tasks;
+  };
+
+  bool TryTake(std::size_t home, TaskId* out);
+  void Push(std::size_t queue, TaskId id);
+  void Execute(TaskId id, int worker, std::size_t home);
+  void WorkerMain(std::size_t index);
+  void WaitUntil(const std::function<bool()>& done);
+  void RecordTiming(std::string name, Clock::time_point start, Clock::time_point end, int worker);
+
+  const Clock::time_point m_origin = Clock::now();
+  const unsigned m_workerCount;
+  std::vector<Task> m_tasks;
+  std::vector<std::unique_ptr<WorkQueue>> m_queues;  // one per worker (at least one)
+  std::vector<std::thread> m_threads;
+
+  mutable std::mutex m_mutex;  // guards Task state, m_epoch, m_stopping, m_timings
+  std::condition_variable m_cv;
+  std::uint64_t m_epoch = 0;   // bumped on every push and completion
+  bool m_started = false;
+  bool m_stopping = false;
+  std::vector<TaskTiming> m_timings;
+  std::atomic<std::size_t> m_nextQueue{ 0 };
+};
+
+}  // namespace skydiag::dump_tool
@@ -43,6 +43,28 @@ struct WctFreezeSummary
   std::string dump_transport;
 };
 
+// Thread -> lock -> owner graph rebuilt from every WCT chain in the primary
+// pass. Cycles come from a Tarjan SCC pass rather than the per-chain isCycle
+// flag, so cycles split across truncated chains are still found.
+struct WctWaitGraphCycle
+{
+  std::vector<std::uint32_t> thread_ids;  // sorted ascending
+  std::vector<std::string> lock_names;    // named lock objects inside the cycle (best-effort)
+};
+
+struct WctWaitGraphSummary
+{
+  bool has = false;
+  std::uint32_t thread_nodes = 0;
+  std::uint32_t lock_nodes = 0;
+  std::uint32_t edges = 0;
+  std::vector<WctWaitGraphCycle> cycles;
+  // Longest blocking chain in thread count, waiter first. A cycle on the chain
+  // contributes all of its threads once.
+  std::vector<std::uint32_t> longest_chain_tids;
+  bool longest_chain_has_cycle = false;
+};
+
 std::vector<std::uint32_t> ExtractWctCandidateThreadIds(std::string_view wctJsonUtf8, std::size_t maxN);
 
 std::uint32_t CountWctThreadsWithStableContextSwitches(
@@ -51,5 +73,6 @@ std::uint32_t CountWctThreadsWithStableContextSwitches(
 
 std::optional<WctCaptureDecision> TryParseWctCaptureDecision(std::string_view wctJsonUtf8);
 std::optional<WctFreezeSummary> TryParseWctFreezeSummary(std::string_view wctJsonUtf8);
+std::optional<WctWaitGraphSummary> TryBuildWctWaitGraph(std::string_view wctJsonUtf8);
 
 }  // namespace skydiag::dump_tool::internal
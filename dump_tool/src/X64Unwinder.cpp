@@ -0,0 +1,922 @@
+#include "X64Unwinder.h"
+
+#include "ModuleCache.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace skydiag::dump_tool::minidump {
+namespace {
+
+constexpr unsigned kMaxDefaultWorkers = 8;
+// Below this many threads the walks finish faster than the workers start.
+constexpr std::size_t kMinThreadsForWorkers = 8;
+
+constexpr std::uint16_t kMachineAmd64 = 0x8664;
+constexpr std::uint16_t kPe32PlusMagic = 0x20B;
+constexpr std::uint32_t kExceptionDirectory = 3;
+constexpr std::size_t kHeaderBytes = 0x1000;
+
+// UNWIND_INFO flags and UNWIND_CODE operations (x64 exception handling ABI).
+constexpr std::uint8_t kUnwFlagChainInfo = 0x4;
+enum UnwindOp : std::uint8_t
+{
+  kPushNonvol = 0,
+  kAllocLarge = 1,
+  kAllocSmall = 2,
+  kSetFpreg = 3,
+  kSaveNonvol = 4,
+  kSaveNonvolFar = 5,
+  kEpilog = 6,     // version 2; was SAVE_XMM
+  kSpareCode = 7,  // was SAVE_XMM_FAR
+  kSaveXmm128 = 8,
+  kSaveXmm128Far = 9,
+  kPushMachframe = 10,
+};
+
+// Chained UNWIND_INFO is legal but never deep; this only stops a cycle.
+constexpr int kMaxChainDepth = 32;
+// Epilog scans follow jmp; bound them against a jump loop.
+constexpr int kMaxEpilogSteps = 64;
+// Gap between UNWIND_INFO records still merged into one cached range.
+constexpr std::uint32_t kCacheRangeGap = 64;
+
+// Integer registers in UNWIND_CODE numbering (RAX, RCX, RDX, RBX, RSP, RBP,
+// RSI, RDI, R8-R15), which is also their order in CONTEXT.
+constexpr std::array<std::uint64_t ContextX64::*, 16> kGpr = {
+  &ContextX64::Rax, &ContextX64::Rcx, &ContextX64::Rdx, &ContextX64::Rbx,
+  &ContextX64::Rsp, &ContextX64::Rbp, &ContextX64::Rsi, &ContextX64::Rdi,
+  &ContextX64::R8,  &ContextX64::R9,  &ContextX64::R10, &ContextX64::R11,
+  &ContextX64::R12, &ContextX64::R13, &ContextX64::R14, &ContextX64::R15,
+};
+
+std::uint64_t& Gpr(ContextX64* ctx, std::size_t reg)
+{
+  return ctx->*kGpr[reg & 15u];
+}
+
+std::uint16_t Le16(const std::uint8_t* p)
+{
+  return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+std::uint32_t Le32(const std::uint8_t* p)
+{
+  return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+    (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+struct RuntimeFunction
+{
+  std::uint32_t begin = 0;
+  std::uint32_t end = 0;
+  std::uint32_t unwindInfo = 0;
+};
+
+struct PeSection
+{
+  std::uint32_t virtualAddress = 0;
+  std::uint32_t virtualSize = 0;
+  std::uint32_t rawOffset = 0;
+  std::uint32_t rawSize = 0;
+};
+
+struct PeHeaders
+{
+  std::uint32_t timeDateStamp = 0;
+  std::uint32_t sizeOfImage = 0;
+  std::uint32_t sizeOfHeaders = 0;
+  std::uint32_t exceptionRva = 0;
+  std::uint32_t exceptionSize = 0;
+  std::vector<PeSection> sections;
+};
+
+// Headers are laid out the same in the file and in the loaded image, so one
+// parser serves both. `bytes` may be short; anything past it is rejected.
+bool ParsePeHeaders(const std::uint8_t* bytes, std::size_t size, PeHeaders* out)
+{
+  if (size < 0x40 || Le16(bytes) != 0x5A4D) {
+    return false;
+  }
+  const std::size_t nt = Le32(bytes + 0x3C);
+  if (nt > size || size - nt < 24 || Le32(bytes + nt) != 0x00004550u) {
+    return false;
+  }
+  const std::uint8_t* fileHeader = bytes + nt + 4;
+  if (Le16(fileHeader) != kMachineAmd64) {
+    return false;
+  }
+  const std::size_t sectionCount = Le16(fileHeader + 2);
+  out->timeDateStamp = Le32(fileHeader + 4);
+  const std::size_t optSize = Le16(fileHeader + 16);
+
+  const std::size_t opt = nt + 24;
+  if (optSize < 112 || opt + optSize > size || Le16(bytes + opt) != kPe32PlusMagic) {
+    return false;
+  }
+  out->sizeOfImage = Le32(bytes + opt + 56);
+  out->sizeOfHeaders = Le32(bytes + opt + 60);
+  const std::uint32_t dirCount = Le32(bytes + opt + 108);
+  const std::size_t dir = opt + 112 + kExceptionDirectory * 8;
+  if (dirCount > kExceptionDirectory && dir + 8 <= opt + optSize) {
+    out->exceptionRva = Le32(bytes + dir);
+    out->exceptionSize = Le32(bytes + dir + 4);
+  }
+
+  const std::size_t sectionTable = opt + optSize;
+  out->sections.clear();
+  for (std::size_t i = 0; i < sectionCount && sectionTable + (i + 1) * 40 <= size; ++i) {
+    const std::uint8_t* s = bytes + sectionTable + i * 40;
+    out->sections.push_back({ Le32(s + 12), Le32(s + 8), Le32(s + 20), Le32(s + 16) });
+  }
+  return true;
+}
+
+std::filesystem::path PathFromUtf8(std::string_view utf8)
+{
+  return std::filesystem::path(std::u8string(reinterpret_cast<const char8_t*>(utf8.data()), utf8.size()));
+}
+
+// File name of a module path recorded on Windows, whatever the host.
+std::string_view RecordedFileName(std::string_view path)
+{
+  const auto slash = path.find_last_of("\\/");
+  return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+}  // namespace
+
+// One module and, once the first frame lands in it, its unwind tables.
+struct X64Unwinder::Module
+{
+  enum class Source
+  {
+    kNone,
+    kDump,
+    kFile,
+    kCache,
+  };
+
+  MinidumpModuleRecord record;
+  std::once_flag loadOnce;
+  // Written only inside loadOnce; read-only afterwards.
+  Source source = Source::kNone;
+  MappedDumpFile file;
+  ModuleCacheFile cache;
+  std::vector<PeSection> sections;
+  std::uint32_t sizeOfHeaders = 0;
+  std::vector<RuntimeFunction> functions;  // sorted by begin
+  std::atomic<bool> loaded{ false };
+
+  // Copies image bytes at `rva`; the rest of `dst` is zeroed. Returns the
+  // number of bytes that came from the image.
+  std::size_t ReadImage(const TargetMemory& memory, std::uint32_t rva, void* dst, std::size_t n) const
+  {
+    std::memset(dst, 0, n);
+    if (source == Source::kDump) {
+      return memory.Read(record.base + rva, dst, n);
+    }
+    if (source == Source::kCache) {
+      return cache.ReadImage(rva, dst, n);
+    }
+    if (source != Source::kFile) {
+      return 0;
+    }
+    const auto* bytes = static_cast<const std::uint8_t*>(file.Data());
+    const auto fileSize = file.Size();
+    std::uint64_t offset = 0;
+    std::uint64_t avail = 0;
+    bool found = false;
+    for (const auto& s : sections) {
+      const std::uint32_t span = std::max(s.virtualSize, s.rawSize);
+      if (rva >= s.virtualAddress && rva - s.virtualAddress < span) {
+        const std::uint32_t into = rva - s.virtualAddress;
+        if (into >= s.rawSize) {
+          return 0;  // uninitialized tail of the section
+        }
+        offset = std::uint64_t{ s.rawOffset } + into;
+        avail = s.rawSize - into;
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      // Outside every section: only the headers map 1:1.
+      offset = rva;
+      avail = sizeOfHeaders;
+      if (offset >= avail) {
+        return 0;
+      }
+      avail -= offset;
+    }
+    if (offset >= fileSize) {
+      return 0;
+    }
+    const std::size_t copyN = static_cast<std::size_t>(std::min<std::uint64_t>({ avail, fileSize - offset, n }));
+    std::memcpy(dst, bytes + offset, copyN);
+    return copyN;
+  }
+
+  bool LoadFromDump(const TargetMemory& memory)
+  {
+    std::vector<std::uint8_t> header(kHeaderBytes);
+    const auto got = memory.Read(record.base, header.data(), header.size());
+    PeHeaders pe;
+    if (!ParsePeHeaders(header.data(), got, &pe) || pe.exceptionSize < 12) {
+      return false;
+    }
+    source = Source::kDump;
+    if (!LoadFunctions(memory, pe)) {
+      source = Source::kNone;
+      return false;
+    }
+    return true;
+  }
+
+  bool LoadFromFile(const TargetMemory& memory, const std::filesystem::path& path)
+  {
+    std::error_code ec;
+    if (path.empty() || !std::filesystem::is_regular_file(path, ec)) {
+      return false;
+    }
+    if (!file.Open(path, nullptr)) {
+      return false;
+    }
+    PeHeaders pe;
+    const auto* bytes = static_cast<const std::uint8_t*>(file.Data());
+    const auto size = static_cast<std::size_t>(std::min<std::uint64_t>(file.Size(), kHeaderBytes));
+    // A different build of the same DLL has different tables.
+    if (!ParsePeHeaders(bytes, size, &pe) || pe.exceptionSize < 12 ||
+        (record.timeDateStamp != 0 && pe.timeDateStamp != record.timeDateStamp) ||
+        (record.size != 0 && pe.sizeOfImage != record.size)) {
+      file.Close();
+      return false;
+    }
+    source = Source::kFile;
+    sections = std::move(pe.sections);
+    sizeOfHeaders = pe.sizeOfHeaders;
+    if (!LoadFunctions(memory, pe)) {
+      source = Source::kNone;
+      sections.clear();
+      file.Close();
+      return false;
+    }
+    return true;
+  }
+
+  bool LoadFunctions(const TargetMemory& memory, const PeHeaders& pe)
+  {
+    const std::size_t count = pe.exceptionSize / 12;
+    std::vector<std::uint8_t> raw(count * 12);
+    if (ReadImage(memory, pe.exceptionRva, raw.data(), raw.size()) != raw.size()) {
+      return false;
+    }
+    functions.clear();
+    functions.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      const std::uint8_t* p = raw.data() + i * 12;
+      RuntimeFunction f{ Le32(p), Le32(p + 4), Le32(p + 8) };
+      if (f.begin < f.end) {
+        functions.push_back(f);
+      }
+    }
+    std::sort(functions.begin(), functions.end(), [](const RuntimeFunction& a, const RuntimeFunction& b) {
+      return a.begin < b.begin;
+    });
+    return !functions.empty();
+  }
+
+  bool LoadFromCache(const std::filesystem::path& cacheDir)
+  {
+    if (!cache.Open(cacheDir, ModuleCacheKeyFor(record), ModuleCacheKind::kUnwind)) {
+      return false;
+    }
+    functions.clear();
+    functions.reserve(cache.FunctionCount());
+    for (std::size_t i = 0; i < cache.FunctionCount(); ++i) {
+      const auto f = cache.Function(i);
+      functions.push_back({ f.begin, f.end, f.unwind_info });
+    }
+    if (functions.empty()) {
+      return false;
+    }
+    source = Source::kCache;
+    return true;
+  }
+
+  // Keeps every UNWIND_INFO the tables reference (with chained and indirect
+  // entries) as merged image ranges.
+  void StoreInCache(const TargetMemory& memory, const std::filesystem::path& cacheDir) const
+  {
+    const auto key = ModuleCacheKeyFor(record);
+    std::error_code ec;
+    if (!key.Valid() || std::filesystem::exists(ModuleCachePath(cacheDir, key, ModuleCacheKind::kUnwind), ec)) {
+      return;
+    }
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> spans;  // rva, size
+    std::vector<CachedRuntimeFunction> cached;
+    cached.reserve(functions.size());
+    for (const auto& f : functions) {
+      cached.push_back({ f.begin, f.end, f.unwindInfo });
+      std::uint32_t info = f.unwindInfo;
+      for (int depth = 0; depth < kMaxChainDepth; ++depth) {
+        std::uint8_t hdr[12];
+        if (info & 1u) {
+          info &= ~1u;
+          spans.push_back({ info, 12u });
+          if (ReadImage(memory, info, hdr, 12) != 12) {
+            break;
+          }
+          info = Le32(hdr + 8);
+          continue;
+        }
+        if (ReadImage(memory, info, hdr, 4) != 4) {
+          break;
+        }
+        const std::uint32_t codeBytes = ((hdr[2] + 1u) & ~1u) * 2u;
+        const bool chained = ((hdr[0] >> 3) & kUnwFlagChainInfo) != 0;
+        spans.push_back({ info, 4u + codeBytes + (chained ? 12u : 0u) });
+        if (!chained || ReadImage(memory, info + 4u + codeBytes, hdr, 12) != 12) {
+          break;
+        }
+        info = Le32(hdr + 8);
+      }
+    }
+
+    std::sort(spans.begin(), spans.end());
+    std::vector<CachedImageRange> ranges;
+    std::uint32_t start = 0;
+    std::uint32_t end = 0;
+    const auto flush = [&]() {
+      if (end > start) {
+        CachedImageRange r;
+        r.rva = start;
+        r.bytes.resize(end - start);
+        r.bytes.resize(ReadImage(memory, start, r.bytes.data(), r.bytes.size()));
+        ranges.push_back(std::move(r));
+      }
+    };
+    for (const auto& [rva, size] : spans) {
+      // Records sit back to back in .xdata; small gaps are cheaper to keep
+      // than to index.
+      if (end > start && rva <= end + kCacheRangeGap) {
+        end = std::max(end, rva + size);
+        continue;
+      }
+      flush();
+      start = rva;
+      end = rva + size;
+    }
+    flush();
+    StoreModuleUnwindCache(cacheDir, key, std::move(cached), std::move(ranges));
+  }
+
+  void Load(const TargetMemory& memory, const X64UnwinderOptions& options)
+  {
+    std::call_once(loadOnce, [&]() {
+      bool ok = LoadFromDump(memory);
+      if (!ok && !options.module_cache_dir.empty()) {
+        ok = LoadFromCache(options.module_cache_dir);
+      }
+      if (!ok && options.use_module_files) {
+        ok = LoadFromFile(memory, PathFromUtf8(record.path));
+        const auto name = PathFromUtf8(RecordedFileName(record.path));
+        for (std::size_t i = 0; !ok && !name.empty() && i < options.image_search_dirs.size(); ++i) {
+          ok = LoadFromFile(memory, options.image_search_dirs[i] / name);
+        }
+      }
+      if (ok && source != Source::kCache && !options.module_cache_dir.empty()) {
+        StoreInCache(memory, options.module_cache_dir);
+      }
+      loaded.store(true, std::memory_order_release);
+    });
+  }
+
+  // Index into `functions` of the entry covering `rva`, or -1.
+  std::ptrdiff_t FindFunction(std::uint32_t rva) const
+  {
+    const auto it = std::upper_bound(functions.begin(), functions.end(), rva, [](std::uint32_t v, const RuntimeFunction& f) {
+      return v < f.begin;
+    });
+    if (it == functions.begin() || rva >= (it - 1)->end) {
+      return -1;
+    }
+    return (it - functions.begin()) - 1;
+  }
+};
+
+namespace {
+
+bool ReadU64(const TargetMemory& memory, std::uint64_t addr, std::uint64_t* out)
+{
+  std::uint8_t b[8];
+  if (memory.Read(addr, b, sizeof(b)) != sizeof(b)) {
+    return false;
+  }
+  std::memcpy(out, b, sizeof(b));
+  return true;
+}
+
+std::size_t UnwindCodeSlots(std::uint8_t op, std::uint8_t info)
+{
+  switch (op) {
+    case kAllocLarge: return info == 0 ? 2u : 3u;
+    case kSaveNonvol:
+    case kSaveXmm128:
+    case kEpilog: return 2u;
+    case kSaveNonvolFar:
+    case kSaveXmm128Far:
+    case kSpareCode: return 3u;
+    default: return 1u;
+  }
+}
+
+}  // namespace
+
+X64Unwinder::X64Unwinder(
+  const std::vector<MinidumpModuleRecord>& modules,
+  const TargetMemory& memory,
+  X64UnwinderOptions options)
+  : m_memory(memory), m_options(std::move(options))
+{
+  m_modules.reserve(modules.size());
+  for (const auto& record : modules) {
+    if (record.size == 0) {
+      continue;
+    }
+    auto m = std::make_unique<Module>();
+    m->record = record;
+    m_modules.push_back(std::move(m));
+  }
+  std::sort(m_modules.begin(), m_modules.end(), [](const auto& a, const auto& b) {
+    return a->record.base < b->record.base;
+  });
+}
+
+X64Unwinder::~X64Unwinder() = default;
+
+X64Unwinder::Module* X64Unwinder::FindModule(std::uint64_t addr) const
+{
+  const auto it = std::upper_bound(m_modules.begin(), m_modules.end(), addr, [](std::uint64_t v, const auto& m) {
+    return v < m->record.base;
+  });
+  if (it == m_modules.begin()) {
+    return nullptr;
+  }
+  const auto& m = *(it - 1);
+  return addr - m->record.base < m->record.size ? m.get() : nullptr;
+}
+
+namespace {
+
+// Target of the jmp rel32 (E9) or rel8 (EB) at c[i], which sits at `pc`
+// after i prefix bytes.
+std::uint32_t JumpTarget(const std::uint8_t* c, std::size_t i, std::uint32_t pc)
+{
+  if (c[i] == 0xEB) {
+    return pc + static_cast<std::uint32_t>(i) + 2u + static_cast<std::uint32_t>(static_cast<std::int8_t>(c[i + 1]));
+  }
+  std::int32_t rel = 0;
+  std::memcpy(&rel, c + i + 1, 4);
+  return pc + static_cast<std::uint32_t>(i) + 5u + static_cast<std::uint32_t>(rel);
+}
+
+bool PopReturnAddress(const TargetMemory& memory, ContextX64* ctx, std::uint32_t extraBytes)
+{
+  std::uint64_t ret = 0;
+  if (!ReadU64(memory, ctx->Rsp, &ret)) {
+    return false;
+  }
+  ctx->Rip = ret;
+  ctx->Rsp += 8u + extraBytes;
+  return true;
+}
+
+// The epilog test and emulation of RtlVirtualUnwind: an epilog is an
+// optional `add rsp, imm` or `lea rsp, [reg+disp]`, then pops of
+// nonvolatile registers, then `ret` or a tail-call jmp out of the function. Unwind
+// codes describe the prolog only, so a frame stopped inside an epilog is
+// unwound by running the rest of the epilog forward instead.
+template <class ReadCode>
+bool IsInsideEpilog(ReadCode&& readCode, std::uint32_t rva, std::uint32_t fnBegin, std::uint32_t fnEnd)
+{
+  std::uint8_t c[16];
+  if (readCode(rva, c) < 2) {
+    return false;
+  }
+  std::uint32_t pc = rva;
+  if ((c[0] & 0xF8) == 0x48) {
+    if (c[1] == 0x81 && c[0] == 0x48 && c[2] == 0xC4) {
+      pc += 7;  // add rsp, imm32
+    } else if (c[1] == 0x83 && c[0] == 0x48 && c[2] == 0xC4) {
+      pc += 4;  // add rsp, imm8
+    } else if (c[1] == 0x8D) {
+      // lea rsp, [reg+disp]: REX.R/X clear, destination rsp, no SIB.
+      if ((c[0] & 0x06) != 0 || ((c[2] >> 3) & 7) != 4 || (c[2] & 7) == 4) {
+        return false;
+      }
+      if ((c[2] >> 6) == 1) {
+        pc += 4;
+      } else if ((c[2] >> 6) == 2) {
+        pc += 7;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  for (int step = 0; step < kMaxEpilogSteps; ++step) {
+    if (readCode(pc, c) == 0) {
+      return false;
+    }
+    std::size_t i = 0;
+    if ((c[i] & 0xF0) == 0x40) {
+      ++i;  // REX
+    }
+    const std::uint8_t op = c[i];
+    if (op >= 0x58 && op <= 0x5F) {
+      pc += static_cast<std::uint32_t>(i + 1);  // pop reg
+      continue;
+    }
+    switch (op) {
+      case 0xC2:  // ret imm16
+      case 0xC3:  // ret
+        return true;
+      case 0xF3:  // rep ret
+        return c[i + 1] == 0xC3;
+      case 0xE9:  // jmp rel32 / rel8: followed inside the function, a tail call out of it
+      case 0xEB: {
+        const std::uint32_t target = JumpTarget(c, i, pc);
+        if (target >= fnBegin && target < fnEnd) {
+          pc = target;
+          continue;
+        }
+        return true;
+      }
+      case 0xFF:  // jmp [rip+disp32]: tail call through the import table
+        return c[i + 1] == 0x25;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+template <class ReadCode>
+bool InterpretEpilog(
+  ReadCode&& readCode,
+  const TargetMemory& memory,
+  std::uint32_t rva,
+  std::uint32_t fnBegin,
+  std::uint32_t fnEnd,
+  ContextX64* ctx)
+{
+  std::uint8_t c[16];
+  std::uint32_t pc = rva;
+  for (int step = 0; step < kMaxEpilogSteps; ++step) {
+    if (readCode(pc, c) == 0) {
+      return false;
+    }
+    std::size_t i = 0;
+    std::uint8_t rex = 0;
+    if ((c[i] & 0xF0) == 0x40) {
+      rex = c[i++] & 0x0F;
+    }
+    const std::uint8_t op = c[i];
+    if (op >= 0x58 && op <= 0x5F) {
+      std::uint64_t v = 0;
+      if (!ReadU64(memory, ctx->Rsp, &v)) {
+        return false;
+      }
+      Gpr(ctx, (op - 0x58u) + (rex & 1u) * 8u) = v;
+      ctx->Rsp += 8;
+      pc += static_cast<std::uint32_t>(i + 1);
+      continue;
+    }
+    switch (op) {
+      case 0x81: {  // add rsp, imm32
+        std::int32_t imm = 0;
+        std::memcpy(&imm, c + i + 2, 4);
+        ctx->Rsp += static_cast<std::uint64_t>(static_cast<std::int64_t>(imm));
+        pc += static_cast<std::uint32_t>(i + 6);
+        continue;
+      }
+      case 0x83:  // add rsp, imm8
+        ctx->Rsp += static_cast<std::uint64_t>(static_cast<std::int64_t>(static_cast<std::int8_t>(c[i + 2])));
+        pc += static_cast<std::uint32_t>(i + 3);
+        continue;
+      case 0x8D: {  // lea rsp, [reg+disp8/disp32]
+        const std::uint64_t base = Gpr(ctx, (c[i + 1] & 7u) + (rex & 1u) * 8u);
+        if ((c[i + 1] >> 6) == 1) {
+          ctx->Rsp = base + static_cast<std::uint64_t>(static_cast<std::int64_t>(static_cast<std::int8_t>(c[i + 2])));
+          pc += static_cast<std::uint32_t>(i + 3);
+        } else {
+          std::int32_t disp = 0;
+          std::memcpy(&disp, c + i + 2, 4);
+          ctx->Rsp = base + static_cast<std::uint64_t>(static_cast<std::int64_t>(disp));
+          pc += static_cast<std::uint32_t>(i + 6);
+        }
+        continue;
+      }
+      case 0xC2:  // ret imm16
+      case 0xC3:  // ret
+      case 0xF3:  // rep ret
+        return PopReturnAddress(memory, ctx, op == 0xC2 ? Le16(c + i + 1) : 0u);
+      case 0xE9:
+      case 0xEB: {
+        const std::uint32_t target = JumpTarget(c, i, pc);
+        if (target >= fnBegin && target < fnEnd) {
+          pc = target;
+          continue;
+        }
+        return PopReturnAddress(memory, ctx, 0);  // tail call
+      }
+      case 0xFF:
+        return c[i + 1] == 0x25 && PopReturnAddress(memory, ctx, 0);
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool X64Unwinder::VirtualUnwind(const Module& m, std::uint32_t functionIndex, ContextX64* ctx, bool topFrame) const
+{
+  // The module cache keeps unwind data only; for code the dump itself is
+  // the last source, and it usually holds the bytes around each thread's
+  // instruction pointer.
+  const auto readCode = [&](std::uint32_t rva, std::uint8_t (&buf)[16]) {
+    if (m.source == Module::Source::kCache) {
+      std::memset(buf, 0, sizeof(buf));
+      return m_memory.Read(m.record.base + rva, buf, sizeof(buf));
+    }
+    return m.ReadImage(m_memory, rva, buf, sizeof(buf));
+  };
+
+  const std::uint32_t rva = static_cast<std::uint32_t>(ctx->Rip - m.record.base);
+  RuntimeFunction fn = m.functions[functionIndex];
+  std::uint64_t frame = ctx->Rsp;
+  bool machFrame = false;
+  bool primary = true;
+
+  for (int depth = 0; depth < kMaxChainDepth; ++depth) {
+    // Bit 0 marks an entry that points at another RUNTIME_FUNCTION.
+    if (fn.unwindInfo & 1u) {
+      std::uint8_t ind[12];
+      if (m.ReadImage(m_memory, fn.unwindInfo & ~1u, ind, sizeof(ind)) != sizeof(ind)) {
+        return false;
+      }
+      fn = { Le32(ind), Le32(ind + 4), Le32(ind + 8) };
+      continue;
+    }
+
+    // UNWIND_INFO header, up to 255 codes (padded to even), chained entry.
+    std::uint8_t info[4 + 256 * 2 + 12];
+    if (m.ReadImage(m_memory, fn.unwindInfo, info, 4) != 4) {
+      return false;
+    }
+    const std::uint8_t version = info[0] & 7u;
+    const std::uint8_t flags = info[0] >> 3;
+    const std::uint8_t prologSize = info[1];
+    const std::size_t codeCount = info[2];
+    const std::uint8_t frameReg = info[3] & 0x0Fu;
+    const std::uint8_t frameOffset = info[3] >> 4;
+    if (version != 1 && version != 2) {
+      return false;
+    }
+    const std::size_t codeBytes = ((codeCount + 1u) & ~std::size_t{ 1 }) * 2u;
+    const std::size_t tail = (flags & kUnwFlagChainInfo) ? 12u : 0u;
+    if (m.ReadImage(m_memory, fn.unwindInfo + 4u, info + 4, codeBytes + tail) != codeBytes + tail) {
+      return false;
+    }
+    const std::uint8_t* codes = info + 4;
+
+    // Only the primary entry can be mid-prolog or mid-epilog; chained
+    // entries describe prologs that have fully run.
+    std::uint32_t prologOffset = ~0u;
+    if (primary && rva >= fn.begin) {
+      std::uint8_t probe[16];
+      if (rva - fn.begin < prologSize) {
+        prologOffset = rva - fn.begin;
+      } else if (topFrame && readCode(rva, probe) < 2) {
+        // Only a top frame can have stopped mid-epilog; without its code
+        // there is no telling, so leave the frame to the caller's fallback.
+        return false;
+      } else if (IsInsideEpilog(readCode, rva, fn.begin, fn.end)) {
+        return InterpretEpilog(readCode, m_memory, rva, fn.begin, fn.end, ctx);
+      }
+    }
+
+    if (frameReg != 0) {
+      bool established = prologOffset == ~0u;
+      for (std::size_t i = 0; !established && i < codeCount; i += UnwindCodeSlots(codes[i * 2 + 1] & 0x0Fu, codes[i * 2 + 1] >> 4)) {
+        established = (codes[i * 2 + 1] & 0x0Fu) == kSetFpreg && codes[i * 2] <= prologOffset;
+      }
+      if (established) {
+        frame = Gpr(ctx, frameReg) - std::uint64_t{ frameOffset } * 16u;
+      }
+    }
+
+    for (std::size_t i = 0; i < codeCount;) {
+      const std::uint8_t codeOffset = codes[i * 2];
+      const std::uint8_t op = codes[i * 2 + 1] & 0x0Fu;
+      const std::uint8_t opInfo = codes[i * 2 + 1] >> 4;
+      const std::size_t slots = UnwindCodeSlots(op, opInfo);
+      if (i + slots > codeCount) {
+        return false;
+      }
+      const std::uint8_t* next = codes + (i + 1) * 2;
+      i += slots;
+      if (prologOffset != ~0u && codeOffset > prologOffset) {
+        continue;  // not executed yet
+      }
+      std::uint64_t v = 0;
+      switch (op) {
+        case kPushNonvol:
+          if (!ReadU64(m_memory, ctx->Rsp, &v)) {
+            return false;
+          }
+          Gpr(ctx, opInfo) = v;
+          ctx->Rsp += 8;
+          break;
+        case kAllocLarge:
+          ctx->Rsp += opInfo == 0 ? std::uint64_t{ Le16(next) } * 8u : std::uint64_t{ Le32(next) };
+          break;
+        case kAllocSmall:
+          ctx->Rsp += std::uint64_t{ opInfo } * 8u + 8u;
+          break;
+        case kSetFpreg:
+          ctx->Rsp = frame;
+          break;
+        case kSaveNonvol:
+        case kSaveNonvolFar:
+          if (!ReadU64(m_memory, frame + (op == kSaveNonvol ? std::uint64_t{ Le16(next) } * 8u : Le32(next)), &v)) {
+            return false;
+          }
+          Gpr(ctx, opInfo) = v;
+          break;
+        case kPushMachframe: {
+          // Interrupt/exception frame: optional error code, then RIP, CS,
+          // EFLAGS, old RSP, SS.
+          const std::uint64_t base = ctx->Rsp + (opInfo ? 8u : 0u);
+          std::uint64_t rip = 0;
+          std::uint64_t rsp = 0;
+          if (!ReadU64(m_memory, base, &rip) || !ReadU64(m_memory, base + 24, &rsp)) {
+            return false;
+          }
+          ctx->Rip = rip;
+          ctx->Rsp = rsp;
+          machFrame = true;
+          break;
+        }
+        default:
+          break;  // XMM saves and version-2 epilog markers move nothing we track
+      }
+    }
+
+    if (!(flags & kUnwFlagChainInfo)) {
+      break;
+    }
+    primary = false;
+    const std::uint8_t* chained = codes + codeBytes;
+    fn = { Le32(chained), Le32(chained + 4), Le32(chained + 8) };
+  }
+
+  if (!machFrame) {
+    std::uint64_t ret = 0;
+    if (!ReadU64(m_memory, ctx->Rsp, &ret)) {
+      return false;
+    }
+    ctx->Rip = ret;
+    ctx->Rsp += 8;
+  }
+  return true;
+}
+
+UnwindStep X64Unwinder::Step(ContextX64* ctx, bool topFrame) const
+{
+  const auto leaf = [&]() {
+    std::uint64_t ret = 0;
+    if (!ReadU64(m_memory, ctx->Rsp, &ret)) {
+      return UnwindStep::kMissingData;
+    }
+    ctx->Rip = ret;
+    ctx->Rsp += 8;
+    return UnwindStep::kUnwound;
+  };
+
+  auto* m = FindModule(ctx->Rip);
+  if (!m) {
+    return topFrame ? leaf() : UnwindStep::kEndOfStack;
+  }
+  m->Load(m_memory, m_options);
+  if (m->source == Module::Source::kNone) {
+    return UnwindStep::kMissingData;  // even a leaf guess would be blind here
+  }
+  const auto index = m->FindFunction(static_cast<std::uint32_t>(ctx->Rip - m->record.base));
+  if (index < 0) {
+    return leaf();  // no entry: a leaf function by the ABI's definition
+  }
+  return VirtualUnwind(*m, static_cast<std::uint32_t>(index), ctx, topFrame) ? UnwindStep::kUnwound : UnwindStep::kMissingData;
+}
+
+std::vector<std::uint64_t> X64Unwinder::Walk(const ContextX64& ctx, std::size_t maxFrames, bool* outTruncated) const
+{
+  if (outTruncated) {
+    *outTruncated = false;
+  }
+  std::vector<std::uint64_t> pcs;
+  if (maxFrames == 0 || ctx.Rip == 0) {
+    return pcs;
+  }
+  ContextX64 cur = ctx;
+  pcs.push_back(cur.Rip);
+  while (pcs.size() < maxFrames) {
+    const std::uint64_t prevRsp = cur.Rsp;
+    const auto step = Step(&cur, pcs.size() == 1);
+    if (step != UnwindStep::kUnwound) {
+      if (outTruncated) {
+        *outTruncated = step == UnwindStep::kMissingData;
+      }
+      break;
+    }
+    if (cur.Rip == 0) {
+      break;
+    }
+    if (cur.Rsp <= prevRsp) {
+      if (outTruncated) {
+        *outTruncated = true;
+      }
+      break;
+    }
+    pcs.push_back(cur.Rip);
+  }
+  return pcs;
+}
+
+X64UnwinderStats X64Unwinder::Stats() const
+{
+  X64UnwinderStats stats;
+  for (const auto& m : m_modules) {
+    if (!m->loaded.load(std::memory_order_acquire)) {
+      continue;
+    }
+    switch (m->source) {
+      case Module::Source::kDump: ++stats.modules_from_dump; break;
+      case Module::Source::kFile: ++stats.modules_from_files; break;
+      case Module::Source::kCache: ++stats.modules_from_cache; break;
+      default: ++stats.modules_without_tables; break;
+    }
+  }
+  return stats;
+}
+
+std::vector<ThreadCallstack> UnwindThreads(
+  const X64Unwinder& unwinder,
+  const std::vector<ThreadUnwindInput>& threads,
+  std::size_t maxFrames,
+  unsigned maxWorkers)
+{
+  std::vector<ThreadCallstack> out(threads.size());
+  if (threads.empty()) {
+    return out;
+  }
+  if (maxWorkers == 0) {
+    maxWorkers = std::clamp(std::thread::hardware_concurrency(), 1u, kMaxDefaultWorkers);
+  }
+  const unsigned workers = threads.size() < kMinThreadsForWorkers
+    ? 1u
+    : static_cast<unsigned>(std::min<std::size_t>(maxWorkers, threads.size()));
+
+  std::atomic<std::size_t> next{ 0 };
+  const auto work = [&]() {
+    for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < threads.size();
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      out[i].tid = threads[i].tid;
+      out[i].pcs = unwinder.Walk(threads[i].context, maxFrames, &out[i].truncated);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(workers > 0 ? workers - 1 : 0);
+  for (unsigned w = 1; w < workers; ++w) {
+    pool.emplace_back(work);
+  }
+  work();
+  for (auto& t : pool) {
+    t.join();
+  }
+  return out;
+}
+
+}  // namespace skydiag::dump_tool::minidump
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "MinidumpReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+// Portable Win64 stack unwinder. Walks a thread from its CONTEXT using the
+// RUNTIME_FUNCTION (.pdata) and UNWIND_INFO (.xdata) tables of the modules in
+// the dump, the way RtlVirtualUnwind does in the target, without DbgHelp or
+// any Windows API. Module images are read from the dump's own memory when it
+// has them (full dumps), else from a matching copy of the module on disk.
+
+namespace skydiag::dump_tool::minidump {
+
+// Target memory as the unwinder sees it: stacks, and module images when the
+// dump has them. Read() must be safe to call from several threads at once.
+class TargetMemory
+{
+public:
+  virtual ~TargetMemory() = default;
+  // Same contract as MinidumpMemory::Read: bytes copied, short on a gap.
+  virtual std::size_t Read(std::uint64_t addr, void* dst, std::size_t size) const = 0;
+};
+
+class DumpTargetMemory final : public TargetMemory
+{
+public:
+  explicit DumpTargetMemory(const MinidumpMemory& memory) : m_memory(memory) {}
+  std::size_t Read(std::uint64_t addr, void* dst, std::size_t size) const override
+  {
+    return m_memory.Read(addr, dst, size);
+  }
+
+private:
+  const MinidumpMemory& m_memory;
+};
+
+struct X64UnwinderOptions
+{
+  // For modules whose headers or .pdata are not in the dump: try the path the
+  // module record names, then <dir>/<file name> for each search dir. A copy
+  // is only used when its TimeDateStamp and SizeOfImage match the record.
+  bool use_module_files = true;
+  std::vector<std::filesystem::path> image_search_dirs;
+  // ModuleCache directory. Tables read from the dump or a module file are
+  // stored there, and a module with neither is looked up there before its
+  // files, so a minidump without images still unwinds on a machine that saw
+  // the same build once. Code bytes are not kept, so a cached module's top
+  // frame is not checked for being mid-epilog.
+  std::filesystem::path module_cache_dir;
+};
+
+// Where the unwind tables of the modules touched so far came from.
+struct X64UnwinderStats
+{
+  std::uint32_t modules_from_dump = 0;
+  std::uint32_t modules_from_files = 0;
+  std::uint32_t modules_from_cache = 0;
+  std::uint32_t modules_without_tables = 0;
+};
+
+enum class UnwindStep
+{
+  kUnwound,
+  kEndOfStack,   // caller outside every module
+  kMissingData,  // unwind tables or stack memory not available
+};
+
+class X64Unwinder
+{
+public:
+  // `modules` need not be sorted; `memory` must outlive the unwinder.
+  X64Unwinder(
+    const std::vector<MinidumpModuleRecord>& modules,
+    const TargetMemory& memory,
+    X64UnwinderOptions options = {});
+  ~X64Unwinder();
+  X64Unwinder(const X64Unwinder&) = delete;
+  X64Unwinder& operator=(const X64Unwinder&) = delete;
+
+  // Instruction pointers from `ctx` outward: ctx.Rip, then each return
+  // address, at most maxFrames. Stops at a zero or unreadable return
+  // address, a frame that does not move the stack pointer up, or a caller
+  // outside every module. `outTruncated` is set when the walk stopped for
+  // lack of data rather than at the end of the stack. Safe to call from
+  // several threads at once: module tables are loaded once on first use and
+  // read-only afterwards.
+  std::vector<std::uint64_t> Walk(const ContextX64& ctx, std::size_t maxFrames, bool* outTruncated = nullptr) const;
+
+  // Unwinds one frame in place (Rip, Rsp and the nonvolatile registers).
+  // `topFrame` allows a leaf step outside every module, for a crash that
+  // jumped to a bad address. A top frame past its prolog whose code cannot
+  // be read (tables from the module cache, code not in the dump) is
+  // kMissingData: it may have stopped in an epilog.
+  UnwindStep Step(ContextX64* ctx, bool topFrame) const;
+
+  X64UnwinderStats Stats() const;
+
+private:
+  struct Module;
+  Module* FindModule(std::uint64_t addr) const;
+  bool VirtualUnwind(const Module& m, std::uint32_t functionIndex, ContextX64* ctx, bool topFrame) const;
+
+  const TargetMemory& m_memory;
+  X64UnwinderOptions m_options;
+  std::vector<std::unique_ptr<Module>> m_modules;  // sorted by base
+};
+
+struct ThreadUnwindInput
+{
+  std::uint32_t tid = 0;
+  ContextX64 context{};
+};
+
+struct ThreadCallstack
+{
+  std::uint32_t tid = 0;
+  std::vector<std::uint64_t> pcs;
+  bool truncated = false;
+};
+
+// X64Unwinder::Walk for every thread, split across worker threads when
+// there are enough of them. Results keep the input order. maxWorkers == 0
+// picks min(hardware threads, 8).
+std::vector<ThreadCallstack> UnwindThreads(
+  const X64Unwinder& unwinder,
+  const std::vector<ThreadUnwindInput>& threads,
+  std::size_t maxFrames,
+  unsigned maxWorkers = 0);
+
+}  // namespace skydiag::dump_tool::minidump
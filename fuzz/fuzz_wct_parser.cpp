@@ -2,6 +2,7 @@
 // Build with: clang++ -g -O1 -fsanitize=fuzzer,address \
 //   -I ../dump_tool/src -I ../shared \
 //   fuzz_wct_parser.cpp ../dump_tool/src/AnalyzerInternalsWct.cpp \
+//   ../dump_tool/src/AnalyzerInternalsWctGraph.cpp \
 //   -o fuzz_wct_parser
 //
 // Run: ./fuzz_wct_parser corpus/ -max_len=4096
@@ -20,6 +21,7 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
 
   (void)ExtractWctCandidateThreadIds(input, 8);
   (void)TryParseWctCaptureDecision(input);
+  (void)TryBuildWctWaitGraph(input);
 
   return 0;
 }
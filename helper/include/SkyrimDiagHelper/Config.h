@@ -11,11 +11,25 @@ enum class DumpMode : std::uint32_t {
   kFull = 2,
 };
 
+// NTFS transparent compression for dump files. Readers (the analyzer's mapped
+// view, WinDbg, DbgHelp) keep random access; the OS decompresses only the
+// 64 KB units that are touched. The ratio depends on the volume and on how
+// much of the game's memory is zero or repetitive; each compressed dump's
+// logical and on-disk size is written to the helper log, which is where the
+// ratio is measured. Volumes that cannot compress (FAT/exFAT, ReFS, NTFS with
+// clusters above 4 KB) get uncompressed dumps and a log line saying so.
+enum class DumpCompression : std::uint32_t {
+  kOff = 0,
+  kLargeDumps = 1,  // full-memory and indirect-memory recapture dumps
+  kAll = 2,         // every dump except the latency-critical thin crash dump
+};
+
 struct HelperConfig {
   std::uint32_t hangThresholdInGameSec = 10;
   std::uint32_t hangThresholdInMenuSec = 30;
   std::uint32_t hangThresholdLoadingSec = 600;
   DumpMode dumpMode = DumpMode::kDefault;
+  DumpCompression dumpCompression = DumpCompression::kLargeDumps;
   std::wstring outputDir;  // empty => next to exe
   bool enableManualCaptureHotkey = true;
   bool enableCompatibilityPreflight = true;
@@ -28,10 +42,19 @@ struct HelperConfig {
   // discarded. When a strong fault was already published and no heartbeat recovery was
   // observed, keep a small metadata record so a genuinely missed CTD stays investigable.
   bool enableCleanExitEvidenceQuarantine = true;
+  // Write a thin crash dump first, then a DumpMode-rich sidecar while the game is still alive.
+  bool enableTwoPhaseCrashCapture = true;
+  // Crash-loop backoff: after N rich captures of the same fault within the window,
+  // keep a thin dump plus a counter and skip enrichment, analysis and the viewer.
+  bool enableCrashLoopBackoff = true;
+  std::uint32_t crashLoopRichCaptureLimit = 3;
+  std::uint32_t crashLoopWindowSec = 86400;
   bool autoOpenViewerOnCrash = true;
   bool autoOpenCrashOnlyIfProcessExited = true;
   std::uint32_t autoOpenCrashWaitForExitMs = 2000;
-  bool enableAutoRecaptureOnUnknownCrash = false;
+  bool enableAutoRecaptureOnUnknownCrash = true;
+  // Recapture only what the first crash dump lacks; the analyzer overlays the two.
+  bool enableIncrementalCrashRecapture = true;
   std::uint32_t autoRecaptureUnknownBucketThreshold = 2;
   std::uint32_t autoRecaptureAnalysisTimeoutSec = 20;
   bool autoOpenViewerOnHang = true;
@@ -39,13 +62,19 @@ struct HelperConfig {
   bool autoOpenHangAfterProcessExit = true;
   std::uint32_t autoOpenHangDelayMs = 2000;
   bool autoOpenViewerBeginnerMode = true;
-  bool enablePssSnapshotForFreeze = false;
+  bool enablePssSnapshotForFreeze = true;
   bool enableAdaptiveLoadingThreshold = true;
   std::uint32_t adaptiveLoadingMinSec = 120;
   std::uint32_t adaptiveLoadingMinExtraSec = 120;
   std::uint32_t adaptiveLoadingMaxSec = 1800;
   bool suppressHangWhenNotForeground = true;
   std::uint32_t foregroundGraceSec = 5;
+  bool enableHangSuppressionTrace = false;
+  bool enableHangPrecapture = true;
+  std::uint32_t hangPrecaptureStartPercent = 50;
+  std::uint32_t hangPrecaptureIntervalMs = 1000;
+  std::uint32_t hangPrecaptureMaxSnapshots = 16;
+  std::uint32_t hangPrecaptureMaxThreads = 8;
   bool enableEtwCaptureOnHang = false;
   std::wstring etwWprExe = L"wpr.exe";
   std::wstring etwHangProfile = L"GeneralProfile";
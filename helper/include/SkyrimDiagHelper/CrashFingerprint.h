@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace skydiag::helper {
+
+// Approximate crash bucket computed in the helper at capture time, before any
+// analysis: exception code, module-relative fault address and the first
+// module-resident return-address candidates found by scanning the faulting
+// thread's stack from RSP. It is not the analyzer's CTD2 bucket (which uses a
+// real stackwalk); the dump tool re-derives the fault part and reports whether
+// the two agree.
+
+inline constexpr std::uint32_t kCrashFingerprintVersion = 1;
+inline constexpr std::size_t kCrashFingerprintMaxFrames = 6;
+inline constexpr std::size_t kCrashFingerprintStackScanBytes = 16 * 1024;
+
+struct FingerprintModule
+{
+  std::string nameLower;
+  std::uint64_t base = 0;
+  std::uint64_t size = 0;
+};
+
+// Sorted by base for binary search; overlapping entries are dropped.
+class FingerprintModuleIndex {
+public:
+  explicit FingerprintModuleIndex(std::vector<FingerprintModule> modules);
+
+  const FingerprintModule* Find(std::uint64_t addr) const;
+  bool empty() const { return m_modules.empty(); }
+
+private:
+  std::vector<FingerprintModule> m_modules;
+};
+
+struct CrashFingerprintFrame
+{
+  std::string module;
+  std::uint64_t offset = 0;
+};
+
+struct CrashFingerprint
+{
+  std::string key;  // "HFP1-<16 hex>"; empty when there was nothing to key on
+  std::uint32_t exceptionCode = 0;
+  std::string faultModule;  // empty when the fault address is outside every module
+  std::uint64_t faultOffset = 0;
+  std::vector<CrashFingerprintFrame> frames;
+  std::uint32_t scannedBytes = 0;
+};
+
+CrashFingerprint ComputeCrashFingerprint(
+  std::uint32_t exceptionCode,
+  std::uint64_t faultAddr,
+  const FingerprintModuleIndex& modules,
+  const std::uint8_t* stackBytes,
+  std::size_t stackSize,
+  std::size_t maxFrames = kCrashFingerprintMaxFrames);
+
+// Incident manifest `helper_fingerprint` object.
+nlohmann::json CrashFingerprintToJson(const CrashFingerprint& fingerprint);
+
+}  // namespace skydiag::helper
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace skydiag::helper {
+
+// Crash-loop backoff: a game that dies at the same spot on every launch
+// should not pay for a rich dump, analysis and viewer each time. Once a
+// capture-time fingerprint has been captured richly `richCaptureLimit` times
+// within the window, further hits get a thin dump only, and a rich capture is
+// let through again after 2, 4, 8, ... thin hits.
+
+inline constexpr std::uint32_t kCrashLoopMaxBackoffThinHits = 64;
+// Fingerprints tracked at once; a user who hits many distinct crashes must
+// not grow the stats file without bound.
+inline constexpr std::size_t kCrashLoopMaxTrackedKeys = 256;
+
+struct CrashLoopLimits
+{
+  std::uint32_t richCaptureLimit = 3;
+  std::uint32_t windowSec = 86'400;
+};
+
+// Persisted per fingerprint next to the crash bucket stats.
+struct CrashLoopHistory
+{
+  std::vector<std::uint64_t> richCaptureUnixSec;  // ascending
+  std::uint32_t thinSinceRich = 0;
+  std::uint32_t thinTotal = 0;
+};
+
+struct CrashLoopDecision
+{
+  bool downgrade = false;
+  std::uint32_t richInWindow = 0;
+  std::uint32_t thinSinceRich = 0;
+  // Thin hits required before the next rich capture; 0 while not backing off.
+  std::uint32_t backoffThinHits = 0;
+};
+
+inline std::uint32_t CountRichCapturesInWindow(
+  const CrashLoopHistory& history,
+  std::uint64_t nowUnixSec,
+  std::uint32_t windowSec)
+{
+  const std::uint64_t cutoff = nowUnixSec > windowSec ? nowUnixSec - windowSec : 0;
+  return static_cast<std::uint32_t>(std::count_if(
+    history.richCaptureUnixSec.begin(),
+    history.richCaptureUnixSec.end(),
+    [&](std::uint64_t t) { return t >= cutoff; }));
+}
+
+inline CrashLoopDecision DecideCrashLoopCapture(
+  const CrashLoopHistory& history,
+  std::uint64_t nowUnixSec,
+  const CrashLoopLimits& limits)
+{
+  CrashLoopDecision out{};
+  out.richInWindow = CountRichCapturesInWindow(history, nowUnixSec, limits.windowSec);
+  out.thinSinceRich = history.thinSinceRich;
+  if (limits.richCaptureLimit == 0 || out.richInWindow < limits.richCaptureLimit) {
+    return out;
+  }
+
+  const std::uint32_t level = std::min<std::uint32_t>(out.richInWindow - limits.richCaptureLimit, 5u);
+  out.backoffThinHits = std::min<std::uint32_t>(2u << level, kCrashLoopMaxBackoffThinHits);
+  out.downgrade = history.thinSinceRich < out.backoffThinHits;
+  return out;
+}
+
+// Records a kept capture and drops rich timestamps that left the window.
+inline void RecordCrashLoopCapture(
+  CrashLoopHistory* history,
+  bool rich,
+  std::uint64_t nowUnixSec,
+  std::uint32_t windowSec)
+{
+  if (!history) {
+    return;
+  }
+  const std::uint64_t cutoff = nowUnixSec > windowSec ? nowUnixSec - windowSec : 0;
+  auto& stamps = history->richCaptureUnixSec;
+  stamps.erase(
+    std::remove_if(stamps.begin(), stamps.end(), [&](std::uint64_t t) { return t < cutoff; }),
+    stamps.end());
+  if (rich) {
+    stamps.push_back(nowUnixSec);
+    std::sort(stamps.begin(), stamps.end());
+    history->thinSinceRich = 0;
+  } else {
+    history->thinSinceRich++;
+    history->thinTotal++;
+  }
+}
+
+struct CrashLoopEntryAge
+{
+  std::string key;
+  std::uint64_t updatedUnixSec = 0;
+};
+
+// Keys to drop from the persisted history. An entry idle for longer than the
+// window holds no rich capture inside it, so it can no longer cause a
+// downgrade and dropping it loses nothing; past that, the least recently
+// updated entries go until at most `maxKeys` remain. `keepKey` (the one just
+// updated) is never dropped.
+inline std::vector<std::string> SelectCrashLoopKeysToPrune(
+  std::vector<CrashLoopEntryAge> entries,
+  std::string_view keepKey,
+  std::uint64_t nowUnixSec,
+  std::uint32_t windowSec,
+  std::size_t maxKeys = kCrashLoopMaxTrackedKeys)
+{
+  const std::uint64_t cutoff = nowUnixSec > windowSec ? nowUnixSec - windowSec : 0;
+  std::vector<std::string> out;
+  std::vector<CrashLoopEntryAge> live;
+  live.reserve(entries.size());
+  for (auto& e : entries) {
+    if (e.key == keepKey) {
+      continue;
+    }
+    if (e.updatedUnixSec < cutoff) {
+      out.push_back(std::move(e.key));
+    } else {
+      live.push_back(std::move(e));
+    }
+  }
+
+  const std::size_t keepOthers = maxKeys > 0 ? maxKeys - 1 : 0;
+  if (live.size() > keepOthers) {
+    std::sort(live.begin(), live.end(), [](const CrashLoopEntryAge& a, const CrashLoopEntryAge& b) {
+      return a.updatedUnixSec != b.updatedUnixSec ? a.updatedUnixSec < b.updatedUnixSec : a.key < b.key;
+    });
+    for (std::size_t i = 0; i < live.size() - keepOthers; ++i) {
+      out.push_back(std::move(live[i].key));
+    }
+  }
+  return out;
+}
+
+// Capture-time fingerprint: exception code plus module-relative fault
+// address. Falls back to the absolute address when the module is unknown.
+inline std::string BuildCrashLoopKey(
+  std::uint32_t exceptionCode,
+  std::string_view moduleNameLower,
+  std::uint64_t addressOrOffset)
+{
+  char code[16]{};
+  char offset[32]{};
+  std::snprintf(code, sizeof(code), "%08X", static_cast<unsigned>(exceptionCode));
+  std::snprintf(offset, sizeof(offset), "%llX", static_cast<unsigned long long>(addressOrOffset));
+
+  std::string key(code);
+  key += ':';
+  key += moduleNameLower.empty() ? std::string_view("?") : moduleNameLower;
+  key += "+0x";
+  key += offset;
+  return key;
+}
+
+}  // namespace skydiag::helper
@@ -2,6 +2,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "SkyrimDiagHelper/Config.h"
@@ -83,6 +86,27 @@ inline const char* RecaptureTargetProfileToString(RecaptureTargetProfile profile
   return "none";
 }
 
+// Whether the dump tool's stack walk failed and it fell back to a stack scan.
+// Summaries record this as callstack.stack_scan_fallback; older ones only
+// left a diagnostics line, under whichever wording the dump tool used then.
+inline bool IsStackwalkDegraded(
+  std::optional<bool> stackScanFallback,
+  const std::vector<std::string>& diagnostics)
+{
+  if (stackScanFallback.has_value()) {
+    return *stackScanFallback;
+  }
+  constexpr std::string_view kLegacyLines[] = {
+    "[Stackwalk] DbgHelp stackwalk failed",
+    "[Stackwalk] stackwalk found no suspects",
+  };
+  return std::any_of(diagnostics.begin(), diagnostics.end(), [&](const std::string& line) {
+    return std::any_of(std::begin(kLegacyLines), std::end(kLegacyLines), [&](std::string_view needle) {
+      return line.find(needle) != std::string::npos;
+    });
+  });
+}
+
 struct RecaptureDecision {
   RecaptureKind kind = RecaptureKind::kCrash;
   bool shouldRecapture = false;
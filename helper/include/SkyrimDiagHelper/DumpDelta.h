@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "SkyrimDiagHelper/TargetedMemoryPlan.h"
+
+namespace skydiag::helper {
+
+// Incremental crash recapture: the second dump drops every memory range the
+// first dump already holds and names that dump in a delta user stream, so the
+// analyzer can overlay the two at read time.
+//
+// Platform-neutral: the base dump is read with plain file I/O (header, stream
+// directory and memory lists only, never the memory payload).
+
+inline constexpr std::uint32_t kDumpDeltaFormatVersion = 1;
+
+struct DumpDeltaBase {
+  std::string filenameUtf8;  // same directory as the delta
+  std::uint64_t sizeBytes = 0;
+  std::uint64_t lastWriteTimeUtc100ns = 0;
+  std::vector<MemoryRange> memoryRanges;  // sorted, coalesced
+};
+
+// Sorts and merges overlapping or adjacent ranges; empty ranges are dropped.
+std::vector<MemoryRange> CoalesceMemoryRanges(std::vector<MemoryRange> ranges);
+
+// Splits ranges so each fits a 32-bit MINIDUMP_CALLBACK_OUTPUT::MemorySize.
+std::vector<MemoryRange> SplitMemoryRangesForCallback(const std::vector<MemoryRange>& ranges);
+
+// Memory held by the dump: MemoryListStream, Memory64ListStream and thread
+// stacks. Returns false when the file is not a readable minidump.
+bool ReadMinidumpMemoryRanges(
+  const std::filesystem::path& dumpPath,
+  std::vector<MemoryRange>* out,
+  std::string* err);
+
+// Payload of protocol::kMinidumpUserStream_DumpDelta.
+std::string BuildDumpDeltaStreamJson(const DumpDeltaBase& base);
+
+}  // namespace skydiag::helper
@@ -9,6 +9,10 @@ enum class CaptureKind {
   Hang,
   Manual,
   CrashRecapture,
+  // First phase of a two-phase crash capture: exception thread context,
+  // thread stacks, module list and the blackbox stream, regardless of
+  // DumpMode, so it lands before the process exits.
+  CrashThin,
 };
 
 struct DumpProfile
@@ -25,6 +29,11 @@ struct DumpProfile
   bool includeModuleHeaders = false;
   bool includeIndirectMemory = false;
   bool ignoreInaccessibleMemory = false;
+  // Register targets, stack pointers and suspect-module globals chosen by
+  // PlanTargetedMemory; only meaningful without includeFullMemory.
+  bool includeTargetedMemory = false;
+  // Storage policy from DumpCompression; does not change the dump contents.
+  bool compressOnDisk = false;
   bool preferMainThread = false;
   bool preferWctThreads = false;
   bool preferCrashContext = false;
@@ -32,5 +41,7 @@ struct DumpProfile
 
 const char* CaptureKindToString(CaptureKind captureKind);
 DumpProfile ResolveDumpProfile(DumpMode baseMode, CaptureKind captureKind);
+DumpProfile ResolveDumpProfile(DumpMode baseMode, CaptureKind captureKind, DumpCompression compression);
+bool ShouldCompressDumpOnDisk(DumpCompression compression, const DumpProfile& profile);
 
 }  // namespace skydiag::helper
@@ -3,9 +3,11 @@
 #include <Windows.h>
 
 #include <cstddef>
+#include <optional>
 #include <string>
 
 #include "SkyrimDiagHelper/Config.h"
+#include "SkyrimDiagHelper/DumpDelta.h"
 #include "SkyrimDiagHelper/DumpProfile.h"
 #include "SkyrimDiagShared.h"
 
@@ -19,9 +21,18 @@ bool WriteDumpWithStreams(
   std::size_t shmSnapshotBytes,
   const std::string& wctJsonUtf8,
   const std::string& pluginScanJson,
+  const std::string& hangPrecaptureJson,
   bool isCrash,
   const DumpProfile& dumpProfile,
   bool isProcessSnapshot,
-  std::wstring* err);
+  std::wstring* err,
+  const DumpDeltaBase* deltaBase = nullptr,
+  bool snapshotImmutable = false);
+
+// Main thread as seen by the blackbox: the latest heartbeat tid, falling back
+// to the session-start tid.
+std::optional<DWORD> InferMainThreadIdFromSnapshot(
+  const skydiag::SharedLayout* snapshot,
+  std::size_t snapshotBytes);
 
 }  // namespace skydiag::helper
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace skydiag::helper {
+
+// Snapshot-first freeze capture. A PSS clone holds the game's threads only
+// while the address space is cloned; the dump is then written from the clone
+// while the game keeps running. A live-process MiniDumpWriteDump holds every
+// thread for the whole write, so it is the fallback, never the default.
+
+enum class FreezeSnapshotOutcome {
+  kDisabled,
+  kApiUnavailable,
+  kCaptureFailed,
+  kCaptured,
+};
+
+enum class FreezeDumpTransport {
+  kPssSnapshot,
+  kLiveProcess,
+};
+
+inline const char* FreezeDumpTransportToString(FreezeDumpTransport transport)
+{
+  switch (transport) {
+    case FreezeDumpTransport::kPssSnapshot:
+      return "pss_snapshot";
+    case FreezeDumpTransport::kLiveProcess:
+      return "live_process";
+  }
+  return "live_process";
+}
+
+struct FreezeDumpPlan
+{
+  std::array<FreezeDumpTransport, 2> attempts{};
+  std::size_t attemptCount = 0;
+  // Why the first attempt is not a snapshot; empty when it is.
+  const char* fallbackReason = "";
+};
+
+// Fallback reason once the snapshot write itself has failed.
+inline constexpr const char* kFreezeFallbackSnapshotDumpFailed = "snapshot_dump_failed";
+
+// Fallback matrix:
+//   disabled / API missing / clone failed -> live dump
+//   clone captured                        -> snapshot dump, then live dump if
+//                                            the snapshot write fails and
+//                                            allowLiveRetry is set
+inline FreezeDumpPlan PlanFreezeDump(FreezeSnapshotOutcome outcome, bool allowLiveRetry)
+{
+  FreezeDumpPlan plan{};
+  switch (outcome) {
+    case FreezeSnapshotOutcome::kCaptured:
+      plan.attempts[plan.attemptCount++] = FreezeDumpTransport::kPssSnapshot;
+      if (allowLiveRetry) {
+        plan.attempts[plan.attemptCount++] = FreezeDumpTransport::kLiveProcess;
+      }
+      return plan;
+    case FreezeSnapshotOutcome::kDisabled:
+      plan.fallbackReason = "pss_disabled";
+      break;
+    case FreezeSnapshotOutcome::kApiUnavailable:
+      plan.fallbackReason = "pss_api_unavailable";
+      break;
+    case FreezeSnapshotOutcome::kCaptureFailed:
+      plan.fallbackReason = "pss_capture_failed";
+      break;
+  }
+  plan.attempts[plan.attemptCount++] = FreezeDumpTransport::kLiveProcess;
+  return plan;
+}
+
+struct FreezeCaptureTiming
+{
+  std::uint32_t snapshotCaptureMs = 0;
+  std::uint32_t snapshotDumpWriteMs = 0;  // includes a failed snapshot write
+  std::uint32_t liveDumpWriteMs = 0;
+  bool snapshotDumpWritten = false;
+};
+
+// How long the capture held the game's threads on top of the freeze itself.
+inline std::uint32_t FreezeExtensionMs(const FreezeCaptureTiming& timing)
+{
+  return timing.snapshotCaptureMs + timing.liveDumpWriteMs;
+}
+
+// Estimate of what a live-process dump would have added: the snapshot write
+// stands in for the live write, minus the clone we paid for instead.
+inline std::uint32_t FreezeExtensionAvoidedMs(const FreezeCaptureTiming& timing)
+{
+  if (!timing.snapshotDumpWritten || timing.snapshotDumpWriteMs <= timing.snapshotCaptureMs) {
+    return 0;
+  }
+  return timing.snapshotDumpWriteMs - timing.snapshotCaptureMs;
+}
+
+}  // namespace skydiag::helper
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SkyrimDiagHelper/HangDetect.h"
+
+namespace skydiag::helper {
+
+// Stack words copied from Rsp upward for each sampled thread. Enough to catch
+// the caller chain of a wait/spin without paying for a stack walk.
+inline constexpr std::size_t kHangPrecaptureStackWords = 16;
+inline constexpr std::uint32_t kHangPrecaptureFormatVersion = 1;
+
+struct HangPrecaptureThreadSample {
+  std::uint32_t tid = 0;
+  std::uint64_t rip = 0;
+  std::uint64_t rsp = 0;
+  std::uint32_t stackWordCount = 0;
+  std::array<std::uint64_t, kHangPrecaptureStackWords> stackWords{};
+};
+
+struct HangPrecaptureSnapshot {
+  std::uint64_t qpc = 0;
+  double secondsSinceHeartbeat = 0.0;
+  std::uint32_t thresholdSec = 0;
+  std::uint32_t stateFlags = 0;
+  std::uint32_t mainThreadId = 0;
+  std::vector<HangPrecaptureThreadSample> threads;
+};
+
+// Bounded in-memory ring of pre-hang snapshots. The oldest snapshot is
+// overwritten once the ring is full; nothing touches disk until a hang dump
+// is confirmed.
+class HangPrecaptureRing {
+public:
+  explicit HangPrecaptureRing(std::size_t capacity = 16);
+
+  void SetCapacity(std::size_t capacity);
+  void Push(HangPrecaptureSnapshot snapshot);
+  void Clear();
+
+  std::size_t Capacity() const { return m_slots.size(); }
+  std::size_t Size() const { return m_count; }
+  bool Empty() const { return m_count == 0; }
+  std::uint64_t DroppedCount() const { return m_dropped; }
+  std::uint64_t LastSampleQpc() const { return m_lastSampleQpc; }
+
+  // Oldest-first access; index must be < Size().
+  const HangPrecaptureSnapshot& At(std::size_t index) const;
+
+private:
+  std::vector<HangPrecaptureSnapshot> m_slots;
+  std::size_t m_head = 0;  // next write slot
+  std::size_t m_count = 0;
+  std::uint64_t m_dropped = 0;
+  std::uint64_t m_lastSampleQpc = 0;
+};
+
+// True while the heartbeat is late enough to be interesting but the hang
+// threshold has not fired yet.
+bool IsInHangPrecaptureWindow(const HangDecision& decision, std::uint32_t startPercent);
+
+bool ShouldTakeHangPrecaptureSample(
+  const HangDecision& decision,
+  std::uint32_t startPercent,
+  std::uint64_t nowQpc,
+  std::uint64_t lastSampleQpc,
+  std::uint64_t qpcFreq,
+  std::uint32_t intervalMs);
+
+// Serialized form embedded as kMinidumpUserStream_HangPrecapture. Empty when
+// the ring holds no snapshots.
+std::string SerializeHangPrecaptureRing(const HangPrecaptureRing& ring, std::uint64_t qpcFreq);
+
+}  // namespace skydiag::helper
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 
 namespace skydiag::helper {
 
@@ -24,6 +27,184 @@ struct HangSuppressionResult {
   HangSuppressionReason reason = HangSuppressionReason::kNone;
 };
 
+// ---- Declarative rule engine ----
+//
+// Every input the policy looks at is reduced to one fact bit. A rule matches
+// when (facts & mask) == value; the first matching rule decides. The rule list
+// is compiled once into a flat table indexed by the fact bitmask, so an
+// evaluation is one lookup plus the rule's state effect.
+
+enum HangSuppressionFact : std::uint32_t {
+  kFact_Hang = 1u << 0,
+  kFact_Foreground = 1u << 1,
+  kFact_Loading = 1u << 2,
+  kFact_InMenu = 1u << 3,
+  kFact_WindowResponsive = 1u << 4,
+  kFact_SuppressWhenNotForeground = 1u << 5,  // config
+  kFact_BackgroundPausePending = 1u << 6,     // a not-foreground suppression is remembered
+  kFact_HeartbeatAdvanced = 1u << 7,          // heartbeat moved since that suppression
+  kFact_GraceConfigured = 1u << 8,            // foregroundGraceSec > 0 and qpc clock usable
+  kFact_GraceElapsed = 1u << 9,               // foreground grace period has run out
+};
+
+inline constexpr std::uint32_t kHangSuppressionFactCount = 10;
+inline constexpr std::size_t kHangSuppressionTableSize = std::size_t{ 1 } << kHangSuppressionFactCount;
+
+enum class HangSuppressionEffect : std::uint8_t {
+  kNone = 0,
+  kResetState = 1,               // forget any remembered background pause
+  kRememberBackgroundPause = 2,  // remember heartbeat, restart foreground grace
+  kMarkForegroundResume = 3,     // start the foreground grace clock if not running
+};
+
+struct HangSuppressionRule {
+  const char* name = "";
+  std::uint32_t mask = 0;
+  std::uint32_t value = 0;
+  bool suppress = false;
+  HangSuppressionReason reason = HangSuppressionReason::kNone;
+  HangSuppressionEffect effect = HangSuppressionEffect::kNone;
+};
+
+struct HangSuppressionTableEntry {
+  bool suppress = false;
+  HangSuppressionReason reason = HangSuppressionReason::kNone;
+  HangSuppressionEffect effect = HangSuppressionEffect::kNone;
+  std::uint8_t ruleIndex = 0xFF;  // 0xFF = no rule matched (allow)
+};
+
+using HangSuppressionTable = std::array<HangSuppressionTableEntry, kHangSuppressionTableSize>;
+
+// Ordered: earlier rules win. The last rule is a catch-all.
+inline constexpr std::array<HangSuppressionRule, 10> kDefaultHangSuppressionRules{ {
+  { "no_hang_resets",
+    kFact_Hang, 0u,
+    false, HangSuppressionReason::kNone, HangSuppressionEffect::kResetState },
+  // Not foreground + unresponsive: the user Alt-Tabbed away from a real freeze.
+  { "background_unresponsive_allows",
+    kFact_SuppressWhenNotForeground | kFact_Foreground | kFact_WindowResponsive,
+    kFact_SuppressWhenNotForeground,
+    false, HangSuppressionReason::kNone, HangSuppressionEffect::kNone },
+  { "background_responsive_suppresses",
+    kFact_SuppressWhenNotForeground | kFact_Foreground,
+    kFact_SuppressWhenNotForeground,
+    true, HangSuppressionReason::kNotForeground, HangSuppressionEffect::kRememberBackgroundPause },
+  { "no_background_pause_allows",
+    kFact_BackgroundPausePending, 0u,
+    false, HangSuppressionReason::kNone, HangSuppressionEffect::kNone },
+  { "heartbeat_advanced_resets",
+    kFact_HeartbeatAdvanced, kFact_HeartbeatAdvanced,
+    false, HangSuppressionReason::kNone, HangSuppressionEffect::kResetState },
+  { "still_background_allows",
+    kFact_Foreground, 0u,
+    false, HangSuppressionReason::kNone, HangSuppressionEffect::kNone },
+  { "no_grace_allows",
+    kFact_GraceConfigured, 0u,
+    false, HangSuppressionReason::kNone, HangSuppressionEffect::kNone },
+  { "foreground_grace_suppresses",
+    kFact_GraceElapsed, 0u,
+    true, HangSuppressionReason::kForegroundGrace, HangSuppressionEffect::kMarkForegroundResume },
+  // After the grace period a responsive window outside loading screens is
+  // still treated as a background pause rather than a freeze.
+  { "foreground_responsive_suppresses",
+    kFact_Loading | kFact_WindowResponsive, kFact_WindowResponsive,
+    true, HangSuppressionReason::kForegroundResponsive, HangSuppressionEffect::kMarkForegroundResume },
+  { "default_allows",
+    0u, 0u,
+    false, HangSuppressionReason::kNone, HangSuppressionEffect::kMarkForegroundResume },
+} };
+
+constexpr HangSuppressionTable CompileHangSuppressionTable(std::span<const HangSuppressionRule> rules)
+{
+  HangSuppressionTable table{};
+  for (std::size_t facts = 0; facts < table.size(); ++facts) {
+    for (std::size_t i = 0; i < rules.size() && i < 0xFFu; ++i) {
+      const auto& rule = rules[i];
+      if ((static_cast<std::uint32_t>(facts) & rule.mask) != rule.value) {
+        continue;
+      }
+      table[facts] = HangSuppressionTableEntry{ rule.suppress, rule.reason, rule.effect, static_cast<std::uint8_t>(i) };
+      break;
+    }
+  }
+  return table;
+}
+
+inline constexpr HangSuppressionTable kDefaultHangSuppressionTable =
+  CompileHangSuppressionTable(kDefaultHangSuppressionRules);
+
+struct HangSuppressionInputs {
+  bool isHang = false;
+  bool isForeground = false;
+  bool isLoading = false;
+  bool isInMenu = false;
+  bool isWindowResponsive = false;
+  bool suppressHangWhenNotForeground = true;
+  std::uint64_t nowQpc = 0;
+  std::uint64_t heartbeatQpc = 0;
+  std::uint64_t qpcFreq = 0;
+  std::uint32_t foregroundGraceSec = 0;
+};
+
+inline std::uint32_t CollectHangSuppressionFacts(const HangSuppressionState& state, const HangSuppressionInputs& in)
+{
+  std::uint32_t facts = 0;
+  const auto set = [&](bool on, std::uint32_t bit) {
+    if (on) {
+      facts |= bit;
+    }
+  };
+  set(in.isHang, kFact_Hang);
+  set(in.isForeground, kFact_Foreground);
+  set(in.isLoading, kFact_Loading);
+  set(in.isInMenu, kFact_InMenu);
+  set(in.isWindowResponsive, kFact_WindowResponsive);
+  set(in.suppressHangWhenNotForeground, kFact_SuppressWhenNotForeground);
+  set(state.suppressedHeartbeatQpc != 0, kFact_BackgroundPausePending);
+  set(state.suppressedHeartbeatQpc != 0 && in.heartbeatQpc > state.suppressedHeartbeatQpc, kFact_HeartbeatAdvanced);
+
+  const bool graceConfigured = in.foregroundGraceSec != 0 && in.qpcFreq != 0;
+  set(graceConfigured, kFact_GraceConfigured);
+  if (graceConfigured) {
+    // The grace clock starts on the first foreground evaluation.
+    const std::uint64_t resumeQpc = state.foregroundResumeQpc != 0 ? state.foregroundResumeQpc : in.nowQpc;
+    const std::uint64_t deltaQpc = (in.nowQpc > resumeQpc) ? (in.nowQpc - resumeQpc) : 0;
+    const double secondsSinceForeground = static_cast<double>(deltaQpc) / static_cast<double>(in.qpcFreq);
+    set(secondsSinceForeground >= static_cast<double>(in.foregroundGraceSec), kFact_GraceElapsed);
+  }
+  return facts;
+}
+
+inline HangSuppressionResult ApplyHangSuppressionTable(
+  const HangSuppressionTable& table,
+  HangSuppressionState& state,
+  const HangSuppressionInputs& in,
+  std::uint8_t* matchedRule = nullptr)
+{
+  const auto facts = CollectHangSuppressionFacts(state, in);
+  const auto& entry = table[facts & (kHangSuppressionTableSize - 1u)];
+  switch (entry.effect) {
+    case HangSuppressionEffect::kNone:
+      break;
+    case HangSuppressionEffect::kResetState:
+      state = {};
+      break;
+    case HangSuppressionEffect::kRememberBackgroundPause:
+      state.suppressedHeartbeatQpc = in.heartbeatQpc;
+      state.foregroundResumeQpc = 0;
+      break;
+    case HangSuppressionEffect::kMarkForegroundResume:
+      if (state.foregroundResumeQpc == 0) {
+        state.foregroundResumeQpc = in.nowQpc;
+      }
+      break;
+  }
+  if (matchedRule) {
+    *matchedRule = entry.ruleIndex;
+  }
+  return { entry.suppress, entry.reason };
+}
+
 inline HangSuppressionResult EvaluateHangSuppression(
   HangSuppressionState& state,
   bool isHang,
@@ -36,59 +217,32 @@ inline HangSuppressionResult EvaluateHangSuppression(
   std::uint64_t qpcFreq,
   std::uint32_t foregroundGraceSec)
 {
-  if (!isHang) {
-    state = {};
-    return {};
-  }
-
-  if (suppressHangWhenNotForeground && !isForeground) {
-    // If the window is unresponsive while not foreground, treat as a real
-    // freeze (user Alt-Tabbed away from a frozen game) and allow capture.
-    if (!isWindowResponsive) {
-      return {};
-    }
-    // Window is responsive but not foreground — likely normal Alt-Tab pause.
-    state.suppressedHeartbeatQpc = heartbeatQpc;
-    state.foregroundResumeQpc = 0;
-    return { true, HangSuppressionReason::kNotForeground };
-  }
-
-  if (state.suppressedHeartbeatQpc == 0) {
-    return {};
-  }
-
-  if (heartbeatQpc > state.suppressedHeartbeatQpc) {
-    state = {};
-    return {};
-  }
-
-  // Heartbeat has not advanced since the background suppression started.
-  // If we're back in foreground, apply a grace period before treating it as an actionable hang.
-  if (!isForeground) {
-    return {};
-  }
-
-  if (foregroundGraceSec == 0 || qpcFreq == 0) {
-    return {};
-  }
-
-  if (state.foregroundResumeQpc == 0) {
-    state.foregroundResumeQpc = nowQpc;
-  }
-
-  const std::uint64_t deltaQpc = (nowQpc > state.foregroundResumeQpc) ? (nowQpc - state.foregroundResumeQpc) : 0;
-  const double secondsSinceForeground = static_cast<double>(deltaQpc) / static_cast<double>(qpcFreq);
-  if (secondsSinceForeground < static_cast<double>(foregroundGraceSec)) {
-    return { true, HangSuppressionReason::kForegroundGrace };
-  }
+  HangSuppressionInputs in{};
+  in.isHang = isHang;
+  in.isForeground = isForeground;
+  in.isLoading = isLoading;
+  in.isWindowResponsive = isWindowResponsive;
+  in.suppressHangWhenNotForeground = suppressHangWhenNotForeground;
+  in.nowQpc = nowQpc;
+  in.heartbeatQpc = heartbeatQpc;
+  in.qpcFreq = qpcFreq;
+  in.foregroundGraceSec = foregroundGraceSec;
+  return ApplyHangSuppressionTable(kDefaultHangSuppressionTable, state, in);
+}
 
-  // After the grace period, if the window is still responsive and we're not in a loading screen,
-  // keep suppressing to avoid false "hang" dumps caused by background pauses (Alt-Tab).
-  if (!isLoading && isWindowResponsive) {
-    return { true, HangSuppressionReason::kForegroundResponsive };
+inline const char* HangSuppressionReasonName(HangSuppressionReason reason)
+{
+  switch (reason) {
+    case HangSuppressionReason::kNone:
+      return "none";
+    case HangSuppressionReason::kNotForeground:
+      return "not_foreground";
+    case HangSuppressionReason::kForegroundGrace:
+      return "foreground_grace";
+    case HangSuppressionReason::kForegroundResponsive:
+      return "foreground_responsive";
   }
-
-  return {};
+  return "unknown";
 }
 
 }  // namespace skydiag::helper
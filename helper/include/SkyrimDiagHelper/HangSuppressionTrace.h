@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "SkyrimDiagHelper/HangSuppression.h"
+
+namespace skydiag::helper {
+
+// One hang-suppression evaluation as seen by the helper. Written as a JSONL
+// line when EnableHangSuppressionTrace=1 and replayed offline through the
+// same rule table by skydiag_hang_suppression_replay.
+struct HangSuppressionTraceRecord {
+  HangSuppressionInputs inputs{};
+  bool confirmedPhase = false;
+  double secondsSinceHeartbeat = 0.0;
+  std::uint32_t thresholdSec = 0;
+  std::uint32_t stateFlags = 0;
+
+  // Decision the helper made when the record was written (absent in
+  // hand-written fixtures).
+  std::optional<HangSuppressionResult> recorded;
+  std::string recordedRule;
+
+  // Optional ground truth for fixtures: "pause" (must not capture) or
+  // "freeze" (must capture).
+  std::string label;
+};
+
+const char* HangSuppressionRuleName(std::uint8_t ruleIndex);
+
+std::optional<HangSuppressionReason> TryParseHangSuppressionReason(std::string_view name);
+
+std::string SerializeHangSuppressionTraceRecord(const HangSuppressionTraceRecord& record);
+
+// Returns false on malformed input; missing optional fields keep defaults.
+bool TryParseHangSuppressionTraceRecord(std::string_view line, HangSuppressionTraceRecord& out);
+
+}  // namespace skydiag::helper
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace skydiag::helper {
+
+// Helper self-profiling. Stages are timed with ScopedPerfTimer into
+// fixed-bucket histograms; counters track events that are not timed. All
+// updates are lock-free so post-process worker threads can record too.
+
+enum class PerfStage : std::uint8_t {
+  kHangTick = 0,        // HandleHangTick, including the 1.5 s confirmation wait
+  kCrashEvent,          // crash event handling after the event fired
+  kWctCapture,          // CaptureWct (both passes)
+  kWctPass,             // a single WCT pass
+  kDumpWrite,           // WriteDumpWithStreams
+  kMemoryPlan,          // targeted-memory region walk + planning, inside kDumpWrite
+  kHangPrecaptureSample,
+  kRetentionSweep,
+  kFreezeExtension,     // game threads held by a hang/manual capture (PSS clone or live dump)
+  kCrashFingerprint,    // module walk + stack read + fingerprint, before the crash dump
+  kCount,
+};
+
+enum class PerfCounter : std::uint8_t {
+  kLoopIterations = 0,
+  kHangSuppressed,
+  kCrashEventRetries,
+  kCount,
+};
+
+inline constexpr std::size_t kPerfStageCount = static_cast<std::size_t>(PerfStage::kCount);
+inline constexpr std::size_t kPerfCounterCount = static_cast<std::size_t>(PerfCounter::kCount);
+inline constexpr std::uint32_t kHelperPerfFormatVersion = 1;
+
+// Inclusive upper bounds in microseconds; one overflow bucket follows.
+inline constexpr std::array<std::uint64_t, 14> kPerfBucketUpperUs{
+  100, 250, 500, 1'000, 2'500, 5'000, 10'000, 25'000, 50'000, 100'000, 250'000, 1'000'000, 2'500'000, 10'000'000,
+};
+inline constexpr std::size_t kPerfBucketCount = kPerfBucketUpperUs.size() + 1;
+
+const char* PerfStageName(PerfStage stage);
+const char* PerfCounterName(PerfCounter counter);
+std::size_t PerfBucketIndex(std::uint64_t us);
+
+class PerfHistogram {
+public:
+  void Record(std::uint64_t us);
+
+  std::uint64_t Count() const { return m_count.load(std::memory_order_relaxed); }
+  std::uint64_t TotalUs() const { return m_totalUs.load(std::memory_order_relaxed); }
+  std::uint64_t MaxUs() const { return m_maxUs.load(std::memory_order_relaxed); }
+  std::uint64_t Bucket(std::size_t index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+
+  // Upper bound of the bucket holding the given quantile (0..1). Samples in
+  // the overflow bucket report MaxUs().
+  std::uint64_t QuantileUpperUs(double q) const;
+
+private:
+  std::atomic<std::uint64_t> m_count{ 0 };
+  std::atomic<std::uint64_t> m_totalUs{ 0 };
+  std::atomic<std::uint64_t> m_maxUs{ 0 };
+  std::array<std::atomic<std::uint64_t>, kPerfBucketCount> m_buckets{};
+};
+
+class HelperPerfRecorder {
+public:
+  HelperPerfRecorder();
+
+  void Record(PerfStage stage, std::uint64_t us);
+  void Increment(PerfCounter counter, std::uint64_t delta = 1);
+
+  const PerfHistogram& Stage(PerfStage stage) const { return m_stages[static_cast<std::size_t>(stage)]; }
+  std::uint64_t Counter(PerfCounter counter) const
+  {
+    return m_counters[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+  }
+  double SessionSeconds() const;
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+  std::array<PerfHistogram, kPerfStageCount> m_stages{};
+  std::array<std::atomic<std::uint64_t>, kPerfCounterCount> m_counters{};
+};
+
+// Process-wide recorder; the helper serves one game session per process.
+HelperPerfRecorder& HelperPerf();
+
+class ScopedPerfTimer {
+public:
+  explicit ScopedPerfTimer(PerfStage stage, HelperPerfRecorder& recorder = HelperPerf())
+    : m_recorder(recorder), m_stage(stage), m_start(std::chrono::steady_clock::now())
+  {}
+  ~ScopedPerfTimer();
+
+  ScopedPerfTimer(const ScopedPerfTimer&) = delete;
+  ScopedPerfTimer& operator=(const ScopedPerfTimer&) = delete;
+
+private:
+  HelperPerfRecorder& m_recorder;
+  PerfStage m_stage;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+// Full SkyrimDiagHelper_Perf.json document (histogram buckets included).
+std::string SerializeHelperPerf(const HelperPerfRecorder& recorder);
+
+// Compact per-stage summary (count/total/max/p95) for the incident manifest.
+std::string SerializeHelperPerfSummary(const HelperPerfRecorder& recorder);
+
+}  // namespace skydiag::helper
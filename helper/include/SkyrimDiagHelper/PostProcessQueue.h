@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace skydiag::helper {
+
+// Work that follows a written dump (analysis hand-off, retention sweeps) runs
+// through one prioritized queue instead of ad-hoc threads, so a crash and its
+// recapture, or a burst of hangs, do not compete for the disk.
+//
+// Jobs become ready once every dependency has finished (successfully or not)
+// and are picked by priority, then submission order, by at most maxWorkers
+// threads. External jobs stand for work the helper only observes (the
+// headless analyzer process); the owner reports them with Complete().
+// Platform-neutral: only std::thread and friends.
+
+enum class PostProcessPriority : std::uint8_t {
+  kCrash = 0,
+  kHang,
+  kManual,
+  kMaintenance,
+};
+
+enum class PostProcessJobState : std::uint8_t {
+  kUnknown = 0,  // never enqueued, or already forgotten
+  kPending,
+  kRunning,
+  kSucceeded,
+  kFailed,
+  kCanceled,
+};
+
+using PostProcessJobId = std::uint64_t;
+inline constexpr PostProcessJobId kNoPostProcessJob = 0;
+
+// Job bodies poll this to stop early once the queue shuts down.
+using PostProcessCancelFlag = std::atomic<bool>;
+
+struct PostProcessJob {
+  std::string name;
+  PostProcessPriority priority = PostProcessPriority::kMaintenance;
+  std::vector<PostProcessJobId> dependsOn;  // unknown/finished ids are ignored
+  // A pending job with the same non-empty key absorbs this one: the newer
+  // body replaces the older and dependencies are merged. Running jobs are
+  // never coalesced into.
+  std::string coalesceKey;
+  std::function<bool(const PostProcessCancelFlag& cancel)> run;
+};
+
+struct PostProcessQueueStats {
+  std::uint64_t enqueued = 0;
+  std::uint64_t coalesced = 0;
+  std::uint64_t succeeded = 0;
+  std::uint64_t failed = 0;
+  std::uint64_t canceled = 0;
+  std::uint32_t maxConcurrent = 0;
+};
+
+class PostProcessQueue {
+public:
+  explicit PostProcessQueue(std::size_t maxWorkers);
+  ~PostProcessQueue();
+
+  PostProcessQueue(const PostProcessQueue&) = delete;
+  PostProcessQueue& operator=(const PostProcessQueue&) = delete;
+
+  // Returns kNoPostProcessJob after Shutdown() or when job.run is empty.
+  PostProcessJobId Enqueue(PostProcessJob job);
+
+  // Placeholder for work tracked outside the queue; it occupies no worker.
+  PostProcessJobId EnqueueExternal(std::string name, PostProcessPriority priority);
+  void Complete(PostProcessJobId id, bool succeeded);
+
+  PostProcessJobState State(PostProcessJobId id) const;
+  PostProcessQueueStats Stats() const;
+
+  // True once nothing is pending or running. External jobs count as pending.
+  bool WaitIdle(std::chrono::milliseconds timeout);
+  // True once `id` is no longer pending or running (unknown ids included).
+  bool WaitFor(PostProcessJobId id, std::chrono::milliseconds timeout);
+
+  // Cancels everything not yet started, raises the cancel flag for running
+  // bodies and joins the workers. Later Enqueue() calls are rejected.
+  void Shutdown();
+
+private:
+  struct Entry {
+    PostProcessJob job;
+    PostProcessJobState state = PostProcessJobState::kPending;
+    bool external = false;
+  };
+
+  void WorkerMain();
+  bool IsReadyLocked(const Entry& entry) const;
+  std::map<PostProcessJobId, Entry>::iterator PickReadyLocked();
+  void FinishLocked(PostProcessJobId id, PostProcessJobState state);
+  void EnsureWorkersLocked();
+
+  const std::size_t m_maxWorkers;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_workCv;
+  std::condition_variable m_idleCv;
+  std::condition_variable m_finishedCv;
+  std::map<PostProcessJobId, Entry> m_jobs;  // pending + running; ordered by id
+  std::map<PostProcessJobId, PostProcessJobState> m_finished;
+  std::vector<std::thread> m_workers;
+  PostProcessCancelFlag m_cancel{ false };
+  PostProcessJobId m_nextId = 1;
+  std::uint32_t m_running = 0;
+  bool m_stopping = false;
+  PostProcessQueueStats m_stats{};
+};
+
+}  // namespace skydiag::helper
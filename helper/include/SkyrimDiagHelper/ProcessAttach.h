@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <string>
 
+#include "SkyrimDiagCapabilities.h"
 #include "SkyrimDiagShared.h"
 
 namespace skydiag::helper {
@@ -18,14 +19,23 @@ struct AttachedProcess {
   const skydiag::SharedLayout* shm = nullptr;
   skydiag::SharedLayout* shmWritable = nullptr;
   std::size_t shmSize = 0;  // mapped bytes (best-effort)
+  std::size_t mappedBytes = 0;  // whole view, including the capability block when present
 
   HANDLE crashEvent = nullptr;
   std::uint32_t crashEventOpenError = ERROR_SUCCESS;
+
+  // Signaled by the plugin once the mapping and crash event exist
+  // (kFeature_ReadyEvent). Null for plugins that predate the handshake.
+  HANDLE readyEvent = nullptr;
+  bool hasCapabilities = false;
+  skydiag::ProtocolNegotiationResult protocol{};
 };
 
 bool AttachByPid(std::uint32_t pid, AttachedProcess& out, std::wstring* err);
 bool FindAndAttach(AttachedProcess& out, std::wstring* err);
 bool TryAttachCrashEvent(AttachedProcess& proc, std::wstring* err);
+// True once the plugin's ready event is signaled; false without one.
+bool IsPluginReady(const AttachedProcess& proc, DWORD waitMs);
 void Detach(AttachedProcess& p);
 
 }  // namespace skydiag::helper
@@ -94,7 +94,9 @@ inline void DeleteAssociatedDumpToolArtifacts(const std::filesystem::path& dir,
       continue;
     }
     const auto name = ent.path().filename().string();
-    if (StartsWith(name, stem + "_")) {
+    // Sibling dumps sharing the prefix (e.g. <stem>_Full.dmp) are retained or
+    // pruned as incidents of their own.
+    if (StartsWith(name, stem + "_") && !EndsWith(name, ".dmp")) {
       std::filesystem::remove(ent.path(), ec);
     }
   }
@@ -173,12 +175,64 @@ inline std::vector<DatedFile> CollectFilesByPrefixAndExt(
   return CollectFilesByPrefixAndExt(files, prefix, ext);
 }
 
-inline std::unordered_map<std::string, std::uint32_t> BuildTimestampRefCounts(const std::vector<DatedFile>& dumps)
+// Dumps that are only useful together form one incident and are counted and
+// pruned as a unit:
+//   <stem>.dmp                   the capture
+//   <stem>_Enriched.dmp          its two-phase enrichment pass
+//   <stem>_Delta_<ts>[...].dmp   a crash recapture stored as a delta on it
+// (the delta may be taken on the enriched dump: <stem>_Enriched_Delta_...).
+inline std::string IncidentGroupStem(std::string_view dumpStem)
 {
-  std::unordered_map<std::string, std::uint32_t> refs;
-  refs.reserve(dumps.size());
+  constexpr std::string_view kDelta = "_Delta_";
+  constexpr std::string_view kEnriched = "_Enriched";
+  std::string_view s = dumpStem;
+  if (const auto pos = s.find(kDelta); pos != std::string_view::npos) {
+    s = s.substr(0, pos);
+  }
+  if (EndsWith(s, kEnriched)) {
+    s.remove_suffix(kEnriched.size());
+  }
+  return std::string(s);
+}
+
+struct DumpIncident {
+  std::string stem;
+  std::string ts;  // of the capture that started the incident
+  std::vector<std::filesystem::path> dumps;
+};
+
+// Newest incident first; `dumps` may be in any order.
+inline std::vector<DumpIncident> GroupDumpsIntoIncidents(const std::vector<DatedFile>& dumps)
+{
+  std::vector<DumpIncident> incidents;
+  std::unordered_map<std::string, std::size_t> byStem;
   for (const auto& dump : dumps) {
-    refs[dump.ts] += 1u;
+    auto stem = IncidentGroupStem(dump.path.stem().string());
+    const auto [it, inserted] = byStem.try_emplace(stem, incidents.size());
+    if (inserted) {
+      DumpIncident incident;
+      incident.ts = TryExtractTimestampToken(stem).value_or(dump.ts);
+      incident.stem = std::move(stem);
+      incidents.push_back(std::move(incident));
+    }
+    incidents[it->second].dumps.push_back(dump.path);
+  }
+
+  std::sort(incidents.begin(), incidents.end(), [](const DumpIncident& a, const DumpIncident& b) {
+    if (a.ts != b.ts) {
+      return a.ts > b.ts;
+    }
+    return a.stem < b.stem;
+  });
+  return incidents;
+}
+
+inline std::unordered_map<std::string, std::uint32_t> BuildTimestampRefCounts(const std::vector<DumpIncident>& incidents)
+{
+  std::unordered_map<std::string, std::uint32_t> refs;
+  refs.reserve(incidents.size());
+  for (const auto& incident : incidents) {
+    refs[incident.ts] += 1u;
   }
   return refs;
 }
@@ -195,42 +249,46 @@ inline void PruneDumpFilesFromCollected(
   if (maxCount == 0 || dumps.size() <= static_cast<std::size_t>(maxCount)) {
     return;
   }
+  const auto incidents = GroupDumpsIntoIncidents(dumps);
+  if (incidents.size() <= static_cast<std::size_t>(maxCount)) {
+    return;
+  }
 
   std::error_code ec;
   const std::string_view incidentKind = IncidentKindForDumpPrefix(dumpPrefix);
-  auto tsRefs = BuildTimestampRefCounts(dumps);
-  for (std::size_t i = maxCount; i < dumps.size(); i++) {
-    const auto p = dumps[i].path;
-    const auto stem = p.stem().string();
-
-    std::filesystem::remove(p, ec);
-    DeleteAssociatedDumpToolArtifacts(dir, stem);
-
-    if (deleteEtlForStem) {
-      auto etl = p;
-      etl.replace_extension(".etl");
-      std::filesystem::remove(etl, ec);
+  auto tsRefs = BuildTimestampRefCounts(incidents);
+  for (std::size_t i = maxCount; i < incidents.size(); i++) {
+    const auto& incident = incidents[i];
+    for (const auto& p : incident.dumps) {
+      std::filesystem::remove(p, ec);
+      DeleteAssociatedDumpToolArtifacts(dir, p.stem().string());
+
+      if (deleteEtlForStem) {
+        auto etl = p;
+        etl.replace_extension(".etl");
+        std::filesystem::remove(etl, ec);
+      }
     }
 
     if (!incidentKind.empty()) {
-      auto it = tsRefs.find(dumps[i].ts);
+      auto it = tsRefs.find(incident.ts);
       if (it != tsRefs.end()) {
         if (it->second > 0) {
           --it->second;
         }
         if (it->second == 0) {
-          const auto manifest = dir / ("SkyrimDiag_Incident_" + std::string(incidentKind) + "_" + dumps[i].ts + ".json");
+          const auto manifest = dir / ("SkyrimDiag_Incident_" + std::string(incidentKind) + "_" + incident.ts + ".json");
           std::filesystem::remove(manifest, ec);
         }
       }
     }
 
     if (deleteWctForTimestamp) {
-      const auto wct = dir / ("SkyrimDiag_WCT_" + dumps[i].ts + ".json");
+      const auto wct = dir / ("SkyrimDiag_WCT_" + incident.ts + ".json");
       std::filesystem::remove(wct, ec);
     }
     if (deleteManualWctForTimestamp) {
-      const auto wct = dir / ("SkyrimDiag_WCT_Manual_" + dumps[i].ts + ".json");
+      const auto wct = dir / ("SkyrimDiag_WCT_Manual_" + incident.ts + ".json");
       std::filesystem::remove(wct, ec);
     }
   }
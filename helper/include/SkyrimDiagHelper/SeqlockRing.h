@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+namespace skydiag::helper {
+
+// Plugin ring writers claim index `idx` by bumping write_index and commit the
+// slot with seq = idx * 2 (odd while writing). A ring is quiescent when every
+// claimed slot carries the committed sequence of the last index that claimed
+// it: no writer is mid-entry and none has claimed a slot it has not written.
+// Entry only needs a `seq` member.
+template <class Entry>
+bool IsSeqlockRingQuiescent(const Entry* entries, std::uint32_t capacity, std::uint32_t writeIndex) noexcept
+{
+  if (!entries || capacity == 0u) {
+    return false;
+  }
+  const std::uint32_t claimed = writeIndex < capacity ? writeIndex : capacity;
+  for (std::uint32_t n = 0; n < claimed; ++n) {
+    const std::uint32_t idx = writeIndex - 1u - n;
+    if (entries[idx % capacity].seq != idx * 2u) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace skydiag::helper
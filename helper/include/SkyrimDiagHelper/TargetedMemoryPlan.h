@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace skydiag::helper {
+
+// Chooses the extra memory a crash dump carries beyond thread stacks: the
+// bytes the analyzer will dereference (register targets, objects behind the
+// first arguments, pointers found on the faulting stack, writable sections of
+// suspect modules) without paying for a full-memory dump.
+//
+// Platform-neutral: the caller supplies the register file, a copy of the
+// faulting stack and the target's committed readable regions. Everything is
+// planned in whole pages and clipped to those regions.
+
+inline constexpr std::uint64_t kTargetedMemoryPageBytes = 4096;
+
+struct MemoryRange {
+  std::uint64_t base = 0;
+  std::uint64_t size = 0;
+};
+
+enum MemoryRegionFlags : std::uint32_t {
+  kRegion_Writable = 1u << 0,
+  kRegion_Executable = 1u << 1,
+  kRegion_Image = 1u << 2,
+};
+
+struct MemoryRegionInfo {
+  std::uint64_t base = 0;
+  std::uint64_t size = 0;
+  std::uint64_t allocationBase = 0;
+  std::uint32_t flags = 0;  // MemoryRegionFlags
+};
+
+struct TargetedMemoryInputs {
+  std::uint64_t instructionPointer = 0;
+  std::vector<std::uint64_t> registers;          // general-purpose registers at the fault
+  std::vector<std::uint64_t> argumentRegisters;  // RCX/RDX: usually `this` and the first argument
+  std::vector<std::uint64_t> stackWords;         // qwords read upward from the stack pointer
+  MemoryRange stack;                             // faulting thread stack; already in every dump
+  std::vector<MemoryRegionInfo> readableRegions; // committed + readable, sorted by base, disjoint
+};
+
+struct TargetedMemoryLimits {
+  std::uint64_t registerWindowBytes = 4 * 1024;     // +/- around each register target
+  std::uint64_t argumentWindowBytes = 16 * 1024;    // forward from RCX/RDX (heap objects)
+  std::uint64_t stackPointerWindowBytes = 1024;     // forward from each stack pointer
+  std::size_t maxStackPointers = 512;
+  std::size_t maxSuspectModules = 4;                // faulting module + return-address modules
+  std::uint64_t maxModuleDataBytes = 2 * 1024 * 1024;
+  std::uint64_t totalBudgetBytes = 32 * 1024 * 1024;
+};
+
+struct TargetedMemoryPlan {
+  std::vector<MemoryRange> ranges;  // sorted, coalesced, page-aligned
+  std::uint64_t totalBytes = 0;
+  std::uint32_t candidates = 0;
+  std::uint32_t droppedForBudget = 0;  // candidates cut short by totalBudgetBytes
+};
+
+// Candidates are taken in priority order (fault site, registers, arguments,
+// stack pointers, module data) until the budget runs out, so a tight budget
+// keeps the most useful bytes. Addresses outside readableRegions are ignored.
+TargetedMemoryPlan PlanTargetedMemory(const TargetedMemoryInputs& in, const TargetedMemoryLimits& limits = {});
+
+}  // namespace skydiag::helper
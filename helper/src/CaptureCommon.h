@@ -9,7 +9,7 @@
 #include "SkyrimDiagHelper/PluginScanner.h"
 #include "SkyrimDiagHelper/ProcessAttach.h"
 #include "SkyrimDiagHelper/Retention.h"
-#include "RetentionWorker.h"
+#include "PostProcessWorker.h"
 
 namespace skydiag::helper::internal {
 
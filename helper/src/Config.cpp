@@ -111,6 +111,9 @@ HelperConfig LoadConfig(std::wstring* err)
     cfg.dumpMode = DumpMode::kDefault;
   }
 
+  cfg.dumpCompression = static_cast<DumpCompression>(ReadIniUint32Clamped(
+    path, L"SkyrimDiagHelper", L"DumpCompression", 1, 0, 2));
+
   cfg.outputDir = ResolveEffectiveOutputDir(ReadIniString(path, L"SkyrimDiagHelper", L"OutputDir", L""));
 
   cfg.enableManualCaptureHotkey =
@@ -126,6 +129,14 @@ HelperConfig LoadConfig(std::wstring* err)
     GetPrivateProfileIntW(L"SkyrimDiagHelper", L"PreserveFilteredCrashDumps", 0, path.c_str()) != 0;
   cfg.enableCleanExitEvidenceQuarantine =
     GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableCleanExitEvidenceQuarantine", 1, path.c_str()) != 0;
+  cfg.enableTwoPhaseCrashCapture =
+    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableTwoPhaseCrashCapture", 1, path.c_str()) != 0;
+  cfg.enableCrashLoopBackoff =
+    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableCrashLoopBackoff", 1, path.c_str()) != 0;
+  cfg.crashLoopRichCaptureLimit = ReadIniUint32Clamped(
+    path, L"SkyrimDiagHelper", L"CrashLoopRichCaptureLimit", 3, 1, 20);
+  cfg.crashLoopWindowSec = ReadIniUint32Clamped(
+    path, L"SkyrimDiagHelper", L"CrashLoopWindowSec", 86400, 600, 30u * 86400u);
   cfg.dumpToolExe = ReadIniString(
     path,
     L"SkyrimDiagHelper",
@@ -137,7 +148,9 @@ HelperConfig LoadConfig(std::wstring* err)
   cfg.autoOpenCrashWaitForExitMs = ReadIniUint32Clamped(
     path, L"SkyrimDiagHelper", L"AutoOpenCrashWaitForExitMs", 2000, 0, 60000);
   cfg.enableAutoRecaptureOnUnknownCrash =
-    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableAutoRecaptureOnUnknownCrash", 0, path.c_str()) != 0;
+    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableAutoRecaptureOnUnknownCrash", 1, path.c_str()) != 0;
+  cfg.enableIncrementalCrashRecapture =
+    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableIncrementalCrashRecapture", 1, path.c_str()) != 0;
   cfg.autoRecaptureUnknownBucketThreshold = ReadIniUint32Clamped(
     path, L"SkyrimDiagHelper", L"AutoRecaptureUnknownBucketThreshold", 2, 1, 10);
   cfg.autoRecaptureAnalysisTimeoutSec = ReadIniUint32Clamped(
@@ -152,7 +165,7 @@ HelperConfig LoadConfig(std::wstring* err)
   cfg.autoOpenViewerBeginnerMode =
     GetPrivateProfileIntW(L"SkyrimDiagHelper", L"AutoOpenViewerBeginnerMode", 1, path.c_str()) != 0;
   cfg.enablePssSnapshotForFreeze =
-    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnablePssSnapshotForFreeze", 0, path.c_str()) != 0;
+    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnablePssSnapshotForFreeze", 1, path.c_str()) != 0;
 
   cfg.enableAdaptiveLoadingThreshold =
     GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableAdaptiveLoadingThreshold", 1, path.c_str()) != 0;
@@ -171,6 +184,19 @@ HelperConfig LoadConfig(std::wstring* err)
 
   cfg.foregroundGraceSec = ReadIniUint32Clamped(
     path, L"SkyrimDiagHelper", L"ForegroundGraceSec", 5, 0, 60);
+  cfg.enableHangSuppressionTrace =
+    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableHangSuppressionTrace", 0, path.c_str()) != 0;
+
+  cfg.enableHangPrecapture =
+    GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableHangPrecapture", 1, path.c_str()) != 0;
+  cfg.hangPrecaptureStartPercent = ReadIniUint32Clamped(
+    path, L"SkyrimDiagHelper", L"HangPrecaptureStartPercent", 50, 10, 95);
+  cfg.hangPrecaptureIntervalMs = ReadIniUint32Clamped(
+    path, L"SkyrimDiagHelper", L"HangPrecaptureIntervalMs", 1000, 250, 10000);
+  cfg.hangPrecaptureMaxSnapshots = ReadIniUint32Clamped(
+    path, L"SkyrimDiagHelper", L"HangPrecaptureMaxSnapshots", 16, 1, 64);
+  cfg.hangPrecaptureMaxThreads = ReadIniUint32Clamped(
+    path, L"SkyrimDiagHelper", L"HangPrecaptureMaxThreads", 8, 1, 64);
 
   cfg.enableEtwCaptureOnHang =
     GetPrivateProfileIntW(L"SkyrimDiagHelper", L"EnableEtwCaptureOnHang", 0, path.c_str()) != 0;
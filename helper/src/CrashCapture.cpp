@@ -1,19 +1,26 @@
 #include "CrashCapture.h"
 
 #include <Windows.h>
+#include <TlHelp32.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cwchar>
 #include <cstring>
+#include <ctime>
 #include <filesystem>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <new>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -26,11 +33,16 @@
 #include "IncidentManifest.h"
 #include "PendingCrashAnalysis.h"
 #include "PluginScanner.h"
+#include "PostProcessWorker.h"
 #include "HexFormat.h"
 #include "SkyrimDiagHelper/Config.h"
+#include "SkyrimDiagHelper/CrashFingerprint.h"
+#include "SkyrimDiagHelper/CrashLoopPolicy.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
 #include "SkyrimDiagHelper/DumpWriter.h"
 #include "SkyrimDiagHelper/HeadlessAnalysisPolicy.h"
 #include "SkyrimDiagHelper/ProcessAttach.h"
+#include "SkyrimDiagHelper/SeqlockRing.h"
 #include "SkyrimDiagShared.h"
 
 namespace skydiag::helper::internal {
@@ -69,6 +81,389 @@ bool IsProcessStillActive(HANDLE process) noexcept
   return WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
 }
 
+// With DumpMode=0 the thin profile is no smaller than the regular one, so a
+// second dump would add nothing.
+bool ShouldUseTwoPhaseCrashCapture(const skydiag::helper::HelperConfig& cfg) noexcept
+{
+  return cfg.enableTwoPhaseCrashCapture && cfg.dumpMode != skydiag::helper::DumpMode::kMini;
+}
+
+struct CrashLoopCapture {
+  std::string key;  // empty when backoff is off or the fault could not be keyed
+  skydiag::helper::CrashLoopDecision decision{};
+  std::uint64_t nowUnixSec = 0;
+  std::uint32_t windowSec = 0;
+};
+
+std::vector<skydiag::helper::FingerprintModule> CollectFingerprintModules(std::uint32_t pid)
+{
+  std::vector<skydiag::helper::FingerprintModule> modules;
+  HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, pid);
+  if (snap == INVALID_HANDLE_VALUE) {
+    return modules;
+  }
+  MODULEENTRY32W me{};
+  me.dwSize = sizeof(me);
+  for (BOOL ok = Module32FirstW(snap, &me); ok; ok = Module32NextW(snap, &me)) {
+    modules.push_back({
+      LowerAscii(WideToUtf8(me.szModule)),
+      reinterpret_cast<std::uint64_t>(me.modBaseAddr),
+      me.modBaseSize,
+    });
+  }
+  CloseHandle(snap);
+  return modules;
+}
+
+// Reads the top of the faulting thread's stack page by page and stops at the
+// first unreadable page (guard page or the end of the stack reservation).
+std::vector<std::uint8_t> ReadFaultingStack(HANDLE process, std::uint64_t rsp)
+{
+  constexpr std::uint64_t kPage = 0x1000;
+  std::vector<std::uint8_t> bytes;
+  if (!process || rsp == 0) {
+    return bytes;
+  }
+  bytes.resize(skydiag::helper::kCrashFingerprintStackScanBytes);
+  std::size_t have = 0;
+  std::uint64_t addr = rsp;
+  while (have < bytes.size()) {
+    const std::size_t chunk = static_cast<std::size_t>(
+      std::min<std::uint64_t>(kPage - (addr & (kPage - 1)), bytes.size() - have));
+    SIZE_T read = 0;
+    if (!ReadProcessMemory(process, reinterpret_cast<LPCVOID>(addr), bytes.data() + have, chunk, &read) || read == 0) {
+      break;
+    }
+    have += read;
+    addr += read;
+    if (read < chunk) {
+      break;
+    }
+  }
+  bytes.resize(have);
+  return bytes;
+}
+
+// What the fingerprint needs from the live process.
+struct FingerprintInputs {
+  std::vector<skydiag::helper::FingerprintModule> modules;
+  std::vector<std::uint8_t> stack;
+};
+
+// Nothing holds the game still here: the plugin's vectored handler returns
+// EXCEPTION_CONTINUE_SEARCH right after signaling, so the process may already
+// be unwinding toward exit. This is read before the thin dump in both modes;
+// once the process is gone Toolhelp and ReadProcessMemory come back empty and
+// the key would fall back to an ASLR-dependent absolute address.
+FingerprintInputs CaptureFingerprintInputs(
+  const skydiag::helper::AttachedProcess& proc,
+  const skydiag::SharedLayout* dumpSnapshot,
+  const CrashEventInfo& info)
+{
+  FingerprintInputs inputs{};
+  if (info.exceptionAddr == 0) {
+    return inputs;
+  }
+  skydiag::helper::ScopedPerfTimer timer(skydiag::helper::PerfStage::kCrashFingerprint);
+  inputs.modules = CollectFingerprintModules(proc.pid);
+  const std::uint64_t rsp = dumpSnapshot ? dumpSnapshot->header.crash.context.Rsp : 0;
+  inputs.stack = ReadFaultingStack(proc.process, rsp);
+  return inputs;
+}
+
+// Module-relative offsets keep the key stable across ASLR.
+skydiag::helper::CrashFingerprint ComputeCaptureFingerprint(
+  const FingerprintInputs& inputs,
+  const CrashEventInfo& info)
+{
+  if (info.exceptionAddr == 0) {
+    return {};
+  }
+  const skydiag::helper::FingerprintModuleIndex modules(inputs.modules);
+  return skydiag::helper::ComputeCrashFingerprint(
+    info.exceptionCode,
+    info.exceptionAddr,
+    modules,
+    inputs.stack.empty() ? nullptr : inputs.stack.data(),
+    inputs.stack.size());
+}
+
+CrashLoopCapture EvaluateCrashLoop(
+  const skydiag::helper::HelperConfig& cfg,
+  const std::filesystem::path& outBase,
+  const CrashEventInfo& info,
+  const skydiag::helper::CrashFingerprint& fingerprint)
+{
+  CrashLoopCapture out{};
+  if (!cfg.enableCrashLoopBackoff) {
+    return out;
+  }
+  out.nowUnixSec = static_cast<std::uint64_t>(std::time(nullptr));
+  out.windowSec = cfg.crashLoopWindowSec;
+  if (fingerprint.key.empty()) {
+    return out;
+  }
+  // Only the fault part of the fingerprint: stack-scan frames are too noisy
+  // to decide whether two launches hit the same crash.
+  out.key = skydiag::helper::BuildCrashLoopKey(info.exceptionCode, fingerprint.faultModule, fingerprint.faultOffset);
+
+  skydiag::helper::CrashLoopHistory history{};
+  std::wstring err;
+  if (!LoadCrashLoopHistory(outBase, out.key, &history, &err)) {
+    // Unreadable history must never cost a rich capture.
+    AppendLogLine(outBase, L"Crash loop history unavailable; capturing normally: " + err);
+    out.key.clear();
+    return out;
+  }
+  skydiag::helper::CrashLoopLimits limits{};
+  limits.richCaptureLimit = cfg.crashLoopRichCaptureLimit;
+  limits.windowSec = out.windowSec;
+  out.decision = skydiag::helper::DecideCrashLoopCapture(history, out.nowUnixSec, limits);
+  if (out.decision.downgrade) {
+    AppendLogLine(
+      outBase,
+      L"Crash loop detected (key=" + std::wstring(out.key.begin(), out.key.end())
+        + L", rich_in_window=" + std::to_wstring(out.decision.richInWindow)
+        + L", thin_since_rich=" + std::to_wstring(out.decision.thinSinceRich)
+        + L", backoff=" + std::to_wstring(out.decision.backoffThinHits)
+        + L"); keeping a thin dump only.");
+  }
+  return out;
+}
+
+// Fingerprint, then the crash-loop decision keyed on it. The decision loads
+// the stats file, so HandleCrashEventTick runs this ahead of the dump only
+// when the decision picks the dump profile.
+CrashLoopCapture FingerprintAndEvaluateCrashLoop(
+  const skydiag::helper::HelperConfig& cfg,
+  const std::filesystem::path& outBase,
+  const FingerprintInputs& inputs,
+  const CrashEventInfo& info,
+  skydiag::helper::CrashFingerprint* fingerprint)
+{
+  *fingerprint = ComputeCaptureFingerprint(inputs, info);
+  if (!fingerprint->key.empty()) {
+    const std::string faultModule = fingerprint->faultModule.empty() ? "?" : fingerprint->faultModule;
+    AppendLogLine(
+      outBase,
+      L"Crash fingerprint: " + std::wstring(fingerprint->key.begin(), fingerprint->key.end())
+        + L" (fault_module=" + std::wstring(faultModule.begin(), faultModule.end())
+        + L", stack_frames=" + std::to_wstring(fingerprint->frames.size()) + L").");
+  }
+  return EvaluateCrashLoop(cfg, outBase, info, *fingerprint);
+}
+
+void RecordCrashLoopOutcome(const std::filesystem::path& outBase, const CrashLoopCapture& crashLoop)
+{
+  if (crashLoop.key.empty()) {
+    return;
+  }
+  std::wstring err;
+  if (!UpdateCrashLoopHistory(
+        outBase,
+        crashLoop.key,
+        /*richCapture=*/!crashLoop.decision.downgrade,
+        crashLoop.nowUnixSec,
+        crashLoop.windowSec,
+        nullptr,
+        &err)) {
+    AppendLogLine(outBase, L"Crash loop history update failed: " + err);
+  }
+}
+
+// Shared between the capture thread and the queued enrichment job.
+class CrashEnrichmentJobState {
+public:
+  void Finish(std::string status, bool written)
+  {
+    std::lock_guard lock(m_mutex);
+    m_status = std::move(status);
+    m_written = written;
+  }
+
+  std::string Status(bool* written) const
+  {
+    std::lock_guard lock(m_mutex);
+    if (written) {
+      *written = m_written;
+    }
+    return m_status;
+  }
+
+  // Set once the crash was filtered: a job that has not started skips the
+  // write, and one that is mid-write removes its file afterwards.
+  std::atomic<bool> discard{ false };
+
+private:
+  mutable std::mutex m_mutex;
+  std::string m_status = "queued";
+  bool m_written = false;
+};
+
+struct CrashEnrichmentOutcome {
+  bool twoPhase = false;
+  std::wstring dumpPath;  // planned path; empty unless the enrichment was queued
+  std::string status = "disabled";
+  skydiag::helper::PostProcessJobId job = skydiag::helper::kNoPostProcessJob;
+  std::shared_ptr<CrashEnrichmentJobState> state;
+};
+
+std::wstring CrashEnrichmentDumpPath(const std::wstring& dumpPath)
+{
+  const std::filesystem::path dumpFs(dumpPath);
+  return (dumpFs.parent_path() / (dumpFs.stem().wstring() + L"_Enriched.dmp")).wstring();
+}
+
+// Second phase: the thin dump already exists, so this is best-effort and is
+// not retried. The rich profile takes seconds to write, so the capture thread
+// only queues it. The job takes over the thin dump's copy of the shared
+// layout, so both dumps carry the same exception record and blackbox history
+// even after the helper thaws the crash freeze.
+CrashEnrichmentOutcome QueueCrashEnrichmentDump(
+  const skydiag::helper::HelperConfig& cfg,
+  const skydiag::helper::AttachedProcess& proc,
+  const std::filesystem::path& outBase,
+  const std::wstring& dumpPath,
+  StableSharedSnapshot snapshot,
+  const CrashLoopCapture& crashLoop)
+{
+  CrashEnrichmentOutcome outcome{};
+  if (crashLoop.decision.downgrade) {
+    // The thin profile was used regardless of EnableTwoPhaseCrashCapture.
+    outcome.twoPhase = true;
+    outcome.status = "crash_loop_backoff";
+    return outcome;
+  }
+  outcome.twoPhase = ShouldUseTwoPhaseCrashCapture(cfg);
+  if (!outcome.twoPhase) {
+    return outcome;
+  }
+  if (!IsProcessStillActive(proc.process)) {
+    outcome.status = "process_exited";
+    AppendLogLine(outBase, L"Crash enrichment skipped: the game process exited after the thin dump.");
+    return outcome;
+  }
+  auto state = std::make_shared<CrashEnrichmentJobState>();
+  auto ownedSnapshot = std::make_shared<StableSharedSnapshot>(std::move(snapshot));
+  const auto enrichedPath = CrashEnrichmentDumpPath(dumpPath);
+  const auto enrichedProfile = skydiag::helper::ResolveDumpProfile(
+    cfg.dumpMode,
+    skydiag::helper::CaptureKind::Crash,
+    cfg.dumpCompression);
+
+  skydiag::helper::PostProcessJob job{};
+  job.name = "crash_enrichment";
+  job.priority = skydiag::helper::PostProcessPriority::kCrash;
+  // The attached process handle stays open until after the workers are joined.
+  job.run = [state, ownedSnapshot, enrichedPath, enrichedProfile, outBase, process = proc.process, pid = proc.pid](
+              const skydiag::helper::PostProcessCancelFlag& cancel) {
+    if (cancel.load(std::memory_order_relaxed) || state->discard.load()) {
+      state->Finish("discarded", false);
+      return false;
+    }
+    if (!IsProcessStillActive(process)) {
+      state->Finish("process_exited", false);
+      AppendLogLine(outBase, L"Crash enrichment skipped: the game process exited after the thin dump.");
+      return false;
+    }
+    std::wstring err;
+    const bool written = skydiag::helper::WriteDumpWithStreams(
+      process,
+      pid,
+      enrichedPath,
+      ownedSnapshot->layout(),
+      ownedSnapshot->size(),
+      {},
+      {},
+      {},
+      true,
+      enrichedProfile,
+      /*isProcessSnapshot=*/false,
+      &err,
+      /*deltaBase=*/nullptr,
+      /*snapshotImmutable=*/true);
+    if (!written || state->discard.load()) {
+      std::error_code ec;
+      std::filesystem::remove(enrichedPath, ec);
+      state->Finish(written ? "discarded" : "failed", false);
+      if (!written) {
+        AppendLogLine(outBase, L"Crash enrichment dump failed; keeping the thin dump only: " + err);
+      }
+      return false;
+    }
+    state->Finish("written", true);
+    AppendLogLine(outBase, L"Crash enrichment dump written: " + enrichedPath);
+    return true;
+  };
+
+  outcome.job = EnqueuePostProcessJob(std::move(job));
+  if (outcome.job == skydiag::helper::kNoPostProcessJob) {
+    outcome.status = "failed";
+    AppendLogLine(outBase, L"Crash enrichment could not be queued; keeping the thin dump only.");
+    return outcome;
+  }
+  TrackDumpReaderJob(outBase, outcome.job);
+  outcome.dumpPath = enrichedPath;
+  outcome.status = "queued";
+  outcome.state = std::move(state);
+  AppendLogLine(outBase, L"Crash enrichment dump queued: " + enrichedPath);
+  return outcome;
+}
+
+// Records the enrichment's final status once its job has finished; the
+// manifest was written while it was still queued.
+void QueueCrashEnrichmentManifestUpdate(
+  const std::filesystem::path& outBase,
+  const std::filesystem::path& manifestPath,
+  const CrashEnrichmentOutcome& enrichment)
+{
+  if (enrichment.job == skydiag::helper::kNoPostProcessJob || !enrichment.state) {
+    return;
+  }
+  skydiag::helper::PostProcessJob job{};
+  job.name = "crash_enrichment_manifest";
+  job.priority = skydiag::helper::PostProcessPriority::kCrash;
+  job.dependsOn.push_back(enrichment.job);
+  job.run = [state = enrichment.state, enrichedPath = std::filesystem::path(enrichment.dumpPath), manifestPath, outBase](
+              const skydiag::helper::PostProcessCancelFlag&) {
+    bool written = false;
+    const auto status = state->Status(&written);
+    std::wstring err;
+    if (!TryUpdateIncidentManifestCrashEnrichment(
+          manifestPath, written ? enrichedPath : std::filesystem::path{}, status, &err)) {
+      AppendLogLine(outBase, L"Incident manifest enrichment update failed: " + err);
+      return false;
+    }
+    return true;
+  };
+  EnqueuePostProcessJob(std::move(job));
+}
+
+// A filtered crash keeps no enrichment. The job may still be queued or
+// mid-write, so removal is queued behind it.
+void DiscardCrashEnrichment(const std::filesystem::path& outBase, const CrashEnrichmentOutcome& enrichment)
+{
+  if (enrichment.job == skydiag::helper::kNoPostProcessJob || !enrichment.state) {
+    return;
+  }
+  enrichment.state->discard.store(true);
+  skydiag::helper::PostProcessJob job{};
+  job.name = "crash_enrichment_discard";
+  job.priority = skydiag::helper::PostProcessPriority::kCrash;
+  job.dependsOn.push_back(enrichment.job);
+  job.run = [enrichedPath = std::filesystem::path(enrichment.dumpPath), outBase](
+              const skydiag::helper::PostProcessCancelFlag&) {
+    std::error_code ec;
+    std::filesystem::remove(enrichedPath, ec);
+    if (std::filesystem::exists(enrichedPath, ec)) {
+      AppendLogLine(outBase, L"Filtered crash enrichment dump removal failed: " + enrichedPath.wstring());
+      return false;
+    }
+    return true;
+  };
+  EnqueuePostProcessJob(std::move(job));
+}
+
 struct FileRemovalObservation {
   bool existedBefore = false;
   bool existsAfter = false;
@@ -147,39 +542,6 @@ bool CopyStableSeqlockEntry(const Entry* source, Entry* destination) noexcept
   return false;
 }
 
-bool TryCaptureDumpIdentity(
-  const std::filesystem::path& dumpPath,
-  CleanExitDumpIdentity* out) noexcept
-{
-  if (out) {
-    *out = CleanExitDumpIdentity{};
-  }
-  if (!out || dumpPath.empty()) {
-    return false;
-  }
-
-  WIN32_FILE_ATTRIBUTE_DATA attributes{};
-  if (!GetFileAttributesExW(
-        dumpPath.c_str(),
-        GetFileExInfoStandard,
-        &attributes)) {
-    return false;
-  }
-
-  ULARGE_INTEGER size{};
-  size.HighPart = attributes.nFileSizeHigh;
-  size.LowPart = attributes.nFileSizeLow;
-  ULARGE_INTEGER lastWrite{};
-  lastWrite.HighPart = attributes.ftLastWriteTime.dwHighDateTime;
-  lastWrite.LowPart = attributes.ftLastWriteTime.dwLowDateTime;
-
-  out->valid = true;
-  out->filename = dumpPath.filename().wstring();
-  out->sizeBytes = size.QuadPart;
-  out->lastWriteTimeUtc100ns = lastWrite.QuadPart;
-  return true;
-}
-
 const char* CleanExitDumpStateId(CleanExitDumpState state) noexcept
 {
   switch (state) {
@@ -500,6 +862,9 @@ void ProcessValidCrashDump(
   const std::wstring& dumpPath,
   const std::wstring& ts,
   const CrashEventInfo& info,
+  const CrashEnrichmentOutcome& enrichment,
+  const CrashLoopCapture& crashLoop,
+  const skydiag::helper::CrashFingerprint& fingerprint,
   PendingCrashEtwCapture* pendingCrashEtw,
   PendingCrashAnalysis* pendingCrashAnalysis,
   std::wstring* pendingCrashViewerDumpPath)
@@ -510,9 +875,15 @@ void ProcessValidCrashDump(
 
   std::wcout << L"[SkyrimDiagHelper] Crash dump written: " << dumpPath << L"\n";
 
-  {
+  // Backoff keeps the dump and the counter; everything that costs minutes of
+  // I/O or pops UI for a fault we already have is skipped.
+  const bool crashLoopThin = crashLoop.decision.downgrade;
+
+  if (!crashLoopThin) {
     const std::string pluginScanJson = CollectPluginScanJson(proc, outBase);
     if (!pluginScanJson.empty()) {
+      // Named after the thin dump; the analyzer falls back to it from an
+      // _Enriched dump, which may not exist yet.
       const auto pluginScanPath = dumpFs.parent_path() / (dumpFs.stem().wstring() + L"_PluginScan.json");
       WriteTextFileUtf8(pluginScanPath, pluginScanJson);
       AppendLogLine(outBase, L"Plugin scan sidecar written: " + pluginScanPath.wstring());
@@ -520,8 +891,9 @@ void ProcessValidCrashDump(
   }
 
   bool etwStarted = false;
-  std::string etwStatus = cfg.enableEtwCaptureOnCrash ? "start_failed" : "disabled";
-  if (cfg.enableEtwCaptureOnCrash && pendingCrashEtw && !pendingCrashEtw->active) {
+  std::string etwStatus =
+    cfg.enableEtwCaptureOnCrash ? (crashLoopThin ? "crash_loop_backoff" : "start_failed") : "disabled";
+  if (cfg.enableEtwCaptureOnCrash && !crashLoopThin && pendingCrashEtw && !pendingCrashEtw->active) {
     const std::wstring effectiveProfile = cfg.etwCrashProfile.empty() ? L"GeneralProfile" : cfg.etwCrashProfile;
     std::wstring etwErr;
     if (StartEtwCaptureWithProfile(cfg, outBase, effectiveProfile, &etwErr)) {
@@ -552,10 +924,18 @@ void ProcessValidCrashDump(
   if (cfg.enableIncidentManifest) {
     nlohmann::json ctx = nlohmann::json::object();
     ctx["reason"] = "crash_event";
+    if (!crashLoop.key.empty()) {
+      ctx["crash_loop_key"] = crashLoop.key;
+      ctx["crash_loop_backoff"] = crashLoopThin;
+      ctx["crash_loop_rich_in_window"] = crashLoop.decision.richInWindow;
+      ctx["crash_loop_thin_since_rich"] = crashLoop.decision.thinSinceRich;
+      ctx["crash_loop_backoff_thin_hits"] = crashLoop.decision.backoffThinHits;
+    }
     const auto dumpProfile = skydiag::helper::ResolveDumpProfile(
       cfg.dumpMode,
-      skydiag::helper::CaptureKind::Crash);
-    const auto manifest = MakeIncidentManifestV1(
+      enrichment.twoPhase ? skydiag::helper::CaptureKind::CrashThin : skydiag::helper::CaptureKind::Crash,
+      cfg.dumpCompression);
+    auto manifest = MakeIncidentManifestV1(
       "crash",
       ts,
       proc.pid,
@@ -569,14 +949,36 @@ void ProcessValidCrashDump(
       /*recaptureDecision=*/nullptr,
       cfg,
       cfg.incidentManifestIncludeConfigSnapshot);
+    if (enrichment.twoPhase) {
+      const auto enrichedProfile = skydiag::helper::ResolveDumpProfile(
+        cfg.dumpMode,
+        skydiag::helper::CaptureKind::Crash,
+        cfg.dumpCompression);
+      // A queued enrichment is recorded as it stands now and rewritten by
+      // QueueCrashEnrichmentManifestUpdate once its job has finished.
+      bool enrichedWritten = false;
+      const std::string enrichmentStatus =
+        enrichment.state ? enrichment.state->Status(&enrichedWritten) : enrichment.status;
+      AddIncidentManifestCrashEnrichment(
+        manifest,
+        enrichedWritten ? std::filesystem::path(enrichment.dumpPath) : std::filesystem::path{},
+        enrichmentStatus,
+        &enrichedProfile);
+    }
+    if (!fingerprint.key.empty()) {
+      // DumpTool checks this against its own stackwalk bucket.
+      manifest["helper_fingerprint"] = skydiag::helper::CrashFingerprintToJson(fingerprint);
+    }
     WriteTextFileUtf8(manifestPath, manifest.dump(2));
     AppendLogLine(outBase, L"Incident manifest written: " + manifestPath.wstring());
+    QueueCrashEnrichmentManifestUpdate(outBase, manifestPath, enrichment);
   }
 
   bool crashAnalysisQueued = false;
-  if (cfg.autoAnalyzeDump && cfg.enableAutoRecaptureOnUnknownCrash) {
+  if (cfg.autoAnalyzeDump && cfg.enableAutoRecaptureOnUnknownCrash && !crashLoopThin) {
     std::wstring analyzeQueueErr;
-    if (StartPendingCrashAnalysisTask(cfg, dumpPath, outBase, pendingCrashAnalysis, &analyzeQueueErr)) {
+    if (StartPendingCrashAnalysisTask(
+          cfg, dumpPath, outBase, pendingCrashAnalysis, &analyzeQueueErr, /*launchAfter=*/enrichment.job)) {
       crashAnalysisQueued = true;
       AppendLogLine(outBase, L"Crash headless analysis queued for unknown-bucket recapture policy.");
     } else {
@@ -584,10 +986,13 @@ void ProcessValidCrashDump(
     }
   }
 
+  // The viewer does not wait for the enrichment; it opens whichever dump is
+  // complete at launch time.
   bool viewerNow = false;
-  if (cfg.autoOpenViewerOnCrash) {
+  if (cfg.autoOpenViewerOnCrash && !crashLoopThin) {
     if (!cfg.autoOpenCrashOnlyIfProcessExited) {
-      const auto launch = StartDumpToolViewer(cfg, dumpPath, outBase, L"crash");
+      const auto launch =
+        StartDumpToolViewer(cfg, ResolveCrashAnalysisDumpPath(dumpPath, enrichment.job), outBase, L"crash");
       viewerNow = (launch == DumpToolViewerLaunchResult::kLaunched);
     } else if (proc.process) {
       const DWORD waitExitMs = static_cast<DWORD>(std::min<std::uint32_t>(cfg.autoOpenCrashWaitForExitMs, 10000u));
@@ -607,7 +1012,8 @@ void ProcessValidCrashDump(
               + dumpFs.filename().wstring()
               + L").");
         } else {
-          const auto launch = StartDumpToolViewer(cfg, dumpPath, outBase, L"crash_exit");
+          const auto viewerDumpPath = ResolveCrashAnalysisDumpPath(dumpPath, enrichment.job);
+          const auto launch = StartDumpToolViewer(cfg, viewerDumpPath, outBase, L"crash_exit");
           viewerNow = (launch == DumpToolViewerLaunchResult::kLaunched);
           if (viewerNow) {
             AppendLogLine(
@@ -615,7 +1021,7 @@ void ProcessValidCrashDump(
               L"Auto-opened DumpTool viewer for crash after process exit during wait window (wait_ms="
                 + std::to_wstring(waitExitMs)
                 + L", dump="
-                + dumpFs.filename().wstring()
+                + std::filesystem::path(viewerDumpPath).filename().wstring()
                 + L").");
           } else {
             AppendLogLine(
@@ -623,7 +1029,7 @@ void ProcessValidCrashDump(
               L"Crash viewer auto-open attempt failed after process exit during wait window (wait_ms="
                 + std::to_wstring(waitExitMs)
                 + L", dump="
-                + dumpFs.filename().wstring()
+                + std::filesystem::path(viewerDumpPath).filename().wstring()
                 + L").");
           }
         }
@@ -654,10 +1060,11 @@ void ProcessValidCrashDump(
     }
   }
 
-  if (!crashAnalysisQueued) {
+  if (!crashAnalysisQueued && !crashLoopThin) {
     if (ShouldRunHeadlessDumpAnalysis(cfg, viewerNow, false)) {
       std::wstring analyzeQueueErr;
-      if (StartPendingCrashAnalysisTask(cfg, dumpPath, outBase, pendingCrashAnalysis, &analyzeQueueErr)) {
+      if (StartPendingCrashAnalysisTask(
+          cfg, dumpPath, outBase, pendingCrashAnalysis, &analyzeQueueErr, /*launchAfter=*/enrichment.job)) {
         crashAnalysisQueued = true;
         AppendLogLine(outBase, L"Crash headless analysis queued with tracked process lifetime.");
       } else {
@@ -668,11 +1075,59 @@ void ProcessValidCrashDump(
     }
   }
 
+  // The sweep waits for the enrichment write and the analyzer, both tracked
+  // as dump readers, so it cannot prune the dump or its sidecars under them.
   ApplyRetentionFromConfig(cfg, outBase);
 }
 
 }
 
+std::wstring ResolveCrashAnalysisDumpPath(
+  const std::wstring& thinDumpPath,
+  skydiag::helper::PostProcessJobId enrichmentJob)
+{
+  if (enrichmentJob == skydiag::helper::kNoPostProcessJob || !IsPostProcessJobFinished(enrichmentJob)) {
+    return thinDumpPath;
+  }
+  // A failed or discarded enrichment removes its file.
+  const auto enrichedPath = CrashEnrichmentDumpPath(thinDumpPath);
+  std::error_code ec;
+  return std::filesystem::is_regular_file(enrichedPath, ec) ? enrichedPath : thinDumpPath;
+}
+
+bool TryCaptureDumpIdentity(
+  const std::filesystem::path& dumpPath,
+  CleanExitDumpIdentity* out) noexcept
+{
+  if (out) {
+    *out = CleanExitDumpIdentity{};
+  }
+  if (!out || dumpPath.empty()) {
+    return false;
+  }
+
+  WIN32_FILE_ATTRIBUTE_DATA attributes{};
+  if (!GetFileAttributesExW(
+        dumpPath.c_str(),
+        GetFileExInfoStandard,
+        &attributes)) {
+    return false;
+  }
+
+  ULARGE_INTEGER size{};
+  size.HighPart = attributes.nFileSizeHigh;
+  size.LowPart = attributes.nFileSizeLow;
+  ULARGE_INTEGER lastWrite{};
+  lastWrite.HighPart = attributes.ftLastWriteTime.dwHighDateTime;
+  lastWrite.LowPart = attributes.ftLastWriteTime.dwLowDateTime;
+
+  out->valid = true;
+  out->filename = dumpPath.filename().wstring();
+  out->sizeBytes = size.QuadPart;
+  out->lastWriteTimeUtc100ns = lastWrite.QuadPart;
+  return true;
+}
+
 bool IsCleanExitEvidenceRequired(
   const skydiag::helper::HelperConfig& cfg,
   const CrashCaptureState* crashState) noexcept
@@ -743,15 +1198,10 @@ void StableSharedSnapshot::AlignedByteDeleter::operator()(std::byte* ptr) const
   }
 }
 
-bool CaptureStableSharedSnapshot(
-  const skydiag::SharedLayout* shm,
-  std::size_t shmBytes,
-  StableSharedSnapshot* out) noexcept
-{
-  if (!shm || !out || shmBytes < sizeof(skydiag::SharedLayout)) {
-    return false;
-  }
+namespace {
 
+bool AllocateSnapshotStorage(StableSharedSnapshot* out) noexcept
+{
   out->storage.reset();
   out->byteSize = 0;
   constexpr std::size_t kSnapshotAlignment = alignof(skydiag::SharedLayout);
@@ -766,6 +1216,23 @@ bool CaptureStableSharedSnapshot(
     rawStorage,
     StableSharedSnapshot::AlignedByteDeleter{kSnapshotAlignment});
   out->byteSize = sizeof(skydiag::SharedLayout);
+  return true;
+}
+
+}  // namespace
+
+bool CaptureStableSharedSnapshot(
+  const skydiag::SharedLayout* shm,
+  std::size_t shmBytes,
+  StableSharedSnapshot* out) noexcept
+{
+  if (!shm || !out || shmBytes < sizeof(skydiag::SharedLayout)) {
+    return false;
+  }
+
+  if (!AllocateSnapshotStorage(out)) {
+    return false;
+  }
 
   for (int attempt = 0; attempt < kStableSnapshotAttempts; ++attempt) {
     const std::uint32_t before = ReadCrashSequence(&shm->header);
@@ -809,6 +1276,94 @@ bool CaptureStableSharedSnapshot(
   return false;
 }
 
+namespace {
+
+std::uint32_t ReadSharedU32(const volatile std::uint32_t* value) noexcept
+{
+  auto* const word = reinterpret_cast<volatile LONG*>(const_cast<volatile std::uint32_t*>(value));
+  return static_cast<std::uint32_t>(InterlockedCompareExchange(word, 0, 0));
+}
+
+bool IsFrozenCrashState(const skydiag::SharedHeader& header, std::uint32_t crashSeq) noexcept
+{
+  const auto flags = ReadSharedU32(&header.state_flags);
+  return (flags & skydiag::kState_Frozen) != 0u && crashSeq != 0u && (crashSeq & 1u) == 0u;
+}
+
+}  // namespace
+
+bool TryBorrowFrozenSharedView(
+  const skydiag::SharedLayout* shm,
+  std::size_t shmBytes,
+  FrozenSharedView* out) noexcept
+{
+  if (!shm || !out || shmBytes < sizeof(skydiag::SharedLayout)) {
+    return false;
+  }
+  *out = FrozenSharedView{};
+
+  const std::uint32_t crashSeq = ReadCrashSequence(&shm->header);
+  if (!IsFrozenCrashState(shm->header, crashSeq)) {
+    return false;
+  }
+  const std::uint32_t eventCapacity = shm->header.capacity;
+  if (eventCapacity == 0u || eventCapacity > skydiag::kEventCapacity) {
+    return false;
+  }
+
+  const std::uint32_t eventWriteIndex = ReadSharedU32(&shm->header.write_index);
+  const std::uint32_t resourceWriteIndex = ReadSharedU32(&shm->resources.write_index);
+  if (!skydiag::helper::IsSeqlockRingQuiescent(shm->events, eventCapacity, eventWriteIndex) ||
+      !skydiag::helper::IsSeqlockRingQuiescent(
+        shm->resources.entries,
+        skydiag::kResourceCapacity,
+        resourceWriteIndex)) {
+    return false;
+  }
+  MemoryBarrier();
+
+  FrozenSharedView view{};
+  view.layout = shm;
+  view.byteSize = sizeof(skydiag::SharedLayout);
+  view.crashSeq = crashSeq;
+  view.eventWriteIndex = eventWriteIndex;
+  view.resourceWriteIndex = resourceWriteIndex;
+  if (!IsFrozenSharedViewUnchanged(view)) {
+    return false;
+  }
+  *out = view;
+  return true;
+}
+
+bool IsFrozenSharedViewUnchanged(const FrozenSharedView& view) noexcept
+{
+  if (!view.layout) {
+    return false;
+  }
+  const auto& shm = *view.layout;
+  return ReadCrashSequence(&shm.header) == view.crashSeq &&
+         IsFrozenCrashState(shm.header, view.crashSeq) &&
+         ReadSharedU32(&shm.header.write_index) == view.eventWriteIndex &&
+         ReadSharedU32(&shm.resources.write_index) == view.resourceWriteIndex;
+}
+
+bool TryCopyFrozenSharedView(const FrozenSharedView& view, StableSharedSnapshot* out) noexcept
+{
+  if (!view.layout || !out || !AllocateSnapshotStorage(out)) {
+    return false;
+  }
+  std::memcpy(out->storage.get(), view.layout, sizeof(skydiag::SharedLayout));
+  MemoryBarrier();
+  // Quiescent at borrow time means every claimed slot was committed, so only
+  // a slot claimed during the copy could be torn; that moves a write index.
+  if (!IsFrozenSharedViewUnchanged(view) || out->layout()->header.crash_seq != view.crashSeq) {
+    out->storage.reset();
+    out->byteSize = 0;
+    return false;
+  }
+  return true;
+}
+
 bool TryClearRecoveredCrashFreeze(
   skydiag::SharedLayout* shm,
   std::uint32_t expectedCrashSeq) noexcept
@@ -963,6 +1518,7 @@ bool HandleCrashEventTick(
     return false;
   }
 
+  const skydiag::helper::ScopedPerfTimer perfTimer(skydiag::helper::PerfStage::kCrashEvent);
   if (!ResetEvent(proc.crashEvent)) {
     AppendLogLine(outBase, L"Failed to reset crash event: " + std::to_wstring(GetLastError()));
   }
@@ -972,11 +1528,18 @@ bool HandleCrashEventTick(
     return true;
   }
 
+  // The thin dump is written from a copy, never from the live mapping: the
+  // crashing thread's own kCrash event (PushEventAlways) and writers that
+  // raced the freeze can still land while it is being written. A quiescent
+  // frozen record is copied in one pass, anything else entry by entry.
+  FrozenSharedView frozenView{};
   StableSharedSnapshot stableSnapshot{};
-  const skydiag::SharedLayout* dumpSnapshot = nullptr;
-  std::size_t dumpSnapshotBytes = 0;
   if (proc.shm) {
-    if (!CaptureStableSharedSnapshot(proc.shm, proc.shmSize, &stableSnapshot)) {
+    const bool copied =
+      (TryBorrowFrozenSharedView(proc.shm, proc.shmSize, &frozenView) &&
+       TryCopyFrozenSharedView(frozenView, &stableSnapshot)) ||
+      CaptureStableSharedSnapshot(proc.shm, proc.shmSize, &stableSnapshot);
+    if (!copied) {
       const bool processStillActive =
         proc.process && WaitForSingleObject(proc.process, 0) == WAIT_TIMEOUT;
       AppendLogLine(
@@ -989,9 +1552,9 @@ bool HandleCrashEventTick(
       }
       return false;
     }
-    dumpSnapshot = stableSnapshot.layout();
-    dumpSnapshotBytes = stableSnapshot.size();
   }
+  const skydiag::SharedLayout* dumpSnapshot = stableSnapshot.layout();
+  const std::size_t dumpSnapshotBytes = stableSnapshot.size();
 
   const auto info = ExtractCrashInfo(dumpSnapshot ? &dumpSnapshot->header : nullptr);
   if (!IsCommittedCrashSequence(info.crashSeq)) {
@@ -1008,6 +1571,7 @@ bool HandleCrashEventTick(
     crashState->cleanExitEvidencePath.clear();
     crashState->cleanExitDumpIdentity = CleanExitDumpIdentity{};
     crashState->cleanExitFilterContext.clear();
+    crashState->enrichmentJob = skydiag::helper::kNoPostProcessJob;
   }
   AppendLogLine(
     outBase,
@@ -1017,11 +1581,29 @@ bool HandleCrashEventTick(
       + L", crash_seq=" + std::to_wstring(info.crashSeq)
       + L").");
 
+  // The fingerprint's module list and stack are read from the live process
+  // before any dump. With two-phase capture the thin profile is used either
+  // way and the crash-loop decision only gates the enrichment, so the stats
+  // file is not touched before the thin dump is on disk.
+  const bool twoPhase = ShouldUseTwoPhaseCrashCapture(cfg);
+  const auto fingerprintInputs = CaptureFingerprintInputs(proc, dumpSnapshot, info);
+  skydiag::helper::CrashFingerprint fingerprint{};
+  CrashLoopCapture crashLoop{};
+  if (!twoPhase) {
+    crashLoop = FingerprintAndEvaluateCrashLoop(cfg, outBase, fingerprintInputs, info, &fingerprint);
+  }
+
   const auto ts = Timestamp();
   const auto dumpPath = (outBase / (L"SkyrimDiag_Crash_" + ts + L".dmp")).wstring();
+  // Phase one is kept small so evidence lands before the faulting process
+  // exits; the DumpMode-rich dump follows as a sidecar. A crash loop in
+  // backoff keeps the thin dump only.
   const auto dumpProfile = skydiag::helper::ResolveDumpProfile(
     cfg.dumpMode,
-    skydiag::helper::CaptureKind::Crash);
+    (twoPhase || crashLoop.decision.downgrade)
+      ? skydiag::helper::CaptureKind::CrashThin
+      : skydiag::helper::CaptureKind::Crash,
+    cfg.dumpCompression);
   if (pendingHangViewerDumpPath) {
     pendingHangViewerDumpPath->clear();
   }
@@ -1059,10 +1641,13 @@ bool HandleCrashEventTick(
       dumpSnapshotBytes,
       {},
       {},
+      {},
       true,
       dumpProfile,
       /*isProcessSnapshot=*/false,
-      &dumpErr);
+      &dumpErr,
+      /*deltaBase=*/nullptr,
+      /*snapshotImmutable=*/true);
     if (dumpOk) {
       if (attempt > 0) {
         AppendLogLine(
@@ -1115,6 +1700,24 @@ bool HandleCrashEventTick(
     *lastCrashDumpPath = dumpPath;
   }
 
+  if (twoPhase) {
+    crashLoop = FingerprintAndEvaluateCrashLoop(cfg, outBase, fingerprintInputs, info, &fingerprint);
+  }
+
+  // Queue the enrichment before filtering: the filters wait on heartbeats for
+  // seconds, and a real CTD is usually gone by then. The thin dump's copy
+  // moves into the job, so `dumpSnapshot` is not used past this point.
+  const auto enrichment = QueueCrashEnrichmentDump(
+    cfg,
+    proc,
+    outBase,
+    dumpPath,
+    std::move(stableSnapshot),
+    crashLoop);
+  if (crashState) {
+    crashState->enrichmentJob = enrichment.job;
+  }
+
   auto verdict = FilterVerdict::kKeepDump;
   if (proc.process) {
     verdict = FilterShutdownException(
@@ -1201,6 +1804,9 @@ bool HandleCrashEventTick(
           }
         }
       }
+      if (!preserveFilteredDump) {
+        DiscardCrashEnrichment(outBase, enrichment);
+      }
       if (preserveFilteredDump) {
         AppendLogLine(
           outBase,
@@ -1232,6 +1838,7 @@ bool HandleCrashEventTick(
     }
   }
 
+  RecordCrashLoopOutcome(outBase, crashLoop);
   ProcessValidCrashDump(
     cfg,
     proc,
@@ -1239,6 +1846,9 @@ bool HandleCrashEventTick(
     dumpPath,
     ts,
     info,
+    enrichment,
+    crashLoop,
+    fingerprint,
     pendingCrashEtw,
     pendingCrashAnalysis,
     pendingCrashViewerDumpPath);
@@ -15,6 +15,7 @@ using DWORD = std::uint32_t;
 #include <string_view>
 
 #include "SkyrimDiagCrashCodes.h"
+#include "SkyrimDiagHelper/PostProcessQueue.h"
 
 namespace skydiag {
 struct SharedHeader;
@@ -67,6 +68,8 @@ struct CrashCaptureState {
   std::filesystem::path cleanExitEvidencePath;
   CleanExitDumpIdentity cleanExitDumpIdentity{};
   std::wstring cleanExitFilterContext;
+  // Queued two-phase enrichment of the captured dump, if any.
+  skydiag::helper::PostProcessJobId enrichmentJob = skydiag::helper::kNoPostProcessJob;
 };
 
 struct StableSharedSnapshot {
@@ -84,6 +87,18 @@ struct StableSharedSnapshot {
   std::size_t size() const noexcept;
 };
 
+// The mapped view, borrowed while the plugin holds the crash record frozen
+// and both rings are quiescent. Writers that raced the freeze and the crash
+// handler's own PushEventAlways can still land, so dumps never stream it in
+// place: TryCopyFrozenSharedView copies it in one pass and re-validates.
+struct FrozenSharedView {
+  const skydiag::SharedLayout* layout = nullptr;
+  std::size_t byteSize = 0;
+  std::uint32_t crashSeq = 0;
+  std::uint32_t eventWriteIndex = 0;
+  std::uint32_t resourceWriteIndex = 0;
+};
+
 enum class FilterVerdict {
   kKeepDump,
   kDeleteBenign,
@@ -200,6 +215,14 @@ inline bool ShouldQuarantineCleanExitEvidence(
 }
 
 CrashEventInfo ExtractCrashInfo(const skydiag::SharedHeader* shm) noexcept;
+// The `_Enriched` sibling once `enrichmentJob` has finished and left it on
+// disk; otherwise the thin dump itself.
+std::wstring ResolveCrashAnalysisDumpPath(
+  const std::wstring& thinDumpPath,
+  skydiag::helper::PostProcessJobId enrichmentJob);
+bool TryCaptureDumpIdentity(
+  const std::filesystem::path& dumpPath,
+  CleanExitDumpIdentity* out) noexcept;
 bool TryCaptureCommittedCrashInfo(
   const skydiag::SharedHeader* shm,
   CrashEventInfo* out) noexcept;
@@ -211,6 +234,16 @@ bool CaptureStableSharedSnapshot(
   const skydiag::SharedLayout* shm,
   std::size_t shmBytes,
   StableSharedSnapshot* out) noexcept;
+bool TryBorrowFrozenSharedView(
+  const skydiag::SharedLayout* shm,
+  std::size_t shmBytes,
+  FrozenSharedView* out) noexcept;
+// False once a writer slipped in after the view was borrowed.
+bool IsFrozenSharedViewUnchanged(const FrozenSharedView& view) noexcept;
+// One-pass copy of a borrowed view; false (and `out` empty) when a writer
+// claimed a slot while it ran, in which case CaptureStableSharedSnapshot
+// copies entry by entry.
+bool TryCopyFrozenSharedView(const FrozenSharedView& view, StableSharedSnapshot* out) noexcept;
 bool TryClearRecoveredCrashFreeze(
   skydiag::SharedLayout* shm,
   std::uint32_t expectedCrashSeq) noexcept;
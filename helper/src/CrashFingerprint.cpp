@@ -0,0 +1,138 @@
+#include "SkyrimDiagHelper/CrashFingerprint.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace skydiag::helper {
+namespace {
+
+std::uint64_t Fnv1a64(std::string_view s)
+{
+  std::uint64_t h = 14695981039346656037ull;
+  for (const unsigned char c : s) {
+    h ^= c;
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+std::string Hex(std::uint64_t v)
+{
+  char buf[24]{};
+  std::snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(v));
+  return buf;
+}
+
+}  // namespace
+
+FingerprintModuleIndex::FingerprintModuleIndex(std::vector<FingerprintModule> modules)
+  : m_modules(std::move(modules))
+{
+  m_modules.erase(
+    std::remove_if(m_modules.begin(), m_modules.end(), [](const FingerprintModule& m) {
+      return m.size == 0 || m.base > UINT64_MAX - m.size;
+    }),
+    m_modules.end());
+  std::sort(m_modules.begin(), m_modules.end(), [](const FingerprintModule& a, const FingerprintModule& b) {
+    return a.base < b.base;
+  });
+
+  std::vector<FingerprintModule> disjoint;
+  disjoint.reserve(m_modules.size());
+  for (auto& m : m_modules) {
+    if (!disjoint.empty() && m.base < disjoint.back().base + disjoint.back().size) {
+      continue;
+    }
+    disjoint.push_back(std::move(m));
+  }
+  m_modules = std::move(disjoint);
+}
+
+const FingerprintModule* FingerprintModuleIndex::Find(std::uint64_t addr) const
+{
+  auto it = std::upper_bound(m_modules.begin(), m_modules.end(), addr, [](std::uint64_t a, const FingerprintModule& m) {
+    return a < m.base;
+  });
+  if (it == m_modules.begin()) {
+    return nullptr;
+  }
+  --it;
+  return (addr - it->base < it->size) ? &*it : nullptr;
+}
+
+CrashFingerprint ComputeCrashFingerprint(
+  std::uint32_t exceptionCode,
+  std::uint64_t faultAddr,
+  const FingerprintModuleIndex& modules,
+  const std::uint8_t* stackBytes,
+  std::size_t stackSize,
+  std::size_t maxFrames)
+{
+  CrashFingerprint fp{};
+  fp.exceptionCode = exceptionCode;
+  if (exceptionCode == 0 && faultAddr == 0) {
+    return fp;
+  }
+
+  if (const auto* m = modules.Find(faultAddr)) {
+    fp.faultModule = m->nameLower;
+    fp.faultOffset = faultAddr - m->base;
+  } else {
+    fp.faultOffset = faultAddr;
+  }
+
+  // Stack scan: any qword that lands inside a module is a return-address
+  // candidate. Repeats of the previous candidate are skipped so a spilled
+  // copy of the same pointer does not fill the frame budget.
+  if (stackBytes) {
+    const std::size_t scanBytes = std::min(stackSize, kCrashFingerprintStackScanBytes) & ~std::size_t{ 7 };
+    fp.scannedBytes = static_cast<std::uint32_t>(scanBytes);
+    std::uint64_t previous = faultAddr;
+    for (std::size_t pos = 0; pos < scanBytes && fp.frames.size() < maxFrames; pos += 8) {
+      std::uint64_t value = 0;
+      std::memcpy(&value, stackBytes + pos, sizeof(value));
+      if (value == previous) {
+        continue;
+      }
+      const auto* m = modules.Find(value);
+      if (!m) {
+        continue;
+      }
+      fp.frames.push_back({ m->nameLower, value - m->base });
+      previous = value;
+    }
+  }
+
+  std::string canonical = "v=1|exc=" + Hex(exceptionCode) + "|mod=" + fp.faultModule + "|off=" + Hex(fp.faultOffset);
+  for (std::size_t i = 0; i < fp.frames.size(); ++i) {
+    canonical += "|f" + std::to_string(i) + "=" + fp.frames[i].module + "+" + Hex(fp.frames[i].offset);
+  }
+  char key[32]{};
+  std::snprintf(key, sizeof(key), "HFP1-%016llx", static_cast<unsigned long long>(Fnv1a64(canonical)));
+  fp.key = key;
+  return fp;
+}
+
+nlohmann::json CrashFingerprintToJson(const CrashFingerprint& fingerprint)
+{
+  nlohmann::json frames = nlohmann::json::array();
+  for (const auto& f : fingerprint.frames) {
+    frames.push_back(f.module + "+" + Hex(f.offset));
+  }
+  return nlohmann::json{
+    { "version", kCrashFingerprintVersion },
+    { "key", fingerprint.key },
+    { "exception_code", fingerprint.exceptionCode },
+    { "fault_module", fingerprint.faultModule },
+    { "fault_offset", fingerprint.faultOffset },
+    { "stack_frames", std::move(frames) },
+    { "stack_scanned_bytes", fingerprint.scannedBytes },
+  };
+}
+
+}  // namespace skydiag::helper
@@ -0,0 +1,202 @@
+#include "SkyrimDiagHelper/DumpDelta.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+namespace skydiag::helper {
+namespace {
+
+// Minidump on-disk layout (little-endian, 4-byte packed).
+constexpr std::uint32_t kMinidumpSignature = 0x504D444Du;  // "MDMP"
+constexpr std::uint32_t kThreadListStream = 3;
+constexpr std::uint32_t kMemoryListStream = 5;
+constexpr std::uint32_t kMemory64ListStream = 9;
+constexpr std::size_t kHeaderBytes = 32;
+constexpr std::size_t kDirectoryEntryBytes = 12;
+constexpr std::size_t kThreadBytes = 48;
+constexpr std::size_t kThreadStackOffset = 24;
+constexpr std::size_t kMemoryDescriptorBytes = 16;
+constexpr std::size_t kMemoryDescriptor64Bytes = 16;
+constexpr std::uint32_t kMaxListEntries = 1u << 22;
+constexpr std::uint64_t kMaxCallbackRangeBytes = 0x80000000ull;
+
+template <typename T>
+T LoadLe(const std::uint8_t* p)
+{
+  T value{};
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+class DumpFileReader {
+public:
+  explicit DumpFileReader(const std::filesystem::path& path) : m_file(path, std::ios::binary) {}
+
+  bool IsOpen() const { return static_cast<bool>(m_file); }
+
+  bool Read(std::uint64_t offset, std::size_t size, std::vector<std::uint8_t>* out)
+  {
+    out->resize(size);
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(offset));
+    m_file.read(reinterpret_cast<char*>(out->data()), static_cast<std::streamsize>(size));
+    return static_cast<std::size_t>(m_file.gcount()) == size;
+  }
+
+private:
+  std::ifstream m_file;
+};
+
+void SetError(std::string* err, const char* message)
+{
+  if (err) {
+    *err = message;
+  }
+}
+
+}  // namespace
+
+std::vector<MemoryRange> CoalesceMemoryRanges(std::vector<MemoryRange> ranges)
+{
+  ranges.erase(
+    std::remove_if(ranges.begin(), ranges.end(), [](const MemoryRange& r) {
+      return r.size == 0 || r.base > UINT64_MAX - r.size;
+    }),
+    ranges.end());
+  std::sort(ranges.begin(), ranges.end(), [](const MemoryRange& a, const MemoryRange& b) { return a.base < b.base; });
+
+  std::vector<MemoryRange> merged;
+  merged.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    if (!merged.empty() && range.base <= merged.back().base + merged.back().size) {
+      auto& last = merged.back();
+      last.size = std::max(last.base + last.size, range.base + range.size) - last.base;
+    } else {
+      merged.push_back(range);
+    }
+  }
+  return merged;
+}
+
+std::vector<MemoryRange> SplitMemoryRangesForCallback(const std::vector<MemoryRange>& ranges)
+{
+  std::vector<MemoryRange> out;
+  out.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    std::uint64_t base = range.base;
+    std::uint64_t remaining = range.size;
+    while (remaining > 0) {
+      const std::uint64_t take = std::min(remaining, kMaxCallbackRangeBytes);
+      out.push_back({ base, take });
+      base += take;
+      remaining -= take;
+    }
+  }
+  return out;
+}
+
+bool ReadMinidumpMemoryRanges(
+  const std::filesystem::path& dumpPath,
+  std::vector<MemoryRange>* out,
+  std::string* err)
+{
+  if (!out) {
+    SetError(err, "missing output");
+    return false;
+  }
+  out->clear();
+
+  DumpFileReader reader(dumpPath);
+  if (!reader.IsOpen()) {
+    SetError(err, "failed to open dump");
+    return false;
+  }
+
+  std::vector<std::uint8_t> buf;
+  if (!reader.Read(0, kHeaderBytes, &buf) || LoadLe<std::uint32_t>(buf.data()) != kMinidumpSignature) {
+    SetError(err, "not a minidump");
+    return false;
+  }
+  const std::uint32_t streamCount = LoadLe<std::uint32_t>(buf.data() + 8);
+  const std::uint32_t directoryRva = LoadLe<std::uint32_t>(buf.data() + 12);
+  if (streamCount == 0 || streamCount > 4096 ||
+      !reader.Read(directoryRva, static_cast<std::size_t>(streamCount) * kDirectoryEntryBytes, &buf)) {
+    SetError(err, "truncated stream directory");
+    return false;
+  }
+
+  struct StreamLocation {
+    std::uint32_t type = 0;
+    std::uint32_t size = 0;
+    std::uint32_t rva = 0;
+  };
+  std::vector<StreamLocation> streams(streamCount);
+  for (std::uint32_t i = 0; i < streamCount; ++i) {
+    const auto* entry = buf.data() + static_cast<std::size_t>(i) * kDirectoryEntryBytes;
+    streams[i] = { LoadLe<std::uint32_t>(entry), LoadLe<std::uint32_t>(entry + 4), LoadLe<std::uint32_t>(entry + 8) };
+  }
+
+  std::vector<MemoryRange> ranges;
+  for (const auto& stream : streams) {
+    if (stream.type == kMemory64ListStream && stream.size >= 16 && reader.Read(stream.rva, 16, &buf)) {
+      const std::uint64_t count = LoadLe<std::uint64_t>(buf.data());
+      if (count > kMaxListEntries || 16 + count * kMemoryDescriptor64Bytes > stream.size ||
+          !reader.Read(stream.rva + 16ull, static_cast<std::size_t>(count * kMemoryDescriptor64Bytes), &buf)) {
+        continue;
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        const auto* d = buf.data() + i * kMemoryDescriptor64Bytes;
+        ranges.push_back({ LoadLe<std::uint64_t>(d), LoadLe<std::uint64_t>(d + 8) });
+      }
+    } else if (stream.type == kMemoryListStream && stream.size >= 4 && reader.Read(stream.rva, 4, &buf)) {
+      const std::uint32_t count = LoadLe<std::uint32_t>(buf.data());
+      if (count > kMaxListEntries || 4 + static_cast<std::uint64_t>(count) * kMemoryDescriptorBytes > stream.size ||
+          !reader.Read(stream.rva + 4ull, static_cast<std::size_t>(count) * kMemoryDescriptorBytes, &buf)) {
+        continue;
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        const auto* d = buf.data() + i * kMemoryDescriptorBytes;
+        ranges.push_back({ LoadLe<std::uint64_t>(d), LoadLe<std::uint32_t>(d + 8) });
+      }
+    } else if (stream.type == kThreadListStream && stream.size >= 4 && reader.Read(stream.rva, 4, &buf)) {
+      const std::uint32_t count = LoadLe<std::uint32_t>(buf.data());
+      if (count > kMaxListEntries || 4 + static_cast<std::uint64_t>(count) * kThreadBytes > stream.size ||
+          !reader.Read(stream.rva + 4ull, static_cast<std::size_t>(count) * kThreadBytes, &buf)) {
+        continue;
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        const auto* stack = buf.data() + i * kThreadBytes + kThreadStackOffset;
+        ranges.push_back({ LoadLe<std::uint64_t>(stack), LoadLe<std::uint32_t>(stack + 8) });
+      }
+    }
+  }
+
+  *out = CoalesceMemoryRanges(std::move(ranges));
+  if (err) {
+    err->clear();
+  }
+  return true;
+}
+
+std::string BuildDumpDeltaStreamJson(const DumpDeltaBase& base)
+{
+  std::uint64_t omittedBytes = 0;
+  for (const auto& range : base.memoryRanges) {
+    omittedBytes += range.size;
+  }
+
+  nlohmann::json j = nlohmann::json::object();
+  j["format"] = "skydiag_dump_delta";
+  j["version"] = kDumpDeltaFormatVersion;
+  j["base_dump"] = base.filenameUtf8;
+  j["base_size_bytes"] = base.sizeBytes;
+  j["base_last_write_utc_100ns"] = base.lastWriteTimeUtc100ns;
+  j["omitted_ranges"] = base.memoryRanges.size();
+  j["omitted_bytes"] = omittedBytes;
+  return j.dump();
+}
+
+}  // namespace skydiag::helper
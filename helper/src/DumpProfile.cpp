@@ -13,6 +13,8 @@ const char* CaptureKindToString(CaptureKind captureKind)
       return "manual";
     case CaptureKind::CrashRecapture:
       return "crash_recapture";
+    case CaptureKind::CrashThin:
+      return "crash_thin";
   }
   return "crash";
 }
@@ -41,6 +43,7 @@ DumpProfile ResolveDumpProfile(DumpMode baseMode, CaptureKind captureKind)
         profile.includeProcessThreadData = true;
         profile.includeFullMemoryInfo = true;
         profile.includeModuleHeaders = true;
+        profile.includeTargetedMemory = true;
       }
       break;
     case CaptureKind::Hang:
@@ -70,12 +73,38 @@ DumpProfile ResolveDumpProfile(DumpMode baseMode, CaptureKind captureKind)
         profile.includeModuleHeaders = true;
         profile.includeIndirectMemory = true;
         profile.ignoreInaccessibleMemory = true;
+        profile.includeTargetedMemory = true;
       }
       profile.includeFullMemory = (baseMode == DumpMode::kFull);
       break;
+    case CaptureKind::CrashThin:
+      profile = DumpProfile{};
+      profile.captureKind = captureKind;
+      profile.baseMode = baseMode;
+      profile.preferCrashContext = true;
+      profile.preferMainThread = true;
+      break;
   }
 
   return profile;
 }
 
+DumpProfile ResolveDumpProfile(DumpMode baseMode, CaptureKind captureKind, DumpCompression compression)
+{
+  DumpProfile profile = ResolveDumpProfile(baseMode, captureKind);
+  profile.compressOnDisk = ShouldCompressDumpOnDisk(compression, profile);
+  return profile;
+}
+
+bool ShouldCompressDumpOnDisk(DumpCompression compression, const DumpProfile& profile)
+{
+  if (compression == DumpCompression::kOff || profile.captureKind == CaptureKind::CrashThin) {
+    return false;
+  }
+  if (compression == DumpCompression::kAll) {
+    return true;
+  }
+  return profile.includeFullMemory || profile.includeIndirectMemory;
+}
+
 }  // namespace skydiag::helper
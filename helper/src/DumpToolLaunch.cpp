@@ -4,11 +4,15 @@
 
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "ProcessUtil.h"
 #include "HelperLog.h"
+#include "PendingCrashAnalysisInternal.h"
+#include "PostProcessWorker.h"
 #include "SkyrimDiagHelper/Config.h"
 #include "SkyrimDiagHelper/DumpToolResolve.h"
 
@@ -120,17 +124,6 @@ bool StartDumpToolProcessWithHandle(
   return true;
 }
 
-bool StartDumpToolProcess(
-  const std::filesystem::path& exe,
-  std::wstring cmd,
-  const std::filesystem::path& outBase,
-  DWORD createFlags,
-  std::wstring* err,
-  DWORD* outLastError = nullptr)
-{
-  return StartDumpToolProcessWithHandle(exe, std::move(cmd), outBase, createFlags, nullptr, err, outLastError);
-}
-
 void AppendOnlineSymbolFlag(std::wstring* cmd, bool allowOnlineSymbols)
 {
   if (!cmd) {
@@ -139,26 +132,100 @@ void AppendOnlineSymbolFlag(std::wstring* cmd, bool allowOnlineSymbols)
   *cmd += allowOnlineSymbols ? L" --allow-online-symbols" : L" --no-online-symbols";
 }
 
+constexpr DWORD kHeadlessAnalysisPollMs = 250;
+
+// Queued headless analyses run one after another; each waits for the last.
+struct HeadlessAnalysisChain
+{
+  std::mutex mutex;
+  skydiag::helper::PostProcessJobId last = skydiag::helper::kNoPostProcessJob;
+};
+
+HeadlessAnalysisChain& GetHeadlessAnalysisChain()
+{
+  static HeadlessAnalysisChain chain{};
+  return chain;
+}
+
+// Job body: the analyzer runs while the job does. At shutdown it is left
+// running, as an unqueued launch would have been; past the timeout it is
+// terminated.
+bool RunHeadlessAnalysis(
+  const skydiag::helper::HelperConfig& cfg,
+  const std::wstring& dumpPath,
+  const std::filesystem::path& outBase,
+  const skydiag::helper::PostProcessCancelFlag& cancel)
+{
+  const auto dumpName = std::filesystem::path(dumpPath).filename().wstring();
+  HANDLE process = nullptr;
+  std::wstring err;
+  if (!StartDumpToolHeadlessAsync(cfg, dumpPath, outBase, &process, &err)) {
+    AppendLogLine(outBase, L"Headless analysis launch failed (dump=" + dumpName + L"): " + err);
+    return false;
+  }
+
+  const DWORD timeoutMs = CrashAnalysisTimeoutMs(cfg);
+  const ULONGLONG startedAt = GetTickCount64();
+  DWORD w = WAIT_TIMEOUT;
+  while ((w = WaitForSingleObject(process, kHeadlessAnalysisPollMs)) == WAIT_TIMEOUT) {
+    if (cancel.load(std::memory_order_relaxed)) {
+      AppendLogLine(outBase, L"Headless analysis left running at shutdown: " + dumpName);
+      CloseHandle(process);
+      return false;
+    }
+    if (GetTickCount64() - startedAt > timeoutMs) {
+      TerminateProcess(process, 1);
+      WaitForSingleObject(process, 1000);
+      AppendLogLine(outBase, L"Headless analysis timeout; process terminated: " + dumpName);
+      CloseHandle(process);
+      return false;
+    }
+  }
+
+  DWORD exitCode = 1;
+  const bool ok = w == WAIT_OBJECT_0 && GetExitCodeProcess(process, &exitCode) && exitCode == 0;
+  CloseHandle(process);
+  if (!ok) {
+    AppendLogLine(
+      outBase,
+      L"Headless analysis failed (dump=" + dumpName + L", exit_code=" + std::to_wstring(exitCode) + L").");
+  }
+  return ok;
+}
+
 }  // namespace
 
-void StartDumpToolHeadlessIfConfigured(
+skydiag::helper::PostProcessJobId QueueDumpToolHeadlessIfConfigured(
   const skydiag::helper::HelperConfig& cfg,
   const std::wstring& dumpPath,
-  const std::filesystem::path& outBase)
+  const std::filesystem::path& outBase,
+  skydiag::helper::PostProcessPriority priority)
 {
   if (!cfg.autoAnalyzeDump) {
-    return;
+    return skydiag::helper::kNoPostProcessJob;
   }
 
-  const auto exe = ResolveDumpToolHeadlessExeForConfig(cfg);
-  std::wstring cmd =
-    QuoteArg(exe.wstring()) + L" " + QuoteArg(dumpPath) + L" --out-dir " + QuoteArg(outBase.wstring()) + L" --headless";
-  AppendOnlineSymbolFlag(&cmd, cfg.allowOnlineSymbols);
+  const auto config = std::make_shared<const skydiag::helper::HelperConfig>(cfg);
+  skydiag::helper::PostProcessJob job{};
+  job.name = "headless_analysis";
+  job.priority = priority;
+  job.run = [config, dumpPath, outBase](const skydiag::helper::PostProcessCancelFlag& cancel) {
+    return RunHeadlessAnalysis(*config, dumpPath, outBase, cancel);
+  };
 
-  std::wstring err;
-  if (!StartDumpToolProcess(exe, std::move(cmd), outBase, CREATE_NO_WINDOW, &err)) {
-    std::wcerr << L"[SkyrimDiagHelper] Warning: failed to start DumpTool headless: " << err << L"\n";
+  auto& chain = GetHeadlessAnalysisChain();
+  std::lock_guard lock(chain.mutex);
+  if (chain.last != skydiag::helper::kNoPostProcessJob) {
+    job.dependsOn.push_back(chain.last);
+  }
+  const auto id = EnqueuePostProcessJob(std::move(job));
+  if (id == skydiag::helper::kNoPostProcessJob) {
+    AppendLogLine(outBase, L"Headless analysis not queued (post-process queue stopped): " + std::filesystem::path(dumpPath).filename().wstring());
+    return id;
   }
+  chain.last = id;
+  TrackDumpReaderJob(outBase, id);
+  return id;
 }
 
 bool StartDumpToolHeadlessAsync(
@@ -7,6 +7,8 @@
 #include <string_view>
 #include <cstdint>
 
+#include "SkyrimDiagHelper/PostProcessQueue.h"
+
 namespace skydiag::helper {
 struct HelperConfig;
 }
@@ -19,10 +21,14 @@ enum class DumpToolViewerLaunchResult : std::uint8_t {
   kExitedImmediately = 2,
 };
 
-void StartDumpToolHeadlessIfConfigured(
+// Runs the headless analyzer as a post-process job, one analysis at a time,
+// and terminates it past the crash analysis timeout. Retention sweeps for
+// `outBase` wait for it. kNoPostProcessJob when autoAnalyzeDump is off.
+skydiag::helper::PostProcessJobId QueueDumpToolHeadlessIfConfigured(
   const skydiag::helper::HelperConfig& cfg,
   const std::wstring& dumpPath,
-  const std::filesystem::path& outBase);
+  const std::filesystem::path& outBase,
+  skydiag::helper::PostProcessPriority priority);
 
 bool StartDumpToolHeadlessAsync(
   const skydiag::helper::HelperConfig& cfg,
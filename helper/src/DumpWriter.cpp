@@ -3,16 +3,22 @@
 #include <Windows.h>
 
 #include <DbgHelp.h>
+#include <winioctl.h>
 
 #include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <filesystem>
 #include <optional>
+#include <span>
 #include <string_view>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "HelperLog.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
+#include "SkyrimDiagHelper/TargetedMemoryPlan.h"
 #include "SkyrimDiagProtocol.h"
 
 namespace skydiag::helper {
@@ -24,8 +30,15 @@ struct DumpCallbackContext
   DWORD preferredThreadId = 0;
   std::vector<DWORD> preferredThreadIds;
   bool isProcessSnapshot = false;
+  std::vector<MemoryRange> memoryRanges;
+  std::size_t nextMemoryRange = 0;
+  std::vector<MemoryRange> removeRanges;  // already held by the base dump
+  std::size_t nextRemoveRange = 0;
 };
 
+constexpr std::uint64_t kTargetedStackScanBytes = 64 * 1024;
+constexpr std::size_t kMaxQueriedRegions = 256 * 1024;
+
 void AppendPreferredThreadId(std::vector<DWORD>& preferredThreadIds, DWORD tid)
 {
   if (tid == 0) {
@@ -61,55 +74,6 @@ std::vector<DWORD> ExtractPreferredWctThreadIds(std::string_view wctJsonUtf8)
   return tids;
 }
 
-std::optional<DWORD> InferMainThreadIdFromSnapshot(
-  const skydiag::SharedLayout* snapshot,
-  std::size_t snapshotBytes)
-{
-  if (!snapshot || snapshotBytes < offsetof(skydiag::SharedLayout, events)) {
-    return std::nullopt;
-  }
-  if (snapshot->header.magic != skydiag::kMagic) {
-    return std::nullopt;
-  }
-
-  const std::size_t availableEventBytes = snapshotBytes - offsetof(skydiag::SharedLayout, events);
-  const std::size_t availableEvents = std::min<std::size_t>(
-    skydiag::kEventCapacity,
-    availableEventBytes / sizeof(skydiag::BlackboxEvent));
-  std::uint32_t capacity = snapshot->header.capacity;
-  if (capacity == 0u || capacity > availableEvents) {
-    capacity = static_cast<std::uint32_t>(availableEvents);
-  }
-  if (capacity == 0u) {
-    return std::nullopt;
-  }
-
-  const std::uint32_t writeIndex = snapshot->header.write_index;
-  const std::uint32_t begin = (writeIndex > capacity) ? (writeIndex - capacity) : 0u;
-  std::optional<DWORD> sessionStartTid;
-  std::optional<DWORD> latestHeartbeatTid;
-  for (std::uint32_t i = begin; i < writeIndex; ++i) {
-    const auto& source = snapshot->events[i % capacity];
-    const std::uint32_t seq1 = source.seq;
-    if ((seq1 & 1u) != 0u) {
-      continue;
-    }
-    skydiag::BlackboxEvent event{};
-    std::memcpy(&event, &source, sizeof(event));
-    const std::uint32_t seq2 = source.seq;
-    if (seq1 != seq2 || (seq2 & 1u) != 0u || event.tid == 0u) {
-      continue;
-    }
-    if (event.type == static_cast<std::uint16_t>(skydiag::EventType::kHeartbeat)) {
-      latestHeartbeatTid = event.tid;
-    } else if (!sessionStartTid &&
-               event.type == static_cast<std::uint16_t>(skydiag::EventType::kSessionStart)) {
-      sessionStartTid = event.tid;
-    }
-  }
-  return latestHeartbeatTid ? latestHeartbeatTid : sessionStartTid;
-}
-
 bool ShouldShapePreferredThread(const DumpCallbackContext& ctx)
 {
   return !ctx.preferredThreadIds.empty() && (ctx.profile.preferCrashContext || ctx.profile.preferMainThread ||
@@ -155,15 +119,141 @@ MINIDUMP_TYPE ApplyProfileToDumpType(const DumpProfile& dumpProfile)
   if (dumpProfile.includeFullMemory) {
     t = static_cast<MINIDUMP_TYPE>(t | MiniDumpWithFullMemory);
   }
+  if (dumpProfile.includeTargetedMemory) {
+    // Planned ranges can be decommitted by other threads before the write.
+    t = static_cast<MINIDUMP_TYPE>(t | MiniDumpIgnoreInaccessibleMemory);
+  }
   return t;
 }
 
+std::vector<MemoryRegionInfo> QueryReadableRegions(HANDLE process)
+{
+  constexpr DWORD kReadable = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY |
+    PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+  constexpr DWORD kWritable = PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+  constexpr DWORD kExecutable = PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+
+  std::vector<MemoryRegionInfo> regions;
+  MEMORY_BASIC_INFORMATION mbi{};
+  std::uintptr_t address = 0;
+  while (regions.size() < kMaxQueriedRegions &&
+         VirtualQueryEx(process, reinterpret_cast<LPCVOID>(address), &mbi, sizeof(mbi)) == sizeof(mbi)) {
+    const auto base = reinterpret_cast<std::uintptr_t>(mbi.BaseAddress);
+    if (mbi.State == MEM_COMMIT && (mbi.Protect & kReadable) != 0 && (mbi.Protect & PAGE_GUARD) == 0) {
+      MemoryRegionInfo region{};
+      region.base = base;
+      region.size = mbi.RegionSize;
+      region.allocationBase = reinterpret_cast<std::uintptr_t>(mbi.AllocationBase);
+      region.flags |= (mbi.Protect & kWritable) != 0 ? kRegion_Writable : 0u;
+      region.flags |= (mbi.Protect & kExecutable) != 0 ? kRegion_Executable : 0u;
+      region.flags |= mbi.Type == MEM_IMAGE ? kRegion_Image : 0u;
+      regions.push_back(region);
+    }
+    const std::uintptr_t next = base + mbi.RegionSize;
+    if (next <= address) {
+      break;
+    }
+    address = next;
+  }
+  return regions;
+}
+
+// Chooses the extra ranges for a crash dump from the committed exception
+// context. Register targets are read from the same snapshot as the exception
+// stream, so the selection matches the state the analyzer will see.
+std::vector<MemoryRange> PlanCrashMemoryRanges(HANDLE process, const CONTEXT& context)
+{
+  const ScopedPerfTimer perfTimer(PerfStage::kMemoryPlan);
+  TargetedMemoryInputs in{};
+  in.readableRegions = QueryReadableRegions(process);
+  in.instructionPointer = context.Rip;
+  in.registers = {
+    context.Rax, context.Rbx, context.Rcx, context.Rdx, context.Rsi, context.Rdi, context.Rbp,
+    context.R8, context.R9, context.R10, context.R11, context.R12, context.R13, context.R14, context.R15,
+  };
+  in.argumentRegisters = { context.Rcx, context.Rdx };
+
+  const std::uint64_t rsp = context.Rsp & ~std::uint64_t{ 7 };
+  const auto stackRegion = std::find_if(in.readableRegions.begin(), in.readableRegions.end(), [rsp](const auto& r) {
+    return rsp >= r.base && rsp - r.base < r.size;
+  });
+  if (stackRegion != in.readableRegions.end()) {
+    in.stack = { stackRegion->base, stackRegion->size };
+    const std::uint64_t end = std::min(stackRegion->base + stackRegion->size, rsp + kTargetedStackScanBytes);
+    in.stackWords.resize(static_cast<std::size_t>((end - rsp) / sizeof(std::uint64_t)));
+    SIZE_T read = 0;
+    if (!ReadProcessMemory(
+          process,
+          reinterpret_cast<LPCVOID>(static_cast<std::uintptr_t>(rsp)),
+          in.stackWords.data(),
+          in.stackWords.size() * sizeof(std::uint64_t),
+          &read)) {
+      in.stackWords.resize(read / sizeof(std::uint64_t));
+    }
+  }
+
+  return PlanTargetedMemory(in).ranges;
+}
+
+// NTFS compresses in independent 64 KB units, so a memory-mapped reader only
+// pays for the units it touches. Returns ERROR_SUCCESS or the ioctl's error;
+// on failure the file is left as it was and is written uncompressed.
+DWORD TryEnableNtfsCompression(HANDLE file)
+{
+  USHORT format = COMPRESSION_FORMAT_DEFAULT;
+  DWORD bytesReturned = 0;
+  const BOOL ok = DeviceIoControl(
+    file,
+    FSCTL_SET_COMPRESSION,
+    &format,
+    sizeof(format),
+    nullptr,
+    0,
+    &bytesReturned,
+    nullptr);
+  return ok ? ERROR_SUCCESS : GetLastError();
+}
+
+void LogDumpCompressionFailure(const std::wstring& dumpPath, DWORD error)
+{
+  const auto path = std::filesystem::path(dumpPath);
+  // NTFS refuses compression on volumes with clusters larger than 4 KB, and
+  // ReFS has none; FAT/exFAT report ERROR_INVALID_FUNCTION.
+  const std::wstring reason = error == ERROR_FILE_SYSTEM_LIMITATION
+    ? L"volume does not support compression (cluster size above 4 KB or not NTFS)"
+    : L"FSCTL_SET_COMPRESSION failed: " + std::to_wstring(error);
+  internal::AppendLogLine(path.parent_path(), L"Dump left uncompressed (" + reason + L"): " + path.filename().wstring());
+}
+
+// Logical and on-disk size of a compressed dump: the ratio DumpCompression
+// achieves on this volume. The file is flushed first so the size reflects
+// the compressed allocation rather than pending writes.
+void LogDumpCompressionRatio(HANDLE file, const std::wstring& dumpPath)
+{
+  LARGE_INTEGER logical{};
+  if (!FlushFileBuffers(file) || !GetFileSizeEx(file, &logical) || logical.QuadPart <= 0) {
+    return;
+  }
+  DWORD high = 0;
+  const DWORD low = GetCompressedFileSizeW(dumpPath.c_str(), &high);
+  if (low == INVALID_FILE_SIZE && GetLastError() != NO_ERROR) {
+    return;
+  }
+  const std::uint64_t onDisk = (std::uint64_t{ high } << 32) | low;
+  const auto path = std::filesystem::path(dumpPath);
+  const std::uint64_t percent = onDisk * 100u / static_cast<std::uint64_t>(logical.QuadPart);
+  internal::AppendLogLine(
+    path.parent_path(),
+    L"Dump compressed on disk: " + std::to_wstring(logical.QuadPart / (1024 * 1024)) + L" MB -> " +
+      std::to_wstring(onDisk / (1024 * 1024)) + L" MB (" + std::to_wstring(percent) + L"%): " + path.filename().wstring());
+}
+
 BOOL CALLBACK MiniDumpCallback(
   PVOID callbackParam,
   const PMINIDUMP_CALLBACK_INPUT callbackInput,
   PMINIDUMP_CALLBACK_OUTPUT callbackOutput)
 {
-  const auto* ctx = static_cast<const DumpCallbackContext*>(callbackParam);
+  auto* ctx = static_cast<DumpCallbackContext*>(callbackParam);
   (void)callbackOutput;
   if (!ctx || !callbackInput) {
     return TRUE;
@@ -183,12 +273,80 @@ BOOL CALLBACK MiniDumpCallback(
     }
     return TRUE;
   }
+  if (callbackType == MemoryCallback && callbackOutput) {
+    // Called repeatedly; each TRUE adds one range, FALSE ends the list.
+    if (ctx->nextMemoryRange >= ctx->memoryRanges.size()) {
+      return FALSE;
+    }
+    const auto& range = ctx->memoryRanges[ctx->nextMemoryRange++];
+    callbackOutput->MemoryBase = range.base;
+    callbackOutput->MemorySize = static_cast<ULONG>(range.size);
+    return TRUE;
+  }
+  if (callbackType == RemoveMemoryCallback && callbackOutput) {
+    if (ctx->nextRemoveRange >= ctx->removeRanges.size()) {
+      return FALSE;
+    }
+    const auto& range = ctx->removeRanges[ctx->nextRemoveRange++];
+    callbackOutput->MemoryBase = range.base;
+    callbackOutput->MemorySize = static_cast<ULONG>(range.size);
+    return TRUE;
+  }
   (void)callbackType;
   return TRUE;
 }
 
 }  // namespace
 
+std::optional<DWORD> InferMainThreadIdFromSnapshot(
+  const skydiag::SharedLayout* snapshot,
+  std::size_t snapshotBytes)
+{
+  if (!snapshot || snapshotBytes < offsetof(skydiag::SharedLayout, events)) {
+    return std::nullopt;
+  }
+  if (snapshot->header.magic != skydiag::kMagic) {
+    return std::nullopt;
+  }
+
+  const std::size_t availableEventBytes = snapshotBytes - offsetof(skydiag::SharedLayout, events);
+  const std::size_t availableEvents = std::min<std::size_t>(
+    skydiag::kEventCapacity,
+    availableEventBytes / sizeof(skydiag::BlackboxEvent));
+  std::uint32_t capacity = snapshot->header.capacity;
+  if (capacity == 0u || capacity > availableEvents) {
+    capacity = static_cast<std::uint32_t>(availableEvents);
+  }
+  if (capacity == 0u) {
+    return std::nullopt;
+  }
+
+  const std::uint32_t writeIndex = snapshot->header.write_index;
+  const std::uint32_t begin = (writeIndex > capacity) ? (writeIndex - capacity) : 0u;
+  std::optional<DWORD> sessionStartTid;
+  std::optional<DWORD> latestHeartbeatTid;
+  for (std::uint32_t i = begin; i < writeIndex; ++i) {
+    const auto& source = snapshot->events[i % capacity];
+    const std::uint32_t seq1 = source.seq;
+    if ((seq1 & 1u) != 0u) {
+      continue;
+    }
+    skydiag::BlackboxEvent event{};
+    std::memcpy(&event, &source, sizeof(event));
+    const std::uint32_t seq2 = source.seq;
+    if (seq1 != seq2 || (seq2 & 1u) != 0u || event.tid == 0u) {
+      continue;
+    }
+    if (event.type == static_cast<std::uint16_t>(skydiag::EventType::kHeartbeat)) {
+      latestHeartbeatTid = event.tid;
+    } else if (!sessionStartTid &&
+               event.type == static_cast<std::uint16_t>(skydiag::EventType::kSessionStart)) {
+      sessionStartTid = event.tid;
+    }
+  }
+  return latestHeartbeatTid ? latestHeartbeatTid : sessionStartTid;
+}
+
 bool WriteDumpWithStreams(
   HANDLE process,
   std::uint32_t pid,
@@ -197,19 +355,24 @@ bool WriteDumpWithStreams(
   std::size_t shmSnapshotBytes,
   const std::string& wctJsonUtf8,
   const std::string& pluginScanJson,
+  const std::string& hangPrecaptureJson,
   bool isCrash,
   const DumpProfile& dumpProfile,
   bool isProcessSnapshot,
-  std::wstring* err)
+  std::wstring* err,
+  const DumpDeltaBase* deltaBase,
+  bool snapshotImmutable)
 {
+  const ScopedPerfTimer perfTimer(PerfStage::kDumpWrite);
   if (!process) {
     if (err) *err = L"Invalid process handle";
     return false;
   }
 
+  // FSCTL_SET_COMPRESSION needs read access to the handle as well.
   HANDLE file = CreateFileW(
     dumpPath.c_str(),
-    GENERIC_WRITE,
+    dumpProfile.compressOnDisk ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_WRITE,
     0,
     nullptr,
     CREATE_ALWAYS,
@@ -219,18 +382,37 @@ bool WriteDumpWithStreams(
     if (err) *err = L"CreateFileW failed: " + std::to_wstring(GetLastError());
     return false;
   }
+  // Set while the file is still empty so the dump is compressed as it is
+  // written instead of being rewritten afterwards.
+  bool compressed = false;
+  if (dumpProfile.compressOnDisk) {
+    const DWORD compressErr = TryEnableNtfsCompression(file);
+    compressed = compressErr == ERROR_SUCCESS;
+    if (!compressed) {
+      LogDumpCompressionFailure(dumpPath, compressErr);
+    }
+  }
 
   // ---- build user streams ----
-  std::vector<std::uint8_t> blackboxBytes;
+  // A live mapping is copied once so both streams see one state. An immutable
+  // source (the crash path's own snapshot copy) is streamed in place: the
+  // SharedLayout is several MB and the game is waiting on this write.
+  std::vector<std::uint8_t> blackboxCopy;
+  std::span<const std::uint8_t> blackboxBytes;
   if (shmSnapshot) {
     const std::size_t want = sizeof(skydiag::SharedLayout);
     const std::size_t got = (shmSnapshotBytes > 0) ? std::min<std::size_t>(want, shmSnapshotBytes) : want;
-    blackboxBytes.resize(got);
-    std::memcpy(blackboxBytes.data(), shmSnapshot, got);
+    const auto* source = reinterpret_cast<const std::uint8_t*>(shmSnapshot);
+    if (snapshotImmutable) {
+      blackboxBytes = { source, got };
+    } else {
+      blackboxCopy.assign(source, source + got);
+      blackboxBytes = blackboxCopy;
+    }
   }
-  // vector<uint8_t> is not formally aligned for SharedLayout. Copy only the
+  // The byte source is not formally aligned for SharedLayout. Copy only the
   // header into an aligned local object instead of type-punning the byte
-  // buffer; both streams still derive from the same immutable byte copy.
+  // buffer; both streams still derive from the same immutable bytes.
   skydiag::SharedHeader committedHeader{};
   const bool hasCommittedHeader = blackboxBytes.size() >= sizeof(committedHeader);
   if (hasCommittedHeader) {
@@ -238,12 +420,12 @@ bool WriteDumpWithStreams(
   }
 
   std::vector<MINIDUMP_USER_STREAM> streams;
-  streams.reserve(3);
+  streams.reserve(5);
 
   MINIDUMP_USER_STREAM s1{};
   s1.Type = skydiag::protocol::kMinidumpUserStream_Blackbox;
   s1.BufferSize = static_cast<ULONG>(blackboxBytes.size());
-  s1.Buffer = blackboxBytes.empty() ? nullptr : blackboxBytes.data();
+  s1.Buffer = blackboxBytes.empty() ? nullptr : const_cast<std::uint8_t*>(blackboxBytes.data());
   streams.push_back(s1);
 
   MINIDUMP_USER_STREAM s2{};
@@ -262,6 +444,23 @@ bool WriteDumpWithStreams(
     streams.push_back(s3);
   }
 
+  MINIDUMP_USER_STREAM s4{};
+  if (!hangPrecaptureJson.empty()) {
+    s4.Type = skydiag::protocol::kMinidumpUserStream_HangPrecapture;
+    s4.BufferSize = static_cast<ULONG>(hangPrecaptureJson.size());
+    s4.Buffer = const_cast<char*>(hangPrecaptureJson.data());
+    streams.push_back(s4);
+  }
+
+  const std::string deltaJson = deltaBase ? BuildDumpDeltaStreamJson(*deltaBase) : std::string{};
+  MINIDUMP_USER_STREAM s5{};
+  if (!deltaJson.empty()) {
+    s5.Type = skydiag::protocol::kMinidumpUserStream_DumpDelta;
+    s5.BufferSize = static_cast<ULONG>(deltaJson.size());
+    s5.Buffer = const_cast<char*>(deltaJson.data());
+    streams.push_back(s5);
+  }
+
   MINIDUMP_USER_STREAM_INFORMATION usi{};
   usi.UserStreamCount = static_cast<ULONG>(streams.size());
   usi.UserStreamArray = streams.empty() ? nullptr : streams.data();
@@ -307,6 +506,13 @@ bool WriteDumpWithStreams(
     }
   }
   callbackContext.isProcessSnapshot = isProcessSnapshot;
+  // A process snapshot handle cannot be walked with VirtualQueryEx.
+  if (effectiveProfile.includeTargetedMemory && !effectiveProfile.includeFullMemory && meiPtr && !isProcessSnapshot) {
+    callbackContext.memoryRanges = PlanCrashMemoryRanges(process, ctx);
+  }
+  if (deltaBase) {
+    callbackContext.removeRanges = SplitMemoryRangesForCallback(deltaBase->memoryRanges);
+  }
   MINIDUMP_CALLBACK_INFORMATION callbackInfo{};
   callbackInfo.CallbackRoutine = MiniDumpCallback;
   callbackInfo.CallbackParam = &callbackContext;
@@ -321,6 +527,9 @@ bool WriteDumpWithStreams(
     &callbackInfo);
 
   const DWORD lastErr = GetLastError();
+  if (ok && compressed) {
+    LogDumpCompressionRatio(file, dumpPath);
+  }
   CloseHandle(file);
 
   if (!ok) {
@@ -54,6 +54,25 @@ HangTickResult ExecuteConfirmedHangCapture(
   const auto manifestPath = outBase / (L"SkyrimDiag_Incident_Hang_" + ts + L".json");
   bool manifestWritten = false;
 
+  // Snapshot first: the clone pins the state closest to detection and releases
+  // the game before WCT, plugin scan and the dump write run.
+  auto pssSnapshot = TryCapturePssSnapshotForFreeze(cfg.enablePssSnapshotForFreeze, proc.process);
+  if (pssSnapshot.requested) {
+    if (pssSnapshot.used) {
+      AppendLogLine(
+        outBase,
+        L"PSS snapshot captured for hang dump (durationMs="
+          + std::to_wstring(pssSnapshot.captureDurationMs)
+          + L").");
+    } else {
+      AppendLogLine(
+        outBase,
+        L"PSS snapshot unavailable for hang dump; falling back to live-process dump (status="
+          + pssSnapshot.status
+          + L").");
+    }
+  }
+
   bool etwStarted = false;
   if (cfg.enableEtwCaptureOnHang) {
     std::wstring etwUsedProfile;
@@ -88,26 +107,11 @@ HangTickResult ExecuteConfirmedHangCapture(
   wctJson["capture"]["stateFlags"] = stateFlags;
 
   const std::string pluginScanJson = CollectPluginScanJson(proc, outBase);
+  const std::string hangPrecaptureJson = TakeHangPrecaptureJson(proc, state);
   const auto dumpProfile = skydiag::helper::ResolveDumpProfile(
     cfg.dumpMode,
-    skydiag::helper::CaptureKind::Hang);
-  auto pssSnapshot = TryCapturePssSnapshotForFreeze(cfg.enablePssSnapshotForFreeze, proc.process);
-  if (pssSnapshot.requested) {
-    if (pssSnapshot.used) {
-      AppendLogLine(
-        outBase,
-        L"PSS snapshot captured for hang dump (durationMs="
-          + std::to_wstring(pssSnapshot.captureDurationMs)
-          + L").");
-    } else {
-      AppendLogLine(
-        outBase,
-        L"PSS snapshot unavailable for hang dump; falling back to live-process dump (status="
-          + pssSnapshot.status
-          + L").");
-    }
-  }
-
+    skydiag::helper::CaptureKind::Hang,
+    cfg.dumpCompression);
   wctJson["capture"]["pss_snapshot_requested"] = pssSnapshot.requested;
   wctJson["capture"]["pss_snapshot_used"] = pssSnapshot.used;
   wctJson["capture"]["pss_snapshot_capture_ms"] = pssSnapshot.captureDurationMs;
@@ -134,25 +138,30 @@ HangTickResult ExecuteConfirmedHangCapture(
   WriteTextFileUtf8(wctPath, wctUtf8);
 
   bool dumpWritten = false;
-  std::wstring dumpErr;
-  const HANDLE dumpSource = pssSnapshot.used ? pssSnapshot.snapshotHandle : proc.process;
-  if (!skydiag::helper::WriteDumpWithStreams(
-        dumpSource,
+  const auto freezeDump = WriteFreezeDump(
+    pssSnapshot,
+    proc.process,
+    [&](HANDLE source, bool isProcessSnapshot, std::wstring* err) {
+      return skydiag::helper::WriteDumpWithStreams(
+        source,
         proc.pid,
         dumpPath,
         proc.shm,
         proc.shmSize,
         wctUtf8,
         pluginScanJson,
+        hangPrecaptureJson,
         /*isCrash=*/false,
         dumpProfile,
-        /*isProcessSnapshot=*/pssSnapshot.used,
-        &dumpErr)) {
-    ReleasePssSnapshotForFreeze(proc.process, pssSnapshot.snapshotHandle);
-    std::wcerr << L"[SkyrimDiagHelper] Hang dump failed: " << dumpErr << L"\n";
-    AppendLogLine(outBase, L"Hang dump failed: " + dumpErr);
+        isProcessSnapshot,
+        err);
+    });
+  ReleasePssSnapshotForFreeze(proc.process, pssSnapshot.snapshotHandle);
+  LogFreezeDumpTiming(outBase, L"hang", freezeDump);
+  if (!freezeDump.written) {
+    std::wcerr << L"[SkyrimDiagHelper] Hang dump failed: " << freezeDump.err << L"\n";
+    AppendLogLine(outBase, L"Hang dump failed: " + freezeDump.err);
   } else {
-    ReleasePssSnapshotForFreeze(proc.process, pssSnapshot.snapshotHandle);
     dumpWritten = true;
     std::wcout << L"[SkyrimDiagHelper] Hang dump written: " << dumpPath << L"\n";
     std::wcout << L"[SkyrimDiagHelper] WCT written: " << wctPath.wstring() << L"\n";
@@ -173,7 +182,7 @@ HangTickResult ExecuteConfirmedHangCapture(
       ctx["pss_snapshot_used"] = pssSnapshot.used;
       ctx["pss_snapshot_capture_ms"] = pssSnapshot.captureDurationMs;
       ctx["pss_snapshot_status"] = WideToUtf8(pssSnapshot.status);
-      ctx["dump_transport"] = pssSnapshot.used ? "pss_snapshot" : "live_process";
+      AddFreezeDumpTimingContext(freezeDump, &ctx);
 
       const auto manifest = MakeIncidentManifestV1(
         "hang",
@@ -207,7 +216,7 @@ HangTickResult ExecuteConfirmedHangCapture(
       }
     }
     if (ShouldRunHeadlessDumpAnalysis(cfg, viewerNow, /*analysisRequired=*/false)) {
-      StartDumpToolHeadlessIfConfigured(cfg, dumpPath, outBase);
+      QueueDumpToolHeadlessIfConfigured(cfg, dumpPath, outBase, skydiag::helper::PostProcessPriority::kHang);
     } else if (viewerNow && cfg.autoAnalyzeDump) {
       AppendLogLine(outBase, L"Skipped headless analysis: viewer auto-open is enabled.");
     }
@@ -3,14 +3,64 @@
 #include <Windows.h>
 
 #include <filesystem>
+#include <fstream>
 #include <string>
 
 #include "HelperLog.h"
 #include "SkyrimDiagHelper/HangSuppression.h"
+#include "SkyrimDiagHelper/HangSuppressionTrace.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
+#include "SkyrimDiagHelper/Retention.h"
 #include "WindowHeuristics.h"
 #include "SkyrimDiagShared.h"
 
 namespace skydiag::helper::internal {
+namespace {
+
+constexpr std::uint64_t kHangSuppressionTraceMaxBytes = 4ull * 1024ull * 1024ull;
+constexpr std::uint32_t kHangSuppressionTraceMaxFiles = 2;
+
+skydiag::helper::HangSuppressionInputs MakeHangSuppressionInputs(
+  const skydiag::helper::HelperConfig& cfg,
+  const skydiag::helper::AttachedProcess& proc,
+  const skydiag::helper::HangDecision& decision,
+  std::uint32_t stateFlags,
+  std::uint64_t nowQpc,
+  bool isForeground,
+  bool isWindowResponsive)
+{
+  skydiag::helper::HangSuppressionInputs in{};
+  in.isHang = decision.isHang;
+  in.isForeground = isForeground;
+  in.isLoading = decision.isLoading;
+  in.isInMenu = (stateFlags & skydiag::kState_InMenu) != 0u;
+  in.isWindowResponsive = isWindowResponsive;
+  in.suppressHangWhenNotForeground = cfg.suppressHangWhenNotForeground;
+  in.nowQpc = nowQpc;
+  in.heartbeatQpc = proc.shm->header.last_heartbeat_qpc;
+  in.qpcFreq = proc.shm->header.qpc_freq;
+  in.foregroundGraceSec = cfg.foregroundGraceSec;
+  return in;
+}
+
+void AppendHangSuppressionTrace(
+  const std::filesystem::path& outBase,
+  const skydiag::helper::HangSuppressionTraceRecord& record)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(outBase, ec);
+
+  const auto path = outBase / L"SkyrimDiagHelper_HangSuppressionTrace.jsonl";
+  skydiag::helper::RotateLogFileIfNeeded(path, kHangSuppressionTraceMaxBytes, kHangSuppressionTraceMaxFiles);
+  std::ofstream f(path, std::ios::binary | std::ios::app);
+  if (!f) {
+    return;
+  }
+  const auto line = skydiag::helper::SerializeHangSuppressionTraceRecord(record) + "\n";
+  f.write(line.data(), static_cast<std::streamsize>(line.size()));
+}
+
+}  // namespace
 
 void ResetHangCaptureEpisode(HangCaptureState* state)
 {
@@ -51,20 +101,30 @@ bool SuppressHangAndLogIfNeeded(
   EnsureTargetWindowForPid(state, proc.pid);
   const bool isForeground = IsPidInForeground(proc.pid);
   const bool isWindowResponsive = state->targetWindow && IsWindowResponsive(state->targetWindow, 250);
-  const auto hangSup = skydiag::helper::EvaluateHangSuppression(
+  const auto inputs =
+    MakeHangSuppressionInputs(cfg, proc, decision, stateFlags, nowQpc, isForeground, isWindowResponsive);
+  std::uint8_t ruleIndex = 0xFF;
+  const auto hangSup = skydiag::helper::ApplyHangSuppressionTable(
+    skydiag::helper::kDefaultHangSuppressionTable,
     state->hangSuppressionState,
-    decision.isHang,
-    isForeground,
-    decision.isLoading,
-    isWindowResponsive,
-    cfg.suppressHangWhenNotForeground,
-    nowQpc,
-    proc.shm->header.last_heartbeat_qpc,
-    proc.shm->header.qpc_freq,
-    cfg.foregroundGraceSec);
+    inputs,
+    &ruleIndex);
+  if (cfg.enableHangSuppressionTrace) {
+    skydiag::helper::HangSuppressionTraceRecord record{};
+    record.inputs = inputs;
+    record.confirmedPhase = confirmedPhase;
+    record.secondsSinceHeartbeat = decision.secondsSinceHeartbeat;
+    record.thresholdSec = decision.thresholdSec;
+    record.stateFlags = stateFlags;
+    record.recorded = hangSup;
+    record.recordedRule = skydiag::helper::HangSuppressionRuleName(ruleIndex);
+    AppendHangSuppressionTrace(outBase, record);
+    state->hangSuppressionTraceOpen = true;
+  }
   if (!hangSup.suppress) {
     return false;
   }
+  skydiag::helper::HelperPerf().Increment(skydiag::helper::PerfCounter::kHangSuppressed);
 
   if (hangSup.reason == skydiag::helper::HangSuppressionReason::kNotForeground) {
     if (!state->hangSuppressedNotForegroundThisEpisode) {
@@ -108,4 +168,38 @@ bool SuppressHangAndLogIfNeeded(
   return true;
 }
 
+void CloseHangSuppressionTraceEpisode(
+  const skydiag::helper::HelperConfig& cfg,
+  const skydiag::helper::AttachedProcess& proc,
+  const std::filesystem::path& outBase,
+  const skydiag::helper::HangDecision& decision,
+  std::uint32_t stateFlags,
+  std::uint64_t nowQpc,
+  HangCaptureState* state)
+{
+  if (!state || !state->hangSuppressionTraceOpen) {
+    return;
+  }
+  state->hangSuppressionTraceOpen = false;
+  if (!cfg.enableHangSuppressionTrace) {
+    return;
+  }
+
+  skydiag::helper::HangSuppressionTraceRecord record{};
+  record.inputs = MakeHangSuppressionInputs(
+    cfg,
+    proc,
+    decision,
+    stateFlags,
+    nowQpc,
+    IsPidInForeground(proc.pid),
+    /*isWindowResponsive=*/false);
+  record.secondsSinceHeartbeat = decision.secondsSinceHeartbeat;
+  record.thresholdSec = decision.thresholdSec;
+  record.stateFlags = stateFlags;
+  record.recorded = skydiag::helper::HangSuppressionResult{};
+  record.recordedRule = skydiag::helper::HangSuppressionRuleName(0);
+  AppendHangSuppressionTrace(outBase, record);
+}
+
 }  // namespace skydiag::helper::internal
@@ -0,0 +1,152 @@
+#include "HangCaptureInternal.h"
+
+#include <Windows.h>
+
+#include <TlHelp32.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SkyrimDiagHelper/DumpWriter.h"
+#include "SkyrimDiagHelper/HangPrecapture.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
+
+namespace skydiag::helper::internal {
+namespace {
+
+std::vector<DWORD> EnumerateProcessThreads(DWORD pid)
+{
+  std::vector<DWORD> tids;
+
+  HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+  if (snap == INVALID_HANDLE_VALUE) {
+    return tids;
+  }
+
+  THREADENTRY32 te{};
+  te.dwSize = sizeof(te);
+  for (BOOL ok = Thread32First(snap, &te); ok; ok = Thread32Next(snap, &te)) {
+    if (te.th32OwnerProcessID == pid) {
+      tids.push_back(te.th32ThreadID);
+    }
+  }
+
+  CloseHandle(snap);
+  return tids;
+}
+
+// Suspend only long enough to read a consistent register set and the top of
+// the stack. Threads we cannot open (exiting, protected) are skipped.
+bool SampleThread(HANDLE process, DWORD tid, skydiag::helper::HangPrecaptureThreadSample& out)
+{
+  HANDLE thread = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_LIMITED_INFORMATION, FALSE, tid);
+  if (!thread) {
+    return false;
+  }
+  if (SuspendThread(thread) == static_cast<DWORD>(-1)) {
+    CloseHandle(thread);
+    return false;
+  }
+
+  CONTEXT ctx{};
+  ctx.ContextFlags = CONTEXT_CONTROL;
+  bool ok = GetThreadContext(thread, &ctx) != FALSE;
+  if (ok) {
+    out.tid = tid;
+    out.rip = ctx.Rip;
+    out.rsp = ctx.Rsp;
+    SIZE_T read = 0;
+    if (ReadProcessMemory(
+          process,
+          reinterpret_cast<LPCVOID>(static_cast<std::uintptr_t>(ctx.Rsp)),
+          out.stackWords.data(),
+          sizeof(out.stackWords),
+          &read) ||
+        read > 0) {
+      out.stackWordCount = static_cast<std::uint32_t>(read / sizeof(std::uint64_t));
+    }
+  }
+
+  ResumeThread(thread);
+  CloseHandle(thread);
+  return ok;
+}
+
+}  // namespace
+
+void MaybeSampleHangPrecapture(
+  const skydiag::helper::HelperConfig& cfg,
+  const skydiag::helper::AttachedProcess& proc,
+  const skydiag::helper::HangDecision& decision,
+  std::uint32_t stateFlags,
+  std::uint64_t nowQpc,
+  HangCaptureState* state)
+{
+  if (!state || !cfg.enableHangPrecapture || !proc.process || !proc.shm) {
+    return;
+  }
+
+  auto& ring = state->precaptureRing;
+  ring.SetCapacity(cfg.hangPrecaptureMaxSnapshots);
+  if (!skydiag::helper::IsInHangPrecaptureWindow(decision, cfg.hangPrecaptureStartPercent)) {
+    // Heartbeat caught up (or the hang already fired): the history no longer
+    // leads into anything we will capture.
+    if (!ring.Empty() && !decision.isHang) {
+      ring.Clear();
+    }
+    return;
+  }
+  if (!skydiag::helper::ShouldTakeHangPrecaptureSample(
+        decision,
+        cfg.hangPrecaptureStartPercent,
+        nowQpc,
+        ring.LastSampleQpc(),
+        proc.shm->header.qpc_freq,
+        cfg.hangPrecaptureIntervalMs)) {
+    return;
+  }
+
+  const skydiag::helper::ScopedPerfTimer perfTimer(skydiag::helper::PerfStage::kHangPrecaptureSample);
+  skydiag::helper::HangPrecaptureSnapshot snapshot{};
+  snapshot.qpc = nowQpc;
+  snapshot.secondsSinceHeartbeat = decision.secondsSinceHeartbeat;
+  snapshot.thresholdSec = decision.thresholdSec;
+  snapshot.stateFlags = stateFlags;
+  if (const auto mainTid = skydiag::helper::InferMainThreadIdFromSnapshot(proc.shm, proc.shmSize)) {
+    snapshot.mainThreadId = *mainTid;
+  }
+
+  auto tids = EnumerateProcessThreads(proc.pid);
+  if (snapshot.mainThreadId != 0u) {
+    const auto it = std::find(tids.begin(), tids.end(), static_cast<DWORD>(snapshot.mainThreadId));
+    if (it != tids.end()) {
+      std::rotate(tids.begin(), it, it + 1);
+    }
+  }
+  if (tids.size() > cfg.hangPrecaptureMaxThreads) {
+    tids.resize(cfg.hangPrecaptureMaxThreads);
+  }
+
+  snapshot.threads.reserve(tids.size());
+  for (const DWORD tid : tids) {
+    skydiag::helper::HangPrecaptureThreadSample sample{};
+    if (SampleThread(proc.process, tid, sample)) {
+      snapshot.threads.push_back(sample);
+    }
+  }
+  ring.Push(std::move(snapshot));
+}
+
+std::string TakeHangPrecaptureJson(const skydiag::helper::AttachedProcess& proc, HangCaptureState* state)
+{
+  if (!state || state->precaptureRing.Empty() || !proc.shm) {
+    return {};
+  }
+  auto json = skydiag::helper::SerializeHangPrecaptureRing(state->precaptureRing, proc.shm->header.qpc_freq);
+  state->precaptureRing.Clear();
+  return json;
+}
+
+}  // namespace skydiag::helper::internal
@@ -107,6 +107,21 @@ HangTickResult HandleHangTick(
     loadingThresholdSec);
 
   if (!decision.isHang) {
+    MaybeSampleHangPrecapture(
+      cfg,
+      proc,
+      decision,
+      stateFlags,
+      static_cast<std::uint64_t>(now.QuadPart),
+      state);
+    CloseHangSuppressionTraceEpisode(
+      cfg,
+      proc,
+      outBase,
+      decision,
+      stateFlags,
+      static_cast<std::uint64_t>(now.QuadPart),
+      state);
     ResetHangCaptureEpisode(state);
     return HangTickResult::kContinue;
   }
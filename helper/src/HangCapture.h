@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <string>
 
+#include "SkyrimDiagHelper/HangPrecapture.h"
 #include "SkyrimDiagHelper/HangSuppression.h"
 
 namespace skydiag::helper {
@@ -26,10 +27,17 @@ struct HangCaptureState
   bool hangSuppressedForegroundResponsiveThisEpisode = false;
 
   skydiag::helper::HangSuppressionState hangSuppressionState{};
+  // Set once a trace record was written for the current hang episode, so the
+  // episode end can be recorded too (EnableHangSuppressionTrace).
+  bool hangSuppressionTraceOpen = false;
   HWND targetWindow = nullptr;
 
   bool wasLoading = false;
   std::uint64_t loadStartQpc = 0;
+
+  // Lightweight thread snapshots taken while the heartbeat is late but the
+  // hang threshold has not fired yet; embedded into the next hang dump.
+  skydiag::helper::HangPrecaptureRing precaptureRing{};
 };
 
 enum class HangTickResult : std::uint8_t {
@@ -28,6 +28,27 @@ bool SuppressHangAndLogIfNeeded(
   bool confirmedPhase,
   HangCaptureState* state);
 
+// Writes the is_hang=false record that closes a traced hang episode.
+void CloseHangSuppressionTraceEpisode(
+  const skydiag::helper::HelperConfig& cfg,
+  const skydiag::helper::AttachedProcess& proc,
+  const std::filesystem::path& outBase,
+  const skydiag::helper::HangDecision& decision,
+  std::uint32_t stateFlags,
+  std::uint64_t nowQpc,
+  HangCaptureState* state);
+
+void MaybeSampleHangPrecapture(
+  const skydiag::helper::HelperConfig& cfg,
+  const skydiag::helper::AttachedProcess& proc,
+  const skydiag::helper::HangDecision& decision,
+  std::uint32_t stateFlags,
+  std::uint64_t nowQpc,
+  HangCaptureState* state);
+
+// Serializes and clears the pre-capture ring; empty when nothing was sampled.
+std::string TakeHangPrecaptureJson(const skydiag::helper::AttachedProcess& proc, HangCaptureState* state);
+
 HangTickResult ExecuteConfirmedHangCapture(
   const skydiag::helper::HelperConfig& cfg,
   const skydiag::helper::AttachedProcess& proc,
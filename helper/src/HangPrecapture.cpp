@@ -0,0 +1,126 @@
+#include "SkyrimDiagHelper/HangPrecapture.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace skydiag::helper {
+
+HangPrecaptureRing::HangPrecaptureRing(std::size_t capacity)
+{
+  SetCapacity(capacity);
+}
+
+void HangPrecaptureRing::SetCapacity(std::size_t capacity)
+{
+  capacity = std::max<std::size_t>(capacity, 1u);
+  if (capacity == m_slots.size()) {
+    return;
+  }
+  m_slots.assign(capacity, HangPrecaptureSnapshot{});
+  m_head = 0;
+  m_count = 0;
+  m_dropped = 0;
+  m_lastSampleQpc = 0;
+}
+
+void HangPrecaptureRing::Push(HangPrecaptureSnapshot snapshot)
+{
+  m_lastSampleQpc = snapshot.qpc;
+  m_slots[m_head] = std::move(snapshot);
+  m_head = (m_head + 1u) % m_slots.size();
+  if (m_count < m_slots.size()) {
+    ++m_count;
+  } else {
+    ++m_dropped;
+  }
+}
+
+void HangPrecaptureRing::Clear()
+{
+  for (auto& slot : m_slots) {
+    slot = HangPrecaptureSnapshot{};
+  }
+  m_head = 0;
+  m_count = 0;
+  m_dropped = 0;
+  m_lastSampleQpc = 0;
+}
+
+const HangPrecaptureSnapshot& HangPrecaptureRing::At(std::size_t index) const
+{
+  const std::size_t oldest = (m_head + m_slots.size() - m_count) % m_slots.size();
+  return m_slots[(oldest + index) % m_slots.size()];
+}
+
+bool IsInHangPrecaptureWindow(const HangDecision& decision, std::uint32_t startPercent)
+{
+  if (decision.isHang || decision.thresholdSec == 0u || startPercent == 0u || startPercent >= 100u) {
+    return false;
+  }
+  const double startSec = static_cast<double>(decision.thresholdSec) * static_cast<double>(startPercent) / 100.0;
+  return decision.secondsSinceHeartbeat >= startSec;
+}
+
+bool ShouldTakeHangPrecaptureSample(
+  const HangDecision& decision,
+  std::uint32_t startPercent,
+  std::uint64_t nowQpc,
+  std::uint64_t lastSampleQpc,
+  std::uint64_t qpcFreq,
+  std::uint32_t intervalMs)
+{
+  if (!IsInHangPrecaptureWindow(decision, startPercent) || qpcFreq == 0u) {
+    return false;
+  }
+  if (lastSampleQpc == 0u || nowQpc < lastSampleQpc) {
+    return true;
+  }
+  const std::uint64_t intervalQpc = (qpcFreq * intervalMs) / 1000u;
+  return (nowQpc - lastSampleQpc) >= intervalQpc;
+}
+
+std::string SerializeHangPrecaptureRing(const HangPrecaptureRing& ring, std::uint64_t qpcFreq)
+{
+  if (ring.Empty()) {
+    return {};
+  }
+
+  const std::uint64_t firstQpc = ring.At(0).qpc;
+  nlohmann::json snapshots = nlohmann::json::array();
+  for (std::size_t i = 0; i < ring.Size(); ++i) {
+    const auto& snapshot = ring.At(i);
+    nlohmann::json threads = nlohmann::json::array();
+    for (const auto& thread : snapshot.threads) {
+      const auto wordCount = std::min<std::size_t>(thread.stackWordCount, kHangPrecaptureStackWords);
+      threads.push_back({
+        { "tid", thread.tid },
+        { "rip", thread.rip },
+        { "rsp", thread.rsp },
+        { "stack", std::vector<std::uint64_t>(thread.stackWords.begin(), thread.stackWords.begin() + wordCount) },
+      });
+    }
+    const std::uint64_t offsetMs = (qpcFreq != 0u && snapshot.qpc >= firstQpc)
+      ? ((snapshot.qpc - firstQpc) * 1000u) / qpcFreq
+      : 0u;
+    snapshots.push_back({
+      { "offset_ms", offsetMs },
+      { "seconds_since_heartbeat", snapshot.secondsSinceHeartbeat },
+      { "threshold_sec", snapshot.thresholdSec },
+      { "state_flags", snapshot.stateFlags },
+      { "main_tid", snapshot.mainThreadId },
+      { "threads", std::move(threads) },
+    });
+  }
+
+  nlohmann::json j = nlohmann::json::object();
+  j["version"] = kHangPrecaptureFormatVersion;
+  j["capacity"] = ring.Capacity();
+  j["dropped"] = ring.DroppedCount();
+  j["stack_words"] = kHangPrecaptureStackWords;
+  j["snapshots"] = std::move(snapshots);
+  return j.dump();
+}
+
+}  // namespace skydiag::helper
@@ -0,0 +1,103 @@
+#include "SkyrimDiagHelper/HangSuppressionTrace.h"
+
+#include <nlohmann/json.hpp>
+
+namespace skydiag::helper {
+
+const char* HangSuppressionRuleName(std::uint8_t ruleIndex)
+{
+  if (ruleIndex < kDefaultHangSuppressionRules.size()) {
+    return kDefaultHangSuppressionRules[ruleIndex].name;
+  }
+  return "none";
+}
+
+std::optional<HangSuppressionReason> TryParseHangSuppressionReason(std::string_view name)
+{
+  for (const auto reason : { HangSuppressionReason::kNone,
+                             HangSuppressionReason::kNotForeground,
+                             HangSuppressionReason::kForegroundGrace,
+                             HangSuppressionReason::kForegroundResponsive }) {
+    if (name == HangSuppressionReasonName(reason)) {
+      return reason;
+    }
+  }
+  return std::nullopt;
+}
+
+std::string SerializeHangSuppressionTraceRecord(const HangSuppressionTraceRecord& record)
+{
+  const auto& in = record.inputs;
+  nlohmann::json j = nlohmann::json::object();
+  j["now_qpc"] = in.nowQpc;
+  j["heartbeat_qpc"] = in.heartbeatQpc;
+  j["qpc_freq"] = in.qpcFreq;
+  j["is_hang"] = in.isHang;
+  j["is_foreground"] = in.isForeground;
+  j["is_loading"] = in.isLoading;
+  j["in_menu"] = in.isInMenu;
+  j["window_responsive"] = in.isWindowResponsive;
+  j["suppress_when_not_foreground"] = in.suppressHangWhenNotForeground;
+  j["foreground_grace_sec"] = in.foregroundGraceSec;
+  j["phase"] = record.confirmedPhase ? "confirmed" : "detected";
+  j["seconds_since_heartbeat"] = record.secondsSinceHeartbeat;
+  j["threshold_sec"] = record.thresholdSec;
+  j["state_flags"] = record.stateFlags;
+  if (record.recorded) {
+    j["suppress"] = record.recorded->suppress;
+    j["reason"] = HangSuppressionReasonName(record.recorded->reason);
+    if (!record.recordedRule.empty()) {
+      j["rule"] = record.recordedRule;
+    }
+  }
+  if (!record.label.empty()) {
+    j["label"] = record.label;
+  }
+  return j.dump();
+}
+
+bool TryParseHangSuppressionTraceRecord(std::string_view line, HangSuppressionTraceRecord& out)
+{
+  const auto j = nlohmann::json::parse(line.begin(), line.end(), nullptr, /*allow_exceptions=*/false);
+  if (!j.is_object()) {
+    return false;
+  }
+
+  HangSuppressionTraceRecord rec{};
+  try {
+    auto& in = rec.inputs;
+    in.nowQpc = j.value("now_qpc", std::uint64_t{ 0 });
+    in.heartbeatQpc = j.value("heartbeat_qpc", std::uint64_t{ 0 });
+    in.qpcFreq = j.value("qpc_freq", std::uint64_t{ 0 });
+    in.isHang = j.value("is_hang", false);
+    in.isForeground = j.value("is_foreground", false);
+    in.isLoading = j.value("is_loading", false);
+    in.isInMenu = j.value("in_menu", false);
+    in.isWindowResponsive = j.value("window_responsive", false);
+    in.suppressHangWhenNotForeground = j.value("suppress_when_not_foreground", true);
+    in.foregroundGraceSec = j.value("foreground_grace_sec", std::uint32_t{ 0 });
+    rec.confirmedPhase = j.value("phase", std::string("confirmed")) != "detected";
+    rec.secondsSinceHeartbeat = j.value("seconds_since_heartbeat", 0.0);
+    rec.thresholdSec = j.value("threshold_sec", std::uint32_t{ 0 });
+    rec.stateFlags = j.value("state_flags", std::uint32_t{ 0 });
+    if (j.contains("suppress")) {
+      HangSuppressionResult recorded{};
+      recorded.suppress = j.at("suppress").get<bool>();
+      const auto reason = TryParseHangSuppressionReason(j.value("reason", std::string("none")));
+      if (!reason) {
+        return false;
+      }
+      recorded.reason = *reason;
+      rec.recorded = recorded;
+      rec.recordedRule = j.value("rule", std::string());
+    }
+    rec.label = j.value("label", std::string());
+  } catch (const nlohmann::json::exception&) {
+    return false;
+  }
+
+  out = std::move(rec);
+  return true;
+}
+
+}  // namespace skydiag::helper
@@ -13,10 +13,13 @@
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
 #include "SkyrimDiagHelper/Config.h"
+#include "SkyrimDiagHelper/CrashLoopPolicy.h"
+#include "SkyrimDiagHelper/CrashRecapturePolicy.h"
 
 namespace skydiag::helper::internal {
 namespace {
@@ -29,21 +32,54 @@ std::filesystem::path CrashBucketStatsPath(const std::filesystem::path& outBase)
   return outBase / L"SkyrimDiag_CrashBucketStats.json";
 }
 
-bool JsonArrayContainsString(const nlohmann::json& array, std::string_view needle)
+// Missing file yields an empty document; a corrupt one is quarantined and
+// replaced by an empty document.
+bool LoadCrashBucketStatsRoot(const std::filesystem::path& path, nlohmann::json* out, std::wstring* err)
 {
-  if (!array.is_array() || needle.empty()) {
+  nlohmann::json root = nlohmann::json::object();
+  std::error_code existsEc;
+  const bool statsExist = std::filesystem::exists(path, existsEc);
+  if (existsEc) {
+    if (err) {
+      *err = L"crash bucket stats existence check failed: "
+        + std::to_wstring(existsEc.value());
+    }
     return false;
   }
-  for (const auto& item : array) {
-    if (!item.is_string()) {
-      continue;
+  if (statsExist) {
+    std::string txt;
+    if (!ReadTextFileUtf8(path, &txt)) {
+      if (err) {
+        *err = L"crash bucket stats read failed";
+      }
+      return false;
     }
-    const auto value = item.get<std::string>();
-    if (value.find(needle) != std::string::npos) {
-      return true;
+    const auto parsed = nlohmann::json::parse(txt, nullptr, false);
+    if (!parsed.is_discarded() && parsed.is_object()) {
+      root = parsed;
+    } else {
+      auto quarantinePath = path;
+      quarantinePath += L".corrupt." + Timestamp();
+      std::error_code quarantineEc;
+      std::filesystem::rename(path, quarantinePath, quarantineEc);
+      if (quarantineEc) {
+        if (err) {
+          *err = L"crash bucket stats parse failed and corrupt file quarantine failed: "
+            + std::to_wstring(quarantineEc.value());
+        }
+        return false;
+      }
     }
   }
-  return false;
+  if (!root.contains("version")) {
+    root["version"] = 1;
+  }
+  if (!root.contains("buckets") || !root["buckets"].is_object()) {
+    root["buckets"] = nlohmann::json::object();
+  }
+
+  *out = std::move(root);
+  return true;
 }
 
 }  // namespace
@@ -298,10 +334,23 @@ bool TryLoadCrashSummaryInfo(const std::filesystem::path& summaryPath, CrashSumm
     }
   }
 
-  if (root.contains("diagnostics")) {
-    info.stackwalkDegraded = JsonArrayContainsString(
-      root["diagnostics"],
-      "[Stackwalk] DbgHelp stackwalk failed");
+  {
+    std::optional<bool> stackScanFallback;
+    if (root.contains("callstack") && root["callstack"].is_object()) {
+      const auto& callstack = root["callstack"];
+      if (callstack.contains("stack_scan_fallback") && callstack["stack_scan_fallback"].is_boolean()) {
+        stackScanFallback = callstack["stack_scan_fallback"].get<bool>();
+      }
+    }
+    std::vector<std::string> diagnostics;
+    if (!stackScanFallback.has_value() && root.contains("diagnostics") && root["diagnostics"].is_array()) {
+      for (const auto& item : root["diagnostics"]) {
+        if (item.is_string()) {
+          diagnostics.push_back(item.get<std::string>());
+        }
+      }
+    }
+    info.stackwalkDegraded = skydiag::helper::IsStackwalkDegraded(stackScanFallback, diagnostics);
   }
 
   const auto parseFirstChanceContext = [&root, &info](const nlohmann::json& firstChance) {
@@ -359,48 +408,10 @@ bool UpdateCrashBucketStats(
   }
 
   const auto path = CrashBucketStatsPath(outBase);
-
-  nlohmann::json root = nlohmann::json::object();
-  std::error_code existsEc;
-  const bool statsExist = std::filesystem::exists(path, existsEc);
-  if (existsEc) {
-    if (err) {
-      *err = L"crash bucket stats existence check failed: "
-        + std::to_wstring(existsEc.value());
-    }
+  nlohmann::json root;
+  if (!LoadCrashBucketStatsRoot(path, &root, err)) {
     return false;
   }
-  if (statsExist) {
-    std::string txt;
-    if (!ReadTextFileUtf8(path, &txt)) {
-      if (err) {
-        *err = L"crash bucket stats read failed";
-      }
-      return false;
-    }
-    const auto parsed = nlohmann::json::parse(txt, nullptr, false);
-    if (!parsed.is_discarded() && parsed.is_object()) {
-      root = parsed;
-    } else {
-      auto quarantinePath = path;
-      quarantinePath += L".corrupt." + Timestamp();
-      std::error_code quarantineEc;
-      std::filesystem::rename(path, quarantinePath, quarantineEc);
-      if (quarantineEc) {
-        if (err) {
-          *err = L"crash bucket stats parse failed and corrupt file quarantine failed: "
-            + std::to_wstring(quarantineEc.value());
-        }
-        return false;
-      }
-    }
-  }
-  if (!root.contains("version")) {
-    root["version"] = 1;
-  }
-  if (!root.contains("buckets") || !root["buckets"].is_object()) {
-    root["buckets"] = nlohmann::json::object();
-  }
 
   auto& bucket = root["buckets"][info.bucketKey];
   if (!bucket.is_object()) {
@@ -443,4 +454,121 @@ bool UpdateCrashBucketStats(
   return true;
 }
 
+namespace {
+
+skydiag::helper::CrashLoopHistory CrashLoopHistoryFromJson(const nlohmann::json& entry)
+{
+  skydiag::helper::CrashLoopHistory history{};
+  if (!entry.is_object()) {
+    return history;
+  }
+  const auto stamps = entry.find("rich_capture_epochs");
+  if (stamps != entry.end() && stamps->is_array()) {
+    for (const auto& t : *stamps) {
+      if (t.is_number_unsigned()) {
+        history.richCaptureUnixSec.push_back(t.get<std::uint64_t>());
+      }
+    }
+    std::sort(history.richCaptureUnixSec.begin(), history.richCaptureUnixSec.end());
+  }
+  history.thinSinceRich = entry.value("thin_since_rich", 0u);
+  history.thinTotal = entry.value("thin_total", 0u);
+  return history;
+}
+
+}  // namespace
+
+bool LoadCrashLoopHistory(
+  const std::filesystem::path& outBase,
+  std::string_view key,
+  skydiag::helper::CrashLoopHistory* out,
+  std::wstring* err)
+{
+  if (out) {
+    *out = skydiag::helper::CrashLoopHistory{};
+  }
+  nlohmann::json root;
+  if (!LoadCrashBucketStatsRoot(CrashBucketStatsPath(outBase), &root, err)) {
+    return false;
+  }
+  const auto loops = root.find("crash_loops");
+  if (out && loops != root.end() && loops->is_object()) {
+    const auto entry = loops->find(std::string(key));
+    if (entry != loops->end()) {
+      *out = CrashLoopHistoryFromJson(*entry);
+    }
+  }
+  if (err) {
+    err->clear();
+  }
+  return true;
+}
+
+bool UpdateCrashLoopHistory(
+  const std::filesystem::path& outBase,
+  std::string_view key,
+  bool richCapture,
+  std::uint64_t nowUnixSec,
+  std::uint32_t windowSec,
+  skydiag::helper::CrashLoopHistory* outHistory,
+  std::wstring* err)
+{
+  if (key.empty()) {
+    if (err) {
+      *err = L"missing crash loop key";
+    }
+    return false;
+  }
+
+  const auto path = CrashBucketStatsPath(outBase);
+  nlohmann::json root;
+  if (!LoadCrashBucketStatsRoot(path, &root, err)) {
+    return false;
+  }
+  if (!root.contains("crash_loops") || !root["crash_loops"].is_object()) {
+    root["crash_loops"] = nlohmann::json::object();
+  }
+  auto& entry = root["crash_loops"][std::string(key)];
+
+  auto history = CrashLoopHistoryFromJson(entry);
+  skydiag::helper::RecordCrashLoopCapture(&history, richCapture, nowUnixSec, windowSec);
+
+  entry = nlohmann::json::object();
+  entry["rich_capture_epochs"] = history.richCaptureUnixSec;
+  entry["thin_since_rich"] = history.thinSinceRich;
+  entry["thin_total"] = history.thinTotal;
+  entry["updated_at_epoch"] = nowUnixSec;
+
+  auto& loops = root["crash_loops"];
+  std::vector<skydiag::helper::CrashLoopEntryAge> ages;
+  ages.reserve(loops.size());
+  for (auto it = loops.begin(); it != loops.end(); ++it) {
+    std::uint64_t updated = 0;
+    if (it->is_object()) {
+      const auto at = it->find("updated_at_epoch");
+      if (at != it->end() && at->is_number_unsigned()) {
+        updated = at->get<std::uint64_t>();
+      }
+    }
+    ages.push_back({ it.key(), updated });
+  }
+  for (const auto& stale : skydiag::helper::SelectCrashLoopKeysToPrune(std::move(ages), key, nowUnixSec, windowSec)) {
+    loops.erase(stale);
+  }
+
+  if (!WriteTextFileUtf8(path, root.dump(2))) {
+    if (err) {
+      *err = L"crash bucket stats atomic write failed";
+    }
+    return false;
+  }
+  if (outHistory) {
+    *outHistory = std::move(history);
+  }
+  if (err) {
+    err->clear();
+  }
+  return true;
+}
+
 }  // namespace skydiag::helper::internal
@@ -8,6 +8,7 @@
 
 namespace skydiag::helper {
 struct HelperConfig;
+struct CrashLoopHistory;
 }
 
 namespace skydiag::helper::internal {
@@ -49,4 +50,21 @@ bool UpdateCrashBucketStats(
   std::uint32_t* outBucketSeenCount,
   std::wstring* err);
 
+// Crash-loop history lives in the crash bucket stats file under "crash_loops",
+// keyed by the capture-time fingerprint (BuildCrashLoopKey).
+bool LoadCrashLoopHistory(
+  const std::filesystem::path& outBase,
+  std::string_view key,
+  skydiag::helper::CrashLoopHistory* out,
+  std::wstring* err);
+
+bool UpdateCrashLoopHistory(
+  const std::filesystem::path& outBase,
+  std::string_view key,
+  bool richCapture,
+  std::uint64_t nowUnixSec,
+  std::uint32_t windowSec,
+  skydiag::helper::CrashLoopHistory* outHistory,
+  std::wstring* err);
+
 }  // namespace skydiag::helper::internal
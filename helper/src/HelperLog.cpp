@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <string>
 
 #include "HelperCommon.h"
@@ -12,6 +13,8 @@ namespace {
 
 std::uint64_t g_maxHelperLogBytes = 0;
 std::uint32_t g_maxHelperLogFiles = 0;
+// Post-process workers log too; rotation and the append must not interleave.
+std::mutex g_logMutex;
 
 }  // namespace
 
@@ -37,6 +40,7 @@ void AppendLogLine(const std::filesystem::path& outBase, std::wstring_view line)
   std::filesystem::create_directories(outBase, ec);
 
   const auto path = outBase / L"SkyrimDiagHelper.log";
+  std::lock_guard lock(g_logMutex);
   skydiag::helper::RotateLogFileIfNeeded(path, g_maxHelperLogBytes, g_maxHelperLogFiles);
   std::ofstream f(path, std::ios::binary | std::ios::app);
   if (!f) {
@@ -4,8 +4,10 @@
 #include <string>
 
 #include "CrashCapture.h"
+#include "HelperCommon.h"
 #include "HelperLog.h"
 #include "ManualCapture.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
 
 namespace {
 
@@ -16,6 +18,14 @@ constexpr std::uint64_t kCrashEventWarnIntervalMs = 30000;
 
 namespace skydiag::helper::internal {
 
+void WriteHelperPerfReport(const std::filesystem::path& outBase)
+{
+  const auto perfPath = outBase / L"SkyrimDiagHelper_Perf.json";
+  if (!WriteTextFileUtf8(perfPath, skydiag::helper::SerializeHelperPerf(skydiag::helper::HelperPerf()))) {
+    AppendLogLine(outBase, L"Failed to write helper perf report: " + perfPath.wstring());
+  }
+}
+
 bool TryTriggerManualCapture(
   const HelperConfig& cfg,
   const AttachedProcess& proc,
@@ -101,6 +111,7 @@ void RunHelperLoop(
   }
 
   for (;;) {
+    skydiag::helper::HelperPerf().Increment(skydiag::helper::PerfCounter::kLoopIterations);
     PumpManualCaptureInputs(cfg, proc, outBase, loadStats, *adaptiveLoadingThresholdSec);
 
     FinalizePendingCrashAnalysisIfReady(cfg, proc, outBase, &state->pendingCrashAnalysis);
@@ -130,7 +141,14 @@ void RunHelperLoop(
 
     if (!proc.crashEvent) {
       const auto nowTick = GetTickCount64();
-      if (state->nextCrashEventRetryTick64 == 0 || nowTick >= state->nextCrashEventRetryTick64) {
+      // The plugin signals its ready event right after creating the crash
+      // event, so try immediately instead of waiting for the retry tick.
+      const bool pluginBecameReady = !state->pluginReadySeen && skydiag::helper::IsPluginReady(proc, 0);
+      if (pluginBecameReady) {
+        state->pluginReadySeen = true;
+      }
+      if (pluginBecameReady || state->nextCrashEventRetryTick64 == 0 || nowTick >= state->nextCrashEventRetryTick64) {
+        skydiag::helper::HelperPerf().Increment(skydiag::helper::PerfCounter::kCrashEventRetries);
         if (skydiag::helper::TryAttachCrashEvent(proc, nullptr)) {
           AppendLogLine(outBase, L"Crash event recovered; crash capture path is enabled.");
           state->nextCrashEventWarnTick64 = 0;
@@ -162,16 +180,21 @@ void RunHelperLoop(
           &state->pendingCrashViewerDumpPath)) {
       continue;
     }
-    if (HandleHangTick(
-          cfg,
-          proc,
-          outBase,
-          loadStats,
-          loadStatsPath,
-          adaptiveLoadingThresholdSec,
-          attachNowQpc,
-          &state->pendingHangViewerDumpPath,
-          &state->hangState) == HangTickResult::kBreak) {
+    HangTickResult hangTick = HangTickResult::kContinue;
+    {
+      const skydiag::helper::ScopedPerfTimer perfTimer(skydiag::helper::PerfStage::kHangTick);
+      hangTick = HandleHangTick(
+        cfg,
+        proc,
+        outBase,
+        loadStats,
+        loadStatsPath,
+        adaptiveLoadingThresholdSec,
+        attachNowQpc,
+        &state->pendingHangViewerDumpPath,
+        &state->hangState);
+    }
+    if (hangTick == HangTickResult::kBreak) {
       break;
     }
   }
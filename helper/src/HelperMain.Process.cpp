@@ -1,6 +1,7 @@
 #include "HelperMainInternal.h"
 
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <string>
@@ -8,8 +9,14 @@
 #include "CrashCapture.h"
 #include "DumpToolLaunch.h"
 #include "HelperLog.h"
+#include "PostProcessWorker.h"
 
 namespace skydiag::helper::internal {
+namespace {
+
+constexpr DWORD kEnrichmentDrainWaitMs = 5000;
+
+}  // namespace
 
 void DrainCrashEventBeforeExit(
   const HelperConfig& cfg,
@@ -176,6 +183,13 @@ void CleanupCrashArtifactsAfterZeroExit(
         + crashEtwPath.filename().wstring());
   }
 
+  // The process is gone, so a running enrichment write fails fast; wait for
+  // it so its file is not recreated after the removal below.
+  if (!WaitForPostProcessJob(state->crashCaptured.enrichmentJob, std::chrono::milliseconds(kEnrichmentDrainWaitMs))) {
+    AppendLogLine(outBase, L"exit_code=0 after crash capture; crash enrichment is still running during artifact removal.");
+  }
+  state->crashCaptured.enrichmentJob = skydiag::helper::kNoPostProcessJob;
+
   if (!state->capturedCrashDumpPath.empty()) {
     const auto removal = RemoveCrashArtifactsForDump(
       outBase,
@@ -251,7 +265,10 @@ void LaunchDeferredViewersAfterExit(
   if (!state->pendingCrashViewerDumpPath.empty() &&
       cfg.autoOpenViewerOnCrash &&
       exitCode != 0) {
-    const std::wstring deferredDumpPath = state->pendingCrashViewerDumpPath;
+    // The game is gone, so the enrichment has finished or is failing fast.
+    (void)WaitForPostProcessJob(state->crashCaptured.enrichmentJob, std::chrono::milliseconds(kEnrichmentDrainWaitMs));
+    const std::wstring deferredDumpPath =
+      ResolveCrashAnalysisDumpPath(state->pendingCrashViewerDumpPath, state->crashCaptured.enrichmentJob);
     const auto launch = StartDumpToolViewer(
       cfg,
       deferredDumpPath,
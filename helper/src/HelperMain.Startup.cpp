@@ -72,7 +72,7 @@ CrashArtifactRemovalResult RemoveCrashArtifactsForDump(
   }
 
   std::vector<std::filesystem::path> artifacts;
-  artifacts.reserve(8);
+  artifacts.reserve(15);
   if (!preserveDumpFile) {
     artifacts.push_back(dumpFs);
   }
@@ -83,6 +83,17 @@ CrashArtifactRemovalResult RemoveCrashArtifactsForDump(
   artifacts.push_back(dumpFs.parent_path() / (stem + L"_PluginScan.json"));
   artifacts.push_back(outBase / (stem + L".etl"));
 
+  // Two-phase crash capture writes a richer sibling dump that analysis runs on.
+  const std::wstring enrichedStem = stem + L"_Enriched";
+  if (!preserveDumpFile) {
+    artifacts.push_back(dumpFs.parent_path() / (enrichedStem + L".dmp"));
+  }
+  artifacts.push_back(outBase / (enrichedStem + L"_SkyrimDiagBlackbox.jsonl"));
+  artifacts.push_back(outBase / (enrichedStem + L"_SkyrimDiagReport.txt"));
+  artifacts.push_back(outBase / (enrichedStem + L"_SkyrimDiagSummary.json"));
+  artifacts.push_back(outBase / (enrichedStem + L"_SkyrimDiagWct.json"));
+  artifacts.push_back(dumpFs.parent_path() / (enrichedStem + L"_PluginScan.json"));
+
   const std::wstring kCrashStemPrefix = L"SkyrimDiag_Crash_";
   if (stem.rfind(kCrashStemPrefix, 0) == 0) {
     std::wstring ts = stem.substr(kCrashStemPrefix.size());
@@ -154,6 +165,7 @@ void InitializeLoopState(const AttachedProcess& proc, HelperLoopState* state)
   state->hangState.loadStartQpc = state->hangState.wasLoading ? proc.shm->header.start_qpc : 0;
   state->nextCrashEventRetryTick64 = GetTickCount64();
   state->nextCrashEventWarnTick64 = 0;
+  state->pluginReadySeen = skydiag::helper::IsPluginReady(proc, 0);
 }
 
 void RegisterManualCaptureHotkeyIfEnabled(const HelperConfig& cfg, const std::filesystem::path& outBase)
@@ -32,6 +32,9 @@ struct HelperLoopState
   PendingCrashEtwCapture pendingCrashEtw{};
   std::uint64_t nextCrashEventRetryTick64 = 0;
   std::uint64_t nextCrashEventWarnTick64 = 0;
+  // Plugin ready event already observed; after that only the legacy retry
+  // interval applies.
+  bool pluginReadySeen = false;
   std::uint32_t postExitEvidenceSeq = 0;
 };
 
@@ -87,6 +90,9 @@ bool HandleProcessExitTick(
   const AttachedProcess& proc,
   const std::filesystem::path& outBase,
   HelperLoopState* state);
+// Writes SkyrimDiagHelper_Perf.json (stage histograms and counters so far).
+void WriteHelperPerfReport(const std::filesystem::path& outBase);
+
 void RunHelperLoop(
   const HelperConfig& cfg,
   AttachedProcess& proc,
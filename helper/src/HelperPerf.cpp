@@ -0,0 +1,187 @@
+#include "SkyrimDiagHelper/HelperPerf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace skydiag::helper {
+namespace {
+
+void StoreMax(std::atomic<std::uint64_t>& target, std::uint64_t value)
+{
+  std::uint64_t observed = target.load(std::memory_order_relaxed);
+  while (value > observed && !target.compare_exchange_weak(observed, value, std::memory_order_relaxed)) {
+  }
+}
+
+nlohmann::json StageSummaryJson(const PerfHistogram& h)
+{
+  return nlohmann::json{
+    { "count", h.Count() },
+    { "total_us", h.TotalUs() },
+    { "max_us", h.MaxUs() },
+    { "p50_us", h.QuantileUpperUs(0.50) },
+    { "p95_us", h.QuantileUpperUs(0.95) },
+  };
+}
+
+}  // namespace
+
+const char* PerfStageName(PerfStage stage)
+{
+  switch (stage) {
+    case PerfStage::kHangTick:
+      return "hang_tick";
+    case PerfStage::kCrashEvent:
+      return "crash_event";
+    case PerfStage::kWctCapture:
+      return "wct_capture";
+    case PerfStage::kWctPass:
+      return "wct_pass";
+    case PerfStage::kDumpWrite:
+      return "dump_write";
+    case PerfStage::kMemoryPlan:
+      return "memory_plan";
+    case PerfStage::kHangPrecaptureSample:
+      return "hang_precapture_sample";
+    case PerfStage::kRetentionSweep:
+      return "retention_sweep";
+    case PerfStage::kFreezeExtension:
+      return "freeze_extension";
+    case PerfStage::kCrashFingerprint:
+      return "crash_fingerprint";
+    case PerfStage::kCount:
+      break;
+  }
+  return "unknown";
+}
+
+const char* PerfCounterName(PerfCounter counter)
+{
+  switch (counter) {
+    case PerfCounter::kLoopIterations:
+      return "loop_iterations";
+    case PerfCounter::kHangSuppressed:
+      return "hang_suppressed";
+    case PerfCounter::kCrashEventRetries:
+      return "crash_event_retries";
+    case PerfCounter::kCount:
+      break;
+  }
+  return "unknown";
+}
+
+std::size_t PerfBucketIndex(std::uint64_t us)
+{
+  const auto it = std::lower_bound(kPerfBucketUpperUs.begin(), kPerfBucketUpperUs.end(), us);
+  return static_cast<std::size_t>(it - kPerfBucketUpperUs.begin());
+}
+
+void PerfHistogram::Record(std::uint64_t us)
+{
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_totalUs.fetch_add(us, std::memory_order_relaxed);
+  StoreMax(m_maxUs, us);
+  m_buckets[PerfBucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t PerfHistogram::QuantileUpperUs(double q) const
+{
+  const std::uint64_t count = Count();
+  if (count == 0) {
+    return 0;
+  }
+  q = std::clamp(q, 0.0, 1.0);
+  const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count))));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kPerfBucketUpperUs.size(); ++i) {
+    seen += Bucket(i);
+    if (seen >= rank) {
+      return std::min(kPerfBucketUpperUs[i], MaxUs());
+    }
+  }
+  return MaxUs();
+}
+
+HelperPerfRecorder::HelperPerfRecorder()
+  : m_start(std::chrono::steady_clock::now())
+{}
+
+void HelperPerfRecorder::Record(PerfStage stage, std::uint64_t us)
+{
+  if (stage < PerfStage::kCount) {
+    m_stages[static_cast<std::size_t>(stage)].Record(us);
+  }
+}
+
+void HelperPerfRecorder::Increment(PerfCounter counter, std::uint64_t delta)
+{
+  if (counter < PerfCounter::kCount) {
+    m_counters[static_cast<std::size_t>(counter)].fetch_add(delta, std::memory_order_relaxed);
+  }
+}
+
+double HelperPerfRecorder::SessionSeconds() const
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+HelperPerfRecorder& HelperPerf()
+{
+  static HelperPerfRecorder recorder;
+  return recorder;
+}
+
+ScopedPerfTimer::~ScopedPerfTimer()
+{
+  const auto elapsed = std::chrono::steady_clock::now() - m_start;
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  m_recorder.Record(m_stage, us > 0 ? static_cast<std::uint64_t>(us) : 0u);
+}
+
+std::string SerializeHelperPerf(const HelperPerfRecorder& recorder)
+{
+  nlohmann::json stages = nlohmann::json::object();
+  for (std::size_t i = 0; i < kPerfStageCount; ++i) {
+    const auto stage = static_cast<PerfStage>(i);
+    const auto& h = recorder.Stage(stage);
+    auto entry = StageSummaryJson(h);
+    std::vector<std::uint64_t> buckets(kPerfBucketCount);
+    for (std::size_t b = 0; b < kPerfBucketCount; ++b) {
+      buckets[b] = h.Bucket(b);
+    }
+    entry["buckets"] = std::move(buckets);
+    stages[PerfStageName(stage)] = std::move(entry);
+  }
+
+  nlohmann::json counters = nlohmann::json::object();
+  for (std::size_t i = 0; i < kPerfCounterCount; ++i) {
+    const auto counter = static_cast<PerfCounter>(i);
+    counters[PerfCounterName(counter)] = recorder.Counter(counter);
+  }
+
+  nlohmann::json j = nlohmann::json::object();
+  j["version"] = kHelperPerfFormatVersion;
+  j["session_seconds"] = std::round(recorder.SessionSeconds() * 10.0) / 10.0;
+  j["bucket_upper_us"] = kPerfBucketUpperUs;
+  j["stages"] = std::move(stages);
+  j["counters"] = std::move(counters);
+  return j.dump(2);
+}
+
+std::string SerializeHelperPerfSummary(const HelperPerfRecorder& recorder)
+{
+  nlohmann::json stages = nlohmann::json::object();
+  for (std::size_t i = 0; i < kPerfStageCount; ++i) {
+    const auto stage = static_cast<PerfStage>(i);
+    const auto& h = recorder.Stage(stage);
+    if (h.Count() != 0) {
+      stages[PerfStageName(stage)] = StageSummaryJson(h);
+    }
+  }
+  return stages.dump();
+}
+
+}  // namespace skydiag::helper
@@ -3,6 +3,7 @@
 #include <Windows.h>
 
 #include <filesystem>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -12,6 +13,7 @@
 #include "HelperCommon.h"
 #include "SkyrimDiagHelper/Config.h"
 #include "SkyrimDiagHelper/DumpProfile.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
 
 namespace skydiag::helper::internal {
 namespace {
@@ -34,18 +36,29 @@ nlohmann::json MakeIncidentConfigSnapshotSafe(const skydiag::helper::HelperConfi
   // Keep this snapshot privacy-safe: avoid absolute paths (OutputDir, DumpToolExe, EtwWprExe).
   nlohmann::json j = nlohmann::json::object();
   j["dump_mode"] = DumpModeToString(cfg.dumpMode);
+  j["dump_compression"] = static_cast<std::uint32_t>(cfg.dumpCompression);
 
   j["hang_threshold_in_game_sec"] = cfg.hangThresholdInGameSec;
   j["hang_threshold_in_menu_sec"] = cfg.hangThresholdInMenuSec;
   j["hang_threshold_loading_sec"] = cfg.hangThresholdLoadingSec;
   j["suppress_hang_when_not_foreground"] = cfg.suppressHangWhenNotForeground;
   j["foreground_grace_sec"] = cfg.foregroundGraceSec;
+  j["enable_hang_suppression_trace"] = cfg.enableHangSuppressionTrace;
+  j["enable_hang_precapture"] = cfg.enableHangPrecapture;
+  j["hang_precapture_start_percent"] = cfg.hangPrecaptureStartPercent;
+  j["hang_precapture_interval_ms"] = cfg.hangPrecaptureIntervalMs;
+  j["hang_precapture_max_snapshots"] = cfg.hangPrecaptureMaxSnapshots;
+  j["hang_precapture_max_threads"] = cfg.hangPrecaptureMaxThreads;
 
   j["enable_manual_capture_hotkey"] = cfg.enableManualCaptureHotkey;
   j["enable_compatibility_preflight"] = cfg.enableCompatibilityPreflight;
   j["auto_analyze_dump"] = cfg.autoAnalyzeDump;
   j["allow_online_symbols"] = cfg.allowOnlineSymbols;
   j["enable_wer_dump_fallback_hint"] = cfg.enableWerDumpFallbackHint;
+  j["enable_two_phase_crash_capture"] = cfg.enableTwoPhaseCrashCapture;
+  j["enable_crash_loop_backoff"] = cfg.enableCrashLoopBackoff;
+  j["crash_loop_rich_capture_limit"] = cfg.crashLoopRichCaptureLimit;
+  j["crash_loop_window_sec"] = cfg.crashLoopWindowSec;
 
   j["auto_open_viewer_on_crash"] = cfg.autoOpenViewerOnCrash;
   j["auto_open_crash_only_if_process_exited"] = cfg.autoOpenCrashOnlyIfProcessExited;
@@ -53,6 +66,7 @@ nlohmann::json MakeIncidentConfigSnapshotSafe(const skydiag::helper::HelperConfi
   j["enable_auto_recapture_on_unknown_crash"] = cfg.enableAutoRecaptureOnUnknownCrash;
   j["auto_recapture_unknown_bucket_threshold"] = cfg.autoRecaptureUnknownBucketThreshold;
   j["auto_recapture_analysis_timeout_sec"] = cfg.autoRecaptureAnalysisTimeoutSec;
+  j["enable_incremental_crash_recapture"] = cfg.enableIncrementalCrashRecapture;
 
   j["auto_open_viewer_on_hang"] = cfg.autoOpenViewerOnHang;
   j["auto_open_viewer_on_manual_capture"] = cfg.autoOpenViewerOnManualCapture;
@@ -108,6 +122,8 @@ nlohmann::json MakeCaptureProfileJson(const skydiag::helper::DumpProfile& dumpPr
     { "include_module_headers", dumpProfile.includeModuleHeaders },
     { "include_indirect_memory", dumpProfile.includeIndirectMemory },
     { "ignore_inaccessible_memory", dumpProfile.ignoreInaccessibleMemory },
+    { "include_targeted_memory", dumpProfile.includeTargetedMemory },
+    { "compress_on_disk", dumpProfile.compressOnDisk },
     { "prefer_main_thread", dumpProfile.preferMainThread },
     { "prefer_wct_threads", dumpProfile.preferWctThreads },
     { "prefer_crash_context", dumpProfile.preferCrashContext },
@@ -129,6 +145,41 @@ nlohmann::json MakeRecaptureEvaluationJson(const skydiag::helper::RecaptureDecis
   };
 }
 
+// Updates run on the capture thread and on post-process workers (crash
+// enrichment); the read-modify-write is serialized so neither loses a field.
+std::mutex g_manifestUpdateMutex;
+
+template <class Mutate>
+bool UpdateIncidentManifestFile(const std::filesystem::path& manifestPath, std::wstring* err, Mutate&& mutate)
+{
+  std::lock_guard lock(g_manifestUpdateMutex);
+  std::string txt;
+  if (!ReadTextFileUtf8(manifestPath, &txt)) {
+    if (err) {
+      *err = L"manifest read failed";
+    }
+    return false;
+  }
+  auto j = nlohmann::json::parse(txt, nullptr, false);
+  if (j.is_discarded() || !j.is_object()) {
+    if (err) {
+      *err = L"manifest parse failed";
+    }
+    return false;
+  }
+  mutate(j);
+  if (!WriteTextFileUtf8(manifestPath, j.dump(2))) {
+    if (err) {
+      *err = L"manifest atomic write failed";
+    }
+    return false;
+  }
+  if (err) {
+    err->clear();
+  }
+  return true;
+}
+
 }  // namespace
 
 nlohmann::json MakeIncidentManifestV1(
@@ -179,44 +230,67 @@ nlohmann::json MakeIncidentManifestV1(
   if (includeConfigSnapshot) {
     j["config_snapshot"] = MakeIncidentConfigSnapshotSafe(cfg);
   }
+  // Stage timings so far in this session; the capture that produced this
+  // manifest is included up to the dump write. SkyrimDiagHelper_Perf.json is
+  // only written at helper shutdown, so any copy on disk now belongs to an
+  // earlier session and is not linked as an artifact.
+  j["helper_perf"] = nlohmann::json::parse(
+    skydiag::helper::SerializeHelperPerfSummary(skydiag::helper::HelperPerf()), nullptr, false);
   return j;
 }
 
+void AddIncidentManifestCrashEnrichment(
+  nlohmann::json& manifest,
+  const std::filesystem::path& enrichedDumpPath,
+  std::string_view status,
+  const skydiag::helper::DumpProfile* enrichedProfile)
+{
+  if (!manifest.contains("artifacts") || !manifest["artifacts"].is_object()) {
+    manifest["artifacts"] = nlohmann::json::object();
+  }
+  manifest["artifacts"]["dump_enriched"] =
+    enrichedDumpPath.empty() ? "" : WideToUtf8(enrichedDumpPath.filename().wstring());
+
+  nlohmann::json enrichment = nlohmann::json::object();
+  enrichment["status"] = std::string(status);
+  if (enrichedProfile) {
+    enrichment["capture_profile"] = MakeCaptureProfileJson(*enrichedProfile);
+  }
+  manifest["capture_enrichment"] = std::move(enrichment);
+}
+
 bool TryUpdateIncidentManifestEtw(
   const std::filesystem::path& manifestPath,
   const std::filesystem::path& etwPath,
   std::string_view etwStatus,
   std::wstring* err)
 {
-  std::string txt;
-  if (!ReadTextFileUtf8(manifestPath, &txt)) {
-    if (err) {
-      *err = L"manifest read failed";
+  return UpdateIncidentManifestFile(manifestPath, err, [&](nlohmann::json& j) {
+    if (!j.contains("artifacts") || !j["artifacts"].is_object()) {
+      j["artifacts"] = nlohmann::json::object();
     }
-    return false;
-  }
-  auto j = nlohmann::json::parse(txt, nullptr, false);
-  if (j.is_discarded() || !j.is_object()) {
-    if (err) {
-      *err = L"manifest parse failed";
+    j["artifacts"]["etw"] = WideToUtf8(etwPath.filename().wstring());
+    j["artifacts"]["etw_status"] = std::string(etwStatus);
+  });
+}
+
+bool TryUpdateIncidentManifestCrashEnrichment(
+  const std::filesystem::path& manifestPath,
+  const std::filesystem::path& enrichedDumpPath,
+  std::string_view status,
+  std::wstring* err)
+{
+  return UpdateIncidentManifestFile(manifestPath, err, [&](nlohmann::json& j) {
+    if (!j.contains("artifacts") || !j["artifacts"].is_object()) {
+      j["artifacts"] = nlohmann::json::object();
     }
-    return false;
-  }
-  if (!j.contains("artifacts") || !j["artifacts"].is_object()) {
-    j["artifacts"] = nlohmann::json::object();
-  }
-  j["artifacts"]["etw"] = WideToUtf8(etwPath.filename().wstring());
-  j["artifacts"]["etw_status"] = std::string(etwStatus);
-  if (!WriteTextFileUtf8(manifestPath, j.dump(2))) {
-    if (err) {
-      *err = L"manifest atomic write failed";
+    j["artifacts"]["dump_enriched"] =
+      enrichedDumpPath.empty() ? "" : WideToUtf8(enrichedDumpPath.filename().wstring());
+    if (!j.contains("capture_enrichment") || !j["capture_enrichment"].is_object()) {
+      j["capture_enrichment"] = nlohmann::json::object();
     }
-    return false;
-  }
-  if (err) {
-    err->clear();
-  }
-  return true;
+    j["capture_enrichment"]["status"] = std::string(status);
+  });
 }
 
 bool TryUpdateIncidentManifestRecaptureEvaluation(
@@ -224,31 +298,9 @@ bool TryUpdateIncidentManifestRecaptureEvaluation(
   const skydiag::helper::RecaptureDecision& recaptureDecision,
   std::wstring* err)
 {
-  std::string txt;
-  if (!ReadTextFileUtf8(manifestPath, &txt)) {
-    if (err) {
-      *err = L"manifest read failed";
-    }
-    return false;
-  }
-  auto j = nlohmann::json::parse(txt, nullptr, false);
-  if (j.is_discarded() || !j.is_object()) {
-    if (err) {
-      *err = L"manifest parse failed";
-    }
-    return false;
-  }
-  j["recapture_evaluation"] = MakeRecaptureEvaluationJson(recaptureDecision);
-  if (!WriteTextFileUtf8(manifestPath, j.dump(2))) {
-    if (err) {
-      *err = L"manifest atomic write failed";
-    }
-    return false;
-  }
-  if (err) {
-    err->clear();
-  }
-  return true;
+  return UpdateIncidentManifestFile(manifestPath, err, [&](nlohmann::json& j) {
+    j["recapture_evaluation"] = MakeRecaptureEvaluationJson(recaptureDecision);
+  });
 }
 
 }  // namespace skydiag::helper::internal
@@ -34,12 +34,28 @@ nlohmann::json MakeIncidentManifestV1(
   const skydiag::helper::HelperConfig& cfg,
   bool includeConfigSnapshot);
 
+// Second phase of a two-phase crash capture. `capture_profile` keeps describing
+// the thin first-phase dump; the enrichment carries its own profile.
+void AddIncidentManifestCrashEnrichment(
+  nlohmann::json& manifest,
+  const std::filesystem::path& enrichedDumpPath,
+  std::string_view status,
+  const skydiag::helper::DumpProfile* enrichedProfile);
+
 bool TryUpdateIncidentManifestEtw(
   const std::filesystem::path& manifestPath,
   const std::filesystem::path& etwPath,
   std::string_view etwStatus,
   std::wstring* err);
 
+// Final state of an enrichment queued after the manifest was written;
+// `enrichedDumpPath` is empty unless the dump was written.
+bool TryUpdateIncidentManifestCrashEnrichment(
+  const std::filesystem::path& manifestPath,
+  const std::filesystem::path& enrichedDumpPath,
+  std::string_view status,
+  std::wstring* err);
+
 bool TryUpdateIncidentManifestRecaptureEvaluation(
   const std::filesystem::path& manifestPath,
   const skydiag::helper::RecaptureDecision& recaptureDecision,
@@ -80,6 +80,25 @@ void DoManualCapture(
     L", loading=" + std::to_wstring(decision.isLoading ? 1 : 0) +
     L", inMenu=" + std::to_wstring(inMenu ? 1 : 0) + L")");
 
+  // Snapshot first: the clone pins the state closest to detection and releases
+  // the game before WCT, plugin scan and the dump write run.
+  auto pssSnapshot = TryCapturePssSnapshotForFreeze(cfg.enablePssSnapshotForFreeze, proc.process);
+  if (pssSnapshot.requested) {
+    if (pssSnapshot.used) {
+      AppendLogLine(
+        outBase,
+        L"PSS snapshot captured for manual dump (durationMs="
+          + std::to_wstring(pssSnapshot.captureDurationMs)
+          + L").");
+    } else {
+      AppendLogLine(
+        outBase,
+        L"PSS snapshot unavailable for manual dump; falling back to live-process dump (status="
+          + pssSnapshot.status
+          + L").");
+    }
+  }
+
   nlohmann::json wctJson;
   std::wstring wctErr;
   if (!skydiag::helper::CaptureWct(proc.pid, &proc.shm->header.state_flags, wctJson, &wctErr)) {
@@ -104,24 +123,8 @@ void DoManualCapture(
   const std::string pluginScanJson = CollectPluginScanJson(proc, outBase);
   const auto dumpProfile = skydiag::helper::ResolveDumpProfile(
     cfg.dumpMode,
-    skydiag::helper::CaptureKind::Manual);
-  auto pssSnapshot = TryCapturePssSnapshotForFreeze(cfg.enablePssSnapshotForFreeze, proc.process);
-  if (pssSnapshot.requested) {
-    if (pssSnapshot.used) {
-      AppendLogLine(
-        outBase,
-        L"PSS snapshot captured for manual dump (durationMs="
-          + std::to_wstring(pssSnapshot.captureDurationMs)
-          + L").");
-    } else {
-      AppendLogLine(
-        outBase,
-        L"PSS snapshot unavailable for manual dump; falling back to live-process dump (status="
-          + pssSnapshot.status
-          + L").");
-    }
-  }
-
+    skydiag::helper::CaptureKind::Manual,
+    cfg.dumpCompression);
   wctJson["capture"]["pss_snapshot_requested"] = pssSnapshot.requested;
   wctJson["capture"]["pss_snapshot_used"] = pssSnapshot.used;
   wctJson["capture"]["pss_snapshot_capture_ms"] = pssSnapshot.captureDurationMs;
@@ -147,25 +150,30 @@ void DoManualCapture(
   const std::string wctUtf8 = wctJson.dump(2);
   WriteTextFileUtf8(wctPath, wctUtf8);
 
-  std::wstring dumpErr;
-  const HANDLE dumpSource = pssSnapshot.used ? pssSnapshot.snapshotHandle : proc.process;
-  if (!skydiag::helper::WriteDumpWithStreams(
-        dumpSource,
+  const auto freezeDump = WriteFreezeDump(
+    pssSnapshot,
+    proc.process,
+    [&](HANDLE source, bool isProcessSnapshot, std::wstring* err) {
+      return skydiag::helper::WriteDumpWithStreams(
+        source,
         proc.pid,
         dumpPath,
         proc.shm,
         proc.shmSize,
         wctUtf8,
         pluginScanJson,
+        /*hangPrecaptureJson=*/{},
         /*isCrash=*/false,
         dumpProfile,
-        /*isProcessSnapshot=*/pssSnapshot.used,
-        &dumpErr)) {
-    ReleasePssSnapshotForFreeze(proc.process, pssSnapshot.snapshotHandle);
-    std::wcerr << L"[SkyrimDiagHelper] Manual dump failed: " << dumpErr << L"\n";
-    AppendLogLine(outBase, L"Manual dump failed: " + dumpErr);
+        isProcessSnapshot,
+        err);
+    });
+  ReleasePssSnapshotForFreeze(proc.process, pssSnapshot.snapshotHandle);
+  LogFreezeDumpTiming(outBase, L"manual", freezeDump);
+  if (!freezeDump.written) {
+    std::wcerr << L"[SkyrimDiagHelper] Manual dump failed: " << freezeDump.err << L"\n";
+    AppendLogLine(outBase, L"Manual dump failed: " + freezeDump.err);
   } else {
-    ReleasePssSnapshotForFreeze(proc.process, pssSnapshot.snapshotHandle);
     std::wcout << L"[SkyrimDiagHelper] Manual dump written: " << dumpPath << L"\n";
     std::wcout << L"[SkyrimDiagHelper] WCT written: " << wctPath.wstring() << L"\n";
     AppendLogLine(outBase, L"Manual dump written: " + dumpPath);
@@ -183,7 +191,7 @@ void DoManualCapture(
       ctx["pss_snapshot_used"] = pssSnapshot.used;
       ctx["pss_snapshot_capture_ms"] = pssSnapshot.captureDurationMs;
       ctx["pss_snapshot_status"] = WideToUtf8(pssSnapshot.status);
-      ctx["dump_transport"] = pssSnapshot.used ? "pss_snapshot" : "live_process";
+      AddFreezeDumpTimingContext(freezeDump, &ctx);
 
       const auto manifest = MakeIncidentManifestV1(
         "manual",
@@ -209,7 +217,7 @@ void DoManualCapture(
       viewerNow = (launch == DumpToolViewerLaunchResult::kLaunched);
     }
     if (ShouldRunHeadlessDumpAnalysis(cfg, viewerNow, /*analysisRequired=*/false)) {
-      StartDumpToolHeadlessIfConfigured(cfg, dumpPath, outBase);
+      QueueDumpToolHeadlessIfConfigured(cfg, dumpPath, outBase, skydiag::helper::PostProcessPriority::kManual);
     } else if (viewerNow && cfg.autoAnalyzeDump) {
       AppendLogLine(outBase, L"Skipped headless analysis: viewer auto-open is enabled.");
     }
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 #include "SkyrimDiagHelper/Config.h"
 
@@ -18,7 +19,13 @@ std::filesystem::path CrashManifestPathForDump(
   if (stem.rfind(kPrefix, 0) != 0) {
     return {};
   }
-  const std::wstring suffix = stem.substr((sizeof(kPrefix) / sizeof(kPrefix[0])) - 1u);
+  std::wstring suffix = stem.substr((sizeof(kPrefix) / sizeof(kPrefix[0])) - 1u);
+  // An enriched dump shares the thin dump's manifest.
+  constexpr std::wstring_view kEnrichedSuffix = L"_Enriched";
+  if (suffix.size() > kEnrichedSuffix.size() &&
+      std::wstring_view(suffix).substr(suffix.size() - kEnrichedSuffix.size()) == kEnrichedSuffix) {
+    suffix.resize(suffix.size() - kEnrichedSuffix.size());
+  }
   return outBase / (L"SkyrimDiag_Incident_Crash_" + suffix + L".json");
 }
 
@@ -6,10 +6,12 @@
 #include <string_view>
 
 #include "CaptureCommon.h"
+#include "CrashCapture.h"
 #include "DumpToolLaunch.h"
 #include "HelperLog.h"
 #include "IncidentManifest.h"
 #include "SkyrimDiagHelper/Config.h"
+#include "SkyrimDiagHelper/DumpDelta.h"
 #include "SkyrimDiagHelper/DumpProfile.h"
 #include "SkyrimDiagHelper/DumpWriter.h"
 #include "SkyrimDiagHelper/ProcessAttach.h"
@@ -75,6 +77,29 @@ std::wstring RecaptureSuffixForTarget(skydiag::helper::RecaptureTargetProfile ta
   return L"_Recapture";
 }
 
+// The base is the dump the analyzer just read; a recapture that drops its
+// memory is only useful while that exact file generation is still on disk.
+bool TryBuildRecaptureDeltaBase(
+  const std::wstring& baseDumpPath,
+  skydiag::helper::DumpDeltaBase* out,
+  std::wstring* err)
+{
+  CleanExitDumpIdentity identity{};
+  if (!TryCaptureDumpIdentity(baseDumpPath, &identity)) {
+    *err = L"base dump is missing";
+    return false;
+  }
+  std::string readErr;
+  if (!skydiag::helper::ReadMinidumpMemoryRanges(baseDumpPath, &out->memoryRanges, &readErr)) {
+    *err = L"base dump memory list unreadable: " + std::wstring(readErr.begin(), readErr.end());
+    return false;
+  }
+  out->filenameUtf8 = WideToUtf8(identity.filename);
+  out->sizeBytes = identity.sizeBytes;
+  out->lastWriteTimeUtc100ns = identity.lastWriteTimeUtc100ns;
+  return true;
+}
+
 std::filesystem::path CrashRecaptureManifestPathForTimestamp(
   std::wstring_view timestamp,
   const std::filesystem::path& outBase)
@@ -106,8 +131,22 @@ void ApplyCrashRecaptureDecision(
     std::wstring aliveErr;
     if (IsProcessStillAlive(proc.process, &aliveErr)) {
       const auto tsFull = Timestamp();
+      std::optional<skydiag::helper::DumpDeltaBase> deltaBase;
+      if (cfg.enableIncrementalCrashRecapture) {
+        skydiag::helper::DumpDeltaBase base{};
+        std::wstring deltaErr;
+        if (TryBuildRecaptureDeltaBase(task.dumpPath, &base, &deltaErr)) {
+          deltaBase = std::move(base);
+        } else {
+          AppendLogLine(outBase, L"Incremental crash recapture unavailable; writing a full recapture: " + deltaErr);
+        }
+      }
+      // A delta is unreadable without its base, so it is named after the base
+      // dump; retention then keeps and prunes the two as one incident.
       const auto recaptureDumpFs =
-        outBase / (L"SkyrimDiag_Crash_" + tsFull +
+        outBase / ((deltaBase ? std::filesystem::path(task.dumpPath).stem().wstring() + L"_Delta_"
+                              : std::wstring(L"SkyrimDiag_Crash_")) +
+                   tsFull +
                    RecaptureSuffixForTarget(context.recaptureDecision.targetProfile) +
                    L".dmp");
       const auto recaptureDumpPath = recaptureDumpFs.wstring();
@@ -115,7 +154,8 @@ void ApplyCrashRecaptureDecision(
         DumpModeForRecaptureTarget(context.recaptureDecision.targetProfile, cfg.dumpMode);
       const auto dumpProfile = skydiag::helper::ResolveDumpProfile(
         recaptureDumpMode,
-        skydiag::helper::CaptureKind::CrashRecapture);
+        skydiag::helper::CaptureKind::CrashRecapture,
+        cfg.dumpCompression);
 
       const std::string pluginScanJson = CollectPluginScanJson(
         proc,
@@ -131,10 +171,12 @@ void ApplyCrashRecaptureDecision(
             proc.shmSize,
             /*wctJsonUtf8=*/{},
             pluginScanJson,
+            /*hangPrecaptureJson=*/{},
             /*isCrash=*/true,
             dumpProfile,
             /*isProcessSnapshot=*/false,
-            &fullDumpErr)) {
+            &fullDumpErr,
+            deltaBase ? &*deltaBase : nullptr)) {
         AppendLogLine(outBase, L"Crash recapture failed: " + fullDumpErr);
       } else {
         recaptureDumpWritten = true;
@@ -144,13 +186,22 @@ void ApplyCrashRecaptureDecision(
         AppendLogLine(
           outBase,
           L"Crash recapture written: " + recaptureDumpPath +
-            L" (targetProfile=" + targetProfileW + L")");
+            L" (targetProfile=" + targetProfileW + L", delta=" + (deltaBase ? L"1" : L"0") + L")");
         if (cfg.enableIncidentManifest) {
           nlohmann::json ctx = nlohmann::json::object();
           ctx["reason"] = "auto_recapture";
           ctx["source_dump"] = WideToUtf8(std::filesystem::path(task.dumpPath).filename().wstring());
           ctx["source_bucket_key"] = context.summaryInfo.bucketKey;
           ctx["source_summary_schema"] = context.summaryInfo.schemaVersion;
+          if (deltaBase) {
+            std::uint64_t omittedBytes = 0;
+            for (const auto& range : deltaBase->memoryRanges) {
+              omittedBytes += range.size;
+            }
+            ctx["delta_base_dump"] = deltaBase->filenameUtf8;
+            ctx["delta_omitted_ranges"] = deltaBase->memoryRanges.size();
+            ctx["delta_omitted_bytes"] = omittedBytes;
+          }
           const auto recaptureManifestPath =
             CrashRecaptureManifestPathForTimestamp(tsFull, outBase);
           const auto manifest = MakeIncidentManifestV1(
@@ -172,7 +223,7 @@ void ApplyCrashRecaptureDecision(
             outBase,
             L"Crash recapture incident manifest written: " + recaptureManifestPath.wstring());
         }
-        StartDumpToolHeadlessIfConfigured(cfg, recaptureDumpPath, outBase);
+        QueueDumpToolHeadlessIfConfigured(cfg, recaptureDumpPath, outBase, skydiag::helper::PostProcessPriority::kCrash);
       }
     } else {
       AppendLogLine(outBase, L"Crash recapture skipped: " + aliveErr);
@@ -5,10 +5,12 @@
 #include <filesystem>
 #include <string>
 
+#include "CrashCapture.h"
 #include "DumpToolLaunch.h"
 #include "HelperCommon.h"
 #include "HelperLog.h"
 #include "PendingCrashAnalysisInternal.h"
+#include "PostProcessWorker.h"
 #include "SkyrimDiagHelper/Config.h"
 
 namespace skydiag::helper::internal {
@@ -28,18 +30,46 @@ void ClearPendingCrashAnalysis(PendingCrashAnalysis* task)
     CloseHandle(task->process);
     task->process = nullptr;
   }
+  // Successful runs were reported by FinalizePendingCrashAnalysisIfReady.
+  CompleteExternalPostProcessJob(task->postProcessJob, /*succeeded=*/false);
+  task->postProcessJob = skydiag::helper::kNoPostProcessJob;
+  task->launchAfter = skydiag::helper::kNoPostProcessJob;
   task->active = false;
   task->dumpPath.clear();
   task->startedAtTick64 = 0;
   task->timeoutMs = 0;
 }
 
+namespace {
+
+// Analyzes the enriched dump when its job left one, else the thin dump.
+bool LaunchPendingCrashAnalyzer(
+  const skydiag::helper::HelperConfig& cfg,
+  const std::filesystem::path& outBase,
+  PendingCrashAnalysis* task,
+  std::wstring* err)
+{
+  const auto dumpPath = ResolveCrashAnalysisDumpPath(task->dumpPath, task->launchAfter);
+  HANDLE processHandle = nullptr;
+  if (!StartDumpToolHeadlessAsync(cfg, dumpPath, outBase, &processHandle, err)) {
+    return false;
+  }
+  task->dumpPath = dumpPath;
+  task->process = processHandle;
+  task->startedAtTick64 = GetTickCount64();
+  task->launchAfter = skydiag::helper::kNoPostProcessJob;
+  return true;
+}
+
+}  // namespace
+
 bool StartPendingCrashAnalysisTask(
   const skydiag::helper::HelperConfig& cfg,
   const std::wstring& dumpPath,
   const std::filesystem::path& outBase,
   PendingCrashAnalysis* task,
-  std::wstring* err)
+  std::wstring* err,
+  skydiag::helper::PostProcessJobId launchAfter)
 {
   if (!task) {
     if (err) {
@@ -51,15 +81,18 @@ bool StartPendingCrashAnalysisTask(
     ClearPendingCrashAnalysis(task);
   }
 
-  HANDLE processHandle = nullptr;
-  if (!StartDumpToolHeadlessAsync(cfg, dumpPath, outBase, &processHandle, err)) {
+  task->dumpPath = dumpPath;
+  task->launchAfter = launchAfter;
+  if (IsPostProcessJobFinished(launchAfter) && !LaunchPendingCrashAnalyzer(cfg, outBase, task, err)) {
+    task->dumpPath.clear();
+    task->launchAfter = skydiag::helper::kNoPostProcessJob;
     return false;
   }
   task->active = true;
-  task->dumpPath = dumpPath;
-  task->process = processHandle;
-  task->startedAtTick64 = GetTickCount64();
   task->timeoutMs = CrashAnalysisTimeoutMs(cfg);
+  task->postProcessJob =
+    BeginExternalPostProcessJob("crash_analysis", skydiag::helper::PostProcessPriority::kCrash);
+  TrackDumpReaderJob(outBase, task->postProcessJob);
   if (err) {
     err->clear();
   }
@@ -72,7 +105,23 @@ void FinalizePendingCrashAnalysisIfReady(
   const std::filesystem::path& outBase,
   PendingCrashAnalysis* task)
 {
-  if (!task || !task->active || !task->process) {
+  if (!task || !task->active) {
+    return;
+  }
+  if (!task->process) {
+    // Deferred behind the enrichment; the timeout starts at launch.
+    if (task->launchAfter == skydiag::helper::kNoPostProcessJob || !IsPostProcessJobFinished(task->launchAfter)) {
+      return;
+    }
+    std::wstring launchErr;
+    if (!LaunchPendingCrashAnalyzer(cfg, outBase, task, &launchErr)) {
+      AppendLogLine(outBase, L"Crash headless analysis launch failed: " + launchErr);
+      ClearPendingCrashAnalysis(task);
+      return;
+    }
+    AppendLogLine(
+      outBase,
+      L"Crash headless analysis started after enrichment: " + std::filesystem::path(task->dumpPath).filename().wstring());
     return;
   }
 
@@ -109,6 +158,9 @@ void FinalizePendingCrashAnalysisIfReady(
     return;
   }
 
+  CompleteExternalPostProcessJob(task->postProcessJob, /*succeeded=*/true);
+  task->postProcessJob = skydiag::helper::kNoPostProcessJob;
+
   if (!cfg.enableAutoRecaptureOnUnknownCrash) {
     AppendLogLine(outBase, L"Crash headless analysis finished; tracked process handle released.");
     ClearPendingCrashAnalysis(task);
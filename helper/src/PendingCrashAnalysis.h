@@ -5,6 +5,8 @@
 #include <filesystem>
 #include <string>
 
+#include "SkyrimDiagHelper/PostProcessQueue.h"
+
 namespace skydiag::helper {
 struct AttachedProcess;
 struct HelperConfig;
@@ -19,6 +21,11 @@ struct PendingCrashAnalysis
   HANDLE process = nullptr;
   ULONGLONG startedAtTick64 = 0;
   DWORD timeoutMs = 0;
+  // External post-process job; retention sweeps queued meanwhile wait on it.
+  skydiag::helper::PostProcessJobId postProcessJob = skydiag::helper::kNoPostProcessJob;
+  // The analyzer is not started until this job (the crash enrichment) has
+  // finished; `process` stays null until then.
+  skydiag::helper::PostProcessJobId launchAfter = skydiag::helper::kNoPostProcessJob;
 };
 
 void ClearPendingCrashAnalysis(PendingCrashAnalysis* task);
@@ -28,7 +35,8 @@ bool StartPendingCrashAnalysisTask(
   const std::wstring& dumpPath,
   const std::filesystem::path& outBase,
   PendingCrashAnalysis* task,
-  std::wstring* err);
+  std::wstring* err,
+  skydiag::helper::PostProcessJobId launchAfter = skydiag::helper::kNoPostProcessJob);
 
 void FinalizePendingCrashAnalysisIfReady(
   const skydiag::helper::HelperConfig& cfg,
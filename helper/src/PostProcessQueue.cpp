@@ -0,0 +1,257 @@
+#include "SkyrimDiagHelper/PostProcessQueue.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace skydiag::helper {
+namespace {
+
+// Finished states are kept for State() queries; older ids are forgotten.
+constexpr std::size_t kMaxFinishedJobs = 256;
+
+bool IsTerminal(PostProcessJobState state)
+{
+  return state == PostProcessJobState::kSucceeded ||
+         state == PostProcessJobState::kFailed ||
+         state == PostProcessJobState::kCanceled;
+}
+
+}  // namespace
+
+PostProcessQueue::PostProcessQueue(std::size_t maxWorkers)
+  : m_maxWorkers(std::max<std::size_t>(1, maxWorkers))
+{}
+
+PostProcessQueue::~PostProcessQueue()
+{
+  Shutdown();
+}
+
+PostProcessJobId PostProcessQueue::Enqueue(PostProcessJob job)
+{
+  if (!job.run) {
+    return kNoPostProcessJob;
+  }
+
+  PostProcessJobId id = kNoPostProcessJob;
+  {
+    std::lock_guard lock(m_mutex);
+    if (m_stopping) {
+      return kNoPostProcessJob;
+    }
+
+    // Dependencies only ever point at older ids, which keeps the graph
+    // acyclic; coalescing into an older job must not break that.
+    if (!job.coalesceKey.empty()) {
+      for (auto& [existingId, entry] : m_jobs) {
+        if (entry.external || entry.state != PostProcessJobState::kPending ||
+            entry.job.coalesceKey != job.coalesceKey) {
+          continue;
+        }
+        const bool depsAreOlder = std::all_of(
+          job.dependsOn.begin(), job.dependsOn.end(),
+          [existingId = existingId](PostProcessJobId dep) { return dep < existingId; });
+        if (!depsAreOlder) {
+          break;
+        }
+        for (const auto dep : job.dependsOn) {
+          if (std::find(entry.job.dependsOn.begin(), entry.job.dependsOn.end(), dep) == entry.job.dependsOn.end()) {
+            entry.job.dependsOn.push_back(dep);
+          }
+        }
+        entry.job.run = std::move(job.run);
+        entry.job.priority = std::min(entry.job.priority, job.priority);
+        ++m_stats.coalesced;
+        return existingId;
+      }
+    }
+
+    id = m_nextId++;
+    job.dependsOn.erase(
+      std::remove_if(job.dependsOn.begin(), job.dependsOn.end(), [id](PostProcessJobId dep) { return dep >= id; }),
+      job.dependsOn.end());
+    m_jobs.emplace(id, Entry{ std::move(job), PostProcessJobState::kPending, /*external=*/false });
+    ++m_stats.enqueued;
+    EnsureWorkersLocked();
+  }
+  m_workCv.notify_one();
+  return id;
+}
+
+PostProcessJobId PostProcessQueue::EnqueueExternal(std::string name, PostProcessPriority priority)
+{
+  std::lock_guard lock(m_mutex);
+  if (m_stopping) {
+    return kNoPostProcessJob;
+  }
+  const PostProcessJobId id = m_nextId++;
+  PostProcessJob job{};
+  job.name = std::move(name);
+  job.priority = priority;
+  m_jobs.emplace(id, Entry{ std::move(job), PostProcessJobState::kRunning, /*external=*/true });
+  ++m_stats.enqueued;
+  return id;
+}
+
+void PostProcessQueue::Complete(PostProcessJobId id, bool succeeded)
+{
+  {
+    std::lock_guard lock(m_mutex);
+    const auto it = m_jobs.find(id);
+    if (it == m_jobs.end() || !it->second.external) {
+      return;
+    }
+    FinishLocked(id, succeeded ? PostProcessJobState::kSucceeded : PostProcessJobState::kFailed);
+  }
+  m_workCv.notify_all();
+}
+
+PostProcessJobState PostProcessQueue::State(PostProcessJobId id) const
+{
+  std::lock_guard lock(m_mutex);
+  if (const auto it = m_jobs.find(id); it != m_jobs.end()) {
+    return it->second.state;
+  }
+  if (const auto it = m_finished.find(id); it != m_finished.end()) {
+    return it->second;
+  }
+  return PostProcessJobState::kUnknown;
+}
+
+PostProcessQueueStats PostProcessQueue::Stats() const
+{
+  std::lock_guard lock(m_mutex);
+  return m_stats;
+}
+
+bool PostProcessQueue::WaitIdle(std::chrono::milliseconds timeout)
+{
+  std::unique_lock lock(m_mutex);
+  return m_idleCv.wait_for(lock, timeout, [this]() { return m_jobs.empty(); });
+}
+
+bool PostProcessQueue::WaitFor(PostProcessJobId id, std::chrono::milliseconds timeout)
+{
+  std::unique_lock lock(m_mutex);
+  return m_finishedCv.wait_for(lock, timeout, [this, id]() { return m_jobs.count(id) == 0; });
+}
+
+void PostProcessQueue::Shutdown()
+{
+  std::vector<std::thread> workers;
+  {
+    std::lock_guard lock(m_mutex);
+    m_stopping = true;
+    m_cancel.store(true, std::memory_order_relaxed);
+    for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+      const auto next = std::next(it);
+      if (it->second.external || it->second.state == PostProcessJobState::kPending) {
+        FinishLocked(it->first, PostProcessJobState::kCanceled);
+      }
+      it = next;
+    }
+    workers.swap(m_workers);
+  }
+  m_workCv.notify_all();
+
+  for (auto& worker : workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+void PostProcessQueue::WorkerMain()
+{
+  std::unique_lock lock(m_mutex);
+  for (;;) {
+    auto it = m_jobs.end();
+    m_workCv.wait(lock, [this, &it]() {
+      it = PickReadyLocked();
+      return m_stopping || it != m_jobs.end();
+    });
+    if (m_stopping) {
+      return;
+    }
+
+    const PostProcessJobId id = it->first;
+    it->second.state = PostProcessJobState::kRunning;
+    auto run = std::move(it->second.job.run);
+    ++m_running;
+    m_stats.maxConcurrent = std::max(m_stats.maxConcurrent, m_running);
+
+    lock.unlock();
+    bool ok = false;
+    try {
+      ok = run(m_cancel);
+    } catch (...) {
+      ok = false;
+    }
+    lock.lock();
+
+    --m_running;
+    FinishLocked(id, ok ? PostProcessJobState::kSucceeded : PostProcessJobState::kFailed);
+    m_workCv.notify_all();
+  }
+}
+
+bool PostProcessQueue::IsReadyLocked(const Entry& entry) const
+{
+  if (entry.external || entry.state != PostProcessJobState::kPending) {
+    return false;
+  }
+  return std::none_of(entry.job.dependsOn.begin(), entry.job.dependsOn.end(), [this](PostProcessJobId dep) {
+    return m_jobs.count(dep) != 0;
+  });
+}
+
+std::map<PostProcessJobId, PostProcessQueue::Entry>::iterator PostProcessQueue::PickReadyLocked()
+{
+  auto best = m_jobs.end();
+  for (auto it = m_jobs.begin(); it != m_jobs.end(); ++it) {
+    if (!IsReadyLocked(it->second)) {
+      continue;
+    }
+    // Ids ascend, so the first ready job of a priority is the oldest one.
+    if (best == m_jobs.end() || it->second.job.priority < best->second.job.priority) {
+      best = it;
+    }
+  }
+  return best;
+}
+
+void PostProcessQueue::FinishLocked(PostProcessJobId id, PostProcessJobState state)
+{
+  if (!IsTerminal(state)) {
+    return;
+  }
+  m_jobs.erase(id);
+  m_finished[id] = state;
+  while (m_finished.size() > kMaxFinishedJobs) {
+    m_finished.erase(m_finished.begin());
+  }
+  switch (state) {
+    case PostProcessJobState::kSucceeded:
+      ++m_stats.succeeded;
+      break;
+    case PostProcessJobState::kFailed:
+      ++m_stats.failed;
+      break;
+    default:
+      ++m_stats.canceled;
+      break;
+  }
+  m_finishedCv.notify_all();
+  if (m_jobs.empty()) {
+    m_idleCv.notify_all();
+  }
+}
+
+void PostProcessQueue::EnsureWorkersLocked()
+{
+  while (m_workers.size() < m_maxWorkers) {
+    m_workers.emplace_back(&PostProcessQueue::WorkerMain, this);
+  }
+}
+
+}  // namespace skydiag::helper
@@ -0,0 +1,173 @@
+#include "PostProcessWorker.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "HelperCommon.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
+
+namespace skydiag::helper::internal {
+namespace {
+
+// Retention sweeps and future in-helper jobs share the disk with the game;
+// two workers keep a sweep from stalling behind a slow job without letting a
+// burst of captures fan out.
+constexpr std::size_t kPostProcessWorkers = 2;
+
+struct PostProcessWorkerState
+{
+  std::mutex mutex;
+  std::shared_ptr<skydiag::helper::PostProcessQueue> queue;
+  // Path key -> jobs that hold a dump in that directory.
+  std::map<std::wstring, std::vector<skydiag::helper::PostProcessJobId>> dumpReaders;
+};
+
+PostProcessWorkerState& GetPostProcessWorkerState()
+{
+  static PostProcessWorkerState state{};
+  return state;
+}
+
+std::shared_ptr<skydiag::helper::PostProcessQueue> AcquireQueue(bool create)
+{
+  auto& state = GetPostProcessWorkerState();
+  std::lock_guard lock(state.mutex);
+  if (!state.queue && create) {
+    state.queue = std::make_shared<skydiag::helper::PostProcessQueue>(kPostProcessWorkers);
+  }
+  return state.queue;
+}
+
+std::wstring MakePathKey(const std::filesystem::path& path)
+{
+  std::error_code ec;
+  const auto canonical = std::filesystem::weakly_canonical(path, ec);
+  if (!ec && !canonical.empty()) {
+    return canonical.wstring();
+  }
+  return path.lexically_normal().wstring();
+}
+
+// Drops finished readers and returns the rest.
+std::vector<skydiag::helper::PostProcessJobId> LiveDumpReadersLocked(
+  PostProcessWorkerState& state,
+  const std::wstring& key)
+{
+  const auto it = state.dumpReaders.find(key);
+  if (it == state.dumpReaders.end()) {
+    return {};
+  }
+  auto& ids = it->second;
+  ids.erase(
+    std::remove_if(ids.begin(), ids.end(), [&state](skydiag::helper::PostProcessJobId id) {
+      const auto jobState = state.queue ? state.queue->State(id) : skydiag::helper::PostProcessJobState::kUnknown;
+      return jobState != skydiag::helper::PostProcessJobState::kPending &&
+        jobState != skydiag::helper::PostProcessJobState::kRunning;
+    }),
+    ids.end());
+  auto live = ids;
+  if (ids.empty()) {
+    state.dumpReaders.erase(it);
+  }
+  return live;
+}
+
+}  // namespace
+
+void QueueRetentionSweep(
+  const std::filesystem::path& outBase,
+  const skydiag::helper::RetentionLimits& limits)
+{
+  if (outBase.empty()) {
+    return;
+  }
+
+  const auto key = MakePathKey(outBase);
+  skydiag::helper::PostProcessJob job{};
+  job.name = "retention_sweep";
+  job.priority = skydiag::helper::PostProcessPriority::kMaintenance;
+  job.coalesceKey = "retention:" + WideToUtf8(key);
+  {
+    auto& state = GetPostProcessWorkerState();
+    std::lock_guard lock(state.mutex);
+    job.dependsOn = LiveDumpReadersLocked(state, key);
+  }
+  job.run = [outBase, limits](const skydiag::helper::PostProcessCancelFlag& cancel) {
+    if (cancel.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    const skydiag::helper::ScopedPerfTimer perfTimer(skydiag::helper::PerfStage::kRetentionSweep);
+    skydiag::helper::ApplyRetentionToOutputDir(outBase, limits);
+    return true;
+  };
+  AcquireQueue(/*create=*/true)->Enqueue(std::move(job));
+}
+
+void TrackDumpReaderJob(const std::filesystem::path& outBase, skydiag::helper::PostProcessJobId id)
+{
+  if (outBase.empty() || id == skydiag::helper::kNoPostProcessJob) {
+    return;
+  }
+  const auto key = MakePathKey(outBase);
+  auto& state = GetPostProcessWorkerState();
+  std::lock_guard lock(state.mutex);
+  (void)LiveDumpReadersLocked(state, key);
+  state.dumpReaders[key].push_back(id);
+}
+
+skydiag::helper::PostProcessJobId BeginExternalPostProcessJob(
+  std::string name,
+  skydiag::helper::PostProcessPriority priority)
+{
+  return AcquireQueue(/*create=*/true)->EnqueueExternal(std::move(name), priority);
+}
+
+void CompleteExternalPostProcessJob(skydiag::helper::PostProcessJobId id, bool succeeded)
+{
+  if (id == skydiag::helper::kNoPostProcessJob) {
+    return;
+  }
+  if (const auto queue = AcquireQueue(/*create=*/false)) {
+    queue->Complete(id, succeeded);
+  }
+}
+
+skydiag::helper::PostProcessJobId EnqueuePostProcessJob(skydiag::helper::PostProcessJob job)
+{
+  return AcquireQueue(/*create=*/true)->Enqueue(std::move(job));
+}
+
+bool IsPostProcessJobFinished(skydiag::helper::PostProcessJobId id)
+{
+  return WaitForPostProcessJob(id, std::chrono::milliseconds(0));
+}
+
+bool WaitForPostProcessJob(skydiag::helper::PostProcessJobId id, std::chrono::milliseconds timeout)
+{
+  if (id == skydiag::helper::kNoPostProcessJob) {
+    return true;
+  }
+  const auto queue = AcquireQueue(/*create=*/false);
+  return !queue || queue->WaitFor(id, timeout);
+}
+
+void ShutdownPostProcessWorker()
+{
+  std::shared_ptr<skydiag::helper::PostProcessQueue> queue;
+  {
+    auto& state = GetPostProcessWorkerState();
+    std::lock_guard lock(state.mutex);
+    queue.swap(state.queue);
+    state.dumpReaders.clear();
+  }
+  if (queue) {
+    queue->Shutdown();
+  }
+}
+
+}  // namespace skydiag::helper::internal
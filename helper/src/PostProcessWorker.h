@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "SkyrimDiagHelper/PostProcessQueue.h"
+#include "SkyrimDiagHelper/Retention.h"
+
+namespace skydiag::helper::internal {
+
+// Sweeps are coalesced per output directory and wait for every job still
+// registered with TrackDumpReaderJob there, so a dump is not pruned
+// underneath the analyzer or while it is being written.
+void QueueRetentionSweep(
+  const std::filesystem::path& outBase,
+  const skydiag::helper::RetentionLimits& limits);
+
+// Marks `id` as reading or writing a dump in `outBase` until it finishes.
+void TrackDumpReaderJob(const std::filesystem::path& outBase, skydiag::helper::PostProcessJobId id);
+
+// Registers work the helper tracks itself (e.g. the analyzer process) so
+// queued jobs can depend on it. Completing an unknown id is a no-op.
+skydiag::helper::PostProcessJobId BeginExternalPostProcessJob(
+  std::string name,
+  skydiag::helper::PostProcessPriority priority);
+void CompleteExternalPostProcessJob(skydiag::helper::PostProcessJobId id, bool succeeded);
+
+// In-helper work that follows a dump (crash enrichment, manifest updates).
+skydiag::helper::PostProcessJobId EnqueuePostProcessJob(skydiag::helper::PostProcessJob job);
+
+// True once `id` is no longer pending or running; kNoPostProcessJob and
+// forgotten ids count as finished.
+bool IsPostProcessJobFinished(skydiag::helper::PostProcessJobId id);
+bool WaitForPostProcessJob(skydiag::helper::PostProcessJobId id, std::chrono::milliseconds timeout);
+
+// Cancels pending jobs and joins the workers; the next enqueue starts a
+// fresh queue.
+void ShutdownPostProcessWorker();
+
+}  // namespace skydiag::helper::internal
@@ -5,6 +5,7 @@
 #include <TlHelp32.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <cwchar>
 #include <cwctype>
 #include <string>
@@ -15,6 +16,10 @@
 namespace skydiag::helper {
 namespace {
 
+// Upper bound for waiting on a plugin that created its ready event but has not
+// finished initializing the mapping yet.
+constexpr DWORD kPluginReadyWaitMs = 3000;
+
 std::wstring MakeKernelName(std::uint32_t pid, const wchar_t* suffix)
 {
   std::wstring name;
@@ -95,6 +100,7 @@ bool AttachByPid(std::uint32_t pid, AttachedProcess& out, std::wstring* err)
   out.shmWritable = static_cast<skydiag::SharedLayout*>(view);
   out.shm = out.shmWritable;
   out.shmSize = sizeof(skydiag::SharedLayout);
+  out.mappedBytes = out.shmSize;
   {
     MEMORY_BASIC_INFORMATION mbi{};
     if (VirtualQuery(view, &mbi, sizeof(mbi)) != 0 && mbi.RegionSize > 0) {
@@ -104,10 +110,37 @@ bool AttachByPid(std::uint32_t pid, AttachedProcess& out, std::wstring* err)
         Detach(out);
         return false;
       }
+      out.mappedBytes = mbi.RegionSize;
     }
   }
 
   out.pid = pid;
+
+  // Newer plugins create the ready event before the mapping and signal it
+  // after initialization; wait for it rather than reading a half-built header.
+  const std::wstring readyEventName = MakeKernelName(pid, skydiag::protocol::kKernelObjectSuffix_ReadyEvent);
+  out.readyEvent = OpenEventW(SYNCHRONIZE, FALSE, readyEventName.c_str());
+  if (out.readyEvent) {
+    (void)IsPluginReady(out, kPluginReadyWaitMs);
+  }
+
+  const auto caps = skydiag::TryReadSharedCapabilities(view, out.mappedBytes, out.shm->header.capabilities_offset);
+  out.hasCapabilities = caps.has_value();
+  out.protocol = skydiag::NegotiateProtocol(
+    out.shm->header.version,
+    skydiag::kVersion,
+    caps,
+    skydiag::kSharedLayoutHash,
+    skydiag::kEventCapacity,
+    skydiag::kResourceCapacity,
+    skydiag::kHelperSupportedFeatures);
+  if (caps && skydiag::IsProtocolAccepted(out.protocol)) {
+    auto* block = reinterpret_cast<skydiag::SharedCapabilities*>(
+      static_cast<std::uint8_t*>(view) + out.shm->header.capabilities_offset);
+    block->helper_accepted_features = out.protocol.features;
+    block->helper_pid = GetCurrentProcessId();
+  }
+
   TryAttachCrashEvent(out, nullptr);
   if (err) err->clear();
   return true;
@@ -163,6 +196,11 @@ bool TryAttachCrashEvent(AttachedProcess& proc, std::wstring* err)
   return true;
 }
 
+bool IsPluginReady(const AttachedProcess& proc, DWORD waitMs)
+{
+  return proc.readyEvent && WaitForSingleObject(proc.readyEvent, waitMs) == WAIT_OBJECT_0;
+}
+
 void Detach(AttachedProcess& p)
 {
   if (p.shm) {
@@ -178,13 +216,20 @@ void Detach(AttachedProcess& p)
     CloseHandle(p.crashEvent);
     p.crashEvent = nullptr;
   }
+  if (p.readyEvent) {
+    CloseHandle(p.readyEvent);
+    p.readyEvent = nullptr;
+  }
   if (p.process) {
     CloseHandle(p.process);
     p.process = nullptr;
   }
   p.pid = 0;
   p.shmSize = 0;
+  p.mappedBytes = 0;
   p.crashEventOpenError = ERROR_SUCCESS;
+  p.hasCapabilities = false;
+  p.protocol = {};
 }
 
 }  // namespace skydiag::helper
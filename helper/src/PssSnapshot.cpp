@@ -3,7 +3,14 @@
 #include <Windows.h>
 #include <ProcessSnapshot.h>
 
+#include <chrono>
 #include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include "HelperLog.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
 
 namespace skydiag::helper::internal {
 namespace {
@@ -49,6 +56,11 @@ bool TryLoadPssApi(PssApi* api, std::wstring* status)
   return true;
 }
 
+std::wstring AsciiToWide(std::string_view s)
+{
+  return std::wstring(s.begin(), s.end());
+}
+
 constexpr PSS_CAPTURE_FLAGS kFreezeSnapshotFlags = static_cast<PSS_CAPTURE_FLAGS>(
   PSS_CAPTURE_VA_CLONE |
   PSS_CAPTURE_VA_SPACE |
@@ -69,12 +81,14 @@ PssSnapshotAttempt TryCapturePssSnapshotForFreeze(bool enabled, HANDLE process)
 
   if (!process) {
     result.status = L"invalid_process_handle";
+    result.outcome = FreezeSnapshotOutcome::kCaptureFailed;
     return result;
   }
 
   PssApi api{};
   if (!TryLoadPssApi(&api, &result.status)) {
     result.apiAvailable = false;
+    result.outcome = FreezeSnapshotOutcome::kApiUnavailable;
     return result;
   }
 
@@ -90,12 +104,14 @@ PssSnapshotAttempt TryCapturePssSnapshotForFreeze(bool enabled, HANDLE process)
 
   if (status != ERROR_SUCCESS || !snapshot) {
     result.status = L"PssCaptureSnapshot failed: " + std::to_wstring(status);
+    result.outcome = FreezeSnapshotOutcome::kCaptureFailed;
     return result;
   }
 
   result.snapshotHandle = snapshot;
   result.used = true;
   result.status = L"captured";
+  result.outcome = FreezeSnapshotOutcome::kCaptured;
   return result;
 }
 
@@ -115,4 +131,74 @@ void ReleasePssSnapshotForFreeze(HANDLE process, HANDLE snapshotHandle)
   CloseHandle(snapshotHandle);
 }
 
+FreezeDumpResult WriteFreezeDump(
+  const PssSnapshotAttempt& snapshot,
+  HANDLE liveProcess,
+  const FreezeDumpWriter& writeDump)
+{
+  FreezeDumpResult result{};
+  result.timing.snapshotCaptureMs = snapshot.used ? snapshot.captureDurationMs : 0u;
+
+  const auto plan = PlanFreezeDump(snapshot.outcome, /*allowLiveRetry=*/true);
+  result.fallbackReason = plan.fallbackReason;
+
+  for (std::size_t i = 0; i < plan.attemptCount && !result.written; ++i) {
+    const auto transport = plan.attempts[i];
+    const bool fromSnapshot = transport == FreezeDumpTransport::kPssSnapshot;
+    std::wstring attemptErr;
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = writeDump(fromSnapshot ? snapshot.snapshotHandle : liveProcess, fromSnapshot, &attemptErr);
+    const auto elapsedMs = static_cast<std::uint32_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+    result.transport = transport;
+    if (fromSnapshot) {
+      result.timing.snapshotDumpWriteMs = elapsedMs;
+      result.timing.snapshotDumpWritten = ok;
+    } else {
+      result.timing.liveDumpWriteMs = elapsedMs;
+    }
+    if (ok) {
+      result.written = true;
+      result.err.clear();
+    } else {
+      result.err = attemptErr;
+      if (fromSnapshot) {
+        result.fallbackReason = kFreezeFallbackSnapshotDumpFailed;
+      }
+    }
+  }
+
+  HelperPerf().Record(PerfStage::kFreezeExtension, static_cast<std::uint64_t>(FreezeExtensionMs(result.timing)) * 1000u);
+  return result;
+}
+
+void LogFreezeDumpTiming(const std::filesystem::path& outBase, std::wstring_view kind, const FreezeDumpResult& result)
+{
+  std::wstring line = L"Freeze capture timing (" + std::wstring(kind) + L"): transport=" +
+    AsciiToWide(FreezeDumpTransportToString(result.transport)) +
+    L" freezeExtensionMs=" + std::to_wstring(FreezeExtensionMs(result.timing)) +
+    L" avoidedMs=" + std::to_wstring(FreezeExtensionAvoidedMs(result.timing)) +
+    L" snapshotMs=" + std::to_wstring(result.timing.snapshotCaptureMs) +
+    L" snapshotWriteMs=" + std::to_wstring(result.timing.snapshotDumpWriteMs) +
+    L" liveWriteMs=" + std::to_wstring(result.timing.liveDumpWriteMs);
+  if (!result.fallbackReason.empty()) {
+    line += L" fallback=" + AsciiToWide(result.fallbackReason);
+  }
+  AppendLogLine(outBase, line);
+}
+
+void AddFreezeDumpTimingContext(const FreezeDumpResult& result, nlohmann::json* ctx)
+{
+  if (!ctx) {
+    return;
+  }
+  (*ctx)["dump_transport"] = FreezeDumpTransportToString(result.transport);
+  (*ctx)["dump_fallback_reason"] = result.fallbackReason;
+  (*ctx)["freeze_extension_ms"] = FreezeExtensionMs(result.timing);
+  (*ctx)["freeze_extension_avoided_ms"] = FreezeExtensionAvoidedMs(result.timing);
+  (*ctx)["snapshot_dump_write_ms"] = result.timing.snapshotDumpWriteMs;
+  (*ctx)["live_dump_write_ms"] = result.timing.liveDumpWriteMs;
+}
+
 }  // namespace skydiag::helper::internal
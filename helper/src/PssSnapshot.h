@@ -3,7 +3,14 @@
 #include <Windows.h>
 
 #include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <string>
+#include <string_view>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "SkyrimDiagHelper/FreezeDumpPlan.h"
 
 namespace skydiag::helper::internal {
 
@@ -15,9 +22,35 @@ struct PssSnapshotAttempt
   bool apiAvailable = false;
   std::uint32_t captureDurationMs = 0;
   std::wstring status = L"disabled";
+  FreezeSnapshotOutcome outcome = FreezeSnapshotOutcome::kDisabled;
 };
 
 PssSnapshotAttempt TryCapturePssSnapshotForFreeze(bool enabled, HANDLE process);
 void ReleasePssSnapshotForFreeze(HANDLE process, HANDLE snapshotHandle);
 
+struct FreezeDumpResult
+{
+  bool written = false;
+  FreezeDumpTransport transport = FreezeDumpTransport::kLiveProcess;
+  std::string fallbackReason;  // empty when the snapshot dump was written
+  FreezeCaptureTiming timing{};
+  std::wstring err;
+};
+
+// Source handle plus process-snapshot marker, as WriteDumpWithStreams takes them.
+using FreezeDumpWriter = std::function<bool(HANDLE source, bool isProcessSnapshot, std::wstring* err)>;
+
+// Runs PlanFreezeDump against the snapshot attempt, falling back to the live
+// process when the snapshot write fails. Does not release the snapshot.
+FreezeDumpResult WriteFreezeDump(
+  const PssSnapshotAttempt& snapshot,
+  HANDLE liveProcess,
+  const FreezeDumpWriter& writeDump);
+
+void LogFreezeDumpTiming(const std::filesystem::path& outBase, std::wstring_view kind, const FreezeDumpResult& result);
+
+// Incident-context keys: dump_transport, dump_fallback_reason and the
+// freeze-extension timings.
+void AddFreezeDumpTimingContext(const FreezeDumpResult& result, nlohmann::json* ctx);
+
 }  // namespace skydiag::helper::internal
@@ -0,0 +1,169 @@
+#include "SkyrimDiagHelper/TargetedMemoryPlan.h"
+
+#include <algorithm>
+#include <set>
+
+namespace skydiag::helper {
+namespace {
+
+constexpr std::uint64_t kArgumentLeadBytes = 64;  // allocator headers precede the object
+constexpr std::uint64_t kPointerLeadBytes = 64;
+
+const MemoryRegionInfo* FindRegion(const std::vector<MemoryRegionInfo>& regions, std::uint64_t address)
+{
+  auto it = std::upper_bound(
+    regions.begin(), regions.end(), address,
+    [](std::uint64_t value, const MemoryRegionInfo& region) { return value < region.base; });
+  if (it == regions.begin()) {
+    return nullptr;
+  }
+  --it;
+  if (address - it->base >= it->size) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+class PagePlanner {
+public:
+  PagePlanner(const std::vector<MemoryRegionInfo>& regions, std::uint64_t budgetBytes, TargetedMemoryPlan& plan)
+    : m_regions(regions), m_budgetPages(budgetBytes / kTargetedMemoryPageBytes), m_plan(plan)
+  {}
+
+  bool Exhausted() const { return m_pages.size() >= m_budgetPages; }
+
+  // Adds [begin, end) clipped to readable regions, one page at a time.
+  void Add(std::uint64_t begin, std::uint64_t end)
+  {
+    if (end <= begin) {
+      return;
+    }
+    ++m_plan.candidates;
+    std::uint64_t page = begin & ~(kTargetedMemoryPageBytes - 1);
+    while (page < end) {
+      if (FindRegion(m_regions, page) && m_pages.count(page) == 0) {
+        if (Exhausted()) {
+          ++m_plan.droppedForBudget;
+          return;
+        }
+        m_pages.insert(page);
+      }
+      if (page > UINT64_MAX - kTargetedMemoryPageBytes) {
+        return;
+      }
+      page += kTargetedMemoryPageBytes;
+    }
+  }
+
+  void AddAround(std::uint64_t address, std::uint64_t before, std::uint64_t after)
+  {
+    const std::uint64_t begin = address > before ? address - before : 0;
+    const std::uint64_t end = (UINT64_MAX - address) > after ? address + after : UINT64_MAX;
+    Add(begin, end);
+  }
+
+  void Finish()
+  {
+    for (const auto page : m_pages) {
+      if (!m_plan.ranges.empty() && m_plan.ranges.back().base + m_plan.ranges.back().size == page) {
+        m_plan.ranges.back().size += kTargetedMemoryPageBytes;
+      } else {
+        m_plan.ranges.push_back({ page, kTargetedMemoryPageBytes });
+      }
+    }
+    m_plan.totalBytes = static_cast<std::uint64_t>(m_pages.size()) * kTargetedMemoryPageBytes;
+  }
+
+private:
+  const std::vector<MemoryRegionInfo>& m_regions;
+  std::uint64_t m_budgetPages = 0;
+  TargetedMemoryPlan& m_plan;
+  std::set<std::uint64_t> m_pages;
+};
+
+bool IsDataRegion(const MemoryRegionInfo* region)
+{
+  return region && (region->flags & kRegion_Executable) == 0;
+}
+
+bool IsInRange(const MemoryRange& range, std::uint64_t address)
+{
+  return address >= range.base && address - range.base < range.size;
+}
+
+bool IsCodeRegion(const MemoryRegionInfo* region)
+{
+  return region && (region->flags & (kRegion_Executable | kRegion_Image)) == (kRegion_Executable | kRegion_Image);
+}
+
+}  // namespace
+
+TargetedMemoryPlan PlanTargetedMemory(const TargetedMemoryInputs& in, const TargetedMemoryLimits& limits)
+{
+  TargetedMemoryPlan plan{};
+  PagePlanner planner(in.readableRegions, limits.totalBudgetBytes, plan);
+
+  // Fault site first: the instruction bytes and whatever the registers point at.
+  planner.AddAround(in.instructionPointer, limits.registerWindowBytes, limits.registerWindowBytes);
+  for (const auto value : in.registers) {
+    if (!IsInRange(in.stack, value) && IsDataRegion(FindRegion(in.readableRegions, value))) {
+      planner.AddAround(value, limits.registerWindowBytes, limits.registerWindowBytes);
+    }
+  }
+  for (const auto value : in.argumentRegisters) {
+    if (!IsInRange(in.stack, value) && IsDataRegion(FindRegion(in.readableRegions, value))) {
+      planner.AddAround(value, kArgumentLeadBytes, limits.argumentWindowBytes);
+    }
+  }
+
+  // Stack words: data pointers get a small window, return addresses nominate
+  // the modules whose globals are worth keeping.
+  std::vector<std::uint64_t> suspectModules;
+  const auto nominateModule = [&](const MemoryRegionInfo* region) {
+    if (!IsCodeRegion(region) || suspectModules.size() >= limits.maxSuspectModules) {
+      return;
+    }
+    if (std::find(suspectModules.begin(), suspectModules.end(), region->allocationBase) == suspectModules.end()) {
+      suspectModules.push_back(region->allocationBase);
+    }
+  };
+  nominateModule(FindRegion(in.readableRegions, in.instructionPointer));
+
+  std::size_t stackPointers = 0;
+  for (const auto word : in.stackWords) {
+    const auto* region = FindRegion(in.readableRegions, word);
+    if (!region) {
+      continue;
+    }
+    if (IsCodeRegion(region)) {
+      nominateModule(region);
+      continue;
+    }
+    if (IsDataRegion(region) && !IsInRange(in.stack, word) &&
+        stackPointers < limits.maxStackPointers && !planner.Exhausted()) {
+      ++stackPointers;
+      planner.AddAround(word, kPointerLeadBytes, limits.stackPointerWindowBytes);
+    }
+  }
+
+  for (const auto moduleBase : suspectModules) {
+    std::uint64_t moduleBytes = 0;
+    for (const auto& region : in.readableRegions) {
+      if (region.allocationBase != moduleBase ||
+          (region.flags & (kRegion_Image | kRegion_Writable | kRegion_Executable)) != (kRegion_Image | kRegion_Writable)) {
+        continue;
+      }
+      const std::uint64_t take = std::min(region.size, limits.maxModuleDataBytes - moduleBytes);
+      planner.Add(region.base, region.base + take);
+      moduleBytes += take;
+      if (moduleBytes >= limits.maxModuleDataBytes) {
+        break;
+      }
+    }
+  }
+
+  planner.Finish();
+  return plan;
+}
+
+}  // namespace skydiag::helper
@@ -7,6 +7,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include "SkyrimDiagHelper/HelperPerf.h"
 #include "SkyrimDiagShared.h"
 
 #include <algorithm>
@@ -106,6 +107,7 @@ bool ReadLoadingSignal(const volatile std::uint32_t* stateFlags)
 
 void CaptureWctPass(HWCT session, std::uint32_t pid, const volatile std::uint32_t* captureStateFlags, WctPassResult& out)
 {
+  const ScopedPerfTimer perfTimer(PerfStage::kWctPass);
   out = WctPassResult{};
   out.threads = nlohmann::json::array();
   out.hasLoadingSignal = ReadLoadingSignal(captureStateFlags);
@@ -209,6 +211,7 @@ bool CaptureWct(
   nlohmann::json& out,
   std::wstring* err)
 {
+  const ScopedPerfTimer perfTimer(PerfStage::kWctCapture);
   out = nlohmann::json::object();
   out["pid"] = pid;
   out["threads"] = nlohmann::json::array();
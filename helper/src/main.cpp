@@ -17,7 +17,7 @@
 #include "HelperCommon.h"
 #include "HelperMainInternal.h"
 #include "HelperLog.h"
-#include "RetentionWorker.h"
+#include "PostProcessWorker.h"
 
 using skydiag::helper::internal::AppendLogLine;
 using skydiag::helper::internal::ApplyRetentionFromConfig;
@@ -25,7 +25,7 @@ using skydiag::helper::internal::BuildCrashEventUnavailableMessage;
 using skydiag::helper::internal::MakeOutputBase;
 using skydiag::helper::internal::SetHelperLogRotation;
 using skydiag::helper::internal::RunCompatibilityPreflight;
-using skydiag::helper::internal::ShutdownRetentionWorker;
+using skydiag::helper::internal::ShutdownPostProcessWorker;
 
 int wmain(int argc, wchar_t** argv)
 {
@@ -66,6 +66,14 @@ int wmain(int argc, wchar_t** argv)
     skydiag::helper::Detach(proc);
     return 3;
   }
+  if (!skydiag::IsProtocolAccepted(proc.protocol)) {
+    const std::string_view status = skydiag::ProtocolNegotiationStatusName(proc.protocol.status);
+    const std::wstring statusW(status.begin(), status.end());
+    std::wcerr << L"[SkyrimDiagHelper] Shared memory handshake rejected (" << statusW << L").\n";
+    AppendLogLine(MakeOutputBase(cfg), L"Shared memory handshake rejected: " + statusW);
+    skydiag::helper::Detach(proc);
+    return 3;
+  }
 
   const auto outBase = MakeOutputBase(cfg);
   const std::wstring configWarning = err;
@@ -92,6 +100,13 @@ int wmain(int argc, wchar_t** argv)
   if (!configWarning.empty()) {
     AppendLogLine(outBase, L"Config warning: " + configWarning);
   }
+  {
+    const std::string_view status = skydiag::ProtocolNegotiationStatusName(proc.protocol.status);
+    AppendLogLine(
+      outBase,
+      L"Protocol handshake: " + std::wstring(status.begin(), status.end())
+        + L" (features=" + std::to_wstring(proc.protocol.features) + L")");
+  }
   if (!proc.crashEvent) {
     AppendLogLine(
       outBase,
@@ -107,7 +122,7 @@ int wmain(int argc, wchar_t** argv)
   if (grassCacheMode) {
     ApplyRetentionFromConfig(cfg, outBase);
     skydiag::helper::internal::RunGrassCacheLoop(proc, outBase);
-    ShutdownRetentionWorker();
+    ShutdownPostProcessWorker();
   } else {
     ApplyRetentionFromConfig(cfg, outBase);
 
@@ -139,8 +154,10 @@ int wmain(int argc, wchar_t** argv)
       attachNowQpc,
       &loopState);
     skydiag::helper::internal::ShutdownLoopState(cfg, proc, outBase, &loopState);
-    ShutdownRetentionWorker();
+    ShutdownPostProcessWorker();
   }
+  // After the post-process workers joined so the last sweep is counted.
+  skydiag::helper::internal::WriteHelperPerfReport(outBase);
 
   if (helperSingletonMutex && helperSingletonMutex != INVALID_HANDLE_VALUE) {
     CloseHandle(helperSingletonMutex);
@@ -2,6 +2,7 @@
 
 #include <Windows.h>
 
+#include <cstddef>
 #include <cstring>
 #include <string>
 
@@ -14,8 +15,17 @@ namespace {
 
 HANDLE g_mapping = nullptr;
 HANDLE g_crashEvent = nullptr;
+HANDLE g_readyEvent = nullptr;
 skydiag::SharedLayout* g_shared = nullptr;
 
+void CloseReadyEvent()
+{
+  if (g_readyEvent) {
+    CloseHandle(g_readyEvent);
+    g_readyEvent = nullptr;
+  }
+}
+
 }  // namespace
 
 std::wstring MakeKernelName(const wchar_t* suffix)
@@ -38,27 +48,35 @@ bool InitSharedMemory()
   const auto pid = GetCurrentProcessId();
   const std::wstring shmName = MakeKernelName(skydiag::protocol::kKernelObjectSuffix_SharedMemory);
   const std::wstring crashEventName = MakeKernelName(skydiag::protocol::kKernelObjectSuffix_CrashEvent);
+  const std::wstring readyEventName = MakeKernelName(skydiag::protocol::kKernelObjectSuffix_ReadyEvent);
+
+  // Created unsignaled before the mapping so a helper that finds the mapping
+  // early can wait on it instead of polling for the crash event.
+  g_readyEvent = CreateEventW(nullptr, /*bManualReset=*/TRUE, /*bInitialState=*/FALSE, readyEventName.c_str());
 
   g_mapping = CreateFileMappingW(
     INVALID_HANDLE_VALUE,
     nullptr,
     PAGE_READWRITE,
     0,
-    static_cast<DWORD>(sizeof(skydiag::SharedLayout)),
+    static_cast<DWORD>(sizeof(skydiag::SharedMapping)),
     shmName.c_str());
   if (!g_mapping) {
+    CloseReadyEvent();
     return false;
   }
 
-  void* view = MapViewOfFile(g_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(skydiag::SharedLayout));
+  void* view = MapViewOfFile(g_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(skydiag::SharedMapping));
   if (!view) {
     CloseHandle(g_mapping);
     g_mapping = nullptr;
+    CloseReadyEvent();
     return false;
   }
 
-  g_shared = static_cast<skydiag::SharedLayout*>(view);
-  std::memset(g_shared, 0, sizeof(skydiag::SharedLayout));
+  auto* mapping = static_cast<skydiag::SharedMapping*>(view);
+  std::memset(mapping, 0, sizeof(skydiag::SharedMapping));
+  g_shared = &mapping->layout;
 
   g_crashEvent = CreateEventW(nullptr, /*bManualReset=*/TRUE, /*bInitialState=*/FALSE, crashEventName.c_str());
   if (!g_crashEvent) {
@@ -66,6 +84,7 @@ bool InitSharedMemory()
     g_shared = nullptr;
     CloseHandle(g_mapping);
     g_mapping = nullptr;
+    CloseReadyEvent();
     return false;
   }
 
@@ -83,11 +102,25 @@ bool InitSharedMemory()
   g_shared->header.last_heartbeat_qpc = static_cast<std::uint64_t>(now.QuadPart);
   g_shared->header.state_flags = skydiag::kState_Loading;
 
+  auto& caps = mapping->capabilities;
+  caps.magic = skydiag::kCapabilitiesMagic;
+  caps.block_bytes = sizeof(skydiag::SharedCapabilities);
+  caps.features = g_readyEvent ? skydiag::kFeature_ReadyEvent : 0u;
+  caps.layout_hash = skydiag::kSharedLayoutHash;
+  caps.event_capacity = skydiag::kEventCapacity;
+  caps.resource_capacity = skydiag::kResourceCapacity;
+  caps.resource_path_max_bytes = skydiag::kResourcePathMaxBytes;
+  g_shared->header.capabilities_offset = static_cast<std::uint32_t>(offsetof(skydiag::SharedMapping, capabilities));
+  g_shared->header.mapping_bytes = static_cast<std::uint32_t>(sizeof(skydiag::SharedMapping));
+
   // Session start marker.
   skydiag::EventPayload p{};
   p.a = pid;
   PushEventAlways(skydiag::EventType::kSessionStart, p, sizeof(p));
 
+  if (g_readyEvent) {
+    SetEvent(g_readyEvent);
+  }
   return true;
 }
 
@@ -101,6 +134,7 @@ void ShutdownSharedMemory()
     CloseHandle(g_crashEvent);
     g_crashEvent = nullptr;
   }
+  CloseReadyEvent();
   if (g_mapping) {
     CloseHandle(g_mapping);
     g_mapping = nullptr;
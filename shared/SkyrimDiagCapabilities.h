@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+
+// Capability handshake between the plugin and the helper.
+//
+// The v4 SharedLayout is frozen; optional features are negotiated through a
+// block appended after it in the same mapping. SharedHeader announces where
+// the block lives (capabilities_offset) and how large the mapping is. A
+// mapping created by an older plugin leaves both fields zero, which reads as
+// "legacy v4, no optional features".
+//
+// This header is platform-neutral so the negotiation can be unit-tested
+// without the Windows shared-memory types.
+
+namespace skydiag {
+
+inline constexpr std::uint32_t kCapabilitiesMagic = 0x50434453u;  // 'SDCP'
+
+enum ProtocolFeature : std::uint64_t {
+  // Plugin signals the named _READY event once the mapping and crash event
+  // are fully initialized; the helper waits on it instead of retrying.
+  kFeature_ReadyEvent = 1ull << 0,
+  // Reserved for per-thread event rings. Not produced yet.
+  kFeature_ShardedEventRings = 1ull << 1,
+  // Reserved for plugin-side hitch duration histograms. Not produced yet.
+  kFeature_HitchHistogram = 1ull << 2,
+};
+
+// Features this build of the helper knows how to consume.
+inline constexpr std::uint64_t kHelperSupportedFeatures = kFeature_ReadyEvent;
+
+struct SharedCapabilities {
+  std::uint32_t magic = kCapabilitiesMagic;
+  std::uint32_t block_bytes = sizeof(SharedCapabilities);
+
+  std::uint64_t features = 0;      // ProtocolFeature bits offered by the plugin
+  std::uint64_t layout_hash = 0;   // kSharedLayoutHash of the plugin build
+
+  std::uint32_t event_capacity = 0;
+  std::uint32_t resource_capacity = 0;
+  std::uint32_t resource_path_max_bytes = 0;
+  std::uint32_t reserved = 0;
+
+  // Written by the helper after a successful handshake.
+  volatile std::uint64_t helper_accepted_features = 0;
+  volatile std::uint32_t helper_pid = 0;
+  std::uint32_t reserved2 = 0;
+};
+
+// FNV-1a over the layout facts (offsets, sizes, capacities) both sides were
+// compiled against.
+constexpr std::uint64_t ComputeLayoutHash(std::initializer_list<std::uint64_t> facts)
+{
+  std::uint64_t h = 0xcbf29ce484222325ull;
+  for (const auto fact : facts) {
+    for (int i = 0; i < 8; ++i) {
+      h ^= (fact >> (i * 8)) & 0xFFu;
+      h *= 0x100000001b3ull;
+    }
+  }
+  return h;
+}
+
+// Copies the capability block out of a mapping. Returns nullopt when the
+// header does not announce one, it does not fit in the mapped bytes, or its
+// magic/size are wrong.
+inline std::optional<SharedCapabilities> TryReadSharedCapabilities(
+  const void* mappingBase,
+  std::size_t mappedBytes,
+  std::uint32_t capabilitiesOffset)
+{
+  if (!mappingBase || capabilitiesOffset == 0 ||
+      capabilitiesOffset > mappedBytes ||
+      mappedBytes - capabilitiesOffset < sizeof(SharedCapabilities)) {
+    return std::nullopt;
+  }
+  SharedCapabilities caps{};
+  std::memcpy(&caps, static_cast<const std::uint8_t*>(mappingBase) + capabilitiesOffset, sizeof(caps));
+  if (caps.magic != kCapabilitiesMagic || caps.block_bytes < sizeof(SharedCapabilities)) {
+    return std::nullopt;
+  }
+  return caps;
+}
+
+enum class ProtocolNegotiationStatus : std::uint8_t {
+  kAccepted = 0,
+  kAcceptedLegacy = 1,   // v4 mapping without a capability block
+  kVersionMismatch = 2,
+  kLayoutMismatch = 3,
+  kMissingRequiredFeature = 4,
+};
+
+struct ProtocolNegotiationResult {
+  ProtocolNegotiationStatus status = ProtocolNegotiationStatus::kVersionMismatch;
+  std::uint64_t features = 0;  // features both sides agreed to use
+};
+
+inline bool IsProtocolAccepted(const ProtocolNegotiationResult& r)
+{
+  return r.status == ProtocolNegotiationStatus::kAccepted ||
+    r.status == ProtocolNegotiationStatus::kAcceptedLegacy;
+}
+
+// Unknown plugin feature bits are ignored, so a newer plugin can add features
+// without a kVersion bump. A layout hash or capacity mismatch means the core
+// structs moved and nothing in the mapping can be trusted.
+inline ProtocolNegotiationResult NegotiateProtocol(
+  std::uint32_t headerVersion,
+  std::uint32_t expectedVersion,
+  const std::optional<SharedCapabilities>& caps,
+  std::uint64_t expectedLayoutHash,
+  std::uint32_t expectedEventCapacity,
+  std::uint32_t expectedResourceCapacity,
+  std::uint64_t helperSupportedFeatures,
+  std::uint64_t requiredFeatures = 0)
+{
+  ProtocolNegotiationResult r{};
+  if (headerVersion != expectedVersion) {
+    r.status = ProtocolNegotiationStatus::kVersionMismatch;
+    return r;
+  }
+  if (!caps) {
+    r.status = requiredFeatures != 0
+      ? ProtocolNegotiationStatus::kMissingRequiredFeature
+      : ProtocolNegotiationStatus::kAcceptedLegacy;
+    return r;
+  }
+  if (caps->layout_hash != expectedLayoutHash ||
+      caps->event_capacity != expectedEventCapacity ||
+      caps->resource_capacity != expectedResourceCapacity) {
+    r.status = ProtocolNegotiationStatus::kLayoutMismatch;
+    return r;
+  }
+
+  r.features = caps->features & helperSupportedFeatures;
+  r.status = ((r.features & requiredFeatures) == requiredFeatures)
+    ? ProtocolNegotiationStatus::kAccepted
+    : ProtocolNegotiationStatus::kMissingRequiredFeature;
+  return r;
+}
+
+inline const char* ProtocolNegotiationStatusName(ProtocolNegotiationStatus status)
+{
+  switch (status) {
+    case ProtocolNegotiationStatus::kAccepted:
+      return "accepted";
+    case ProtocolNegotiationStatus::kAcceptedLegacy:
+      return "accepted_legacy";
+    case ProtocolNegotiationStatus::kVersionMismatch:
+      return "version_mismatch";
+    case ProtocolNegotiationStatus::kLayoutMismatch:
+      return "layout_mismatch";
+    case ProtocolNegotiationStatus::kMissingRequiredFeature:
+      return "missing_required_feature";
+  }
+  return "unknown";
+}
+
+}  // namespace skydiag
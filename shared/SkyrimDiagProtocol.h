@@ -10,11 +10,15 @@ inline constexpr wchar_t kKernelObjectPrefix[] = L"Local\\SkyrimDiag_";
 inline constexpr wchar_t kKernelObjectSuffix_SharedMemory[] = L"_SHM";
 inline constexpr wchar_t kKernelObjectSuffix_CrashEvent[] = L"_CRASH";
 inline constexpr wchar_t kKernelObjectSuffix_HelperMutex[] = L"_HELPER_MUTEX";
+inline constexpr wchar_t kKernelObjectSuffix_ReadyEvent[] = L"_READY";  // kFeature_ReadyEvent
 
 // Custom minidump user stream types must be > MINIDUMP_STREAM_TYPE::LastReservedStream (0xffff).
 inline constexpr std::uint32_t kMinidumpUserStream_Blackbox = 0x10000u + 0x5344u;  // arbitrary
 inline constexpr std::uint32_t kMinidumpUserStream_WctJson = 0x10000u + 0x5743u;   // arbitrary
 inline constexpr std::uint32_t kMinidumpUserStream_PluginInfo = 0x10000u + 0x504Cu;  // arbitrary "PL"
+inline constexpr std::uint32_t kMinidumpUserStream_HangPrecapture = 0x10000u + 0x4850u;  // arbitrary "HP"
+// Incremental recapture: JSON naming the base dump whose memory was omitted.
+inline constexpr std::uint32_t kMinidumpUserStream_DumpDelta = 0x10000u + 0x444Cu;  // arbitrary "DL"
 
 // Build a kernel object name from PID and suffix.
 inline std::wstring MakeKernelName(std::uint32_t pid, const wchar_t* suffix)
@@ -2,9 +2,12 @@
 
 #include <Windows.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 
+#include "SkyrimDiagCapabilities.h"
+
 namespace skydiag {
 
 inline constexpr std::uint32_t kMagic = 0x53444941u;  // 'SDIA'
@@ -151,9 +154,19 @@ struct SharedHeader {
   volatile std::uint32_t crash_seq = 0;
   volatile std::uint32_t hang_seq = 0;     // helper can bump when it takes hang dump
 
+  // Capability handshake (see SkyrimDiagCapabilities.h). These occupy what
+  // was alignment padding before CrashInfo, so v4 offsets are unchanged and
+  // older plugins leave them zero.
+  std::uint32_t capabilities_offset = 0;  // byte offset of SharedCapabilities in the mapping
+  std::uint32_t mapping_bytes = 0;        // total bytes the plugin mapped
+
   CrashInfo crash{};
 };
 
+#if defined(_M_X64) || defined(__x86_64__)
+static_assert(offsetof(SharedHeader, crash) == 64, "SharedHeader v4 offsets must not move");
+#endif
+
 struct SharedLayout {
   SharedHeader header{};
   BlackboxEvent events[kEventCapacity]{};
@@ -162,4 +175,32 @@ struct SharedLayout {
 
 static_assert(std::is_trivially_copyable_v<SharedLayout>);
 
+inline constexpr std::uint64_t kSharedLayoutHash = ComputeLayoutHash({
+  sizeof(SharedHeader),
+  offsetof(SharedHeader, last_heartbeat_qpc),
+  offsetof(SharedHeader, state_flags),
+  offsetof(SharedHeader, write_index),
+  offsetof(SharedHeader, crash_seq),
+  offsetof(SharedHeader, crash),
+  sizeof(BlackboxEvent),
+  sizeof(ResourceEntry),
+  offsetof(SharedLayout, events),
+  offsetof(SharedLayout, resources),
+  sizeof(SharedLayout),
+  kEventCapacity,
+  kResourceCapacity,
+  kResourcePathMaxBytes,
+});
+
+// What the plugin actually maps: the frozen v4 layout followed by the
+// capability block. Everything that snapshots or parses the blackbox keeps
+// using SharedLayout and sizeof(SharedLayout).
+struct SharedMapping {
+  SharedLayout layout{};
+  SharedCapabilities capabilities{};
+};
+
+static_assert(offsetof(SharedMapping, layout) == 0);
+static_assert(std::is_trivially_copyable_v<SharedMapping>);
+
 }  // namespace skydiag
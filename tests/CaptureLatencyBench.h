@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// Shared pieces of the capture latency benchmarks: raw per-stage samples,
+// exact percentiles, the JSON report and the baseline regression gate. The
+// portable bench (capture_latency_bench.cpp) and the Windows bench
+// (capture_latency_bench_win.cpp) differ only in how a capture is driven.
+
+namespace skydiag::tests::bench {
+
+inline constexpr std::string_view kReportKind = "skydiag.capture_latency.v1";
+
+class StopWatch {
+public:
+  StopWatch() : m_start(std::chrono::steady_clock::now()) {}
+
+  std::uint64_t ElapsedUs() const
+  {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - m_start).count());
+  }
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+};
+
+// Nearest-rank percentile over raw samples; q in [0, 1].
+inline std::uint64_t PercentileUs(std::vector<std::uint64_t> samples, double q)
+{
+  if (samples.empty()) {
+    return 0;
+  }
+  std::sort(samples.begin(), samples.end());
+  q = std::clamp(q, 0.0, 1.0);
+  const auto rank = static_cast<std::size_t>(std::ceil(q * static_cast<double>(samples.size())));
+  return samples[rank == 0 ? 0 : rank - 1];
+}
+
+class LatencyTable {
+public:
+  void Add(std::string_view scenario, std::string_view stage, std::uint64_t us)
+  {
+    m_samples[std::string(scenario)][std::string(stage)].push_back(us);
+  }
+
+  // { kind, scenarios: { <scenario>: { <stage>: { count, p50_us, p90_us, p99_us, max_us } } } }
+  nlohmann::json ToJson() const
+  {
+    nlohmann::json scenarios = nlohmann::json::object();
+    for (const auto& [scenario, stages] : m_samples) {
+      nlohmann::json s = nlohmann::json::object();
+      for (const auto& [stage, us] : stages) {
+        s[stage] = {
+          { "count", us.size() },
+          { "p50_us", PercentileUs(us, 0.50) },
+          { "p90_us", PercentileUs(us, 0.90) },
+          { "p99_us", PercentileUs(us, 0.99) },
+          { "max_us", us.empty() ? 0 : *std::max_element(us.begin(), us.end()) },
+        };
+      }
+      scenarios[scenario] = std::move(s);
+    }
+    return nlohmann::json{
+      { "kind", kReportKind },
+      { "scenarios", std::move(scenarios) },
+    };
+  }
+
+private:
+  std::map<std::string, std::map<std::string, std::vector<std::uint64_t>>> m_samples;
+};
+
+// A stage regresses when its p50 or p90 exceeds baseline * tolerance + slack.
+// The slack keeps sub-millisecond stages from tripping on scheduler noise.
+// Stages missing from either side are ignored so new stages can land first.
+inline std::vector<std::string> FindLatencyRegressions(
+  const nlohmann::json& report,
+  const nlohmann::json& baseline,
+  double tolerance,
+  std::uint64_t slackUs)
+{
+  std::vector<std::string> out;
+  if (!report.contains("scenarios") || !baseline.contains("scenarios")) {
+    return out;
+  }
+  for (const auto& [scenario, stages] : baseline["scenarios"].items()) {
+    if (!report["scenarios"].contains(scenario)) {
+      continue;
+    }
+    const auto& current = report["scenarios"][scenario];
+    for (const auto& [stage, base] : stages.items()) {
+      if (!current.contains(stage)) {
+        continue;
+      }
+      for (const char* key : { "p50_us", "p90_us" }) {
+        const auto baseUs = base.value(key, std::uint64_t{ 0 });
+        const auto nowUs = current[stage].value(key, std::uint64_t{ 0 });
+        const auto limit = static_cast<std::uint64_t>(static_cast<double>(baseUs) * tolerance) + slackUs;
+        if (nowUs > limit) {
+          std::ostringstream line;
+          line << scenario << "/" << stage << " " << key << "=" << nowUs << "us > " << limit << "us (baseline "
+               << baseUs << "us)";
+          out.push_back(line.str());
+        }
+      }
+    }
+  }
+  return out;
+}
+
+struct BenchOptions {
+  std::uint32_t iterations = 20;
+  std::filesystem::path outPath;
+  std::filesystem::path baselinePath;
+  double tolerance = 1.5;
+  std::uint64_t slackUs = 2'000;
+  std::map<std::string, std::string> extra;  // bench-specific --key value pairs
+};
+
+inline bool ParseBenchOptions(int argc, char** argv, BenchOptions* out, std::string* err)
+{
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view a = argv[i];
+    if (a.rfind("--", 0) != 0 || i + 1 >= argc) {
+      *err = "expected --key value, got '" + std::string(a) + "'";
+      return false;
+    }
+    const std::string value = argv[++i];
+    if (a == "--iterations") {
+      out->iterations = static_cast<std::uint32_t>(std::max(1l, std::strtol(value.c_str(), nullptr, 10)));
+    } else if (a == "--out") {
+      out->outPath = value;
+    } else if (a == "--baseline") {
+      out->baselinePath = value;
+    } else if (a == "--tolerance") {
+      out->tolerance = std::max(1.0, std::strtod(value.c_str(), nullptr));
+    } else if (a == "--slack-us") {
+      out->slackUs = std::strtoull(value.c_str(), nullptr, 10);
+    } else {
+      out->extra[std::string(a.substr(2))] = value;
+    }
+  }
+  return true;
+}
+
+// Runs the bench, prints and optionally writes the report, then gates it
+// against --baseline. Exit code 1 on a regression, 2 on a usage/IO error.
+inline int RunBenchMain(
+  int argc,
+  char** argv,
+  const std::function<void(const BenchOptions&, LatencyTable*)>& run)
+{
+  BenchOptions options{};
+  std::string err;
+  if (!ParseBenchOptions(argc, argv, &options, &err)) {
+    std::cerr << err << "\n"
+              << "usage: " << argv[0]
+              << " [--iterations N] [--out report.json] [--baseline report.json] [--tolerance 1.5] [--slack-us 2000]\n";
+    return 2;
+  }
+
+  LatencyTable table;
+  run(options, &table);
+  auto report = table.ToJson();
+  report["iterations"] = options.iterations;
+  std::cout << report.dump(2) << "\n";
+
+  if (!options.outPath.empty()) {
+    std::ofstream f(options.outPath, std::ios::binary | std::ios::trunc);
+    f << report.dump(2) << "\n";
+    if (!f.good()) {
+      std::cerr << "failed to write " << options.outPath.string() << "\n";
+      return 2;
+    }
+  }
+
+  if (options.baselinePath.empty()) {
+    return 0;
+  }
+  std::ifstream b(options.baselinePath, std::ios::binary);
+  const auto baseline = nlohmann::json::parse(b, nullptr, /*allow_exceptions=*/false);
+  if (baseline.is_discarded()) {
+    std::cerr << "unreadable baseline " << options.baselinePath.string() << "\n";
+    return 2;
+  }
+  const auto regressions = FindLatencyRegressions(report, baseline, options.tolerance, options.slackUs);
+  for (const auto& r : regressions) {
+    std::cerr << "REGRESSION " << r << "\n";
+  }
+  return regressions.empty() ? 0 : 1;
+}
+
+}  // namespace skydiag::tests::bench
@@ -271,6 +271,7 @@ inline skydiag::helper::HelperConfig MakeTestConfig()
   cfg.enableAutoRecaptureOnUnknownCrash = false;
   cfg.preserveFilteredCrashDumps = false;
   cfg.enablePssSnapshotForFreeze = false;
+  cfg.enableCrashLoopBackoff = false;
   return cfg;
 }
 
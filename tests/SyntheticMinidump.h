@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Builds small minidump images in memory with the on-disk layout DbgHelp
+// writes, for the portable reader tests. Only the fields the reader decodes
+// are filled; everything else stays zero.
+
+namespace skydiag::tests::minidump {
+
+class SyntheticMinidump
+{
+public:
+  SyntheticMinidump() { m_bytes.resize(32); }
+
+  std::uint32_t Append(const void* data, std::size_t size)
+  {
+    const auto rva = static_cast<std::uint32_t>(m_bytes.size());
+    const auto* p = static_cast<const std::uint8_t*>(data);
+    m_bytes.insert(m_bytes.end(), p, p + size);
+    return rva;
+  }
+
+  template <class T>
+  std::uint32_t AppendPod(const T& v)
+  {
+    return Append(&v, sizeof(v));
+  }
+
+  // MINIDUMP_STRING: byte length then UTF-16LE (ASCII input only).
+  std::uint32_t AppendString(std::string_view ascii)
+  {
+    const auto rva = AppendPod(static_cast<std::uint32_t>(ascii.size() * 2));
+    for (const char c : ascii) {
+      AppendPod(static_cast<std::uint16_t>(static_cast<unsigned char>(c)));
+    }
+    return rva;
+  }
+
+  void AddStream(std::uint32_t type, const std::vector<std::uint8_t>& body)
+  {
+    const auto rva = Append(body.data(), body.size());
+    m_streams.push_back({ type, static_cast<std::uint32_t>(body.size()), rva });
+  }
+
+  void AddModule(std::uint64_t base, std::uint32_t size, std::string_view path, std::uint32_t timeDateStamp = 0)
+  {
+    m_modules.push_back({ base, size, AppendString(path), timeDateStamp });
+  }
+
+  void AddThread(std::uint32_t tid, std::uint64_t stackStart, const std::vector<std::uint8_t>& stack, std::uint64_t rsp, std::uint64_t rip)
+  {
+    const auto stackRva = Append(stack.data(), stack.size());
+    std::vector<std::uint8_t> ctx(1232, 0);
+    std::memcpy(ctx.data() + 0x98, &rsp, sizeof(rsp));
+    std::memcpy(ctx.data() + 0xF8, &rip, sizeof(rip));
+    const auto ctxRva = Append(ctx.data(), ctx.size());
+    m_threads.push_back({ tid, stackStart, static_cast<std::uint32_t>(stack.size()), stackRva, ctxRva });
+  }
+
+  // Memory64ListStream entry; bytes are laid out back to back at Finish().
+  void AddMemory64(std::uint64_t start, const std::vector<std::uint8_t>& bytes)
+  {
+    m_memory64.push_back({ start, bytes });
+  }
+
+  void SetException(std::uint32_t tid, std::uint32_t code, std::uint64_t address)
+  {
+    m_exception = { tid, code, address, true };
+  }
+
+  std::vector<std::uint8_t> Finish()
+  {
+    if (!m_modules.empty()) {
+      std::vector<std::uint8_t> body;
+      Put32(&body, static_cast<std::uint32_t>(m_modules.size()));
+      for (const auto& m : m_modules) {
+        const auto off = body.size();
+        body.resize(off + 108, 0);
+        std::memcpy(body.data() + off, &m.base, 8);
+        std::memcpy(body.data() + off + 8, &m.size, 4);
+        std::memcpy(body.data() + off + 16, &m.timeDateStamp, 4);
+        std::memcpy(body.data() + off + 20, &m.nameRva, 4);
+      }
+      AddStream(4, body);
+    }
+    if (!m_threads.empty()) {
+      std::vector<std::uint8_t> body;
+      Put32(&body, static_cast<std::uint32_t>(m_threads.size()));
+      for (const auto& t : m_threads) {
+        const auto off = body.size();
+        body.resize(off + 48, 0);
+        std::memcpy(body.data() + off, &t.tid, 4);
+        std::memcpy(body.data() + off + 24, &t.stackStart, 8);
+        std::memcpy(body.data() + off + 32, &t.stackSize, 4);
+        std::memcpy(body.data() + off + 36, &t.stackRva, 4);
+        const std::uint32_t ctxSize = 1232;
+        std::memcpy(body.data() + off + 40, &ctxSize, 4);
+        std::memcpy(body.data() + off + 44, &t.ctxRva, 4);
+      }
+      AddStream(3, body);
+    }
+    if (m_exception.set) {
+      std::vector<std::uint8_t> body(168, 0);
+      std::memcpy(body.data(), &m_exception.tid, 4);
+      std::memcpy(body.data() + 8, &m_exception.code, 4);
+      std::memcpy(body.data() + 24, &m_exception.address, 8);
+      AddStream(6, body);
+    }
+    if (!m_memory64.empty()) {
+      std::vector<std::uint8_t> body;
+      Put64(&body, m_memory64.size());
+      const auto baseRvaOff = body.size();
+      Put64(&body, 0);
+      for (const auto& r : m_memory64) {
+        Put64(&body, r.start);
+        Put64(&body, r.bytes.size());
+      }
+      AddStream(9, body);
+      const std::uint64_t baseRva = m_bytes.size();
+      std::memcpy(m_bytes.data() + m_streams.back().rva + baseRvaOff, &baseRva, 8);
+      for (const auto& r : m_memory64) {
+        Append(r.bytes.data(), r.bytes.size());
+      }
+    }
+
+    const auto dirRva = static_cast<std::uint32_t>(m_bytes.size());
+    for (const auto& s : m_streams) {
+      AppendPod(s);
+    }
+    const std::uint32_t signature = 0x504D444Du;
+    const auto count = static_cast<std::uint32_t>(m_streams.size());
+    std::memcpy(m_bytes.data(), &signature, 4);
+    std::memcpy(m_bytes.data() + 8, &count, 4);
+    std::memcpy(m_bytes.data() + 12, &dirRva, 4);
+    return m_bytes;
+  }
+
+private:
+  struct Directory
+  {
+    std::uint32_t type;
+    std::uint32_t size;
+    std::uint32_t rva;
+  };
+  struct Module
+  {
+    std::uint64_t base;
+    std::uint32_t size;
+    std::uint32_t nameRva;
+    std::uint32_t timeDateStamp;
+  };
+  struct Thread
+  {
+    std::uint32_t tid;
+    std::uint64_t stackStart;
+    std::uint32_t stackSize;
+    std::uint32_t stackRva;
+    std::uint32_t ctxRva;
+  };
+  struct Memory64
+  {
+    std::uint64_t start;
+    std::vector<std::uint8_t> bytes;
+  };
+  struct Exception
+  {
+    std::uint32_t tid = 0;
+    std::uint32_t code = 0;
+    std::uint64_t address = 0;
+    bool set = false;
+  };
+
+  static void Put32(std::vector<std::uint8_t>* out, std::uint32_t v)
+  {
+    const auto off = out->size();
+    out->resize(off + 4);
+    std::memcpy(out->data() + off, &v, 4);
+  }
+
+  static void Put64(std::vector<std::uint8_t>* out, std::uint64_t v)
+  {
+    const auto off = out->size();
+    out->resize(off + 8);
+    std::memcpy(out->data() + off, &v, 8);
+  }
+
+  std::vector<std::uint8_t> m_bytes;
+  std::vector<Directory> m_streams;
+  std::vector<Module> m_modules;
+  std::vector<Thread> m_threads;
+  std::vector<Memory64> m_memory64;
+  Exception m_exception;
+};
+
+}  // namespace skydiag::tests::minidump
@@ -710,6 +710,52 @@ void TestCrashHistorySameStemIdentityIsolation()
   assert(history.Size() == 0u);
 }
 
+void TestCrashHistoryTreeIdentityReadsLegacyFlatRows()
+{
+  CrashHistory history;
+
+  CrashHistoryEntry flat{};
+  flat.timestamp_utc = "2026-07-21T01:00:00Z";
+  flat.dump_file = "Legacy.dmp";
+  flat.dump_identity_key = "sha-flat.0000000000001000.0000000000002000";
+  flat.bucket_key = "bucket-flat";
+  history.AddEntry(flat);
+
+  CrashHistoryEntry otherGeneration{};
+  otherGeneration.timestamp_utc = "2026-07-21T02:00:00Z";
+  otherGeneration.dump_file = "Legacy.dmp";
+  otherGeneration.dump_identity_key = "tree-sha256-root-a.0000000000001000.0000000000004000";
+  otherGeneration.bucket_key = "bucket-other";
+  history.AddEntry(otherGeneration);
+  assert(history.Size() == 2u);
+
+  // Re-analysis of the flat row's file generation under the tree algorithm
+  // refreshes that row instead of recording a second crash.
+  CrashHistoryEntry tree{};
+  tree.timestamp_utc = "2026-07-21T03:00:00Z";
+  tree.dump_file = "legacy.DMP";
+  tree.dump_identity_key = "tree-sha256-root-b.0000000000001000.0000000000002000";
+  tree.bucket_key = "bucket-tree";
+  history.AddEntry(tree);
+  assert(history.Size() == 2u);
+  assert(history.GetBucketStats("bucket-flat").count == 0u);
+  assert(history.GetBucketStats("bucket-tree").count == 1u);
+  assert(history.GetBucketStats("bucket-tree").first_seen == "2026-07-21T01:00:00Z");
+
+  // Same metadata but a different file name is a different dump.
+  CrashHistoryEntry renamed = flat;
+  renamed.dump_file = "Other.dmp";
+  history.AddEntry(renamed);
+  assert(history.Size() == 3u);
+
+  // The exact flat key and its tree counterpart both go; the other
+  // generation of Legacy.dmp stays.
+  assert(history.RemoveEntriesForDumpFile("Legacy.dmp", flat.dump_identity_key) == 2u);
+  assert(history.GetBucketStats("bucket-tree").count == 0u);
+  assert(history.GetBucketStats("bucket-other").count == 1u);
+  assert(history.Size() == 1u);
+}
+
 #ifdef _WIN32
 void TestCrashHistoryFailedReplacementPreservesExistingFile()
 {
@@ -1148,6 +1194,7 @@ int main()
   TestCrashHistoryCandidateKeyVersionMigration();
   TestCrashHistorySameDumpIsIdempotent();
   TestCrashHistorySameStemIdentityIsolation();
+  TestCrashHistoryTreeIdentityReadsLegacyFlatRows();
 #ifdef _WIN32
   TestCrashHistoryFailedReplacementPreservesExistingFile();
 #endif
@@ -5,6 +5,7 @@
 #include <vector>
 
 using skydiag::dump_tool::ComputeCrashBucketKey;
+using skydiag::dump_tool::CheckHelperFingerprint;
 using skydiag::dump_tool::CrashBucketFrame;
 
 static void Test_SameInput_ProducesStableKey()
@@ -77,6 +78,37 @@ static void Test_CaseDifferences_DoNotChangeCanonicalKey()
   assert(a == b);
 }
 
+static void Test_HelperFingerprintCheck_ConfirmsMatchingFrames()
+{
+  const std::vector<CrashBucketFrame> helperFrames = {
+    { L"hdtsmp64.dll", 0x12 },
+    { L"skyrimse.exe", 0x999 },  // stale stack slot
+    { L"skyrimse.exe", 0x123456 },
+  };
+  const std::vector<CrashBucketFrame> stackwalkFrames = {
+    { L"hdtSMP64.dll", 0x12 },
+    { L"SkyrimSE.exe", 0x123456 },
+  };
+
+  const auto ok = CheckHelperFingerprint(
+    0xC0000005u, L"hdtsmp64.dll", 0x40, helperFrames,
+    0xC0000005u, L"hdtSMP64.dll", 0x40, stackwalkFrames);
+  assert(ok.faultConsistent);
+  assert(ok.framesConfirmed == 2);
+  assert(ok.framesTotal == 3);
+
+  const auto otherOffset = CheckHelperFingerprint(
+    0xC0000005u, L"hdtsmp64.dll", 0x44, helperFrames,
+    0xC0000005u, L"hdtSMP64.dll", 0x40, stackwalkFrames);
+  assert(!otherOffset.faultConsistent);
+
+  const auto otherCode = CheckHelperFingerprint(
+    0xC000001Du, L"hdtsmp64.dll", 0x40, {},
+    0xC0000005u, L"hdtSMP64.dll", 0x40, stackwalkFrames);
+  assert(!otherCode.faultConsistent);
+  assert(otherCode.framesTotal == 0);
+}
+
 int main()
 {
   Test_SameInput_ProducesStableKey();
@@ -84,5 +116,6 @@ int main()
   Test_DifferentExceptionCode_ChangesKey();
   Test_DifferentModuleOffset_ChangesKey();
   Test_CaseDifferences_DoNotChangeCanonicalKey();
+  Test_HelperFingerprintCheck_ConfirmsMatchingFrames();
   return 0;
 }
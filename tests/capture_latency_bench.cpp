@@ -0,0 +1,266 @@
+// Portable capture latency benchmark.
+//
+// A synthetic target thread writes a fake shared segment with the same
+// seqlock ring protocol as the plugin (claim idx, seq = idx * 2 when
+// committed, stop while frozen) and a heartbeat. The bench then drives
+// crash, hang and manual captures through the helper's ring validation
+// (IsSeqlockRingQuiescent, one-pass copy when frozen), a mock dump writer and a
+// mock summary writer, and reports per-stage latency percentiles.
+//
+// Absolute numbers are not comparable with the Windows bench
+// (capture_latency_bench_win.cpp), which drives the real HandleCrashEventTick /
+// HandleHangTick / DoManualCapture against a child process.
+//
+//   skydiag_capture_latency_bench [--iterations N] [--out r.json] [--baseline r.json]
+//                                 [--dump-mb 8] [--hang-threshold-ms 200]
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "CaptureLatencyBench.h"
+#include "SkyrimDiagHelper/SeqlockRing.h"
+
+using skydiag::tests::bench::BenchOptions;
+using skydiag::tests::bench::LatencyTable;
+using skydiag::tests::bench::RunBenchMain;
+using skydiag::tests::bench::StopWatch;
+
+namespace {
+
+// Same sizes as skydiag::BlackboxEvent / kEventCapacity, which cannot be
+// included here (SkyrimDiagShared.h pulls in Windows types).
+constexpr std::uint32_t kFakeEventCapacity = 1u << 16;
+constexpr auto kHelperPollInterval = std::chrono::milliseconds(10);
+
+struct FakeEvent {
+  std::atomic<std::uint32_t> seq{ 0 };
+  std::uint32_t tid = 0;
+  std::uint64_t qpc = 0;
+  std::uint16_t type = 0;
+  std::uint16_t size = 0;
+  std::uint32_t reserved = 0;
+  std::uint64_t payload[4]{};
+};
+
+struct FakeSegment {
+  std::atomic<bool> frozen{ false };
+  std::atomic<std::uint32_t> crashSeq{ 0 };
+  std::atomic<std::uint32_t> writeIndex{ 0 };
+  std::atomic<std::int64_t> lastHeartbeatUs{ 0 };
+  FakeEvent events[kFakeEventCapacity];
+};
+
+std::int64_t NowUs()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Stands in for the game: pushes events and heartbeats until told to stop or
+// to stall (hang scenario).
+class SyntheticTarget {
+public:
+  explicit SyntheticTarget(FakeSegment* seg) : m_seg(seg), m_thread([this] { Run(); }) {}
+  ~SyntheticTarget()
+  {
+    m_stop = true;
+    m_thread.join();
+  }
+
+  void SetStalled(bool stalled) { m_stalled = stalled; }
+
+private:
+  void Run()
+  {
+    std::uint64_t n = 0;
+    while (!m_stop) {
+      if (m_stalled || m_seg->frozen.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        continue;
+      }
+      const std::uint32_t idx = m_seg->writeIndex.fetch_add(1, std::memory_order_acq_rel);
+      auto& e = m_seg->events[idx % kFakeEventCapacity];
+      e.seq.store(idx * 2u | 1u, std::memory_order_release);
+      e.qpc = static_cast<std::uint64_t>(NowUs());
+      e.payload[0] = n;
+      e.seq.store(idx * 2u, std::memory_order_release);
+      if ((++n & 0xFF) == 0) {
+        m_seg->lastHeartbeatUs.store(NowUs(), std::memory_order_release);
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  FakeSegment* m_seg;
+  std::atomic<bool> m_stop{ false };
+  std::atomic<bool> m_stalled{ false };
+  std::thread m_thread;
+};
+
+struct Snapshot {
+  std::unique_ptr<FakeEvent[]> events;
+  bool onePass = false;
+};
+
+// One pass when the target is frozen and the ring is quiescent, kept only if
+// no slot was claimed meanwhile, as in TryCopyFrozenSharedView; otherwise a
+// per-entry seqlock copy. The dump never reads the live ring.
+Snapshot TakeSnapshot(const FakeSegment& seg)
+{
+  Snapshot s{};
+  s.events.reset(new FakeEvent[kFakeEventCapacity]);
+  const std::uint32_t wi = seg.writeIndex.load(std::memory_order_acquire);
+  if (seg.frozen.load(std::memory_order_acquire) &&
+      skydiag::helper::IsSeqlockRingQuiescent(seg.events, kFakeEventCapacity, wi)) {
+    for (std::uint32_t i = 0; i < kFakeEventCapacity; ++i) {
+      const auto& src = seg.events[i];
+      auto& dst = s.events[i];
+      dst.seq.store(src.seq.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      dst.qpc = src.qpc;
+      std::memcpy(dst.payload, src.payload, sizeof(dst.payload));
+    }
+    if (seg.writeIndex.load(std::memory_order_acquire) == wi) {
+      s.onePass = true;
+      return s;
+    }
+  }
+  for (std::uint32_t i = 0; i < kFakeEventCapacity; ++i) {
+    const auto& src = seg.events[i];
+    auto& dst = s.events[i];
+    const std::uint32_t before = src.seq.load(std::memory_order_acquire);
+    dst.qpc = src.qpc;
+    std::memcpy(dst.payload, src.payload, sizeof(dst.payload));
+    const std::uint32_t after = src.seq.load(std::memory_order_acquire);
+    dst.seq.store((before == after && (before & 1u) == 0u) ? before : 1u, std::memory_order_relaxed);
+  }
+  return s;
+}
+
+// Mock MiniDumpWriteDump: blackbox stream plus `dumpMb` of "process memory".
+void WriteMockDump(const std::filesystem::path& path, const Snapshot& snap, std::uint32_t dumpMb)
+{
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  std::vector<char> block(1u << 20, '\x5A');
+  for (std::uint32_t i = 0; i < dumpMb; ++i) {
+    f.write(block.data(), static_cast<std::streamsize>(block.size()));
+  }
+  for (std::uint32_t i = 0; i < kFakeEventCapacity; ++i) {
+    const auto& e = snap.events[i];
+    const std::uint32_t seq = e.seq.load(std::memory_order_relaxed);
+    f.write(reinterpret_cast<const char*>(&seq), sizeof(seq));
+    f.write(reinterpret_cast<const char*>(&e.qpc), sizeof(e.qpc));
+    f.write(reinterpret_cast<const char*>(e.payload), sizeof(e.payload));
+  }
+  f.flush();
+}
+
+// Mock analysis: reads the blackbox stream back and writes a summary.
+void WriteMockSummary(const std::filesystem::path& dumpPath, const std::filesystem::path& summaryPath, std::uint32_t dumpMb)
+{
+  std::ifstream f(dumpPath, std::ios::binary);
+  f.seekg(static_cast<std::streamoff>(dumpMb) << 20);
+  std::uint64_t committed = 0;
+  std::uint32_t seq = 0;
+  char rest[sizeof(std::uint64_t) * 5]{};
+  while (f.read(reinterpret_cast<char*>(&seq), sizeof(seq)) && f.read(rest, sizeof(rest))) {
+    committed += (seq & 1u) == 0u ? 1 : 0;
+  }
+  std::ofstream s(summaryPath, std::ios::binary | std::ios::trunc);
+  s << nlohmann::json{ { "committed_events", committed } }.dump() << "\n";
+}
+
+void RecordCapture(
+  LatencyTable* table,
+  std::string_view scenario,
+  const FakeSegment& seg,
+  const std::filesystem::path& dir,
+  std::uint32_t dumpMb,
+  const StopWatch& sinceTrigger)
+{
+  StopWatch stage;
+  const auto snap = TakeSnapshot(seg);
+  table->Add(scenario, snap.onePass ? "snapshot_one_pass" : "snapshot_copy", stage.ElapsedUs());
+
+  const auto dumpPath = dir / (std::string(scenario) + ".dmp");
+  stage = StopWatch();
+  WriteMockDump(dumpPath, snap, dumpMb);
+  table->Add(scenario, "dump_write", stage.ElapsedUs());
+  table->Add(scenario, "trigger_to_dump", sinceTrigger.ElapsedUs());
+
+  stage = StopWatch();
+  WriteMockSummary(dumpPath, dir / (std::string(scenario) + "_Summary.json"), dumpMb);
+  table->Add(scenario, "summary_write", stage.ElapsedUs());
+  table->Add(scenario, "trigger_to_summary", sinceTrigger.ElapsedUs());
+}
+
+void RunPortableBench(const BenchOptions& options, LatencyTable* table)
+{
+  const auto dumpMb = static_cast<std::uint32_t>(std::stoul(options.extra.count("dump-mb") ? options.extra.at("dump-mb") : "8"));
+  const auto hangThresholdUs = 1000ll * std::stoll(
+    options.extra.count("hang-threshold-ms") ? options.extra.at("hang-threshold-ms") : "200");
+
+  const auto dir = std::filesystem::temp_directory_path() / "skydiag_capture_latency_bench";
+  std::filesystem::create_directories(dir);
+  auto seg = std::make_unique<FakeSegment>();
+  SyntheticTarget target(seg.get());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  for (std::uint32_t i = 0; i < options.iterations; ++i) {
+    // Crash: the target's handler freezes the rings, publishes and signals.
+    {
+      std::mutex m;
+      std::condition_variable cv;
+      bool signaled = false;
+      StopWatch sinceSignal;
+      std::thread handler([&] {
+        seg->frozen.store(true, std::memory_order_release);
+        seg->crashSeq.fetch_add(2, std::memory_order_acq_rel);
+        sinceSignal = StopWatch();
+        {
+          std::lock_guard lock(m);
+          signaled = true;
+        }
+        cv.notify_one();
+      });
+      {
+        std::unique_lock lock(m);
+        cv.wait(lock, [&] { return signaled; });
+      }
+      handler.join();
+      table->Add("crash", "signal_to_wake", sinceSignal.ElapsedUs());
+      RecordCapture(table, "crash", *seg, dir, dumpMb, sinceSignal);
+      seg->frozen.store(false, std::memory_order_release);
+    }
+
+    // Hang: the target stops heartbeating; the helper notices on its poll.
+    {
+      target.SetStalled(true);
+      const auto stalledAt = seg->lastHeartbeatUs.load(std::memory_order_acquire);
+      while (NowUs() - stalledAt < hangThresholdUs) {
+        std::this_thread::sleep_for(kHelperPollInterval);
+      }
+      const auto overdueUs = static_cast<std::uint64_t>(NowUs() - stalledAt - hangThresholdUs);
+      table->Add("hang", "threshold_to_detect", overdueUs);
+      RecordCapture(table, "hang", *seg, dir, dumpMb, StopWatch());
+      target.SetStalled(false);
+    }
+
+    // Manual: hotkey with the target running; always the copy path.
+    RecordCapture(table, "manual", *seg, dir, dumpMb, StopWatch());
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  return RunBenchMain(argc, argv, RunPortableBench);
+}
@@ -0,0 +1,74 @@
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "CaptureLatencyBench.h"
+
+using skydiag::tests::bench::FindLatencyRegressions;
+using skydiag::tests::bench::LatencyTable;
+using skydiag::tests::bench::PercentileUs;
+
+namespace {
+
+void TestNearestRankPercentiles()
+{
+  std::vector<std::uint64_t> samples;
+  for (std::uint64_t i = 100; i >= 1; --i) {
+    samples.push_back(i);
+  }
+  assert(PercentileUs(samples, 0.50) == 50);
+  assert(PercentileUs(samples, 0.90) == 90);
+  assert(PercentileUs(samples, 0.99) == 99);
+  assert(PercentileUs(samples, 1.0) == 100);
+  assert(PercentileUs(samples, 0.0) == 1);
+  assert(PercentileUs({}, 0.5) == 0);
+  assert(PercentileUs({ 7 }, 0.99) == 7);
+}
+
+void TestReportShape()
+{
+  LatencyTable table;
+  table.Add("crash", "dump_write", 300);
+  table.Add("crash", "dump_write", 100);
+  table.Add("crash", "dump_write", 200);
+  table.Add("hang", "tick", 5);
+  const auto j = table.ToJson();
+  assert(j.at("kind") == "skydiag.capture_latency.v1");
+  const auto& dump = j.at("scenarios").at("crash").at("dump_write");
+  assert(dump.at("count") == 3);
+  assert(dump.at("p50_us") == 200);
+  assert(dump.at("max_us") == 300);
+  assert(j.at("scenarios").at("hang").at("tick").at("p99_us") == 5);
+}
+
+void TestRegressionGate()
+{
+  LatencyTable base;
+  LatencyTable now;
+  for (int i = 0; i < 10; ++i) {
+    base.Add("crash", "dump_write", 10'000);
+    base.Add("crash", "snapshot_copy", 100);
+    now.Add("crash", "dump_write", 12'000);   // within 1.5x
+    now.Add("crash", "snapshot_copy", 900);   // 9x, but under the slack
+    now.Add("crash", "new_stage", 50'000);    // no baseline yet
+  }
+  assert(FindLatencyRegressions(now.ToJson(), base.ToJson(), 1.5, 2'000).empty());
+
+  LatencyTable slow;
+  for (int i = 0; i < 10; ++i) {
+    slow.Add("crash", "dump_write", 40'000);
+  }
+  const auto regressions = FindLatencyRegressions(slow.ToJson(), base.ToJson(), 1.5, 2'000);
+  assert(regressions.size() == 2);  // p50 and p90
+  assert(regressions[0].rfind("crash/dump_write p50_us=40000us", 0) == 0);
+}
+
+}  // namespace
+
+int main()
+{
+  TestNearestRankPercentiles();
+  TestReportShape();
+  TestRegressionGate();
+  return 0;
+}
@@ -0,0 +1,282 @@
+// Windows capture latency benchmark.
+//
+// Drives the real HandleCrashEventTick, HandleHangTick and DoManualCapture
+// against a sleeping child process and a test shared layout, and reports
+// per-stage latency percentiles. Stage times come from the helper's own
+// HelperPerf histograms (delta of each stage's total per capture), so the
+// names match SkyrimDiagHelper_Perf.json. Crash captures include the
+// shutdown/first-chance filters, which wait for heartbeats that a sleeping
+// child never sends; keep --iterations small.
+//
+//   skydiag_capture_latency_bench_win [--iterations N] [--out r.json] [--baseline r.json]
+//                                     [--dump-tool <SkyrimDiagDumpToolCli.exe>]
+//
+// With --dump-tool, each dump is analyzed with the CLI and the time until the
+// summary exists is reported as trigger_to_summary.
+
+#include <Windows.h>
+
+#include <array>
+#include <filesystem>
+#include <string>
+
+#include "CaptureLatencyBench.h"
+#include "CrashCapture.h"
+#include "HangCapture.h"
+#include "HelperLog.h"
+#include "HelperRuntimeTestUtils.h"
+#include "ManualCapture.h"
+#include "PendingCrashAnalysis.h"
+#include "PostProcessWorker.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
+#include "SkyrimDiagHelper/LoadStats.h"
+
+using skydiag::helper::HelperConfig;
+using skydiag::helper::HelperPerf;
+using skydiag::helper::kPerfStageCount;
+using skydiag::helper::LoadStats;
+using skydiag::helper::PerfStage;
+using skydiag::helper::PerfStageName;
+using skydiag::helper::internal::ClearLog;
+using skydiag::helper::internal::CrashCaptureState;
+using skydiag::helper::internal::DoManualCapture;
+using skydiag::helper::internal::HandleCrashEventTick;
+using skydiag::helper::internal::HandleHangTick;
+using skydiag::helper::internal::HangCaptureState;
+using skydiag::helper::internal::PendingCrashAnalysis;
+using skydiag::helper::internal::PendingCrashEtwCapture;
+using skydiag::helper::internal::ShutdownPostProcessWorker;
+using skydiag::tests::bench::BenchOptions;
+using skydiag::tests::bench::LatencyTable;
+using skydiag::tests::bench::RunBenchMain;
+using skydiag::tests::bench::StopWatch;
+using skydiag::tests::runtime::ChildProcess;
+using skydiag::tests::runtime::LaunchSleepingChildProcess;
+using skydiag::tests::runtime::MakeAttachedProcessForChild;
+using skydiag::tests::runtime::MakeSharedLayout;
+using skydiag::tests::runtime::MakeTempDir;
+using skydiag::tests::runtime::MakeTestConfig;
+using skydiag::tests::runtime::Require;
+using skydiag::tests::runtime::TerminateChildProcess;
+
+namespace {
+
+using StageTotals = std::array<std::uint64_t, kPerfStageCount>;
+
+StageTotals ReadStageTotals()
+{
+  StageTotals totals{};
+  for (std::size_t i = 0; i < kPerfStageCount; ++i) {
+    totals[i] = HelperPerf().Stage(static_cast<PerfStage>(i)).TotalUs();
+  }
+  return totals;
+}
+
+void AddStageDeltas(LatencyTable* table, std::string_view scenario, const StageTotals& before)
+{
+  const auto after = ReadStageTotals();
+  for (std::size_t i = 0; i < kPerfStageCount; ++i) {
+    if (after[i] > before[i]) {
+      table->Add(scenario, PerfStageName(static_cast<PerfStage>(i)), after[i] - before[i]);
+    }
+  }
+}
+
+std::uint64_t NowFileTime()
+{
+  FILETIME ft{};
+  GetSystemTimeAsFileTime(&ft);
+  return (static_cast<std::uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+}
+
+// Newest .dmp written at or after `sinceFileTime`; its last-write time marks
+// "dump on disk".
+std::filesystem::path FindNewestDump(const std::filesystem::path& dir, std::uint64_t sinceFileTime, std::uint64_t* writeFileTime)
+{
+  std::filesystem::path newest;
+  std::uint64_t newestTime = 0;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+    if (entry.path().extension() != L".dmp") {
+      continue;
+    }
+    WIN32_FILE_ATTRIBUTE_DATA attr{};
+    if (!GetFileAttributesExW(entry.path().c_str(), GetFileExInfoStandard, &attr)) {
+      continue;
+    }
+    const std::uint64_t t =
+      (static_cast<std::uint64_t>(attr.ftLastWriteTime.dwHighDateTime) << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    if (t >= sinceFileTime && t >= newestTime) {
+      newest = entry.path();
+      newestTime = t;
+    }
+  }
+  *writeFileTime = newestTime;
+  return newest;
+}
+
+bool RunDumpToolCli(const std::filesystem::path& exe, const std::filesystem::path& dump)
+{
+  std::wstring cmd = L"\"" + exe.wstring() + L"\" \"" + dump.wstring() + L"\" --headless --no-online-symbols";
+  STARTUPINFOW si{};
+  si.cb = sizeof(si);
+  PROCESS_INFORMATION pi{};
+  if (!CreateProcessW(exe.c_str(), cmd.data(), nullptr, nullptr, FALSE, CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi)) {
+    return false;
+  }
+  WaitForSingleObject(pi.hProcess, INFINITE);
+  DWORD code = 1;
+  GetExitCodeProcess(pi.hProcess, &code);
+  CloseHandle(pi.hThread);
+  CloseHandle(pi.hProcess);
+  return code == 0;
+}
+
+// Records trigger_to_dump (and trigger_to_summary with --dump-tool) for the
+// dump a capture just wrote.
+void AddDiskMilestones(
+  LatencyTable* table,
+  std::string_view scenario,
+  const std::filesystem::path& outBase,
+  std::uint64_t triggerFileTime,
+  const StopWatch& sinceTrigger,
+  const std::filesystem::path& dumpTool)
+{
+  std::uint64_t dumpFileTime = 0;
+  const auto dump = FindNewestDump(outBase, triggerFileTime, &dumpFileTime);
+  if (dump.empty()) {
+    return;
+  }
+  table->Add(scenario, "trigger_to_dump", (dumpFileTime - triggerFileTime) / 10u);
+  if (!dumpTool.empty() && RunDumpToolCli(dumpTool, dump)) {
+    table->Add(scenario, "trigger_to_summary", sinceTrigger.ElapsedUs());
+  }
+}
+
+std::uint64_t QpcNow()
+{
+  LARGE_INTEGER now{};
+  QueryPerformanceCounter(&now);
+  return static_cast<std::uint64_t>(now.QuadPart);
+}
+
+std::uint64_t QpcFrequency()
+{
+  LARGE_INTEGER freq{};
+  QueryPerformanceFrequency(&freq);
+  return static_cast<std::uint64_t>(freq.QuadPart);
+}
+
+void RunWindowsBench(const BenchOptions& options, LatencyTable* table)
+{
+  const std::filesystem::path dumpTool =
+    options.extra.count("dump-tool") ? std::filesystem::path(options.extra.at("dump-tool")) : std::filesystem::path{};
+  const auto outBase = MakeTempDir(L"skydiag_capture_latency_bench");
+  ClearLog(outBase);
+
+  HelperConfig cfg = MakeTestConfig();
+  cfg.suppressHangWhenNotForeground = false;
+  cfg.hangThresholdInGameSec = 1;
+  cfg.enableHangPrecapture = false;
+
+  auto shared = MakeSharedLayout();
+  shared->header.qpc_freq = QpcFrequency();
+  auto child = LaunchSleepingChildProcess();
+  LoadStats loadStats;
+  std::uint32_t adaptiveLoadingThresholdSec = cfg.hangThresholdLoadingSec;
+
+  for (std::uint32_t i = 0; i < options.iterations; ++i) {
+    if (WaitForSingleObject(child.pi.hProcess, 0) != WAIT_TIMEOUT) {
+      TerminateChildProcess(&child);
+      child = LaunchSleepingChildProcess();
+    }
+    auto proc = MakeAttachedProcessForChild(child, shared.get());
+
+    // Crash: a committed, frozen crash record and a signaled event.
+    {
+      shared->header.crash_seq += 2u;
+      shared->header.crash.exception_code = 0xC0000005u;
+      shared->header.crash.faulting_tid = child.pi.dwThreadId;
+      shared->header.crash.exception_addr = reinterpret_cast<std::uint64_t>(shared.get());
+      shared->header.crash.exception_record.ExceptionCode = 0xC0000005u;
+      RtlCaptureContext(&shared->header.crash.context);
+      shared->header.state_flags = skydiag::kState_Frozen;
+      proc.crashEvent = CreateEventW(nullptr, TRUE, TRUE, nullptr);
+      Require(proc.crashEvent != nullptr, "CreateEventW failed");
+
+      CrashCaptureState crashState{};
+      PendingCrashEtwCapture pendingCrashEtw{};
+      PendingCrashAnalysis pendingCrashAnalysis{};
+      std::wstring lastCrashDumpPath;
+      std::wstring pendingHangViewerDumpPath;
+      std::wstring pendingCrashViewerDumpPath;
+      const auto before = ReadStageTotals();
+      const auto triggerFileTime = NowFileTime();
+      const StopWatch sinceTrigger;
+      HandleCrashEventTick(
+        cfg,
+        proc,
+        outBase,
+        /*waitMs=*/0,
+        &crashState,
+        &pendingCrashEtw,
+        &pendingCrashAnalysis,
+        &lastCrashDumpPath,
+        &pendingHangViewerDumpPath,
+        &pendingCrashViewerDumpPath);
+      table->Add("crash", "tick", sinceTrigger.ElapsedUs());
+      AddStageDeltas(table, "crash", before);
+      AddDiskMilestones(table, "crash", outBase, triggerFileTime, sinceTrigger, dumpTool);
+      CloseHandle(proc.crashEvent);
+      proc.crashEvent = nullptr;
+      shared->header.state_flags = skydiag::kState_None;
+    }
+
+    // Hang: heartbeat already past the in-game threshold.
+    {
+      shared->header.last_heartbeat_qpc = QpcNow() - 2ull * shared->header.qpc_freq;
+      HangCaptureState state{};
+      std::wstring pendingHangViewerDumpPath;
+      const auto before = ReadStageTotals();
+      const auto triggerFileTime = NowFileTime();
+      const StopWatch sinceTrigger;
+      HandleHangTick(
+        cfg,
+        proc,
+        outBase,
+        &loadStats,
+        outBase / L"load_stats.json",
+        &adaptiveLoadingThresholdSec,
+        /*attachNowQpc=*/QpcNow() - 60ull * shared->header.qpc_freq,
+        &pendingHangViewerDumpPath,
+        &state);
+      table->Add("hang", "tick", sinceTrigger.ElapsedUs());
+      AddStageDeltas(table, "hang", before);
+      AddDiskMilestones(table, "hang", outBase, triggerFileTime, sinceTrigger, dumpTool);
+      shared->header.last_heartbeat_qpc = QpcNow();
+    }
+
+    // Manual: hotkey path.
+    {
+      const auto before = ReadStageTotals();
+      const auto triggerFileTime = NowFileTime();
+      const StopWatch sinceTrigger;
+      DoManualCapture(cfg, proc, outBase, loadStats, adaptiveLoadingThresholdSec, L"bench");
+      table->Add("manual", "capture", sinceTrigger.ElapsedUs());
+      AddStageDeltas(table, "manual", before);
+      AddDiskMilestones(table, "manual", outBase, triggerFileTime, sinceTrigger, dumpTool);
+    }
+  }
+
+  ShutdownPostProcessWorker();
+  TerminateChildProcess(&child);
+  std::error_code ec;
+  std::filesystem::remove_all(outBase, ec);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  return RunBenchMain(argc, argv, RunWindowsBench);
+}
@@ -39,7 +39,91 @@ int main()
     "FilterShutdownException(",
     "Dump-first strategy must be preserved before filtering.");
 
+  AssertContains(
+    crashTickBody,
+    "CaptureKind::CrashThin",
+    "Two-phase crash capture must write the thin profile first.");
+  AssertOrdered(
+    crashTickBody,
+    "WriteDumpWithStreams(",
+    "QueueCrashEnrichmentDump(",
+    "The enrichment dump must follow the thin dump.");
+  AssertOrdered(
+    crashTickBody,
+    "QueueCrashEnrichmentDump(",
+    "FilterShutdownException(",
+    "Enrichment must be queued before the heartbeat filters give the process time to exit.");
+  AssertContains(
+    crashTickBody,
+    "DiscardCrashEnrichment(outBase, enrichment);",
+    "A filtered crash must discard its queued enrichment.");
+
+  AssertOrdered(
+    crashTickBody,
+    "TryCopyFrozenSharedView(frozenView, &stableSnapshot)",
+    "CaptureStableSharedSnapshot(",
+    "The one-pass copy of a frozen mapping must be tried before the per-entry copy.");
+  assert(
+    crashTickBody.find("= frozenView.layout") == std::string::npos &&
+    "The thin dump must never stream the live mapping; plugin writers can still land during the write.");
+  const std::string enrichmentBody =
+    ExtractFunctionBody(crashCapture, "CrashEnrichmentOutcome QueueCrashEnrichmentDump(");
+  AssertOrdered(
+    enrichmentBody,
+    "job.run = [",
+    "WriteDumpWithStreams(",
+    "The enrichment dump must be written by its post-process job, not the capture thread.");
+  AssertOrdered(
+    enrichmentBody,
+    "WriteDumpWithStreams(",
+    "EnqueuePostProcessJob(",
+    "The capture thread must only enqueue the enrichment.");
+  AssertContains(
+    enrichmentBody,
+    "std::make_shared<StableSharedSnapshot>(std::move(snapshot))",
+    "The enrichment job must own its shared-layout copy; the frozen view can be thawed under it.");
+
+  const std::string crashLoopBody =
+    ExtractFunctionBody(crashCapture, "CrashLoopCapture FingerprintAndEvaluateCrashLoop(");
+  AssertOrdered(
+    crashLoopBody,
+    "ComputeCaptureFingerprint(",
+    "EvaluateCrashLoop(",
+    "The crash-loop key is derived from the capture-time fingerprint.");
+  assert(
+    crashTickBody.find("ComputeCaptureFingerprint(") == std::string::npos &&
+    "HandleCrashEventTick must fingerprint only through FingerprintAndEvaluateCrashLoop.");
+  AssertOrdered(
+    crashTickBody,
+    "CaptureFingerprintInputs(",
+    "WriteDumpWithStreams(",
+    "The fingerprint's module list and stack must be read before the thin dump, while the process is alive.");
+  AssertOrdered(
+    crashTickBody,
+    "if (!twoPhase) {\n    crashLoop = FingerprintAndEvaluateCrashLoop(",
+    "WriteDumpWithStreams(",
+    "Single-phase capture must decide crash-loop backoff before the dump profile is chosen.");
+  AssertOrdered(
+    crashTickBody,
+    "WriteDumpWithStreams(",
+    "if (twoPhase) {\n    crashLoop = FingerprintAndEvaluateCrashLoop(",
+    "Two-phase capture must not load crash-loop history before the thin dump is written.");
+  AssertOrdered(
+    crashTickBody,
+    "if (twoPhase) {\n    crashLoop = FingerprintAndEvaluateCrashLoop(",
+    "QueueCrashEnrichmentDump(",
+    "The crash-loop decision gates the enrichment dump.");
+  AssertOrdered(
+    crashTickBody,
+    "FilterShutdownException(",
+    "RecordCrashLoopOutcome(",
+    "Filtered (benign) crash events must not count toward crash-loop history.");
+
   const std::string processValidBody = ExtractFunctionBody(crashCapture, "void ProcessValidCrashDump(");
+  AssertContains(
+    processValidBody,
+    "!crashLoopThin",
+    "Crash-loop backoff must skip analysis and viewer work in ProcessValidCrashDump.");
   AssertContains(
     processValidBody,
     "CollectPluginScanJson(",
@@ -56,11 +140,25 @@ int main()
     processValidBody,
     "ApplyRetentionFromConfig(cfg, outBase)",
     "ProcessValidCrashDump must apply retention policy.");
+  AssertOrdered(
+    processValidBody,
+    "StartPendingCrashAnalysisTask(",
+    "ApplyRetentionFromConfig(cfg, outBase)",
+    "Crash retention must be queued after the headless analysis job is tracked.");
   AssertOrdered(
     processValidBody,
     "StartEtwCaptureWithProfile(",
     "MakeIncidentManifestV1(",
     "ETW start logic must appear before manifest generation.");
+  AssertOrdered(
+    processValidBody,
+    "WriteTextFileUtf8(manifestPath, manifest.dump(2));",
+    "QueueCrashEnrichmentManifestUpdate(outBase, manifestPath, enrichment);",
+    "The manifest must be updated once the queued enrichment has finished.");
+  AssertContains(
+    processValidBody,
+    "/*launchAfter=*/enrichment.job",
+    "Crash analysis must wait for the queued enrichment.");
 
   AssertContains(
     crashCaptureHeader,
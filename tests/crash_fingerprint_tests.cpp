@@ -0,0 +1,152 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "SkyrimDiagHelper/CrashFingerprint.h"
+
+using skydiag::helper::ComputeCrashFingerprint;
+using skydiag::helper::CrashFingerprintToJson;
+using skydiag::helper::FingerprintModule;
+using skydiag::helper::FingerprintModuleIndex;
+
+namespace {
+
+constexpr std::uint32_t kAccessViolation = 0xC0000005u;
+constexpr std::uint64_t kGameBase = 0x7FF600000000ull;
+constexpr std::uint64_t kPluginBase = 0x7FFA10000000ull;
+
+FingerprintModuleIndex MakeModules(std::uint64_t gameBase, std::uint64_t pluginBase)
+{
+  return FingerprintModuleIndex({
+    { "plugin.dll", pluginBase, 0x100000 },
+    { "skyrimse.exe", gameBase, 0x4000000 },
+  });
+}
+
+std::vector<std::uint8_t> MakeStack(const std::vector<std::uint64_t>& qwords)
+{
+  std::vector<std::uint8_t> bytes(qwords.size() * 8);
+  std::memcpy(bytes.data(), qwords.data(), bytes.size());
+  return bytes;
+}
+
+void TestModuleIndexLookup()
+{
+  const auto modules = MakeModules(kGameBase, kPluginBase);
+  assert(modules.Find(kGameBase)->nameLower == "skyrimse.exe");
+  assert(modules.Find(kPluginBase + 0xFFFFF)->nameLower == "plugin.dll");
+  assert(modules.Find(kPluginBase + 0x100000) == nullptr);
+  assert(modules.Find(kGameBase - 1) == nullptr);
+  assert(modules.Find(0) == nullptr);
+
+  // Overlapping and empty entries never shadow the first module.
+  const FingerprintModuleIndex overlapping({
+    { "a.dll", 0x1000, 0x1000 },
+    { "b.dll", 0x1800, 0x1000 },
+    { "empty.dll", 0x5000, 0 },
+  });
+  assert(overlapping.Find(0x1900)->nameLower == "a.dll");
+  assert(overlapping.Find(0x2100) == nullptr);
+  assert(overlapping.Find(0x5000) == nullptr);
+}
+
+void TestFaultAndFramesAreModuleRelative()
+{
+  const auto modules = MakeModules(kGameBase, kPluginBase);
+  const auto stack = MakeStack({
+    0x0000000000001234ull,  // not code
+    kPluginBase + 0x2345,
+    kPluginBase + 0x2345,   // spilled copy, skipped
+    0x00000200DEADBEEFull,  // heap-like value
+    kGameBase + 0x123456,
+  });
+  const auto fp = ComputeCrashFingerprint(kAccessViolation, kPluginBase + 0x1000, modules, stack.data(), stack.size());
+  assert(fp.key.rfind("HFP1-", 0) == 0);
+  assert(fp.key.size() == 5 + 16);
+  assert(fp.faultModule == "plugin.dll");
+  assert(fp.faultOffset == 0x1000);
+  assert(fp.frames.size() == 2);
+  assert(fp.frames[0].module == "plugin.dll" && fp.frames[0].offset == 0x2345);
+  assert(fp.frames[1].module == "skyrimse.exe" && fp.frames[1].offset == 0x123456);
+  assert(fp.scannedBytes == stack.size());
+}
+
+void TestKeyIsStableAcrossAslr()
+{
+  const auto a = MakeModules(kGameBase, kPluginBase);
+  const auto b = MakeModules(kGameBase + 0x10000000, kPluginBase - 0x20000000);
+  const auto stackA = MakeStack({ kGameBase + 0x500 });
+  const auto stackB = MakeStack({ kGameBase + 0x10000000 + 0x500 });
+  const auto fpA = ComputeCrashFingerprint(kAccessViolation, kPluginBase + 0x40, a, stackA.data(), stackA.size());
+  const auto fpB =
+    ComputeCrashFingerprint(kAccessViolation, kPluginBase - 0x20000000 + 0x40, b, stackB.data(), stackB.size());
+  assert(fpA.key == fpB.key);
+
+  const auto fpOtherCode = ComputeCrashFingerprint(0xC000001Du, kPluginBase + 0x40, a, stackA.data(), stackA.size());
+  assert(fpOtherCode.key != fpA.key);
+}
+
+void TestFrameBudgetAndUnknownFault()
+{
+  const auto modules = MakeModules(kGameBase, kPluginBase);
+  std::vector<std::uint64_t> qwords;
+  for (std::uint64_t i = 0; i < 32; ++i) {
+    qwords.push_back(kGameBase + 0x100 + i * 0x10);
+  }
+  const auto stack = MakeStack(qwords);
+  const auto fp = ComputeCrashFingerprint(kAccessViolation, 0x10, modules, stack.data(), stack.size(), 3);
+  assert(fp.faultModule.empty());
+  assert(fp.faultOffset == 0x10);
+  assert(fp.frames.size() == 3);
+
+  // Without stack bytes the fault part alone still yields a key.
+  const auto noStack = ComputeCrashFingerprint(kAccessViolation, kGameBase + 0x10, modules, nullptr, 0);
+  assert(!noStack.key.empty());
+  assert(noStack.frames.empty());
+  assert(noStack.scannedBytes == 0);
+
+  const auto empty = ComputeCrashFingerprint(0, 0, modules, stack.data(), stack.size());
+  assert(empty.key.empty());
+}
+
+void TestStackScanIsBounded()
+{
+  const auto modules = MakeModules(kGameBase, kPluginBase);
+  std::vector<std::uint8_t> big(skydiag::helper::kCrashFingerprintStackScanBytes * 2 + 3, 0);
+  const std::uint64_t lateFrame = kGameBase + 0x42;
+  std::memcpy(big.data() + skydiag::helper::kCrashFingerprintStackScanBytes, &lateFrame, sizeof(lateFrame));
+  const auto fp = ComputeCrashFingerprint(kAccessViolation, kGameBase, modules, big.data(), big.size());
+  assert(fp.scannedBytes == skydiag::helper::kCrashFingerprintStackScanBytes);
+  assert(fp.frames.empty());
+}
+
+void TestJsonShape()
+{
+  const auto modules = MakeModules(kGameBase, kPluginBase);
+  const auto stack = MakeStack({ kGameBase + 0xABC });
+  const auto fp = ComputeCrashFingerprint(kAccessViolation, kPluginBase + 0x10, modules, stack.data(), stack.size());
+  const auto j = CrashFingerprintToJson(fp);
+  assert(j.at("version").get<std::uint32_t>() == skydiag::helper::kCrashFingerprintVersion);
+  assert(j.at("key").get<std::string>() == fp.key);
+  assert(j.at("exception_code").get<std::uint32_t>() == kAccessViolation);
+  assert(j.at("fault_module").get<std::string>() == "plugin.dll");
+  assert(j.at("fault_offset").get<std::uint64_t>() == 0x10);
+  assert(j.at("stack_frames").size() == 1);
+  assert(j.at("stack_frames")[0].get<std::string>() == "skyrimse.exe+0xabc");
+}
+
+}  // namespace
+
+int main()
+{
+  TestModuleIndexLookup();
+  TestFaultAndFramesAreModuleRelative();
+  TestKeyIsStableAcrossAslr();
+  TestFrameBudgetAndUnknownFault();
+  TestStackScanIsBounded();
+  TestJsonShape();
+  return 0;
+}
@@ -93,10 +93,11 @@ std::vector<std::byte> BuildBlackboxMinidump(std::uint32_t protocolVersion)
 void VerifyOfflineBlackboxProtocolVersion(std::uint32_t protocolVersion)
 {
   auto dump = BuildBlackboxMinidump(protocolVersion);
+  skydiag::dump_tool::minidump::MinidumpIndex index;
+  assert(index.Build(dump.data(), dump.size(), nullptr));
   skydiag::dump_tool::AnalysisResult result{};
   skydiag::dump_tool::ParseBlackboxStream(
-    dump.data(),
-    dump.size(),
+    index,
     std::nullopt,
     {},
     result);
@@ -120,10 +121,11 @@ void TestOfflineParserAcceptsV3AndV4OnlyAsSupportedGenerations()
   VerifyOfflineBlackboxProtocolVersion(skydiag::kVersion);
 
   auto futureDump = BuildBlackboxMinidump(skydiag::kVersion + 1u);
+  skydiag::dump_tool::minidump::MinidumpIndex futureIndex;
+  assert(futureIndex.Build(futureDump.data(), futureDump.size(), nullptr));
   skydiag::dump_tool::AnalysisResult futureResult{};
   skydiag::dump_tool::ParseBlackboxStream(
-    futureDump.data(),
-    futureDump.size(),
+    futureIndex,
     std::nullopt,
     {},
     futureResult);
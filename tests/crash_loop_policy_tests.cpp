@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SkyrimDiagHelper/CrashLoopPolicy.h"
+
+using skydiag::helper::CrashLoopEntryAge;
+using skydiag::helper::CrashLoopHistory;
+using skydiag::helper::CrashLoopLimits;
+using skydiag::helper::DecideCrashLoopCapture;
+using skydiag::helper::RecordCrashLoopCapture;
+using skydiag::helper::SelectCrashLoopKeysToPrune;
+
+namespace {
+
+constexpr std::uint64_t kNow = 1'800'000'000ull;
+
+void TestRichCapturesUntilLimit()
+{
+  CrashLoopLimits limits{};
+  limits.richCaptureLimit = 3;
+  limits.windowSec = 3600;
+
+  CrashLoopHistory history{};
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    const auto d = DecideCrashLoopCapture(history, kNow + i, limits);
+    assert(!d.downgrade);
+    assert(d.backoffThinHits == 0);
+    RecordCrashLoopCapture(&history, /*rich=*/true, kNow + i, limits.windowSec);
+  }
+  const auto d = DecideCrashLoopCapture(history, kNow + 10, limits);
+  assert(d.downgrade);
+  assert(d.richInWindow == 3);
+  assert(d.backoffThinHits == 2);
+}
+
+void TestBackoffDoublesBetweenRichCaptures()
+{
+  CrashLoopLimits limits{};
+  limits.richCaptureLimit = 1;
+  limits.windowSec = 86'400;
+
+  CrashLoopHistory history{};
+  std::uint64_t t = kNow;
+  RecordCrashLoopCapture(&history, true, t, limits.windowSec);
+
+  // Sequence after the first rich capture: 2 thin, rich, 4 thin, rich, 8 thin, rich.
+  for (std::uint32_t expectedThin : { 2u, 4u, 8u }) {
+    for (std::uint32_t i = 0; i < expectedThin; ++i) {
+      const auto d = DecideCrashLoopCapture(history, ++t, limits);
+      assert(d.downgrade);
+      assert(d.backoffThinHits == expectedThin);
+      RecordCrashLoopCapture(&history, false, t, limits.windowSec);
+    }
+    const auto d = DecideCrashLoopCapture(history, ++t, limits);
+    assert(!d.downgrade);
+    RecordCrashLoopCapture(&history, true, t, limits.windowSec);
+    assert(history.thinSinceRich == 0);
+  }
+  assert(history.thinTotal == 14);
+}
+
+void TestBackoffIsCapped()
+{
+  CrashLoopLimits limits{};
+  limits.richCaptureLimit = 1;
+  CrashLoopHistory history{};
+  for (std::uint64_t i = 0; i < 40; ++i) {
+    history.richCaptureUnixSec.push_back(kNow + i);
+  }
+  const auto d = DecideCrashLoopCapture(history, kNow + 100, limits);
+  assert(d.downgrade);
+  assert(d.backoffThinHits == skydiag::helper::kCrashLoopMaxBackoffThinHits);
+}
+
+void TestOldRichCapturesAgeOut()
+{
+  CrashLoopLimits limits{};
+  limits.richCaptureLimit = 2;
+  limits.windowSec = 600;
+
+  CrashLoopHistory history{};
+  RecordCrashLoopCapture(&history, true, kNow, limits.windowSec);
+  RecordCrashLoopCapture(&history, true, kNow + 1, limits.windowSec);
+  assert(DecideCrashLoopCapture(history, kNow + 2, limits).downgrade);
+
+  const auto later = kNow + 1 + limits.windowSec + 1;
+  const auto d = DecideCrashLoopCapture(history, later, limits);
+  assert(!d.downgrade);
+  assert(d.richInWindow == 0);
+
+  RecordCrashLoopCapture(&history, true, later, limits.windowSec);
+  assert(history.richCaptureUnixSec.size() == 1);
+}
+
+void TestKeyIsModuleRelative()
+{
+  const auto key = skydiag::helper::BuildCrashLoopKey(0xC0000005u, "skyrimse.exe", 0x1234ABull);
+  assert(key == "C0000005:skyrimse.exe+0x1234AB");
+  assert(skydiag::helper::BuildCrashLoopKey(0x80000003u, "", 0x7FF612340000ull) == "80000003:?+0x7FF612340000");
+}
+
+void TestPrunesIdleKeysBeyondWindow()
+{
+  const std::vector<CrashLoopEntryAge> entries = {
+    { "idle", kNow - 700 },
+    { "recent", kNow - 10 },
+    { "current", kNow - 5000 },
+  };
+  const auto drop = SelectCrashLoopKeysToPrune(entries, "current", kNow, /*windowSec=*/600);
+  assert(drop.size() == 1);
+  assert(drop[0] == "idle");
+}
+
+void TestCapsTrackedKeysOldestFirst()
+{
+  std::vector<CrashLoopEntryAge> entries;
+  for (std::uint64_t i = 0; i < 6; ++i) {
+    entries.push_back({ "k" + std::to_string(i), kNow - 100 + i });
+  }
+  // Cap of 4 keeps "current" plus the three most recently updated others.
+  entries.push_back({ "current", kNow });
+  auto drop = SelectCrashLoopKeysToPrune(entries, "current", kNow, /*windowSec=*/3600, /*maxKeys=*/4);
+  std::sort(drop.begin(), drop.end());
+  assert((drop == std::vector<std::string>{ "k0", "k1", "k2" }));
+
+  assert(SelectCrashLoopKeysToPrune(entries, "current", kNow, 3600).empty());
+}
+
+}  // namespace
+
+int main()
+{
+  TestRichCapturesUntilLimit();
+  TestBackoffDoublesBetweenRichCaptures();
+  TestBackoffIsCapped();
+  TestOldRichCapturesAgeOut();
+  TestKeyIsModuleRelative();
+  TestPrunesIdleKeysBeyondWindow();
+  TestCapsTrackedKeysOldestFirst();
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include <cassert>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "SkyrimDiagHelper/Config.h"
 #include "SkyrimDiagHelper/CrashRecapturePolicy.h"
@@ -159,6 +161,39 @@ void TestStrongFreezeStateSkipsRecapture()
   assert(d.targetProfile == skydiag::helper::RecaptureTargetProfile::kNone);
 }
 
+void TestStackwalkDegradedPrefersStructuredField()
+{
+  using skydiag::helper::IsStackwalkDegraded;
+  const std::vector<std::string> fallbackLine = {
+    "[Symbols] cache ready",
+    "[Stackwalk] stackwalk found no suspects, falling back to stack scan",
+  };
+  const std::vector<std::string> legacyLine = { "[Stackwalk] DbgHelp stackwalk failed; using stack scan" };
+
+  assert(IsStackwalkDegraded(true, {}));
+  assert(!IsStackwalkDegraded(false, fallbackLine));  // the field wins over stale text
+  // Summaries written before the field existed.
+  assert(IsStackwalkDegraded(std::nullopt, fallbackLine));
+  assert(IsStackwalkDegraded(std::nullopt, legacyLine));
+  assert(!IsStackwalkDegraded(std::nullopt, { "[Symbols] cache ready" }));
+
+  const auto d = skydiag::helper::DecideCrashRecapture(
+    /*enablePolicy=*/true,
+    /*autoAnalyzeDump=*/true,
+    /*unknownFaultModule=*/false,
+    /*unknownStreak=*/0,
+    /*bucketSeenCount=*/1,
+    /*threshold=*/2,
+    /*candidateConflict=*/false,
+    /*isolatedReferenceClue=*/false,
+    /*degradedStackwalk=*/IsStackwalkDegraded(true, {}),
+    /*symbolRuntimeDegraded=*/false,
+    /*firstChanceCandidateWeak=*/false,
+    DumpMode::kMini);
+  assert(d.triggeredByStackwalkDegraded);
+  assert(HasReason(d, skydiag::helper::RecaptureReason::kStackwalkDegraded));
+}
+
 }  // namespace
 
 int main()
@@ -170,5 +205,6 @@ int main()
   TestFreezeAmbiguousSelectsSnapshotProfile();
   TestFreezeSnapshotFallbackSelectsSnapshotProfile();
   TestStrongFreezeStateSkipsRecapture();
+  TestStackwalkDegradedPrefersStructuredField();
   return 0;
 }
@@ -0,0 +1,258 @@
+#include "SkyrimDiagHelper/DumpDelta.h"
+
+#include "MemoryRangeOverlay.h"
+#include "SourceGuardTestUtils.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using skydiag::dump_tool::AddressSpan;
+using skydiag::dump_tool::CoalesceSpans;
+using skydiag::dump_tool::UncoveredSpans;
+using skydiag::helper::CoalesceMemoryRanges;
+using skydiag::helper::MemoryRange;
+using skydiag::tests::source_guard::ReadProjectText;
+
+namespace {
+
+class MinidumpBuilder
+{
+public:
+  void AddThreadStack(std::uint64_t start, std::uint32_t size)
+  {
+    m_threads.push_back({ start, size });
+  }
+  void AddMemory(std::uint64_t start, std::uint32_t size) { m_memory.push_back({ start, size }); }
+  void AddMemory64(std::uint64_t start, std::uint64_t size) { m_memory64.push_back({ start, size }); }
+
+  std::vector<std::uint8_t> Build() const
+  {
+    std::vector<std::uint8_t> out(32, 0);
+    Put32(out, 0, 0x504D444Du);
+    Put32(out, 8, 3);
+    Put32(out, 12, 32);
+    const std::size_t dirAt = out.size();
+    out.resize(out.size() + 3 * 12, 0);
+
+    const auto threadRva = static_cast<std::uint32_t>(out.size());
+    Append32(out, static_cast<std::uint32_t>(m_threads.size()));
+    for (const auto& t : m_threads) {
+      const std::size_t at = out.size();
+      out.resize(at + 48, 0);
+      Put64(out, at + 24, t.base);
+      Put32(out, at + 32, static_cast<std::uint32_t>(t.size));
+    }
+    const auto threadSize = static_cast<std::uint32_t>(out.size() - threadRva);
+
+    const auto memRva = static_cast<std::uint32_t>(out.size());
+    Append32(out, static_cast<std::uint32_t>(m_memory.size()));
+    for (const auto& m : m_memory) {
+      const std::size_t at = out.size();
+      out.resize(at + 16, 0);
+      Put64(out, at, m.base);
+      Put32(out, at + 8, static_cast<std::uint32_t>(m.size));
+    }
+    const auto memSize = static_cast<std::uint32_t>(out.size() - memRva);
+
+    const auto mem64Rva = static_cast<std::uint32_t>(out.size());
+    out.resize(out.size() + 16, 0);
+    Put64(out, mem64Rva, m_memory64.size());
+    for (const auto& m : m_memory64) {
+      const std::size_t at = out.size();
+      out.resize(at + 16, 0);
+      Put64(out, at, m.base);
+      Put64(out, at + 8, m.size);
+    }
+    const auto mem64Size = static_cast<std::uint32_t>(out.size() - mem64Rva);
+
+    const std::uint32_t entries[3][3] = {
+      { 3, threadSize, threadRva },
+      { 5, memSize, memRva },
+      { 9, mem64Size, mem64Rva },
+    };
+    for (std::size_t i = 0; i < 3; ++i) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        Put32(out, dirAt + i * 12 + k * 4, entries[i][k]);
+      }
+    }
+    return out;
+  }
+
+private:
+  static void Put32(std::vector<std::uint8_t>& b, std::size_t at, std::uint32_t v) { std::memcpy(b.data() + at, &v, 4); }
+  static void Put64(std::vector<std::uint8_t>& b, std::size_t at, std::uint64_t v) { std::memcpy(b.data() + at, &v, 8); }
+  static void Append32(std::vector<std::uint8_t>& b, std::uint32_t v)
+  {
+    b.resize(b.size() + 4);
+    Put32(b, b.size() - 4, v);
+  }
+
+  std::vector<MemoryRange> m_threads;
+  std::vector<MemoryRange> m_memory;
+  std::vector<MemoryRange> m_memory64;
+};
+
+std::filesystem::path WriteTempFile(const char* name, const std::vector<std::uint8_t>& bytes)
+{
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  return path;
+}
+
+void TestCoalesceMergesOverlapsAndDropsEmpty()
+{
+  const auto merged = CoalesceMemoryRanges({
+    { 0x3000, 0x1000 },
+    { 0x1000, 0x1000 },
+    { 0x1800, 0x1000 },  // overlaps the previous
+    { 0x5000, 0 },
+    { 0x2800, 0x800 },   // touches 0x3000
+  });
+  assert(merged.size() == 1);
+  assert(merged[0].base == 0x1000);
+  assert(merged[0].size == 0x3000);
+}
+
+void TestSplitKeepsCallbackSizesBelow32Bits()
+{
+  const auto split = skydiag::helper::SplitMemoryRangesForCallback({ { 0x10000, 0x1'2000'0000ull } });
+  std::uint64_t total = 0;
+  for (const auto& r : split) {
+    assert(r.size <= 0x8000'0000ull);
+    total += r.size;
+  }
+  assert(split.size() == 3);
+  assert(total == 0x1'2000'0000ull);
+  assert(split[1].base == split[0].base + split[0].size);
+}
+
+void TestReadsAllMemorySourcesFromMinidump()
+{
+  MinidumpBuilder b;
+  b.AddThreadStack(0x7000'0000, 0x2000);
+  b.AddMemory(0x1000, 0x100);
+  b.AddMemory64(0x4000'0000, 0x10000);
+  b.AddMemory64(0x4001'0000, 0x10000);
+  const auto path = WriteTempFile("skydiag_dump_delta_base.dmp", b.Build());
+
+  std::vector<MemoryRange> ranges;
+  std::string err;
+  assert(skydiag::helper::ReadMinidumpMemoryRanges(path, &ranges, &err));
+  assert(ranges.size() == 3);
+  assert(ranges[0].base == 0x1000 && ranges[0].size == 0x100);
+  assert(ranges[1].base == 0x4000'0000 && ranges[1].size == 0x20000);
+  assert(ranges[2].base == 0x7000'0000 && ranges[2].size == 0x2000);
+  std::filesystem::remove(path);
+}
+
+void TestRejectsNonMinidumpAndTruncatedFiles()
+{
+  std::vector<MemoryRange> ranges{ { 1, 1 } };
+  std::string err;
+  const auto junk = WriteTempFile("skydiag_dump_delta_junk.dmp", std::vector<std::uint8_t>(64, 0xAB));
+  assert(!skydiag::helper::ReadMinidumpMemoryRanges(junk, &ranges, &err));
+  assert(ranges.empty());
+  assert(!err.empty());
+  std::filesystem::remove(junk);
+
+  MinidumpBuilder b;
+  b.AddMemory64(0x4000'0000, 0x1000);
+  auto bytes = b.Build();
+  bytes.resize(40);  // directory cut short
+  const auto truncated = WriteTempFile("skydiag_dump_delta_truncated.dmp", bytes);
+  assert(!skydiag::helper::ReadMinidumpMemoryRanges(truncated, &ranges, &err));
+  std::filesystem::remove(truncated);
+
+  assert(!skydiag::helper::ReadMinidumpMemoryRanges("does_not_exist.dmp", &ranges, &err));
+}
+
+void TestDeltaStreamNamesBaseIdentity()
+{
+  skydiag::helper::DumpDeltaBase base{};
+  base.filenameUtf8 = "SkyrimDiag_Crash_20260101_000000.dmp";
+  base.sizeBytes = 12345;
+  base.lastWriteTimeUtc100ns = 678;
+  base.memoryRanges = { { 0x1000, 0x1000 }, { 0x8000, 0x3000 } };
+
+  const auto j = nlohmann::json::parse(skydiag::helper::BuildDumpDeltaStreamJson(base));
+  assert(j["format"] == "skydiag_dump_delta");
+  assert(j["version"] == skydiag::helper::kDumpDeltaFormatVersion);
+  assert(j["base_dump"] == base.filenameUtf8);
+  assert(j["base_size_bytes"] == 12345u);
+  assert(j["base_last_write_utc_100ns"] == 678u);
+  assert(j["omitted_ranges"] == 2u);
+  assert(j["omitted_bytes"] == 0x4000u);
+}
+
+void TestOverlayKeepsBaseAndFillsGaps()
+{
+  const auto covered = CoalesceSpans({ { 0x3000, 0x4000 }, { 0x1000, 0x2000 }, { 0x1800, 0x2800 } });
+  assert(covered.size() == 2);
+  assert(covered[0].start == 0x1000 && covered[0].end == 0x2800);
+
+  // Delta range spanning both base spans: only the holes come through.
+  const auto gaps = UncoveredSpans(covered, 0x0800, 0x5000);
+  assert(gaps.size() == 3);
+  assert(gaps[0].start == 0x0800 && gaps[0].end == 0x1000);
+  assert(gaps[1].start == 0x2800 && gaps[1].end == 0x3000);
+  assert(gaps[2].start == 0x4000 && gaps[2].end == 0x5000);
+
+  // Starting inside a base span.
+  const auto inner = UncoveredSpans(covered, 0x2000, 0x3800);
+  assert(inner.size() == 1);
+  assert(inner[0].start == 0x2800 && inner[0].end == 0x3000);
+
+  assert(UncoveredSpans(covered, 0x1100, 0x1200).empty());
+  assert(UncoveredSpans({}, 5, 9).size() == 1);
+  assert(UncoveredSpans(covered, 9, 9).empty());
+}
+
+void TestOverlayScopeIsStackwalkMemoryOnly()
+{
+  // The delta overlays the stackwalk memory view and nothing else: streams
+  // and the stack scan come from the base. Pin that, and that the summary
+  // says so, so a consumer never reads more into overlay_applied.
+  const auto analyzer = ReadProjectText("dump_tool/src/Analyzer.cpp");
+  const auto first = analyzer.find("deltaOverlay ? &*deltaOverlay : nullptr");
+  assert(first != std::string::npos);
+  assert(analyzer.find("deltaOverlay ? &*deltaOverlay : nullptr", first + 1) == std::string::npos);
+  const auto suspects = analyzer.rfind("ComputeSuspects(", first);
+  assert(suspects != std::string::npos && analyzer.find(';', suspects) > first);
+
+  // Inside ComputeSuspects the overlay reaches the stackwalk and not the scan.
+  const auto inputs = ReadProjectText("dump_tool/src/Analyzer.CaptureInputs.cpp");
+  const auto body = inputs.find("void ComputeSuspects(");
+  assert(body != std::string::npos);
+  const auto walk = inputs.find("internal::TryComputeStackwalkSuspects(", body);
+  const auto scan = inputs.find("internal::ComputeStackScanSuspects(", body);
+  assert(walk != std::string::npos && scan != std::string::npos);
+  const auto walkArgs = inputs.substr(walk, inputs.find(')', walk) - walk);
+  const auto scanArgs = inputs.substr(scan, inputs.find(')', scan) - scan);
+  assert(walkArgs.find("overlay") != std::string::npos);
+  assert(scanArgs.find("overlay") == std::string::npos);
+
+  const auto summary = ReadProjectText("dump_tool/src/OutputWriter.Summary.cpp");
+  assert(summary.find("\"overlay_scope\", r.dump_delta_overlay_applied ? \"stackwalk_memory\"") != std::string::npos);
+}
+
+}  // namespace
+
+int main()
+{
+  TestCoalesceMergesOverlapsAndDropsEmpty();
+  TestSplitKeepsCallbackSizesBelow32Bits();
+  TestReadsAllMemorySourcesFromMinidump();
+  TestRejectsNonMinidumpAndTruncatedFiles();
+  TestDeltaStreamNamesBaseIdentity();
+  TestOverlayKeepsBaseAndFillsGaps();
+  TestOverlayScopeIsStackwalkMemoryOnly();
+  return 0;
+}
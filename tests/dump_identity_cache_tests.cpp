@@ -0,0 +1,111 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+
+#include "DumpIdentityCache.h"
+
+using skydiag::dump_tool::DumpIdentityCacheKey;
+using skydiag::dump_tool::DumpIdentityCachePath;
+using skydiag::dump_tool::LookupDumpIdentityCache;
+using skydiag::dump_tool::StoreDumpIdentityCache;
+
+namespace {
+
+const std::string kFlat = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+const std::string kTree = "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1";
+
+std::filesystem::path FreshDir()
+{
+  std::random_device rd;
+  const auto dir = std::filesystem::temp_directory_path() /
+    ("skydiag_identity_cache_" + std::to_string(rd()));
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  return dir;
+}
+
+DumpIdentityCacheKey Key()
+{
+  DumpIdentityCacheKey key{};
+  key.volume_serial_number = 0x1234abcdu;
+  key.file_index = 0x0001000000000042ull;
+  key.size_bytes = 4096;
+  key.last_write_time_utc_100ns = 133000000000000000ull;
+  return key;
+}
+
+void TestRoundTripAndMisses()
+{
+  const auto dir = FreshDir();
+  const auto key = Key();
+
+  assert(!LookupDumpIdentityCache(dir, key, "sha256"));
+  assert(StoreDumpIdentityCache(dir, key, "sha256", kFlat));
+  assert(LookupDumpIdentityCache(dir, key, "sha256") == kFlat);
+  assert(!LookupDumpIdentityCache(dir, key, "tree-sha256"));
+
+  // Both algorithms live in the same sidecar.
+  assert(StoreDumpIdentityCache(dir, key, "tree-sha256", kTree));
+  assert(LookupDumpIdentityCache(dir, key, "sha256") == kFlat);
+  assert(LookupDumpIdentityCache(dir, key, "tree-sha256") == kTree);
+
+  // Any change of generation is a miss.
+  auto rewritten = key;
+  rewritten.last_write_time_utc_100ns += 1;
+  assert(!LookupDumpIdentityCache(dir, rewritten, "sha256"));
+  auto grown = key;
+  grown.size_bytes += 1;
+  assert(!LookupDumpIdentityCache(dir, grown, "sha256"));
+  auto otherFile = key;
+  otherFile.file_index += 1;
+  assert(!LookupDumpIdentityCache(dir, otherFile, "sha256"));
+
+  // A new generation of the same file ID drops the stale digests.
+  assert(StoreDumpIdentityCache(dir, rewritten, "tree-sha256", kTree));
+  assert(LookupDumpIdentityCache(dir, rewritten, "tree-sha256") == kTree);
+  assert(!LookupDumpIdentityCache(dir, rewritten, "sha256"));
+  assert(!LookupDumpIdentityCache(dir, key, "tree-sha256"));
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+
+void TestRejectsBadInput()
+{
+  const auto dir = FreshDir();
+  const auto key = Key();
+
+  assert(!StoreDumpIdentityCache({}, key, "sha256", kFlat));
+  assert(!StoreDumpIdentityCache(dir, key, "sha256", "not-a-digest"));
+  assert(!StoreDumpIdentityCache(dir, key, "sha256", "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD"));
+  auto unset = key;
+  unset.last_write_time_utc_100ns = 0;
+  assert(!StoreDumpIdentityCache(dir, unset, "sha256", kFlat));
+  assert(!LookupDumpIdentityCache({}, key, "sha256"));
+
+  // Corrupt sidecars read as a miss and are replaced on the next store.
+  std::filesystem::create_directories(dir);
+  {
+    std::ofstream out(DumpIdentityCachePath(dir, key), std::ios::binary);
+    out << "{ not json";
+  }
+  assert(!LookupDumpIdentityCache(dir, key, "sha256"));
+  assert(StoreDumpIdentityCache(dir, key, "sha256", kFlat));
+  assert(LookupDumpIdentityCache(dir, key, "sha256") == kFlat);
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+
+}  // namespace
+
+int main()
+{
+  TestRoundTripAndMisses();
+  TestRejectsBadInput();
+  return 0;
+}
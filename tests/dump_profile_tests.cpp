@@ -3,11 +3,13 @@
 
 #include <cassert>
 #include <filesystem>
+#include <initializer_list>
 #include <string_view>
 
 using skydiag::helper::CaptureKind;
 using skydiag::helper::CaptureKindToString;
 using skydiag::helper::DumpMode;
+using skydiag::helper::DumpCompression;
 using skydiag::helper::DumpProfile;
 using skydiag::helper::ResolveDumpProfile;
 using skydiag::tests::source_guard::AssertContains;
@@ -20,6 +22,7 @@ void AssertCrashRicherFlagsDisabled(const DumpProfile& profile)
   assert(!profile.includeProcessThreadData);
   assert(!profile.includeFullMemoryInfo);
   assert(!profile.includeModuleHeaders);
+  assert(!profile.includeTargetedMemory);
 }
 
 void AssertCrashRecaptureExtraFlagsDisabled(const DumpProfile& profile)
@@ -76,6 +79,7 @@ int main()
   AssertContains(header, "bool includeModuleHeaders", "DumpProfile must model module-header inclusion.");
   AssertContains(header, "bool includeIndirectMemory", "DumpProfile must model indirectly referenced memory inclusion.");
   AssertContains(header, "bool ignoreInaccessibleMemory", "DumpProfile must model inaccessible-memory tolerance.");
+  AssertContains(header, "bool includeTargetedMemory", "DumpProfile must model targeted memory selection.");
   AssertContains(header, "CaptureKindToString", "DumpProfile must expose a capture-kind string helper.");
   AssertContains(header, "ResolveDumpProfile", "DumpProfile must expose profile resolution.");
 
@@ -111,6 +115,7 @@ int main()
   assert(crashDefault.includeModuleHeaders);
   assert(!crashDefault.includeIndirectMemory);
   assert(!crashDefault.ignoreInaccessibleMemory);
+  assert(crashDefault.includeTargetedMemory);
 
   const DumpProfile crashMini = ResolveDumpProfile(DumpMode::kMini, CaptureKind::Crash);
   assert(crashMini.captureKind == CaptureKind::Crash);
@@ -147,6 +152,7 @@ int main()
   assert(recaptureDefault.includeModuleHeaders);
   assert(recaptureDefault.includeIndirectMemory);
   assert(recaptureDefault.ignoreInaccessibleMemory);
+  assert(recaptureDefault.includeTargetedMemory);
 
   const DumpProfile recaptureMini = ResolveDumpProfile(DumpMode::kMini, CaptureKind::CrashRecapture);
   assert(recaptureMini.captureKind == CaptureKind::CrashRecapture);
@@ -226,5 +232,30 @@ int main()
   assert(!manualMini.preferCrashContext);
   AssertCrashRecaptureExtraFlagsDisabled(manualMini);
 
+  assert(std::string_view(CaptureKindToString(CaptureKind::CrashThin)) == "crash_thin");
+  for (const auto mode : { DumpMode::kMini, DumpMode::kDefault, DumpMode::kFull }) {
+    const DumpProfile thin = ResolveDumpProfile(mode, CaptureKind::CrashThin);
+    assert(thin.captureKind == CaptureKind::CrashThin);
+    assert(thin.baseMode == mode);
+    assert(!thin.includeThreadInfo);
+    assert(!thin.includeHandleData);
+    assert(!thin.includeUnloadedModules);
+    assert(!thin.includeCodeSegments);
+    assert(!thin.includeFullMemory);
+    assert(thin.preferCrashContext);
+    assert(thin.preferMainThread);
+    assert(!thin.preferWctThreads);
+    AssertCrashRecaptureExtraFlagsDisabled(thin);
+  }
+
+  // On-disk compression is a storage policy layered over the capture profile.
+  assert(!ResolveDumpProfile(DumpMode::kDefault, CaptureKind::Crash).compressOnDisk);
+  assert(!ResolveDumpProfile(DumpMode::kFull, CaptureKind::Crash, DumpCompression::kOff).compressOnDisk);
+  assert(ResolveDumpProfile(DumpMode::kFull, CaptureKind::Crash, DumpCompression::kLargeDumps).compressOnDisk);
+  assert(ResolveDumpProfile(DumpMode::kDefault, CaptureKind::CrashRecapture, DumpCompression::kLargeDumps).compressOnDisk);
+  assert(!ResolveDumpProfile(DumpMode::kDefault, CaptureKind::Hang, DumpCompression::kLargeDumps).compressOnDisk);
+  assert(ResolveDumpProfile(DumpMode::kDefault, CaptureKind::Hang, DumpCompression::kAll).compressOnDisk);
+  assert(!ResolveDumpProfile(DumpMode::kFull, CaptureKind::CrashThin, DumpCompression::kAll).compressOnDisk);
+
   return 0;
 }
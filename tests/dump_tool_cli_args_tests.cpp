@@ -61,6 +61,33 @@ static void Test_ParsesOnlineSymbolsFlags()
   }
 }
 
+static void Test_ParsesTreeIdentityFlag()
+{
+  {
+    DumpToolCliArgs a{};
+    std::wstring err;
+    const std::vector<std::wstring_view> argv = {
+      L"SkyrimDiagDumpToolCli.exe",
+      L"C:\\dumps\\a.dmp",
+    };
+    assert(ParseDumpToolCliArgs(argv, &a, &err));
+    assert(!a.tree_identity);
+  }
+
+  {
+    DumpToolCliArgs a{};
+    std::wstring err;
+    const std::vector<std::wstring_view> argv = {
+      L"SkyrimDiagDumpToolCli.exe",
+      L"--tree-identity",
+      L"C:\\dumps\\a.dmp",
+    };
+    assert(ParseDumpToolCliArgs(argv, &a, &err));
+    assert(a.tree_identity);
+    assert(a.dump_path == L"C:\\dumps\\a.dmp");
+  }
+}
+
 static void Test_RejectsMissingDumpPath()
 {
   DumpToolCliArgs a{};
@@ -114,6 +141,7 @@ int main()
 {
   Test_ParsesDumpPathAndOutDir();
   Test_ParsesOnlineSymbolsFlags();
+  Test_ParsesTreeIdentityFlag();
   Test_RejectsMissingDumpPath();
   Test_RejectsUnknownFlag();
   Test_CliMainPrintsMachineReadableOutputPaths();
@@ -3,6 +3,7 @@
 #include <filesystem>
 
 using skydiag::tests::source_guard::AssertContains;
+using skydiag::tests::source_guard::AssertOrdered;
 using skydiag::tests::source_guard::ReadAllText;
 
 int main()
@@ -63,11 +64,29 @@ int main()
   AssertContains(impl, "InferMainThreadIdFromSnapshot", "Dump writer must recover the main thread from the blackbox snapshot.");
   AssertContains(impl, "effectiveProfile.preferMainThread", "preferMainThread must affect the callback preferred thread set.");
   AssertContains(impl, "EventType::kSessionStart", "SessionStart must be the compatibility fallback when heartbeats are absent.");
+  AssertContains(impl, "ERROR_FILE_SYSTEM_LIMITATION", "Volumes that cannot compress must leave the dump uncompressed and say why.");
+  AssertContains(impl, "LogDumpCompressionFailure(dumpPath, compressErr)", "A failed FSCTL_SET_COMPRESSION must be logged, not ignored.");
+  AssertContains(impl, "GetCompressedFileSizeW", "Compressed dumps must log their on-disk size so the ratio can be measured.");
 
   AssertContains(crashCapture, "CaptureKind::Crash", "Crash capture must request the crash dump profile.");
   AssertContains(hangCapture, "CaptureKind::Hang", "Hang capture must request the hang dump profile.");
   AssertContains(manualCapture, "CaptureKind::Manual", "Manual capture must request the manual capture profile.");
   AssertContains(pendingAnalysis, "CaptureKind::CrashRecapture", "Crash recapture must request the recapture profile.");
 
+  // Every headless analysis runs as a queued job the retention sweep waits for.
+  AssertContains(hangCapture, "QueueDumpToolHeadlessIfConfigured(", "Hang analysis must go through the post-process queue.");
+  AssertContains(manualCapture, "QueueDumpToolHeadlessIfConfigured(", "Manual analysis must go through the post-process queue.");
+  AssertContains(pendingAnalysis, "QueueDumpToolHeadlessIfConfigured(", "Recapture analysis must go through the post-process queue.");
+  AssertOrdered(hangCapture, "QueueDumpToolHeadlessIfConfigured(", "ApplyRetentionFromConfig(cfg, outBase)", "Hang retention must be queued after its analysis.");
+  AssertOrdered(manualCapture, "QueueDumpToolHeadlessIfConfigured(", "ApplyRetentionFromConfig(cfg, outBase)", "Manual retention must be queued after its analysis.");
+  AssertOrdered(pendingAnalysis, "QueueDumpToolHeadlessIfConfigured(", "ApplyRetentionFromConfig(cfg, outBase)", "Recapture retention must be queued after its analysis.");
+  assert(
+    hangCapture.find("StartDumpToolHeadlessIfConfigured(") == std::string::npos &&
+    manualCapture.find("StartDumpToolHeadlessIfConfigured(") == std::string::npos &&
+    pendingAnalysis.find("StartDumpToolHeadlessIfConfigured(") == std::string::npos &&
+    "No headless analysis may start outside the post-process queue.");
+  AssertContains(pendingAnalysis, "TrackDumpReaderJob(outBase, task->postProcessJob)", "The crash analysis must hold off retention sweeps.");
+  AssertContains(crashCapture, "TrackDumpReaderJob(outBase, outcome.job)", "The crash enrichment write must hold off retention sweeps.");
+
   return 0;
 }
@@ -165,6 +165,41 @@ void TestConsensusModuleThreadGroupSupportsLogicalSynchronizationStall()
   assert(result.primary_reasons.size() == 3u);
 }
 
+void TestConsensusModuleOnNearlyEveryStackIsDowngraded()
+{
+  FreezeSignalInput input{};
+  input.is_hang_like = true;
+  input.thread_module_consensus = skydiag::dump_tool::HangThreadModuleConsensus{};
+  input.thread_module_consensus->has_consensus = true;
+  input.thread_module_consensus->main_thread_id = 45112u;
+  input.thread_module_consensus->module_filename = L"hookframework.dll";
+  input.thread_module_consensus->matching_thread_count = 16u;
+  input.thread_module_consensus->stable_thread_count = 16u;
+
+  // The same near-stack group, but the whole-stack scan sees the module on
+  // a minority of threads: the verdict is unchanged.
+  input.thread_module_consensus->whole_stack_thread_count = 18u;
+  input.thread_module_consensus->whole_stack_scanned_thread_count = 40u;
+  const auto selective = BuildFreezeCandidateConsensus(input, Language::kEnglish);
+  assert(selective.state_id == "synchronization_stall_likely");
+  assert(selective.confidence_level == ConfidenceLevel::kMedium);
+  assert(selective.primary_reasons.size() == 3u);
+
+  // On 38 of 40 stacks the module is everywhere and the group does not
+  // single it out.
+  input.thread_module_consensus->whole_stack_thread_count = 38u;
+  const auto ubiquitous = BuildFreezeCandidateConsensus(input, Language::kEnglish);
+  assert(ubiquitous.state_id == "synchronization_stall_likely");
+  assert(ubiquitous.confidence_level == ConfidenceLevel::kLow);
+  assert(ubiquitous.primary_reasons.size() == 4u);
+  assert(ubiquitous.primary_reasons.back().find(L"38 of 40") != std::wstring::npos);
+
+  // Too few readable stacks to judge.
+  input.thread_module_consensus->whole_stack_thread_count = 6u;
+  input.thread_module_consensus->whole_stack_scanned_thread_count = 6u;
+  assert(BuildFreezeCandidateConsensus(input, Language::kEnglish).confidence_level == ConfidenceLevel::kMedium);
+}
+
 void TestConsensusLoaderStallLikely()
 {
   FreezeSignalInput input{};
@@ -325,6 +360,32 @@ void TestConsensusFreezeCandidateAndAmbiguous()
   assert(ambiguousResult.related_candidates.empty());
 }
 
+void TestConsensusWaitGraphCycleWithoutWctFlag()
+{
+  skydiag::dump_tool::WaitGraphAnalysis graph{};
+  graph.has_graph = true;
+  graph.thread_nodes = 2;
+  graph.lock_nodes = 2;
+  skydiag::dump_tool::WaitGraphCycle cycle{};
+  cycle.thread_ids = { 100u, 200u };
+  cycle.modules = { L"LockyMod.dll" };
+  graph.cycles.push_back(cycle);
+  graph.longest_chain_thread_ids = { 100u, 200u };
+  graph.longest_chain_has_cycle = true;
+
+  FreezeSignalInput input{};
+  input.is_hang_like = true;
+  input.wait_graph = graph;
+
+  const auto result = BuildFreezeCandidateConsensus(input, Language::kEnglish);
+  assert(result.has_analysis);
+  assert(result.state_id == "deadlock_likely");
+  assert(result.wait_graph.has_graph);
+  assert(result.wait_graph.cycles.size() == 1);
+  assert(!result.related_candidates.empty());
+  assert(result.related_candidates[0].display_name == L"LockyMod.dll");
+}
+
 }  // namespace
 
 int main()
@@ -335,11 +396,13 @@ int main()
   TestConsensusDeadlockSinglePassLiveStaysConservative();
   TestConsensusDeadlockSnapshotConsensusBacked();
   TestConsensusModuleThreadGroupSupportsLogicalSynchronizationStall();
+  TestConsensusModuleOnNearlyEveryStackIsDowngraded();
   TestConsensusLoaderStallLikely();
   TestConsensusLoaderStallWithBlackboxChurn();
   TestConsensusLoaderStallWithFirstChanceContext();
   TestConsensusLoaderStallNeedsContextForConsistentLoadingSignal();
   TestConsensusSnapshotFallbackAndSnapshotBackedStayStateConservative();
   TestConsensusFreezeCandidateAndAmbiguous();
+  TestConsensusWaitGraphCycleWithoutWctFlag();
   return 0;
 }
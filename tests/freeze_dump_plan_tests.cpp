@@ -0,0 +1,82 @@
+#include <cassert>
+#include <cstring>
+
+#include "SkyrimDiagHelper/FreezeDumpPlan.h"
+
+using skydiag::helper::FreezeCaptureTiming;
+using skydiag::helper::FreezeDumpTransport;
+using skydiag::helper::FreezeSnapshotOutcome;
+using skydiag::helper::PlanFreezeDump;
+
+namespace {
+
+void TestCapturedSnapshotIsTriedFirstWithLiveRetry()
+{
+  const auto plan = PlanFreezeDump(FreezeSnapshotOutcome::kCaptured, /*allowLiveRetry=*/true);
+  assert(plan.attemptCount == 2);
+  assert(plan.attempts[0] == FreezeDumpTransport::kPssSnapshot);
+  assert(plan.attempts[1] == FreezeDumpTransport::kLiveProcess);
+  assert(std::strlen(plan.fallbackReason) == 0);
+
+  const auto noRetry = PlanFreezeDump(FreezeSnapshotOutcome::kCaptured, /*allowLiveRetry=*/false);
+  assert(noRetry.attemptCount == 1);
+  assert(noRetry.attempts[0] == FreezeDumpTransport::kPssSnapshot);
+}
+
+void TestSnapshotFailuresFallBackToLiveWithReason()
+{
+  struct Case
+  {
+    FreezeSnapshotOutcome outcome;
+    const char* reason;
+  };
+  const Case cases[] = {
+    { FreezeSnapshotOutcome::kDisabled, "pss_disabled" },
+    { FreezeSnapshotOutcome::kApiUnavailable, "pss_api_unavailable" },
+    { FreezeSnapshotOutcome::kCaptureFailed, "pss_capture_failed" },
+  };
+  for (const auto& c : cases) {
+    const auto plan = PlanFreezeDump(c.outcome, /*allowLiveRetry=*/true);
+    assert(plan.attemptCount == 1);
+    assert(plan.attempts[0] == FreezeDumpTransport::kLiveProcess);
+    assert(std::strcmp(plan.fallbackReason, c.reason) == 0);
+  }
+}
+
+void TestFreezeExtensionCountsOnlyTimeTheGameWasHeld()
+{
+  FreezeCaptureTiming snapshotOnly{};
+  snapshotOnly.snapshotCaptureMs = 40;
+  snapshotOnly.snapshotDumpWriteMs = 2'000;
+  snapshotOnly.snapshotDumpWritten = true;
+  assert(skydiag::helper::FreezeExtensionMs(snapshotOnly) == 40);
+  assert(skydiag::helper::FreezeExtensionAvoidedMs(snapshotOnly) == 1'960);
+
+  FreezeCaptureTiming retried = snapshotOnly;
+  retried.snapshotDumpWritten = false;
+  retried.liveDumpWriteMs = 1'500;
+  assert(skydiag::helper::FreezeExtensionMs(retried) == 1'540);
+  assert(skydiag::helper::FreezeExtensionAvoidedMs(retried) == 0);
+
+  FreezeCaptureTiming liveOnly{};
+  liveOnly.liveDumpWriteMs = 900;
+  assert(skydiag::helper::FreezeExtensionMs(liveOnly) == 900);
+  assert(skydiag::helper::FreezeExtensionAvoidedMs(liveOnly) == 0);
+}
+
+void TestTransportNames()
+{
+  assert(std::strcmp(skydiag::helper::FreezeDumpTransportToString(FreezeDumpTransport::kPssSnapshot), "pss_snapshot") == 0);
+  assert(std::strcmp(skydiag::helper::FreezeDumpTransportToString(FreezeDumpTransport::kLiveProcess), "live_process") == 0);
+}
+
+}  // namespace
+
+int main()
+{
+  TestCapturedSnapshotIsTriedFirstWithLiveRetry();
+  TestSnapshotFailuresFallBackToLiveWithReason();
+  TestFreezeExtensionCountsOnlyTimeTheGameWasHeld();
+  TestTransportNames();
+  return 0;
+}
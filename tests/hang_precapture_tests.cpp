@@ -0,0 +1,160 @@
+#include "HangPrecaptureTypes.h"
+#include "SkyrimDiagHelper/HangPrecapture.h"
+#include "SourceGuardTestUtils.h"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+
+using skydiag::dump_tool::internal::CountTrailingStableMainThreadRip;
+using skydiag::dump_tool::internal::FindMainThreadSample;
+using skydiag::dump_tool::internal::TryParseHangPrecapture;
+using skydiag::helper::HangDecision;
+using skydiag::helper::HangPrecaptureRing;
+using skydiag::helper::HangPrecaptureSnapshot;
+using skydiag::helper::HangPrecaptureThreadSample;
+using skydiag::helper::IsInHangPrecaptureWindow;
+using skydiag::helper::SerializeHangPrecaptureRing;
+using skydiag::helper::ShouldTakeHangPrecaptureSample;
+using skydiag::tests::source_guard::AssertContains;
+using skydiag::tests::source_guard::ReadProjectText;
+
+namespace {
+
+HangDecision MakeDecision(double secondsSinceHeartbeat, std::uint32_t thresholdSec)
+{
+  HangDecision d{};
+  d.secondsSinceHeartbeat = secondsSinceHeartbeat;
+  d.thresholdSec = thresholdSec;
+  d.isHang = secondsSinceHeartbeat >= static_cast<double>(thresholdSec);
+  return d;
+}
+
+HangPrecaptureSnapshot MakeSnapshot(std::uint64_t qpc, std::uint32_t mainTid, std::uint64_t mainRip)
+{
+  HangPrecaptureSnapshot s{};
+  s.qpc = qpc;
+  s.secondsSinceHeartbeat = static_cast<double>(qpc) / 1000.0;
+  s.thresholdSec = 10;
+  s.mainThreadId = mainTid;
+  HangPrecaptureThreadSample main{};
+  main.tid = mainTid;
+  main.rip = mainRip;
+  main.rsp = 0x1000;
+  main.stackWordCount = 2;
+  main.stackWords[0] = 0x7FF600001000ull;
+  main.stackWords[1] = 0x7FF600002000ull;
+  s.threads.push_back(main);
+  HangPrecaptureThreadSample worker{};
+  worker.tid = mainTid + 1u;
+  worker.rip = 0x7FFB00000000ull;
+  s.threads.push_back(worker);
+  return s;
+}
+
+void TestWindowPolicy()
+{
+  // threshold 10s, start at 50% -> sample between 5s and 10s.
+  assert(!IsInHangPrecaptureWindow(MakeDecision(4.9, 10), 50));
+  assert(IsInHangPrecaptureWindow(MakeDecision(5.0, 10), 50));
+  assert(IsInHangPrecaptureWindow(MakeDecision(9.9, 10), 50));
+  assert(!IsInHangPrecaptureWindow(MakeDecision(10.0, 10), 50));
+  assert(!IsInHangPrecaptureWindow(MakeDecision(9.0, 0), 50));
+  assert(!IsInHangPrecaptureWindow(MakeDecision(9.0, 10), 0));
+
+  const auto d = MakeDecision(6.0, 10);
+  // freq=1000 qpc/s, interval=500ms -> 500 qpc between samples.
+  assert(ShouldTakeHangPrecaptureSample(d, 50, 10000, 0, 1000, 500));
+  assert(!ShouldTakeHangPrecaptureSample(d, 50, 10400, 10000, 1000, 500));
+  assert(ShouldTakeHangPrecaptureSample(d, 50, 10500, 10000, 1000, 500));
+  assert(!ShouldTakeHangPrecaptureSample(d, 50, 10500, 10000, 0, 500));
+}
+
+void TestRingKeepsNewestOldestFirst()
+{
+  HangPrecaptureRing ring(3);
+  assert(ring.Empty());
+  assert(SerializeHangPrecaptureRing(ring, 1000).empty());
+
+  for (std::uint64_t i = 1; i <= 5; ++i) {
+    ring.Push(MakeSnapshot(i * 1000u, 42u, 0x7FF600000000ull + i));
+  }
+  assert(ring.Size() == 3);
+  assert(ring.DroppedCount() == 2);
+  assert(ring.LastSampleQpc() == 5000u);
+  assert(ring.At(0).qpc == 3000u);
+  assert(ring.At(2).qpc == 5000u);
+
+  ring.Clear();
+  assert(ring.Empty());
+  assert(ring.DroppedCount() == 0);
+  assert(ring.LastSampleQpc() == 0);
+}
+
+void TestSerializeParseRoundTrip()
+{
+  HangPrecaptureRing ring(4);
+  ring.Push(MakeSnapshot(1000u, 42u, 0x7FF600000100ull));
+  ring.Push(MakeSnapshot(2000u, 42u, 0x7FF600000200ull));
+  ring.Push(MakeSnapshot(3000u, 42u, 0x7FF600000200ull));
+  ring.Push(MakeSnapshot(4000u, 42u, 0x7FF600000200ull));
+
+  const auto json = SerializeHangPrecaptureRing(ring, /*qpcFreq=*/1000);
+  const auto parsed = TryParseHangPrecapture(json);
+  assert(parsed.has_value());
+  assert(parsed->version == skydiag::helper::kHangPrecaptureFormatVersion);
+  assert(parsed->capacity == 4);
+  assert(parsed->dropped == 0);
+  assert(parsed->snapshots.size() == 4);
+  assert(parsed->snapshots[0].offset_ms == 0);
+  assert(parsed->snapshots[3].offset_ms == 3000);
+  assert(parsed->snapshots[3].threshold_sec == 10);
+
+  const auto* main = FindMainThreadSample(parsed->snapshots[1]);
+  assert(main != nullptr);
+  assert(main->tid == 42u);
+  assert(main->rip == 0x7FF600000200ull);
+  assert(main->stack.size() == 2);
+  assert(main->stack[1] == 0x7FF600002000ull);
+  assert(parsed->snapshots[1].threads.size() == 2);
+
+  assert(CountTrailingStableMainThreadRip(*parsed) == 3);
+}
+
+void TestParseRejectsInvalidInput()
+{
+  assert(!TryParseHangPrecapture("").has_value());
+  assert(!TryParseHangPrecapture("{bad json").has_value());
+  assert(!TryParseHangPrecapture(R"({"snapshots":[]})").has_value());
+  assert(!TryParseHangPrecapture(R"({"snapshots":{}})").has_value());
+
+  const auto noMain = TryParseHangPrecapture(R"({"snapshots":[{"main_tid":0,"threads":[{"tid":5,"rip":1}]}]})");
+  assert(noMain.has_value());
+  assert(FindMainThreadSample(noMain->snapshots[0]) == nullptr);
+  assert(CountTrailingStableMainThreadRip(*noMain) == 0);
+}
+
+void TestSourceContracts()
+{
+  const auto dumpWriter = ReadProjectText("helper/src/DumpWriter.cpp");
+  const auto hangTick = ReadProjectText("helper/src/HangCapture.cpp");
+  const auto hangExecute = ReadProjectText("helper/src/HangCapture.Execute.cpp");
+  const auto analyzer = ReadProjectText("dump_tool/src/Analyzer.cpp");
+
+  AssertContains(dumpWriter, "kMinidumpUserStream_HangPrecapture", "DumpWriter must embed the hang pre-capture stream.");
+  AssertContains(hangTick, "MaybeSampleHangPrecapture(", "Hang tick must feed the pre-capture ring before the threshold fires.");
+  AssertContains(hangExecute, "TakeHangPrecaptureJson(", "Confirmed hang capture must drain the pre-capture ring into the dump.");
+  AssertContains(analyzer, "ParseHangPrecaptureStream(", "Analyzer must read the hang pre-capture stream.");
+}
+
+}  // namespace
+
+int main()
+{
+  TestWindowPolicy();
+  TestRingKeepsNewestOldestFirst();
+  TestSerializeParseRoundTrip();
+  TestParseRejectsInvalidInput();
+  TestSourceContracts();
+  return 0;
+}
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "SkyrimDiagHelper/HangSuppression.h"
+#include "SkyrimDiagHelper/HangSuppressionTrace.h"
+
+// Replays recorded helper hang-suppression traces through the production rule
+// table and reports what would have been suppressed or captured. Labeled
+// fixtures double as a gate: a "pause" episode that captures is a false
+// positive hang dump on a real player's machine.
+
+namespace {
+
+using skydiag::helper::HangSuppressionReasonName;
+using skydiag::helper::HangSuppressionRuleName;
+using skydiag::helper::HangSuppressionState;
+using skydiag::helper::HangSuppressionTraceRecord;
+
+struct Episode {
+  bool open = false;
+  std::uint64_t startQpc = 0;
+  std::uint64_t qpcFreq = 0;
+  std::string label;
+  bool captured = false;
+};
+
+struct ReplayStats {
+  std::uint64_t traces = 0;
+  std::uint64_t samples = 0;
+  std::uint64_t episodes = 0;
+  std::uint64_t captures = 0;
+  std::uint64_t labeledPause = 0;
+  std::uint64_t labeledFreeze = 0;
+  std::uint64_t falsePositiveCaptures = 0;
+  std::uint64_t missedFreezes = 0;
+  std::uint64_t mismatches = 0;
+  std::uint64_t captureDelayMaxMs = 0;
+  std::uint64_t captureDelaySumMs = 0;
+  std::map<std::string, std::uint64_t> suppressedByReason;
+  std::map<std::string, std::uint64_t> ruleHits;
+  std::vector<std::string> problems;
+};
+
+void CloseEpisode(const std::string& traceName, Episode& episode, ReplayStats& stats)
+{
+  if (!episode.open) {
+    return;
+  }
+  ++stats.episodes;
+  if (episode.captured) {
+    ++stats.captures;
+  }
+  if (episode.label == "pause") {
+    ++stats.labeledPause;
+    if (episode.captured) {
+      ++stats.falsePositiveCaptures;
+      stats.problems.push_back(traceName + ": pause episode produced a hang capture");
+    }
+  } else if (episode.label == "freeze") {
+    ++stats.labeledFreeze;
+    if (!episode.captured) {
+      ++stats.missedFreezes;
+      stats.problems.push_back(traceName + ": freeze episode was never captured");
+    }
+  }
+  episode = {};
+}
+
+void ReplayTrace(const std::filesystem::path& path, ReplayStats& stats)
+{
+  std::ifstream f(path, std::ios::binary);
+  if (!f) {
+    throw std::runtime_error("cannot open trace: " + path.string());
+  }
+
+  const auto traceName = path.filename().string();
+  ++stats.traces;
+
+  HangSuppressionState state{};
+  Episode episode{};
+  std::string line;
+  std::uint64_t lineNo = 0;
+  while (std::getline(f, line)) {
+    ++lineNo;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.find_first_not_of(" \t") == std::string::npos) {
+      continue;
+    }
+
+    HangSuppressionTraceRecord rec{};
+    if (!skydiag::helper::TryParseHangSuppressionTraceRecord(line, rec)) {
+      throw std::runtime_error(traceName + ":" + std::to_string(lineNo) + ": malformed trace record");
+    }
+    ++stats.samples;
+
+    std::uint8_t ruleIndex = 0xFF;
+    const auto result = skydiag::helper::ApplyHangSuppressionTable(
+      skydiag::helper::kDefaultHangSuppressionTable, state, rec.inputs, &ruleIndex);
+    const std::string ruleName = HangSuppressionRuleName(ruleIndex);
+    ++stats.ruleHits[ruleName];
+    if (result.suppress) {
+      ++stats.suppressedByReason[HangSuppressionReasonName(result.reason)];
+    }
+
+    if (rec.recorded) {
+      const bool differs = rec.recorded->suppress != result.suppress ||
+        rec.recorded->reason != result.reason ||
+        (!rec.recordedRule.empty() && rec.recordedRule != ruleName);
+      if (differs) {
+        ++stats.mismatches;
+        stats.problems.push_back(
+          traceName + ":" + std::to_string(lineNo) + ": recorded " +
+          HangSuppressionReasonName(rec.recorded->reason) + "/" + rec.recordedRule + ", replayed " +
+          HangSuppressionReasonName(result.reason) + "/" + ruleName);
+      }
+    }
+
+    if (!rec.inputs.isHang) {
+      CloseEpisode(traceName, episode, stats);
+      continue;
+    }
+    if (!episode.open) {
+      episode.open = true;
+      episode.startQpc = rec.inputs.nowQpc;
+      episode.qpcFreq = rec.inputs.qpcFreq;
+    }
+    if (!rec.label.empty()) {
+      episode.label = rec.label;
+    }
+    // The helper stops evaluating once it captured; later lines in the same
+    // episode (if any) cannot produce a second dump.
+    if (!episode.captured && !result.suppress && rec.confirmedPhase) {
+      episode.captured = true;
+      const std::uint64_t delayQpc = rec.inputs.nowQpc >= episode.startQpc ? rec.inputs.nowQpc - episode.startQpc : 0;
+      const std::uint64_t delayMs = episode.qpcFreq != 0 ? (delayQpc * 1000u) / episode.qpcFreq : 0;
+      stats.captureDelayMaxMs = std::max(stats.captureDelayMaxMs, delayMs);
+      stats.captureDelaySumMs += delayMs;
+    }
+  }
+  CloseEpisode(traceName, episode, stats);
+}
+
+nlohmann::json ToJson(const ReplayStats& stats)
+{
+  nlohmann::json j = nlohmann::json::object();
+  j["traces"] = stats.traces;
+  j["samples"] = stats.samples;
+  j["episodes"] = stats.episodes;
+  j["captures"] = stats.captures;
+  j["labeled_pause_episodes"] = stats.labeledPause;
+  j["labeled_freeze_episodes"] = stats.labeledFreeze;
+  j["false_positive_captures"] = stats.falsePositiveCaptures;
+  j["missed_freezes"] = stats.missedFreezes;
+  j["mismatches"] = stats.mismatches;
+  j["capture_delay_ms"] = {
+    { "max", stats.captureDelayMaxMs },
+    { "mean", stats.captures != 0 ? stats.captureDelaySumMs / stats.captures : 0 },
+  };
+  j["suppressed_by_reason"] = stats.suppressedByReason;
+  j["rule_hits"] = stats.ruleHits;
+  j["problems"] = stats.problems;
+  return j;
+}
+
+std::uint64_t ParseLimit(std::string_view flag, const char* value)
+{
+  try {
+    return std::stoull(value);
+  } catch (const std::exception&) {
+    throw std::runtime_error("invalid value for " + std::string(flag) + ": " + value);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try {
+    std::vector<std::filesystem::path> inputs;
+    std::uint64_t maxFalsePositives = UINT64_MAX;
+    std::uint64_t maxMissedFreezes = UINT64_MAX;
+    std::uint64_t maxMismatches = UINT64_MAX;
+    std::uint64_t maxCaptureDelayMs = UINT64_MAX;
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg(argv[i]);
+      const bool hasValue = i + 1 < argc;
+      if (arg == "--max-false-positives" && hasValue) {
+        maxFalsePositives = ParseLimit(arg, argv[++i]);
+      } else if (arg == "--max-missed-freezes" && hasValue) {
+        maxMissedFreezes = ParseLimit(arg, argv[++i]);
+      } else if (arg == "--max-mismatches" && hasValue) {
+        maxMismatches = ParseLimit(arg, argv[++i]);
+      } else if (arg == "--max-capture-delay-ms" && hasValue) {
+        maxCaptureDelayMs = ParseLimit(arg, argv[++i]);
+      } else if (arg.starts_with("--")) {
+        throw std::runtime_error("unknown option: " + std::string(arg));
+      } else {
+        inputs.emplace_back(argv[i]);
+      }
+    }
+    if (inputs.empty()) {
+      std::cerr << "usage: skydiag_hang_suppression_replay <trace.jsonl|dir>... "
+                   "[--max-false-positives N] [--max-missed-freezes N] "
+                   "[--max-mismatches N] [--max-capture-delay-ms N]\n";
+      return 2;
+    }
+
+    std::vector<std::filesystem::path> traces;
+    for (const auto& input : inputs) {
+      if (std::filesystem::is_directory(input)) {
+        for (const auto& entry : std::filesystem::directory_iterator(input)) {
+          if (entry.is_regular_file() && entry.path().extension() == ".jsonl") {
+            traces.push_back(entry.path());
+          }
+        }
+      } else if (std::filesystem::is_regular_file(input)) {
+        traces.push_back(input);
+      } else {
+        throw std::runtime_error("trace not found: " + input.string());
+      }
+    }
+    std::sort(traces.begin(), traces.end());
+    if (traces.empty()) {
+      throw std::runtime_error("no *.jsonl traces found");
+    }
+
+    ReplayStats stats{};
+    for (const auto& trace : traces) {
+      ReplayTrace(trace, stats);
+    }
+    std::cout << ToJson(stats).dump(2) << '\n';
+
+    const bool failed = stats.falsePositiveCaptures > maxFalsePositives ||
+      stats.missedFreezes > maxMissedFreezes ||
+      stats.mismatches > maxMismatches ||
+      stats.captureDelayMaxMs > maxCaptureDelayMs;
+    if (failed) {
+      std::cerr << "hang suppression replay exceeded a configured limit\n";
+      return 1;
+    }
+    return 0;
+  } catch (const std::exception& error) {
+    std::cerr << "hang suppression replay failed: " << error.what() << '\n';
+    return 1;
+  }
+}
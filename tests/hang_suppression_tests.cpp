@@ -1,7 +1,9 @@
 #include "SkyrimDiagHelper/HangSuppression.h"
+#include "SkyrimDiagHelper/HangSuppressionTrace.h"
 
 #include <cassert>
 #include <cstdint>
+#include <string>
 
 using skydiag::helper::EvaluateHangSuppression;
 using skydiag::helper::HangSuppressionReason;
@@ -308,6 +310,173 @@ static void Test_Resets_WhenNoHang()
   assert(s.foregroundResumeQpc == 0);
 }
 
+// Hand-written branches the rule table replaced; kept as the reference the
+// table must agree with.
+static skydiag::helper::HangSuppressionResult ReferenceEvaluate(
+  HangSuppressionState& state,
+  bool isHang,
+  bool isForeground,
+  bool isLoading,
+  bool isWindowResponsive,
+  bool suppressHangWhenNotForeground,
+  std::uint64_t nowQpc,
+  std::uint64_t heartbeatQpc,
+  std::uint64_t qpcFreq,
+  std::uint32_t foregroundGraceSec)
+{
+  if (!isHang) {
+    state = {};
+    return {};
+  }
+  if (suppressHangWhenNotForeground && !isForeground) {
+    if (!isWindowResponsive) {
+      return {};
+    }
+    state.suppressedHeartbeatQpc = heartbeatQpc;
+    state.foregroundResumeQpc = 0;
+    return { true, HangSuppressionReason::kNotForeground };
+  }
+  if (state.suppressedHeartbeatQpc == 0) {
+    return {};
+  }
+  if (heartbeatQpc > state.suppressedHeartbeatQpc) {
+    state = {};
+    return {};
+  }
+  if (!isForeground) {
+    return {};
+  }
+  if (foregroundGraceSec == 0 || qpcFreq == 0) {
+    return {};
+  }
+  if (state.foregroundResumeQpc == 0) {
+    state.foregroundResumeQpc = nowQpc;
+  }
+  const std::uint64_t deltaQpc = (nowQpc > state.foregroundResumeQpc) ? (nowQpc - state.foregroundResumeQpc) : 0;
+  const double secondsSinceForeground = static_cast<double>(deltaQpc) / static_cast<double>(qpcFreq);
+  if (secondsSinceForeground < static_cast<double>(foregroundGraceSec)) {
+    return { true, HangSuppressionReason::kForegroundGrace };
+  }
+  if (!isLoading && isWindowResponsive) {
+    return { true, HangSuppressionReason::kForegroundResponsive };
+  }
+  return {};
+}
+
+static void Test_RuleTable_MatchesReferenceExhaustively()
+{
+  const HangSuppressionState states[] = {
+    {},
+    { 200, 0 },
+    { 200, 900 },
+    { 200, 1000 },
+    { 200, 400 },
+  };
+  const std::uint64_t heartbeats[] = { 150, 200, 250 };
+  const std::uint64_t freqs[] = { 0, 100 };
+  const std::uint32_t graces[] = { 0, 5 };
+
+  for (const auto& initial : states) {
+    for (std::uint32_t bits = 0; bits < 32u; ++bits) {
+      for (const auto hb : heartbeats) {
+        for (const auto freq : freqs) {
+          for (const auto grace : graces) {
+            const bool isHang = (bits & 1u) != 0;
+            const bool isForeground = (bits & 2u) != 0;
+            const bool isLoading = (bits & 4u) != 0;
+            const bool isResponsive = (bits & 8u) != 0;
+            const bool suppressCfg = (bits & 16u) != 0;
+
+            HangSuppressionState a = initial;
+            HangSuppressionState b = initial;
+            const auto ra = EvaluateHangSuppression(
+              a, isHang, isForeground, isLoading, isResponsive, suppressCfg, 1000, hb, freq, grace);
+            const auto rb = ReferenceEvaluate(
+              b, isHang, isForeground, isLoading, isResponsive, suppressCfg, 1000, hb, freq, grace);
+            assert(ra.suppress == rb.suppress);
+            assert(ra.reason == rb.reason);
+            assert(a.suppressedHeartbeatQpc == b.suppressedHeartbeatQpc);
+            assert(a.foregroundResumeQpc == b.foregroundResumeQpc);
+          }
+        }
+      }
+    }
+  }
+}
+
+static void Test_RuleTable_EveryEntryResolvedAndInMenuIsInert()
+{
+  using namespace skydiag::helper;
+  for (std::size_t facts = 0; facts < kHangSuppressionTableSize; ++facts) {
+    const auto& entry = kDefaultHangSuppressionTable[facts];
+    assert(entry.ruleIndex < kDefaultHangSuppressionRules.size());
+    // No default rule looks at the menu flag; it is recorded for traces and
+    // future tuning only.
+    const auto& twin = kDefaultHangSuppressionTable[facts ^ kFact_InMenu];
+    assert(entry.ruleIndex == twin.ruleIndex);
+  }
+  static_assert(kDefaultHangSuppressionTable[0].ruleIndex == 0);
+  static_assert(kDefaultHangSuppressionRules.back().mask == 0u);
+}
+
+static void Test_RuleTable_ReportsMatchedRule()
+{
+  using namespace skydiag::helper;
+  HangSuppressionState s{};
+  HangSuppressionInputs in{};
+  in.isHang = true;
+  in.isForeground = false;
+  in.isWindowResponsive = true;
+  in.nowQpc = 1000;
+  in.heartbeatQpc = 200;
+  in.qpcFreq = 100;
+  in.foregroundGraceSec = 5;
+
+  std::uint8_t rule = 0xFF;
+  const auto r = ApplyHangSuppressionTable(kDefaultHangSuppressionTable, s, in, &rule);
+  assert(r.suppress);
+  assert(std::string(HangSuppressionRuleName(rule)) == "background_responsive_suppresses");
+}
+
+static void Test_TraceRecord_RoundTrips()
+{
+  using namespace skydiag::helper;
+  HangSuppressionTraceRecord rec{};
+  rec.inputs.isHang = true;
+  rec.inputs.isForeground = true;
+  rec.inputs.isInMenu = true;
+  rec.inputs.suppressHangWhenNotForeground = false;
+  rec.inputs.nowQpc = 123456789012ull;
+  rec.inputs.heartbeatQpc = 123000000000ull;
+  rec.inputs.qpcFreq = 10000000;
+  rec.inputs.foregroundGraceSec = 7;
+  rec.confirmedPhase = true;
+  rec.secondsSinceHeartbeat = 45.5;
+  rec.thresholdSec = 30;
+  rec.stateFlags = 4;
+  rec.recorded = HangSuppressionResult{ true, HangSuppressionReason::kForegroundGrace };
+  rec.recordedRule = "foreground_grace_suppresses";
+
+  HangSuppressionTraceRecord back{};
+  assert(TryParseHangSuppressionTraceRecord(SerializeHangSuppressionTraceRecord(rec), back));
+  assert(back.inputs.isHang && back.inputs.isForeground && back.inputs.isInMenu);
+  assert(!back.inputs.suppressHangWhenNotForeground);
+  assert(back.inputs.nowQpc == rec.inputs.nowQpc);
+  assert(back.inputs.heartbeatQpc == rec.inputs.heartbeatQpc);
+  assert(back.inputs.qpcFreq == rec.inputs.qpcFreq);
+  assert(back.inputs.foregroundGraceSec == 7);
+  assert(back.confirmedPhase);
+  assert(back.thresholdSec == 30);
+  assert(back.stateFlags == 4);
+  assert(back.recorded && back.recorded->suppress);
+  assert(back.recorded->reason == HangSuppressionReason::kForegroundGrace);
+  assert(back.recordedRule == "foreground_grace_suppresses");
+
+  HangSuppressionTraceRecord bad{};
+  assert(!TryParseHangSuppressionTraceRecord("not json", bad));
+  assert(!TryParseHangSuppressionTraceRecord(R"({"is_hang":true,"suppress":true,"reason":"bogus"})", bad));
+}
+
 int main()
 {
   Test_Suppresses_WhenNotForeground_AndResponsive();
@@ -318,5 +487,9 @@ int main()
   Test_NoGraceConfigured_DoesNotSuppressInForeground();
   Test_ZeroQpcFreq_DoesNotGetStuckSuppressed();
   Test_Resets_WhenNoHang();
+  Test_RuleTable_MatchesReferenceExhaustively();
+  Test_RuleTable_EveryEntryResolvedAndInMenuIsInert();
+  Test_RuleTable_ReportsMatchedRule();
+  Test_TraceRecord_RoundTrips();
   return 0;
 }
@@ -13,7 +13,7 @@
 #include "HelperRuntimeTestUtils.h"
 #include "EtwCapture.h"
 #include "IncidentManifest.h"
-#include "RetentionWorker.h"
+#include "PostProcessWorker.h"
 
 using skydiag::helper::HelperConfig;
 using skydiag::helper::internal::ClearLog;
@@ -26,7 +26,7 @@ using skydiag::helper::internal::HandleProcessExitTick;
 using skydiag::helper::internal::LaunchDeferredViewersAfterExit;
 using skydiag::helper::internal::MaybeStopPendingCrashEtwCapture;
 using skydiag::helper::internal::PendingCrashEtwCapture;
-using skydiag::helper::internal::ShutdownRetentionWorker;
+using skydiag::helper::internal::ShutdownPostProcessWorker;
 using skydiag::helper::internal::StopEtwCaptureToPath;
 using skydiag::helper::internal::CrashSummaryInfo;
 using skydiag::helper::internal::TryWriteCleanExitEvidenceRecord;
@@ -741,7 +741,7 @@ void TestEtwStopFailureRetriesThenConfirmsCancellation()
     log,
     "WPR cancellation was confirmed",
     "Crash ETW cleanup must log confirmed cancellation instead of forgetting the session");
-  ShutdownRetentionWorker();
+  ShutdownPostProcessWorker();
   std::filesystem::remove_all(outBase);
 }
 
@@ -10,7 +10,7 @@
 #include "HangCaptureInternal.h"
 #include "HelperLog.h"
 #include "HelperRuntimeTestUtils.h"
-#include "RetentionWorker.h"
+#include "PostProcessWorker.h"
 #include "SkyrimDiagHelper/LoadStats.h"
 
 using skydiag::helper::HangDecision;
@@ -20,7 +20,7 @@ using skydiag::helper::internal::ExecuteConfirmedHangCapture;
 using skydiag::helper::internal::HandleHangTick;
 using skydiag::helper::internal::HangCaptureState;
 using skydiag::helper::internal::HangTickResult;
-using skydiag::helper::internal::ShutdownRetentionWorker;
+using skydiag::helper::internal::ShutdownPostProcessWorker;
 using skydiag::tests::runtime::AssertContains;
 using skydiag::tests::runtime::CloseAttachedProcess;
 using skydiag::tests::runtime::FindSingleFileByPrefix;
@@ -250,7 +250,7 @@ void TestExecuteConfirmedHangCapture_WritesArtifacts()
   AssertContains(log, "Hang dump written", "Confirmed hang capture must log dump creation");
   AssertContains(log, "Incident manifest written", "Confirmed hang capture must log manifest creation");
 
-  ShutdownRetentionWorker();
+  ShutdownPostProcessWorker();
   CloseAttachedProcess(&proc);
   std::filesystem::remove_all(outBase);
 }
@@ -0,0 +1,120 @@
+#include "SkyrimDiagHelper/HelperPerf.h"
+
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using skydiag::helper::HelperPerfRecorder;
+using skydiag::helper::PerfCounter;
+using skydiag::helper::PerfHistogram;
+using skydiag::helper::PerfStage;
+
+static void Test_BucketIndex_UsesInclusiveUpperBounds()
+{
+  using skydiag::helper::PerfBucketIndex;
+  assert(PerfBucketIndex(0) == 0);
+  assert(PerfBucketIndex(100) == 0);
+  assert(PerfBucketIndex(101) == 1);
+  assert(PerfBucketIndex(1'000) == 3);
+  assert(PerfBucketIndex(10'000'000) == skydiag::helper::kPerfBucketUpperUs.size() - 1);
+  assert(PerfBucketIndex(10'000'001) == skydiag::helper::kPerfBucketCount - 1);
+}
+
+static void Test_Histogram_TracksCountTotalMaxAndQuantiles()
+{
+  PerfHistogram h;
+  assert(h.QuantileUpperUs(0.95) == 0);
+
+  for (int i = 0; i < 19; ++i) {
+    h.Record(80);
+  }
+  h.Record(40'000);
+
+  assert(h.Count() == 20);
+  assert(h.TotalUs() == 19u * 80u + 40'000u);
+  assert(h.MaxUs() == 40'000);
+  assert(h.Bucket(0) == 19);
+  // Quantiles report the upper bound of the bucket that holds the rank.
+  assert(h.QuantileUpperUs(0.50) == 100);
+  assert(h.QuantileUpperUs(0.95) == 100);
+  assert(h.QuantileUpperUs(1.0) == 40'000);
+}
+
+static void Test_Histogram_OverflowReportsMax()
+{
+  PerfHistogram h;
+  h.Record(30'000'000);
+  assert(h.Bucket(skydiag::helper::kPerfBucketCount - 1) == 1);
+  assert(h.QuantileUpperUs(0.5) == 30'000'000);
+}
+
+static void Test_Recorder_IsSafeAcrossThreads()
+{
+  HelperPerfRecorder perf;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&perf, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        perf.Record(PerfStage::kRetentionSweep, static_cast<std::uint64_t>(t * 1000 + i));
+        perf.Increment(PerfCounter::kLoopIterations);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  assert(perf.Stage(PerfStage::kRetentionSweep).Count() == 4000);
+  assert(perf.Stage(PerfStage::kRetentionSweep).MaxUs() == 3999);
+  assert(perf.Counter(PerfCounter::kLoopIterations) == 4000);
+}
+
+static void Test_ScopedTimer_RecordsOnce()
+{
+  HelperPerfRecorder perf;
+  {
+    const skydiag::helper::ScopedPerfTimer timer(PerfStage::kDumpWrite, perf);
+  }
+  assert(perf.Stage(PerfStage::kDumpWrite).Count() == 1);
+  assert(perf.Stage(PerfStage::kHangTick).Count() == 0);
+}
+
+static void Test_Serialize_FullAndSummary()
+{
+  HelperPerfRecorder perf;
+  perf.Record(PerfStage::kWctCapture, 12'000);
+  perf.Record(PerfStage::kWctCapture, 3'000);
+  perf.Increment(PerfCounter::kHangSuppressed, 2);
+
+  const auto full = nlohmann::json::parse(skydiag::helper::SerializeHelperPerf(perf));
+  assert(full["version"] == skydiag::helper::kHelperPerfFormatVersion);
+  assert(full["bucket_upper_us"].size() == skydiag::helper::kPerfBucketUpperUs.size());
+  assert(full["stages"].size() == skydiag::helper::kPerfStageCount);
+  const auto& wct = full["stages"]["wct_capture"];
+  assert(wct["count"] == 2);
+  assert(wct["total_us"] == 15'000);
+  assert(wct["max_us"] == 12'000);
+  assert(wct["buckets"].size() == skydiag::helper::kPerfBucketCount);
+  assert(full["stages"]["dump_write"]["count"] == 0);
+  assert(full["counters"]["hang_suppressed"] == 2);
+  assert(full["counters"]["loop_iterations"] == 0);
+
+  // The manifest summary only lists stages that ran.
+  const auto summary = nlohmann::json::parse(skydiag::helper::SerializeHelperPerfSummary(perf));
+  assert(summary.size() == 1);
+  assert(summary["wct_capture"]["p95_us"] == 12'000);
+  assert(!summary["wct_capture"].contains("buckets"));
+}
+
+int main()
+{
+  Test_BucketIndex_UsesInclusiveUpperBounds();
+  Test_Histogram_TracksCountTotalMaxAndQuantiles();
+  Test_Histogram_OverflowReportsMax();
+  Test_Recorder_IsSafeAcrossThreads();
+  Test_ScopedTimer_RecordsOnce();
+  Test_Serialize_FullAndSummary();
+  return 0;
+}
@@ -136,6 +136,25 @@ int main()
     manualCaptureText,
     "TryCapturePssSnapshotForFreeze",
     "Manual capture spike must attempt PSS snapshot capture through the shared helper.");
+  AssertContains(
+    helperIniText,
+    "EnablePssSnapshotForFreeze=1",
+    "Snapshot-first freeze capture must be the shipped default.");
+  AssertContains(
+    pssSnapshotCppText,
+    "PlanFreezeDump(",
+    "Freeze dump writer must follow the shared fallback matrix.");
+  AssertContains(hangCaptureText, "WriteFreezeDump(", "Hang capture must write through the freeze dump fallback path.");
+  AssertContains(manualCaptureText, "WriteFreezeDump(", "Manual capture must write through the freeze dump fallback path.");
+  assert(
+    hangCaptureText.find("TryCapturePssSnapshotForFreeze(") < hangCaptureText.find("CaptureWct(") &&
+    "Hang capture must take the PSS snapshot before WCT capture.");
+  assert(
+    hangCaptureText.find("TryCapturePssSnapshotForFreeze(") < hangCaptureText.find("StartEtwCaptureForHang(") &&
+    "Hang capture must take the PSS snapshot before starting ETW.");
+  assert(
+    manualCaptureText.find("TryCapturePssSnapshotForFreeze(") < manualCaptureText.find("CaptureWct(") &&
+    "Manual capture must take the PSS snapshot before WCT capture.");
 
   return 0;
 }
@@ -2,7 +2,9 @@
 
 #include <atomic>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <optional>
 #include <exception>
 #include <string>
 #include <thread>
@@ -12,20 +14,33 @@
 #include "HelperLog.h"
 #include "HelperMainInternal.h"
 #include "HelperRuntimeTestUtils.h"
+#include "IncidentManifest.h"
 #include "PendingCrashAnalysis.h"
-#include "RetentionWorker.h"
+#include "PostProcessWorker.h"
+#include "SkyrimDiagHelper/HelperPerf.h"
 
 using skydiag::helper::HelperConfig;
+using skydiag::helper::PostProcessPriority;
+using skydiag::helper::RetentionLimits;
+using skydiag::helper::internal::BeginExternalPostProcessJob;
+using skydiag::helper::internal::CompleteExternalPostProcessJob;
+using skydiag::helper::internal::QueueRetentionSweep;
+using skydiag::helper::internal::TrackDumpReaderJob;
 using skydiag::helper::internal::ClearLog;
 using skydiag::helper::internal::CleanupCrashArtifactsAfterZeroExit;
 using skydiag::helper::internal::CaptureStableSharedSnapshot;
 using skydiag::helper::internal::CrashCaptureState;
 using skydiag::helper::internal::ExtractCrashInfo;
+using skydiag::helper::internal::FrozenSharedView;
 using skydiag::helper::internal::HandleCrashEventTick;
 using skydiag::helper::internal::PendingCrashAnalysis;
 using skydiag::helper::internal::PendingCrashEtwCapture;
-using skydiag::helper::internal::ShutdownRetentionWorker;
+using skydiag::helper::internal::ShutdownPostProcessWorker;
 using skydiag::helper::internal::StableSharedSnapshot;
+using skydiag::helper::internal::IsFrozenSharedViewUnchanged;
+using skydiag::helper::internal::MakeIncidentManifestV1;
+using skydiag::helper::internal::TryBorrowFrozenSharedView;
+using skydiag::helper::internal::TryCopyFrozenSharedView;
 using skydiag::helper::internal::TryClearRecoveredCrashFreeze;
 using skydiag::tests::runtime::AssertContains;
 using skydiag::tests::runtime::FileExists;
@@ -102,7 +117,7 @@ void TestHandleCrashEventTick_WritesCrashArtifacts()
   AssertContains(log, "Incident manifest written", "Crash capture must log incident manifest creation");
   AssertContains(log, "Crash captured; waiting for process exit.", "Crash capture must log post-capture state");
 
-  ShutdownRetentionWorker();
+  ShutdownPostProcessWorker();
   CloseHandle(proc.crashEvent);
   proc.crashEvent = nullptr;
   TerminateChildProcess(&child);
@@ -336,6 +351,112 @@ void TestCleanupCrashArtifactsAfterZeroExit_RemovesHandledStrongCrashArtifacts()
   std::filesystem::remove_all(outBase);
 }
 
+void TestIncidentManifest_DoesNotLinkEarlierSessionPerfReport()
+{
+  const auto outBase = MakeTempDir(L"skydiag_helper_runtime_manifest_perf");
+  // Left behind by an earlier helper session's shutdown.
+  WriteAllTextUtf8(outBase / "SkyrimDiagHelper_Perf.json", "{\"version\":1,\"stages\":{}}");
+  const auto dumpPath = outBase / "SkyrimDiag_Crash_20260315_120000_001.dmp";
+  WriteAllTextUtf8(dumpPath, "dump");
+
+  skydiag::helper::HelperPerf().Record(skydiag::helper::PerfStage::kRetentionSweep, 1234u);
+  HelperConfig cfg = MakeTestConfig();
+  const auto manifest = MakeIncidentManifestV1(
+    "crash",
+    L"20260315_120000_001",
+    4242u,
+    dumpPath,
+    std::nullopt,
+    std::nullopt,
+    "",
+    0u,
+    nlohmann::json::object(),
+    nullptr,
+    nullptr,
+    cfg,
+    /*includeConfigSnapshot=*/false);
+
+  Require(
+    !manifest["artifacts"].contains("helper_perf"),
+    "Manifest must not link a perf report written by an earlier session");
+  Require(manifest.contains("helper_perf") && manifest["helper_perf"].is_object(),
+    "Manifest must carry this session's perf summary inline");
+  Require(manifest["helper_perf"].contains("retention_sweep"),
+    "Inline perf summary must include stages recorded in this session");
+
+  std::filesystem::remove_all(outBase);
+}
+
+void TestFrozenSharedView_BorrowsOnlyQuiescentFrozenRings()
+{
+  auto shared = MakeSharedLayout();
+  shared->header.crash_seq = 2u;
+  shared->header.crash.exception_code = 0xC0000005u;
+  for (std::uint32_t i = 0; i < 3; ++i) {
+    shared->events[i].seq = i * 2u;
+  }
+  shared->header.write_index = 3u;
+
+  FrozenSharedView view{};
+  Require(
+    !TryBorrowFrozenSharedView(shared.get(), sizeof(*shared), &view),
+    "Unfrozen mapping must not be borrowed without a copy");
+
+  shared->header.state_flags = skydiag::kState_Frozen;
+  Require(
+    TryBorrowFrozenSharedView(shared.get(), sizeof(*shared), &view),
+    "Frozen mapping with committed rings must be borrowed in place");
+  Require(view.layout == shared.get(), "Borrowed view must point at the mapping itself");
+  Require(IsFrozenSharedViewUnchanged(view), "Untouched frozen view must stay valid");
+
+  StableSharedSnapshot copy{};
+  Require(TryCopyFrozenSharedView(view, &copy), "Untouched frozen view must copy in one pass");
+  Require(copy.layout() != shared.get(), "The dump source must be a copy, not the mapping");
+  Require(
+    std::memcmp(copy.layout(), shared.get(), sizeof(*shared)) == 0,
+    "One-pass copy must match the frozen mapping");
+
+  shared->header.write_index = 4u;
+  Require(
+    !IsFrozenSharedViewUnchanged(view),
+    "A ring writer landing after the borrow must invalidate the view");
+  Require(
+    !TryCopyFrozenSharedView(view, &copy) && !copy.layout(),
+    "A copy racing a ring writer must be dropped for the per-entry path");
+
+  shared->events[3].seq = (3u * 2u) | 1u;
+  Require(
+    !TryBorrowFrozenSharedView(shared.get(), sizeof(*shared), &view),
+    "A writer mid-entry must force the stable-copy path");
+}
+
+void TestRetentionSweep_WaitsForTrackedDumpReaders()
+{
+  const auto outBase = MakeTempDir(L"skydiag_retention_readers");
+  const auto older = outBase / L"SkyrimDiag_Crash_20260101_000000.dmp";
+  const auto newer = outBase / L"SkyrimDiag_Crash_20260101_000100.dmp";
+  WriteAllTextUtf8(older, "dump");
+  WriteAllTextUtf8(newer, "dump");
+  RetentionLimits limits{};
+  limits.maxCrashDumps = 1;
+
+  // Stands in for the analyzer still reading the older dump.
+  const auto reader = BeginExternalPostProcessJob("crash_analysis", PostProcessPriority::kCrash);
+  TrackDumpReaderJob(outBase, reader);
+  QueueRetentionSweep(outBase, limits);
+  Sleep(300);
+  Require(FileExists(older), "A retention sweep must wait for tracked dump readers");
+
+  CompleteExternalPostProcessJob(reader, /*succeeded=*/true);
+  for (int i = 0; i < 50 && FileExists(older); ++i) {
+    Sleep(100);
+  }
+  Require(!FileExists(older) && FileExists(newer), "The sweep must run once the reader has finished");
+
+  ShutdownPostProcessWorker();
+  std::filesystem::remove_all(outBase);
+}
+
 }  // namespace
 
 int main()
@@ -344,8 +465,11 @@ int main()
     TestHandleCrashEventTick_WritesCrashArtifacts();
     TestRecoveredCrashThaw_AllowsStableFollowupSnapshot();
     TestStableSnapshot_PerEntrySeqlocksRejectTornRingData();
+    TestFrozenSharedView_BorrowsOnlyQuiescentFrozenRings();
     TestHandleCrashEventTick_RejectsUncommittedCrashSequenceBeforeDump();
     TestCleanupCrashArtifactsAfterZeroExit_RemovesHandledStrongCrashArtifacts();
+    TestIncidentManifest_DoesNotLinkEarlierSessionPerfReport();
+    TestRetentionSweep_WaitsForTrackedDumpReaders();
     return 0;
   } catch (const std::exception& ex) {
     std::fprintf(stderr, "%s\n", ex.what());
@@ -0,0 +1,164 @@
+// Repeated-parse cost of the analysis stages with and without MinidumpIndex.
+//
+// "per-stage" replays what AnalyzeDump did before the index: every stream
+// lookup re-walks the directory, each stage re-decodes the thread list, the
+// fault lookup re-decodes the module list and each memory view rebuilds the
+// range table. "indexed" builds the index once and serves the same lookups
+// from it. The dump is synthetic but shaped like a large FullMemory capture.
+//
+//   skydiag_minidump_index_bench [--iterations N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "MinidumpIndex.h"
+#include "SyntheticMinidump.h"
+
+using skydiag::dump_tool::minidump::MinidumpIndex;
+using skydiag::dump_tool::minidump::MinidumpMemory;
+using skydiag::dump_tool::minidump::MinidumpReader;
+using skydiag::tests::minidump::SyntheticMinidump;
+
+namespace {
+
+constexpr std::uint32_t kModules = 1200;
+constexpr std::uint32_t kThreads = 400;
+constexpr std::uint32_t kMemoryRanges = 60'000;
+constexpr std::uint32_t kUserStreams = 12;
+
+// Lookups one AnalyzeDump performs (see Analyzer.cpp / Analyzer.CaptureInputs.cpp).
+constexpr std::uint32_t kStreamLookups = 8;
+constexpr std::uint32_t kThreadListLoads = 4;
+constexpr std::uint32_t kModuleListLoads = 2;
+constexpr std::uint32_t kMemoryViews = 2;
+constexpr std::uint32_t kThreadLookups = 64;
+
+std::vector<std::uint8_t> BuildLargeDump()
+{
+  SyntheticMinidump d;
+  for (std::uint32_t i = 0; i < kModules; ++i) {
+    d.AddModule(0x7FF000000000ull + std::uint64_t{ i } * 0x1000000ull, 0x800000u, "C:\\Games\\Skyrim\\Data\\SKSE\\Plugins\\plugin_" + std::to_string(i) + ".dll");
+  }
+  const std::vector<std::uint8_t> stack(256, 0xCC);
+  for (std::uint32_t i = 0; i < kThreads; ++i) {
+    d.AddThread(1000 + i * 4, 0x10000000ull + std::uint64_t{ i } * 0x100000ull, stack, 0, 0);
+  }
+  const std::vector<std::uint8_t> page(64, 0x5A);
+  for (std::uint32_t i = 0; i < kMemoryRanges; ++i) {
+    d.AddMemory64(0x200000000ull + std::uint64_t{ i } * 0x2000ull, page);
+  }
+  for (std::uint32_t i = 0; i < kUserStreams; ++i) {
+    d.AddStream(0x10000u + i, std::vector<std::uint8_t>(32, static_cast<std::uint8_t>(i)));
+  }
+  d.SetException(1000, 0xC0000005u, 0x7FF000001234ull);
+  return d.Finish();
+}
+
+template <class F>
+double MedianUs(std::uint32_t iterations, F&& f)
+{
+  std::vector<double> samples;
+  for (std::uint32_t i = 0; i < iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+  }
+  std::sort(samples.begin(), samples.end());
+  return samples[samples.size() / 2];
+}
+
+volatile std::uint64_t g_sink = 0;
+
+void PerStageRun(const std::vector<std::uint8_t>& dump)
+{
+  std::uint64_t sink = 0;
+  for (std::uint32_t i = 0; i < kStreamLookups; ++i) {
+    MinidumpReader r;
+    r.Open(dump.data(), dump.size(), nullptr);
+    sink += r.Stream(0x10000u + (i % kUserStreams)).value_or(std::span<const std::uint8_t>{}).size();
+  }
+  for (std::uint32_t i = 0; i < kModuleListLoads; ++i) {
+    MinidumpReader r;
+    r.Open(dump.data(), dump.size(), nullptr);
+    sink += r.Modules().size();
+  }
+  for (std::uint32_t i = 0; i < kThreadListLoads; ++i) {
+    MinidumpReader r;
+    r.Open(dump.data(), dump.size(), nullptr);
+    const auto threads = r.Threads();
+    for (std::uint32_t j = 0; j < kThreadLookups / kThreadListLoads; ++j) {
+      const std::uint32_t tid = 1000 + ((j * 37) % kThreads) * 4;
+      for (const auto& t : threads) {
+        if (t.tid == tid) {
+          sink += t.stackStart;
+          break;
+        }
+      }
+    }
+  }
+  for (std::uint32_t i = 0; i < kMemoryViews; ++i) {
+    MinidumpReader r;
+    r.Open(dump.data(), dump.size(), nullptr);
+    sink += MinidumpMemory(r).Regions().size();
+  }
+  g_sink = sink;
+}
+
+void IndexedRun(const std::vector<std::uint8_t>& dump)
+{
+  std::uint64_t sink = 0;
+  MinidumpIndex index;
+  index.Build(dump.data(), dump.size(), nullptr);
+  for (std::uint32_t i = 0; i < kStreamLookups; ++i) {
+    sink += index.Stream(0x10000u + (i % kUserStreams)).value_or(std::span<const std::uint8_t>{}).size();
+  }
+  for (std::uint32_t i = 0; i < kModuleListLoads; ++i) {
+    sink += index.Modules().size();
+  }
+  for (std::uint32_t j = 0; j < kThreadLookups; ++j) {
+    if (const auto* t = index.FindThread(1000 + ((j * 37) % kThreads) * 4)) {
+      sink += t->stackStart;
+    }
+  }
+  for (std::uint32_t i = 0; i < kMemoryViews; ++i) {
+    sink += index.Memory().Regions().size();
+  }
+  g_sink = sink;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  std::uint32_t iterations = 15;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--iterations") == 0) {
+      iterations = static_cast<std::uint32_t>(std::max(1l, std::strtol(argv[i + 1], nullptr, 10)));
+    }
+  }
+
+  const auto dump = BuildLargeDump();
+  const double perStage = MedianUs(iterations, [&] { PerStageRun(dump); });
+  const double indexed = MedianUs(iterations, [&] { IndexedRun(dump); });
+  std::printf(
+    "dump: %.1f MiB, %u modules, %u threads, %u memory ranges\n"
+    "per-stage parsing: %.0f us (median of %u)\n"
+    "indexed:           %.0f us (median of %u)\n"
+    "speedup:           %.2fx\n",
+    static_cast<double>(dump.size()) / (1024.0 * 1024.0),
+    kModules,
+    kThreads,
+    kMemoryRanges,
+    perStage,
+    iterations,
+    indexed,
+    iterations,
+    indexed > 0.0 ? perStage / indexed : 0.0);
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "MinidumpIndex.h"
+#include "SyntheticMinidump.h"
+
+using skydiag::dump_tool::minidump::MinidumpIndex;
+using skydiag::dump_tool::minidump::MinidumpReader;
+using skydiag::tests::minidump::SyntheticMinidump;
+
+namespace {
+
+std::vector<std::uint8_t> BuildDump()
+{
+  SyntheticMinidump d;
+  // Out of base order on purpose; the index sorts.
+  d.AddModule(0x7FF800000000ull, 0x100000u, "C:\\Windows\\System32\\ntdll.dll");
+  d.AddModule(0x140000000ull, 0x2000000u, "C:\\Games\\Skyrim\\SkyrimSE.exe");
+  d.AddThread(300, 0x3000, std::vector<std::uint8_t>(0x100, 3), 0x3080, 0x140000010ull);
+  d.AddThread(100, 0x1000, std::vector<std::uint8_t>(0x100, 1), 0x1080, 0x140000020ull);
+  d.AddThread(200, 0x2000, std::vector<std::uint8_t>(0x100, 2), 0x2080, 0x7FF800000100ull);
+  d.AddMemory64(0x1000, std::vector<std::uint8_t>(0x100, 1));
+  d.SetException(100, 0xC0000005u, 0x140000020ull);
+  d.AddStream(0x10000u + 0x5344u, { 'F', 'I', 'R', 'S', 'T' });
+  d.AddStream(0x10000u + 0x5344u, { 'S', 'E', 'C', 'O', 'N', 'D' });
+  return d.Finish();
+}
+
+void TestMatchesReader()
+{
+  const auto dump = BuildDump();
+  MinidumpReader reader;
+  assert(reader.Open(dump.data(), dump.size(), nullptr));
+  MinidumpIndex index;
+  assert(index.Build(dump.data(), dump.size(), nullptr));
+
+  for (const std::uint32_t type : { 3u, 4u, 5u, 6u, 7u, 9u, 0x10000u + 0x5344u, 0x10000u + 0x5743u }) {
+    const auto a = reader.Stream(type);
+    const auto b = index.Stream(type);
+    assert(a.has_value() == b.has_value());
+    if (a) {
+      assert(a->data() == b->data() && a->size() == b->size());
+    }
+  }
+  // First directory entry wins for duplicate stream types.
+  assert(index.Stream(0x10000u + 0x5344u)->size() == 5);
+  assert(index.Exception() && index.Exception()->tid == 100);
+  assert(index.Memory().Regions().size() == 1);
+}
+
+void TestModuleAndThreadLookups()
+{
+  const auto dump = BuildDump();
+  MinidumpIndex index;
+  assert(index.Build(dump.data(), dump.size(), nullptr));
+
+  assert(index.Modules().size() == 2);
+  assert(index.Modules()[0].base == 0x140000000ull);
+  const auto* exe = index.FindModule(0x140001234ull);
+  assert(exe && exe->path == "C:\\Games\\Skyrim\\SkyrimSE.exe");
+  assert(index.FindModule(0x7FF8000FFFFFull) != nullptr);
+  assert(index.FindModule(0x7FF800100000ull) == nullptr);  // one past the end
+  assert(index.FindModule(0x1000) == nullptr);
+
+  // Threads keep dump order; lookups go by tid.
+  assert(index.Threads().size() == 3);
+  assert(index.Threads()[0].tid == 300);
+  const auto* t = index.FindThread(200);
+  assert(t && t->stackStart == 0x2000);
+  assert(index.FindThread(999) == nullptr);
+}
+
+void TestCorruptDumpLeavesIndexEmpty()
+{
+  auto dump = BuildDump();
+  dump[0] = 'X';
+  MinidumpIndex index;
+  std::string err;
+  assert(!index.Build(dump.data(), dump.size(), &err));
+  assert(!err.empty());
+  assert(!index.Stream(4));
+  assert(index.Modules().empty());
+  assert(index.Threads().empty());
+  assert(index.FindThread(100) == nullptr);
+  assert(index.Memory().Regions().empty());
+}
+
+}  // namespace
+
+int main()
+{
+  TestMatchesReader();
+  TestModuleAndThreadLookups();
+  TestCorruptDumpLeavesIndexEmpty();
+  return 0;
+}
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "MinidumpReader.h"
+#include "SyntheticMinidump.h"
+
+using skydiag::dump_tool::minidump::ContextX64;
+using skydiag::dump_tool::minidump::MappedDumpFile;
+using skydiag::dump_tool::minidump::MinidumpMemory;
+using skydiag::dump_tool::minidump::MinidumpReader;
+using skydiag::dump_tool::minidump::Utf16LeToUtf8;
+using skydiag::tests::minidump::SyntheticMinidump;
+
+namespace {
+
+std::vector<std::uint8_t> Pattern(std::size_t n, std::uint8_t seed)
+{
+  std::vector<std::uint8_t> v(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    v[i] = static_cast<std::uint8_t>(seed + i);
+  }
+  return v;
+}
+
+std::vector<std::uint8_t> BuildDump()
+{
+  SyntheticMinidump d;
+  d.AddModule(0x140000000ull, 0x2000000u, "C:\\Games\\Skyrim\\SkyrimSE.exe");
+  d.AddModule(0x7FF800000000ull, 0x100000u, "C:\\Windows\\System32\\ntdll.dll");
+  d.AddThread(42, 0x1000, Pattern(0x200, 1), 0x1100, 0x140001234ull);
+  d.AddMemory64(0x1000, Pattern(0x200, 1));
+  d.AddMemory64(0x1200, Pattern(0x100, 7));  // adjacent to the first range
+  d.AddMemory64(0x9000, Pattern(0x40, 9));
+  d.SetException(42, 0xC0000005u, 0x140001234ull);
+  d.AddStream(0x10000u + 0x5344u, { 'B', 'B', 'O', 'X' });
+  return d.Finish();
+}
+
+void TestHeaderAndStreams()
+{
+  const auto dump = BuildDump();
+  MinidumpReader r;
+  std::string err;
+  assert(r.Open(dump.data(), dump.size(), &err));
+  assert(err.empty());
+  assert(r.StreamCount() == 5);
+
+  const auto user = r.Stream(0x10000u + 0x5344u);
+  assert(user && user->size() == 4 && (*user)[0] == 'B');
+  assert(!r.Stream(0x10000u + 0x4850u));
+}
+
+void TestModulesThreadsException()
+{
+  const auto dump = BuildDump();
+  MinidumpReader r;
+  assert(r.Open(dump.data(), dump.size(), nullptr));
+
+  const auto mods = r.Modules();
+  assert(mods.size() == 2);
+  assert(mods[0].base == 0x140000000ull && mods[0].size == 0x2000000u);
+  assert(mods[0].path == "C:\\Games\\Skyrim\\SkyrimSE.exe");
+  assert(!mods[0].hasVersion);
+
+  const auto threads = r.Threads();
+  assert(threads.size() == 1);
+  assert(threads[0].tid == 42 && threads[0].stackStart == 0x1000);
+  const auto stack = r.Bytes(threads[0].stack);
+  assert(stack.size() == 0x200 && stack[0] == 1);
+
+  ContextX64 ctx{};
+  assert(r.ReadContextX64(threads[0].context, &ctx));
+  assert(ctx.Rsp == 0x1100 && ctx.Rip == 0x140001234ull);
+
+  const auto ex = r.Exception();
+  assert(ex && ex->tid == 42 && ex->code == 0xC0000005u && ex->address == 0x140001234ull);
+}
+
+void TestMemoryReads()
+{
+  const auto dump = BuildDump();
+  MinidumpReader r;
+  assert(r.Open(dump.data(), dump.size(), nullptr));
+  const MinidumpMemory mem(r);
+  assert(mem.Regions().size() == 3);
+
+  std::uint8_t buf[0x20]{};
+  // Crosses from the first range into the adjacent second one.
+  assert(mem.Read(0x11F0, buf, sizeof(buf)) == sizeof(buf));
+  assert(buf[0] == static_cast<std::uint8_t>(1 + 0x1F0));
+  assert(buf[0x10] == 7);
+  // Short read at the end of the last contiguous range, none in a gap.
+  assert(mem.Read(0x12F8, buf, sizeof(buf)) == 8);
+  assert(mem.Read(0x5000, buf, sizeof(buf)) == 0);
+  assert(mem.Read(0x0, buf, sizeof(buf)) == 0);
+
+  // Hopping between ranges (what the recent-range cache serves) returns the
+  // same bytes as cold lookups, including through a copy, which starts cold.
+  const MinidumpMemory copy = mem;
+  for (int round = 0; round < 3; ++round) {
+    for (const MinidumpMemory* m : { &mem, &copy }) {
+      std::uint8_t b = 0;
+      assert(m->Read(0x9010, &b, 1) == 1 && b == static_cast<std::uint8_t>(9 + 0x10));
+      assert(m->Read(0x1008, &b, 1) == 1 && b == static_cast<std::uint8_t>(1 + 0x8));
+      assert(m->Read(0x1210, &b, 1) == 1 && b == static_cast<std::uint8_t>(7 + 0x10));
+      assert(m->Read(0x9040, &b, 1) == 0);
+      assert(m->Read(0x11FF, buf, 2) == 2 && buf[0] == static_cast<std::uint8_t>(1 + 0x1FF) && buf[1] == 7);
+    }
+  }
+}
+
+void TestRejectsCorruptInput()
+{
+  auto dump = BuildDump();
+  MinidumpReader r;
+  std::string err;
+  assert(!r.Open(dump.data(), 16, &err) && !err.empty());
+
+  auto badSig = dump;
+  badSig[0] = 'X';
+  assert(!r.Open(badSig.data(), badSig.size(), &err));
+
+  // Stream count larger than the file can hold.
+  auto badCount = dump;
+  const std::uint32_t huge = 0x10000000u;
+  std::memcpy(badCount.data() + 8, &huge, 4);
+  assert(!r.Open(badCount.data(), badCount.size(), &err));
+
+  // Truncated file: the directory still fits, but streams point past the end
+  // and must come back empty instead of reading out of bounds.
+  std::uint32_t dirRva = 0;
+  std::memcpy(&dirRva, dump.data() + 12, 4);
+  std::vector<std::uint8_t> moved(dump.begin(), dump.end());
+  const std::uint32_t newDir = 32;
+  std::memcpy(moved.data() + 32, dump.data() + dirRva, 5 * 12);
+  std::memcpy(moved.data() + 12, &newDir, 4);
+  moved.resize(32 + 5 * 12);
+  assert(r.Open(moved.data(), moved.size(), &err));
+  assert(r.Modules().empty());
+  assert(r.Threads().empty());
+  assert(!r.Exception());
+  assert(MinidumpMemory(r).Regions().empty());
+}
+
+void TestUtf16Decode()
+{
+  const std::uint8_t hangul[] = { 0x5C, 0xD5 };              // U+D55C
+  assert(Utf16LeToUtf8(hangul) == "\xED\x95\x9C");
+  const std::uint8_t pair[] = { 0x3D, 0xD8, 0x00, 0xDE };    // U+1F600
+  assert(Utf16LeToUtf8(pair) == "\xF0\x9F\x98\x80");
+  const std::uint8_t lone[] = { 0x3D, 0xD8, 0x41, 0x00 };    // unpaired high + 'A'
+  assert(Utf16LeToUtf8(lone) == "\xEF\xBF\xBD" "A");
+}
+
+void TestMappedFile()
+{
+  const auto dump = BuildDump();
+  const auto path = std::filesystem::temp_directory_path() / "skydiag_minidump_reader_test.dmp";
+  {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(dump.data()), static_cast<std::streamsize>(dump.size()));
+  }
+  {
+    MappedDumpFile file;
+    std::string err;
+    assert(file.Open(path, &err));
+    assert(file.Size() == dump.size());
+    MinidumpReader r;
+    assert(r.Open(file.Data(), file.Size(), &err));
+    assert(r.Modules().size() == 2);
+
+    // Read-ahead is advisory: the bytes are unchanged and empty spans are fine.
+    const auto stack = r.Bytes(r.Threads().at(0).stack);
+    const std::vector<std::uint8_t> before(stack.begin(), stack.end());
+    skydiag::dump_tool::minidump::PrefetchMappedSpans({ stack, {}, r.Bytes(0, file.Size()) });
+    assert(std::equal(stack.begin(), stack.end(), before.begin(), before.end()));
+  }
+  std::filesystem::remove(path);
+
+  MappedDumpFile missing;
+  std::string err;
+  assert(!missing.Open(path, &err) && !err.empty());
+}
+
+}  // namespace
+
+int main()
+{
+  TestHeaderAndStreams();
+  TestModulesThreadsException();
+  TestMemoryReads();
+  TestRejectsCorruptInput();
+  TestUtf16Decode();
+  TestMappedFile();
+  return 0;
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "ModuleAddressIndex.h"
+
+using skydiag::dump_tool::minidump::ModuleAddressIndex;
+
+namespace {
+
+using Range = ModuleAddressIndex::Range;
+
+// Reference: the upper_bound lookup FindModuleIndexForAddress does over a
+// base-sorted module list.
+std::optional<std::size_t> Reference(const std::vector<Range>& sorted, std::uint64_t addr)
+{
+  const auto it = std::upper_bound(sorted.begin(), sorted.end(), addr, [](std::uint64_t v, const Range& r) {
+    return v < r.base;
+  });
+  if (it == sorted.begin()) {
+    return std::nullopt;
+  }
+  const auto& cand = *(it - 1);
+  if (addr >= cand.base && addr < cand.end) {
+    return static_cast<std::size_t>(std::distance(sorted.begin(), it - 1));
+  }
+  return std::nullopt;
+}
+
+std::vector<Range> TypicalProcessLayout()
+{
+  return {
+    { 0x140000000ull, 0x143A00000ull },          // SkyrimSE.exe
+    { 0x180000000ull, 0x180051000ull },          // skse64_1_6_1170.dll
+    { 0x7FF8A0000000ull, 0x7FF8A0021000ull },    // plugin
+    { 0x7FF8A0030000ull, 0x7FF8A0031000ull },    // plugin, single page
+    { 0x7FFF3C8E0000ull, 0x7FFF3CAED000ull },    // ntdll.dll
+    { 0x7FFFFFFF0000ull, 0x800000010000ull },    // straddles a 4 GiB region
+  };
+}
+
+void TestMatchesReferenceOnTypicalLayout()
+{
+  const auto mods = TypicalProcessLayout();
+  const ModuleAddressIndex index(mods);
+
+  for (const auto& m : mods) {
+    for (const std::uint64_t addr : { m.base - 1, m.base, m.base + 1, (m.base + m.end) / 2, m.end - 1, m.end }) {
+      assert(index.Find(addr) == Reference(mods, addr));
+    }
+  }
+  assert(!index.Find(0));
+  assert(!index.Find(0x00000000DEADBEEFull));   // small integer
+  assert(!index.Find(0x000000A1B2C3D000ull));   // stack/heap-looking pointer
+  assert(!index.Find(~std::uint64_t{ 0 }));
+  assert(index.Find(0x800000000100ull) == std::optional<std::size_t>(5));
+}
+
+void TestUnsortedInputKeepsCallerIndices()
+{
+  std::vector<Range> mods = {
+    { 0x7FF800000000ull, 0x7FF800100000ull },
+    { 0x140000000ull, 0x140200000ull },
+    { 0x180000000ull, 0x180010000ull },
+  };
+  const ModuleAddressIndex index(mods);
+  assert(index.Find(0x7FF800000010ull) == std::optional<std::size_t>(0));
+  assert(index.Find(0x140000010ull) == std::optional<std::size_t>(1));
+  assert(index.Find(0x180000010ull) == std::optional<std::size_t>(2));
+}
+
+void TestOverlapAndEmptyRangesMatchReference()
+{
+  // The reference only checks the predecessor by base; an empty or nested
+  // module shadows the outer one. The index must agree, not "fix" it.
+  const std::vector<Range> mods = {
+    { 0x10000000ull, 0x10100000ull },
+    { 0x10040000ull, 0x10040000ull },  // empty
+    { 0x10080000ull, 0x10090000ull },  // nested
+    { 0x10080000ull, 0x100A0000ull },  // same base, larger; wins as last
+  };
+  const ModuleAddressIndex index(mods);
+  for (std::uint64_t addr = 0x0FFF0000ull; addr < 0x10110000ull; addr += 0x4000ull) {
+    assert(index.Find(addr) == Reference(mods, addr));
+  }
+}
+
+void TestRandomizedParityAndPrefilter()
+{
+  std::mt19937_64 rng(0x5EED);
+  for (int round = 0; round < 20; ++round) {
+    std::vector<Range> mods;
+    std::uint64_t cursor = 0x7FF000000000ull;
+    const int count = 1 + static_cast<int>(rng() % 300);
+    for (int i = 0; i < count; ++i) {
+      cursor += (rng() % 64) * 0x10000ull;
+      const std::uint64_t size = 0x1000ull + (rng() % 0x400000ull);
+      mods.push_back({ cursor, cursor + size });
+      cursor += size;
+    }
+    const ModuleAddressIndex index(mods);
+
+    std::vector<std::uint64_t> words;
+    for (int i = 0; i < 4096; ++i) {
+      switch (rng() % 3) {
+        case 0: words.push_back(rng() % 0x10000ull); break;
+        case 1: words.push_back(mods[rng() % mods.size()].base + (rng() % 0x500000ull)); break;
+        default: words.push_back(rng()); break;
+      }
+    }
+    for (const auto w : words) {
+      const auto expected = Reference(mods, w);
+      assert(index.Find(w) == expected);
+      if (expected) {
+        assert(index.MayContain(w));
+      }
+    }
+
+    std::vector<std::uint32_t> positions(words.size());
+    const auto kept = index.FilterCandidates(words.data(), words.size(), positions.data());
+    std::size_t cursorPos = 0;
+    for (std::size_t i = 0; i < words.size(); ++i) {
+      if (index.MayContain(words[i])) {
+        assert(cursorPos < kept && positions[cursorPos] == i);
+        ++cursorPos;
+      }
+    }
+    assert(cursorPos == kept);
+  }
+}
+
+void TestEmptyIndex()
+{
+  const ModuleAddressIndex index;
+  assert(index.Empty());
+  assert(!index.Find(0x140000000ull));
+  const std::uint64_t words[] = { 0, 0x140000000ull };
+  std::uint32_t positions[2]{};
+  assert(index.FilterCandidates(words, 2, positions) == 0);
+}
+
+}  // namespace
+
+int main()
+{
+  TestMatchesReferenceOnTypicalLayout();
+  TestUnsortedInputKeepsCallerIndices();
+  TestOverlapAndEmptyRangesMatchReference();
+  TestRandomizedParityAndPrefilter();
+  TestEmptyIndex();
+  return 0;
+}
@@ -0,0 +1,195 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "ModuleCache.h"
+#include "SourceGuardTestUtils.h"
+
+using skydiag::dump_tool::CachedImageRange;
+using skydiag::dump_tool::CachedRuntimeFunction;
+using skydiag::dump_tool::CachedSymbol;
+using skydiag::dump_tool::ModuleCacheFile;
+using skydiag::dump_tool::ModuleCacheKey;
+using skydiag::dump_tool::ModuleCacheKeyFor;
+using skydiag::dump_tool::ModuleCacheKind;
+using skydiag::dump_tool::ModuleCachePath;
+using skydiag::dump_tool::StoreModuleSymbolCache;
+using skydiag::dump_tool::StoreModuleUnwindCache;
+using skydiag::dump_tool::minidump::MinidumpModuleRecord;
+using skydiag::tests::source_guard::AssertContains;
+using skydiag::tests::source_guard::ExtractFunctionBody;
+using skydiag::tests::source_guard::ReadProjectText;
+
+namespace {
+
+std::filesystem::path FreshDir()
+{
+  std::random_device rd;
+  const auto dir = std::filesystem::temp_directory_path() / ("skydiag_module_cache_" + std::to_string(rd()));
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  return dir;
+}
+
+ModuleCacheKey Key()
+{
+  MinidumpModuleRecord record;
+  record.path = "C:\\Games\\Skyrim Special Edition\\Data\\SKSE\\Plugins\\EngineFixes.dll";
+  record.timeDateStamp = 0x65A1B2C3u;
+  record.size = 0x2A000;
+  return ModuleCacheKeyFor(record);
+}
+
+void TestKeyFromRecord()
+{
+  const auto key = Key();
+  assert(key.file_name == "enginefixes.dll");
+  assert(key.Valid());
+
+  MinidumpModuleRecord odd;
+  odd.path = "/opt/x/My Mod+.DLL";
+  odd.timeDateStamp = 1;
+  odd.size = 2;
+  assert(ModuleCacheKeyFor(odd).file_name == "my%20mod%2b.dll");
+
+  MinidumpModuleRecord noStamp = odd;
+  noStamp.timeDateStamp = 0;
+  assert(!ModuleCacheKeyFor(noStamp).Valid());
+}
+
+void TestUnwindRoundTrip()
+{
+  const auto dir = FreshDir();
+  const auto key = Key();
+
+  ModuleCacheFile file;
+  assert(!file.Open(dir, key, ModuleCacheKind::kUnwind));
+
+  std::vector<CachedRuntimeFunction> functions = { { 0x2000, 0x2040, 0x9010 }, { 0x1000, 0x1100, 0x9000 } };
+  std::vector<CachedImageRange> ranges(2);
+  ranges[0].rva = 0x9000;
+  ranges[0].bytes = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  ranges[1].rva = 0x9010;
+  ranges[1].bytes = { 9, 10, 11, 12 };
+  assert(StoreModuleUnwindCache(dir, key, functions, ranges));
+
+  assert(file.Open(dir, key, ModuleCacheKind::kUnwind));
+  assert(file.FunctionCount() == 2);
+  assert(file.Function(0).begin == 0x1000 && file.Function(0).unwind_info == 0x9000);
+  assert(file.Function(1).begin == 0x2000 && file.Function(1).end == 0x2040);
+
+  std::uint8_t buf[6]{};
+  assert(file.ReadImage(0x9006, buf, sizeof(buf)) == 2);
+  assert(buf[0] == 7 && buf[1] == 8 && buf[2] == 0);
+  assert(file.ReadImage(0x9011, buf, 2) == 2 && buf[0] == 10 && buf[1] == 11);
+  assert(file.ReadImage(0x9008, buf, 2) == 0);
+  assert(file.ReadImage(0x8FFF, buf, 2) == 0);
+
+  // The symbol kind of the same build is a separate file.
+  ModuleCacheFile symbols;
+  assert(!symbols.Open(dir, key, ModuleCacheKind::kSymbols));
+
+  // Overlapping ranges are refused.
+  ranges[1].rva = 0x9004;
+  assert(!StoreModuleUnwindCache(dir, key, functions, ranges));
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+
+void TestSymbolLookup()
+{
+  const auto dir = FreshDir();
+  const auto key = Key();
+  assert(StoreModuleSymbolCache(dir, key, { { 0x3000, "Later" }, { 0x1000, "SKSEPlugin_Load" }, { 0x1000, "Alias" } }));
+
+  ModuleCacheFile file;
+  assert(file.Open(dir, key, ModuleCacheKind::kSymbols));
+  assert(file.SymbolCount() == 2);
+  std::string_view name;
+  std::uint32_t disp = 0;
+  assert(!file.FindSymbol(0x0FFF, &name, &disp));
+  assert(file.FindSymbol(0x1000, &name, &disp) && name == "Alias" && disp == 0);
+  assert(file.FindSymbol(0x2FFF, &name, &disp) && name == "Alias" && disp == 0x1FFF);
+  assert(file.FindSymbol(0x3010, &name, &disp) && name == "Later" && disp == 0x10);
+
+  // An empty table is a valid "nothing to symbolize" entry.
+  auto other = key;
+  other.file_name = "nosyms.dll";
+  assert(StoreModuleSymbolCache(dir, other, {}));
+  ModuleCacheFile empty;
+  assert(empty.Open(dir, other, ModuleCacheKind::kSymbols));
+  assert(empty.SymbolCount() == 0 && !empty.FindSymbol(0x1000, &name, &disp));
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+
+void TestForeignAndCorruptFilesMiss()
+{
+  const auto dir = FreshDir();
+  const auto key = Key();
+  assert(StoreModuleSymbolCache(dir, key, { { 0x1000, "A" } }));
+
+  // A rebuild with the same name misses.
+  auto rebuilt = key;
+  rebuilt.time_date_stamp += 1;
+  ModuleCacheFile file;
+  assert(!file.Open(dir, rebuilt, ModuleCacheKind::kSymbols));
+
+  // A file copied over another key's name is rejected by its header.
+  std::filesystem::copy_file(
+    ModuleCachePath(dir, key, ModuleCacheKind::kSymbols),
+    ModuleCachePath(dir, rebuilt, ModuleCacheKind::kSymbols));
+  assert(!file.Open(dir, rebuilt, ModuleCacheKind::kSymbols));
+
+  // Truncated: the table no longer fits.
+  const auto path = ModuleCachePath(dir, key, ModuleCacheKind::kSymbols);
+  std::filesystem::resize_file(path, 50);
+  assert(!file.Open(dir, key, ModuleCacheKind::kSymbols));
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "not a cache";
+  }
+  assert(!file.Open(dir, key, ModuleCacheKind::kSymbols));
+
+  // Uncacheable keys are neither stored nor looked up.
+  auto unset = key;
+  unset.time_date_stamp = 0;
+  assert(!StoreModuleSymbolCache(dir, unset, {}));
+  assert(!StoreModuleSymbolCache({}, key, {}));
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+
+void TestStackwalkCachesPdbPublicsOnly()
+{
+  const auto stackwalk = ReadProjectText("dump_tool/src/AnalyzerInternalsStackwalk.cpp");
+  const auto store = ExtractFunctionBody(stackwalk, "std::size_t StoreFrameSymbolCaches(");
+  AssertContains(store, "info.SymType == SymPdb && !info.LineNumbers",
+    "Symbol caches must only persist PDB publics; export names depend on the search path.");
+  AssertContains(stackwalk, "recordRuntime(ProbeSymbolRuntime(modules, out.online_symbol_source_allowed))",
+    "Skipping DbgHelp on a full cache hit must still report the symbol runtime.");
+
+  const auto cache = ReadProjectText("dump_tool/src/ModuleCache.cpp");
+  AssertContains(cache, "kVersion = 2", "Caches written before the publics-only rule must be invalidated.");
+}
+
+}  // namespace
+
+int main()
+{
+  TestKeyFromRecord();
+  TestUnwindRoundTrip();
+  TestSymbolLookup();
+  TestForeignAndCorruptFilesMiss();
+  TestStackwalkCachesPdbPublicsOnly();
+  return 0;
+}
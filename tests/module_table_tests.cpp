@@ -0,0 +1,213 @@
+#include "ModuleTable.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using skydiag::dump_tool::minidump::FindModuleIndexForAddress;
+using skydiag::dump_tool::minidump::ModuleRow;
+using skydiag::dump_tool::minidump::ModuleTable;
+
+// Views point back at the table; it must stay where it was built.
+static_assert(!std::is_copy_constructible_v<ModuleTable>);
+static_assert(!std::is_copy_assignable_v<ModuleTable>);
+static_assert(!std::is_move_constructible_v<ModuleTable>);
+static_assert(!std::is_move_assignable_v<ModuleTable>);
+
+namespace {
+
+std::atomic<int> g_classifyCalls{ 0 };
+
+std::uint8_t CountingClassifier(std::wstring_view filenameLower)
+{
+  g_classifyCalls.fetch_add(1);
+  std::uint8_t flags = 0;
+  if (filenameLower == L"ntdll.dll") {
+    flags |= ModuleTable::kSystemish;
+  }
+  if (filenameLower == L"skyrimse.exe") {
+    flags |= ModuleTable::kGameExe;
+  }
+  if (filenameLower == L"enginefixes.dll") {
+    flags |= ModuleTable::kKnownHookFramework;
+  }
+  return flags;
+}
+
+ModuleRow Row(std::uint64_t base, std::uint64_t size, std::wstring path)
+{
+  ModuleRow row;
+  row.base = base;
+  row.size = size;
+  row.path = std::move(path);
+  return row;
+}
+
+std::vector<ModuleRow> SampleRows()
+{
+  std::vector<ModuleRow> rows;
+  auto& exe = rows.emplace_back(Row(0x140000000ull, 0x3000000, L"C:\\Games\\Skyrim Special Edition\\SkyrimSE.exe"));
+  exe.hasVersion = true;
+  exe.fileVersionMS = (1u << 16) | 6u;
+  exe.fileVersionLS = (1170u << 16) | 0u;
+  rows.push_back(Row(0x180000000ull, 0x2A000,
+    L"D:\\MO2\\mods\\Engine Fixes\\SKSE\\Plugins\\EngineFixes.dll"));
+  // Same file name as the row above in a different case and folder.
+  rows.push_back(Row(0x190000000ull, 0x1000, L"D:\\MO2\\overwrite\\SKSE\\Plugins\\ENGINEFIXES.DLL"));
+  auto& custom = rows.emplace_back(Row(0x7FF800000000ull, 0x10000, L"C:\\Windows\\System32\\custom_driver_shim.dll"));
+  custom.systemPath = true;
+  rows.push_back(Row(0x7FFA00000000ull, 0x200000, L"C:\\Windows\\System32\\ntdll.dll"));
+  return rows;
+}
+
+void TestColumnLayout()
+{
+  g_classifyCalls = 0;
+  ModuleTable table;
+  table.Build(SampleRows(), &CountingClassifier);
+
+  assert(table.size() == 5);
+  assert(!table.empty());
+  // One classification per distinct lower-case file name.
+  assert(g_classifyCalls.load() == 4);
+
+  assert(table.Base(0) == 0x140000000ull);
+  assert(table.End(0) == 0x143000000ull);
+  assert(table.End(1) == 0x18002A000ull);
+
+  const auto exe = table[0];
+  assert(exe.path == L"C:\\Games\\Skyrim Special Edition\\SkyrimSE.exe");
+  assert(exe.filename == L"SkyrimSE.exe");
+  assert(exe.filename_lower == L"skyrimse.exe");
+  assert(exe.is_game_exe && !exe.is_systemish && !exe.is_known_hook_framework);
+  assert(table.Has(0, ModuleTable::kGameExe));
+
+  // Equal names share one interned lower-case string but keep their own
+  // path and original-case file name.
+  const auto fixes = table[1];
+  const auto fixesCopy = table[2];
+  assert(&fixes.filename_lower == &fixesCopy.filename_lower);
+  assert(&fixes.filename_lower == &table.FilenameLower(2));
+  assert(fixes.filename == L"EngineFixes.dll");
+  assert(fixesCopy.filename == L"ENGINEFIXES.DLL");
+  assert(fixes.is_known_hook_framework && fixesCopy.is_known_hook_framework);
+
+  // A system directory marks the row systemish even for an unknown name.
+  assert(table[3].is_systemish);
+  assert(!table.Has(3, ModuleTable::kKnownHookFramework));
+  assert(table[4].is_systemish);
+
+  std::size_t visited = 0;
+  for (const auto& m : table) {
+    assert(m.table == &table);
+    assert(m.index == visited);
+    assert(m.base == table.Base(visited));
+    ++visited;
+  }
+  assert(visited == table.size());
+}
+
+void TestLookups()
+{
+  ModuleTable table;
+  table.Build(SampleRows(), &CountingClassifier);
+
+  assert(!table.Find(0x13FFFFFFFull).has_value());
+  assert(table.Find(0x140000000ull) == 0u);
+  assert(table.Find(0x142FFFFFFull) == 0u);
+  assert(!table.Find(0x143000000ull).has_value());
+  assert(table.Find(0x180001000ull) == 1u);
+  assert(table.Find(0x7FFA00000010ull) == 4u);
+  assert(!table.Find(0x7FFA00200000ull).has_value());
+  assert(FindModuleIndexForAddress(table, 0x190000800ull) == 2u);
+
+  assert(table.FindByFilename(L"NTDLL.dll") == 4u);
+  assert(table.FindByFilename(L"enginefixes.dll") == 1u);
+  assert(!table.FindByFilename(L"missing.dll").has_value());
+
+  ModuleTable empty;
+  assert(empty.empty());
+  assert(!empty.Find(0x140000000ull).has_value());
+  assert(empty.begin() == empty.end());
+}
+
+void TestLazyVersionAndModName()
+{
+  ModuleTable table;
+  table.Build(SampleRows(), &CountingClassifier);
+
+  assert(table[0].Version() == "1.6.1170.0");
+  assert(table[1].Version().empty());
+  assert(&table[0].Version() == &table.Version(0));
+
+  assert(table[1].InferredModName() == L"Engine Fixes");
+  assert(table[2].InferredModName().empty());
+  assert(table[0].InferredModName().empty());
+  assert(&table[1].InferredModName() == &table.InferredModName(1));
+}
+
+void TestConcurrentFirstAccess()
+{
+  constexpr std::size_t kRows = 64;
+  std::vector<ModuleRow> rows;
+  for (std::size_t i = 0; i < kRows; ++i) {
+    auto& row = rows.emplace_back(Row(0x180000000ull + i * 0x100000ull, 0x10000,
+      L"D:\\MO2\\mods\\Mod" + std::to_wstring(i) + L"\\SKSE\\Plugins\\Plugin" + std::to_wstring(i) + L".dll"));
+    row.hasVersion = true;
+    row.fileVersionMS = (1u << 16) | static_cast<std::uint32_t>(i);
+    row.fileVersionLS = 0;
+  }
+  ModuleTable table;
+  table.Build(rows, &CountingClassifier);
+
+  // Every thread races the first access on every row; each must see the
+  // finished value and the same storage.
+  constexpr int kThreads = 8;
+  std::vector<std::vector<const std::string*>> versions(kThreads);
+  std::vector<std::vector<const std::wstring*>> modNames(kThreads);
+  std::atomic<int> ready{ 0 };
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      ready.fetch_add(1);
+      while (ready.load() < kThreads) {
+        std::this_thread::yield();
+      }
+      for (std::size_t n = 0; n < kRows; ++n) {
+        const std::size_t i = (t % 2 == 0) ? n : kRows - 1 - n;
+        const auto m = table[i];
+        versions[t].push_back(&m.Version());
+        modNames[t].push_back(&m.InferredModName());
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  for (int t = 0; t < kThreads; ++t) {
+    for (std::size_t n = 0; n < kRows; ++n) {
+      const std::size_t i = (t % 2 == 0) ? n : kRows - 1 - n;
+      assert(versions[t][n] == &table.Version(i));
+      assert(modNames[t][n] == &table.InferredModName(i));
+      assert(*versions[t][n] == "1." + std::to_string(i) + ".0.0");
+      assert(*modNames[t][n] == L"Mod" + std::to_wstring(i));
+    }
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  TestColumnLayout();
+  TestLookups();
+  TestLazyVersionAndModName();
+  TestConcurrentFirstAccess();
+  return 0;
+}
@@ -95,6 +95,7 @@ void TestGoldenJsonSchemaV2(const nlohmann::json& j)
   AssertIsType(j, "evidence", "array", "root");
   AssertIsType(j, "recommendations", "array", "root");
   AssertIsType(j, "first_chance_context", "object", "root");
+  AssertIsType(j, "hang_precapture", "object", "root");
 
   // ── schema block ──
   const auto& schema = j["schema"];
@@ -263,6 +264,27 @@ void TestGoldenJsonSchemaV2(const nlohmann::json& j)
   AssertIsType(wctConsensus, "repeated_cycle_thread_count", "number", "freeze_analysis.wct_consensus");
   AssertIsType(wctConsensus, "consistent_loading_signal", "boolean", "freeze_analysis.wct_consensus");
   AssertIsType(wctConsensus, "longest_wait_tid_consensus", "boolean", "freeze_analysis.wct_consensus");
+  AssertIsType(freeze, "wait_graph", "object", "freeze_analysis");
+  const auto& waitGraph = freeze["wait_graph"];
+  AssertIsType(waitGraph, "has_graph", "boolean", "freeze_analysis.wait_graph");
+  AssertIsType(waitGraph, "thread_nodes", "number", "freeze_analysis.wait_graph");
+  AssertIsType(waitGraph, "lock_nodes", "number", "freeze_analysis.wait_graph");
+  AssertIsType(waitGraph, "cycle_count", "number", "freeze_analysis.wait_graph");
+  AssertIsType(waitGraph, "cycles", "array", "freeze_analysis.wait_graph");
+  AssertIsType(waitGraph, "longest_chain", "object", "freeze_analysis.wait_graph");
+  const auto& longestChain = waitGraph["longest_chain"];
+  AssertIsType(longestChain, "thread_ids", "array", "freeze_analysis.wait_graph.longest_chain");
+  AssertIsType(longestChain, "modules", "array", "freeze_analysis.wait_graph.longest_chain");
+  AssertIsType(longestChain, "has_cycle", "boolean", "freeze_analysis.wait_graph.longest_chain");
+
+  // ── hang_precapture ──
+  const auto& precapture = j["hang_precapture"];
+  AssertIsType(precapture, "has_precapture", "boolean", "hang_precapture");
+  AssertIsType(precapture, "snapshot_count", "number", "hang_precapture");
+  AssertIsType(precapture, "dropped_snapshots", "number", "hang_precapture");
+  AssertIsType(precapture, "main_thread_id", "number", "hang_precapture");
+  AssertIsType(precapture, "stable_main_rip_samples", "number", "hang_precapture");
+  AssertIsType(precapture, "timeline", "array", "hang_precapture");
 
   // ── recommendations ──
   for (const auto& r : j["recommendations"]) {
@@ -90,6 +90,23 @@ int main()
     "summaryInfo.stackwalkDegraded",
     "Pending crash analysis must consider stackwalk degradation when deciding recapture.");
 
+  // The flag must come from the field the dump tool writes, not from
+  // diagnostics wording that has already changed once.
+  const std::string helperCommon = ReadAllText(repoRoot / "helper" / "src" / "HelperCommon.cpp");
+  const std::string summaryWriter = ReadAllText(repoRoot / "dump_tool" / "src" / "OutputWriter.Summary.cpp");
+  AssertContains(
+    summaryWriter,
+    "summary[\"callstack\"][\"stack_scan_fallback\"] = r.stack_scan_fallback;",
+    "The dump tool must record the stack-scan fallback as a summary field.");
+  AssertContains(
+    helperCommon,
+    "callstack[\"stack_scan_fallback\"]",
+    "The helper must read the stack-scan fallback field.");
+  AssertContains(
+    helperCommon,
+    "info.stackwalkDegraded = skydiag::helper::IsStackwalkDegraded(",
+    "The helper must derive stackwalkDegraded through IsStackwalkDegraded.");
+
   AssertContains(
     decision,
     "summaryInfo.symbolRuntimeDegraded",
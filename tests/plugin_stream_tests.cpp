@@ -98,6 +98,30 @@ void TestCrashSeqlockProtocolVersionAndDumpCompatibility()
     "Offline analyzer must continue accepting v2 and v3 blackbox streams from existing dumps");
 }
 
+void TestPluginSignalsReadyAfterCapabilityBlock()
+{
+  const auto impl = ReadFile("plugin/src/SharedMemory.cpp");
+  const auto initBody = ExtractFunctionBody(impl, "bool InitSharedMemory(");
+  AssertOrdered(
+    initBody,
+    "CreateEventW(nullptr, /*bManualReset=*/TRUE, /*bInitialState=*/FALSE, readyEventName.c_str())",
+    "CreateFileMappingW(",
+    "The ready event must exist before the mapping so an early helper can wait on it.");
+  AssertOrdered(
+    initBody,
+    "g_crashEvent = CreateEventW(",
+    "SetEvent(g_readyEvent)",
+    "The ready event must only fire once the crash event exists.");
+  AssertOrdered(
+    initBody,
+    "g_shared->header.capabilities_offset",
+    "SetEvent(g_readyEvent)",
+    "The capability block must be published before the ready event fires.");
+
+  const auto attach = ReadFile("helper/src/ProcessAttach.cpp");
+  assert(attach.find("skydiag::NegotiateProtocol(") != std::string::npos);
+}
+
 void TestAnalyzerHasPluginSidecarFallback()
 {
   const auto impl = ReadFile("dump_tool/src/Analyzer.cpp");
@@ -115,6 +139,7 @@ int main()
   TestCrashPathIsDumpFirst();
   TestCrashPathWritesPluginScanSidecar();
   TestCrashSeqlockProtocolVersionAndDumpCompatibility();
+  TestPluginSignalsReadyAfterCapabilityBlock();
   TestAnalyzerHasPluginSidecarFallback();
   return 0;
 }
@@ -0,0 +1,296 @@
+#include "SkyrimDiagHelper/PostProcessQueue.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using skydiag::helper::PostProcessCancelFlag;
+using skydiag::helper::PostProcessJob;
+using skydiag::helper::PostProcessJobId;
+using skydiag::helper::PostProcessJobState;
+using skydiag::helper::PostProcessPriority;
+using skydiag::helper::PostProcessQueue;
+
+namespace {
+
+constexpr auto kWait = std::chrono::seconds(10);
+
+struct Gate
+{
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool open = false;
+
+  void Open()
+  {
+    {
+      std::lock_guard lock(mutex);
+      open = true;
+    }
+    cv.notify_all();
+  }
+
+  void Wait()
+  {
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [this]() { return open; });
+  }
+};
+
+struct Trace
+{
+  std::mutex mutex;
+  std::vector<std::string> order;
+
+  void Add(const std::string& name)
+  {
+    std::lock_guard lock(mutex);
+    order.push_back(name);
+  }
+};
+
+PostProcessJob MakeJob(
+  std::string name,
+  PostProcessPriority priority,
+  Trace* trace,
+  std::vector<PostProcessJobId> deps = {},
+  Gate* gate = nullptr)
+{
+  PostProcessJob job{};
+  job.name = name;
+  job.priority = priority;
+  job.dependsOn = std::move(deps);
+  job.run = [name, trace, gate](const PostProcessCancelFlag&) {
+    if (gate) {
+      gate->Wait();
+    }
+    trace->Add(name);
+    return true;
+  };
+  return job;
+}
+
+void TestReadyJobsRunByPriorityThenSubmissionOrder()
+{
+  PostProcessQueue queue(1);
+  Trace trace;
+  Gate gate;
+
+  // Occupy the single worker so the rest queue up behind it.
+  queue.Enqueue(MakeJob("blocker", PostProcessPriority::kCrash, &trace, {}, &gate));
+  while (queue.Stats().maxConcurrent == 0) {
+    std::this_thread::yield();
+  }
+  queue.Enqueue(MakeJob("maintenance", PostProcessPriority::kMaintenance, &trace));
+  queue.Enqueue(MakeJob("hang1", PostProcessPriority::kHang, &trace));
+  queue.Enqueue(MakeJob("crash", PostProcessPriority::kCrash, &trace));
+  queue.Enqueue(MakeJob("hang2", PostProcessPriority::kHang, &trace));
+  gate.Open();
+
+  assert(queue.WaitIdle(kWait));
+  const std::vector<std::string> expected{ "blocker", "crash", "hang1", "hang2", "maintenance" };
+  assert(trace.order == expected);
+}
+
+void TestDependenciesHoldJobsUntilFinished()
+{
+  PostProcessQueue queue(4);
+  Trace trace;
+
+  const auto analysis = queue.EnqueueExternal("analysis", PostProcessPriority::kCrash);
+  const auto retention = queue.Enqueue(MakeJob("retention", PostProcessPriority::kMaintenance, &trace, { analysis }));
+  const auto unrelated = queue.Enqueue(MakeJob("unrelated", PostProcessPriority::kMaintenance, &trace));
+
+  assert(!queue.WaitIdle(std::chrono::milliseconds(50)));
+  assert(queue.State(unrelated) == PostProcessJobState::kSucceeded);
+  assert(queue.State(retention) == PostProcessJobState::kPending);
+  assert(queue.State(analysis) == PostProcessJobState::kRunning);
+
+  // A failed dependency still releases its dependents.
+  queue.Complete(analysis, /*succeeded=*/false);
+  assert(queue.WaitIdle(kWait));
+  assert(queue.State(analysis) == PostProcessJobState::kFailed);
+  assert(queue.State(retention) == PostProcessJobState::kSucceeded);
+  assert(trace.order.back() == "retention");
+}
+
+void TestChainRunsInDependencyOrderAcrossWorkers()
+{
+  PostProcessQueue queue(4);
+  Trace trace;
+
+  const auto identity = queue.Enqueue(MakeJob("identity", PostProcessPriority::kMaintenance, &trace));
+  const auto analysis = queue.Enqueue(MakeJob("analysis", PostProcessPriority::kMaintenance, &trace, { identity }));
+  queue.Enqueue(MakeJob("retention", PostProcessPriority::kCrash, &trace, { analysis }));
+
+  assert(queue.WaitIdle(kWait));
+  const std::vector<std::string> expected{ "identity", "analysis", "retention" };
+  assert(trace.order == expected);
+}
+
+void TestConcurrencyIsBounded()
+{
+  PostProcessQueue queue(2);
+  std::atomic<int> running{ 0 };
+  std::atomic<int> peak{ 0 };
+
+  for (int i = 0; i < 8; ++i) {
+    PostProcessJob job{};
+    job.name = "job";
+    job.run = [&running, &peak](const PostProcessCancelFlag&) {
+      const int now = ++running;
+      int seen = peak.load();
+      while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      --running;
+      return true;
+    };
+    queue.Enqueue(std::move(job));
+  }
+
+  assert(queue.WaitIdle(kWait));
+  assert(peak.load() <= 2);
+  assert(queue.Stats().maxConcurrent <= 2);
+  assert(queue.Stats().succeeded == 8);
+}
+
+void TestPendingJobsCoalesceByKey()
+{
+  PostProcessQueue queue(1);
+  Trace trace;
+
+  const auto external = queue.EnqueueExternal("analysis", PostProcessPriority::kCrash);
+  auto first = MakeJob("sweep_old", PostProcessPriority::kMaintenance, &trace, { external });
+  first.coalesceKey = "retention:out";
+  auto second = MakeJob("sweep_new", PostProcessPriority::kHang, &trace);
+  second.coalesceKey = "retention:out";
+
+  const auto firstId = queue.Enqueue(std::move(first));
+  const auto secondId = queue.Enqueue(std::move(second));
+  assert(firstId == secondId);
+  assert(queue.Stats().coalesced == 1);
+
+  // The merged job keeps the older dependency.
+  assert(!queue.WaitIdle(std::chrono::milliseconds(50)));
+  queue.Complete(external, true);
+  assert(queue.WaitIdle(kWait));
+  const std::vector<std::string> expected{ "sweep_new" };
+  assert(trace.order == expected);
+}
+
+void TestCoalescingNeverCreatesCycles()
+{
+  PostProcessQueue queue(1);
+  Trace trace;
+
+  const auto external = queue.EnqueueExternal("analysis", PostProcessPriority::kCrash);
+  auto sweep = MakeJob("sweep", PostProcessPriority::kMaintenance, &trace, { external });
+  sweep.coalesceKey = "k";
+  const auto sweepId = queue.Enqueue(std::move(sweep));
+  const auto later = queue.Enqueue(MakeJob("later", PostProcessPriority::kMaintenance, &trace, { sweepId }));
+
+  // Depending on a newer job cannot fold into the older sweep.
+  auto again = MakeJob("again", PostProcessPriority::kMaintenance, &trace, { later });
+  again.coalesceKey = "k";
+  const auto againId = queue.Enqueue(std::move(again));
+  assert(againId != sweepId);
+
+  queue.Complete(external, true);
+  assert(queue.WaitIdle(kWait));
+  const std::vector<std::string> expected{ "sweep", "later", "again" };
+  assert(trace.order == expected);
+}
+
+void TestShutdownCancelsPendingAndSignalsRunning()
+{
+  PostProcessQueue queue(1);
+  std::atomic<bool> started{ false };
+  std::atomic<bool> sawCancel{ false };
+
+  PostProcessJob longJob{};
+  longJob.name = "long";
+  longJob.run = [&started, &sawCancel](const PostProcessCancelFlag& cancel) {
+    started = true;
+    while (!cancel.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    sawCancel = true;
+    return false;
+  };
+  const auto longId = queue.Enqueue(std::move(longJob));
+  while (!started.load()) {
+    std::this_thread::yield();
+  }
+
+  Trace trace;
+  const auto pending = queue.Enqueue(MakeJob("pending", PostProcessPriority::kCrash, &trace));
+  const auto external = queue.EnqueueExternal("analysis", PostProcessPriority::kCrash);
+
+  queue.Shutdown();
+  assert(sawCancel.load());
+  assert(trace.order.empty());
+  assert(queue.State(longId) == PostProcessJobState::kFailed);
+  assert(queue.State(pending) == PostProcessJobState::kCanceled);
+  assert(queue.State(external) == PostProcessJobState::kCanceled);
+  assert(queue.Stats().canceled == 2);
+
+  assert(queue.Enqueue(MakeJob("late", PostProcessPriority::kCrash, &trace)) == skydiag::helper::kNoPostProcessJob);
+  queue.Complete(external, true);  // no-op after shutdown
+  assert(queue.State(external) == PostProcessJobState::kCanceled);
+}
+
+void TestThrowingJobIsRecordedAsFailed()
+{
+  PostProcessQueue queue(1);
+  PostProcessJob job{};
+  job.name = "throws";
+  job.run = [](const PostProcessCancelFlag&) -> bool { throw std::runtime_error("boom"); };
+  const auto id = queue.Enqueue(std::move(job));
+  assert(queue.WaitIdle(kWait));
+  assert(queue.State(id) == PostProcessJobState::kFailed);
+  assert(queue.State(id + 100) == PostProcessJobState::kUnknown);
+}
+
+void TestWaitForReturnsWhenOneJobFinishes()
+{
+  PostProcessQueue queue(2);
+  Trace trace;
+  Gate slowGate;
+  const auto slow = queue.Enqueue(MakeJob("slow", PostProcessPriority::kMaintenance, &trace, {}, &slowGate));
+  const auto fast = queue.Enqueue(MakeJob("fast", PostProcessPriority::kCrash, &trace));
+  const auto external = queue.EnqueueExternal("analysis", PostProcessPriority::kCrash);
+
+  assert(queue.WaitFor(fast, kWait));
+  assert(queue.State(fast) == PostProcessJobState::kSucceeded);
+  assert(!queue.WaitFor(slow, std::chrono::milliseconds(20)));
+  assert(!queue.WaitFor(external, std::chrono::milliseconds(20)));
+
+  queue.Complete(external, false);
+  assert(queue.WaitFor(external, kWait));
+  slowGate.Open();
+  assert(queue.WaitFor(slow, kWait));
+  assert(queue.WaitFor(skydiag::helper::kNoPostProcessJob, std::chrono::milliseconds(0)));
+}
+
+}  // namespace
+
+int main()
+{
+  TestReadyJobsRunByPriorityThenSubmissionOrder();
+  TestDependenciesHoldJobsUntilFinished();
+  TestChainRunsInDependencyOrderAcrossWorkers();
+  TestConcurrencyIsBounded();
+  TestPendingJobsCoalesceByKey();
+  TestCoalescingNeverCreatesCycles();
+  TestShutdownCancelsPendingAndSignalsRunning();
+  TestThrowingJobIsRecordedAsFailed();
+  TestWaitForReturnsWhenOneJobFinishes();
+  return 0;
+}
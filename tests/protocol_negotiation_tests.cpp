@@ -0,0 +1,125 @@
+#include "SkyrimDiagCapabilities.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+using skydiag::NegotiateProtocol;
+using skydiag::ProtocolNegotiationStatus;
+using skydiag::SharedCapabilities;
+
+namespace {
+
+constexpr std::uint32_t kVersion = 4;
+constexpr std::uint64_t kLayoutHash = skydiag::ComputeLayoutHash({ 64, 65536, 256 });
+constexpr std::uint32_t kEvents = 65536;
+constexpr std::uint32_t kResources = 256;
+
+SharedCapabilities MakeCaps(std::uint64_t features)
+{
+  SharedCapabilities caps{};
+  caps.features = features;
+  caps.layout_hash = kLayoutHash;
+  caps.event_capacity = kEvents;
+  caps.resource_capacity = kResources;
+  caps.resource_path_max_bytes = 260;
+  return caps;
+}
+
+void TestLegacyMappingIsAcceptedWithoutFeatures()
+{
+  const auto r = NegotiateProtocol(kVersion, kVersion, std::nullopt, kLayoutHash, kEvents, kResources, ~0ull);
+  assert(r.status == ProtocolNegotiationStatus::kAcceptedLegacy);
+  assert(r.features == 0);
+  assert(skydiag::IsProtocolAccepted(r));
+}
+
+void TestVersionMismatchIsRejectedBeforeCapabilities()
+{
+  const auto r = NegotiateProtocol(5, kVersion, MakeCaps(skydiag::kFeature_ReadyEvent), kLayoutHash, kEvents, kResources, ~0ull);
+  assert(r.status == ProtocolNegotiationStatus::kVersionMismatch);
+  assert(!skydiag::IsProtocolAccepted(r));
+}
+
+void TestFeaturesAreIntersectedAndUnknownBitsIgnored()
+{
+  const std::uint64_t futureBit = 1ull << 40;
+  const auto caps = MakeCaps(skydiag::kFeature_ReadyEvent | skydiag::kFeature_HitchHistogram | futureBit);
+  const auto r = NegotiateProtocol(
+    kVersion, kVersion, caps, kLayoutHash, kEvents, kResources, skydiag::kFeature_ReadyEvent);
+  assert(r.status == ProtocolNegotiationStatus::kAccepted);
+  assert(r.features == skydiag::kFeature_ReadyEvent);
+}
+
+void TestLayoutAndCapacityMismatchAreRejected()
+{
+  auto caps = MakeCaps(skydiag::kFeature_ReadyEvent);
+  caps.layout_hash ^= 1u;
+  assert(NegotiateProtocol(kVersion, kVersion, caps, kLayoutHash, kEvents, kResources, ~0ull).status ==
+         ProtocolNegotiationStatus::kLayoutMismatch);
+
+  caps = MakeCaps(skydiag::kFeature_ReadyEvent);
+  caps.event_capacity = kEvents / 2;
+  assert(NegotiateProtocol(kVersion, kVersion, caps, kLayoutHash, kEvents, kResources, ~0ull).status ==
+         ProtocolNegotiationStatus::kLayoutMismatch);
+}
+
+void TestRequiredFeatures()
+{
+  const auto required = skydiag::kFeature_ShardedEventRings;
+  assert(NegotiateProtocol(kVersion, kVersion, std::nullopt, kLayoutHash, kEvents, kResources, ~0ull, required).status ==
+         ProtocolNegotiationStatus::kMissingRequiredFeature);
+  assert(NegotiateProtocol(
+           kVersion, kVersion, MakeCaps(skydiag::kFeature_ReadyEvent), kLayoutHash, kEvents, kResources, ~0ull, required)
+           .status == ProtocolNegotiationStatus::kMissingRequiredFeature);
+  const auto ok = NegotiateProtocol(
+    kVersion, kVersion, MakeCaps(required), kLayoutHash, kEvents, kResources, ~0ull, required);
+  assert(ok.status == ProtocolNegotiationStatus::kAccepted);
+  assert(ok.features == required);
+}
+
+void TestReadCapabilitiesBounds()
+{
+  constexpr std::uint32_t kOffset = 128;
+  std::vector<std::uint8_t> mapping(kOffset + sizeof(SharedCapabilities), 0);
+  const auto caps = MakeCaps(skydiag::kFeature_ReadyEvent);
+  std::memcpy(mapping.data() + kOffset, &caps, sizeof(caps));
+
+  const auto read = skydiag::TryReadSharedCapabilities(mapping.data(), mapping.size(), kOffset);
+  assert(read.has_value());
+  assert(read->features == skydiag::kFeature_ReadyEvent);
+  assert(read->layout_hash == kLayoutHash);
+
+  // Older plugins leave the header fields zero.
+  assert(!skydiag::TryReadSharedCapabilities(mapping.data(), mapping.size(), 0).has_value());
+  // Block announced past the end of what was actually mapped.
+  assert(!skydiag::TryReadSharedCapabilities(mapping.data(), mapping.size() - 1, kOffset).has_value());
+  assert(!skydiag::TryReadSharedCapabilities(mapping.data(), kOffset / 2, kOffset).has_value());
+  assert(!skydiag::TryReadSharedCapabilities(nullptr, mapping.size(), kOffset).has_value());
+
+  mapping[kOffset] ^= 0xFFu;  // corrupt magic
+  assert(!skydiag::TryReadSharedCapabilities(mapping.data(), mapping.size(), kOffset).has_value());
+}
+
+void TestLayoutHashIsOrderSensitive()
+{
+  static_assert(skydiag::ComputeLayoutHash({ 1, 2 }) != skydiag::ComputeLayoutHash({ 2, 1 }));
+  static_assert(skydiag::ComputeLayoutHash({ 64 }) == skydiag::ComputeLayoutHash({ 64 }));
+}
+
+}  // namespace
+
+int main()
+{
+  TestLegacyMappingIsAcceptedWithoutFeatures();
+  TestVersionMismatchIsRejectedBeforeCapabilities();
+  TestFeaturesAreIntersectedAndUnknownBitsIgnored();
+  TestLayoutAndCapacityMismatchAreRejected();
+  TestRequiredFeatures();
+  TestReadCapabilitiesBounds();
+  TestLayoutHashIsOrderSensitive();
+  return 0;
+}
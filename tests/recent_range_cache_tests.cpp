@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "RecentRangeCache.h"
+
+using skydiag::dump_tool::minidump::RecentRangeCache;
+
+namespace {
+
+struct Range
+{
+  std::uint64_t start = 0;
+  std::uint64_t end = 0;
+};
+
+const auto kStartOf = [](const Range& r) { return r.start; };
+const auto kContains = [](const Range& r, std::uint64_t a) { return a >= r.start && a < r.end; };
+
+// The lookup the cache stands in for.
+std::size_t Reference(const std::vector<Range>& ranges, std::uint64_t addr)
+{
+  const auto it = std::upper_bound(ranges.begin(), ranges.end(), addr, [](std::uint64_t v, const Range& r) {
+    return v < r.start;
+  });
+  if (it == ranges.begin() || addr >= (it - 1)->end) {
+    return RecentRangeCache::kNone;
+  }
+  return static_cast<std::size_t>(it - ranges.begin()) - 1u;
+}
+
+std::vector<Range> RandomRanges(std::mt19937_64& rng, std::size_t count)
+{
+  std::vector<Range> ranges;
+  std::uint64_t cursor = 0x10000;
+  for (std::size_t i = 0; i < count; ++i) {
+    cursor += (rng() % 4) * 0x1000;  // sometimes adjacent
+    const std::uint64_t size = 0x1000 * (1 + rng() % 16);
+    ranges.push_back({ cursor, cursor + size });
+    cursor += size;
+  }
+  return ranges;
+}
+
+void TestMatchesBinarySearch()
+{
+  std::mt19937_64 rng(7);
+  const auto ranges = RandomRanges(rng, 500);
+  const std::uint64_t lo = ranges.front().start - 0x2000;
+  const std::uint64_t hi = ranges.back().end + 0x2000;
+
+  RecentRangeCache cache;
+  // Mix of stack-walk-like locality (a few hot ranges, sequential offsets)
+  // and uniform probes, including gaps and out-of-table addresses.
+  std::vector<std::uint64_t> hot;
+  for (int i = 0; i < 6; ++i) {
+    hot.push_back(ranges[rng() % ranges.size()].start);
+  }
+  for (int i = 0; i < 200000; ++i) {
+    std::uint64_t addr = 0;
+    switch (rng() % 3) {
+      case 0: addr = lo + rng() % (hi - lo); break;
+      case 1: addr = hot[rng() % hot.size()] + (i % 0x1000); break;
+      default: addr = hot[0] + static_cast<std::uint64_t>(i % 0x800) * 8; break;
+    }
+    assert(cache.Find(ranges, addr, kStartOf, kContains) == Reference(ranges, addr));
+  }
+}
+
+void TestOverlappingTableKeepsPredecessorSemantics()
+{
+  // Malformed: the second range starts inside the first.
+  const std::vector<Range> ranges = { { 0x1000, 0x3000 }, { 0x2000, 0x2800 }, { 0x5000, 0x6000 } };
+  RecentRangeCache cache;
+  for (const std::uint64_t addr : { 0x1800ull, 0x2100ull, 0x1800ull, 0x2900ull, 0x2100ull, 0x5000ull, 0x4000ull }) {
+    assert(cache.Find(ranges, addr, kStartOf, kContains) == Reference(ranges, addr));
+  }
+}
+
+void TestResetAndCopies()
+{
+  std::vector<Range> ranges = { { 0x1000, 0x2000 }, { 0x4000, 0x5000 } };
+  RecentRangeCache cache;
+  assert(cache.Find(ranges, 0x4100, kStartOf, kContains) == 1u);
+
+  // A replaced table with fewer entries must not be answered from stale slots.
+  ranges = { { 0x4000, 0x4010 } };
+  cache.Reset();
+  assert(cache.Find(ranges, 0x4100, kStartOf, kContains) == RecentRangeCache::kNone);
+  assert(cache.Find(ranges, 0x4008, kStartOf, kContains) == 0u);
+
+  const RecentRangeCache copy = cache;
+  assert(copy.Find(ranges, 0x4008, kStartOf, kContains) == 0u);
+  assert(copy.Find(ranges, 0x3000, kStartOf, kContains) == RecentRangeCache::kNone);
+}
+
+void TestConcurrentReaders()
+{
+  std::mt19937_64 seedRng(11);
+  const auto ranges = RandomRanges(seedRng, 200);
+  const std::uint64_t lo = ranges.front().start;
+  const std::uint64_t hi = ranges.back().end;
+  RecentRangeCache shared;
+  std::atomic<int> mismatches{ 0 };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      std::mt19937_64 rng(100 + t);
+      for (int i = 0; i < 50000; ++i) {
+        const std::uint64_t addr = lo + rng() % (hi - lo);
+        if (shared.Find(ranges, addr, kStartOf, kContains) != Reference(ranges, addr)) {
+          mismatches.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  assert(mismatches.load() == 0);
+}
+
+}  // namespace
+
+int main()
+{
+  TestMatchesBinarySearch();
+  TestOverlappingTableKeepsPredecessorSemantics();
+  TestResetAndCopies();
+  TestConcurrentReaders();
+  return 0;
+}
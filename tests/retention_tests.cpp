@@ -187,6 +187,76 @@ static void Test_PrunesCrashManifestWithPrecisionTimestamp()
   assert(Exists(dir / manifest1));
 }
 
+static void Test_CountsThinAndEnrichedCrashDumpsAsOneIncident()
+{
+  const auto dir = MakeTempDir();
+
+  // Two two-phase incidents and one single-dump incident; keep newest 2.
+  const auto stem0 = std::string("SkyrimDiag_Crash_20260101_050000");
+  const auto stem1 = std::string("SkyrimDiag_Crash_20260101_050001");
+  const auto stem2 = std::string("SkyrimDiag_Crash_20260101_050002");
+  const auto manifest0 = std::string("SkyrimDiag_Incident_Crash_20260101_050000.json");
+
+  WriteFile(dir / (stem0 + ".dmp"));
+  WriteFile(dir / (stem0 + "_Enriched.dmp"));
+  WriteFile(dir / (stem0 + "_Enriched_SkyrimDiagSummary.json"));
+  WriteFile(dir / manifest0);
+  WriteFile(dir / (stem1 + ".dmp"));
+  WriteFile(dir / (stem1 + "_Enriched.dmp"));
+  WriteFile(dir / (stem2 + ".dmp"));
+
+  RetentionLimits limits{};
+  limits.maxCrashDumps = 2;
+  limits.maxHangDumps = 0;
+  limits.maxManualDumps = 0;
+  limits.maxEtwTraces = 0;
+  ApplyRetentionToOutputDir(dir, limits);
+
+  // The oldest incident goes as a whole...
+  assert(!Exists(dir / (stem0 + ".dmp")));
+  assert(!Exists(dir / (stem0 + "_Enriched.dmp")));
+  assert(!Exists(dir / (stem0 + "_Enriched_SkyrimDiagSummary.json")));
+  assert(!Exists(dir / manifest0));
+  // ...and both remaining incidents keep both of their dumps.
+  assert(Exists(dir / (stem1 + ".dmp")));
+  assert(Exists(dir / (stem1 + "_Enriched.dmp")));
+  assert(Exists(dir / (stem2 + ".dmp")));
+}
+
+static void Test_KeepsDeltaRecaptureWithItsBaseDump()
+{
+  const auto dir = MakeTempDir();
+
+  // Deltas are named after their base (thin or enriched) and carry a later
+  // timestamp of their own; they must neither count as a separate incident
+  // nor outlive the base they overlay. Keep newest 1.
+  const auto stem0 = std::string("SkyrimDiag_Crash_20260101_060000");
+  const auto stem1 = std::string("SkyrimDiag_Crash_20260101_060001");
+  const auto delta0 = stem0 + "_Delta_20260101_060105_Recapture.dmp";
+  const auto delta1 = stem1 + "_Enriched_Delta_20260101_060106_Recapture.dmp";
+
+  WriteFile(dir / (stem0 + ".dmp"));
+  WriteFile(dir / delta0);
+  WriteFile(dir / (stem0 + "_Delta_20260101_060105_Recapture_SkyrimDiagSummary.json"));
+  WriteFile(dir / (stem1 + ".dmp"));
+  WriteFile(dir / (stem1 + "_Enriched.dmp"));
+  WriteFile(dir / delta1);
+
+  RetentionLimits limits{};
+  limits.maxCrashDumps = 1;
+  limits.maxHangDumps = 0;
+  limits.maxManualDumps = 0;
+  limits.maxEtwTraces = 0;
+  ApplyRetentionToOutputDir(dir, limits);
+
+  assert(!Exists(dir / (stem0 + ".dmp")));
+  assert(!Exists(dir / delta0));
+  assert(!Exists(dir / (stem0 + "_Delta_20260101_060105_Recapture_SkyrimDiagSummary.json")));
+  assert(Exists(dir / (stem1 + ".dmp")));
+  assert(Exists(dir / (stem1 + "_Enriched.dmp")));
+  assert(Exists(dir / delta1));
+}
+
 static void Test_RotatesHelperLog()
 {
   const auto dir = MakeTempDir();
@@ -207,6 +277,8 @@ int main()
   Test_KeepsCrashManifestWhenSiblingDumpSharesTimestamp();
   Test_PrunesEtwTracesAcrossCrashAndHangPrefixes();
   Test_PrunesCrashManifestWithPrecisionTimestamp();
+  Test_CountsThinAndEnrichedCrashDumpsAsOneIncident();
+  Test_KeepsDeltaRecaptureWithItsBaseDump();
   Test_RotatesHelperLog();
   return 0;
 }
@@ -0,0 +1,75 @@
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "SkyrimDiagHelper/SeqlockRing.h"
+
+using skydiag::helper::IsSeqlockRingQuiescent;
+
+namespace {
+
+struct FakeEntry
+{
+  std::uint32_t seq = 0;
+};
+
+// Mirrors the plugin writer: claim idx, commit with seq = idx * 2.
+void Commit(std::vector<FakeEntry>& ring, std::uint32_t idx)
+{
+  ring[idx % ring.size()].seq = idx * 2u;
+}
+
+void TestEmptyAndPartiallyFilledRings()
+{
+  std::vector<FakeEntry> ring(8);
+  assert(IsSeqlockRingQuiescent(ring.data(), 8, 0));
+  for (std::uint32_t i = 0; i < 5; ++i) {
+    Commit(ring, i);
+  }
+  assert(IsSeqlockRingQuiescent(ring.data(), 8, 5));
+  assert(!IsSeqlockRingQuiescent(ring.data(), 0, 5));
+  assert(!IsSeqlockRingQuiescent<FakeEntry>(nullptr, 8, 5));
+}
+
+void TestWrappedRingNeedsLatestGeneration()
+{
+  std::vector<FakeEntry> ring(4);
+  for (std::uint32_t i = 0; i < 10; ++i) {
+    Commit(ring, i);
+  }
+  assert(IsSeqlockRingQuiescent(ring.data(), 4, 10));
+
+  // Slot 9 % 4 still holding generation 5: claimed but not yet written.
+  ring[1].seq = 5u * 2u;
+  assert(!IsSeqlockRingQuiescent(ring.data(), 4, 10));
+}
+
+void TestWriterMidEntryIsNotQuiescent()
+{
+  std::vector<FakeEntry> ring(4);
+  for (std::uint32_t i = 0; i < 3; ++i) {
+    Commit(ring, i);
+  }
+  ring[2].seq = (2u * 2u) | 1u;
+  assert(!IsSeqlockRingQuiescent(ring.data(), 4, 3));
+}
+
+void TestClaimedButUnwrittenSlot()
+{
+  std::vector<FakeEntry> ring(4);
+  Commit(ring, 0);
+  Commit(ring, 1);
+  // write_index bumped to 3 but slot 2 still zero.
+  assert(!IsSeqlockRingQuiescent(ring.data(), 4, 3));
+}
+
+}  // namespace
+
+int main()
+{
+  TestEmptyAndPartiallyFilledRings();
+  TestWrappedRingNeedsLatestGeneration();
+  TestWriterMidEntryIsNotQuiescent();
+  TestClaimedButUnwrittenSlot();
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Sha256.h"
+
+using skydiag::dump_tool::ComputeSha256;
+using skydiag::dump_tool::ComputeTreeSha256;
+using skydiag::dump_tool::Sha256;
+using skydiag::dump_tool::Sha256Digest;
+using skydiag::dump_tool::Sha256ForceScalarForTesting;
+using skydiag::dump_tool::Sha256HardwareAccelerated;
+using skydiag::dump_tool::Sha256HexLower;
+
+namespace {
+
+std::string Hex(const std::string& s)
+{
+  return Sha256HexLower(ComputeSha256(s.data(), s.size()));
+}
+
+std::vector<std::uint8_t> RandomBytes(std::size_t n, std::uint32_t seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<std::uint8_t> out(n);
+  for (auto& b : out) {
+    b = static_cast<std::uint8_t>(rng());
+  }
+  return out;
+}
+
+// FIPS 180-4 / NIST CSHS example vectors.
+void CheckKnownVectors()
+{
+  assert(Hex("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  assert(Hex("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  assert(Hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+    "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  assert(Hex("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu") ==
+    "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1");
+
+  Sha256 h;
+  const std::string chunk(1000, 'a');
+  for (int i = 0; i < 1000; ++i) {
+    h.Update(chunk.data(), chunk.size());
+  }
+  assert(Sha256HexLower(h.Finish()) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+void TestKnownVectors()
+{
+  CheckKnownVectors();
+  if (Sha256HardwareAccelerated()) {
+    Sha256ForceScalarForTesting(true);
+    assert(!Sha256HardwareAccelerated());
+    CheckKnownVectors();
+    Sha256ForceScalarForTesting(false);
+  }
+}
+
+void TestStreamingMatchesOneShot()
+{
+  const auto data = RandomBytes(4096 + 77, 1);
+  const auto expected = ComputeSha256(data.data(), data.size());
+  for (const std::size_t step : { 1u, 3u, 55u, 63u, 64u, 65u, 1000u }) {
+    Sha256 h;
+    for (std::size_t off = 0; off < data.size(); off += step) {
+      h.Update(data.data() + off, std::min(step, data.size() - off));
+    }
+    assert(h.Finish() == expected);
+  }
+
+  // Finish() resets, so the object is reusable.
+  Sha256 h;
+  h.Update("x", 1);
+  (void)h.Finish();
+  h.Update("abc", 3);
+  assert(Sha256HexLower(h.Finish()) == Hex("abc"));
+}
+
+// Every padding boundary around the 55/56/64-byte edges, scalar vs the
+// accelerated block function when this CPU has one.
+void TestAcceleratedMatchesScalar()
+{
+  if (!Sha256HardwareAccelerated()) {
+    return;
+  }
+  const auto data = RandomBytes(1 << 16, 2);
+  for (std::size_t n = 0; n < 300; ++n) {
+    const auto fast = ComputeSha256(data.data(), n);
+    Sha256ForceScalarForTesting(true);
+    const auto slow = ComputeSha256(data.data(), n);
+    Sha256ForceScalarForTesting(false);
+    assert(fast == slow);
+  }
+  const auto fast = ComputeSha256(data.data(), data.size());
+  Sha256ForceScalarForTesting(true);
+  const auto slow = ComputeSha256(data.data(), data.size());
+  Sha256ForceScalarForTesting(false);
+  assert(fast == slow);
+}
+
+Sha256Digest ReferenceTree(const std::vector<std::uint8_t>& data, std::size_t leafBytes)
+{
+  Sha256 root;
+  std::uint8_t header[17]{};
+  header[0] = 0x01;
+  for (int i = 0; i < 8; ++i) {
+    header[1 + i] = static_cast<std::uint8_t>(static_cast<std::uint64_t>(leafBytes) >> (i * 8));
+    header[9 + i] = static_cast<std::uint8_t>(static_cast<std::uint64_t>(data.size()) >> (i * 8));
+  }
+  root.Update(header, sizeof(header));
+  for (std::size_t off = 0; off < data.size(); off += leafBytes) {
+    Sha256 leaf;
+    const std::uint8_t prefix = 0x00;
+    leaf.Update(&prefix, 1);
+    leaf.Update(data.data() + off, std::min(leafBytes, data.size() - off));
+    const auto digest = leaf.Finish();
+    root.Update(digest.data(), digest.size());
+  }
+  return root.Finish();
+}
+
+void TestTreeHash()
+{
+  constexpr std::size_t kLeaf = 4096;
+  const auto data = RandomBytes(kLeaf * 37 + 123, 3);
+
+  const auto serial = ComputeTreeSha256(data.data(), data.size(), kLeaf, 1);
+  assert(serial == ReferenceTree(data, kLeaf));
+  for (const unsigned workers : { 0u, 2u, 4u, 64u }) {
+    assert(ComputeTreeSha256(data.data(), data.size(), kLeaf, workers) == serial);
+  }
+
+  // Not the flat digest, and bound to the leaf size and every byte.
+  assert(serial != ComputeSha256(data.data(), data.size()));
+  assert(ComputeTreeSha256(data.data(), data.size(), kLeaf * 2, 4) != serial);
+  auto flipped = data;
+  flipped[kLeaf * 20 + 5] ^= 1u;
+  assert(ComputeTreeSha256(flipped.data(), flipped.size(), kLeaf, 4) != serial);
+
+  // Exact multiple of the leaf size, a single short leaf, and empty input.
+  const std::vector<std::uint8_t> exact(data.begin(), data.begin() + kLeaf * 8);
+  assert(ComputeTreeSha256(exact.data(), exact.size(), kLeaf, 3) == ReferenceTree(exact, kLeaf));
+  const std::vector<std::uint8_t> small(data.begin(), data.begin() + 10);
+  assert(ComputeTreeSha256(small.data(), small.size(), kLeaf, 3) == ReferenceTree(small, kLeaf));
+  const std::vector<std::uint8_t> empty;
+  assert(ComputeTreeSha256(nullptr, 0, kLeaf, 3) == ReferenceTree(empty, kLeaf));
+}
+
+}  // namespace
+
+int main()
+{
+  TestKnownVectors();
+  TestStreamingMatchesOneShot();
+  TestAcceleratedMatchesScalar();
+  TestTreeHash();
+  return 0;
+}
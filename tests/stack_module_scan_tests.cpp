@@ -0,0 +1,116 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "ModuleAddressIndex.h"
+#include "StackModuleScan.h"
+
+using skydiag::dump_tool::minidump::ModuleAddressIndex;
+using skydiag::dump_tool::minidump::ScanStacksForModuleRefs;
+using skydiag::dump_tool::minidump::StackSlice;
+
+namespace {
+
+const std::vector<ModuleAddressIndex::Range> kModules = {
+  { 0x140000000ull, 0x143A00000ull },        // 0: exe
+  { 0x7FF8A0000000ull, 0x7FF8A0021000ull },  // 1: plugin
+  { 0x7FF8B0000000ull, 0x7FF8B0100000ull },  // 2: plugin
+  { 0x7FFF3C8E0000ull, 0x7FFF3CAED000ull },  // 3: ntdll
+};
+
+std::vector<std::uint8_t> Words(const std::vector<std::uint64_t>& words)
+{
+  std::vector<std::uint8_t> bytes(words.size() * sizeof(std::uint64_t));
+  std::memcpy(bytes.data(), words.data(), bytes.size());
+  return bytes;
+}
+
+void TestWholeStackRefs()
+{
+  const ModuleAddressIndex index(kModules);
+  // Module 2 only appears deep in the stack, past the old 32-slot window.
+  std::vector<std::uint64_t> deep(4096, 0x000000A1B2C3D000ull);
+  deep[3] = 0x7FFF3C8E1234ull;
+  deep[4000] = 0x7FF8B0000040ull;
+  const auto deepBytes = Words(deep);
+  const auto noiseBytes = Words({ 1, 2, 0xFFFFFFFFFFFFFFFFull, 0x7FF8A0021000ull /* end, exclusive */ });
+  const auto exeBytes = Words({ 0x140001000ull, 0x140001000ull, 0x7FF8A0000010ull });
+
+  const std::vector<StackSlice> slices = {
+    { 10, deepBytes.data(), deepBytes.size() },
+    { 11, noiseBytes.data(), noiseBytes.size() },
+    { 12, exeBytes.data(), exeBytes.size() },
+    { 13, nullptr, 0 },
+  };
+  const auto refs = ScanStacksForModuleRefs(index, slices, 1);
+  assert(refs.size() == 4);
+  assert(refs[0].tid == 10 && (refs[0].modules == std::vector<std::uint32_t>{ 2, 3 }));
+  assert(refs[1].tid == 11 && refs[1].modules.empty());
+  assert(refs[2].tid == 12 && (refs[2].modules == std::vector<std::uint32_t>{ 0, 1 }));
+  assert(refs[3].tid == 13 && refs[3].modules.empty());
+}
+
+void TestParallelMatchesSerial()
+{
+  const ModuleAddressIndex index(kModules);
+  std::mt19937_64 rng(44);
+  std::vector<std::vector<std::uint8_t>> stacks;
+  std::vector<StackSlice> slices;
+  // Enough bytes in total (> 1 MiB) that the worker path actually runs.
+  for (std::uint32_t t = 0; t < 48; ++t) {
+    std::vector<std::uint64_t> words(8192 + (rng() % 1024));
+    for (auto& w : words) {
+      w = (rng() % 512 == 0) ? kModules[rng() % kModules.size()].base + (rng() % 0x20000ull) : rng();
+    }
+    stacks.push_back(Words(words));
+  }
+  for (std::uint32_t t = 0; t < stacks.size(); ++t) {
+    // Odd start offsets: slices are not 8-byte aligned in real dumps either.
+    slices.push_back({ 100 + t, stacks[t].data() + (t % 8), stacks[t].size() - 8 });
+  }
+
+  const auto serial = ScanStacksForModuleRefs(index, slices, 1);
+  const auto parallel = ScanStacksForModuleRefs(index, slices, 4);
+  assert(serial.size() == parallel.size());
+  for (std::size_t i = 0; i < serial.size(); ++i) {
+    assert(serial[i].tid == slices[i].tid && parallel[i].tid == slices[i].tid);
+    assert(serial[i].modules == parallel[i].modules);
+  }
+}
+
+void TestBoundsMaskMatchesScalar()
+{
+  std::mt19937_64 rng(7);
+  for (int round = 0; round < 200; ++round) {
+    const std::uint64_t lo = rng();
+    const std::uint64_t span = rng() >> (rng() % 64);
+    std::uint64_t words[64];
+    for (auto& w : words) {
+      switch (rng() % 4) {
+        case 0: w = lo + (span ? rng() % span : 0); break;
+        case 1: w = lo - 1 - (rng() % 16); break;
+        case 2: w = lo + span + (rng() % 16); break;
+        default: w = rng(); break;
+      }
+    }
+    for (const std::size_t count : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 3 }, std::size_t{ 4 }, std::size_t{ 37 }, std::size_t{ 64 } }) {
+      std::uint64_t expected = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        expected |= static_cast<std::uint64_t>((words[i] - lo) < span) << i;
+      }
+      assert(ModuleAddressIndex::BoundsMask(words, count, lo, span) == expected);
+    }
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  TestWholeStackRefs();
+  TestParallelMatchesSerial();
+  TestBoundsMaskMatchesScalar();
+  return 0;
+}
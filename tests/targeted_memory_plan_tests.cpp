@@ -0,0 +1,174 @@
+#include "SkyrimDiagHelper/TargetedMemoryPlan.h"
+
+#include <cassert>
+#include <cstdint>
+
+using skydiag::helper::kRegion_Executable;
+using skydiag::helper::kRegion_Image;
+using skydiag::helper::kRegion_Writable;
+using skydiag::helper::kTargetedMemoryPageBytes;
+using skydiag::helper::MemoryRange;
+using skydiag::helper::MemoryRegionInfo;
+using skydiag::helper::PlanTargetedMemory;
+using skydiag::helper::TargetedMemoryInputs;
+using skydiag::helper::TargetedMemoryLimits;
+using skydiag::helper::TargetedMemoryPlan;
+
+namespace {
+
+constexpr std::uint64_t kPage = kTargetedMemoryPageBytes;
+
+// Fake address space:
+//   game.exe   0x140000000: .text (rx) 0x140001000..0x140101000, .data (rw) 0x140101000..0x140301000
+//   mod.dll    0x180000000: .text (rx) 0x180001000..0x180011000, .data (rw) 0x180011000..0x180013000
+//   heap       0x200000000..0x201000000 (rw)
+//   stack      0x300000000..0x300100000 (rw)
+constexpr std::uint64_t kGameBase = 0x140000000ull;
+constexpr std::uint64_t kModBase = 0x180000000ull;
+constexpr std::uint64_t kHeap = 0x200000000ull;
+constexpr std::uint64_t kStack = 0x300000000ull;
+
+TargetedMemoryInputs MakeInputs()
+{
+  TargetedMemoryInputs in{};
+  in.readableRegions = {
+    { kGameBase + 0x1000, 0x100000, kGameBase, kRegion_Image | kRegion_Executable },
+    { kGameBase + 0x101000, 0x200000, kGameBase, kRegion_Image | kRegion_Writable },
+    { kModBase + 0x1000, 0x10000, kModBase, kRegion_Image | kRegion_Executable },
+    { kModBase + 0x11000, 0x2000, kModBase, kRegion_Image | kRegion_Writable },
+    { kHeap, 0x1000000, kHeap, kRegion_Writable },
+    { kStack, 0x100000, kStack, kRegion_Writable },
+  };
+  in.stack = { kStack, 0x100000 };
+  return in;
+}
+
+bool Covers(const TargetedMemoryPlan& plan, std::uint64_t address)
+{
+  for (const auto& r : plan.ranges) {
+    if (address >= r.base && address - r.base < r.size) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AssertWellFormed(const TargetedMemoryPlan& plan)
+{
+  std::uint64_t total = 0;
+  std::uint64_t prevEnd = 0;
+  for (const auto& r : plan.ranges) {
+    assert(r.base % kPage == 0);
+    assert(r.size % kPage == 0 && r.size > 0);
+    assert(r.base > prevEnd || prevEnd == 0);  // sorted and coalesced
+    prevEnd = r.base + r.size;
+    total += r.size;
+  }
+  assert(total == plan.totalBytes);
+}
+
+void Test_FaultSiteRegistersAndArguments()
+{
+  auto in = MakeInputs();
+  in.instructionPointer = kModBase + 0x5000;
+  in.registers = { kHeap + 0x10000, 0x1234, kStack + 0x800 };
+  in.argumentRegisters = { kHeap + 0x80000 };
+
+  TargetedMemoryLimits limits{};
+  limits.maxModuleDataBytes = 0;
+  const auto plan = PlanTargetedMemory(in, limits);
+  AssertWellFormed(plan);
+
+  assert(Covers(plan, kModBase + 0x5000));
+  assert(Covers(plan, kModBase + 0x5000 - limits.registerWindowBytes));
+  assert(Covers(plan, kHeap + 0x10000));
+  assert(Covers(plan, kHeap + 0x80000 + limits.argumentWindowBytes - 1));
+  assert(!Covers(plan, 0x1234));           // not mapped
+  assert(!Covers(plan, kStack + 0x800));   // the stack is already in the dump
+}
+
+void Test_StackWordsPickPointersAndNominateModules()
+{
+  auto in = MakeInputs();
+  in.instructionPointer = kGameBase + 0x2000;
+  in.stackWords = {
+    0,
+    kHeap + 0x400000,      // data pointer
+    kModBase + 0x3000,     // return address into mod.dll
+    kStack + 0x40,         // frame pointer
+    0xDEADBEEF,
+  };
+  const auto plan = PlanTargetedMemory(in);
+  AssertWellFormed(plan);
+
+  assert(Covers(plan, kHeap + 0x400000));
+  assert(!Covers(plan, kStack + 0x40));
+  // Writable sections of the faulting module and of the return-address module.
+  assert(Covers(plan, kModBase + 0x11000));
+  assert(Covers(plan, kModBase + 0x12FFF));
+  assert(Covers(plan, kGameBase + 0x101000));
+  assert(!Covers(plan, kModBase + 0x8000));  // code of a module that is not the fault site
+}
+
+void Test_ModuleDataIsCappedPerModule()
+{
+  auto in = MakeInputs();
+  in.instructionPointer = kGameBase + 0x2000;
+  TargetedMemoryLimits limits{};
+  limits.maxModuleDataBytes = 0x10000;
+  const auto plan = PlanTargetedMemory(in, limits);
+  assert(Covers(plan, kGameBase + 0x101000));
+  assert(Covers(plan, kGameBase + 0x101000 + 0xFFFF));
+  assert(!Covers(plan, kGameBase + 0x101000 + 0x10000));
+}
+
+void Test_BudgetKeepsHighPriorityRanges()
+{
+  auto in = MakeInputs();
+  in.instructionPointer = kGameBase + 0x2000;
+  in.registers = { kHeap + 0x10000 };
+  for (std::uint64_t i = 0; i < 64; ++i) {
+    in.stackWords.push_back(kHeap + 0x100000 + i * 0x10000);
+  }
+
+  TargetedMemoryLimits limits{};
+  limits.totalBudgetBytes = 8 * kPage;
+  const auto plan = PlanTargetedMemory(in, limits);
+  AssertWellFormed(plan);
+
+  assert(plan.totalBytes == limits.totalBudgetBytes);
+  assert(plan.droppedForBudget > 0);
+  assert(Covers(plan, kGameBase + 0x2000));
+  assert(Covers(plan, kHeap + 0x10000));
+  assert(!Covers(plan, kGameBase + 0x101000));  // module data comes last
+}
+
+void Test_EmptyInputsPlanNothing()
+{
+  const auto plan = PlanTargetedMemory(TargetedMemoryInputs{});
+  assert(plan.ranges.empty());
+  assert(plan.totalBytes == 0);
+}
+
+void Test_HighAddressesDoNotWrap()
+{
+  TargetedMemoryInputs in{};
+  in.readableRegions = { { UINT64_MAX - 2 * kPage + 1, 2 * kPage, UINT64_MAX - 2 * kPage + 1, kRegion_Writable } };
+  in.instructionPointer = UINT64_MAX - 16;
+  in.registers = { UINT64_MAX - 16 };
+  const auto plan = PlanTargetedMemory(in);
+  assert(plan.totalBytes <= 2 * kPage);
+}
+
+}  // namespace
+
+int main()
+{
+  Test_FaultSiteRegistersAndArguments();
+  Test_StackWordsPickPointersAndNominateModules();
+  Test_ModuleDataIsCappedPerModule();
+  Test_BudgetKeepsHighPriorityRanges();
+  Test_EmptyInputsPlanNothing();
+  Test_HighAddressesDoNotWrap();
+  return 0;
+}
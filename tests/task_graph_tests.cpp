@@ -0,0 +1,216 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SourceGuardTestUtils.h"
+#include "TaskGraph.h"
+
+using skydiag::dump_tool::TaskGraph;
+using skydiag::tests::source_guard::ReadProjectText;
+
+namespace {
+
+void TestDependenciesRunInOrder()
+{
+  for (const unsigned workers : { 0u, 1u, 4u }) {
+    std::mutex m;
+    std::vector<std::string> order;
+    const auto log = [&](const char* s) {
+      return [&, s]() {
+        std::lock_guard lock(m);
+        order.emplace_back(s);
+      };
+    };
+
+    TaskGraph graph(workers);
+    const auto a = graph.Add("a", log("a"));
+    const auto b = graph.Add("b", log("b"), { a });
+    const auto c = graph.Add("c", log("c"), { a });
+    const auto d = graph.Add("d", log("d"), { b, c });
+    graph.Start();
+    graph.Wait(d);
+
+    assert(order.size() == 4);
+    assert(order.front() == "a" && order.back() == "d");
+    graph.WaitAll();
+  }
+}
+
+void TestIndependentTasksOverlap()
+{
+  // Each task waits for the other to start, so this only finishes promptly
+  // when the two really run at the same time.
+  std::atomic<bool> aStarted{ false };
+  std::atomic<bool> bStarted{ false };
+  std::atomic<bool> aSawB{ false };
+  std::atomic<bool> bSawA{ false };
+  const auto waitFor = [](const std::atomic<bool>& flag) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!flag.load() && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+    return flag.load();
+  };
+
+  TaskGraph graph(2);
+  graph.Add("a", [&]() { aStarted = true; aSawB = waitFor(bStarted); });
+  graph.Add("b", [&]() { bStarted = true; bSawA = waitFor(aStarted); });
+  graph.Start();
+  graph.WaitAll();
+  assert(aSawB && bSawA);
+}
+
+void TestAnalysisThreadHelpsWhileWaiting()
+{
+  // With no pool workers the waiting thread runs everything itself.
+  TaskGraph graph(0);
+  const auto caller = std::this_thread::get_id();
+  std::thread::id ranOn;
+  const auto t = graph.Add("only", [&]() { ranOn = std::this_thread::get_id(); });
+  graph.Start();
+  graph.Wait(t);
+  assert(ranOn == caller);
+}
+
+void TestFailureSkipsDependents()
+{
+  TaskGraph graph(2);
+  std::atomic<bool> dependentRan{ false };
+  std::atomic<bool> siblingRan{ false };
+  const auto bad = graph.Add("bad", []() { throw std::runtime_error("boom"); });
+  const auto dependent = graph.Add("dependent", [&]() { dependentRan = true; }, { bad });
+  const auto sibling = graph.Add("sibling", [&]() { siblingRan = true; });
+  graph.Start();
+
+  bool threw = false;
+  try {
+    graph.Wait(dependent);
+  } catch (const std::runtime_error& e) {
+    threw = std::string(e.what()) == "boom";
+  }
+  assert(threw);
+  assert(!dependentRan);
+  graph.Wait(sibling);
+  assert(siblingRan);
+}
+
+void TestTimingsCoverTasksAndInlineSteps()
+{
+  TaskGraph graph(1);
+  graph.Add("pool_task", []() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+  graph.Start();
+  const int v = graph.RunInline("inline_step", []() { return 42; });
+  assert(v == 42);
+  graph.WaitAll();
+
+  const auto timings = graph.Timings();
+  assert(timings.size() == 2);
+  bool sawPool = false;
+  bool sawInline = false;
+  for (const auto& t : timings) {
+    assert(t.start_ms >= 0.0 && t.duration_ms >= 0.0);
+    if (t.name == "pool_task") {
+      sawPool = t.duration_ms >= 1.0;
+    }
+    if (t.name == "inline_step") {
+      sawInline = t.worker == 0;
+    }
+  }
+  assert(sawPool && sawInline);
+  for (std::size_t i = 1; i < timings.size(); ++i) {
+    assert(timings[i - 1].start_ms <= timings[i].start_ms);
+  }
+}
+
+void TestManyTasksWideGraph()
+{
+  TaskGraph graph(4);
+  std::atomic<int> sum{ 0 };
+  std::vector<TaskGraph::TaskId> leaves;
+  const auto root = graph.Add("root", [&]() { sum += 1; });
+  for (int i = 0; i < 200; ++i) {
+    leaves.push_back(graph.Add("leaf", [&]() { sum += 1; }, { root }));
+  }
+  const auto last = graph.Add("join", [&]() { sum += 1000; }, { leaves[0], leaves[99], leaves[199] });
+  graph.Start();
+  graph.Wait(last);
+  graph.WaitAll();
+  assert(sum == 1 + 200 + 1000);
+}
+
+// Mirrors AnalyzeDump: inputs declared ahead of the graph, then an early
+// return on a failed identity while another task is still reading them.
+bool RunWithEarlyReturn(std::atomic<int>* intactReads)
+{
+  const std::string dataDir(256, 'd');
+  bool identityOk = true;
+  TaskGraph graph(2);
+  const auto identity = graph.Add("dump_identity", [&]() { identityOk = false; });
+  graph.Add("data_load", [&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (dataDir == std::string(256, 'd')) {
+      intactReads->fetch_add(1);
+    }
+  });
+  graph.Start();
+  graph.Wait(identity);
+  if (!identityOk) {
+    return false;
+  }
+  graph.WaitAll();
+  return true;
+}
+
+void TestEarlyReturnWaitsForPendingTasks()
+{
+  std::atomic<int> intactReads{ 0 };
+  assert(!RunWithEarlyReturn(&intactReads));
+  // The destructor ran the pending task to completion before the locals it
+  // captured went away.
+  assert(intactReads == 1);
+}
+
+void TestAnalyzerDeclaresCapturedLocalsBeforeTheGraph()
+{
+  // Between the graph and Start() AnalyzeDump may only add tasks: a local
+  // declared there is destroyed before the graph waits for its readers.
+  const auto analyzer = ReadProjectText("dump_tool/src/Analyzer.cpp");
+  const auto graphPos = analyzer.find("\n  TaskGraph graph(");
+  assert(graphPos != std::string::npos);
+  const auto startPos = analyzer.find("\n  graph.Start();", graphPos);
+  assert(startPos != std::string::npos);
+
+  std::istringstream lines(analyzer.substr(graphPos + 1, startPos - graphPos));
+  std::string line;
+  std::getline(lines, line);  // the graph itself
+  while (std::getline(lines, line)) {
+    if (line.rfind("  ", 0) != 0 || line.rfind("   ", 0) == 0) {
+      continue;  // lambda bodies and continuation lines
+    }
+    const bool allowed = line.rfind("  //", 0) == 0 || line.rfind("  }", 0) == 0 ||
+                         line.rfind("  const auto analysisStart = ", 0) == 0 ||
+                         (line.rfind("  const auto ", 0) == 0 && line.find("= graph.Add(") != std::string::npos);
+    assert(allowed && "AnalyzeDump declares a local between TaskGraph and Start()");
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  TestDependenciesRunInOrder();
+  TestIndependentTasksOverlap();
+  TestAnalysisThreadHelpsWhileWaiting();
+  TestFailureSkipsDependents();
+  TestTimingsCoverTasksAndInlineSteps();
+  TestManyTasksWideGraph();
+  TestEarlyReturnWaitsForPendingTasks();
+  TestAnalyzerDeclaresCapturedLocalsBeforeTheGraph();
+  return 0;
+}
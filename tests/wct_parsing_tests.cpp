@@ -10,6 +10,7 @@
 using skydiag::dump_tool::internal::ExtractWctCandidateThreadIds;
 using skydiag::dump_tool::internal::CountWctThreadsWithStableContextSwitches;
 using skydiag::dump_tool::internal::TryParseWctCaptureDecision;
+using skydiag::dump_tool::internal::TryBuildWctWaitGraph;
 using skydiag::dump_tool::internal::TryParseWctFreezeSummary;
 
 // ── ExtractWctCandidateThreadIds ────────────────────────
@@ -193,6 +194,103 @@ static void Test_FreezeSummary_ConsensusFields()
   assert(r->longest_wait_tid_consensus == true);
 }
 
+// ── TryBuildWctWaitGraph ────────────────────────────────
+
+static void Test_WaitGraph_InvalidInput()
+{
+  assert(!TryBuildWctWaitGraph("").has_value());
+  assert(!TryBuildWctWaitGraph("{bad json").has_value());
+  assert(!TryBuildWctWaitGraph(R"({"capture":{}})").has_value());
+}
+
+static void Test_WaitGraph_TwoThreadCycleAcrossChains()
+{
+  // Each WCT chain only shows half of the cycle; the graph joins them on the
+  // shared lock names.
+  const std::string json = R"({
+    "threads": [
+      {"tid": 100, "isCycle": false, "nodes": [
+        {"objectType": 8, "thread": {"threadId": 100, "waitTime": 900}},
+        {"objectType": 2, "objectName": "MutexA"},
+        {"objectType": 8, "thread": {"threadId": 200, "waitTime": 800}}
+      ]},
+      {"tid": 200, "isCycle": false, "nodes": [
+        {"objectType": 8, "thread": {"threadId": 200, "waitTime": 800}},
+        {"objectType": 2, "objectName": "MutexB"},
+        {"objectType": 8, "thread": {"threadId": 100, "waitTime": 900}}
+      ]},
+      {"tid": 300, "isCycle": false, "nodes": [
+        {"objectType": 8, "thread": {"threadId": 300, "waitTime": 50}},
+        {"objectType": 2, "objectName": "MutexA"}
+      ]}
+    ]
+  })";
+  const auto graph = TryBuildWctWaitGraph(json);
+  assert(graph.has_value());
+  assert(graph->has);
+  assert(graph->thread_nodes == 3);
+  assert(graph->lock_nodes == 2);
+  assert(graph->cycles.size() == 1);
+  assert(graph->cycles[0].thread_ids.size() == 2);
+  assert(graph->cycles[0].thread_ids[0] == 100);
+  assert(graph->cycles[0].thread_ids[1] == 200);
+  assert(graph->cycles[0].lock_names.size() == 2);
+  assert(graph->cycles[0].lock_names[0] == "MutexA");
+  assert(graph->longest_chain_has_cycle);
+  assert(graph->longest_chain_tids.size() == 3);
+  assert(graph->longest_chain_tids[0] == 300);
+}
+
+static void Test_WaitGraph_ChainWithoutCycle()
+{
+  const std::string json = R"({
+    "threads": [
+      {"tid": 10, "nodes": [
+        {"objectType": 8, "thread": {"threadId": 10}},
+        {"objectType": 1},
+        {"objectType": 8, "thread": {"threadId": 20}},
+        {"objectType": 1},
+        {"objectType": 8, "thread": {"threadId": 30}},
+        {"objectType": 3, "objectName": "IoEvent"}
+      ]},
+      {"tid": 40, "nodes": [
+        {"objectType": 8, "thread": {"threadId": 40}},
+        {"objectType": 1},
+        {"objectType": 8, "thread": {"threadId": 30}}
+      ]}
+    ]
+  })";
+  const auto graph = TryBuildWctWaitGraph(json);
+  assert(graph.has_value());
+  assert(graph->cycles.empty());
+  assert(!graph->longest_chain_has_cycle);
+  assert(graph->thread_nodes == 4);
+  assert(graph->longest_chain_tids.size() == 3);
+  assert(graph->longest_chain_tids[0] == 10);
+  assert(graph->longest_chain_tids[1] == 20);
+  assert(graph->longest_chain_tids[2] == 30);
+}
+
+static void Test_WaitGraph_UnknownOwnerBreaksChain()
+{
+  const std::string json = R"({
+    "threads": [
+      {"tid": 7, "nodes": [
+        {"objectType": 8, "thread": {"threadId": 7}},
+        {"objectType": 2, "objectName": "M"},
+        {"objectType": 8, "thread": {"threadId": 0}},
+        {"objectType": 2, "objectName": "N"},
+        {"objectType": 8, "thread": {"threadId": 7}}
+      ]}
+    ]
+  })";
+  const auto graph = TryBuildWctWaitGraph(json);
+  assert(graph.has_value());
+  assert(graph->cycles.empty());
+  assert(graph->thread_nodes == 1);
+  assert(graph->lock_nodes == 1);
+}
+
 static void Test_HelperSource_PreservesPassesAndAvoidsLoaderHeuristic()
 {
   const auto repoRoot = std::filesystem::path(__FILE__).parent_path().parent_path();
@@ -246,6 +344,12 @@ int main()
   Test_Capture_ValidCapture();
   Test_Capture_DefaultValues();
   Test_FreezeSummary_ConsensusFields();
+
+  Test_WaitGraph_InvalidInput();
+  Test_WaitGraph_TwoThreadCycleAcrossChains();
+  Test_WaitGraph_ChainWithoutCycle();
+  Test_WaitGraph_UnknownOwnerBreaksChain();
+
   Test_HelperSource_PreservesPassesAndAvoidsLoaderHeuristic();
 
   return 0;
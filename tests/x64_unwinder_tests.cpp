@@ -0,0 +1,469 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "MinidumpIndex.h"
+#include "SyntheticMinidump.h"
+#include "X64Unwinder.h"
+
+using skydiag::dump_tool::minidump::ContextX64;
+using skydiag::dump_tool::minidump::DumpTargetMemory;
+using skydiag::dump_tool::minidump::MinidumpIndex;
+using skydiag::dump_tool::minidump::ThreadUnwindInput;
+using skydiag::dump_tool::minidump::UnwindStep;
+using skydiag::dump_tool::minidump::UnwindThreads;
+using skydiag::dump_tool::minidump::X64Unwinder;
+using skydiag::dump_tool::minidump::X64UnwinderOptions;
+using skydiag::tests::minidump::SyntheticMinidump;
+
+namespace {
+
+constexpr std::uint64_t kBase = 0x140000000ull;
+constexpr std::uint32_t kImageSize = 0x3000;
+constexpr std::uint32_t kTimeDateStamp = 0x5EED5EEDu;
+constexpr std::uint64_t kStackBase = 0x7FF000ull;
+constexpr std::uint32_t kStackSize = 0x1000;
+
+// Functions in the synthetic module (RVAs).
+//   F1 [0x1000, 0x1040): push rbx; sub rsp, 20h        epilog at 0x1030
+//   F2 [0x1100, 0x1180): push rbp; sub rsp, 40h; lea rbp, [rsp+20h];
+//                        mov [rsp+38h], rsi            (frame pointer)
+//   F3 [0x1200, 0x1220): no codes of its own, chained to F1
+// 0x1800 has no entry, so it is a leaf.
+constexpr std::uint32_t kF1 = 0x1000;
+constexpr std::uint32_t kF2 = 0x1100;
+constexpr std::uint32_t kF3 = 0x1200;
+constexpr std::uint32_t kLeaf = 0x1800;
+constexpr std::uint32_t kEpilog = 0x1030;
+constexpr std::uint32_t kPdata = 0x2000;
+constexpr std::uint32_t kXdata = 0x2100;
+
+void Put16(std::vector<std::uint8_t>* b, std::size_t off, std::uint16_t v) { std::memcpy(b->data() + off, &v, 2); }
+void Put32(std::vector<std::uint8_t>* b, std::size_t off, std::uint32_t v) { std::memcpy(b->data() + off, &v, 4); }
+void Put64(std::vector<std::uint8_t>* b, std::size_t off, std::uint64_t v) { std::memcpy(b->data() + off, &v, 8); }
+
+std::uint16_t Code(std::uint8_t offset, std::uint8_t op, std::uint8_t info)
+{
+  return static_cast<std::uint16_t>(offset | (op << 8) | (info << 12));
+}
+
+// The module as loaded: headers, .text at 0x1000, .pdata/.xdata at 0x2000.
+std::vector<std::uint8_t> BuildImage(std::uint32_t timeDateStamp = kTimeDateStamp)
+{
+  std::vector<std::uint8_t> img(kImageSize, 0);
+  Put16(&img, 0, 0x5A4D);
+  Put32(&img, 0x3C, 0x40);
+  Put32(&img, 0x40, 0x00004550);
+  Put16(&img, 0x44, 0x8664);
+  Put16(&img, 0x46, 2);  // sections
+  Put32(&img, 0x48, timeDateStamp);
+  Put16(&img, 0x54, 0xF0);  // SizeOfOptionalHeader
+  const std::size_t opt = 0x58;
+  Put16(&img, opt, 0x20B);
+  Put32(&img, opt + 56, kImageSize);
+  Put32(&img, opt + 60, 0x400);  // SizeOfHeaders
+  Put32(&img, opt + 108, 16);
+  Put32(&img, opt + 112 + 3 * 8, kPdata);
+  Put32(&img, opt + 112 + 3 * 8 + 4, 3 * 12);
+  const std::size_t sec = opt + 0xF0;
+  // .text: VA 0x1000, file offset 0x400; .rdata: VA 0x2000, file offset 0x1400.
+  Put32(&img, sec + 8, 0x1000);
+  Put32(&img, sec + 12, 0x1000);
+  Put32(&img, sec + 16, 0x1000);
+  Put32(&img, sec + 20, 0x400);
+  Put32(&img, sec + 40 + 8, 0x200);
+  Put32(&img, sec + 40 + 12, 0x2000);
+  Put32(&img, sec + 40 + 16, 0x200);
+  Put32(&img, sec + 40 + 20, 0x1400);
+
+  // F1 epilog: add rsp, 20h; pop rbx; ret
+  const std::uint8_t epilog[] = { 0x48, 0x83, 0xC4, 0x20, 0x5B, 0xC3 };
+  std::memcpy(img.data() + kEpilog, epilog, sizeof(epilog));
+
+  // RUNTIME_FUNCTION entries.
+  const std::uint32_t f1Info = kXdata;
+  const std::uint32_t f2Info = kXdata + 0x20;
+  const std::uint32_t f3Info = kXdata + 0x40;
+  const std::uint32_t fns[3][3] = { { kF1, kF1 + 0x40, f1Info }, { kF2, kF2 + 0x80, f2Info }, { kF3, kF3 + 0x20, f3Info } };
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      Put32(&img, kPdata + i * 12 + j * 4, fns[i][j]);
+    }
+  }
+
+  // F1: version 1, prolog 5, two codes.
+  img[f1Info] = 1;
+  img[f1Info + 1] = 5;
+  img[f1Info + 2] = 2;
+  Put16(&img, f1Info + 4, Code(5, 2, 3));  // ALLOC_SMALL 0x20
+  Put16(&img, f1Info + 6, Code(1, 0, 3));  // PUSH_NONVOL rbx
+
+  // F2: prolog 15, frame register rbp with offset 2*16.
+  img[f2Info] = 1;
+  img[f2Info + 1] = 15;
+  img[f2Info + 2] = 5;
+  img[f2Info + 3] = static_cast<std::uint8_t>(5 | (2 << 4));
+  Put16(&img, f2Info + 4, Code(15, 4, 6));  // SAVE_NONVOL rsi
+  Put16(&img, f2Info + 6, 0x38 / 8);
+  Put16(&img, f2Info + 8, Code(10, 3, 0));  // SET_FPREG
+  Put16(&img, f2Info + 10, Code(5, 2, 7));  // ALLOC_SMALL 0x40
+  Put16(&img, f2Info + 12, Code(1, 0, 5));  // PUSH_NONVOL rbp
+
+  // F3: UNW_FLAG_CHAININFO, no codes, then F1's entry.
+  img[f3Info] = static_cast<std::uint8_t>(1 | (0x4 << 3));
+  Put32(&img, f3Info + 4, kF1);
+  Put32(&img, f3Info + 8, kF1 + 0x40);
+  Put32(&img, f3Info + 12, f1Info);
+  return img;
+}
+
+// The same module as a file on disk: sections at their raw offsets.
+std::vector<std::uint8_t> ImageToFile(const std::vector<std::uint8_t>& img)
+{
+  std::vector<std::uint8_t> file(0x1600, 0);
+  std::memcpy(file.data(), img.data(), 0x400);
+  std::memcpy(file.data() + 0x400, img.data() + 0x1000, 0x1000);
+  std::memcpy(file.data() + 0x1400, img.data() + 0x2000, 0x200);
+  return file;
+}
+
+struct Dump
+{
+  std::vector<std::uint8_t> bytes;
+  MinidumpIndex index;
+};
+
+// `codeAround`, when set, adds only the image bytes near that RVA, the way a
+// minidump keeps the code around each thread's instruction pointer.
+void BuildDump(
+  Dump* dump,
+  const std::vector<std::uint8_t>& stack,
+  bool withImage,
+  std::string_view path,
+  std::uint32_t codeAround = 0)
+{
+  SyntheticMinidump md;
+  md.AddModule(kBase, kImageSize, path, kTimeDateStamp);
+  md.AddMemory64(kStackBase, stack);
+  if (withImage) {
+    md.AddMemory64(kBase, BuildImage());
+  } else if (codeAround != 0) {
+    const auto img = BuildImage();
+    md.AddMemory64(kBase + codeAround - 0x40, std::vector<std::uint8_t>(img.begin() + (codeAround - 0x40), img.begin() + (codeAround + 0x40)));
+  }
+  dump->bytes = md.Finish();
+  std::string err;
+  const bool built = dump->index.Build(dump->bytes.data(), dump->bytes.size(), &err);
+  assert(built);
+  (void)built;
+}
+
+ContextX64 Context(std::uint64_t rip, std::uint64_t rsp)
+{
+  ContextX64 ctx{};
+  ctx.Rip = rip;
+  ctx.Rsp = rsp;
+  return ctx;
+}
+
+// F2 -> F1 -> F3 -> an address outside every module; `ctx` is F2's.
+struct ChainStack
+{
+  std::vector<std::uint8_t> stack;
+  ContextX64 ctx{};
+  std::uint64_t r1 = 0;
+  std::uint64_t r3 = 0;
+};
+
+constexpr std::uint64_t kOutside = 0x12345678ull;
+constexpr std::uint64_t kSavedRsi = 0x51515151ull;
+constexpr std::uint64_t kSavedRbp = 0xB0B0B0B0ull;
+constexpr std::uint64_t kSavedRbx1 = 0xB1B1B1B1ull;
+constexpr std::uint64_t kSavedRbx3 = 0xB3B3B3B3ull;
+
+ChainStack BuildChainStack()
+{
+  ChainStack s;
+  s.stack.assign(kStackSize, 0xCC);
+  const std::uint64_t r2 = kStackBase + 0x400;  // F2 after its prolog
+  const auto at = [&](std::uint64_t addr) { return static_cast<std::size_t>(addr - kStackBase); };
+  Put64(&s.stack, at(r2 + 0x38), kSavedRsi);
+  Put64(&s.stack, at(r2 + 0x40), kSavedRbp);
+  Put64(&s.stack, at(r2 + 0x48), kBase + kF1 + 0x20);
+  s.r1 = r2 + 0x50;
+  Put64(&s.stack, at(s.r1 + 0x20), kSavedRbx1);
+  Put64(&s.stack, at(s.r1 + 0x28), kBase + kF3 + 0x10);
+  s.r3 = s.r1 + 0x30;
+  Put64(&s.stack, at(s.r3 + 0x20), kSavedRbx3);
+  Put64(&s.stack, at(s.r3 + 0x28), kOutside);
+
+  // F2 has since pushed its stack pointer far down (alloca); only rbp
+  // still locates the frame.
+  s.ctx = Context(kBase + kF2 + 0x50, r2 - 0x200);
+  s.ctx.Rbp = r2 + 0x20;
+  return s;
+}
+
+void TestFramePointerSavesAndChains()
+{
+  const auto chain = BuildChainStack();
+  Dump dump;
+  BuildDump(&dump, chain.stack, true, "C:\\Games\\Skyrim\\synthetic.dll");
+  const DumpTargetMemory memory(dump.index.Memory());
+  X64UnwinderOptions options;
+  options.use_module_files = false;
+  const X64Unwinder unwinder(dump.index.Modules(), memory, options);
+
+  ContextX64 ctx = chain.ctx;
+  assert(unwinder.Step(&ctx, true) == UnwindStep::kUnwound);
+  assert(ctx.Rip == kBase + kF1 + 0x20);
+  assert(ctx.Rsp == chain.r1);
+  assert(ctx.Rsi == kSavedRsi);
+  assert(ctx.Rbp == kSavedRbp);
+
+  assert(unwinder.Step(&ctx, false) == UnwindStep::kUnwound);
+  assert(ctx.Rip == kBase + kF3 + 0x10);
+  assert(ctx.Rsp == chain.r3);
+  assert(ctx.Rbx == kSavedRbx1);
+
+  // Chained entry: F1's codes apply in full.
+  assert(unwinder.Step(&ctx, false) == UnwindStep::kUnwound);
+  assert(ctx.Rip == kOutside);
+  assert(ctx.Rbx == kSavedRbx3);
+  assert(unwinder.Step(&ctx, false) == UnwindStep::kEndOfStack);
+
+  bool truncated = true;
+  const auto pcs = unwinder.Walk(chain.ctx, 64, &truncated);
+  assert((pcs == std::vector<std::uint64_t>{ kBase + kF2 + 0x50, kBase + kF1 + 0x20, kBase + kF3 + 0x10, kOutside }));
+  assert(!truncated);
+  assert(unwinder.Walk(chain.ctx, 2).size() == 2);
+
+  const auto stats = unwinder.Stats();
+  assert(stats.modules_from_dump == 1 && stats.modules_from_files == 0 && stats.modules_without_tables == 0);
+}
+
+void TestPrologEpilogAndLeaf()
+{
+  std::vector<std::uint8_t> stack(kStackSize, 0);
+  const std::uint64_t sp = kStackBase + 0x100;
+  Put64(&stack, 0x100, 0xAAAA);                 // saved rbx
+  Put64(&stack, 0x108, kBase + kLeaf);          // return address
+  Put64(&stack, 0x110, 0);                      // leaf's return: end of stack
+  Dump dump;
+  BuildDump(&dump, stack, true, "synthetic.dll");
+  const DumpTargetMemory memory(dump.index.Memory());
+  const X64Unwinder unwinder(dump.index.Modules(), memory);
+
+  // After `push rbx` but before `sub rsp`: only the push is undone.
+  ContextX64 ctx = Context(kBase + kF1 + 1, sp);
+  assert(unwinder.Step(&ctx, true) == UnwindStep::kUnwound);
+  assert(ctx.Rbx == 0xAAAA && ctx.Rip == kBase + kLeaf && ctx.Rsp == sp + 16);
+
+  // At `pop rbx` in the epilog: the rest of the epilog runs forward.
+  ctx = Context(kBase + kEpilog + 4, sp);
+  assert(unwinder.Step(&ctx, true) == UnwindStep::kUnwound);
+  assert(ctx.Rbx == 0xAAAA && ctx.Rip == kBase + kLeaf && ctx.Rsp == sp + 16);
+
+  // At `add rsp, 20h`: the stack pointer is still 0x20 below the push.
+  ctx = Context(kBase + kEpilog, sp - 0x20);
+  assert(unwinder.Step(&ctx, true) == UnwindStep::kUnwound);
+  assert(ctx.Rbx == 0xAAAA && ctx.Rip == kBase + kLeaf && ctx.Rsp == sp + 16);
+
+  // A crash that jumped to a bad address unwinds as a leaf; so does code
+  // with no RUNTIME_FUNCTION. A zero return address ends the walk.
+  bool truncated = true;
+  const auto pcs = unwinder.Walk(Context(0xDEAD0000ull, sp + 8), 64, &truncated);
+  assert((pcs == std::vector<std::uint64_t>{ 0xDEAD0000ull, kBase + kLeaf }));
+  assert(!truncated);
+
+  // Unreadable stack.
+  ctx = Context(kBase + kLeaf, 0x10);
+  assert(unwinder.Step(&ctx, false) == UnwindStep::kMissingData);
+}
+
+std::filesystem::path FreshDir()
+{
+  std::random_device rd;
+  const auto dir = std::filesystem::temp_directory_path() / ("skydiag_x64_unwinder_" + std::to_string(rd()));
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+void WriteFile(const std::filesystem::path& path, const std::vector<std::uint8_t>& bytes)
+{
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+void TestTablesFromLocalFile()
+{
+  const auto chain = BuildChainStack();
+  const auto dir = FreshDir();
+  const auto matchDir = dir / "match";
+  const auto staleDir = dir / "stale";
+  std::filesystem::create_directories(matchDir);
+  std::filesystem::create_directories(staleDir);
+  WriteFile(matchDir / "synthetic.dll", ImageToFile(BuildImage()));
+  WriteFile(staleDir / "synthetic.dll", ImageToFile(BuildImage(kTimeDateStamp + 1)));
+
+  // No image in the dump; the recorded path does not exist here.
+  Dump dump;
+  BuildDump(&dump, chain.stack, false, "C:\\Games\\Skyrim\\Data\\SKSE\\Plugins\\synthetic.dll");
+  const DumpTargetMemory memory(dump.index.Memory());
+
+  {
+    X64UnwinderOptions options;
+    options.image_search_dirs = { staleDir, matchDir };
+    const X64Unwinder unwinder(dump.index.Modules(), memory, options);
+    bool truncated = true;
+    const auto pcs = unwinder.Walk(chain.ctx, 64, &truncated);
+    assert((pcs == std::vector<std::uint64_t>{ kBase + kF2 + 0x50, kBase + kF1 + 0x20, kBase + kF3 + 0x10, kOutside }));
+    assert(!truncated);
+    assert(unwinder.Stats().modules_from_files == 1);
+
+    // Epilog bytes come from the file's .text too.
+    ContextX64 ctx = Context(kBase + kEpilog + 5, chain.r3 + 0x28);  // at `ret`
+    assert(unwinder.Step(&ctx, true) == UnwindStep::kUnwound);
+    assert(ctx.Rip == kOutside);
+  }
+
+  {
+    // A different build of the DLL is not used.
+    X64UnwinderOptions options;
+    options.image_search_dirs = { staleDir };
+    const X64Unwinder unwinder(dump.index.Modules(), memory, options);
+    bool truncated = false;
+    const auto pcs = unwinder.Walk(chain.ctx, 64, &truncated);
+    assert(truncated);
+    assert(pcs.size() == 1);
+    const auto stats = unwinder.Stats();
+    assert(stats.modules_from_files == 0 && stats.modules_without_tables == 1);
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+
+void TestTablesFromModuleCache()
+{
+  const auto chain = BuildChainStack();
+  const auto cacheDir = FreshDir();
+  const std::vector<std::uint64_t> expected = { kBase + kF2 + 0x50, kBase + kF1 + 0x20, kBase + kF3 + 0x10, kOutside };
+
+  {
+    // A full dump stores the tables it used.
+    Dump full;
+    BuildDump(&full, chain.stack, true, "C:\\Games\\Skyrim\\synthetic.dll");
+    const DumpTargetMemory memory(full.index.Memory());
+    X64UnwinderOptions options;
+    options.module_cache_dir = cacheDir;
+    const X64Unwinder unwinder(full.index.Modules(), memory, options);
+    assert(unwinder.Walk(chain.ctx, 64) == expected);
+    assert(unwinder.Stats().modules_from_dump == 1);
+  }
+
+  {
+    // A later minidump of the same build with the code around the top
+    // frame, but without the image or the file.
+    Dump mini;
+    BuildDump(&mini, chain.stack, false, "C:\\Games\\Skyrim\\synthetic.dll", kF2 + 0x50);
+    const DumpTargetMemory memory(mini.index.Memory());
+    X64UnwinderOptions options;
+    options.module_cache_dir = cacheDir;
+    const X64Unwinder unwinder(mini.index.Modules(), memory, options);
+    bool truncated = true;
+    assert(unwinder.Walk(chain.ctx, 64, &truncated) == expected);
+    assert(!truncated);
+    const auto stats = unwinder.Stats();
+    assert(stats.modules_from_cache == 1 && stats.modules_from_dump == 0 && stats.modules_from_files == 0);
+
+    // Code bytes are not cached, but prolog offsets still apply.
+    ContextX64 ctx = Context(kBase + kF1 + 1, chain.r3 + 0x20);
+    assert(unwinder.Step(&ctx, true) == UnwindStep::kUnwound);
+    assert(ctx.Rbx == kSavedRbx3 && ctx.Rip == kOutside);
+  }
+
+  {
+    // A top frame stopped in an epilog: the dump's code bytes run it forward.
+    Dump mini;
+    BuildDump(&mini, chain.stack, false, "C:\\Games\\Skyrim\\synthetic.dll", kEpilog);
+    const DumpTargetMemory memory(mini.index.Memory());
+    X64UnwinderOptions options;
+    options.module_cache_dir = cacheDir;
+    const X64Unwinder unwinder(mini.index.Modules(), memory, options);
+    ContextX64 ctx = Context(kBase + kEpilog + 4, chain.r3 + 0x20);  // at `pop rbx`
+    assert(unwinder.Step(&ctx, true) == UnwindStep::kUnwound);
+    assert(ctx.Rbx == kSavedRbx3 && ctx.Rip == kOutside);
+    assert(unwinder.Stats().modules_from_cache == 1);
+  }
+
+  {
+    // Without any code the epilog test cannot run, so the walk reports a
+    // truncated stack rather than guess through the prolog codes.
+    Dump bare;
+    BuildDump(&bare, chain.stack, false, "C:\\Games\\Skyrim\\synthetic.dll");
+    const DumpTargetMemory memory(bare.index.Memory());
+    X64UnwinderOptions options;
+    options.module_cache_dir = cacheDir;
+    const X64Unwinder unwinder(bare.index.Modules(), memory, options);
+    bool truncated = false;
+    assert(unwinder.Walk(chain.ctx, 64, &truncated) == std::vector<std::uint64_t>{ chain.ctx.Rip });
+    assert(truncated);
+    ContextX64 ctx = Context(kBase + kEpilog + 4, chain.r3 + 0x20);
+    assert(unwinder.Step(&ctx, true) == UnwindStep::kMissingData);
+    // Return addresses sit after a call, not in an epilog.
+    ctx = Context(kBase + kF1 + 0x20, chain.r1);
+    assert(unwinder.Step(&ctx, false) == UnwindStep::kUnwound);
+    assert(ctx.Rip == kBase + kF3 + 0x10);
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(cacheDir, ec);
+}
+
+void TestUnwindThreadsInParallel()
+{
+  const auto chain = BuildChainStack();
+  Dump dump;
+  BuildDump(&dump, chain.stack, true, "synthetic.dll");
+  const DumpTargetMemory memory(dump.index.Memory());
+  const X64Unwinder unwinder(dump.index.Modules(), memory);
+
+  std::vector<ThreadUnwindInput> threads;
+  for (std::uint32_t tid = 1; tid <= 40; ++tid) {
+    ThreadUnwindInput t;
+    t.tid = tid;
+    t.context = tid % 2 ? chain.ctx : Context(0, 0);
+    threads.push_back(t);
+  }
+  const auto expected = unwinder.Walk(chain.ctx, 64);
+  for (const unsigned workers : { 1u, 4u }) {
+    const auto stacks = UnwindThreads(unwinder, threads, 64, workers);
+    assert(stacks.size() == threads.size());
+    for (std::size_t i = 0; i < stacks.size(); ++i) {
+      assert(stacks[i].tid == threads[i].tid);
+      assert(stacks[i].pcs == (threads[i].tid % 2 ? expected : std::vector<std::uint64_t>{}));
+      assert(!stacks[i].truncated);
+    }
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  TestFramePointerSavesAndChains();
+  TestPrologEpilogAndLeaf();
+  TestTablesFromLocalFile();
+  TestTablesFromModuleCache();
+  TestUnwindThreadsInParallel();
+  return 0;
+}